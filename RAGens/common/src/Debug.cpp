@@ -228,14 +228,14 @@ void Debug_Event(int key)
 			break;
 
 		case K_H:
-			if (Debug == 1) main68k_interrupt(4, -1);
+			if (Debug == 1) main68k_interrupt(4);
 			else if (Debug == 2) z80_Interrupt(&M_Z80, 0xFF);
 			else if ((Debug >= 4) && (Debug < 7)) sub68k_interrupt(5, -1);
 			else if ((Debug >= 7) && (Debug < 9)) SH2_Interrupt(sh, 8);
 			break;
 
 		case K_J:
-			if (Debug == 1) main68k_interrupt(6, -1);
+			if (Debug == 1) main68k_interrupt(6);
 			else if (Debug == 2) z80_Interrupt(&M_Z80, 0xFF);
 			else if ((Debug >= 4) && (Debug < 7)) sub68k_interrupt(4, -1);
 			else if ((Debug >= 7) && (Debug < 9)) SH2_Interrupt(sh, 12);
@@ -1588,6 +1588,40 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 	// Have to do it *before* load by command line
 	Init_Genesis_Bios();
 
+	// -rewindbench N <rom>: push and rewind N frames of memstates, append the
+	// results to rewind_bench.txt and quit
+	int rewindBenchFrames = 0;
+	if( strncmp( lpCmdLine, "-rewindbench ", 13 ) == 0 )
+	{
+		lpCmdLine += 13;
+		rewindBenchFrames = strtol( lpCmdLine, &lpCmdLine, 10 );
+		while( *lpCmdLine == ' ' )
+			lpCmdLine++;
+	}
+
+	// -corebench <movie.gmv> <rom>: play the movie back headless, append the
+	// frames/s and memory hashes of this core backend to core_bench.txt and quit
+	char coreBenchMovie[ 1024 ] = "";
+	if( strncmp( lpCmdLine, "-corebench ", 11 ) == 0 )
+	{
+		int len = 0;
+		char end = ' ';
+
+		lpCmdLine += 11;
+		if( *lpCmdLine == '"' )
+		{
+			end = '"';
+			lpCmdLine++;
+		}
+		while( *lpCmdLine != '\0' && *lpCmdLine != end && len < 1023 )
+			coreBenchMovie[ len++ ] = *lpCmdLine++;
+		coreBenchMovie[ len ] = '\0';
+		if( *lpCmdLine == end )
+			lpCmdLine++;
+		while( *lpCmdLine == ' ' )
+			lpCmdLine++;
+	}
+
 	if( lpCmdLine[ 0 ] != '\0' )
 	{
 		//	Fetch target ROM path from cmd line
@@ -1618,6 +1652,43 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 		RA_AttemptLogin( true );
 		Pre_Load_Rom( HWnd, buffer );
 
+		if( rewindBenchFrames > 0 )
+		{
+			char report[ 512 ] = "";
+			FILE *f;
+
+			if( !Memstate_Benchmark( rewindBenchFrames, report, sizeof( report ) ) && report[ 0 ] == '\0' )
+				strcpy( report, "rewind benchmark could not run" );
+
+			strcpy_s( Str_Tmp, 1024, Gens_Path );
+			strcat_s( Str_Tmp, 1024, "rewind_bench.txt" );
+			if( fopen_s( &f, Str_Tmp, "a" ) == 0 )
+			{
+				fprintf( f, "%s\n", report );
+				fclose( f );
+			}
+			Gens_Running = 0;
+		}
+
+		if( coreBenchMovie[ 0 ] != '\0' )
+		{
+			char report[ 512 ] = "";
+			char log[ 1024 ];
+			FILE *f;
+
+			strcpy_s( log, 1024, Gens_Path );
+			strcat_s( log, 1024, "core_bench.txt" );
+			if( !Core_Benchmark( coreBenchMovie, log, report, sizeof( report ) ) && report[ 0 ] == '\0' )
+				sprintf_s( report, sizeof( report ), "%s: core benchmark could not run", coreBenchMovie );
+
+			if( fopen_s( &f, log, "a" ) == 0 )
+			{
+				fprintf( f, "%s\n", report );
+				fclose( f );
+			}
+			Gens_Running = 0;
+		}
+
 #ifdef CC_SUPPORT
 		}
 #endif
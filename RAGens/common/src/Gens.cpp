@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "gens.h"
 #include "G_main.h"
@@ -9,6 +11,7 @@
 #include "mem_M68K.h"
 #include "mem_S68K.h"
 #include "mem_SH2.h"
+#include "Mem_Z80.h"
 #include "ym2612.h"
 #include "psg.h"
 #include "Cpu_68k.h"
@@ -903,6 +906,146 @@ int Do_Genesis_Frame()
 }
 
 
+static unsigned int Hash_Block(unsigned int h, const unsigned char *p, int size)
+{
+	for(int i = 0; i < size; i++) h = (h ^ p[i]) * 16777619U;
+	return h;
+}
+
+static void Set_Movie_Pad(const unsigned char *f)
+{
+	// GMV frames are 3 bytes, active low like the Controller_* variables
+	Controller_1_Up = (f[0] >> 0) & 1;
+	Controller_1_Down = (f[0] >> 1) & 1;
+	Controller_1_Left = (f[0] >> 2) & 1;
+	Controller_1_Right = (f[0] >> 3) & 1;
+	Controller_1_A = (f[0] >> 4) & 1;
+	Controller_1_B = (f[0] >> 5) & 1;
+	Controller_1_C = (f[0] >> 6) & 1;
+	Controller_1_Start = (f[0] >> 7) & 1;
+	Controller_1_X = (f[2] >> 0) & 1;
+	Controller_1_Y = (f[2] >> 1) & 1;
+	Controller_1_Z = (f[2] >> 2) & 1;
+	Controller_1_Mode = (f[2] >> 3) & 1;
+
+	Controller_2_Up = (f[1] >> 0) & 1;
+	Controller_2_Down = (f[1] >> 1) & 1;
+	Controller_2_Left = (f[1] >> 2) & 1;
+	Controller_2_Right = (f[1] >> 3) & 1;
+	Controller_2_A = (f[1] >> 4) & 1;
+	Controller_2_B = (f[1] >> 5) & 1;
+	Controller_2_C = (f[1] >> 6) & 1;
+	Controller_2_Start = (f[1] >> 7) & 1;
+	Controller_2_X = (f[2] >> 4) & 1;
+	Controller_2_Y = (f[2] >> 5) & 1;
+	Controller_2_Z = (f[2] >> 6) & 1;
+	Controller_2_Mode = (f[2] >> 7) & 1;
+}
+
+// Resets the Genesis and plays back a GMV movie as fast as possible, then
+// writes a line with the core backend, frames/s and hashes of the 68000 RAM,
+// Z80 RAM, VRAM and screen to report. If log has a run of the same movie
+// with the other backend (asm or C cores) the hashes and speed are compared.
+// Returns 0 if the movie can't be played or the hashes don't match.
+int Core_Benchmark(const char *movie, const char *log, char *report, int reportSize)
+{
+#ifdef GENS_C_CORES
+	static const char *backend = "C", *other = "asm";
+#else
+	static const char *backend = "asm", *other = "C";
+#endif
+	LARGE_INTEGER freq, t0, t1;
+	unsigned char *gmv;
+	unsigned int type1 = Controller_1_Type, type2 = Controller_2_Type;
+	char hashes[64], line[512], prefix[300];
+	const char *name;
+	double fps, other_fps = 0;
+	int size, frames, match = -1;
+	FILE *f;
+
+	report[0] = 0;
+	if (!Genesis_Started) return 0;
+
+	if ((name = strrchr(movie, '\\')) == NULL) name = movie;
+	else name++;
+
+	if (fopen_s(&f, movie, "rb")) return 0;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if ((size < 64) || ((gmv = (unsigned char *) malloc(size)) == NULL))
+	{
+		fclose(f);
+		return 0;
+	}
+	if ((int) fread(gmv, 1, size, f) != size || memcmp(gmv, "Gens Movie", 10))
+	{
+		fclose(f);
+		free(gmv);
+		return 0;
+	}
+	fclose(f);
+
+	if (gmv[0x16] & 0x40)
+	{
+		_snprintf(report, reportSize, "%s: movies starting from a savestate aren't supported", name);
+		report[reportSize - 1] = 0;
+		free(gmv);
+		return 0;
+	}
+
+	frames = (size - 64) / 3;
+
+	Controller_1_Type = (Controller_1_Type & ~1) | (gmv[0x14] == '6');
+	Controller_2_Type = (Controller_2_Type & ~1) | (gmv[0x15] == '6');
+	Reset_Genesis();
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t0);
+	for(int i = 0; i < frames; i++)
+	{
+		Set_Movie_Pad(gmv + 64 + i * 3);
+		Update_Frame();
+	}
+	QueryPerformanceCounter(&t1);
+
+	Controller_1_Type = type1;
+	Controller_2_Type = type2;
+	free(gmv);
+
+	if (t1.QuadPart <= t0.QuadPart) t1.QuadPart = t0.QuadPart + 1;
+	fps = (double) frames * freq.QuadPart / (t1.QuadPart - t0.QuadPart);
+
+	sprintf(hashes, "RAM %.8X Z80 %.8X VRAM %.8X screen %.8X",
+		Hash_Block(2166136261U, Ram_68k, 64 * 1024), Hash_Block(2166136261U, Ram_Z80, 8 * 1024),
+		Hash_Block(2166136261U, VRam, 64 * 1024), Hash_Block(2166136261U, (unsigned char *) MD_Screen, sizeof(MD_Screen)));
+
+	// the last run of the other backend on this movie
+	_snprintf(prefix, sizeof(prefix), "%s: %s core, %d frames,", name, other, frames);
+	prefix[sizeof(prefix) - 1] = 0;
+	if (log && !fopen_s(&f, log, "r"))
+	{
+		while (fgets(line, sizeof(line), f))
+		{
+			const char *h;
+
+			if (strncmp(line, prefix, strlen(prefix)) || (h = strstr(line, "RAM ")) == NULL) continue;
+			match = !strncmp(h, hashes, strlen(hashes));
+			other_fps = atof(line + strlen(prefix));
+		}
+		fclose(f);
+	}
+
+	_snprintf(line, sizeof(line), "%.2fx the %s core, %s", fps / other_fps, other, match ? "hashes match" : "HASH MISMATCH");
+	line[sizeof(line) - 1] = 0;
+	_snprintf(report, reportSize, "%s: %s core, %d frames, %.1f frames/s, %s, %s", name, backend, frames, fps, hashes,
+		(match < 0) ? "no other core run to compare" : line);
+	report[reportSize - 1] = 0;
+
+	return match != 0;
+}
+
+
 
 
 
@@ -3,6 +3,14 @@
 %define CYCLE_FOR_TAKE_Z80_BUS_GENESIS 16
 %define CYCLE_FOR_TAKE_Z80_BUS_SEGACD 32
 
+%ifdef GENS_C_CORES
+	; z80_c.c is compiled C, its symbols get the MSVC decorations
+	%define M_Z80 _M_Z80
+	%define z80_Exec @z80_Exec@8
+	%define z80_Set_Odo @z80_Set_Odo@8
+	%define z80_Reset @z80_Reset@4
+%endif
+
 	extern _Write_To_68K_Space
 	extern _Read_To_68K_Space
 
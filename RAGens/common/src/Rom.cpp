@@ -364,6 +364,32 @@ void RAMByteWriterSRAM( unsigned int nOffs, unsigned int nVal )
 	SRAM[ nOffs ] = nVal;
 }
 
+static unsigned int RAMBlockCopy( const unsigned char* pSrc, unsigned int nSize, unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	if( nOffs >= nSize )
+		return 0;
+	if( nCount > nSize - nOffs )
+		nCount = nSize - nOffs;
+
+	memcpy( pBuffer, pSrc + nOffs, nCount );
+	return nCount;
+}
+
+unsigned int RAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	return RAMBlockCopy( Ram_68k, sizeof( Ram_68k ), nOffs, pBuffer, nCount );
+}
+
+unsigned int RAMBlockReaderSegaCD( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	return RAMBlockCopy( Ram_Prg, sizeof( Ram_Prg ), nOffs, pBuffer, nCount );
+}
+
+unsigned int RAMBlockReaderSRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	return RAMBlockCopy( SRAM, sizeof( SRAM ), nOffs, pBuffer, nCount );
+}
+
 
 int Get_Rom(HWND hWnd)
 {
@@ -429,6 +455,8 @@ int Get_Rom(HWND hWnd)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 			RA_OnLoadNewRom( Rom_Data, Rom_Size );
 
 			allocate_Memstates(GENESIS_STATE_FILE_LENGHT); // ##RW
@@ -442,6 +470,8 @@ int Get_Rom(HWND hWnd)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 			RA_OnLoadNewRom( Rom_Data, Rom_Size );
 
 			allocate_Memstates(G32X_STATE_FILE_LENGHT); // ##RW
@@ -455,6 +485,8 @@ int Get_Rom(HWND hWnd)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 
 			allocate_Memstates(SEGACD_STATE_FILE_LENGHT); // ##RW
 			SegaCD_Started = Init_SegaCD(Name);
@@ -517,6 +549,8 @@ int Pre_Load_Rom(HWND hWnd, char *Name)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 			RA_OnLoadNewRom( Rom_Data, Rom_Size );
 
 			allocate_Memstates(GENESIS_STATE_FILE_LENGHT); // ##RW
@@ -532,6 +566,8 @@ int Pre_Load_Rom(HWND hWnd, char *Name)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 			RA_OnLoadNewRom( Rom_Data, Rom_Size );
 
 			allocate_Memstates(G32X_STATE_FILE_LENGHT); // ##RW
@@ -545,6 +581,8 @@ int Pre_Load_Rom(HWND hWnd, char *Name)
 			RA_ClearMemoryBanks();
 			RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, 64 * 1024 );
 			RA_InstallMemoryBank( 1, RAMByteReaderSRAM, RAMByteWriterSRAM, 64 * 1024 );
+			RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
+			RA_InstallMemoryBankBlockReader( 1, RAMBlockReaderSRAM );
 			RA_OnLoadNewRom( CD_Data, 1024 );
 
 			allocate_Memstates(SEGACD_STATE_FILE_LENGHT); // ##RW
@@ -95,7 +95,6 @@ extern struct SNC##CONTEXT SN##context;                       \
 int      SN##init             (void);                         \
 unsigned SN##reset            (void);                         \
 unsigned SN##exec             (int n);                        \
-int      SN##interrupt        (int level, int vector);        \
 void     SN##flushInterrupts  (void);                         \
 int      SN##GetContextSize   (void);                         \
 void     SN##GetContext       (void *context);                \
@@ -112,6 +111,10 @@ unsigned SN##readPC           (void);                         \
 STARSCREAM_IDENTIFIERS(S68000, main68k_)
 STARSCREAM_IDENTIFIERS(S68000, sub68k_)
 
+/* the main 68000 is always autovectored, it only takes the level */
+int      main68k_interrupt    (int level);
+int      sub68k_interrupt     (int level, int vector);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,7 @@ extern void Reset_Genesis();
 int Do_VDP_Only(void);
 int Do_Genesis_Frame_No_VDP(void);
 int Do_Genesis_Frame(void);
+int Core_Benchmark(const char *movie, const char *log, char *report, int reportSize);
 
 int Init_32X(struct Rom *MD_Rom);
 extern void Reset_32X();
@@ -0,0 +1,2167 @@
+/*
+** Starscream 680x0 emulation library
+** Copyright 1997, 1998, 1999 Neill Corlett
+**
+** Portable C version of the main68k core that main68kgen.c generates for
+** Gens (68000, hog mode, Gens memory handlers). It is built instead of
+** main68k.asm when GENS_C_CORES is defined, exports the same context and
+** entry points, and follows the generated code closely, quirks included,
+** so both backends give the same results on the same input.
+**
+** Only the nmake build selects it (nmake RELEASE=1 CCORES=1 in win32);
+** RAGens.vcxproj always uses the asm cores.
+*/
+
+#ifdef GENS_C_CORES
+
+#include <stddef.h>
+#include <string.h>
+#include "main68k.h"		// Star_68k.h declares releaseCycles() without argument (the asm takes it in eax)
+#include "Mem_M68k.h"
+
+#ifndef INLINE
+#define INLINE __inline
+#endif
+
+#ifndef UINT8
+#define UINT8   unsigned char
+#endif
+
+#ifndef INT8
+#define INT8    signed char
+#endif
+
+#ifndef UINT16
+#define UINT16  unsigned short
+#endif
+
+#ifndef INT16
+#define INT16   signed short
+#endif
+
+#ifndef UINT32
+#define UINT32  unsigned int
+#endif
+
+#ifndef INT32
+#define INT32   signed int
+#endif
+
+
+#define EXEC_RUNNING    0x01
+#define EXEC_BADPC      0x02
+
+unsigned char Int_Ack(void);		// vdp_io.asm, returns the new IPL
+
+struct S68000CONTEXT main68k_context;
+
+static int Cycles_Needed;
+static int Cycles_Leftover;
+static UINT32 Fetch_Start, Fetch_End;
+static int Exec_Info;
+
+// Cycle counter of the running exec (edi in the asm), -1 when idle.
+// The memory handlers read and change it through the API like they do
+// with __io_cycle_counter.
+static int IO_Cycles = -1;
+
+// PC is a host pointer, Fetch_Base + 68K PC. The asm keeps the same
+// thing in esi/ebp.
+static size_t Fetch_Base;
+static UINT8 *PC;
+
+static UINT32 Flag_N, Flag_Z, Flag_V, Flag_C, Flag_X;
+
+static UINT8 Op_Table[0x10000];
+static UINT8 EA_Idx[64];
+static UINT8 EA_Cyc[2][64];
+static UINT8 Move_Cyc[2][64];
+
+static UINT32 RMW_Adr;
+
+
+// Cycles by EA index: dreg, areg, aind, ainc, adec, adsp, axdp, absw, absl, pcdp, pcxd, immd
+
+static const UINT8 EA_Time[12]       = { 0, 0,  4, 4, 6,  8, 10,  8, 12,  8, 10, 4 };
+static const UINT8 Move_Time[12]     = { 0, 0,  4, 4, 4,  8, 10,  8, 12,  0,  0, 0 };
+static const UINT8 Jmp_Time[12]      = { 0, 0,  8, 0, 0, 10, 14, 10, 12, 10, 14, 0 };
+static const UINT8 Jsr_Time[12]      = { 0, 0, 16, 0, 0, 18, 22, 18, 20, 18, 22, 0 };
+static const UINT8 Lea_Time[12]      = { 0, 0,  4, 0, 0,  8, 12,  8, 12,  8, 12, 0 };
+static const UINT8 Pea_Time[12]      = { 0, 0, 12, 0, 0, 16, 20, 16, 20, 16, 20, 0 };
+static const UINT8 Movem_RM_Time[12] = { 0, 0,  8, 0, 0, 12, 14, 12, 16,  0,  0, 0 };
+static const UINT8 Movem_MR_Time[12] = { 0, 0, 12, 0, 0, 16, 18, 16, 20, 16, 18, 0 };
+
+static const UINT32 Size_Mask[5] = { 0, 0xFF, 0xFFFF, 0, 0xFFFFFFFF };
+static const UINT32 Size_Msb[5]  = { 0, 0x80, 0x8000, 0, 0x80000000 };
+static const int Size_Field[4]   = { 1, 2, 4, 0 };
+static const int Move_Size[4]    = { 0, 1, 4, 2 };
+
+
+enum
+{
+	I_ILLEGAL = 0, I_LINE_A, I_LINE_F,
+	I_IMM, I_BITOP_IMM, I_BITOP_REG, I_CCR_OP, I_SR_OP, I_MOVEP_MR, I_MOVEP_RM,
+	I_MOVE, I_MOVEA_W, I_MOVEA_L,
+	I_MOVE_FROM_SR, I_MOVE_TO_CCR, I_MOVE_TO_SR, I_JMP, I_JSR, I_LEA, I_CHK, I_PEA,
+	I_CLR, I_TST, I_RESET, I_NOP, I_STOP, I_RTE, I_RTS, I_TRAPV, I_RTR,
+	I_MOVEM_RM, I_MOVEM_MR, I_MOVEM_POSTINC, I_MOVEM_PREDEC, I_LINK, I_UNLK, I_TRAP,
+	I_MOVE_TO_USP, I_MOVE_FROM_USP, I_SWAP, I_EXT_W, I_EXT_L,
+	I_NEGX, I_NEG, I_NOT, I_NBCD, I_TAS,
+	I_ADDQ, I_SUBQ, I_DBT, I_DBF, I_DBCC, I_SCC, I_BRA, I_BSR, I_BCC, I_MOVEQ,
+	I_OR_DN, I_OR_EA, I_DIVU, I_DIVS, I_SBCD_DREG, I_SBCD_ADEC,
+	I_SUB_DN, I_SUB_EA, I_SUBA_W, I_SUBA_L, I_SUBX_DREG, I_SUBX_ADEC,
+	I_CMP_DN, I_EOR_EA, I_CMPA_W, I_CMPA_L, I_CMPM,
+	I_AND_DN, I_AND_EA, I_MULU, I_MULS, I_EXG_DD, I_EXG_AA, I_EXG_DA, I_ABCD_DREG, I_ABCD_ADEC,
+	I_ADD_DN, I_ADD_EA, I_ADDA_W, I_ADDA_L, I_ADDX_DREG, I_ADDX_ADEC,
+	I_SHIFT_REG, I_SHIFT_MEM
+};
+
+
+#define DREG(n)			main68k_context.dreg[n]
+#define AREG(n)			main68k_context.areg[n]
+#define REG(n)			(*(((n) & 8) ? &AREG((n) & 7) : &DREG(n)))
+
+#define SEXT8(v)		((UINT32) (INT32) (INT8) (v))
+#define SEXT16(v)		((UINT32) (INT32) (INT16) (v))
+
+#define FETCH_WORD		(*(UINT16 *) PC)
+#define FETCH_LONG		(((UINT32) ((UINT16 *) PC)[0] << 16) | ((UINT16 *) PC)[1])
+#define UNBASED_PC		((UINT32) ((size_t) PC - Fetch_Base))
+
+#define GET_CCR			((Flag_X << 4) | (Flag_N << 3) | (Flag_Z << 2) | (Flag_V << 1) | Flag_C)
+#define GET_SR			((main68k_context.sr & 0xFF00) | GET_CCR)
+
+#define EA_CYCLES(ea, size)	(EA_Cyc[(size) == 4][ea])
+
+#define SET_NZ(res, size)									\
+{															\
+	Flag_N = ((res) & Size_Msb[size]) != 0;					\
+	Flag_Z = ((res) & Size_Mask[size]) == 0;				\
+}
+
+#define SET_LOGIC(res, size)								\
+{															\
+	SET_NZ(res, size)										\
+	Flag_V = Flag_C = 0;									\
+}
+
+
+/***************************/
+/* Memory                  */
+/***************************/
+
+// Same fast path as the asm, RAM above 0xE00000 is read straight from
+// Ram_68k (byte swapped words), the rest goes to the Gens handlers.
+
+static INLINE UINT32 Read_Byte(UINT32 adr)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000) return Ram_68k[(adr & 0xFFFF) ^ 1];
+	return M68K_RB(adr);
+}
+
+static INLINE UINT32 Read_Word(UINT32 adr)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000) return *(UINT16 *) &Ram_68k[adr & 0xFFFF];
+	return M68K_RW(adr);
+}
+
+static UINT32 Read_Long(UINT32 adr)
+{
+	UINT32 hi;
+
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000)
+	{
+		// a long at 0xFFFFFE reads past Ram_68k, like the asm
+		UINT16 *p = (UINT16 *) &Ram_68k[adr & 0xFFFF];
+		return ((UINT32) p[0] << 16) | p[1];
+	}
+
+	hi = M68K_RW(adr);
+	return (hi << 16) | M68K_RW(adr + 2);
+}
+
+// -(An) longs are read and written low word first
+
+static UINT32 Read_Long_Dec(UINT32 adr)
+{
+	UINT32 lo;
+
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000)
+	{
+		UINT16 *p = (UINT16 *) &Ram_68k[adr & 0xFFFF];
+		return ((UINT32) p[0] << 16) | p[1];
+	}
+
+	lo = M68K_RW(adr + 2);
+	return ((UINT32) M68K_RW(adr) << 16) | lo;
+}
+
+static INLINE void Write_Byte(UINT32 adr, UINT32 data)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000) Ram_68k[(adr & 0xFFFF) ^ 1] = (UINT8) data;
+	else M68K_WB(adr, (UINT8) data);
+}
+
+static INLINE void Write_Word(UINT32 adr, UINT32 data)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000) *(UINT16 *) &Ram_68k[adr & 0xFFFF] = (UINT16) data;
+	else M68K_WW(adr, (UINT16) data);
+}
+
+static void Write_Long(UINT32 adr, UINT32 data)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000)
+	{
+		UINT16 *p = (UINT16 *) &Ram_68k[adr & 0xFFFF];
+		p[0] = (UINT16) (data >> 16);
+		p[1] = (UINT16) data;
+		return;
+	}
+
+	M68K_WW(adr, (UINT16) (data >> 16));
+	M68K_WW(adr + 2, (UINT16) data);
+}
+
+static void Write_Long_Dec(UINT32 adr, UINT32 data)
+{
+	adr &= 0xFFFFFF;
+	if (adr >= 0xE00000)
+	{
+		UINT16 *p = (UINT16 *) &Ram_68k[adr & 0xFFFF];
+		p[0] = (UINT16) (data >> 16);
+		p[1] = (UINT16) data;
+		return;
+	}
+
+	M68K_WW(adr + 2, (UINT16) data);
+	M68K_WW(adr, (UINT16) (data >> 16));
+}
+
+static INLINE UINT32 Read_Mem(UINT32 adr, int size, int dec)
+{
+	if (size == 1) return Read_Byte(adr);
+	if (size == 2) return Read_Word(adr);
+	if (dec) return Read_Long_Dec(adr);
+	return Read_Long(adr);
+}
+
+static INLINE void Write_Mem(UINT32 adr, int size, UINT32 data, int dec)
+{
+	if (size == 1) Write_Byte(adr, data);
+	else if (size == 2) Write_Word(adr, data);
+	else if (dec) Write_Long_Dec(adr, data);
+	else Write_Long(adr, data);
+}
+
+// pushes use the -(A7) store of the asm
+
+#define PUSH_LONG(data)										\
+{															\
+	AREG(7) -= 4;											\
+	Write_Long_Dec(AREG(7), (data));						\
+}
+
+
+/***************************/
+/* PC and status register  */
+/***************************/
+
+// basefunction: uncached rebase, ends the timeslice if PC is out of bounds
+
+static void Rebase(UINT32 pc)
+{
+	struct STARSCREAM_PROGRAMREGION *f;
+	UINT32 adr = pc & 0xFFFFFF, high = pc & 0xFF000000;
+
+	for(f = main68k_context.fetch; ; f++)
+	{
+		if ((adr >= f->lowaddr) && (adr <= f->highaddr))
+		{
+			Fetch_Start = f->lowaddr | high;
+			Fetch_End = f->highaddr | high;
+			Fetch_Base = (size_t) f->offset - high;
+			PC = (UINT8 *) (Fetch_Base + pc);
+			return;
+		}
+
+		if (f->lowaddr == 0xFFFFFFFF) break;
+	}
+
+	Fetch_Start = 0xFFFFFFFF;
+	Fetch_End = 0;
+	Fetch_Base = 0;
+	PC = (UINT8 *) (size_t) pc;
+	IO_Cycles -= Cycles_Needed;
+	Cycles_Needed = 0;
+	Exec_Info |= EXEC_BADPC;
+}
+
+// cached rebase, used by jumps, returns and exceptions
+
+static INLINE void Jump(UINT32 pc)
+{
+	if ((pc >= Fetch_Start) && (pc <= Fetch_End)) PC = (UINT8 *) (Fetch_Base + pc);
+	else Rebase(pc);
+}
+
+static INLINE void Set_CCR(UINT32 ccr)
+{
+	Flag_X = (ccr >> 4) & 1;
+	Flag_N = (ccr >> 3) & 1;
+	Flag_Z = (ccr >> 2) & 1;
+	Flag_V = (ccr >> 1) & 1;
+	Flag_C = ccr & 1;
+}
+
+static void Set_Map(int super)
+{
+	if (super)
+	{
+		main68k_context.fetch = main68k_context.s_fetch;
+		main68k_context.readbyte = main68k_context.s_readbyte;
+		main68k_context.readword = main68k_context.s_readword;
+		main68k_context.writebyte = main68k_context.s_writebyte;
+		main68k_context.writeword = main68k_context.s_writeword;
+	}
+	else
+	{
+		main68k_context.fetch = main68k_context.u_fetch;
+		main68k_context.readbyte = main68k_context.u_readbyte;
+		main68k_context.readword = main68k_context.u_readword;
+		main68k_context.writebyte = main68k_context.u_writebyte;
+		main68k_context.writeword = main68k_context.u_writeword;
+	}
+}
+
+static void Swap_SP(void)
+{
+	UINT32 sp = AREG(7);
+
+	AREG(7) = main68k_context.asp;
+	main68k_context.asp = sp;
+}
+
+// cx2sr
+
+static void Set_SR(UINT32 sr)
+{
+	if ((sr ^ main68k_context.sr) & 0x2000)
+	{
+		Swap_SP();
+		Set_Map(sr & 0x2000);
+	}
+
+	main68k_context.sr = (UINT16) ((main68k_context.sr & 0xFF) | (sr & 0xA700));
+	Set_CCR(sr);
+}
+
+// group 1 and 2 exceptions, pushes pc and SR and returns the new PC
+
+static UINT32 Exception(UINT32 vector, UINT32 pc)
+{
+	UINT32 new_pc, sr;
+
+	main68k_context.interrupts[0] &= 0xEF;
+	new_pc = Read_Long(vector);
+	sr = GET_SR;
+
+	if (!(main68k_context.sr & 0x2000))
+	{
+		Swap_SP();
+		Set_Map(1);
+		main68k_context.sr |= 0x2000;
+	}
+	main68k_context.sr &= 0x27FF;
+
+	Write_Long(AREG(7) - 4, pc);
+	Write_Word(AREG(7) - 6, sr);
+	AREG(7) -= 6;
+
+	return new_pc;
+}
+
+// same test as the asm, level 7 isn't masked and the stopped bit
+// counts as a level when it isn't masked out
+
+#define INT_PENDING(level)	(((level) == 7) || (((main68k_context.sr >> 8) & 7) < (UINT32) (level)))
+
+// flush_interrupts followed by an uncached rebase
+
+static void Do_Interrupt(void)
+{
+	UINT32 pc = UNBASED_PC;
+	UINT32 level = main68k_context.interrupts[0] & 7;
+
+	if (level)
+	{
+		pc = Exception((level + 0x18) * 4, pc);
+		main68k_context.sr = (UINT16) ((main68k_context.sr & 0xF8FF) | ((main68k_context.interrupts[0] & 7) << 8));
+		IO_Cycles -= 44;
+		main68k_context.interrupts[0] = Int_Ack();
+	}
+
+	Rebase(pc);
+}
+
+
+/***************************/
+/* Effective address       */
+/***************************/
+
+// decode_ext: index register + 8 bits displacement
+
+static INLINE UINT32 Ext_Index(void)
+{
+	UINT32 ext = FETCH_WORD, idx;
+
+	PC += 2;
+	idx = REG(ext >> 12);
+	if (!(ext & 0x800)) idx = SEXT16(idx);
+
+	return idx + SEXT8(ext);
+}
+
+// Address of a memory EA. (An)+ and -(An) update An here, the asm does it
+// after the access but nothing can see the difference.
+
+static UINT32 EA_Adr(UINT32 ea, int size)
+{
+	UINT32 r = ea & 7, adr;
+
+	switch(ea >> 3)
+	{
+		case 2:
+			return AREG(r);
+
+		case 3:
+			adr = AREG(r);
+			AREG(r) += ((size == 1) && (r == 7)) ? 2 : size;
+			return adr;
+
+		case 4:
+			AREG(r) -= ((size == 1) && (r == 7)) ? 2 : size;
+			return AREG(r);
+
+		case 5:
+			adr = AREG(r) + SEXT16(FETCH_WORD);
+			PC += 2;
+			return adr;
+
+		case 6:
+			adr = Ext_Index();
+			return adr + AREG(r);
+
+		default:
+			switch(r)
+			{
+				case 0:
+					adr = SEXT16(FETCH_WORD);
+					PC += 2;
+					return adr;
+
+				case 1:
+					adr = FETCH_LONG;
+					PC += 4;
+					return adr;
+
+				case 2:
+					adr = UNBASED_PC + SEXT16(FETCH_WORD);
+					PC += 2;
+					return adr;
+
+				default:
+					adr = UNBASED_PC;
+					return adr + Ext_Index();
+			}
+	}
+}
+
+static INLINE UINT32 Read_EA(UINT32 ea, int size)
+{
+	UINT32 data;
+
+	if (ea < 0x10) return REG(ea) & Size_Mask[size];
+
+	if (ea == 0x3C)
+	{
+		if (size == 4)
+		{
+			data = FETCH_LONG;
+			PC += 4;
+		}
+		else
+		{
+			data = FETCH_WORD & Size_Mask[size];
+			PC += 2;
+		}
+		return data;
+	}
+
+	data = EA_Adr(ea, size);
+	return Read_Mem(data, size, (ea & 0x38) == 0x20);
+}
+
+static INLINE void Set_DREG(UINT32 r, UINT32 data, int size)
+{
+	if (size == 1) DREG(r) = (DREG(r) & 0xFFFFFF00) | (data & 0xFF);
+	else if (size == 2) DREG(r) = (DREG(r) & 0xFFFF0000) | (data & 0xFFFF);
+	else DREG(r) = data;
+}
+
+static INLINE void Write_EA(UINT32 ea, int size, UINT32 data)
+{
+	UINT32 adr;
+
+	if (ea < 8) Set_DREG(ea, data, size);
+	else
+	{
+		adr = EA_Adr(ea, size);
+		Write_Mem(adr, size, data, (ea & 0x38) == 0x20);
+	}
+}
+
+static INLINE UINT32 Read_RMW(UINT32 ea, int size)
+{
+	if (ea < 8) return DREG(ea) & Size_Mask[size];
+
+	RMW_Adr = EA_Adr(ea, size);
+	return Read_Mem(RMW_Adr, size, (ea & 0x38) == 0x20);
+}
+
+static INLINE void Write_RMW(UINT32 ea, int size, UINT32 data)
+{
+	if (ea < 8) Set_DREG(ea, data, size);
+	else Write_Mem(RMW_Adr, size, data, (ea & 0x38) == 0x20);
+}
+
+
+/***************************/
+/* ALU                     */
+/***************************/
+
+static INLINE UINT32 Do_Add(UINT32 dst, UINT32 src, UINT32 x, int size)
+{
+	UINT32 msb = Size_Msb[size];
+	UINT32 res = (dst + src + x) & Size_Mask[size];
+
+	Flag_N = (res & msb) != 0;
+	Flag_Z = res == 0;
+	Flag_V = ((src ^ res) & (dst ^ res) & msb) != 0;
+	Flag_C = (((src & dst) | (~res & (src | dst))) & msb) != 0;
+
+	return res;
+}
+
+static INLINE UINT32 Do_Sub(UINT32 dst, UINT32 src, UINT32 x, int size)
+{
+	UINT32 msb = Size_Msb[size];
+	UINT32 res = (dst - src - x) & Size_Mask[size];
+
+	Flag_N = (res & msb) != 0;
+	Flag_Z = res == 0;
+	Flag_V = ((src ^ dst) & (res ^ dst) & msb) != 0;
+	Flag_C = (((src & ~dst) | (res & ~dst) | (src & res)) & msb) != 0;
+
+	return res;
+}
+
+// ABCD / SBCD are done like the asm, adc / sbb followed by the x86 daa / das.
+// Z is only cleared (adjzero).
+
+static UINT32 Do_ABCD(UINT32 dst, UINT32 src)
+{
+	UINT32 res = dst + src + Flag_X;
+	UINT32 al = res & 0xFF, old = al;
+	UINT32 cf = res >> 8;
+
+	if (((al & 0x0F) > 9) || ((dst ^ src ^ res) & 0x10)) al = (al + 0x06) & 0xFF;
+	if ((old > 0x99) || cf)
+	{
+		al = (al + 0x60) & 0xFF;
+		cf = 1;
+	}
+	else cf = 0;
+
+	Flag_N = al >> 7;
+	if (al) Flag_Z = 0;
+	Flag_V = 0;
+	Flag_C = Flag_X = cf;
+
+	return al;
+}
+
+static UINT32 Do_SBCD(UINT32 dst, UINT32 src)
+{
+	UINT32 res = dst - src - Flag_X;
+	UINT32 al = res & 0xFF, old = al;
+	UINT32 cf = (res >> 8) & 1, old_cf = cf;
+
+	if (((al & 0x0F) > 9) || ((dst ^ src ^ res) & 0x10))
+	{
+		cf = old_cf | (al < 0x06);
+		al = (al - 0x06) & 0xFF;
+	}
+	else cf = 0;
+	if ((old > 0x99) || old_cf)
+	{
+		al = (al - 0x60) & 0xFF;
+		cf = 1;
+	}
+
+	Flag_N = al >> 7;
+	if (al) Flag_Z = 0;
+	Flag_V = 0;
+	Flag_C = Flag_X = cf;
+
+	return al;
+}
+
+// type: 0 = AS, 1 = LS, 2 = ROX, 3 = RO, count is never 0
+
+static UINT32 Shift(int type, int left, UINT32 v, UINT32 cnt, int size)
+{
+	UINT32 msb = Size_Msb[size], mask = Size_Mask[size];
+	UINT32 bits = size * 8, c;
+	INT32 s;
+
+	switch(type)
+	{
+		case 0:
+			if (left)
+			{
+				// bit by bit like the asm, V is set if the MSB changed at any step
+				Flag_V = 0;
+				for(; cnt; cnt--)
+				{
+					c = (v << 1) & mask;
+					Flag_C = (v & msb) != 0;
+					Flag_V |= ((v ^ c) & msb) != 0;
+					v = c;
+				}
+			}
+			else
+			{
+				// register counts above 31 shift by 31 in the asm
+				if (cnt > 31) cnt = 31;
+				s = (INT32) (v << (32 - bits)) >> (32 - bits);
+
+				if (cnt < bits)
+				{
+					Flag_C = (s >> (cnt - 1)) & 1;
+					v = (UINT32) (s >> cnt) & mask;
+				}
+				else
+				{
+					Flag_C = (v & msb) != 0;
+					v = Flag_C ? mask : 0;
+				}
+				Flag_V = 0;
+			}
+			Flag_X = Flag_C;
+			break;
+
+		case 1:
+			if (cnt > 31) cnt = 31;
+
+			if (cnt > bits) Flag_C = v = 0;
+			else if (left)
+			{
+				Flag_C = (v >> (bits - cnt)) & 1;
+				v = (cnt == bits) ? 0 : (v << cnt) & mask;
+			}
+			else
+			{
+				Flag_C = (v >> (cnt - 1)) & 1;
+				v = (cnt == bits) ? 0 : v >> cnt;
+			}
+			Flag_V = 0;
+			Flag_X = Flag_C;
+			break;
+
+		case 2:
+			// the asm does register counts above 31 as 31 then (count - 31) & 31
+			if (cnt == 63) cnt = 31;
+
+			for(cnt %= bits + 1; cnt; cnt--)
+			{
+				if (left)
+				{
+					c = (v & msb) != 0;
+					v = ((v << 1) | Flag_X) & mask;
+				}
+				else
+				{
+					c = v & 1;
+					v = (v >> 1) | (Flag_X ? msb : 0);
+				}
+				Flag_X = c;
+			}
+			Flag_C = Flag_X;
+			Flag_V = 0;
+			break;
+
+		default:
+			c = cnt & (bits - 1);
+			if (c)
+			{
+				if (left) v = ((v << c) | (v >> (bits - c))) & mask;
+				else v = ((v >> c) | (v << (bits - c))) & mask;
+			}
+			Flag_C = left ? (v & 1) : ((v & msb) != 0);
+			Flag_V = 0;
+			break;
+	}
+
+	SET_NZ(v, size)
+	return v;
+}
+
+static INLINE int Cond(UINT32 cc)
+{
+	switch(cc)
+	{
+		case 0x0: return 1;
+		case 0x1: return 0;
+		case 0x2: return !Flag_C && !Flag_Z;
+		case 0x3: return Flag_C || Flag_Z;
+		case 0x4: return !Flag_C;
+		case 0x5: return Flag_C;
+		case 0x6: return !Flag_Z;
+		case 0x7: return Flag_Z;
+		case 0x8: return !Flag_V;
+		case 0x9: return Flag_V;
+		case 0xA: return !Flag_N;
+		case 0xB: return Flag_N;
+		case 0xC: return Flag_N == Flag_V;
+		case 0xD: return Flag_N != Flag_V;
+		case 0xE: return !Flag_Z && (Flag_N == Flag_V);
+		default:  return Flag_Z || (Flag_N != Flag_V);
+	}
+}
+
+static INLINE int Bit_Count(UINT32 v)
+{
+	int n = 0;
+
+	for(; v; v &= v - 1) n++;
+	return n;
+}
+
+
+/***************************/
+/* Decoder                 */
+/***************************/
+
+// EA sets, one bit per EA index
+
+#define EA_ALL          0xFFF
+#define EA_DATA         0xFFD
+#define EA_ALTER        0x1FF
+#define EA_DATA_ALT     0x1FD
+#define EA_MEM_ALT      0x1FC
+#define EA_CONTROL      0x7E4
+#define EA_CTRL_ALT     0x1E4
+
+static int Get_EA_Index(UINT32 ea)
+{
+	if ((ea >> 3) < 7) return ea >> 3;
+	if ((ea & 7) > 4) return -1;
+	return 7 + (ea & 7);
+}
+
+static int EA_Valid(UINT32 ea, int set)
+{
+	int idx = Get_EA_Index(ea);
+
+	if (idx < 0) return 0;
+	return (set >> idx) & 1;
+}
+
+// same matching order as main68kgen.c, the first one wins
+
+static int Decode(UINT32 op)
+{
+	UINT32 ea = op & 0x3F;
+	int size = (op >> 6) & 3;
+
+	switch(op >> 12)
+	{
+		case 0x0:
+			if ((size != 3) && EA_Valid(ea, EA_DATA_ALT))
+			{
+				switch(op & 0xFF00)
+				{
+					case 0x0000: case 0x0200: case 0x0400:
+					case 0x0600: case 0x0A00: case 0x0C00:
+						return I_IMM;
+				}
+			}
+			if ((op & 0xFF00) == 0x0800)
+			{
+				if (EA_Valid(ea, (size == 0) ? EA_DATA : EA_DATA_ALT)) return I_BITOP_IMM;
+			}
+			if (op & 0x0100)
+			{
+				if (EA_Valid(ea, (size == 0) ? EA_DATA : EA_DATA_ALT)) return I_BITOP_REG;
+			}
+			switch(op)
+			{
+				case 0x003C: case 0x023C: case 0x0A3C: return I_CCR_OP;
+				case 0x007C: case 0x027C: case 0x0A7C: return I_SR_OP;
+			}
+			if ((op & 0xF1B8) == 0x0108) return I_MOVEP_MR;
+			if ((op & 0xF1B8) == 0x0188) return I_MOVEP_RM;
+			return I_ILLEGAL;
+
+		case 0x1: case 0x2: case 0x3:
+			if (!EA_Valid(ea, EA_ALL)) return I_ILLEGAL;
+			switch((op >> 6) & 7)
+			{
+				case 1:
+					if ((op & 0x3000) == 0x1000) return I_ILLEGAL;
+					return ((op & 0x3000) == 0x3000) ? I_MOVEA_W : I_MOVEA_L;
+
+				case 7:
+					if (op & 0x0C00) return I_ILLEGAL;
+					return I_MOVE;
+
+				default:
+					return I_MOVE;
+			}
+
+		case 0x4:
+			if (((op & 0xFFC0) == 0x40C0) && EA_Valid(ea, EA_DATA_ALT)) return I_MOVE_FROM_SR;
+			if (((op & 0xFFC0) == 0x44C0) && EA_Valid(ea, EA_DATA)) return I_MOVE_TO_CCR;
+			if (((op & 0xFFC0) == 0x46C0) && EA_Valid(ea, EA_DATA)) return I_MOVE_TO_SR;
+			if (((op & 0xFFC0) == 0x4EC0) && EA_Valid(ea, EA_CONTROL)) return I_JMP;
+			if (((op & 0xFFC0) == 0x4E80) && EA_Valid(ea, EA_CONTROL)) return I_JSR;
+			if (((op & 0xF1C0) == 0x41C0) && EA_Valid(ea, EA_CONTROL)) return I_LEA;
+			if (((op & 0xF1C0) == 0x4180) && EA_Valid(ea, EA_DATA)) return I_CHK;
+			if (((op & 0xFFC0) == 0x4840) && EA_Valid(ea, EA_CONTROL)) return I_PEA;
+			if (((op & 0xFF00) == 0x4200) && (size != 3) && EA_Valid(ea, EA_DATA_ALT)) return I_CLR;
+			if (((op & 0xFF00) == 0x4A00) && (size != 3) && EA_Valid(ea, EA_DATA_ALT)) return I_TST;
+			switch(op)
+			{
+				case 0x4E70: return I_RESET;
+				case 0x4E71: return I_NOP;
+				case 0x4E72: return I_STOP;
+				case 0x4E73: return I_RTE;
+				case 0x4E75: return I_RTS;
+				case 0x4E76: return I_TRAPV;
+				case 0x4E77: return I_RTR;
+			}
+			if (((op & 0xFF80) == 0x4880) && EA_Valid(ea, EA_CTRL_ALT)) return I_MOVEM_RM;
+			if (((op & 0xFF80) == 0x4C80) && EA_Valid(ea, EA_CONTROL)) return I_MOVEM_MR;
+			if ((op & 0xFFB8) == 0x4C98) return I_MOVEM_POSTINC;
+			if ((op & 0xFFB8) == 0x48A0) return I_MOVEM_PREDEC;
+			if ((op & 0xFFF8) == 0x4E50) return I_LINK;
+			if ((op & 0xFFF8) == 0x4E58) return I_UNLK;
+			if ((op & 0xFFF0) == 0x4E40) return I_TRAP;
+			if ((op & 0xFFF8) == 0x4E60) return I_MOVE_TO_USP;
+			if ((op & 0xFFF8) == 0x4E68) return I_MOVE_FROM_USP;
+			if ((op & 0xFFF8) == 0x4840) return I_SWAP;
+			if ((op & 0xFFF8) == 0x4880) return I_EXT_W;
+			if ((op & 0xFFF8) == 0x48C0) return I_EXT_L;
+			if ((size != 3) && EA_Valid(ea, EA_DATA_ALT))
+			{
+				if ((op & 0xFF00) == 0x4000) return I_NEGX;
+				if ((op & 0xFF00) == 0x4400) return I_NEG;
+				if ((op & 0xFF00) == 0x4600) return I_NOT;
+			}
+			if (((op & 0xFFC0) == 0x4800) && EA_Valid(ea, EA_DATA_ALT)) return I_NBCD;
+			if (((op & 0xFFC0) == 0x4AC0) && EA_Valid(ea, EA_DATA_ALT)) return I_TAS;
+			return I_ILLEGAL;
+
+		case 0x5:
+			if (size != 3)
+			{
+				if (!EA_Valid(ea, EA_ALTER) || ((size == 0) && ((ea >> 3) == 1))) return I_ILLEGAL;
+				return (op & 0x0100) ? I_SUBQ : I_ADDQ;
+			}
+			if ((op & 0xF0F8) == 0x50C8)
+			{
+				switch((op >> 8) & 0xF)
+				{
+					case 0: return I_DBT;
+					case 1: return I_DBF;
+					default: return I_DBCC;
+				}
+			}
+			if (EA_Valid(ea, EA_DATA_ALT)) return I_SCC;
+			return I_ILLEGAL;
+
+		case 0x6:
+			switch((op >> 8) & 0xF)
+			{
+				case 0: return I_BRA;
+				case 1: return I_BSR;
+				default: return I_BCC;
+			}
+
+		case 0x7:
+			if (op & 0x0100) return I_ILLEGAL;
+			return I_MOVEQ;
+
+		case 0x8:
+			if (size == 3)
+			{
+				if (!EA_Valid(ea, EA_DATA)) return I_ILLEGAL;
+				return (op & 0x0100) ? I_DIVS : I_DIVU;
+			}
+			if (!(op & 0x0100)) return EA_Valid(ea, EA_DATA) ? I_OR_DN : I_ILLEGAL;
+			if (EA_Valid(ea, EA_MEM_ALT)) return I_OR_EA;
+			if ((op & 0xF1F8) == 0x8100) return I_SBCD_DREG;
+			if ((op & 0xF1F8) == 0x8108) return I_SBCD_ADEC;
+			return I_ILLEGAL;
+
+		case 0x9:
+		case 0xD:
+			if (size == 3)
+			{
+				if (!EA_Valid(ea, EA_ALL)) return I_ILLEGAL;
+				if (op & 0x4000) return (op & 0x0100) ? I_ADDA_L : I_ADDA_W;
+				return (op & 0x0100) ? I_SUBA_L : I_SUBA_W;
+			}
+			if (!(op & 0x0100))
+			{
+				if (!EA_Valid(ea, EA_ALL) || ((size == 0) && ((ea >> 3) == 1))) return I_ILLEGAL;
+				return (op & 0x4000) ? I_ADD_DN : I_SUB_DN;
+			}
+			if (EA_Valid(ea, EA_MEM_ALT)) return (op & 0x4000) ? I_ADD_EA : I_SUB_EA;
+			if ((ea >> 3) == 0) return (op & 0x4000) ? I_ADDX_DREG : I_SUBX_DREG;
+			if ((ea >> 3) == 1) return (op & 0x4000) ? I_ADDX_ADEC : I_SUBX_ADEC;
+			return I_ILLEGAL;
+
+		case 0xA:
+			return I_LINE_A;
+
+		case 0xB:
+			if (size == 3)
+			{
+				if (!EA_Valid(ea, EA_ALL)) return I_ILLEGAL;
+				return (op & 0x0100) ? I_CMPA_L : I_CMPA_W;
+			}
+			if (!(op & 0x0100))
+			{
+				if (!EA_Valid(ea, EA_ALL) || ((size == 0) && ((ea >> 3) == 1))) return I_ILLEGAL;
+				return I_CMP_DN;
+			}
+			if (EA_Valid(ea, EA_DATA_ALT)) return I_EOR_EA;
+			if ((ea >> 3) == 1) return I_CMPM;
+			return I_ILLEGAL;
+
+		case 0xC:
+			if (size == 3)
+			{
+				if (!EA_Valid(ea, EA_DATA)) return I_ILLEGAL;
+				return (op & 0x0100) ? I_MULS : I_MULU;
+			}
+			if (!(op & 0x0100)) return EA_Valid(ea, EA_DATA) ? I_AND_DN : I_ILLEGAL;
+			if (EA_Valid(ea, EA_MEM_ALT)) return I_AND_EA;
+			switch(op & 0xF1F8)
+			{
+				case 0xC100: return I_ABCD_DREG;
+				case 0xC108: return I_ABCD_ADEC;
+				case 0xC140: return I_EXG_DD;
+				case 0xC148: return I_EXG_AA;
+				case 0xC188: return I_EXG_DA;
+			}
+			return I_ILLEGAL;
+
+		case 0xE:
+			if (size != 3) return I_SHIFT_REG;
+			if (!(op & 0x0800) && EA_Valid(ea, EA_MEM_ALT)) return I_SHIFT_MEM;
+			return I_ILLEGAL;
+
+		default:
+			return I_LINE_F;
+	}
+}
+
+
+/***************************/
+/* Instruction macros      */
+/***************************/
+
+#define NEXT(n)												\
+{															\
+	IO_Cycles -= (n);										\
+	if (IO_Cycles < 0) goto Exec_Quit;						\
+	goto Next_Op;											\
+}
+
+// for the instructions which can change the interrupt mask
+#define CHECKPOINT(n)										\
+{															\
+	IO_Cycles -= (n);										\
+	goto Exec_Checkpoint;									\
+}
+
+#define EXCEPTION(vector, n)								\
+{															\
+	Jump(Exception((vector), UNBASED_PC));					\
+	NEXT(n)													\
+}
+
+#define PRIVILEGED											\
+	if (!(main68k_context.sr & 0x2000))						\
+	{														\
+		PC -= 2;											\
+		EXCEPTION(0x20, 34)									\
+	}
+
+// register direct and immediate sources cost 2 more for the long ops
+#define REG_IMM_EA(ea)		((EA_Idx[ea] < 2) || ((ea) == 0x3C))
+
+
+/***************************/
+/* Starscream API          */
+/***************************/
+
+int main68k_init(void)
+{
+	UINT32 i;
+	int idx;
+
+	for(i = 0; i < 64; i++)
+	{
+		idx = Get_EA_Index(i);
+		if (idx < 0) idx = 0;
+
+		EA_Idx[i] = (UINT8) idx;
+		EA_Cyc[0][i] = EA_Time[idx];
+		EA_Cyc[1][i] = (UINT8) (EA_Time[idx] + ((idx >= 2) ? 4 : 0));
+		Move_Cyc[0][i] = Move_Time[idx];
+		Move_Cyc[1][i] = (UINT8) (Move_Time[idx] + ((Move_Time[idx]) ? 4 : 0));
+	}
+
+	for(i = 0; i < 0x10000; i++) Op_Table[i] = (UINT8) Decode(i);
+
+	return 0;
+}
+
+
+unsigned main68k_reset(void)
+{
+	UINT16 *p;
+	int i;
+
+	if ((Exec_Info & EXEC_RUNNING) || (main68k_context.s_fetch == NULL)) return 1;
+
+	Exec_Info = 0;
+	for(i = 0; i < 8; i++) DREG(i) = AREG(i) = 0;
+	main68k_context.asp = 0;
+	main68k_context.sr = 0x2700;
+	Set_Map(1);
+	main68k_context.pc = 1;
+	main68k_context.interrupts[0] = 0x10;
+
+	Rebase(0);
+	if (Exec_Info & EXEC_BADPC) return 1;
+
+	p = (UINT16 *) PC;
+	AREG(7) = ((UINT32) p[0] << 16) | p[1];
+	main68k_context.pc = ((UINT32) p[2] << 16) | p[3];
+	main68k_context.interrupts[0] = 0;
+
+	return (unsigned) -(int) (main68k_context.pc & 1);
+}
+
+
+unsigned main68k_exec(int odo)
+{
+	UINT32 op, ea, src, dst, res, adr, ret;
+	int size, reg, cycles;
+
+	if ((UINT32) odo <= main68k_context.odometer) return 0x80000003;
+	odo -= main68k_context.odometer;
+
+	if (main68k_context.interrupts[0] & 0x10)
+	{
+		if (main68k_context.pc & 1) return 0xFFFFFFFF;
+		main68k_context.odometer += odo;
+		return 0x80000004;
+	}
+
+	Cycles_Needed = odo;
+	IO_Cycles = odo - 1;
+	Set_CCR(main68k_context.sr);
+	Exec_Info = EXEC_RUNNING;
+
+	Rebase(main68k_context.pc);
+	if (Exec_Info & EXEC_BADPC)
+	{
+		ret = 0x80000001;
+		goto Exec_Exit;
+	}
+	Cycles_Leftover = 0;
+
+Exec_Checkpoint:
+	if (IO_Cycles < 0) goto Exec_Quit;
+
+	if (INT_PENDING(main68k_context.interrupts[0]))
+	{
+		Do_Interrupt();
+		if (IO_Cycles < 0) goto Exec_Quit;
+
+		if (Exec_Info & EXEC_BADPC)
+		{
+			ret = 0x80000001;
+			goto Exec_Exit;
+		}
+	}
+
+	for(;;)
+	{
+Next_Op:
+		op = FETCH_WORD;
+		PC += 2;
+
+		switch(Op_Table[op])
+		{
+			case I_ILLEGAL:
+				PC -= 2;
+				EXCEPTION(0x10, 34)
+
+			case I_LINE_A:
+				PC -= 2;
+				EXCEPTION(0x28, 34)
+
+			case I_LINE_F:
+				PC -= 2;
+				EXCEPTION(0x2C, 34)
+
+			// ORI, ANDI, SUBI, ADDI, EORI, CMPI
+
+			case I_IMM:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+
+				if (size == 4)
+				{
+					src = FETCH_LONG;
+					PC += 4;
+				}
+				else
+				{
+					src = FETCH_WORD & Size_Mask[size];
+					PC += 2;
+				}
+
+				if ((op & 0xFF00) == 0x0C00)
+				{
+					dst = Read_EA(ea, size);
+					Do_Sub(dst, src, 0, size);
+					if (ea < 8) NEXT((size == 4) ? 14 : 8)
+					NEXT(((size == 4) ? 12 : 8) + EA_CYCLES(ea, size))
+				}
+
+				dst = Read_RMW(ea, size);
+				switch(op & 0xFF00)
+				{
+					case 0x0000:
+						res = dst | src;
+						SET_LOGIC(res, size)
+						break;
+
+					case 0x0200:
+						res = dst & src;
+						SET_LOGIC(res, size)
+						break;
+
+					case 0x0A00:
+						res = dst ^ src;
+						SET_LOGIC(res, size)
+						break;
+
+					case 0x0400:
+						res = Do_Sub(dst, src, 0, size);
+						Flag_X = Flag_C;
+						break;
+
+					default:
+						res = Do_Add(dst, src, 0, size);
+						Flag_X = Flag_C;
+						break;
+				}
+				Write_RMW(ea, size, res);
+
+				if (ea < 8) NEXT((size != 4) ? 8 : ((op & 0xFF00) == 0x0200) ? 14 : 16)
+				NEXT(((size == 4) ? 20 : 12) + EA_CYCLES(ea, size))
+
+			// BTST, BCHG, BCLR, BSET
+
+			case I_BITOP_IMM:
+				src = FETCH_WORD & 0xFF;
+				PC += 2;
+				cycles = 4;
+				goto Bit_Op;
+
+			case I_BITOP_REG:
+				src = DREG((op >> 9) & 7) & 0xFF;
+				cycles = 0;
+
+			Bit_Op:
+				ea = op & 0x3F;
+				reg = (op >> 6) & 3;
+
+				if (ea < 8)
+				{
+					src = 1 << (src & 31);
+					dst = DREG(ea);
+					Flag_Z = !(dst & src);
+
+					switch(reg)
+					{
+						case 0: NEXT(6 + cycles)
+						case 1: DREG(ea) = dst ^ src; NEXT(8 + cycles)
+						case 2: DREG(ea) = dst & ~src; NEXT(10 + cycles)
+						default: DREG(ea) = dst | src; NEXT(8 + cycles)
+					}
+				}
+
+				src = 1 << (src & 7);
+				if (reg == 0)
+				{
+					dst = Read_EA(ea, 1);
+					Flag_Z = !(dst & src);
+					NEXT(4 + cycles + EA_CYCLES(ea, 1))
+				}
+
+				dst = Read_RMW(ea, 1);
+				Flag_Z = !(dst & src);
+				if (reg == 1) dst ^= src;
+				else if (reg == 2) dst &= ~src;
+				else dst |= src;
+				Write_RMW(ea, 1, dst);
+				NEXT(8 + cycles + EA_CYCLES(ea, 1))
+
+			// ORI, ANDI, EORI to CCR / SR
+
+			case I_CCR_OP:
+				src = FETCH_WORD;
+				PC += 2;
+				res = GET_CCR;
+				if ((op & 0x0F00) == 0x0000) res |= src;
+				else if ((op & 0x0F00) == 0x0200) res &= src;
+				else res ^= src;
+				Set_CCR(res);
+				NEXT(20)
+
+			case I_SR_OP:
+				PRIVILEGED
+				src = FETCH_WORD;
+				PC += 2;
+				res = GET_SR;
+				if ((op & 0x0F00) == 0x0000) res |= src;
+				else if ((op & 0x0F00) == 0x0200) res &= src;
+				else res ^= src;
+				Set_SR(res);
+				CHECKPOINT(20)
+
+			case I_MOVEP_MR:
+				adr = AREG(op & 7) + SEXT16(FETCH_WORD);
+				PC += 2;
+				reg = (op >> 9) & 7;
+
+				res = Read_Byte(adr) << 8;
+				res |= Read_Byte(adr + 2);
+				if (op & 0x40)
+				{
+					res = (res << 8) | Read_Byte(adr + 4);
+					res = (res << 8) | Read_Byte(adr + 6);
+					DREG(reg) = res;
+					NEXT(24)
+				}
+				DREG(reg) = (DREG(reg) & 0xFFFF0000) | res;
+				NEXT(16)
+
+			case I_MOVEP_RM:
+				adr = AREG(op & 7) + SEXT16(FETCH_WORD);
+				PC += 2;
+				src = DREG((op >> 9) & 7);
+
+				if (op & 0x40)
+				{
+					Write_Byte(adr, src >> 24);
+					Write_Byte(adr + 2, src >> 16);
+					adr += 4;
+				}
+				Write_Byte(adr, src >> 8);
+				Write_Byte(adr + 2, src);
+				NEXT((op & 0x40) ? 24 : 16)
+
+			case I_MOVE:
+				size = Move_Size[op >> 12];
+				ea = op & 0x3F;
+				src = Read_EA(ea, size);
+				cycles = 4 + EA_CYCLES(ea, size);
+
+				ea = ((op >> 3) & 0x38) | ((op >> 9) & 7);
+				Write_EA(ea, size, src);
+
+				// the asm tests the data after writememorydecdword, which leaves
+				// its halves swapped when the write goes outside RAM
+				if ((size == 4) && ((ea >> 3) == 4) && ((AREG(ea & 7) & 0xFFFFFF) < 0xE00000))
+					src = (src << 16) | (src >> 16);
+
+				SET_LOGIC(src, size)
+				NEXT(cycles + Move_Cyc[size == 4][ea])
+
+			case I_MOVEA_W:
+				ea = op & 0x3F;
+				AREG((op >> 9) & 7) = SEXT16(Read_EA(ea, 2));
+				NEXT(4 + EA_CYCLES(ea, 2))
+
+			case I_MOVEA_L:
+				ea = op & 0x3F;
+				AREG((op >> 9) & 7) = Read_EA(ea, 4);
+				NEXT(4 + EA_CYCLES(ea, 4))
+
+			case I_MOVE_FROM_SR:
+				ea = op & 0x3F;
+				Write_EA(ea, 2, GET_SR);
+				NEXT((ea < 8) ? 6 : 8 + EA_CYCLES(ea, 2))
+
+			case I_MOVE_TO_CCR:
+				ea = op & 0x3F;
+				Set_CCR(Read_EA(ea, 2));
+				NEXT(12 + EA_CYCLES(ea, 2))
+
+			case I_MOVE_TO_SR:
+				PRIVILEGED
+				ea = op & 0x3F;
+				Set_SR(Read_EA(ea, 2));
+				CHECKPOINT(12 + EA_CYCLES(ea, 2))
+
+			case I_JMP:
+				ea = op & 0x3F;
+				Jump(EA_Adr(ea, 4));
+				NEXT(Jmp_Time[EA_Idx[ea]])
+
+			case I_JSR:
+				ea = op & 0x3F;
+				adr = EA_Adr(ea, 4);
+				src = UNBASED_PC;
+				Jump(adr);
+				PUSH_LONG(src)
+				NEXT(Jsr_Time[EA_Idx[ea]])
+
+			case I_LEA:
+				ea = op & 0x3F;
+				AREG((op >> 9) & 7) = EA_Adr(ea, 4);
+				NEXT(Lea_Time[EA_Idx[ea]])
+
+			case I_PEA:
+				ea = op & 0x3F;
+				adr = EA_Adr(ea, 4);
+				PUSH_LONG(adr)
+				NEXT(Pea_Time[EA_Idx[ea]])
+
+			case I_CHK:
+				ea = op & 0x3F;
+				src = Read_EA(ea, 2);
+				dst = DREG((op >> 9) & 7);
+				Flag_N = Flag_Z = Flag_V = Flag_C = 0;
+
+				if ((INT16) dst < 0)
+				{
+					Flag_N = 1;
+					EXCEPTION(0x18, 40 + EA_CYCLES(ea, 2))
+				}
+				if ((INT16) dst > (INT16) src) EXCEPTION(0x18, 40 + EA_CYCLES(ea, 2))
+				NEXT(10 + EA_CYCLES(ea, 2))
+
+			// CLR doesn't read the destination
+
+			case I_CLR:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				Write_EA(ea, size, 0);
+				Flag_N = Flag_V = Flag_C = 0;
+				Flag_Z = 1;
+				if (ea < 8) NEXT((size == 4) ? 8 : 4)
+				NEXT(EA_CYCLES(ea, size) + ((size == 4) ? 12 : 6))
+
+			case I_TST:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				res = Read_EA(ea, size);
+				SET_LOGIC(res, size)
+				NEXT(4 + EA_CYCLES(ea, size))
+
+			case I_RESET:
+				PRIVILEGED
+				if (main68k_context.resethandler == NULL)
+				{
+					PC -= 2;
+					ret = UNBASED_PC & 0xFFFFFF;
+					goto Exec_Exit;
+				}
+				main68k_context.resethandler();
+				NEXT(132)
+
+			case I_NOP:
+				NEXT(4)
+
+			case I_STOP:
+				PRIVILEGED
+				src = FETCH_WORD;
+				PC += 2;
+				Set_SR(src);
+				main68k_context.interrupts[0] |= 0x10;
+
+				// forfeit the remaining cycles
+				IO_Cycles -= 4;
+				if (IO_Cycles >= 0) IO_Cycles = -1;
+				NEXT(0)
+
+			case I_RTE:
+				PRIVILEGED
+				adr = AREG(7);
+				Set_SR(Read_Word(adr));
+				if (main68k_context.sr & 0x2000) AREG(7) += 6;
+				else main68k_context.asp += 6;
+				Jump(Read_Long(adr + 2));
+				CHECKPOINT(20)
+
+			case I_RTS:
+				adr = Read_Long(AREG(7));
+				AREG(7) += 4;
+				Jump(adr);
+				NEXT(16)
+
+			case I_TRAPV:
+				if (Flag_V) EXCEPTION(0x1C, 38)
+				NEXT(4)
+
+			case I_RTR:
+				Set_CCR(Read_Word(AREG(7)));
+				AREG(7) += 2;
+				adr = Read_Long(AREG(7));
+				AREG(7) += 4;
+				Jump(adr);
+				NEXT(20)
+
+			// MOVEM takes its per register cycles as it goes, like the asm
+
+			case I_MOVEM_RM:
+				src = FETCH_WORD;
+				PC += 2;
+				ea = op & 0x3F;
+				size = (op & 0x40) ? 4 : 2;
+				adr = EA_Adr(ea, size);
+
+				for(reg = 0; reg < 16; reg++)
+				{
+					if (src & (1 << reg))
+					{
+						Write_Mem(adr, size, REG(reg), 0);
+						adr += size;
+						IO_Cycles -= size * 2;
+					}
+				}
+				NEXT(Movem_RM_Time[EA_Idx[ea]])
+
+			case I_MOVEM_MR:
+				src = FETCH_WORD;
+				PC += 2;
+				ea = op & 0x3F;
+				size = (op & 0x40) ? 4 : 2;
+				adr = EA_Adr(ea, size);
+
+				for(reg = 0; reg < 16; reg++)
+				{
+					if (src & (1 << reg))
+					{
+						res = Read_Mem(adr, size, 0);
+						REG(reg) = (size == 2) ? SEXT16(res) : res;
+						adr += size;
+						IO_Cycles -= size * 2;
+					}
+				}
+				NEXT(Movem_MR_Time[EA_Idx[ea]])
+
+			case I_MOVEM_POSTINC:
+				src = FETCH_WORD;
+				PC += 2;
+				size = (op & 0x40) ? 4 : 2;
+				adr = AREG(op & 7);
+
+				for(reg = 0; reg < 16; reg++)
+				{
+					if (src & (1 << reg))
+					{
+						res = Read_Mem(adr, size, 0);
+						REG(reg) = (size == 2) ? SEXT16(res) : res;
+						adr += size;
+						IO_Cycles -= size * 2;
+					}
+				}
+				AREG(op & 7) = adr;
+				NEXT(12)
+
+			// the mask is reversed, bit 0 is A7
+
+			case I_MOVEM_PREDEC:
+				src = FETCH_WORD;
+				PC += 2;
+				size = (op & 0x40) ? 4 : 2;
+				adr = AREG(op & 7);
+
+				for(reg = 15; reg >= 0; reg--, src >>= 1)
+				{
+					if (src & 1)
+					{
+						adr -= size;
+						IO_Cycles -= size * 2;
+						Write_Mem(adr, size, REG(reg), 0);
+					}
+				}
+				AREG(op & 7) = adr;
+				NEXT(8)
+
+			case I_LINK:
+				reg = op & 7;
+				src = AREG(reg);
+				PUSH_LONG(src)
+				AREG(reg) = AREG(7);
+				AREG(7) += SEXT16(FETCH_WORD);
+				PC += 2;
+				NEXT(16)
+
+			case I_UNLK:
+				reg = op & 7;
+				AREG(7) = AREG(reg);
+				src = Read_Long(AREG(7));
+				AREG(7) += 4;
+				AREG(reg) = src;
+				NEXT(12)
+
+			case I_TRAP:
+				EXCEPTION(0x80 + ((op & 0xF) << 2), 34)
+
+			case I_MOVE_TO_USP:
+				PRIVILEGED
+				main68k_context.asp = AREG(op & 7);
+				NEXT(4)
+
+			case I_MOVE_FROM_USP:
+				PRIVILEGED
+				AREG(op & 7) = main68k_context.asp;
+				NEXT(4)
+
+			case I_SWAP:
+				reg = op & 7;
+				res = (DREG(reg) >> 16) | (DREG(reg) << 16);
+				DREG(reg) = res;
+				SET_LOGIC(res, 4)
+				NEXT(4)
+
+			case I_EXT_W:
+				reg = op & 7;
+				res = SEXT8(DREG(reg)) & 0xFFFF;
+				Set_DREG(reg, res, 2);
+				SET_LOGIC(res, 2)
+				NEXT(4)
+
+			case I_EXT_L:
+				reg = op & 7;
+				res = SEXT16(DREG(reg));
+				DREG(reg) = res;
+				SET_LOGIC(res, 4)
+				NEXT(4)
+
+			case I_NEGX:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				dst = Read_RMW(ea, size);
+				reg = Flag_Z;
+				res = Do_Sub(0, dst, Flag_X, size);
+				Flag_Z &= reg;
+				Flag_X = Flag_C;
+				Write_RMW(ea, size, res);
+				if (ea < 8) NEXT((size == 4) ? 6 : 4)
+				NEXT(((size == 4) ? 12 : 8) + EA_CYCLES(ea, size))
+
+			case I_NEG:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				dst = Read_RMW(ea, size);
+				res = Do_Sub(0, dst, 0, size);
+				Flag_X = Flag_C;
+				Write_RMW(ea, size, res);
+				if (ea < 8) NEXT((size == 4) ? 6 : 4)
+				NEXT(((size == 4) ? 12 : 8) + EA_CYCLES(ea, size))
+
+			case I_NOT:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				res = ~Read_RMW(ea, size) & Size_Mask[size];
+				SET_LOGIC(res, size)
+				Write_RMW(ea, size, res);
+				if (ea < 8) NEXT((size == 4) ? 6 : 4)
+				NEXT(((size == 4) ? 12 : 8) + EA_CYCLES(ea, size))
+
+			// same as the asm, which loses the operand and stores 0 - X
+
+			case I_NBCD:
+				ea = op & 0x3F;
+				Read_RMW(ea, 1);
+				res = Do_SBCD(0, 0);
+				Write_RMW(ea, 1, res);
+				if (ea < 8) NEXT(6)
+				NEXT(8 + EA_CYCLES(ea, 1))
+
+			// Gens change: no write back to memory, and (An)+ / -(An) aren't updated either
+
+			case I_TAS:
+				ea = op & 0x3F;
+				if (ea < 8)
+				{
+					res = DREG(ea) & 0xFF;
+					SET_LOGIC(res, 1)
+					DREG(ea) |= 0x80;
+					NEXT(4)
+				}
+
+				src = AREG(ea & 7);
+				adr = EA_Adr(ea, 1);
+				if (((ea >> 3) == 3) || ((ea >> 3) == 4)) AREG(ea & 7) = src;
+				res = Read_Byte(adr);
+				SET_LOGIC(res, 1)
+				NEXT(14 + EA_CYCLES(ea, 1))
+
+			case I_ADDQ:
+			case I_SUBQ:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				src = (op >> 9) & 7;
+				if (!src) src = 8;
+
+				if ((ea >> 3) == 1)
+				{
+					cycles = (size == 4) ? 8 : 4;
+					if (op & 0x0100)
+					{
+						AREG(ea & 7) -= src;
+						if (size == 2) cycles += 4;
+					}
+					else AREG(ea & 7) += src;
+					NEXT(cycles)
+				}
+
+				dst = Read_RMW(ea, size);
+				if (op & 0x0100) res = Do_Sub(dst, src, 0, size);
+				else res = Do_Add(dst, src, 0, size);
+				Flag_X = Flag_C;
+				Write_RMW(ea, size, res);
+				if (ea < 8) NEXT((size == 4) ? 8 : 4)
+				NEXT(((size == 4) ? 12 : 8) + EA_CYCLES(ea, size))
+
+			case I_DBT:
+				PC += 2;
+				NEXT(8)
+
+			case I_DBCC:
+				if (Cond((op >> 8) & 0xF))
+				{
+					PC += 2;
+					NEXT(12)
+				}
+				/* fall through */
+
+			case I_DBF:
+				reg = op & 7;
+				res = (DREG(reg) - 1) & 0xFFFF;
+				DREG(reg) = (DREG(reg) & 0xFFFF0000) | res;
+				if (res == 0xFFFF)
+				{
+					PC += 2;
+					NEXT(14)
+				}
+				PC += (INT16) FETCH_WORD;
+				NEXT(10)
+
+			case I_SCC:
+				ea = op & 0x3F;
+				res = Cond((op >> 8) & 0xF) ? 0xFF : 0;
+				Write_EA(ea, 1, res);
+				if (ea < 8) NEXT(res ? 6 : 4)
+				NEXT(8 + EA_CYCLES(ea, 1))
+
+			// branches don't rebase
+
+			case I_BRA:
+				if (op & 0xFF) PC += (INT8) op;
+				else PC += (INT16) FETCH_WORD;
+				NEXT(10)
+
+			case I_BSR:
+				if (op & 0xFF)
+				{
+					src = UNBASED_PC;
+					PC += (INT8) op;
+				}
+				else
+				{
+					src = UNBASED_PC + 2;
+					PC += (INT16) FETCH_WORD;
+				}
+				PUSH_LONG(src)
+				NEXT(18)
+
+			case I_BCC:
+				if (op & 0xFF)
+				{
+					if (Cond((op >> 8) & 0xF))
+					{
+						PC += (INT8) op;
+						NEXT(10)
+					}
+					NEXT(8)
+				}
+				if (Cond((op >> 8) & 0xF))
+				{
+					PC += (INT16) FETCH_WORD;
+					NEXT(10)
+				}
+				PC += 2;
+				NEXT(12)
+
+			case I_MOVEQ:
+				res = SEXT8(op);
+				DREG((op >> 9) & 7) = res;
+				SET_LOGIC(res, 4)
+				NEXT(4)
+
+			// <ea>,Dn
+
+			case I_OR_DN:
+			case I_AND_DN:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, size);
+				if (op & 0x4000) res = DREG(reg) & src;
+				else res = (DREG(reg) | src) & Size_Mask[size];
+				Set_DREG(reg, res, size);
+				SET_LOGIC(res, size)
+				if (size != 4) NEXT(4 + EA_CYCLES(ea, size))
+				NEXT(6 + EA_CYCLES(ea, 4) + (REG_IMM_EA(ea) ? 2 : 0))
+
+			case I_SUB_DN:
+			case I_ADD_DN:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, size);
+				if (op & 0x4000) res = Do_Add(DREG(reg) & Size_Mask[size], src, 0, size);
+				else res = Do_Sub(DREG(reg) & Size_Mask[size], src, 0, size);
+				Flag_X = Flag_C;
+				Set_DREG(reg, res, size);
+				if (size != 4) NEXT(4 + EA_CYCLES(ea, size))
+				NEXT(6 + EA_CYCLES(ea, 4) + (REG_IMM_EA(ea) ? 2 : 0))
+
+			case I_CMP_DN:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				src = Read_EA(ea, size);
+				Do_Sub(DREG((op >> 9) & 7) & Size_Mask[size], src, 0, size);
+				NEXT(((size == 4) ? 6 : 4) + EA_CYCLES(ea, size))
+
+			// Dn,<ea>
+
+			case I_OR_EA:
+			case I_AND_EA:
+			case I_EOR_EA:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				dst = Read_RMW(ea, size);
+				src = DREG((op >> 9) & 7) & Size_Mask[size];
+				if ((op & 0xF000) == 0x8000) res = dst | src;
+				else if ((op & 0xF000) == 0xC000) res = dst & src;
+				else res = dst ^ src;
+				SET_LOGIC(res, size)
+				Write_RMW(ea, size, res);
+				cycles = 8 + EA_CYCLES(ea, size) + ((size == 4) ? 4 : 0);
+				if (ea < 8) cycles -= 4;
+				NEXT(cycles)
+
+			case I_SUB_EA:
+			case I_ADD_EA:
+				size = Size_Field[(op >> 6) & 3];
+				ea = op & 0x3F;
+				dst = Read_RMW(ea, size);
+				src = DREG((op >> 9) & 7) & Size_Mask[size];
+				if (op & 0x4000) res = Do_Add(dst, src, 0, size);
+				else res = Do_Sub(dst, src, 0, size);
+				Flag_X = Flag_C;
+				Write_RMW(ea, size, res);
+				NEXT(8 + EA_CYCLES(ea, size) + ((size == 4) ? 4 : 0))
+
+			case I_SUBA_W:
+			case I_ADDA_W:
+				ea = op & 0x3F;
+				src = SEXT16(Read_EA(ea, 2));
+				if (op & 0x4000) AREG((op >> 9) & 7) += src;
+				else AREG((op >> 9) & 7) -= src;
+				NEXT(8 + EA_CYCLES(ea, 2))
+
+			case I_SUBA_L:
+			case I_ADDA_L:
+				ea = op & 0x3F;
+				src = Read_EA(ea, 4);
+				if (op & 0x4000) AREG((op >> 9) & 7) += src;
+				else AREG((op >> 9) & 7) -= src;
+				NEXT(6 + EA_CYCLES(ea, 4) + (REG_IMM_EA(ea) ? 2 : 0))
+
+			case I_CMPA_W:
+				ea = op & 0x3F;
+				src = SEXT16(Read_EA(ea, 2));
+				Do_Sub(AREG((op >> 9) & 7), src, 0, 4);
+				NEXT(6 + EA_CYCLES(ea, 2))
+
+			case I_CMPA_L:
+				ea = op & 0x3F;
+				src = Read_EA(ea, 4);
+				Do_Sub(AREG((op >> 9) & 7), src, 0, 4);
+				NEXT(6 + EA_CYCLES(ea, 4))
+
+			// ADDX / SUBX, Z is only cleared
+
+			case I_SUBX_DREG:
+			case I_ADDX_DREG:
+				size = Size_Field[(op >> 6) & 3];
+				reg = (op >> 9) & 7;
+				src = DREG(op & 7) & Size_Mask[size];
+				dst = DREG(reg) & Size_Mask[size];
+				cycles = Flag_Z;
+				if (op & 0x4000) res = Do_Add(dst, src, Flag_X, size);
+				else res = Do_Sub(dst, src, Flag_X, size);
+				Flag_Z &= cycles;
+				Flag_X = Flag_C;
+				Set_DREG(reg, res, size);
+				NEXT((size == 4) ? 8 : 4)
+
+			case I_SUBX_ADEC:
+			case I_ADDX_ADEC:
+				size = Size_Field[(op >> 6) & 3];
+				src = Read_Mem(EA_Adr(0x20 | (op & 7), size), size, 1);
+				adr = EA_Adr(0x20 | ((op >> 9) & 7), size);
+				dst = Read_Mem(adr, size, 1);
+				cycles = Flag_Z;
+				if (op & 0x4000) res = Do_Add(dst, src, Flag_X, size);
+				else res = Do_Sub(dst, src, Flag_X, size);
+				Flag_Z &= cycles;
+				Flag_X = Flag_C;
+				Write_Mem(adr, size, res, 1);
+				NEXT((size == 4) ? 30 : 18)
+
+			case I_SBCD_DREG:
+			case I_ABCD_DREG:
+				reg = (op >> 9) & 7;
+				src = DREG(op & 7) & 0xFF;
+				dst = DREG(reg) & 0xFF;
+				if (op & 0x4000) res = Do_ABCD(dst, src);
+				else res = Do_SBCD(dst, src);
+				Set_DREG(reg, res, 1);
+				NEXT(6)
+
+			case I_SBCD_ADEC:
+			case I_ABCD_ADEC:
+				src = Read_Byte(EA_Adr(0x20 | (op & 7), 1));
+				adr = EA_Adr(0x20 | ((op >> 9) & 7), 1);
+				dst = Read_Byte(adr);
+				if (op & 0x4000) res = Do_ABCD(dst, src);
+				else res = Do_SBCD(dst, src);
+				Write_Byte(adr, res);
+				NEXT(18)
+
+			case I_CMPM:
+				size = Size_Field[(op >> 6) & 3];
+				src = Read_Mem(EA_Adr(0x18 | (op & 7), size), size, 0);
+				dst = Read_Mem(EA_Adr(0x18 | ((op >> 9) & 7), size), size, 0);
+				Do_Sub(dst, src, 0, size);
+				NEXT((size == 4) ? 20 : 12)
+
+			// 38 + 2n cycles, n = 1 bits of the source (MULU) or 01 / 10 pairs (MULS)
+
+			case I_MULU:
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, 2);
+				res = (DREG(reg) & 0xFFFF) * src;
+				DREG(reg) = res;
+				SET_LOGIC(res, 4)
+				NEXT(38 + 2 * Bit_Count(src) + EA_CYCLES(ea, 2))
+
+			case I_MULS:
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, 2);
+				res = (UINT32) ((INT32) (INT16) DREG(reg) * (INT32) (INT16) src);
+				DREG(reg) = res;
+				SET_LOGIC(res, 4)
+				NEXT(38 + 2 * Bit_Count((src ^ (src << 1)) & 0xFFFF) + EA_CYCLES(ea, 2))
+
+			case I_DIVU:
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, 2);
+				if (!src) EXCEPTION(0x14, 38 + EA_CYCLES(ea, 2))
+
+				dst = DREG(reg);
+				res = dst / src;
+				if (res > 0xFFFF)
+				{
+					Flag_N = Flag_Z = Flag_C = 0;
+					Flag_V = 1;
+					NEXT(133 + EA_CYCLES(ea, 2))
+				}
+				DREG(reg) = ((dst % src) << 16) | res;
+				SET_LOGIC(res, 2)
+				NEXT(133 + EA_CYCLES(ea, 2))
+
+			case I_DIVS:
+				ea = op & 0x3F;
+				reg = (op >> 9) & 7;
+				src = Read_EA(ea, 2);
+				if (!src) EXCEPTION(0x14, 38 + EA_CYCLES(ea, 2))
+
+				dst = DREG(reg);
+				if ((dst == 0x80000000) && (src == 0xFFFF)) res = 0x8000;		// overflows (the x86 would fault)
+				else res = (UINT32) ((INT32) dst / (INT32) (INT16) src);
+				if ((res + 0x8000) > 0xFFFF)
+				{
+					Flag_N = Flag_Z = Flag_C = 0;
+					Flag_V = 1;
+					NEXT(150 + EA_CYCLES(ea, 2))
+				}
+				res &= 0xFFFF;
+				DREG(reg) = ((UINT32) ((INT32) dst % (INT32) (INT16) src) << 16) | res;
+				SET_LOGIC(res, 2)
+				NEXT(150 + EA_CYCLES(ea, 2))
+
+			case I_EXG_DD:
+				src = DREG((op >> 9) & 7);
+				DREG((op >> 9) & 7) = DREG(op & 7);
+				DREG(op & 7) = src;
+				NEXT(6)
+
+			case I_EXG_AA:
+				src = AREG((op >> 9) & 7);
+				AREG((op >> 9) & 7) = AREG(op & 7);
+				AREG(op & 7) = src;
+				NEXT(6)
+
+			case I_EXG_DA:
+				src = DREG((op >> 9) & 7);
+				DREG((op >> 9) & 7) = AREG(op & 7);
+				AREG(op & 7) = src;
+				NEXT(6)
+
+			case I_SHIFT_REG:
+				size = Size_Field[(op >> 6) & 3];
+				reg = op & 7;
+				cycles = (size == 4) ? 8 : 6;
+
+				if (op & 0x20)
+				{
+					src = DREG((op >> 9) & 7) & 63;
+					if (!src)
+					{
+						res = DREG(reg) & Size_Mask[size];
+						SET_NZ(res, size)
+						Flag_V = 0;
+						Flag_C = ((op & 0x18) == 0x10) ? Flag_X : 0;
+						NEXT(cycles)
+					}
+				}
+				else
+				{
+					src = (op >> 9) & 7;
+					if (!src) src = 8;
+				}
+
+				res = Shift((op >> 3) & 3, op & 0x100, DREG(reg) & Size_Mask[size], src, size);
+				Set_DREG(reg, res, size);
+				NEXT(cycles + src * 2)
+
+			case I_SHIFT_MEM:
+				ea = op & 0x3F;
+				dst = Read_RMW(ea, 2);
+				res = Shift((op >> 9) & 3, op & 0x100, dst, 1, 2);
+				Write_RMW(ea, 2, res);
+				NEXT(8 + EA_CYCLES(ea, 2))
+		}
+	}
+
+Exec_Quit:
+	// pending interrupts above the mask are taken last
+	if (INT_PENDING(main68k_context.interrupts[0] & 7))
+	{
+		Do_Interrupt();
+
+		if (Exec_Info & EXEC_BADPC)
+		{
+			ret = 0x80000001;
+			goto Exec_Exit;
+		}
+	}
+
+	IO_Cycles += Cycles_Leftover;
+	Cycles_Leftover = 0;
+	if (IO_Cycles >= 0) goto Next_Op;
+
+	ret = 0x80000000;
+
+Exec_Exit:
+	main68k_context.pc = UNBASED_PC;
+	main68k_context.sr = (UINT16) ((main68k_context.sr & 0xFF00) | GET_CCR);
+	IO_Cycles++;
+	main68k_context.odometer += Cycles_Needed - IO_Cycles;
+	Exec_Info = 0;
+	Cycles_Needed = 0;
+	IO_Cycles = -1;
+
+	return ret;
+}
+
+
+int main68k_interrupt(int level)
+{
+	main68k_context.interrupts[0] = (unsigned char) level;
+	Cycles_Leftover += IO_Cycles + 1;
+	IO_Cycles = -1;
+
+	return 0;
+}
+
+
+void main68k_flushInterrupts(void)
+{
+	UINT32 level;
+
+	if (Exec_Info & EXEC_RUNNING) return;
+	if (!INT_PENDING(main68k_context.interrupts[0])) return;
+
+	level = main68k_context.interrupts[0] & 7;
+	if (level)
+	{
+		Set_CCR(main68k_context.sr);
+		main68k_context.pc = Exception((level + 0x18) * 4, main68k_context.pc);
+		main68k_context.sr = (UINT16) ((main68k_context.sr & 0xF8FF) | ((main68k_context.interrupts[0] & 7) << 8));
+		main68k_context.odometer += 44;
+		main68k_context.interrupts[0] = Int_Ack();
+	}
+}
+
+
+int main68k_GetContextSize(void)
+{
+	return sizeof(struct S68000CONTEXT);
+}
+
+
+void main68k_GetContext(void *context)
+{
+	memcpy(context, &main68k_context, sizeof(struct S68000CONTEXT));
+}
+
+
+void main68k_SetContext(void *context)
+{
+	memcpy(&main68k_context, context, sizeof(struct S68000CONTEXT));
+}
+
+
+int main68k_fetch(unsigned address)
+{
+	struct STARSCREAM_PROGRAMREGION *fetch = main68k_context.fetch;
+	UINT32 start = Fetch_Start, end = Fetch_End;
+	size_t base = Fetch_Base;
+	UINT8 *pc = PC;
+	int info = Exec_Info, cycles = IO_Cycles, needed = Cycles_Needed;
+	int data = -1;
+
+	main68k_context.fetch = main68k_context.s_fetch;
+	Exec_Info &= ~EXEC_BADPC;
+
+	Rebase(address);
+	if (!(Exec_Info & EXEC_BADPC)) data = FETCH_WORD;
+
+	main68k_context.fetch = fetch;
+	Fetch_Start = start;
+	Fetch_End = end;
+	Fetch_Base = base;
+	PC = pc;
+	Exec_Info = info;
+	IO_Cycles = cycles;
+	Cycles_Needed = needed;
+
+	return data;
+}
+
+
+unsigned main68k_readOdometer(void)
+{
+	return Cycles_Needed - IO_Cycles - 1 - Cycles_Leftover + main68k_context.odometer;
+}
+
+
+unsigned main68k_tripOdometer(void)
+{
+	unsigned odo;
+
+	main68k_context.odometer += Cycles_Needed - IO_Cycles - 1 - Cycles_Leftover;
+	Cycles_Needed = IO_Cycles + 1;
+
+	odo = main68k_context.odometer;
+	main68k_context.odometer = 0;
+	return odo;
+}
+
+
+unsigned main68k_controlOdometer(int n)
+{
+	if (n) return main68k_tripOdometer();
+	return main68k_readOdometer();
+}
+
+
+void main68k_releaseTimeslice(void)
+{
+	IO_Cycles -= Cycles_Needed;
+	Cycles_Needed = 0;
+}
+
+
+// the asm takes the cycles in eax, vdp_io.asm pushes them for this one
+
+void main68k_releaseCycles(int cycles)
+{
+	IO_Cycles -= cycles;
+}
+
+
+void main68k_addCycles(int cycles)
+{
+	main68k_context.odometer += cycles;
+}
+
+
+unsigned main68k_readPC(void)
+{
+	if (Exec_Info & EXEC_RUNNING) return UNBASED_PC;
+	return main68k_context.pc;
+}
+
+#endif
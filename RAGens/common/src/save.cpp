@@ -42,59 +42,162 @@ char BRAM_Dir[1024] = "";
 unsigned char State_Buffer[MAX_STATE_FILE_LENGHT];
 
 // ##RW
-int numMemstates = 0;
+// Memstates live in one contiguous ring as XOR deltas. memstateCurrent always
+// holds the newest state on the stack, and each entry holds the bytes that
+// changed between that state and the one pushed before it, XORed together and
+// run-length coded. Rewinding loads memstateCurrent, then XORs the newest entry
+// back into it to get the state underneath, so a push only costs as much ring
+// space as the frame changed and no keyframes are needed to walk back.
+int numMemstates = 0;		// states on the rewind stack
 int memstateSize = 0;
 int memstateAllocated = 0;
 int maxMemTakenByMemstates = 128 * 1024 * 1024; //##RW001 128MB Memory taken by Memstates (doubled the buffer size)
+int MemstateSeconds = 60;	// how far back rewinding can go
 
-struct Memstate *ptr_Memstates, *prev_Memstate, *next_Memstate; 
+struct Memstate
+{
+	int offset;		// in memstateRing
+	int size;
+	int clock;		// frame the state was pushed on
+};
+
+static BYTE *memstateRing, *memstateCurrent, *memstateNext, *memstateDelta;
+static int memstateRingSize, memstateHead;
+static struct Memstate *memstateEntries;
+static int memstateMaxEntries, memstateFirst, memstateClock;
 
 char cTemp[255];
 
-void allocate_Memstates(int datasize)
+static BYTE *Put_Memstate_Count(BYTE *out, unsigned int n)
 {
-	int maxnumstates = 100;
+	while(n >= 0x80)
+	{
+		*out++ = (BYTE) (n | 0x80);
+		n >>= 7;
+	}
+	*out++ = (BYTE) n;
+	return out;
+}
 
-	maxnumstates = maxMemTakenByMemstates / datasize;
+static const BYTE *Get_Memstate_Count(const BYTE *in, unsigned int *n)
+{
+	unsigned int shift = 0;
+	*n = 0;
+	do
+	{
+		*n |= (*in & 0x7F) << shift;
+		shift += 7;
+	} while(*in++ & 0x80);
+	return in;
+}
 
-	if(memstateAllocated == 1)
-      return;
+// Codes next against cur as (skip, count, count XOR bytes) runs ending with a
+// zero count, and leaves next in cur. Runs only break on two equal dwords in a
+// row, so short unchanged gaps don't cost a header each.
+static int Encode_Memstate_Delta(BYTE *cur, const BYTE *next, int len, BYTE *out)
+{
+	BYTE *start = out;
+	int words = len >> 2, last = 0, i = 0, j;
+	unsigned int *c = (unsigned int *) cur;
+	const unsigned int *n = (const unsigned int *) next;
 
-	struct Memstate *created_state, *first_state;
-	int i;
-	memstateSize = GENESIS_STATE_FILE_LENGHT_EX; // 152912byte
-	numMemstates = maxnumstates;
-	if(numMemstates <= 0)
+	while(i < words)
 	{
-		memstateAllocated = 0;
-		return;
+		if(c[i] == n[i])
+		{
+			i++;
+			continue;
+		}
+
+		int run = i;
+		while(i < words && (c[i] != n[i] || (i + 1 < words && c[i + 1] != n[i + 1])))
+			i++;
+
+		out = Put_Memstate_Count(out, (run - last) << 2);
+		out = Put_Memstate_Count(out, (i - run) << 2);
+		for(j = run; j < i; j++)
+		{
+			unsigned int x = c[j] ^ n[j];
+			memcpy(out, &x, 4);
+			out += 4;
+			c[j] = n[j];
+		}
+		last = i;
 	}
-	else
+
+	// bytes past the last whole dword go out as one run
+	if((len & 3) && memcmp(cur + (words << 2), next + (words << 2), len & 3))
 	{
-		memstateAllocated = 1;
+		out = Put_Memstate_Count(out, (words - last) << 2);
+		out = Put_Memstate_Count(out, len & 3);
+		for(j = words << 2; j < len; j++)
+		{
+			*out++ = cur[j] ^ next[j];
+			cur[j] = next[j];
+		}
 	}
 
-	// reserves first State
-	created_state = (struct Memstate *) malloc(sizeof(Memstate));
-	created_state->hasData = false;
-	created_state->buf = (BYTE *) malloc(datasize);
-	first_state = created_state;
-	prev_Memstate = first_state;
+	out = Put_Memstate_Count(out, 0);
+	out = Put_Memstate_Count(out, 0);
+	return (int) (out - start);
+}
+
+static void Apply_Memstate_Delta(BYTE *cur, const BYTE *in)
+{
+	unsigned int skip, count, pos = 0;
 
-	for(i=1; i < numMemstates; i++)
+	for(;;)
 	{
-		created_state = (struct Memstate *) malloc(sizeof(Memstate));
-		created_state->hasData = false;
-		created_state->buf = (BYTE *) malloc(datasize);
-		created_state->prev = prev_Memstate;
-		prev_Memstate->next = created_state;
-		prev_Memstate = created_state;
+		in = Get_Memstate_Count(in, &skip);
+		in = Get_Memstate_Count(in, &count);
+		if(count == 0)
+			break;
+		pos += skip;
+		for(unsigned int i = 0; i < count; i++)
+			cur[pos + i] ^= in[i];
+		in += count;
+		pos += count;
+	}
+}
+
+static void Reset_Memstates()
+{
+	numMemstates = 0;
+	memstateFirst = 0;
+	memstateHead = 0;
+	memstateClock = 0;
+	memset(memstateCurrent, 0, memstateSize);
+}
+
+void allocate_Memstates(int datasize)
+{
+	if(memstateAllocated == 1)
+		return;
+
+	// the ROM isn't started yet, so CPU_Mode can't tell PAL from NTSC here
+	memstateSize = datasize;
+	memstateRingSize = maxMemTakenByMemstates;
+	memstateMaxEntries = MemstateSeconds * 60;
+	if(memstateMaxEntries <= 0 || memstateRingSize < datasize * 2)
+	{
+		memstateAllocated = 0;
+		return;
+	}
+
+	memstateRing = (BYTE *) malloc(memstateRingSize);
+	memstateCurrent = (BYTE *) malloc(datasize);
+	memstateNext = (BYTE *) malloc(datasize);
+	memstateDelta = (BYTE *) malloc(datasize + datasize / 2 + 64);
+	memstateEntries = (struct Memstate *) malloc(memstateMaxEntries * sizeof(struct Memstate));
+	if(!memstateRing || !memstateCurrent || !memstateNext || !memstateDelta || !memstateEntries)
+	{
+		memstateAllocated = 1;
+		free_Memstates();
+		return;
 	}
 
-	// make list circular
-	created_state->next = first_state;
-	first_state->prev = created_state;
-	ptr_Memstates = first_state;
+	memstateAllocated = 1;
+	Reset_Memstates();
 }
 
 void free_Memstates()
@@ -102,23 +205,56 @@ void free_Memstates()
 	if(memstateAllocated == 0)
 		return;
 
-	struct Memstate *now_state;
+	free(memstateRing);
+	free(memstateCurrent);
+	free(memstateNext);
+	free(memstateDelta);
+	free(memstateEntries);
+	memstateRing = memstateCurrent = memstateNext = memstateDelta = NULL;
+	memstateEntries = NULL;
+	numMemstates = 0;
+
+	memstateAllocated = 0;
+}
+
+static void Drop_Oldest_Memstate()
+{
+	memstateFirst = (memstateFirst + 1) % memstateMaxEntries;
+	numMemstates--;
+}
 
-	now_state = ptr_Memstates;
-	prev_Memstate = now_state->prev;
-	prev_Memstate->next = NULL;
+// Finds room for size bytes at memstateHead, dropping the oldest states as needed.
+// Live entries always span from the oldest one's offset up to memstateHead.
+static int Make_Memstate_Room(int size)
+{
+	if(size > memstateRingSize)
+		return 0;
 
-	while(true)
+	for(;;)
 	{
-		if(now_state == NULL)
-			break;
-		next_Memstate = now_state->next;
-		free(now_state->buf);
-		free(now_state);
-		now_state = next_Memstate;
-	}
+		if(numMemstates == 0)
+		{
+			if(memstateHead + size > memstateRingSize)
+				memstateHead = 0;
+			return 1;
+		}
 
-	memstateAllocated = 0;
+		int tail = memstateEntries[memstateFirst].offset;
+		if(tail < memstateHead)
+		{
+			// free space is [head, end) and [0, tail)
+			if(memstateHead + size <= memstateRingSize)
+				return 1;
+			memstateHead = 0;
+		}
+		else
+		{
+			// free space is [head, tail)
+			if(memstateHead + size <= tail)
+				return 1;
+			Drop_Oldest_Memstate();
+		}
+	}
 }
 
 void save_Memstate()
@@ -130,10 +266,30 @@ void save_Memstate()
 	}
 	if(memstateAllocated == 0)
 		return;
-	// hier ptr_Memstates->buf saven!
-	Save_Memstate(ptr_Memstates->buf);
-	ptr_Memstates->hasData = true;
-	ptr_Memstates = ptr_Memstates->next;
+
+	Save_Memstate(memstateNext);
+	int size = Encode_Memstate_Delta(memstateCurrent, memstateNext, memstateSize, memstateDelta);
+
+	memstateClock += MemstateFrameSkip + 1;
+	int window = MemstateSeconds * (CPU_Mode ? 50 : 60);
+	while(numMemstates > 0 && (numMemstates == memstateMaxEntries || memstateClock - memstateEntries[memstateFirst].clock > window))
+		Drop_Oldest_Memstate();
+
+	if(!Make_Memstate_Room(size))
+	{
+		// memstateCurrent already moved on, so the older deltas no longer lead anywhere
+		numMemstates = 0;
+		memstateFirst = 0;
+		return;
+	}
+
+	struct Memstate *entry = &memstateEntries[(memstateFirst + numMemstates) % memstateMaxEntries];
+	entry->offset = memstateHead;
+	entry->size = size;
+	entry->clock = memstateClock;
+	memcpy(memstateRing + memstateHead, memstateDelta, size);
+	memstateHead += size;
+	numMemstates++;
 }
 
 int load_Memstate()
@@ -142,22 +298,98 @@ int load_Memstate()
 	if( RA_HardcoreModeIsActive() )
 		return 0;
 
-	if(memstateAllocated == 0)
+	if(memstateAllocated == 0 || numMemstates == 0)
 		return 0;
 
-	int ret_val = 0;
-	prev_Memstate = ptr_Memstates->prev;
+	struct Memstate *entry = &memstateEntries[(memstateFirst + numMemstates - 1) % memstateMaxEntries];
+
+	Load_Memstate(memstateCurrent);
+	Apply_Memstate_Delta(memstateCurrent, memstateRing + entry->offset);
+	memstateHead = entry->offset;
+	memstateClock = entry->clock - (MemstateFrameSkip + 1);
+	numMemstates--;
+
+	return 1;
+}
+
+// Pushes a memstate on every one of the next frames, then rewinds all the way
+// back and writes a line with the delta sizes, rewind depth and timings to
+// report. The rewind history is discarded.
+int Memstate_Benchmark(int frames, char *report, int reportSize)
+{
+	LARGE_INTEGER freq, t0, t1;
+	double pushTime = 0, popTime = 0;
+	double bytes = 0;
+	int maxBytes = 0, pushes = 0, dropped = 0, depth, rewound = 0, match = -1;
+	const char *sys;
+	BYTE *first;
+	int skip = MemstateFrameSkip;
+
+	if(Genesis_Started) sys = "Genesis";
+	else if(SegaCD_Started) sys = "Sega CD";
+	else if(_32X_Started) sys = "32X";
+	else return 0;
 
-	if(prev_Memstate->hasData)
+	if(memstateAllocated == 0 || RA_HardcoreModeIsActive() || frames <= 0)
+		return 0;
+	if((first = (BYTE *) malloc(memstateSize)) == NULL)
+		return 0;
+
+	QueryPerformanceFrequency(&freq);
+	MemstateFrameSkip = 0;
+	Reset_Memstates();
+
+	for(int i = 0; i < frames; i++)
 	{
-		// hier aus prev_Memstate->buf lesen
-		Load_Memstate(prev_Memstate->buf);
-		prev_Memstate->hasData = false;
-		ptr_Memstates = ptr_Memstates->prev;
-		ret_val = 1;
+		Update_Frame_Fast();
+
+		int before = numMemstates;
+		QueryPerformanceCounter(&t0);
+		save_Memstate();
+		QueryPerformanceCounter(&t1);
+		pushTime += (double) (t1.QuadPart - t0.QuadPart);
+
+		if(numMemstates <= before)
+			dropped += before + 1 - numMemstates;
+		if(numMemstates == 0)
+			continue;
+		struct Memstate *entry = &memstateEntries[(memstateFirst + numMemstates - 1) % memstateMaxEntries];
+		if(i == 0)
+			memcpy(first, memstateCurrent, memstateSize);
+		else
+		{
+			// the first push is coded against zeros, which is a keyframe in all but name
+			bytes += entry->size;
+			if(entry->size > maxBytes)
+				maxBytes = entry->size;
+		}
+		pushes++;
 	}
 
-	return ret_val;
+	depth = numMemstates;
+	while(numMemstates > 0)
+	{
+		if(numMemstates == 1 && dropped == 0)
+			match = memcmp(memstateCurrent, first, memstateSize) == 0;
+		QueryPerformanceCounter(&t0);
+		rewound += load_Memstate();
+		QueryPerformanceCounter(&t1);
+		popTime += (double) (t1.QuadPart - t0.QuadPart);
+	}
+
+	MemstateFrameSkip = skip;
+	Reset_Memstates();
+	free(first);
+
+	_snprintf(report, reportSize,
+		"%s: %d frames, state %d bytes, %.0f bytes/frame (max %d), depth %d frames (%.1f s) in %d KB, push %.1f us, rewind %.1f us, %s",
+		sys, pushes, memstateSize, pushes > 1 ? bytes / (pushes - 1) : 0.0, maxBytes,
+		depth, depth / (CPU_Mode ? 50.0 : 60.0), memstateRingSize / 1024,
+		pushTime * 1000000.0 / freq.QuadPart / pushes, rewound ? popTime * 1000000.0 / freq.QuadPart / rewound : 0.0,
+		match < 0 ? "oldest state not checked" : match ? "oldest state matches" : "OLDEST STATE MISMATCH");
+	report[reportSize - 1] = 0;
+
+	return match != 0;
 }
 
 // ##RW - End
@@ -370,6 +602,8 @@ extern unsigned char RAMByteReader( unsigned int nOffs );
 extern void RAMByteWriter( unsigned int nOffs, unsigned int nVal );
 extern unsigned char RAMByteReaderSegaCD( unsigned int nOffs );
 extern void RAMByteWriterSegaCD( unsigned int nOffs, unsigned int nVal );
+extern unsigned int RAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+extern unsigned int RAMBlockReaderSegaCD( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
 
 int Load_Memstate(BYTE *memBuf)
 {
@@ -421,11 +655,13 @@ int Load_Memstate(BYTE *memBuf)
 			if( SegaCD_Started )
 			{
 				RA_InstallMemoryBank( 0, &RAMByteReaderSegaCD, &RAMByteWriterSegaCD, 512 * 1024 );
+				RA_InstallMemoryBankBlockReader( 0, &RAMBlockReaderSegaCD );
 				RA_OnLoadNewRom( CD_Data, 512 );
 			}
 			else
 			{
 				RA_InstallMemoryBank( 0, &RAMByteReader, &RAMByteWriter, 64 * 1024 );
+				RA_InstallMemoryBankBlockReader( 0, &RAMBlockReader );
 				RA_OnLoadNewRom( Rom_Data, 6*1024*1024 );
 			}
 		}
@@ -1230,6 +1466,8 @@ int Save_Config(char *File_Name)
 	//##RW001
 	wsprintf(Str_Tmp, "%d", MemstateFrameSkip);
 	WritePrivateProfileString("REWiND", "REWiND Frameskip", Str_Tmp, Conf_File);
+	wsprintf(Str_Tmp, "%d", MemstateSeconds);
+	WritePrivateProfileString("REWiND", "REWiND Seconds", Str_Tmp, Conf_File);
 
 	wsprintf(Str_Tmp, "%d", Full_Screen & 1);
 	WritePrivateProfileString("Graphics", "Full Screen", Str_Tmp, Conf_File);
@@ -1682,6 +1920,7 @@ int Load_Config(char *File_Name, void *Game_Active)
 	Gens_Priority = GetPrivateProfileInt("General", "Priority", 1, Conf_File);
 
 	MemstateFrameSkip = GetPrivateProfileInt("REWiND", "REWiND Frameskip", 0, Conf_File);	//##RW001
+	MemstateSeconds = GetPrivateProfileInt("REWiND", "REWiND Seconds", 60, Conf_File);
 
 	if (GetPrivateProfileInt("Graphics", "Force 555", 0, Conf_File)) Mode_555 = 3;
 	else if (GetPrivateProfileInt("Graphics", "Force 565", 0, Conf_File)) Mode_555 = 2;
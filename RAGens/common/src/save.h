@@ -45,28 +45,14 @@ void Format_Backup_Ram(void);
 extern int numMemstates;
 extern int memstateSize;
 extern int memstateAllocated;
-
-void allocate_Memstates(int maxnumstates);
-void free_Memstates();
-void save_Memstate();
-int load_Memstate();
-int Load_Memstate(BYTE *memBuf);
-int Save_Memstate(BYTE *memBuf);
-
-struct Memstate
-{
-	int hasData;
-	BYTE *buf;
-	struct Memstate *prev;
-	struct Memstate *next;
-};
-
-extern struct Memstate *ptr_Memstates, *prev_Memstate, *next_Memstate;
+extern int maxMemTakenByMemstates;
+extern int MemstateSeconds;
 
 void allocate_Memstates(int datasize);
 void free_Memstates();
 void save_Memstate();
 int load_Memstate();
+int Memstate_Benchmark(int frames, char *report, int reportSize);
 int Load_Memstate(BYTE *memBuf);
 int Save_Memstate(BYTE *memBuf);
 
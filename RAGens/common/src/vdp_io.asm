@@ -1155,7 +1155,13 @@ section .text align=64
 		mov [DMAT_Lenght], eax
 		mov [VDP_Reg.DMA_Address], esi
 		call Update_DMA
+%ifdef GENS_C_CORES
+		push eax
+		call _main68k_releaseCycles				; cdecl in main68k_c.c
+		add esp, byte 4
+%else
 		call _main68k_releaseCycles
+%endif
 		pop esi
 		pop edi
 		pop edx
@@ -1665,10 +1671,9 @@ section .text align=64
 		test byte [VDP_Int], 0x8
 		jz short .No_V_Int
 
-		push dword -1
 		push dword 6
 		call _main68k_interrupt
-		add esp, 8
+		add esp, 4
 		ret
 
 	ALIGN4
@@ -1679,10 +1684,9 @@ section .text align=64
 		test byte [VDP_Int], 0x4
 		jz short .No_H_Int
 
-		push dword -1
 		push dword 4
 		call _main68k_interrupt
-		add esp, 8
+		add esp, 4
 		ret
 
 	ALIGN4
@@ -1643,6 +1643,8 @@ ALIGN4
 
 ; *******************************************************
 
+%ifndef GENS_C_CORES						; vdp_rend_c.c has the C version
+
 	DECL Render_Line
 
 		pushad
@@ -1814,6 +1816,10 @@ ALIGN4
 
 
 
+%endif
+
+
+
 ; *******************************************************
 
 	DECL Render_Line_32X
@@ -0,0 +1,607 @@
+/***********************************************************
+ *                                                         *
+ * VDP_REND_C.C : portable Render_Line                     *
+ *                                                         *
+ * C version of Render_Line from vdp_rend.asm, built in    *
+ * place of it with GENS_C_CORES. It follows the asm step  *
+ * by step (same MD_Screen layout, same sprite cache and   *
+ * same quirks) so both produce the same screen.           *
+ * The data and Render_Line_32X stay in vdp_rend.asm.      *
+ *                                                         *
+ ***********************************************************/
+
+#ifdef GENS_C_CORES
+
+#include <string.h>
+#include "vdp_io.h"
+#include "vdp_rend.h"
+
+#define HIGH_B   0x80
+#define SHAD_B   0x40
+#define PRIO_B   0x01
+#define SPR_B    0x20
+
+#define HIGH_W   0x8080
+#define SHAD_W   0x4040
+#define NOSHAD_W 0xBFBF
+#define PRIO_W   0x0100
+#define SPR_W    0x2000
+
+// vdp_io.asm variables which don't have a C declaration
+
+extern unsigned char *ScrA_Addr, *ScrB_Addr, *Win_Addr, *Spr_Addr, *H_Scroll_Addr;
+extern int H_Cell, H_Win_Mul, H_Pix, H_Pix_Begin;
+extern int H_Scroll_Mask, H_Scroll_CMul, H_Scroll_CMask, V_Scroll_CMask, V_Scroll_MMask;
+extern int Win_X_Pos, Win_Y_Pos;
+
+// vdp_rend.asm variables, shared with Render_Line_32X
+
+extern int Sprite_Visible[0x100];
+extern struct
+{
+	int Pattern_Adr;
+	int Line_7;
+	int X;
+	int Cell;
+	int Start_A;
+	int Lenght_A;
+	int Start_W;
+	int Lenght_W;
+	int Mask;
+	int Spr_End;
+	int Next_Cell;
+	int Palette;
+	int Borne;
+} Data_Misc;
+
+static const unsigned int Mask_N[8] =
+{
+	0xFFFFFFFF, 0xFFF0FFFF, 0xFF00FFFF, 0xF000FFFF,
+	0x0000FFFF, 0x0000FFF0, 0x0000FF00, 0x0000F000
+};
+
+static const unsigned int Mask_F[8] =
+{
+	0xFFFFFFFF, 0xFFFF0FFF, 0xFFFF00FF, 0xFFFF000F,
+	0xFFFF0000, 0x0FFF0000, 0x00FF0000, 0x000F0000
+};
+
+// Pixel shifts in a pattern line (VRam is stored as byte swapped words)
+
+static const int Pixel_Shift[2][8] =
+{
+	{12,  8,  4,  0, 28, 24, 20, 16},		// normal
+	{16, 20, 24, 28,  0,  4,  8, 12}		// H-Flip
+};
+
+
+#define VRAM_L(adr)	(*(unsigned int *) (VRam + (adr)))
+#define VSRAM_W(n)	(((unsigned short *) VSRam)[n])
+
+
+/* One pattern line of a scroll plane or the window.
+ * dest = 8 pixels of MD_Screen, data = pattern line, pal = palette * 16,
+ * scr_a = 0 for scroll B and 1 for scroll A / window, hs = Shadow/Highlight.
+ * Low priority pixels only go in the color byte, the high ones set PRIO_B. */
+
+static __inline void Put_Line(unsigned short *dest, unsigned int data, unsigned int info, int scr_a, int hs)
+{
+	const int *shift = Pixel_Shift[(info >> 11) & 1];
+	unsigned int pal = (info >> 9) & 0x30;
+	unsigned int px;
+	int i;
+
+	if (info & 0x8000)
+	{
+		if (!scr_a) memset(dest, 0, 8 * 2);
+		else if (hs) for(i = 0; i < 8; i++) dest[i] &= NOSHAD_W;
+
+		if (data == 0) return;
+
+		for(i = 0; i < 8; i++)
+		{
+			if ((px = (data >> shift[i]) & 0xF) != 0)
+				dest[i] = (unsigned short) (px + pal + PRIO_W);
+		}
+	}
+	else
+	{
+		if (!scr_a)
+		{
+			for(i = 0; i < 8; i++) dest[i] = hs ? SHAD_W : 0;
+		}
+
+		if (data == 0) return;
+
+		for(i = 0; i < 8; i++)
+		{
+			unsigned char *d = (unsigned char *) &dest[i];
+
+			if ((px = (data >> shift[i]) & 0xF) == 0) continue;
+
+			if (scr_a)
+			{
+				if (d[1] & PRIO_B) continue;
+				d[0] = (unsigned char) (px + pal + (hs ? (d[1] & SHAD_B) : 0));
+			}
+			else d[0] = (unsigned char) (px + pal + (hs ? SHAD_B : 0));
+		}
+	}
+}
+
+
+/* Pattern data of a cell, ebx in the asm */
+
+static __inline unsigned int Get_Pattern_Data(unsigned int info, int line_7, int interlace)
+{
+	if (info & 0x1000) line_7 ^= 7;
+
+	if (interlace) return VRAM_L(((info & 0x7FF) << 6) + line_7 * 8);
+	else return VRAM_L(((info & 0x7FF) << 5) + line_7 * 4);
+}
+
+
+/* UPDATE_Y_OFFSET : new V cell offset for 2 cells V scroll */
+
+static __inline void Update_Y_Offset(int cell, int scr_a, int interlace, int *y_cell, int *line_7)
+{
+	unsigned int y;
+
+	if (cell & 0xFF81) return;
+
+	y = VSRAM_W(cell + (scr_a ? 0 : 1));
+	if (interlace) y >>= 1;
+	y += VDP_Current_Line;
+
+	*line_7 = y & 7;
+	*y_cell = (y >> 3) & V_Scroll_CMask;
+}
+
+
+static void Render_Line_Scroll_B(unsigned short *line, int interlace, int vscroll_cell, int hs)
+{
+	unsigned short *hscr = (unsigned short *) H_Scroll_Addr;
+	unsigned short *dest;
+	unsigned int x, y, info;
+	int x_cell, y_cell, line_7, cell, n;
+
+	x = hscr[(VDP_Current_Line & H_Scroll_Mask) * 2 + 1];
+
+	dest = line + (x & 7);
+	x_cell = (x ^ 0x3FF) >> 3;
+	cell = (x_cell & 1) - 2;				// we start at cell -2 or -1 (for the V scroll)
+	x_cell &= H_Scroll_CMask;
+
+	y = VSRAM_W(1);
+	if (interlace) y >>= 1;
+	y += VDP_Current_Line;
+	line_7 = y & 7;
+	y_cell = (y >> 3) & V_Scroll_CMask;
+
+	for(n = H_Cell; n >= 0; n--)
+	{
+		if (vscroll_cell && (n != H_Cell)) Update_Y_Offset(cell, 0, interlace, &y_cell, &line_7);
+
+		info = ((unsigned short *) ScrB_Addr)[x_cell + (y_cell << H_Scroll_CMul)];
+		Put_Line(dest, Get_Pattern_Data(info, line_7, interlace), info, 0, hs);
+
+		cell++;
+		x_cell = (x_cell + 1) & H_Scroll_CMask;
+		dest += 8;
+	}
+}
+
+
+static void Render_Line_Window(unsigned short *line, int start, int length, int interlace, int hs)
+{
+	unsigned short *pat;
+	unsigned short *dest;
+	unsigned int info;
+	int line_7;
+
+	pat = (unsigned short *) Win_Addr + ((VDP_Current_Line >> 3) << H_Win_Mul);
+	dest = line + start * 8 + 8;			// no clipping for the window
+	line_7 = VDP_Current_Line & 7;
+
+	do
+	{
+		info = pat[start++];
+		Put_Line(dest, Get_Pattern_Data(info, line_7, interlace), info, 1, hs);
+		dest += 8;
+	} while(--length);
+}
+
+
+static void Render_Line_Scroll_A_Win(unsigned short *line, int interlace, int vscroll_cell, int hs)
+{
+	unsigned short *hscr = (unsigned short *) H_Scroll_Addr;
+	unsigned short *dest;
+	unsigned int x, y, info, data;
+	int start_a, length_a, start_w, length_w;
+	int x_cell, y_cell, line_7, cell, mask;
+
+	if ((unsigned) (VDP_Current_Line >> 3) >= (unsigned) Win_Y_Pos)
+	{
+		if (VDP_Reg.Win_V_Pos & 0x80)
+		{
+			Render_Line_Window(line, 0, H_Cell, interlace, hs);
+			return;
+		}
+	}
+	else if (!(VDP_Reg.Win_V_Pos & 0x80))
+	{
+		Render_Line_Window(line, 0, H_Cell, interlace, hs);
+		return;
+	}
+
+	if (VDP_Reg.Win_H_Pos & 0x80)
+	{
+		start_w = Win_X_Pos;
+		length_w = H_Cell - Win_X_Pos;
+		start_a = 0;
+		length_a = Win_X_Pos - 1;			// the last cell is always rendered apart
+	}
+	else
+	{
+		start_w = 0;
+		length_w = Win_X_Pos;
+		start_a = Win_X_Pos;
+		length_a = H_Cell - Win_X_Pos - 1;
+	}
+
+	if (length_a < 0)
+	{
+		Render_Line_Window(line, start_w, length_w, interlace, hs);
+		return;
+	}
+
+	x = hscr[(VDP_Current_Line & H_Scroll_Mask) * 2];
+
+	mask = x & 7;
+	dest = line + mask + start_a * 8;
+	x_cell = (x ^ 0x3FF) >> 3;
+	cell = start_a + (x_cell & 1) - 2;		// we start at cell -2 or -1 (for the V scroll)
+	x_cell = (x_cell + start_a) & H_Scroll_CMask;
+
+	if (cell < 0) y = VSRAM_W(0);
+	else y = VSRAM_W(cell & V_Scroll_MMask);
+	if (interlace) y >>= 1;
+	y += VDP_Current_Line;
+	line_7 = y & 7;
+	y_cell = (y >> 3) & V_Scroll_CMask;
+
+	for(;;)
+	{
+		info = ((unsigned short *) ScrA_Addr)[x_cell + (y_cell << H_Scroll_CMul)];
+		Put_Line(dest, Get_Pattern_Data(info, line_7, interlace), info, 1, hs);
+
+		cell++;
+		x_cell = (x_cell + 1) & H_Scroll_CMask;
+		dest += 8;
+
+		if (vscroll_cell) Update_Y_Offset(cell, 1, interlace, &y_cell, &line_7);
+
+		if (--length_a < 0) break;
+	}
+
+	// last cell, clipped by the scroll offset
+
+	info = ((unsigned short *) ScrA_Addr)[x_cell + (y_cell << H_Scroll_CMul)];
+	data = Get_Pattern_Data(info, line_7, interlace);
+	data &= (info & 0x0800) ? Mask_F[mask] : Mask_N[mask];
+	Put_Line(dest, data, info, 1, hs);
+
+	if (length_w & 0xFF) Render_Line_Window(line, start_w, length_w, interlace, hs);
+}
+
+
+/* MAKE_SPRITE_STRUCT : sprite cache rebuilt from the sprite table */
+
+static void Make_Sprite_Struct(int interlace)
+{
+	unsigned char *spr = Spr_Addr;
+	unsigned int size, link;
+	int n = 0;
+	int y;
+
+	for(;;)
+	{
+		y = *(unsigned short *) (spr + 0);
+		if (interlace) y >>= 1;				// in interlace mode the position is divided by 2
+
+		size = spr[2 ^ 1];
+		link = spr[3 ^ 1] & 0x7F;
+
+		Sprite_Struct[n].Pos_Y = (y & 0x1FF) - 0x80;
+		Sprite_Struct[n].Pos_X = (*(unsigned short *) (spr + 6) & 0x1FF) - 0x80;
+		Sprite_Struct[n].Size_X = ((size >> 2) & 3) + 1;
+		Sprite_Struct[n].Size_Y = size & 3;
+		Sprite_Struct[n].Pos_X_Max = Sprite_Struct[n].Pos_X + Sprite_Struct[n].Size_X * 8 - 1;
+		Sprite_Struct[n].Pos_Y_Max = Sprite_Struct[n].Pos_Y + Sprite_Struct[n].Size_Y * 8 + 7;
+		Sprite_Struct[n].Num_Tile = *(unsigned short *) (spr + 4);
+		n++;
+
+		if ((link == 0) || (n >= 80)) break;
+		spr = Spr_Addr + link * 8;
+	}
+
+	Data_Misc.Spr_End = (n - 1) * 8 * 4;
+}
+
+
+/* MAKE_SPRITE_STRUCT_PARTIAL : only X and the tile changed.
+ * Doesn't touch Size_X and Spr_End, same as the asm. */
+
+static void Make_Sprite_Struct_Partial(void)
+{
+	unsigned char *spr = Spr_Addr;
+	unsigned int link;
+	int n = 0;
+
+	for(;;)
+	{
+		link = spr[3 ^ 1] & 0x7F;
+
+		Sprite_Struct[n].Num_Tile = *(unsigned short *) (spr + 4);
+		Sprite_Struct[n].Pos_X = (*(unsigned short *) (spr + 6) & 0x1FF) - 0x80;
+		Sprite_Struct[n].Pos_X_Max = Sprite_Struct[n].Pos_X + (spr[2 ^ 1] & 0x0C) * 2 + 7;
+
+		if (link == 0) break;
+		if (++n >= 80) break;
+		spr = Spr_Addr + link * 8;
+	}
+}
+
+
+#define ON_LINE(n)	((Sprite_Struct[n].Pos_Y <= line) && (Sprite_Struct[n].Pos_Y_Max >= line))
+#define ON_SCREEN(n)	((Sprite_Struct[n].Pos_X < H_Pix) && (Sprite_Struct[n].Pos_X_Max >= 0))
+
+/* UPDATE_MASK_SPRITE : fills Sprite_Visible with the sprites of the current line.
+ * The mask (X = -128) only works after a first sprite on the line. */
+
+static int Update_Mask_Sprite(int limit)
+{
+	int line = VDP_Current_Line;
+	int last = Data_Misc.Spr_End / (8 * 4);
+	int cells = H_Cell;
+	int nb = 0;
+	int n = 0;
+
+	for(; n <= last; n++)
+	{
+		if (!ON_LINE(n)) continue;
+
+		if (limit) cells -= Sprite_Struct[n].Size_X;
+		if (ON_SCREEN(n)) Sprite_Visible[nb++] = n * 8 * 4;
+		n++;
+		goto First_Done;
+	}
+	return nb;
+
+First_Done:
+
+	for(; n <= last; n++)
+	{
+		if (ON_LINE(n))
+		{
+			if (Sprite_Struct[n].Pos_X == -128) return nb;	// next sprites are masked
+
+			if (limit) cells -= Sprite_Struct[n].Size_X;
+			if (ON_SCREEN(n)) Sprite_Visible[nb++] = n * 8 * 4;
+		}
+
+		if (limit && (cells <= 0))
+		{
+			for(n++; n <= last; n++)
+			{
+				if (ON_LINE(n))
+				{
+					VDP_Status |= 0x40;
+					break;
+				}
+			}
+			return nb;
+		}
+	}
+
+	return nb;
+}
+
+
+/* One pattern line of a sprite, x is relative to the 8 pixels left border.
+ * Returns the collision bit for VDP_Status. */
+
+static __inline int Put_Line_Sprite(unsigned short *line, int x, unsigned int data, unsigned int pal, int flip, int prio, int hs)
+{
+	const int *shift = Pixel_Shift[flip];
+	unsigned char *d;
+	unsigned int px, c;
+	int collision = 0;
+	int i;
+
+	for(i = 0; i < 8; i++)
+	{
+		if ((px = (data >> shift[i]) & 0xF) == 0) continue;
+
+		d = (unsigned char *) &line[x + i + 8];
+
+		if (d[1] & (PRIO_B + SPR_B - prio))
+		{
+			collision |= d[1];
+			if (!prio) d[1] |= SPR_B;
+			continue;
+		}
+
+		px += pal;
+
+		if (hs)
+		{
+			c = d[1] & (prio ? HIGH_B : (SHAD_B | HIGH_B));
+
+			if (px == 0x3E)
+			{
+				line[x + i + 8] |= HIGH_W;
+				continue;
+			}
+			if (px > 0x3E)
+			{
+				line[x + i + 8] |= SHAD_W;
+				continue;
+			}
+
+			px = (px + c) & 0xFF;
+		}
+
+		line[x + i + 8] = (unsigned short) (px + SPR_W);
+	}
+
+	return collision & SPR_B;
+}
+
+
+static void Render_Line_Spr(unsigned short *line, int interlace, int hs)
+{
+	int nb, v, n;
+	int x, x_min, x_max, next;
+	int prio, flip;
+	unsigned int info, pal, pat, y_off;
+
+	nb = Update_Mask_Sprite(Sprite_Over & 1);
+
+	for(v = 0; v < nb; v++)
+	{
+		n = Sprite_Visible[v] / (8 * 4);
+		info = Sprite_Struct[n].Num_Tile;
+		y_off = VDP_Current_Line - Sprite_Struct[n].Pos_Y;
+		pal = (info >> 9) & 0x30;
+		prio = (info & 0x8000) ? 1 : 0;
+		flip = (info & 0x0800) ? 1 : 0;
+
+		// pat = offset of the first pattern line, next = offset of the next cell in X
+
+		if (interlace)
+		{
+			next = (Sprite_Struct[n].Size_Y + 1) * 64;
+			if (info & 0x1000) pat = ((info & 0x7FF) << 6) + (Sprite_Struct[n].Size_Y << 6) - (y_off & 0xF8) * 8 + (7 - (y_off & 7)) * 8;
+			else pat = ((info & 0x7FF) << 6) + (y_off & 0xF8) * 8 + (y_off & 7) * 8;
+		}
+		else
+		{
+			next = (Sprite_Struct[n].Size_Y + 1) * 32;
+			if (info & 0x1000) pat = ((info & 0x7FF) << 5) + (Sprite_Struct[n].Size_Y << 5) - (y_off & 0xF8) * 4 + (7 - (y_off & 7)) * 4;
+			else pat = ((info & 0x7FF) << 5) + (y_off & 0xF8) * 4 + (y_off & 7) * 4;
+		}
+
+		if (flip)
+		{
+			x_min = Sprite_Struct[n].Pos_X;
+			if (x_min <= -7) x_min = -7;
+
+			// the last pattern is rendered first
+			for(x = Sprite_Struct[n].Pos_X_Max - 7; x >= H_Pix; x -= 8) pat += next;
+
+			do
+			{
+				VDP_Status |= Put_Line_Sprite(line, x, VRAM_L(pat), pal, 1, prio, hs);
+				x -= 8;
+				pat += next;
+			} while(x >= x_min);
+		}
+		else
+		{
+			x_max = Sprite_Struct[n].Pos_X_Max;
+			if (x_max >= H_Pix) x_max = H_Pix;
+
+			for(x = Sprite_Struct[n].Pos_X; x < -7; x += 8) pat += next;
+
+			do
+			{
+				VDP_Status |= Put_Line_Sprite(line, x, VRAM_L(pat), pal, 0, prio, hs);
+				x += 8;
+				pat += next;
+			} while(x < x_max);
+		}
+	}
+
+	Data_Misc.Borne = nb * 4;
+}
+
+
+/* UPDATE_PALETTE */
+
+static void Update_Palette(int hs)
+{
+	unsigned short c, mask;
+	int i;
+
+	*(unsigned char *) &CRam_Flag = 0;
+	mask = (Mode_555 & 1) ? 0x3DEF : 0x7BEF;
+
+	for(i = 63; i >= 0; i--)
+	{
+		c = Palette[((unsigned short *) CRam)[i] & 0x0FFF];
+		MD_Palette[i] = c;
+
+		if (hs)
+		{
+			MD_Palette[i + 192] = c;
+			c = (c >> 1) & mask;
+			MD_Palette[i + 64] = c;					// shadow
+			MD_Palette[i + 128] = c + mask;			// highlight
+		}
+	}
+
+	c = MD_Palette[VDP_Reg.BG_Color & 0x3F];
+	MD_Palette[0] = c;
+
+	if (hs)
+	{
+		MD_Palette[192] = c;
+		c = (c >> 1) & mask;
+		MD_Palette[64] = c;
+		MD_Palette[128] = c + mask;
+	}
+}
+
+
+void Render_Line(void)
+{
+	unsigned short *line = MD_Screen + TAB336[VDP_Current_Line];
+	int interlace, hs, i;
+
+	if (!(VDP_Reg.Set2 & 0x40))
+	{
+		// VDP off
+		unsigned short c = (VDP_Reg.Set4 & 0x08) ? SHAD_W : 0;
+
+		for(i = 0; i < 320; i++) line[i + 8] = c;
+	}
+	else
+	{
+		interlace = (VDP_Reg.Set4 & 4) ? 1 : 0;
+		hs = (VDP_Reg.Set4 & 8) ? 1 : 0;
+
+		switch(VRam_Flag & 3)
+		{
+			case 1:
+			case 3:
+				Make_Sprite_Struct(interlace);
+				break;
+
+			case 2:
+				Make_Sprite_Struct_Partial();
+				break;
+		}
+		*(unsigned char *) &VRam_Flag = 0;
+
+		Render_Line_Scroll_B(line, interlace, VDP_Reg.Set3 & 4, hs);
+		Render_Line_Scroll_A_Win(line, interlace, VDP_Reg.Set3 & 4, hs);
+		Render_Line_Spr(line, interlace, hs);
+	}
+
+	if (CRam_Flag & 1) Update_Palette(VDP_Reg.Set4 & 8);
+
+	for(i = 8; i < H_Pix + 8; i++) line[i] = MD_Palette[line[i] & 0xFF];
+}
+
+#endif
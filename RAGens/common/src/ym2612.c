@@ -1828,6 +1828,282 @@ void Update_Chan_Algo7_LFO_Int(channel_ *CH, int **buf, int lenght)
 
 
 
+/***********************************************
+ *        rendu par blocs (block renderer)     *
+ ***********************************************/
+
+// Same output as the Update_Chan_* functions above, sample for sample.
+// The enveloppe of a slot only changes when Ecnt >> ENV_LBITS does, or on
+// an enveloppe event, which is every few hundred samples outside of the
+// attack. So the channel is rendered in runs of samples over which all four
+// enveloppes are constant: ENV_TAB, the TL and SSG-EG adjustments and the
+// event checks are done once per run instead of once per sample, and the
+// per-sample loop keeps its counters in local variables instead of going
+// back to the channel (the output buffers could alias it).
+
+#ifdef _MSC_VER
+#define BLOCK_INLINE static __forceinline
+#else
+#define BLOCK_INLINE static __inline __attribute__((always_inline))
+#endif
+
+int YM2612_Block = 1;
+
+// Number of samples, counting this one, the slot enveloppe stays the same:
+// up to the next ENV_TAB step or the next enveloppe event, whichever comes
+// first (an event happens after the last of them).
+
+static INLINE int Env_Run(slot_ *SL)
+{
+	int d = SL->Ecmp - SL->Ecnt;
+	int s = (((SL->Ecnt >> ENV_LBITS) + 1) << ENV_LBITS) - SL->Ecnt;
+
+	if (SL->Einc <= 0) return (d <= SL->Einc) ? 1 : 0x7FFFFFFF;
+	if (s < d) d = s;
+	if (d <= SL->Einc) return 1;
+	return ((d - 1) / SL->Einc) + 1;
+}
+
+
+// en##n is the enveloppe for the run; with the LFO, env_LFO >> AMS is added
+// to it on every sample, unless SSG-EG cut the slot off (mask##n = 0).
+
+#define BLOCK_ENV(n, s)															\
+if (SL[s].SEG & 4)																\
+{																				\
+	if ((en##n = ENV_TAB[SL[s].Ecnt >> ENV_LBITS] + SL[s].TLL) > ENV_MASK)		\
+	{																			\
+		en##n = 0;																\
+		mask##n = 0;															\
+	}																			\
+	else																		\
+	{																			\
+		en##n ^= ENV_MASK;														\
+		mask##n = -1;															\
+	}																			\
+}																				\
+else																			\
+{																				\
+	en##n = ENV_TAB[SL[s].Ecnt >> ENV_LBITS] + SL[s].TLL;						\
+	mask##n = -1;																\
+}
+
+
+#define BLOCK_SIN(n)	SIN_TAB[(in##n >> SIN_LBITS) & SIN_MASK][env##n]
+
+
+BLOCK_INLINE void Update_Chan_Block(channel_ *CH, int **buf, int lenght, const int algo, const int lfo, const int inter)
+{
+	slot_ *SL = CH->SLOT;
+	int *bufL = buf[0], *bufR = buf[1];
+	int in0, in1, in2, in3;
+	int en0, en1, en2, en3, env0, env1, env2, env3;
+	int mask0, mask1, mask2, mask3;
+	int fcnt0 = SL[S0].Fcnt, fcnt1 = SL[S1].Fcnt, fcnt2 = SL[S2].Fcnt, fcnt3 = SL[S3].Fcnt;
+	int finc0 = SL[S0].Finc, finc1 = SL[S1].Finc, finc2 = SL[S2].Finc, finc3 = SL[S3].Finc;
+	int ams0 = SL[S0].AMS, ams1 = SL[S1].AMS, ams2 = SL[S2].AMS, ams3 = SL[S3].AMS;
+	int out0 = CH->S0_OUT[0], out1 = CH->S0_OUT[1];
+	int outd = CH->OUTd, old_outd = CH->Old_OUTd;
+	int fb = CH->FB, fms = CH->FMS, left = CH->LEFT, right = CH->RIGHT;
+	int cnt = 0, step = YM2612.Inter_Step;
+	int env_LFO, freq_LFO, run, done, r, i;
+
+	switch(algo)
+	{
+		case 0: case 1: case 2: case 3:
+			if (SL[S3].Ecnt == ENV_END) return;
+			break;
+		case 4:
+			if ((SL[S1].Ecnt == ENV_END) && (SL[S3].Ecnt == ENV_END)) return;
+			break;
+		case 5: case 6:
+			if ((SL[S1].Ecnt == ENV_END) && (SL[S2].Ecnt == ENV_END) && (SL[S3].Ecnt == ENV_END)) return;
+			break;
+		default:
+			if ((SL[S0].Ecnt == ENV_END) && (SL[S1].Ecnt == ENV_END) && (SL[S2].Ecnt == ENV_END) && (SL[S3].Ecnt == ENV_END)) return;
+			break;
+	}
+
+	if (inter) cnt = YM2612.Inter_Cnt;
+
+	for(i = 0; i < lenght; )
+	{
+		run = Env_Run(&SL[S0]);
+		if ((r = Env_Run(&SL[S1])) < run) run = r;
+		if ((r = Env_Run(&SL[S2])) < run) run = r;
+		if ((r = Env_Run(&SL[S3])) < run) run = r;
+		if ((!inter) && (run > lenght - i)) run = lenght - i;
+
+		BLOCK_ENV(0, S0)
+		BLOCK_ENV(1, S1)
+		BLOCK_ENV(2, S2)
+		BLOCK_ENV(3, S3)
+
+		env0 = en0; env1 = en1; env2 = en2; env3 = en3;
+
+		for(done = 0; (done < run) && (i < lenght); done++)
+		{
+			in0 = fcnt0; in1 = fcnt1; in2 = fcnt2; in3 = fcnt3;
+
+			if (lfo)
+			{
+				if (freq_LFO = (fms * LFO_FREQ_UP[i]) >> (LFO_HBITS - 1))
+				{
+					fcnt0 += finc0 + ((finc0 * freq_LFO) >> LFO_FMS_LBITS);
+					fcnt1 += finc1 + ((finc1 * freq_LFO) >> LFO_FMS_LBITS);
+					fcnt2 += finc2 + ((finc2 * freq_LFO) >> LFO_FMS_LBITS);
+					fcnt3 += finc3 + ((finc3 * freq_LFO) >> LFO_FMS_LBITS);
+				}
+				else
+				{
+					fcnt0 += finc0; fcnt1 += finc1; fcnt2 += finc2; fcnt3 += finc3;
+				}
+
+				env_LFO = LFO_ENV_UP[i];
+				env0 = en0 + ((env_LFO >> ams0) & mask0);
+				env1 = en1 + ((env_LFO >> ams1) & mask1);
+				env2 = en2 + ((env_LFO >> ams2) & mask2);
+				env3 = en3 + ((env_LFO >> ams3) & mask3);
+			}
+			else
+			{
+				fcnt0 += finc0; fcnt1 += finc1; fcnt2 += finc2; fcnt3 += finc3;
+			}
+
+			// DO_FEEDBACK
+			in0 += (out0 + out1) >> fb;
+			out1 = out0;
+			out0 = BLOCK_SIN(0);
+
+			switch(algo)
+			{
+				case 0:
+					in1 += out1;
+					in2 += BLOCK_SIN(1);
+					in3 += BLOCK_SIN(2);
+					outd = BLOCK_SIN(3) >> OUT_SHIFT;
+					break;
+
+				case 1:
+					in2 += out1 + BLOCK_SIN(1);
+					in3 += BLOCK_SIN(2);
+					outd = BLOCK_SIN(3) >> OUT_SHIFT;
+					break;
+
+				case 2:
+					in2 += BLOCK_SIN(1);
+					in3 += out1 + BLOCK_SIN(2);
+					outd = BLOCK_SIN(3) >> OUT_SHIFT;
+					break;
+
+				case 3:
+					in1 += out1;
+					in3 += BLOCK_SIN(1) + BLOCK_SIN(2);
+					outd = BLOCK_SIN(3) >> OUT_SHIFT;
+					break;
+
+				case 4:
+					in1 += out1;
+					in3 += BLOCK_SIN(2);
+					outd = ((int) BLOCK_SIN(3) + (int) BLOCK_SIN(1)) >> OUT_SHIFT;
+					break;
+
+				case 5:
+					in1 += out1;
+					in2 += out1;
+					in3 += out1;
+					outd = ((int) BLOCK_SIN(3) + (int) BLOCK_SIN(1) + (int) BLOCK_SIN(2)) >> OUT_SHIFT;
+					break;
+
+				case 6:
+					in1 += out1;
+					outd = ((int) BLOCK_SIN(3) + (int) BLOCK_SIN(1) + (int) BLOCK_SIN(2)) >> OUT_SHIFT;
+					break;
+
+				default:
+					outd = ((int) BLOCK_SIN(3) + (int) BLOCK_SIN(1) + (int) BLOCK_SIN(2) + out1) >> OUT_SHIFT;
+					break;
+			}
+
+			// DO_LIMIT
+			if (algo >= 4)
+			{
+				if (outd > LIMIT_CH_OUT) outd = LIMIT_CH_OUT;
+				else if (outd < -LIMIT_CH_OUT) outd = -LIMIT_CH_OUT;
+			}
+
+			if (!inter)
+			{
+				bufL[i] += outd & left;
+				bufR[i] += outd & right;
+				i++;
+			}
+			else
+			{
+				// DO_OUTPUT_INT
+				if ((cnt += step) & 0x04000)
+				{
+					cnt &= 0x3FFF;
+					old_outd = (((cnt ^ 0x3FFF) * outd) + (cnt * old_outd)) >> 14;
+					bufL[i] += old_outd & left;
+					bufR[i] += old_outd & right;
+					i++;
+				}
+				old_outd = outd;
+			}
+		}
+
+		// UPDATE_ENV, for the whole run
+		if ((SL[S0].Ecnt += SL[S0].Einc * done) >= SL[S0].Ecmp) ENV_NEXT_EVENT[SL[S0].Ecurp](&(SL[S0]));
+		if ((SL[S1].Ecnt += SL[S1].Einc * done) >= SL[S1].Ecmp) ENV_NEXT_EVENT[SL[S1].Ecurp](&(SL[S1]));
+		if ((SL[S2].Ecnt += SL[S2].Einc * done) >= SL[S2].Ecmp) ENV_NEXT_EVENT[SL[S2].Ecurp](&(SL[S2]));
+		if ((SL[S3].Ecnt += SL[S3].Einc * done) >= SL[S3].Ecmp) ENV_NEXT_EVENT[SL[S3].Ecurp](&(SL[S3]));
+	}
+
+	SL[S0].Fcnt = fcnt0; SL[S1].Fcnt = fcnt1; SL[S2].Fcnt = fcnt2; SL[S3].Fcnt = fcnt3;
+	CH->S0_OUT[0] = out0;
+	CH->S0_OUT[1] = out1;
+	CH->OUTd = outd;
+
+	if (inter)
+	{
+		CH->Old_OUTd = old_outd;
+		int_cnt = cnt;
+	}
+}
+
+#define UPDATE_CHAN_BLOCK_DEF(algo)																											\
+static void Update_Chan_Block##algo(channel_ *CH, int **buf, int lenght) { Update_Chan_Block(CH, buf, lenght, algo, 0, 0); }				\
+static void Update_Chan_Block##algo##_LFO(channel_ *CH, int **buf, int lenght) { Update_Chan_Block(CH, buf, lenght, algo, 1, 0); }		\
+static void Update_Chan_Block##algo##_Int(channel_ *CH, int **buf, int lenght) { Update_Chan_Block(CH, buf, lenght, algo, 0, 1); }		\
+static void Update_Chan_Block##algo##_LFO_Int(channel_ *CH, int **buf, int lenght) { Update_Chan_Block(CH, buf, lenght, algo, 1, 1); }
+
+UPDATE_CHAN_BLOCK_DEF(0)
+UPDATE_CHAN_BLOCK_DEF(1)
+UPDATE_CHAN_BLOCK_DEF(2)
+UPDATE_CHAN_BLOCK_DEF(3)
+UPDATE_CHAN_BLOCK_DEF(4)
+UPDATE_CHAN_BLOCK_DEF(5)
+UPDATE_CHAN_BLOCK_DEF(6)
+UPDATE_CHAN_BLOCK_DEF(7)
+
+static void (*const UPDATE_CHAN_BLOCK[4 * 8])(channel_ *CH, int **buf, int lenght) =	// Same order as UPDATE_CHAN
+{
+	Update_Chan_Block0, Update_Chan_Block1, Update_Chan_Block2, Update_Chan_Block3,
+	Update_Chan_Block4, Update_Chan_Block5, Update_Chan_Block6, Update_Chan_Block7,
+
+	Update_Chan_Block0_LFO, Update_Chan_Block1_LFO, Update_Chan_Block2_LFO, Update_Chan_Block3_LFO,
+	Update_Chan_Block4_LFO, Update_Chan_Block5_LFO, Update_Chan_Block6_LFO, Update_Chan_Block7_LFO,
+
+	Update_Chan_Block0_Int, Update_Chan_Block1_Int, Update_Chan_Block2_Int, Update_Chan_Block3_Int,
+	Update_Chan_Block4_Int, Update_Chan_Block5_Int, Update_Chan_Block6_Int, Update_Chan_Block7_Int,
+
+	Update_Chan_Block0_LFO_Int, Update_Chan_Block1_LFO_Int, Update_Chan_Block2_LFO_Int, Update_Chan_Block3_LFO_Int,
+	Update_Chan_Block4_LFO_Int, Update_Chan_Block5_LFO_Int, Update_Chan_Block6_LFO_Int, Update_Chan_Block7_LFO_Int
+};
+
+
+
 /***********************************************
  *            fonctions publiques              *
  ***********************************************/
@@ -2357,12 +2633,24 @@ void YM2612_Update(int **buf, int length)
 		algo_type |= 8;
 	}
 
-	UPDATE_CHAN[YM2612.CHANNEL[0].ALGO + algo_type](&(YM2612.CHANNEL[0]), buf, length);
-	UPDATE_CHAN[YM2612.CHANNEL[1].ALGO + algo_type](&(YM2612.CHANNEL[1]), buf, length);
-	UPDATE_CHAN[YM2612.CHANNEL[2].ALGO + algo_type](&(YM2612.CHANNEL[2]), buf, length);
-	UPDATE_CHAN[YM2612.CHANNEL[3].ALGO + algo_type](&(YM2612.CHANNEL[3]), buf, length);
-	UPDATE_CHAN[YM2612.CHANNEL[4].ALGO + algo_type](&(YM2612.CHANNEL[4]), buf, length);
-	if (!(YM2612.DAC)) UPDATE_CHAN[YM2612.CHANNEL[5].ALGO + algo_type](&(YM2612.CHANNEL[5]), buf, length);
+	if (YM2612_Block)
+	{
+		UPDATE_CHAN_BLOCK[YM2612.CHANNEL[0].ALGO + algo_type](&(YM2612.CHANNEL[0]), buf, length);
+		UPDATE_CHAN_BLOCK[YM2612.CHANNEL[1].ALGO + algo_type](&(YM2612.CHANNEL[1]), buf, length);
+		UPDATE_CHAN_BLOCK[YM2612.CHANNEL[2].ALGO + algo_type](&(YM2612.CHANNEL[2]), buf, length);
+		UPDATE_CHAN_BLOCK[YM2612.CHANNEL[3].ALGO + algo_type](&(YM2612.CHANNEL[3]), buf, length);
+		UPDATE_CHAN_BLOCK[YM2612.CHANNEL[4].ALGO + algo_type](&(YM2612.CHANNEL[4]), buf, length);
+		if (!(YM2612.DAC)) UPDATE_CHAN_BLOCK[YM2612.CHANNEL[5].ALGO + algo_type](&(YM2612.CHANNEL[5]), buf, length);
+	}
+	else
+	{
+		UPDATE_CHAN[YM2612.CHANNEL[0].ALGO + algo_type](&(YM2612.CHANNEL[0]), buf, length);
+		UPDATE_CHAN[YM2612.CHANNEL[1].ALGO + algo_type](&(YM2612.CHANNEL[1]), buf, length);
+		UPDATE_CHAN[YM2612.CHANNEL[2].ALGO + algo_type](&(YM2612.CHANNEL[2]), buf, length);
+		UPDATE_CHAN[YM2612.CHANNEL[3].ALGO + algo_type](&(YM2612.CHANNEL[3]), buf, length);
+		UPDATE_CHAN[YM2612.CHANNEL[4].ALGO + algo_type](&(YM2612.CHANNEL[4]), buf, length);
+		if (!(YM2612.DAC)) UPDATE_CHAN[YM2612.CHANNEL[5].ALGO + algo_type](&(YM2612.CHANNEL[5]), buf, length);
+	}
 
 	YM2612.Inter_Cnt = int_cnt;
 
@@ -102,6 +102,7 @@ typedef struct ym2612__ {
 
 extern int YM2612_Enable;
 extern int YM2612_Improv;
+extern int YM2612_Block;
 extern int DAC_Enable;
 extern int *YM_Buf[2];
 extern int YM_Len;
@@ -0,0 +1,183 @@
+/***********************************************************
+ *                                                         *
+ * YM2612BENCH.C : YM2612 benchmark                        *
+ *                                                         *
+ * Replays the YM2612 writes of a GYM dump, and reports   *
+ * samples/second and a hash of the sound, which has to be *
+ * the same on every loop, with both renderers, and        *
+ * before/after a change.                                  *
+ *                                                         *
+ * ym2612bench file.gym [rate] [loops] [-improv]           *
+ *                                                         *
+ ***********************************************************/
+
+// Every loop is played once with the per-channel renderers and once with the
+// block renderer (YM2612_Block), which have to give the same hash.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ym2612.h"
+
+#define CLOCK_NTSC 53693175
+
+// Gens globals used by ym2612.c
+
+unsigned int Sound_Extrapol[312][2];
+int Seg_L[882], Seg_R[882];
+int VDP_Current_Line;
+int GYM_Dumping = 0;
+
+// YM2612_Init doesn't reset it and it leaks into Inter_Cnt when no channel
+// is playing, so every run has to start from the same value
+extern int int_cnt;
+
+int Update_GYM_Dump(char v0, char v1, char v2)
+{
+	return 0;
+}
+
+
+// Same thing as GYM_Next() in G_dsound.cpp, without the PSG.
+// Returns the number of frames played. gym needs 2 bytes of padding.
+
+static int Replay_GYM(const unsigned char *gym, int size, int seg, unsigned int *hash, double *seconds)
+{
+	int *buf[2];
+	int i, j, frames = 0;
+	unsigned int h = 2166136261U;
+	clock_t start;
+
+	*seconds = 0;
+
+	for(i = 0; i < size; )
+	{
+		switch(gym[i++])
+		{
+			case 0:
+				memset(Seg_L, 0, sizeof(Seg_L));
+				memset(Seg_R, 0, sizeof(Seg_R));
+				buf[0] = Seg_L;
+				buf[1] = Seg_R;
+
+				start = clock();
+				YM2612_Update(buf, seg);
+				*seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+				for(j = 0; j < seg; j++)
+				{
+					h = (h ^ (unsigned int) Seg_L[j]) * 16777619U;
+					h = (h ^ (unsigned int) Seg_R[j]) * 16777619U;
+				}
+				frames++;
+				break;
+
+			case 1:
+				YM2612_Write(0, gym[i]);
+				YM2612_Write(1, gym[i + 1]);
+				i += 2;
+				break;
+
+			case 2:
+				YM2612_Write(2, gym[i]);
+				YM2612_Write(3, gym[i + 1]);
+				i += 2;
+				break;
+
+			case 3:
+				i++;
+				break;
+		}
+	}
+
+	*hash = h;
+	return frames;
+}
+
+
+int main(int argc, char *argv[])
+{
+	FILE *f;
+	unsigned char *gym;
+	int size, rate = 44100, loops = 10, improv = 0;
+	int i, l, r, frames = 0, mismatch = 0;
+	unsigned int hash = 0, ref_hash = 0;
+	double seconds, total[2] = {0, 0}, samples;
+
+	for(i = 2; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-improv")) improv = 1;
+		else if (i == 2) rate = atoi(argv[i]);
+		else loops = atoi(argv[i]);
+	}
+
+	if ((argc < 2) || (rate < 11025) || (rate > 48000) || (loops < 1))
+	{
+		printf("usage : ym2612bench file.gym [rate] [loops] [-improv]\n");
+		return 1;
+	}
+
+	if ((f = fopen(argv[1], "rb")) == NULL)
+	{
+		printf("can't open %s\n", argv[1]);
+		return 1;
+	}
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	gym = (unsigned char *) calloc(size + 2, 1);
+	if ((gym == NULL) || (fread(gym, 1, size, f) != (size_t) size))
+	{
+		printf("can't read %s\n", argv[1]);
+		fclose(f);
+		return 1;
+	}
+	fclose(f);
+
+	// GYMX files have a 428 bytes tag in front, the packed ones aren't supported
+	if ((size >= 428) && !memcmp(gym, "GYMX", 4))
+	{
+		if (gym[424] | gym[425] | gym[426] | gym[427])
+		{
+			printf("packed GYMX files aren't supported\n");
+			return 1;
+		}
+		memmove(gym, gym + 428, size - 428);
+		size -= 428;
+		gym[size] = gym[size + 1] = 0;
+	}
+
+	printf("%s, %d Hz%s, %d loops\n", argv[1], rate, improv ? " interpolated" : "", loops);
+
+	for(l = 0; l < loops; l++)
+	{
+		for(r = 0; r < 2; r++)
+		{
+			YM2612_Block = r;
+			int_cnt = 0;
+			YM2612_Init(CLOCK_NTSC / 7, rate, improv);
+			frames = Replay_GYM(gym, size, rate / 60, &hash, &seconds);
+			total[r] += seconds;
+
+			if ((l == 0) && (r == 0)) ref_hash = hash;
+			else if (hash != ref_hash) mismatch = 1;
+		}
+	}
+
+	samples = (double) frames * (rate / 60) * loops;
+	for(r = 0; r < 2; r++)
+	{
+		if (total[r] <= 0) total[r] = 1.0 / CLOCKS_PER_SEC;
+	}
+
+	printf("channel %10.0f samples/s\n", samples / total[0]);
+	printf("block   %10.0f samples/s  (%.2fx)\n", samples / total[1], total[0] / total[1]);
+	printf("hash %.8X%s\n", ref_hash, mismatch ? "  MISMATCH" : "");
+	printf("%d frames (%.1f s of sound)\n", frames, frames / 60.0);
+
+	free(gym);
+	YM2612_End();
+
+	return mismatch;
+}
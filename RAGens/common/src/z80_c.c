@@ -0,0 +1,2005 @@
+/**********************************************************/
+/*                                                        */
+/* Z80 emulator 0.99                                      */
+/* Copyright 2002 Stphane Dallongeville                  */
+/* Used for the genesis emulation in Gens                 */
+/*                                                        */
+/* Portable C version of z80.asm, built instead of it     */
+/* when GENS_C_CORES is defined. It follows the asm core  */
+/* instruction for instruction, quirks included, so both  */
+/* backends give the same results on the same input.      */
+/*                                                        */
+/**********************************************************/
+
+#ifdef GENS_C_CORES
+
+#include <stddef.h>
+#include <string.h>
+#include "z80.h"
+
+#ifndef INLINE
+#define INLINE __inline
+#endif
+
+
+#define FLAG_C    0x01
+#define FLAG_N    0x02
+#define FLAG_P    0x04
+#define FLAG_X    0x08
+#define FLAG_H    0x10
+#define FLAG_Y    0x20
+#define FLAG_Z    0x40
+#define FLAG_S    0x80
+
+#define Z80_RUNNING     0x01
+#define Z80_HALTED      0x02
+#define Z80_FAULTED     0x10
+
+
+extern unsigned char Ram_Z80[];		// Gens stuff
+
+Z80_CONTEXT M_Z80;
+
+static UINT8 Def_z80_Mem[0x10000 + 1];
+
+// Base of the current fetch region. The asm core keeps it in BasePC and
+// PC.d holds the based PC, that doesn't fit in 32 bits on a 64-bit build
+// so here PC.d always holds the unbased PC.
+static UINT8 *Base_PC = Def_z80_Mem;
+
+static UINT8 SZP_Table[256];
+
+
+// Flag tables ('borrowed' from MAZE, by Ishmair)
+
+static const UINT8 INC_Table[256] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x30,
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x30,
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x10,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x30,
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x30,
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x94,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x90,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0xB0,
+	0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xB0,
+	0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0x90,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x90,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0xB0,
+	0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xB0,
+	0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0xA8, 0x50
+};
+
+static const UINT8 DEC_Table[256] =
+{
+	0xBA, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+	0x1A, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+	0x1A, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A,
+	0x3A, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A,
+	0x3A, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+	0x1A, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+	0x1A, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A,
+	0x3A, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A,
+	0x3E, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A,
+	0x9A, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A,
+	0x9A, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+	0xBA, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+	0xBA, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A,
+	0x9A, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x82, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A, 0x8A,
+	0x9A, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+	0xBA, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xA2, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA
+};
+
+// DAA table ('borrowed' from Z80Emul, by unknown)
+// Index is A | C << 8 | N << 9 | H << 10. z80.asm adds H one bit too high
+// and reads past the end of its copy when H is set, that can't be matched.
+
+static const UINT16 DAA_Table[2048] =
+{
+	0x4400, 0x0001, 0x0002, 0x0403, 0x0004, 0x0405, 0x0406, 0x0007,
+	0x0808, 0x0C09, 0x1010, 0x1411, 0x1412, 0x1013, 0x1414, 0x1015,
+	0x0010, 0x0411, 0x0412, 0x0013, 0x0414, 0x0015, 0x0016, 0x0417,
+	0x0C18, 0x0819, 0x3020, 0x3421, 0x3422, 0x3023, 0x3424, 0x3025,
+	0x2020, 0x2421, 0x2422, 0x2023, 0x2424, 0x2025, 0x2026, 0x2427,
+	0x2C28, 0x2829, 0x3430, 0x3031, 0x3032, 0x3433, 0x3034, 0x3435,
+	0x2430, 0x2031, 0x2032, 0x2433, 0x2034, 0x2435, 0x2436, 0x2037,
+	0x2838, 0x2C39, 0x1040, 0x1441, 0x1442, 0x1043, 0x1444, 0x1045,
+	0x0040, 0x0441, 0x0442, 0x0043, 0x0444, 0x0045, 0x0046, 0x0447,
+	0x0C48, 0x0849, 0x1450, 0x1051, 0x1052, 0x1453, 0x1054, 0x1455,
+	0x0450, 0x0051, 0x0052, 0x0453, 0x0054, 0x0455, 0x0456, 0x0057,
+	0x0858, 0x0C59, 0x3460, 0x3061, 0x3062, 0x3463, 0x3064, 0x3465,
+	0x2460, 0x2061, 0x2062, 0x2463, 0x2064, 0x2465, 0x2466, 0x2067,
+	0x2868, 0x2C69, 0x3070, 0x3471, 0x3472, 0x3073, 0x3474, 0x3075,
+	0x2070, 0x2471, 0x2472, 0x2073, 0x2474, 0x2075, 0x2076, 0x2477,
+	0x2C78, 0x2879, 0x9080, 0x9481, 0x9482, 0x9083, 0x9484, 0x9085,
+	0x8080, 0x8481, 0x8482, 0x8083, 0x8484, 0x8085, 0x8086, 0x8487,
+	0x8C88, 0x8889, 0x9490, 0x9091, 0x9092, 0x9493, 0x9094, 0x9495,
+	0x8490, 0x8091, 0x8092, 0x8493, 0x8094, 0x8495, 0x8496, 0x8097,
+	0x8898, 0x8C99, 0x5500, 0x1101, 0x1102, 0x1503, 0x1104, 0x1505,
+	0x4500, 0x0101, 0x0102, 0x0503, 0x0104, 0x0505, 0x0506, 0x0107,
+	0x0908, 0x0D09, 0x1110, 0x1511, 0x1512, 0x1113, 0x1514, 0x1115,
+	0x0110, 0x0511, 0x0512, 0x0113, 0x0514, 0x0115, 0x0116, 0x0517,
+	0x0D18, 0x0919, 0x3120, 0x3521, 0x3522, 0x3123, 0x3524, 0x3125,
+	0x2120, 0x2521, 0x2522, 0x2123, 0x2524, 0x2125, 0x2126, 0x2527,
+	0x2D28, 0x2929, 0x3530, 0x3131, 0x3132, 0x3533, 0x3134, 0x3535,
+	0x2530, 0x2131, 0x2132, 0x2533, 0x2134, 0x2535, 0x2536, 0x2137,
+	0x2938, 0x2D39, 0x1140, 0x1541, 0x1542, 0x1143, 0x1544, 0x1145,
+	0x0140, 0x0541, 0x0542, 0x0143, 0x0544, 0x0145, 0x0146, 0x0547,
+	0x0D48, 0x0949, 0x1550, 0x1151, 0x1152, 0x1553, 0x1154, 0x1555,
+	0x0550, 0x0151, 0x0152, 0x0553, 0x0154, 0x0555, 0x0556, 0x0157,
+	0x0958, 0x0D59, 0x3560, 0x3161, 0x3162, 0x3563, 0x3164, 0x3565,
+	0x2560, 0x2161, 0x2162, 0x2563, 0x2164, 0x2565, 0x2566, 0x2167,
+	0x2968, 0x2D69, 0x3170, 0x3571, 0x3572, 0x3173, 0x3574, 0x3175,
+	0x2170, 0x2571, 0x2572, 0x2173, 0x2574, 0x2175, 0x2176, 0x2577,
+	0x2D78, 0x2979, 0x9180, 0x9581, 0x9582, 0x9183, 0x9584, 0x9185,
+	0x8180, 0x8581, 0x8582, 0x8183, 0x8584, 0x8185, 0x8186, 0x8587,
+	0x8D88, 0x8989, 0x9590, 0x9191, 0x9192, 0x9593, 0x9194, 0x9595,
+	0x8590, 0x8191, 0x8192, 0x8593, 0x8194, 0x8595, 0x8596, 0x8197,
+	0x8998, 0x8D99, 0xB5A0, 0xB1A1, 0xB1A2, 0xB5A3, 0xB1A4, 0xB5A5,
+	0xA5A0, 0xA1A1, 0xA1A2, 0xA5A3, 0xA1A4, 0xA5A5, 0xA5A6, 0xA1A7,
+	0xA9A8, 0xADA9, 0xB1B0, 0xB5B1, 0xB5B2, 0xB1B3, 0xB5B4, 0xB1B5,
+	0xA1B0, 0xA5B1, 0xA5B2, 0xA1B3, 0xA5B4, 0xA1B5, 0xA1B6, 0xA5B7,
+	0xADB8, 0xA9B9, 0x95C0, 0x91C1, 0x91C2, 0x95C3, 0x91C4, 0x95C5,
+	0x85C0, 0x81C1, 0x81C2, 0x85C3, 0x81C4, 0x85C5, 0x85C6, 0x81C7,
+	0x89C8, 0x8DC9, 0x91D0, 0x95D1, 0x95D2, 0x91D3, 0x95D4, 0x91D5,
+	0x81D0, 0x85D1, 0x85D2, 0x81D3, 0x85D4, 0x81D5, 0x81D6, 0x85D7,
+	0x8DD8, 0x89D9, 0xB1E0, 0xB5E1, 0xB5E2, 0xB1E3, 0xB5E4, 0xB1E5,
+	0xA1E0, 0xA5E1, 0xA5E2, 0xA1E3, 0xA5E4, 0xA1E5, 0xA1E6, 0xA5E7,
+	0xADE8, 0xA9E9, 0xB5F0, 0xB1F1, 0xB1F2, 0xB5F3, 0xB1F4, 0xB5F5,
+	0xA5F0, 0xA1F1, 0xA1F2, 0xA5F3, 0xA1F4, 0xA5F5, 0xA5F6, 0xA1F7,
+	0xA9F8, 0xADF9, 0x5500, 0x1101, 0x1102, 0x1503, 0x1104, 0x1505,
+	0x4500, 0x0101, 0x0102, 0x0503, 0x0104, 0x0505, 0x0506, 0x0107,
+	0x0908, 0x0D09, 0x1110, 0x1511, 0x1512, 0x1113, 0x1514, 0x1115,
+	0x0110, 0x0511, 0x0512, 0x0113, 0x0514, 0x0115, 0x0116, 0x0517,
+	0x0D18, 0x0919, 0x3120, 0x3521, 0x3522, 0x3123, 0x3524, 0x3125,
+	0x2120, 0x2521, 0x2522, 0x2123, 0x2524, 0x2125, 0x2126, 0x2527,
+	0x2D28, 0x2929, 0x3530, 0x3131, 0x3132, 0x3533, 0x3134, 0x3535,
+	0x2530, 0x2131, 0x2132, 0x2533, 0x2134, 0x2535, 0x2536, 0x2137,
+	0x2938, 0x2D39, 0x1140, 0x1541, 0x1542, 0x1143, 0x1544, 0x1145,
+	0x0140, 0x0541, 0x0542, 0x0143, 0x0544, 0x0145, 0x0146, 0x0547,
+	0x0D48, 0x0949, 0x1550, 0x1151, 0x1152, 0x1553, 0x1154, 0x1555,
+	0x0550, 0x0151, 0x0152, 0x0553, 0x0154, 0x0555, 0x0556, 0x0157,
+	0x0958, 0x0D59, 0x3560, 0x3161, 0x3162, 0x3563, 0x3164, 0x3565,
+	0x4600, 0x0201, 0x0202, 0x0603, 0x0204, 0x0605, 0x0606, 0x0207,
+	0x0A08, 0x0E09, 0x0204, 0x0605, 0x0606, 0x0207, 0x0A08, 0x0E09,
+	0x0210, 0x0611, 0x0612, 0x0213, 0x0614, 0x0215, 0x0216, 0x0617,
+	0x0E18, 0x0A19, 0x0614, 0x0215, 0x0216, 0x0617, 0x0E18, 0x0A19,
+	0x2220, 0x2621, 0x2622, 0x2223, 0x2624, 0x2225, 0x2226, 0x2627,
+	0x2E28, 0x2A29, 0x2624, 0x2225, 0x2226, 0x2627, 0x2E28, 0x2A29,
+	0x2630, 0x2231, 0x2232, 0x2633, 0x2234, 0x2635, 0x2636, 0x2237,
+	0x2A38, 0x2E39, 0x2234, 0x2635, 0x2636, 0x2237, 0x2A38, 0x2E39,
+	0x0240, 0x0641, 0x0642, 0x0243, 0x0644, 0x0245, 0x0246, 0x0647,
+	0x0E48, 0x0A49, 0x0644, 0x0245, 0x0246, 0x0647, 0x0E48, 0x0A49,
+	0x0650, 0x0251, 0x0252, 0x0653, 0x0254, 0x0655, 0x0656, 0x0257,
+	0x0A58, 0x0E59, 0x0254, 0x0655, 0x0656, 0x0257, 0x0A58, 0x0E59,
+	0x2660, 0x2261, 0x2262, 0x2663, 0x2264, 0x2665, 0x2666, 0x2267,
+	0x2A68, 0x2E69, 0x2264, 0x2665, 0x2666, 0x2267, 0x2A68, 0x2E69,
+	0x2270, 0x2671, 0x2672, 0x2273, 0x2674, 0x2275, 0x2276, 0x2677,
+	0x2E78, 0x2A79, 0x2674, 0x2275, 0x2276, 0x2677, 0x2E78, 0x2A79,
+	0x8280, 0x8681, 0x8682, 0x8283, 0x8684, 0x8285, 0x8286, 0x8687,
+	0x8E88, 0x8A89, 0x8684, 0x8285, 0x8286, 0x8687, 0x8E88, 0x8A89,
+	0x8690, 0x8291, 0x8292, 0x8693, 0x8294, 0x8695, 0x8696, 0x8297,
+	0x8A98, 0x8E99, 0x2334, 0x2735, 0x2736, 0x2337, 0x2B38, 0x2F39,
+	0x0340, 0x0741, 0x0742, 0x0343, 0x0744, 0x0345, 0x0346, 0x0747,
+	0x0F48, 0x0B49, 0x0744, 0x0345, 0x0346, 0x0747, 0x0F48, 0x0B49,
+	0x0750, 0x0351, 0x0352, 0x0753, 0x0354, 0x0755, 0x0756, 0x0357,
+	0x0B58, 0x0F59, 0x0354, 0x0755, 0x0756, 0x0357, 0x0B58, 0x0F59,
+	0x2760, 0x2361, 0x2362, 0x2763, 0x2364, 0x2765, 0x2766, 0x2367,
+	0x2B68, 0x2F69, 0x2364, 0x2765, 0x2766, 0x2367, 0x2B68, 0x2F69,
+	0x2370, 0x2771, 0x2772, 0x2373, 0x2774, 0x2375, 0x2376, 0x2777,
+	0x2F78, 0x2B79, 0x2774, 0x2375, 0x2376, 0x2777, 0x2F78, 0x2B79,
+	0x8380, 0x8781, 0x8782, 0x8383, 0x8784, 0x8385, 0x8386, 0x8787,
+	0x8F88, 0x8B89, 0x8784, 0x8385, 0x8386, 0x8787, 0x8F88, 0x8B89,
+	0x8790, 0x8391, 0x8392, 0x8793, 0x8394, 0x8795, 0x8796, 0x8397,
+	0x8B98, 0x8F99, 0x8394, 0x8795, 0x8796, 0x8397, 0x8B98, 0x8F99,
+	0xA7A0, 0xA3A1, 0xA3A2, 0xA7A3, 0xA3A4, 0xA7A5, 0xA7A6, 0xA3A7,
+	0xABA8, 0xAFA9, 0xA3A4, 0xA7A5, 0xA7A6, 0xA3A7, 0xABA8, 0xAFA9,
+	0xA3B0, 0xA7B1, 0xA7B2, 0xA3B3, 0xA7B4, 0xA3B5, 0xA3B6, 0xA7B7,
+	0xAFB8, 0xABB9, 0xA7B4, 0xA3B5, 0xA3B6, 0xA7B7, 0xAFB8, 0xABB9,
+	0x87C0, 0x83C1, 0x83C2, 0x87C3, 0x83C4, 0x87C5, 0x87C6, 0x83C7,
+	0x8BC8, 0x8FC9, 0x83C4, 0x87C5, 0x87C6, 0x83C7, 0x8BC8, 0x8FC9,
+	0x83D0, 0x87D1, 0x87D2, 0x83D3, 0x87D4, 0x83D5, 0x83D6, 0x87D7,
+	0x8FD8, 0x8BD9, 0x87D4, 0x83D5, 0x83D6, 0x87D7, 0x8FD8, 0x8BD9,
+	0xA3E0, 0xA7E1, 0xA7E2, 0xA3E3, 0xA7E4, 0xA3E5, 0xA3E6, 0xA7E7,
+	0xAFE8, 0xABE9, 0xA7E4, 0xA3E5, 0xA3E6, 0xA7E7, 0xAFE8, 0xABE9,
+	0xA7F0, 0xA3F1, 0xA3F2, 0xA7F3, 0xA3F4, 0xA7F5, 0xA7F6, 0xA3F7,
+	0xABF8, 0xAFF9, 0xA3F4, 0xA7F5, 0xA7F6, 0xA3F7, 0xABF8, 0xAFF9,
+	0x4700, 0x0301, 0x0302, 0x0703, 0x0304, 0x0705, 0x0706, 0x0307,
+	0x0B08, 0x0F09, 0x0304, 0x0705, 0x0706, 0x0307, 0x0B08, 0x0F09,
+	0x0310, 0x0711, 0x0712, 0x0313, 0x0714, 0x0315, 0x0316, 0x0717,
+	0x0F18, 0x0B19, 0x0714, 0x0315, 0x0316, 0x0717, 0x0F18, 0x0B19,
+	0x2320, 0x2721, 0x2722, 0x2323, 0x2724, 0x2325, 0x2326, 0x2727,
+	0x2F28, 0x2B29, 0x2724, 0x2325, 0x2326, 0x2727, 0x2F28, 0x2B29,
+	0x2730, 0x2331, 0x2332, 0x2733, 0x2334, 0x2735, 0x2736, 0x2337,
+	0x2B38, 0x2F39, 0x2334, 0x2735, 0x2736, 0x2337, 0x2B38, 0x2F39,
+	0x0340, 0x0741, 0x0742, 0x0343, 0x0744, 0x0345, 0x0346, 0x0747,
+	0x0F48, 0x0B49, 0x0744, 0x0345, 0x0346, 0x0747, 0x0F48, 0x0B49,
+	0x0750, 0x0351, 0x0352, 0x0753, 0x0354, 0x0755, 0x0756, 0x0357,
+	0x0B58, 0x0F59, 0x0354, 0x0755, 0x0756, 0x0357, 0x0B58, 0x0F59,
+	0x2760, 0x2361, 0x2362, 0x2763, 0x2364, 0x2765, 0x2766, 0x2367,
+	0x2B68, 0x2F69, 0x2364, 0x2765, 0x2766, 0x2367, 0x2B68, 0x2F69,
+	0x2370, 0x2771, 0x2772, 0x2373, 0x2774, 0x2375, 0x2376, 0x2777,
+	0x2F78, 0x2B79, 0x2774, 0x2375, 0x2376, 0x2777, 0x2F78, 0x2B79,
+	0x8380, 0x8781, 0x8782, 0x8383, 0x8784, 0x8385, 0x8386, 0x8787,
+	0x8F88, 0x8B89, 0x8784, 0x8385, 0x8386, 0x8787, 0x8F88, 0x8B89,
+	0x8790, 0x8391, 0x8392, 0x8793, 0x8394, 0x8795, 0x8796, 0x8397,
+	0x8B98, 0x8F99, 0x8394, 0x8795, 0x8796, 0x8397, 0x8B98, 0x8F99,
+	0x0406, 0x0007, 0x0808, 0x0C09, 0x0C0A, 0x080B, 0x0C0C, 0x080D,
+	0x080E, 0x0C0F, 0x1010, 0x1411, 0x1412, 0x1013, 0x1414, 0x1015,
+	0x0016, 0x0417, 0x0C18, 0x0819, 0x081A, 0x0C1B, 0x081C, 0x0C1D,
+	0x0C1E, 0x081F, 0x3020, 0x3421, 0x3422, 0x3023, 0x3424, 0x3025,
+	0x2026, 0x2427, 0x2C28, 0x2829, 0x282A, 0x2C2B, 0x282C, 0x2C2D,
+	0x2C2E, 0x282F, 0x3430, 0x3031, 0x3032, 0x3433, 0x3034, 0x3435,
+	0x2436, 0x2037, 0x2838, 0x2C39, 0x2C3A, 0x283B, 0x2C3C, 0x283D,
+	0x283E, 0x2C3F, 0x1040, 0x1441, 0x1442, 0x1043, 0x1444, 0x1045,
+	0x0046, 0x0447, 0x0C48, 0x0849, 0x084A, 0x0C4B, 0x084C, 0x0C4D,
+	0x0C4E, 0x084F, 0x1450, 0x1051, 0x1052, 0x1453, 0x1054, 0x1455,
+	0x0456, 0x0057, 0x0858, 0x0C59, 0x0C5A, 0x085B, 0x0C5C, 0x085D,
+	0x085E, 0x0C5F, 0x3460, 0x3061, 0x3062, 0x3463, 0x3064, 0x3465,
+	0x2466, 0x2067, 0x2868, 0x2C69, 0x2C6A, 0x286B, 0x2C6C, 0x286D,
+	0x286E, 0x2C6F, 0x3070, 0x3471, 0x3472, 0x3073, 0x3474, 0x3075,
+	0x2076, 0x2477, 0x2C78, 0x2879, 0x287A, 0x2C7B, 0x287C, 0x2C7D,
+	0x2C7E, 0x287F, 0x9080, 0x9481, 0x9482, 0x9083, 0x9484, 0x9085,
+	0x8086, 0x8487, 0x8C88, 0x8889, 0x888A, 0x8C8B, 0x888C, 0x8C8D,
+	0x8C8E, 0x888F, 0x9490, 0x9091, 0x9092, 0x9493, 0x9094, 0x9495,
+	0x8496, 0x8097, 0x8898, 0x8C99, 0x8C9A, 0x889B, 0x8C9C, 0x889D,
+	0x889E, 0x8C9F, 0x5500, 0x1101, 0x1102, 0x1503, 0x1104, 0x1505,
+	0x0506, 0x0107, 0x0908, 0x0D09, 0x0D0A, 0x090B, 0x0D0C, 0x090D,
+	0x090E, 0x0D0F, 0x1110, 0x1511, 0x1512, 0x1113, 0x1514, 0x1115,
+	0x0116, 0x0517, 0x0D18, 0x0919, 0x091A, 0x0D1B, 0x091C, 0x0D1D,
+	0x0D1E, 0x091F, 0x3120, 0x3521, 0x3522, 0x3123, 0x3524, 0x3125,
+	0x2126, 0x2527, 0x2D28, 0x2929, 0x292A, 0x2D2B, 0x292C, 0x2D2D,
+	0x2D2E, 0x292F, 0x3530, 0x3131, 0x3132, 0x3533, 0x3134, 0x3535,
+	0x2536, 0x2137, 0x2938, 0x2D39, 0x2D3A, 0x293B, 0x2D3C, 0x293D,
+	0x293E, 0x2D3F, 0x1140, 0x1541, 0x1542, 0x1143, 0x1544, 0x1145,
+	0x0146, 0x0547, 0x0D48, 0x0949, 0x094A, 0x0D4B, 0x094C, 0x0D4D,
+	0x0D4E, 0x094F, 0x1550, 0x1151, 0x1152, 0x1553, 0x1154, 0x1555,
+	0x0556, 0x0157, 0x0958, 0x0D59, 0x0D5A, 0x095B, 0x0D5C, 0x095D,
+	0x095E, 0x0D5F, 0x3560, 0x3161, 0x3162, 0x3563, 0x3164, 0x3565,
+	0x2566, 0x2167, 0x2968, 0x2D69, 0x2D6A, 0x296B, 0x2D6C, 0x296D,
+	0x296E, 0x2D6F, 0x3170, 0x3571, 0x3572, 0x3173, 0x3574, 0x3175,
+	0x2176, 0x2577, 0x2D78, 0x2979, 0x297A, 0x2D7B, 0x297C, 0x2D7D,
+	0x2D7E, 0x297F, 0x9180, 0x9581, 0x9582, 0x9183, 0x9584, 0x9185,
+	0x8186, 0x8587, 0x8D88, 0x8989, 0x898A, 0x8D8B, 0x898C, 0x8D8D,
+	0x8D8E, 0x898F, 0x9590, 0x9191, 0x9192, 0x9593, 0x9194, 0x9595,
+	0x8596, 0x8197, 0x8998, 0x8D99, 0x8D9A, 0x899B, 0x8D9C, 0x899D,
+	0x899E, 0x8D9F, 0xB5A0, 0xB1A1, 0xB1A2, 0xB5A3, 0xB1A4, 0xB5A5,
+	0xA5A6, 0xA1A7, 0xA9A8, 0xADA9, 0xADAA, 0xA9AB, 0xADAC, 0xA9AD,
+	0xA9AE, 0xADAF, 0xB1B0, 0xB5B1, 0xB5B2, 0xB1B3, 0xB5B4, 0xB1B5,
+	0xA1B6, 0xA5B7, 0xADB8, 0xA9B9, 0xA9BA, 0xADBB, 0xA9BC, 0xADBD,
+	0xADBE, 0xA9BF, 0x95C0, 0x91C1, 0x91C2, 0x95C3, 0x91C4, 0x95C5,
+	0x85C6, 0x81C7, 0x89C8, 0x8DC9, 0x8DCA, 0x89CB, 0x8DCC, 0x89CD,
+	0x89CE, 0x8DCF, 0x91D0, 0x95D1, 0x95D2, 0x91D3, 0x95D4, 0x91D5,
+	0x81D6, 0x85D7, 0x8DD8, 0x89D9, 0x89DA, 0x8DDB, 0x89DC, 0x8DDD,
+	0x8DDE, 0x89DF, 0xB1E0, 0xB5E1, 0xB5E2, 0xB1E3, 0xB5E4, 0xB1E5,
+	0xA1E6, 0xA5E7, 0xADE8, 0xA9E9, 0xA9EA, 0xADEB, 0xA9EC, 0xADED,
+	0xADEE, 0xA9EF, 0xB5F0, 0xB1F1, 0xB1F2, 0xB5F3, 0xB1F4, 0xB5F5,
+	0xA5F6, 0xA1F7, 0xA9F8, 0xADF9, 0xADFA, 0xA9FB, 0xADFC, 0xA9FD,
+	0xA9FE, 0xADFF, 0x5500, 0x1101, 0x1102, 0x1503, 0x1104, 0x1505,
+	0x0506, 0x0107, 0x0908, 0x0D09, 0x0D0A, 0x090B, 0x0D0C, 0x090D,
+	0x090E, 0x0D0F, 0x1110, 0x1511, 0x1512, 0x1113, 0x1514, 0x1115,
+	0x0116, 0x0517, 0x0D18, 0x0919, 0x091A, 0x0D1B, 0x091C, 0x0D1D,
+	0x0D1E, 0x091F, 0x3120, 0x3521, 0x3522, 0x3123, 0x3524, 0x3125,
+	0x2126, 0x2527, 0x2D28, 0x2929, 0x292A, 0x2D2B, 0x292C, 0x2D2D,
+	0x2D2E, 0x292F, 0x3530, 0x3131, 0x3132, 0x3533, 0x3134, 0x3535,
+	0x2536, 0x2137, 0x2938, 0x2D39, 0x2D3A, 0x293B, 0x2D3C, 0x293D,
+	0x293E, 0x2D3F, 0x1140, 0x1541, 0x1542, 0x1143, 0x1544, 0x1145,
+	0x0146, 0x0547, 0x0D48, 0x0949, 0x094A, 0x0D4B, 0x094C, 0x0D4D,
+	0x0D4E, 0x094F, 0x1550, 0x1151, 0x1152, 0x1553, 0x1154, 0x1555,
+	0x0556, 0x0157, 0x0958, 0x0D59, 0x0D5A, 0x095B, 0x0D5C, 0x095D,
+	0x095E, 0x0D5F, 0x3560, 0x3161, 0x3162, 0x3563, 0x3164, 0x3565,
+	0xBEFA, 0xBAFB, 0xBEFC, 0xBAFD, 0xBAFE, 0xBEFF, 0x4600, 0x0201,
+	0x0202, 0x0603, 0x0204, 0x0605, 0x0606, 0x0207, 0x0A08, 0x0E09,
+	0x1E0A, 0x1A0B, 0x1E0C, 0x1A0D, 0x1A0E, 0x1E0F, 0x0210, 0x0611,
+	0x0612, 0x0213, 0x0614, 0x0215, 0x0216, 0x0617, 0x0E18, 0x0A19,
+	0x1A1A, 0x1E1B, 0x1A1C, 0x1E1D, 0x1E1E, 0x1A1F, 0x2220, 0x2621,
+	0x2622, 0x2223, 0x2624, 0x2225, 0x2226, 0x2627, 0x2E28, 0x2A29,
+	0x3A2A, 0x3E2B, 0x3A2C, 0x3E2D, 0x3E2E, 0x3A2F, 0x2630, 0x2231,
+	0x2232, 0x2633, 0x2234, 0x2635, 0x2636, 0x2237, 0x2A38, 0x2E39,
+	0x3E3A, 0x3A3B, 0x3E3C, 0x3A3D, 0x3A3E, 0x3E3F, 0x0240, 0x0641,
+	0x0642, 0x0243, 0x0644, 0x0245, 0x0246, 0x0647, 0x0E48, 0x0A49,
+	0x1A4A, 0x1E4B, 0x1A4C, 0x1E4D, 0x1E4E, 0x1A4F, 0x0650, 0x0251,
+	0x0252, 0x0653, 0x0254, 0x0655, 0x0656, 0x0257, 0x0A58, 0x0E59,
+	0x1E5A, 0x1A5B, 0x1E5C, 0x1A5D, 0x1A5E, 0x1E5F, 0x2660, 0x2261,
+	0x2262, 0x2663, 0x2264, 0x2665, 0x2666, 0x2267, 0x2A68, 0x2E69,
+	0x3E6A, 0x3A6B, 0x3E6C, 0x3A6D, 0x3A6E, 0x3E6F, 0x2270, 0x2671,
+	0x2672, 0x2273, 0x2674, 0x2275, 0x2276, 0x2677, 0x2E78, 0x2A79,
+	0x3A7A, 0x3E7B, 0x3A7C, 0x3E7D, 0x3E7E, 0x3A7F, 0x8280, 0x8681,
+	0x8682, 0x8283, 0x8684, 0x8285, 0x8286, 0x8687, 0x8E88, 0x8A89,
+	0x9A8A, 0x9E8B, 0x9A8C, 0x9E8D, 0x9E8E, 0x9A8F, 0x8690, 0x8291,
+	0x8292, 0x8693, 0x2334, 0x2735, 0x2736, 0x2337, 0x2B38, 0x2F39,
+	0x3F3A, 0x3B3B, 0x3F3C, 0x3B3D, 0x3B3E, 0x3F3F, 0x0340, 0x0741,
+	0x0742, 0x0343, 0x0744, 0x0345, 0x0346, 0x0747, 0x0F48, 0x0B49,
+	0x1B4A, 0x1F4B, 0x1B4C, 0x1F4D, 0x1F4E, 0x1B4F, 0x0750, 0x0351,
+	0x0352, 0x0753, 0x0354, 0x0755, 0x0756, 0x0357, 0x0B58, 0x0F59,
+	0x1F5A, 0x1B5B, 0x1F5C, 0x1B5D, 0x1B5E, 0x1F5F, 0x2760, 0x2361,
+	0x2362, 0x2763, 0x2364, 0x2765, 0x2766, 0x2367, 0x2B68, 0x2F69,
+	0x3F6A, 0x3B6B, 0x3F6C, 0x3B6D, 0x3B6E, 0x3F6F, 0x2370, 0x2771,
+	0x2772, 0x2373, 0x2774, 0x2375, 0x2376, 0x2777, 0x2F78, 0x2B79,
+	0x3B7A, 0x3F7B, 0x3B7C, 0x3F7D, 0x3F7E, 0x3B7F, 0x8380, 0x8781,
+	0x8782, 0x8383, 0x8784, 0x8385, 0x8386, 0x8787, 0x8F88, 0x8B89,
+	0x9B8A, 0x9F8B, 0x9B8C, 0x9F8D, 0x9F8E, 0x9B8F, 0x8790, 0x8391,
+	0x8392, 0x8793, 0x8394, 0x8795, 0x8796, 0x8397, 0x8B98, 0x8F99,
+	0x9F9A, 0x9B9B, 0x9F9C, 0x9B9D, 0x9B9E, 0x9F9F, 0xA7A0, 0xA3A1,
+	0xA3A2, 0xA7A3, 0xA3A4, 0xA7A5, 0xA7A6, 0xA3A7, 0xABA8, 0xAFA9,
+	0xBFAA, 0xBBAB, 0xBFAC, 0xBBAD, 0xBBAE, 0xBFAF, 0xA3B0, 0xA7B1,
+	0xA7B2, 0xA3B3, 0xA7B4, 0xA3B5, 0xA3B6, 0xA7B7, 0xAFB8, 0xABB9,
+	0xBBBA, 0xBFBB, 0xBBBC, 0xBFBD, 0xBFBE, 0xBBBF, 0x87C0, 0x83C1,
+	0x83C2, 0x87C3, 0x83C4, 0x87C5, 0x87C6, 0x83C7, 0x8BC8, 0x8FC9,
+	0x9FCA, 0x9BCB, 0x9FCC, 0x9BCD, 0x9BCE, 0x9FCF, 0x83D0, 0x87D1,
+	0x87D2, 0x83D3, 0x87D4, 0x83D5, 0x83D6, 0x87D7, 0x8FD8, 0x8BD9,
+	0x9BDA, 0x9FDB, 0x9BDC, 0x9FDD, 0x9FDE, 0x9BDF, 0xA3E0, 0xA7E1,
+	0xA7E2, 0xA3E3, 0xA7E4, 0xA3E5, 0xA3E6, 0xA7E7, 0xAFE8, 0xABE9,
+	0xBBEA, 0xBFEB, 0xBBEC, 0xBFED, 0xBFEE, 0xBBEF, 0xA7F0, 0xA3F1,
+	0xA3F2, 0xA7F3, 0xA3F4, 0xA7F5, 0xA7F6, 0xA3F7, 0xABF8, 0xAFF9,
+	0xBFFA, 0xBBFB, 0xBFFC, 0xBBFD, 0xBBFE, 0xBFFF, 0x4700, 0x0301,
+	0x0302, 0x0703, 0x0304, 0x0705, 0x0706, 0x0307, 0x0B08, 0x0F09,
+	0x1F0A, 0x1B0B, 0x1F0C, 0x1B0D, 0x1B0E, 0x1F0F, 0x0310, 0x0711,
+	0x0712, 0x0313, 0x0714, 0x0315, 0x0316, 0x0717, 0x0F18, 0x0B19,
+	0x1B1A, 0x1F1B, 0x1B1C, 0x1F1D, 0x1F1E, 0x1B1F, 0x2320, 0x2721,
+	0x2722, 0x2323, 0x2724, 0x2325, 0x2326, 0x2727, 0x2F28, 0x2B29,
+	0x3B2A, 0x3F2B, 0x3B2C, 0x3F2D, 0x3F2E, 0x3B2F, 0x2730, 0x2331,
+	0x2332, 0x2733, 0x2334, 0x2735, 0x2736, 0x2337, 0x2B38, 0x2F39,
+	0x3F3A, 0x3B3B, 0x3F3C, 0x3B3D, 0x3B3E, 0x3F3F, 0x0340, 0x0741,
+	0x0742, 0x0343, 0x0744, 0x0345, 0x0346, 0x0747, 0x0F48, 0x0B49,
+	0x1B4A, 0x1F4B, 0x1B4C, 0x1F4D, 0x1F4E, 0x1B4F, 0x0750, 0x0351,
+	0x0352, 0x0753, 0x0354, 0x0755, 0x0756, 0x0357, 0x0B58, 0x0F59,
+	0x1F5A, 0x1B5B, 0x1F5C, 0x1B5D, 0x1B5E, 0x1F5F, 0x2760, 0x2361,
+	0x2362, 0x2763, 0x2364, 0x2765, 0x2766, 0x2367, 0x2B68, 0x2F69,
+	0x3F6A, 0x3B6B, 0x3F6C, 0x3B6D, 0x3B6E, 0x3F6F, 0x2370, 0x2771,
+	0x2772, 0x2373, 0x2774, 0x2375, 0x2376, 0x2777, 0x2F78, 0x2B79,
+	0x3B7A, 0x3F7B, 0x3B7C, 0x3F7D, 0x3F7E, 0x3B7F, 0x8380, 0x8781,
+	0x8782, 0x8383, 0x8784, 0x8385, 0x8386, 0x8787, 0x8F88, 0x8B89,
+	0x9B8A, 0x9F8B, 0x9B8C, 0x9F8D, 0x9F8E, 0x9B8F, 0x8790, 0x8391,
+	0x8392, 0x8793, 0x8394, 0x8795, 0x8796, 0x8397, 0x8B98, 0x8F99
+};
+
+// BIT n,r flags when the bit is set
+
+static const UINT8 BIT_Table[8] = { 0, 0, 0, FLAG_X, 0, FLAG_Y, 0, FLAG_S };
+
+// CB register field -> register
+
+static const UINT32 Reg_Offset[8] =
+{
+	offsetof(Z80_CONTEXT, BC.b.B), offsetof(Z80_CONTEXT, BC.b.C),
+	offsetof(Z80_CONTEXT, DE.b.D), offsetof(Z80_CONTEXT, DE.b.E),
+	offsetof(Z80_CONTEXT, HL.b.H), offsetof(Z80_CONTEXT, HL.b.L),
+	0, offsetof(Z80_CONTEXT, AF.b.A)
+};
+
+
+/***************************/
+/* Registers & memory      */
+/***************************/
+
+#define zA		z->AF.b.A
+#define zF		z->AF.b.F
+#define zFXY	z->AF.b.FXY
+#define zB		z->BC.b.B
+#define zC		z->BC.b.C
+#define zBC		z->BC.w.BC
+#define zD		z->DE.b.D
+#define zE		z->DE.b.E
+#define zDE		z->DE.w.DE
+#define zH		z->HL.b.H
+#define zL		z->HL.b.L
+#define zHL		z->HL.w.HL
+#define zSP		z->SP.w.SP
+#define zI		z->I
+#define zR		z->R.b.R1
+#define zIM		z->IM
+#define zIFF2	z->IFF.b.IFF2		// z80.asm names this byte zIFF1 and zIFF2
+
+// IX or IY for DD/FD prefixed instructions
+#define zXY		(*xy)
+#define zhXY	(((UINT8 *) xy)[1])
+#define zlXY	(((UINT8 *) xy)[0])
+
+#define SZ_FLAGS(r)		(((r) & FLAG_S) | (((r) & 0xFF) ? 0 : FLAG_Z))
+
+#define GET_WORD(n)		(pc[n] | (pc[(n) + 1] << 8))
+#define XY_ADR			((zXY + (INT8) pc[1]) & 0xFFFF)
+
+
+// Memory access, same fast path as the GENS_OPT macros of z80.asm.
+// 'cyc' is handed to the handlers through CycleIO so they can read
+// the odometer or end the timeslice.
+
+#define READ_BYTE(adr, dst)									\
+{															\
+	UINT32 a_ = (adr);										\
+	if (a_ <= 0x3FFF) dst = Ram_Z80[a_ & 0x1FFF];			\
+	else													\
+	{														\
+		z->CycleIO = cyc;									\
+		dst = z->ReadB[(a_ >> 8) & 0xFF](a_);				\
+		cyc = (int) z->CycleIO;								\
+	}														\
+}
+
+#define WRITE_BYTE(adr, src)								\
+{															\
+	UINT32 a_ = (adr);										\
+	if (a_ <= 0x3FFF) Ram_Z80[a_ & 0x1FFF] = (UINT8) (src);	\
+	else													\
+	{														\
+		z->CycleIO = cyc;									\
+		z->WriteB[(a_ >> 8) & 0xFF](a_, (UINT8) (src));		\
+		cyc = (int) z->CycleIO;								\
+	}														\
+}
+
+// the word access at 0x1FFF reads or writes the byte after Ram_Z80,
+// like the asm does
+
+#define READ_WORD(adr, dst)									\
+{															\
+	UINT32 a_ = (adr);										\
+	if (a_ <= 0x3FFF)										\
+	{														\
+		a_ &= 0x1FFF;										\
+		dst = (UINT16) (Ram_Z80[a_] | (Ram_Z80[a_ + 1] << 8));	\
+	}														\
+	else													\
+	{														\
+		z->CycleIO = cyc;									\
+		dst = z->ReadW[(a_ >> 8) & 0xFF](a_);				\
+		cyc = (int) z->CycleIO;								\
+	}														\
+}
+
+#define WRITE_WORD(adr, src)								\
+{															\
+	UINT32 a_ = (adr), d_ = (src);							\
+	if (a_ <= 0x3FFF)										\
+	{														\
+		a_ &= 0x1FFF;										\
+		Ram_Z80[a_] = (UINT8) d_;							\
+		Ram_Z80[a_ + 1] = (UINT8) (d_ >> 8);				\
+	}														\
+	else													\
+	{														\
+		z->CycleIO = cyc;									\
+		z->WriteW[(a_ >> 8) & 0xFF](a_, (UINT16) d_);		\
+		cyc = (int) z->CycleIO;								\
+	}														\
+}
+
+#define PUSH_WORD(src)										\
+{															\
+	UINT32 v_ = (src);										\
+	z->SP.d = (z->SP.d - 2) & 0xFFFF;						\
+	WRITE_WORD(z->SP.d, v_)									\
+}
+
+#define POP_WORD(dst)										\
+{															\
+	READ_WORD(z->SP.d, dst)									\
+	z->SP.d = (z->SP.d + 2) & 0xFFFF;						\
+}
+
+// jumps and calls rebase PC, straight code and JR don't
+
+#define UNBASED_PC		((UINT32) (pc - Base_PC))
+
+#define REBASE_PC(adr)										\
+{															\
+	UINT32 p_ = (adr);										\
+	Base_PC = z->Fetch[p_ >> 8];							\
+	pc = Base_PC + p_;										\
+}
+
+#define CHECK_INT											\
+	if ((z->IntLine & 0x80) || (z->IntLine & zIFF2))		\
+		pc = Z80_Do_Int(z, pc, &cyc);
+
+
+/***************************/
+/* Instruction macros      */
+/***************************/
+
+#define NEXT(n)												\
+{															\
+	cyc -= (n);												\
+	if (cyc < 0) goto Exec_Quit;							\
+	goto Next_Op;											\
+}
+
+#define ADD_A(src, carry)									\
+{															\
+	UINT32 s_ = (src), r_ = zA + s_ + (carry);				\
+	zF = (UINT8) (SZ_FLAGS(r_) | ((zA ^ s_ ^ r_) & FLAG_H) | ((((zA ^ r_) & (s_ ^ r_)) >> 5) & FLAG_P) | ((r_ >> 8) & FLAG_C));	\
+	zA = (UINT8) r_;										\
+	zFXY = zA;												\
+}
+
+#define SUB_A(src, carry)									\
+{															\
+	UINT32 s_ = (src), r_ = zA - s_ - (carry);				\
+	zF = (UINT8) (SZ_FLAGS(r_) | ((zA ^ s_ ^ r_) & FLAG_H) | ((((zA ^ s_) & (zA ^ r_)) >> 5) & FLAG_P) | FLAG_N | ((r_ >> 8) & FLAG_C));	\
+	zA = (UINT8) r_;										\
+	zFXY = zA;												\
+}
+
+#define CP_A(src)											\
+{															\
+	UINT32 s_ = (src), r_ = zA - s_;						\
+	zF = (UINT8) (SZ_FLAGS(r_) | ((zA ^ s_ ^ r_) & FLAG_H) | ((((zA ^ s_) & (zA ^ r_)) >> 5) & FLAG_P) | FLAG_N | ((r_ >> 8) & FLAG_C));	\
+	zFXY = (UINT8) s_;										\
+}
+
+// CP A/H/L don't load their operand in DL, the asm takes X/Y from the opcode
+#define CP_OPCODE_XY(op)	if (((op) & 0xF8) == 0xB8) zFXY = (UINT8) (op);
+
+#define AND_A(src)	{ zA &= (src); zF = SZP_Table[zA] | FLAG_H; zFXY = zA; }
+#define XOR_A(src)	{ zA ^= (src); zF = SZP_Table[zA]; zFXY = zA; }
+#define OR_A(src)	{ zA |= (src); zF = SZP_Table[zA]; zFXY = zA; }
+
+// ALU op by the opcode bits 3-5
+#define ARITH_A(op, src)									\
+{															\
+	UINT8 v_ = (src);										\
+	switch(((op) >> 3) & 7)									\
+	{														\
+		case 0: ADD_A(v_, 0) break;							\
+		case 1: ADD_A(v_, zF & FLAG_C) break;				\
+		case 2: SUB_A(v_, 0) break;							\
+		case 3: SUB_A(v_, zF & FLAG_C) break;				\
+		case 4: AND_A(v_) break;							\
+		case 5: XOR_A(v_) break;							\
+		case 6: OR_A(v_) break;								\
+		default: CP_A(v_) break;							\
+	}														\
+}
+
+#define INC_R(r)	{ zF = (zF & FLAG_C) | INC_Table[r]; (r)++; zFXY = (r); }
+#define DEC_R(r)	{ zF = (zF & FLAG_C) | DEC_Table[r]; (r)--; zFXY = (r); }
+
+#define ADD_RR(dst, src)									\
+{															\
+	UINT32 d_ = (dst), s_ = (src), r_ = d_ + s_;			\
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | (((d_ ^ s_ ^ r_) >> 8) & FLAG_H) | (r_ >> 16);	\
+	dst = (UINT16) r_;										\
+	zFXY = (UINT8) (r_ >> 8);								\
+}
+
+#define ADC_HL(src)											\
+{															\
+	UINT32 s_ = (src), r_ = zHL + s_ + (zF & FLAG_C);		\
+	zF = (UINT8) (((r_ >> 8) & FLAG_S) | ((r_ & 0xFFFF) ? 0 : FLAG_Z) | (((zHL ^ s_ ^ r_) >> 8) & FLAG_H) | ((((zHL ^ r_) & (s_ ^ r_)) >> 13) & FLAG_P) | (r_ >> 16));	\
+	zHL = (UINT16) r_;										\
+	zFXY = zH;												\
+}
+
+#define SBC_HL(src)											\
+{															\
+	UINT32 s_ = (src), r_ = zHL - s_ - (zF & FLAG_C);		\
+	zF = (UINT8) (((r_ >> 8) & FLAG_S) | ((r_ & 0xFFFF) ? 0 : FLAG_Z) | (((zHL ^ s_ ^ r_) >> 8) & FLAG_H) | ((((zHL ^ s_) & (zHL ^ r_)) >> 13) & FLAG_P) | FLAG_N | ((r_ >> 16) & FLAG_C));	\
+	zHL = (UINT16) r_;										\
+	zFXY = zH;												\
+}
+
+#define BIT_FLAGS(b, src, fxy)								\
+{															\
+	zF = (zF & FLAG_C) | FLAG_H;							\
+	if ((src) & (1 << (b)))									\
+	{														\
+		zF |= BIT_Table[b];									\
+		zFXY = (((b) == 3) || ((b) == 5)) ? (UINT8) (fxy) : 0;	\
+	}														\
+	else													\
+	{														\
+		zF |= FLAG_Z | FLAG_P;								\
+		zFXY = 0;											\
+	}														\
+}
+
+// cc in bits 3-5 of the RET/JP/CALL cc opcodes, JR cc uses the first four
+#define COND(op)	((zF & Cond_Mask[((op) >> 4) & 3]) ? ((op) & 8) : !((op) & 8))
+
+static const UINT8 Cond_Mask[4] = { FLAG_Z, FLAG_C, FLAG_P, FLAG_S };
+
+
+/***************************/
+/* Internals functions     */
+/***************************/
+
+// CB rotations and shifts, returns the result. SLL returns the value
+// before bit 0 is set, callers differ about when they set it.
+
+static INLINE UINT8 Z80_Rotate(Z80_CONTEXT *z, UINT32 op, UINT32 src)
+{
+	UINT32 res, c;
+
+	switch((op >> 3) & 7)
+	{
+		case 0:		// RLC
+			c = src >> 7;
+			res = (src << 1) | c;
+			break;
+
+		case 1:		// RRC
+			c = src & 1;
+			res = (src >> 1) | (c << 7);
+			break;
+
+		case 2:		// RL
+			c = src >> 7;
+			res = (src << 1) | (zF & FLAG_C);
+			break;
+
+		case 3:		// RR
+			c = src & 1;
+			res = (src >> 1) | ((zF & FLAG_C) << 7);
+			break;
+
+		case 4:		// SLA
+		case 6:		// SLL
+			c = src >> 7;
+			res = src << 1;
+			break;
+
+		case 5:		// SRA
+			c = src & 1;
+			res = (src >> 1) | (src & 0x80);
+			break;
+
+		default:	// SRL
+			c = src & 1;
+			res = src >> 1;
+			break;
+	}
+
+	res &= 0xFF;
+	zF = SZP_Table[res] | (UINT8) c;
+	zFXY = (UINT8) res;
+	if (((op >> 3) & 7) == 6) zF |= FLAG_P;
+
+	return (UINT8) res;
+}
+
+
+// do_NMI / do_INT
+
+static UINT8 *Z80_Do_Int(Z80_CONTEXT *z, UINT8 *pc, int *cycles)
+{
+	int cyc = *cycles;
+	UINT32 adr;
+
+	PUSH_WORD(UNBASED_PC)
+
+	if (z->IntLine & 0x80)
+	{
+		zIFF2 = 0;
+		z->IntLine &= ~0x80;
+		z->Status &= ~Z80_HALTED;
+		adr = 0x66;
+	}
+	else
+	{
+		z->Status &= ~Z80_HALTED;
+		z->IntLine &= 0x80;
+		z->IFF.d = 0;
+
+		if (zIM == 0)
+		{
+			cyc -= 13;
+			adr = (UINT8) (z->IntVect - 0xC7);		// assume we have a RST instruction
+		}
+		else if (zIM == 1)
+		{
+			cyc -= 13;
+			adr = 0x38;
+		}
+		else
+		{
+			UINT16 vec;
+
+			cyc -= 19;
+			READ_WORD((zI << 8) | z->IntVect, vec)
+			adr = vec;
+		}
+	}
+
+	REBASE_PC(adr)
+
+	*cycles = cyc;
+	return pc;
+}
+
+
+/***************************/
+/* Default handlers        */
+/***************************/
+
+static UINT8 FASTCALL Def_z80_ReadB(UINT32 adr)
+{
+	return Def_z80_Mem[adr & 0xFFFF];
+}
+
+static UINT16 FASTCALL Def_z80_ReadW(UINT32 adr)
+{
+	adr &= 0xFFFF;
+	return (UINT16) (Def_z80_Mem[adr] | (Def_z80_Mem[adr + 1] << 8));
+}
+
+static void FASTCALL Def_z80_WriteB(UINT32 adr, UINT8 data)
+{
+	Def_z80_Mem[adr & 0xFFFF] = data;
+}
+
+static void FASTCALL Def_z80_WriteW(UINT32 adr, UINT16 data)
+{
+	adr &= 0xFFFF;
+	Def_z80_Mem[adr] = (UINT8) data;
+	Def_z80_Mem[adr + 1] = (UINT8) (data >> 8);
+}
+
+
+/*******************/
+/* Publics functions */
+/*******************/
+
+UINT32 FASTCALL z80_Init(Z80_CONTEXT *z80)
+{
+	int i;
+
+	memset(z80, 0, sizeof(Z80_CONTEXT));
+	memset(Def_z80_Mem, 0, sizeof(Def_z80_Mem));
+
+	for(i = 0; i < 0x100; i++)
+	{
+		z80->ReadB[i] = Def_z80_ReadB;
+		z80->ReadW[i] = Def_z80_ReadW;
+		z80->WriteB[i] = Def_z80_WriteB;
+		z80->WriteW[i] = Def_z80_WriteW;
+		z80->Fetch[i] = Def_z80_Mem;
+	}
+
+	z80->IN_C = Def_z80_WriteB;
+	z80->OUT_C = Def_z80_ReadB;
+
+	for(i = 0; i < 256; i++)
+	{
+		int p = i ^ (i >> 4);
+
+		p ^= p >> 2;
+		p ^= p >> 1;
+		SZP_Table[i] = (UINT8) (SZ_FLAGS(i) | ((p & 1) ? 0 : FLAG_P));
+	}
+
+	return 0;
+}
+
+
+UINT32 FASTCALL z80_Reset(Z80_CONTEXT *z80)
+{
+	UINT32 odo = z80->CycleCnt;
+
+	memset(z80, 0, offsetof(Z80_CONTEXT, ReadB));
+	z80->CycleCnt = odo;
+
+	Base_PC = z80->Fetch[0];
+	z80->PC.d = 0;
+	z80->IX.d = 0xFFFF;
+	z80->IY.d = 0xFFFF;
+	z80->AF.d = 0x4000;
+
+	return 0;
+}
+
+
+UINT32 z80_Add_ReadB(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_RB *Func)
+{
+	UINT32 i;
+
+	for(i = low_adr & 0xFF; i <= (high_adr & 0xFF); i++) z80->ReadB[i] = Func;
+	return 0;
+}
+
+UINT32 z80_Add_ReadW(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_RW *Func)
+{
+	UINT32 i;
+
+	for(i = low_adr & 0xFF; i <= (high_adr & 0xFF); i++) z80->ReadW[i] = Func;
+	return 0;
+}
+
+UINT32 z80_Add_WriteB(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_WB *Func)
+{
+	UINT32 i;
+
+	for(i = low_adr & 0xFF; i <= (high_adr & 0xFF); i++) z80->WriteB[i] = Func;
+	return 0;
+}
+
+UINT32 z80_Add_WriteW(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_WW *Func)
+{
+	UINT32 i;
+
+	for(i = low_adr & 0xFF; i <= (high_adr & 0xFF); i++) z80->WriteW[i] = Func;
+	return 0;
+}
+
+UINT32 z80_Add_Fetch(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, UINT8 *Region)
+{
+	UINT32 i;
+
+	// Region is stored pre-offset so that base + PC is the host address
+	for(i = low_adr & 0xFF; i <= (high_adr & 0xFF); i++) z80->Fetch[i] = Region - ((low_adr & 0xFF) << 8);
+	return 0;
+}
+
+
+UINT32 FASTCALL z80_Read_Odo(Z80_CONTEXT *z80)
+{
+	if (z80->Status & Z80_RUNNING) return z80->CycleCnt + z80->CycleTD - z80->CycleIO;
+	return z80->CycleCnt;
+}
+
+void FASTCALL z80_Clear_Odo(Z80_CONTEXT *z80)
+{
+	z80->CycleCnt = 0;
+}
+
+void FASTCALL z80_Set_Odo(Z80_CONTEXT *z80, UINT32 Odo)
+{
+	z80->CycleCnt = Odo;
+}
+
+void FASTCALL z80_Add_Cycles(Z80_CONTEXT *z80, UINT32 cycles)
+{
+	if (z80->Status & Z80_RUNNING) z80->CycleIO -= cycles;
+	else z80->CycleCnt += cycles;
+}
+
+
+UINT32 FASTCALL z80_NMI(Z80_CONTEXT *z80)
+{
+	z80->IntVect = 0x66;
+	z80->IntLine = 0x80;
+
+	if (z80->Status & Z80_RUNNING)
+	{
+		z80->CycleSup = z80->CycleIO;
+		z80->CycleIO = 0;
+	}
+
+	return 0;
+}
+
+UINT32 FASTCALL z80_Interrupt(Z80_CONTEXT *z80, UINT32 vector)
+{
+	z80->IntVect = (UINT8) vector;
+	z80->IntLine = FLAG_P;		// because of IFF mask
+
+	if (z80->Status & Z80_RUNNING)
+	{
+		z80->CycleSup = z80->CycleIO;
+		z80->CycleIO = 0;
+	}
+
+	return 0;
+}
+
+
+UINT32 FASTCALL z80_Get_PC(Z80_CONTEXT *z80)
+{
+	if (z80->Status & Z80_RUNNING) return (UINT32) -1;
+	return z80->PC.d;
+}
+
+UINT32 FASTCALL z80_Set_PC(Z80_CONTEXT *z80, UINT32 PC)
+{
+	if (!(z80->Status & Z80_RUNNING))
+	{
+		PC &= 0xFFFF;
+		Base_PC = z80->Fetch[PC >> 8];
+		z80->PC.d = PC;
+	}
+
+	return 0;
+}
+
+UINT32 FASTCALL z80_Get_AF(Z80_CONTEXT *z80)
+{
+	if (z80->Status & Z80_RUNNING) return (UINT32) -1;
+	return (z80->AF.b.A << 8) | (z80->AF.b.F & ~(FLAG_X | FLAG_Y)) | (z80->AF.b.FXY & (FLAG_X | FLAG_Y));
+}
+
+UINT32 FASTCALL z80_Set_AF(Z80_CONTEXT *z80, UINT32 AF)
+{
+	if (!(z80->Status & Z80_RUNNING))
+	{
+		z80->AF.b.FXY = (UINT8) (AF & (FLAG_X | FLAG_Y));
+		z80->AF.b.F = (UINT8) (AF & ~(FLAG_X | FLAG_Y));
+		z80->AF.b.A = (UINT8) (AF >> 8);
+	}
+
+	return 0;
+}
+
+UINT32 FASTCALL z80_Get_AF2(Z80_CONTEXT *z80)
+{
+	if (z80->Status & Z80_RUNNING) return (UINT32) -1;
+	return (z80->AF2.b.A2 << 8) | (z80->AF2.b.F2 & ~(FLAG_X | FLAG_Y)) | (z80->AF2.b.FXY2 & (FLAG_X | FLAG_Y));
+}
+
+UINT32 FASTCALL z80_Set_AF2(Z80_CONTEXT *z80, UINT32 AF2)
+{
+	if (!(z80->Status & Z80_RUNNING))
+	{
+		z80->AF2.b.FXY2 = (UINT8) (AF2 & (FLAG_X | FLAG_Y));
+		z80->AF2.b.F2 = (UINT8) (AF2 & ~(FLAG_X | FLAG_Y));
+		z80->AF2.b.A2 = (UINT8) (AF2 >> 8);
+	}
+
+	return 0;
+}
+
+
+/***************************/
+/* Execution               */
+/***************************/
+
+// Returns 0, or -1 when odo is already reached.
+// Like the asm version, cycles taken by an interrupt accepted on entry
+// don't go to the odometer and leaving a HALT, a block instruction or an
+// interrupted EI also depends on the last value in edx ('quit' here).
+
+UINT32 FASTCALL z80_Exec(Z80_CONTEXT *z, int odo)
+{
+	UINT8 *pc;
+	UINT16 *xy;
+	UINT8 *r8;
+	UINT32 op, adr;
+	UINT16 w16;
+	UINT8 d8;
+	int cyc, quit;
+
+	if ((UINT32) odo <= z->CycleCnt) return (UINT32) -1;
+
+	cyc = (int) ((UINT32) odo - z->CycleCnt) - 1;
+	pc = Base_PC + z->PC.d;
+
+	CHECK_INT
+
+	if (z->Status & (Z80_HALTED | Z80_FAULTED | Z80_RUNNING))
+	{
+		if (z->Status & Z80_HALTED) z->CycleCnt += cyc;
+		return 0;
+	}
+
+	z->Status |= Z80_RUNNING;
+	z->CycleSup = 0;
+	z->CycleTD = cyc;
+
+	for(;;)
+	{
+Next_Op:
+		op = *pc;
+
+Dispatch:
+		switch(op)
+		{
+			case 0x00:	// NOP
+				pc++;
+				NEXT(4)
+
+			// LD rr,nn
+
+			case 0x01: zBC = (UINT16) GET_WORD(1); pc += 3; NEXT(10)
+			case 0x11: zDE = (UINT16) GET_WORD(1); pc += 3; NEXT(10)
+			case 0x21: zHL = (UINT16) GET_WORD(1); pc += 3; NEXT(10)
+			case 0x31: zSP = (UINT16) GET_WORD(1); pc += 3; NEXT(10)
+
+			// LD (rr),A / LD A,(rr)
+
+			case 0x02: pc++; WRITE_BYTE(z->BC.d, zA) NEXT(7)
+			case 0x12: pc++; WRITE_BYTE(z->DE.d, zA) NEXT(7)
+			case 0x0A: pc++; READ_BYTE(z->BC.d, zA) NEXT(7)
+			case 0x1A: pc++; READ_BYTE(z->DE.d, zA) NEXT(7)
+
+			// INC/DEC rr
+
+			case 0x03: zBC++; pc++; NEXT(6)
+			case 0x13: zDE++; pc++; NEXT(6)
+			case 0x23: zHL++; pc++; NEXT(6)
+			case 0x33: zSP++; pc++; NEXT(6)
+			case 0x0B: zBC--; pc++; NEXT(6)
+			case 0x1B: zDE--; pc++; NEXT(6)
+			case 0x2B: zHL--; pc++; NEXT(6)
+			case 0x3B: zSP--; pc++; NEXT(6)
+
+			// INC/DEC r
+
+			case 0x04: INC_R(zB) pc++; NEXT(4)
+			case 0x0C: INC_R(zC) pc++; NEXT(4)
+			case 0x14: INC_R(zD) pc++; NEXT(4)
+			case 0x1C: INC_R(zE) pc++; NEXT(4)
+			case 0x24: INC_R(zH) pc++; NEXT(4)
+			case 0x2C: INC_R(zL) pc++; NEXT(4)
+			case 0x3C: INC_R(zA) pc++; NEXT(4)
+			case 0x05: DEC_R(zB) pc++; NEXT(4)
+			case 0x0D: DEC_R(zC) pc++; NEXT(4)
+			case 0x15: DEC_R(zD) pc++; NEXT(4)
+			case 0x1D: DEC_R(zE) pc++; NEXT(4)
+			case 0x25: DEC_R(zH) pc++; NEXT(4)
+			case 0x2D: DEC_R(zL) pc++; NEXT(4)
+			case 0x3D: DEC_R(zA) pc++; NEXT(4)
+
+			case 0x34:	// INC (HL)
+				pc++;
+				READ_BYTE(zHL, d8)
+				INC_R(d8)
+				WRITE_BYTE(zHL, d8)
+				NEXT(11)
+
+			case 0x35:	// DEC (HL)
+				pc++;
+				READ_BYTE(zHL, d8)
+				DEC_R(d8)
+				WRITE_BYTE(zHL, d8)
+				NEXT(11)
+
+			// LD r,n
+
+			case 0x06: zB = pc[1]; pc += 2; NEXT(7)
+			case 0x0E: zC = pc[1]; pc += 2; NEXT(7)
+			case 0x16: zD = pc[1]; pc += 2; NEXT(7)
+			case 0x1E: zE = pc[1]; pc += 2; NEXT(7)
+			case 0x26: zH = pc[1]; pc += 2; NEXT(7)
+			case 0x2E: zL = pc[1]; pc += 2; NEXT(7)
+			case 0x3E: zA = pc[1]; pc += 2; NEXT(7)
+
+			case 0x36:	// LD (HL),n
+				d8 = pc[1];
+				pc += 2;
+				WRITE_BYTE(zHL, d8)
+				NEXT(10)
+
+			// Accumulator rotations
+
+			case 0x07:	// RLCA
+				zA = (UINT8) ((zA << 1) | (zA >> 7));
+				zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | (zA & FLAG_C);
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x0F:	// RRCA
+				zA = (UINT8) ((zA >> 1) | (zA << 7));
+				zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | (zA >> 7);
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x17:	// RLA
+				d8 = zA >> 7;
+				zA = (UINT8) ((zA << 1) | (zF & FLAG_C));
+				zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | d8;
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x1F:	// RRA
+				d8 = zA & 1;
+				zA = (UINT8) ((zA >> 1) | ((zF & FLAG_C) << 7));
+				zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | d8;
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x08:	// EX AF,AF'
+				w16 = z->AF.w.AF;
+				z->AF.w.AF = z->AF2.w.AF2;
+				z->AF2.w.AF2 = w16;
+				d8 = zFXY;
+				zFXY = z->AF2.b.FXY2;
+				z->AF2.b.FXY2 = d8;
+				pc++;
+				NEXT(4)
+
+			// ADD HL,rr
+
+			case 0x09: ADD_RR(zHL, zBC) pc++; NEXT(11)
+			case 0x19: ADD_RR(zHL, zDE) pc++; NEXT(11)
+			case 0x29: ADD_RR(zHL, zHL) pc++; NEXT(11)
+			case 0x39: ADD_RR(zHL, zSP) pc++; NEXT(11)
+
+			case 0x10:	// DJNZ
+				d8 = zB - 1;
+				zB = d8;
+				if (d8)
+				{
+					pc += (INT8) pc[1] + 2;
+					NEXT(13)
+				}
+				pc += 2;
+				NEXT(10)
+
+			case 0x18:	// JR
+				pc += (INT8) pc[1] + 2;
+				NEXT(12)
+
+			case 0x20:	// JR NZ
+			case 0x28:	// JR Z
+			case 0x30:	// JR NC
+			case 0x38:	// JR C
+				if (COND(op - 0x20))
+				{
+					pc += (INT8) pc[1] + 2;
+					NEXT(12)
+				}
+				pc += 2;
+				NEXT(7)
+
+			case 0x22:	// LD (nn),HL
+				adr = GET_WORD(1);
+				pc += 3;
+				WRITE_WORD(adr, zHL)
+				NEXT(16)
+
+			case 0x2A:	// LD HL,(nn)
+				adr = GET_WORD(1);
+				pc += 3;
+				READ_WORD(adr, zHL)
+				NEXT(16)
+
+			case 0x32:	// LD (nn),A
+				adr = GET_WORD(1);
+				pc += 3;
+				WRITE_BYTE(adr, zA)
+				NEXT(13)
+
+			case 0x3A:	// LD A,(nn)
+				adr = GET_WORD(1);
+				pc += 3;
+				READ_BYTE(adr, zA)
+				NEXT(13)
+
+			case 0x27:	// DAA
+				z->AF.w.AF = DAA_Table[zA | ((zF & (FLAG_C | FLAG_N)) << 8) | ((zF & FLAG_H) << 6)];
+				zFXY = zF;
+				pc++;
+				NEXT(4)
+
+			case 0x2F:	// CPL
+				zA = ~zA;
+				zF |= FLAG_H | FLAG_N;
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x37:	// SCF
+				zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | FLAG_C;
+				zFXY = zA;
+				pc++;
+				NEXT(4)
+
+			case 0x3F:	// CCF
+				zF = ((zF & (FLAG_S | FLAG_Z | FLAG_P | FLAG_C)) ^ FLAG_C) | ((zF & FLAG_C) << 4);
+				pc++;
+				NEXT(4)
+
+			// LD r,r'
+
+			case 0x40: pc++; NEXT(4)
+			case 0x41: zB = zC; pc++; NEXT(4)
+			case 0x42: zB = zD; pc++; NEXT(4)
+			case 0x43: zB = zE; pc++; NEXT(4)
+			case 0x44: zB = zH; pc++; NEXT(4)
+			case 0x45: zB = zL; pc++; NEXT(4)
+			case 0x47: zB = zA; pc++; NEXT(4)
+			case 0x48: zC = zB; pc++; NEXT(4)
+			case 0x49: pc++; NEXT(4)
+			case 0x4A: zC = zD; pc++; NEXT(4)
+			case 0x4B: zC = zE; pc++; NEXT(4)
+			case 0x4C: zC = zH; pc++; NEXT(4)
+			case 0x4D: zC = zL; pc++; NEXT(4)
+			case 0x4F: zC = zA; pc++; NEXT(4)
+			case 0x50: zD = zB; pc++; NEXT(4)
+			case 0x51: zD = zC; pc++; NEXT(4)
+			case 0x52: pc++; NEXT(4)
+			case 0x53: zD = zE; pc++; NEXT(4)
+			case 0x54: zD = zH; pc++; NEXT(4)
+			case 0x55: zD = zL; pc++; NEXT(4)
+			case 0x57: zD = zA; pc++; NEXT(4)
+			case 0x58: zE = zB; pc++; NEXT(4)
+			case 0x59: zE = zC; pc++; NEXT(4)
+			case 0x5A: zE = zD; pc++; NEXT(4)
+			case 0x5B: pc++; NEXT(4)
+			case 0x5C: zE = zH; pc++; NEXT(4)
+			case 0x5D: zE = zL; pc++; NEXT(4)
+			case 0x5F: zE = zA; pc++; NEXT(4)
+			case 0x60: zH = zB; pc++; NEXT(4)
+			case 0x61: zH = zC; pc++; NEXT(4)
+			case 0x62: zH = zD; pc++; NEXT(4)
+			case 0x63: zH = zE; pc++; NEXT(4)
+			case 0x64: pc++; NEXT(4)
+			case 0x65: zH = zL; pc++; NEXT(4)
+			case 0x67: zH = zA; pc++; NEXT(4)
+			case 0x68: zL = zB; pc++; NEXT(4)
+			case 0x69: zL = zC; pc++; NEXT(4)
+			case 0x6A: zL = zD; pc++; NEXT(4)
+			case 0x6B: zL = zE; pc++; NEXT(4)
+			case 0x6C: zL = zH; pc++; NEXT(4)
+			case 0x6D: pc++; NEXT(4)
+			case 0x6F: zL = zA; pc++; NEXT(4)
+			case 0x78: zA = zB; pc++; NEXT(4)
+			case 0x79: zA = zC; pc++; NEXT(4)
+			case 0x7A: zA = zD; pc++; NEXT(4)
+			case 0x7B: zA = zE; pc++; NEXT(4)
+			case 0x7C: zA = zH; pc++; NEXT(4)
+			case 0x7D: zA = zL; pc++; NEXT(4)
+			case 0x7F: pc++; NEXT(4)
+
+			// LD r,(HL)
+
+			case 0x46: pc++; READ_BYTE(zHL, zB) NEXT(7)
+			case 0x4E: pc++; READ_BYTE(zHL, zC) NEXT(7)
+			case 0x56: pc++; READ_BYTE(zHL, zD) NEXT(7)
+			case 0x5E: pc++; READ_BYTE(zHL, zE) NEXT(7)
+			case 0x66: pc++; READ_BYTE(zHL, zH) NEXT(7)
+			case 0x6E: pc++; READ_BYTE(zHL, zL) NEXT(7)
+			case 0x7E: pc++; READ_BYTE(zHL, zA) NEXT(7)
+
+			// LD (HL),r
+
+			case 0x70: pc++; WRITE_BYTE(zHL, zB) NEXT(7)
+			case 0x71: pc++; WRITE_BYTE(zHL, zC) NEXT(7)
+			case 0x72: pc++; WRITE_BYTE(zHL, zD) NEXT(7)
+			case 0x73: pc++; WRITE_BYTE(zHL, zE) NEXT(7)
+			case 0x74: pc++; WRITE_BYTE(zHL, zH) NEXT(7)
+			case 0x75: pc++; WRITE_BYTE(zHL, zL) NEXT(7)
+			case 0x77: pc++; WRITE_BYTE(zHL, zA) NEXT(7)
+
+			case 0x76:	// HALT
+				cyc = -1;
+				z->Status |= Z80_HALTED;
+				quit = (int) z->Status;
+				pc++;
+				goto Really_Quit;
+
+			// ALU A,r
+
+			case 0x80: case 0x88: case 0x90: case 0x98: case 0xA0: case 0xA8: case 0xB0: case 0xB8:
+				ARITH_A(op, zB) pc++; NEXT(4)
+			case 0x81: case 0x89: case 0x91: case 0x99: case 0xA1: case 0xA9: case 0xB1: case 0xB9:
+				ARITH_A(op, zC) pc++; NEXT(4)
+			case 0x82: case 0x8A: case 0x92: case 0x9A: case 0xA2: case 0xAA: case 0xB2: case 0xBA:
+				ARITH_A(op, zD) pc++; NEXT(4)
+			case 0x83: case 0x8B: case 0x93: case 0x9B: case 0xA3: case 0xAB: case 0xB3: case 0xBB:
+				ARITH_A(op, zE) pc++; NEXT(4)
+			case 0x84: case 0x8C: case 0x94: case 0x9C: case 0xA4: case 0xAC: case 0xB4: case 0xBC:
+				ARITH_A(op, zH) CP_OPCODE_XY(op) pc++; NEXT(4)
+			case 0x85: case 0x8D: case 0x95: case 0x9D: case 0xA5: case 0xAD: case 0xB5: case 0xBD:
+				ARITH_A(op, zL) CP_OPCODE_XY(op) pc++; NEXT(4)
+			case 0x87: case 0x8F: case 0x97: case 0x9F: case 0xA7: case 0xAF: case 0xB7: case 0xBF:
+				ARITH_A(op, zA) CP_OPCODE_XY(op) pc++; NEXT(4)
+
+			// ALU A,(HL)
+
+			case 0x86: case 0x8E: case 0x96: case 0x9E: case 0xA6: case 0xAE: case 0xB6: case 0xBE:
+				pc++;
+				READ_BYTE(zHL, d8)
+				ARITH_A(op, d8)
+				NEXT(7)
+
+			// ALU A,n
+
+			case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+				d8 = pc[1];
+				pc += 2;
+				ARITH_A(op, d8)
+				NEXT(7)
+
+			// RET cc
+
+			case 0xC0: case 0xC8: case 0xD0: case 0xD8: case 0xE0: case 0xE8: case 0xF0: case 0xF8:
+				if (COND(op))
+				{
+					POP_WORD(w16)
+					REBASE_PC(w16)
+					NEXT(17)
+				}
+				pc++;
+				NEXT(5)
+
+			case 0xC9:	// RET
+				POP_WORD(w16)
+				REBASE_PC(w16)
+				NEXT(10)
+
+			// POP rr
+
+			case 0xC1: pc++; POP_WORD(zBC) NEXT(10)
+			case 0xD1: pc++; POP_WORD(zDE) NEXT(10)
+			case 0xE1: pc++; POP_WORD(zHL) NEXT(10)
+			case 0xF1:
+				pc++;
+				POP_WORD(w16)
+				zF = zFXY = (UINT8) w16;
+				zA = (UINT8) (w16 >> 8);
+				NEXT(10)
+
+			// PUSH rr
+
+			case 0xC5: pc++; PUSH_WORD(zBC) NEXT(11)
+			case 0xD5: pc++; PUSH_WORD(zDE) NEXT(11)
+			case 0xE5: pc++; PUSH_WORD(zHL) NEXT(11)
+			case 0xF5:
+				pc++;
+				PUSH_WORD((zA << 8) | (zF & ~(FLAG_X | FLAG_Y)) | (zFXY & (FLAG_X | FLAG_Y)))
+				NEXT(11)
+
+			// JP cc,nn
+
+			case 0xC2: case 0xCA: case 0xD2: case 0xDA: case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+				if (COND(op))
+				{
+					REBASE_PC(GET_WORD(1))
+					NEXT(10)
+				}
+				pc += 3;
+				NEXT(10)
+
+			case 0xC3:	// JP nn
+				REBASE_PC(GET_WORD(1))
+				NEXT(10)
+
+			// CALL cc,nn
+
+			case 0xC4: case 0xCC: case 0xD4: case 0xDC: case 0xE4: case 0xEC: case 0xF4: case 0xFC:
+				if (!COND(op))
+				{
+					pc += 3;
+					NEXT(10)
+				}
+				// fall through
+			case 0xCD:	// CALL nn
+				PUSH_WORD(UNBASED_PC + 3)
+				REBASE_PC(GET_WORD(1))
+				NEXT(17)
+
+			// RST n
+
+			case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+				PUSH_WORD(UNBASED_PC + 1)
+				REBASE_PC(op & 0x38)
+				NEXT(11)
+
+			case 0xD3:	// OUT (n),A
+				pc += 2;
+				NEXT(11)
+
+			case 0xDB:	// IN A,(n), A isn't modified by the Gens build
+				pc += 2;
+				NEXT(11)
+
+			case 0xD9:	// EXX
+				adr = z->BC.d; z->BC.d = z->BC2.d; z->BC2.d = adr;
+				adr = z->DE.d; z->DE.d = z->DE2.d; z->DE2.d = adr;
+				adr = z->HL.d; z->HL.d = z->HL2.d; z->HL2.d = adr;
+				pc++;
+				NEXT(4)
+
+			case 0xE3:	// EX (SP),HL
+				pc++;
+				READ_WORD(z->SP.d, w16)
+				adr = zHL;
+				zHL = w16;
+				WRITE_WORD(z->SP.d, adr)
+				NEXT(19)
+
+			case 0xE9:	// JP (HL)
+				REBASE_PC(zHL)
+				NEXT(4)
+
+			case 0xEB:	// EX DE,HL
+				adr = z->HL.d;
+				z->HL.d = z->DE.d;
+				z->DE.d = adr;
+				pc++;
+				NEXT(4)
+
+			case 0xF9:	// LD SP,HL
+				zSP = zHL;
+				pc++;
+				NEXT(6)
+
+			case 0xF3:	// DI, the next instruction is always executed
+				z->IFF.d = 0;
+				pc++;
+				cyc -= 4;
+				goto Next_Op;
+
+			case 0xFB:	// EI, we will check for interrupt after the next instruction
+				z->CycleSup = cyc;
+				z->IFF.d = FLAG_P | (FLAG_P << 8);
+				pc++;
+				cyc = -4;
+				goto Next_Op;
+
+			case 0xCB:
+				goto Prefix_CB;
+
+			case 0xED:
+				goto Prefix_ED;
+
+			case 0xDD:
+				xy = &z->IX.w.IX;
+				goto Prefix_XY;
+
+			case 0xFD:
+				xy = &z->IY.w.IY;
+				goto Prefix_XY;
+		}
+
+
+Prefix_CB:
+		op = pc[1];
+		pc += 2;
+
+		if ((op & 7) == 6)
+		{
+			READ_BYTE(zHL, d8)
+
+			switch(op >> 6)
+			{
+				case 0:
+					d8 = Z80_Rotate(z, op, d8);
+					if ((op & 0x38) == 0x30) d8++;		// SLL
+					WRITE_BYTE(zHL, d8)
+					NEXT(15)
+
+				case 1:
+					// outside Z80 RAM the asm takes X/Y from what the read
+					// handler leaves in CH, that depends on the handler
+					BIT_FLAGS((op >> 3) & 7, d8, (zHL & 0x1FFF) >> 8)
+					NEXT(12)
+
+				case 2:
+					d8 &= ~(1 << ((op >> 3) & 7));
+					WRITE_BYTE(zHL, d8)
+					NEXT(15)
+
+				default:
+					d8 |= 1 << ((op >> 3) & 7);
+					WRITE_BYTE(zHL, d8)
+					NEXT(15)
+			}
+		}
+
+		r8 = (UINT8 *) z + Reg_Offset[op & 7];
+
+		switch(op >> 6)
+		{
+			case 0:
+				d8 = Z80_Rotate(z, op, *r8);
+				// SLL sets bit 0 of A, H and L only
+				if (((op & 0x38) == 0x30) && ((op & 7) >= 4)) d8++;
+				*r8 = d8;
+				NEXT(8)
+
+			case 1:
+				BIT_FLAGS((op >> 3) & 7, *r8, *r8)
+				NEXT(8)
+
+			case 2:
+				*r8 &= ~(1 << ((op >> 3) & 7));
+				NEXT(8)
+
+			default:
+				*r8 |= 1 << ((op >> 3) & 7);
+				NEXT(8)
+		}
+
+
+Prefix_ED:
+		op = pc[1];
+
+		switch(op)
+		{
+			// IN r,(C), the Gens build always reads 0
+
+			case 0x40: case 0x48: case 0x50: case 0x58:
+			case 0x60: case 0x68: case 0x70: case 0x78:
+				if (op != 0x70) *((UINT8 *) z + Reg_Offset[(op >> 3) & 7]) = 0;
+				zF = (zF & FLAG_C) | FLAG_Z | FLAG_P;
+				zFXY = 0;
+				pc += 2;
+				NEXT(12)
+
+			// OUT (C),r
+
+			case 0x41: case 0x49: case 0x51: case 0x59:
+			case 0x61: case 0x69: case 0x71: case 0x79:
+				pc += 2;
+				NEXT(12)
+
+			// SBC/ADC HL,rr
+
+			case 0x42: SBC_HL(zBC) pc += 2; NEXT(15)
+			case 0x52: SBC_HL(zDE) pc += 2; NEXT(15)
+			case 0x62: SBC_HL(zHL) pc += 2; NEXT(15)
+			case 0x72: SBC_HL(zSP) pc += 2; NEXT(15)
+			case 0x4A: ADC_HL(zBC) pc += 2; NEXT(15)
+			case 0x5A: ADC_HL(zDE) pc += 2; NEXT(15)
+			case 0x6A: ADC_HL(zHL) pc += 2; NEXT(15)
+			case 0x7A: ADC_HL(zSP) pc += 2; NEXT(15)
+
+			// LD (nn),rr / LD rr,(nn)
+
+			case 0x43: adr = GET_WORD(2); pc += 4; WRITE_WORD(adr, zBC) NEXT(20)
+			case 0x53: adr = GET_WORD(2); pc += 4; WRITE_WORD(adr, zDE) NEXT(20)
+			case 0x63: adr = GET_WORD(2); pc += 4; WRITE_WORD(adr, zHL) NEXT(20)
+			case 0x73: adr = GET_WORD(2); pc += 4; WRITE_WORD(adr, zSP) NEXT(20)
+			case 0x4B: adr = GET_WORD(2); pc += 4; READ_WORD(adr, zBC) NEXT(20)
+			case 0x5B: adr = GET_WORD(2); pc += 4; READ_WORD(adr, zDE) NEXT(20)
+			case 0x6B: adr = GET_WORD(2); pc += 4; READ_WORD(adr, zHL) NEXT(20)
+			case 0x7B: adr = GET_WORD(2); pc += 4; READ_WORD(adr, zSP) NEXT(20)
+
+			case 0x44: case 0x4C: case 0x54: case 0x5C:		// NEG
+			case 0x64: case 0x6C: case 0x74: case 0x7C:
+				adr = (0 - zA) & 0xFF;
+				zF = (UINT8) (SZ_FLAGS(adr) | ((zA ^ adr) & FLAG_H) | ((zA == 0x80) ? FLAG_P : 0) | FLAG_N | (zA ? FLAG_C : 0));
+				zA = (UINT8) adr;
+				zFXY = zA;
+				pc += 2;
+				NEXT(8)
+
+			case 0x45: case 0x4D: case 0x55: case 0x5D:		// RETN / RETI
+			case 0x65: case 0x6D: case 0x75: case 0x7D:
+				POP_WORD(w16)
+				REBASE_PC(w16)
+				NEXT(14)
+
+			case 0x46: case 0x4E: case 0x66: case 0x6E:
+				zIM = 0;
+				pc += 2;
+				NEXT(8)
+
+			case 0x56: case 0x76:
+				zIM = 1;
+				pc += 2;
+				NEXT(8)
+
+			case 0x5E: case 0x7E:
+				zIM = 2;
+				pc += 2;
+				NEXT(8)
+
+			case 0x47:	// LD I,A
+				zI = zA;
+				pc += 2;
+				NEXT(9)
+
+			case 0x4F:	// LD R,A
+				zR = zA;
+				pc += 2;
+				NEXT(9)
+
+			case 0x57:	// LD A,I
+				zA = zI;
+				zF = (zF & FLAG_C) | SZ_FLAGS(zA) | zIFF2;
+				zFXY = zA;
+				pc += 2;
+				NEXT(9)
+
+			case 0x5F:	// LD A,R
+				zA = (UINT8) ((((z->CycleCnt - cyc + z->CycleTD) >> 2) + zR) & 0x7F);
+				zF = (zF & FLAG_C) | SZ_FLAGS(zA) | zIFF2;
+				zFXY = zA;
+				pc += 2;
+				NEXT(9)
+
+			case 0x67:	// RRD
+				pc += 2;
+				READ_BYTE(zHL, d8)
+				adr = ((zA << 4) | (d8 >> 4)) & 0xFF;
+				zA = (zA & 0xF0) | (d8 & 0x0F);
+				zF = SZP_Table[zA] | (zF & FLAG_C);
+				zFXY = zA;
+				WRITE_BYTE(zHL, adr)
+				NEXT(18)
+
+			case 0x6F:	// RLD, the asm keeps the high nibble of A instead of the low one
+				pc += 2;
+				READ_BYTE(zHL, d8)
+				adr = ((d8 << 4) | (zA & 0xF0)) & 0xFF;
+				zA = (zA & 0xF0) | (d8 >> 4);
+				zF = SZP_Table[zA] | (zF & FLAG_C);
+				zFXY = zA;
+				WRITE_BYTE(zHL, adr)
+				NEXT(18)
+
+			// Block instructions
+
+			case 0xA0:	// LDI
+			case 0xA8:	// LDD
+				pc += 2;
+				READ_BYTE(zHL, d8)
+				WRITE_BYTE(zDE, d8)
+				zF &= FLAG_S | FLAG_Z | FLAG_C;
+				if (op & 8) { zHL--; zDE--; }
+				else { zHL++; zDE++; }
+				if (--zBC) zF |= FLAG_P;
+				NEXT(16)
+
+			case 0xB0:	// LDIR
+			case 0xB8:	// LDDR
+				for(;;)
+				{
+					READ_BYTE(zHL, d8)
+					WRITE_BYTE(zDE, d8)
+					if (op & 8) { zHL--; zDE--; }
+					else { zHL++; zDE++; }
+
+					if (!--zBC)
+					{
+						pc += 2;
+						zF &= FLAG_S | FLAG_Z | FLAG_C;
+						NEXT(16)
+					}
+
+					cyc -= 21;
+					if (cyc < 0)
+					{
+						zF &= FLAG_S | FLAG_Z | FLAG_C;
+						quit = zBC;
+						goto Really_Quit;
+					}
+				}
+
+			case 0xA1:	// CPI
+			case 0xA9:	// CPD
+				pc += 2;
+				READ_BYTE(zHL, d8)
+				if (op & 8) zHL--;
+				else zHL++;
+				adr = zA - d8;
+				zF = (UINT8) ((zF & FLAG_C) | SZ_FLAGS(adr) | ((zA ^ d8 ^ adr) & FLAG_H) | FLAG_N);
+				if (--zBC) zF |= FLAG_P;
+				NEXT(16)
+
+			case 0xB1:	// CPIR
+			case 0xB9:	// CPDR
+				zF &= FLAG_C;
+				for(;;)
+				{
+					READ_BYTE(zHL, d8)
+					if (op & 8) zHL--;
+					else zHL++;
+					adr = zA - d8;
+					adr = SZ_FLAGS(adr) | ((zA ^ d8 ^ adr) & FLAG_H) | FLAG_N;
+
+					if (!--zBC)
+					{
+						zF |= (UINT8) adr;
+						pc += 2;
+						NEXT(18)
+					}
+
+					if (zA == d8)
+					{
+						zF |= (UINT8) adr | FLAG_P;
+						pc += 2;
+						NEXT(18)
+					}
+
+					cyc -= 21;
+					if (cyc < 0)
+					{
+						zF |= (UINT8) adr | FLAG_P;
+						quit = d8;
+						goto Really_Quit;
+					}
+				}
+
+			case 0xA2:	// INI
+			case 0xAA:	// IND
+				pc += 2;
+				WRITE_BYTE(zHL, 0)
+				if (op & 8) zHL--;
+				else zHL++;
+				zB--;
+				zF = SZP_Table[zB];
+				NEXT(16)
+
+			case 0xB2:	// INIR
+			case 0xBA:	// INDR
+				for(;;)
+				{
+					WRITE_BYTE(zHL, 0)
+					if (op & 8) zHL--;
+					else zHL++;
+					d8 = zB - 1;
+
+					if (!d8)
+					{
+						zF = FLAG_Z | FLAG_P;
+						zFXY = 0;
+						zB = 0;
+						pc += 2;
+						NEXT(16)
+					}
+
+					zB = d8;
+					cyc -= 21;
+					if (cyc < 0)
+					{
+						zF = d8 & FLAG_S;
+						zFXY = d8;
+						quit = d8;
+						goto Really_Quit;
+					}
+				}
+
+			case 0xA3:	// OUTI
+			case 0xAB:	// OUTD
+				pc += 2;
+				READ_BYTE(zHL, d8)
+				if (op & 8) zHL--;
+				else zHL++;
+				zB--;
+				zF = SZP_Table[zB] | ((zL + d8) > 0xFF ? (FLAG_H | FLAG_C) : 0) | ((d8 >> 7) << 1);
+				NEXT(16)
+
+			case 0xB3:	// OTIR
+			case 0xBB:	// OTDR
+				for(;;)
+				{
+					READ_BYTE(zHL, w16)
+					if (op & 8) zHL--;
+					else zHL++;
+					d8 = zB - 1;
+
+					if (!d8)
+					{
+						zF = FLAG_Z | FLAG_P | ((zL + w16) > 0xFF ? (FLAG_H | FLAG_C) : 0) | ((w16 >> 7) << 1);
+						zFXY = 0;
+						zB = 0;
+						pc += 2;
+						NEXT(16)
+					}
+
+					zB = d8;
+					cyc -= 21;
+					if (cyc < 0)
+					{
+						zF = (d8 & FLAG_S) | ((zL + w16) > 0xFF ? (FLAG_H | FLAG_C) : 0) | ((w16 >> 7) << 1);
+						zFXY = d8;
+						quit = d8;
+						goto Really_Quit;
+					}
+				}
+
+			default:	// not an ED instruction, only the prefix is skipped
+				pc++;
+				NEXT(4)
+		}
+
+
+Prefix_XY:
+		op = pc[1];
+		cyc -= 4;
+		pc++;
+
+		switch(op)
+		{
+			case 0x09: ADD_RR(zXY, zBC) pc++; NEXT(11)
+			case 0x19: ADD_RR(zXY, zDE) pc++; NEXT(11)
+			case 0x29: ADD_RR(zXY, zXY) pc++; NEXT(11)
+			case 0x39: ADD_RR(zXY, zSP) pc++; NEXT(11)
+
+			// swapped in the asm tables
+			case 0x1C: DEC_R(zE) pc++; NEXT(4)
+			case 0x1D: INC_R(zE) pc++; NEXT(4)
+
+			case 0x21: zXY = (UINT16) GET_WORD(1); pc += 3; NEXT(10)
+
+			case 0x22:	// LD (nn),XY
+				adr = GET_WORD(1);
+				pc += 3;
+				WRITE_WORD(adr, zXY)
+				NEXT(16)
+
+			case 0x2A:	// LD XY,(nn)
+				adr = GET_WORD(1);
+				pc += 3;
+				READ_WORD(adr, zXY)
+				NEXT(16)
+
+			case 0x23: zXY++; pc++; NEXT(6)
+			case 0x2B: zXY--; pc++; NEXT(6)
+
+			case 0x24: INC_R(zhXY) pc++; NEXT(4)
+			case 0x25: DEC_R(zhXY) pc++; NEXT(4)
+			case 0x2C: INC_R(zlXY) pc++; NEXT(4)
+			case 0x2D: DEC_R(zlXY) pc++; NEXT(4)
+			case 0x26: zhXY = pc[1]; pc += 2; NEXT(7)
+			case 0x2E: zlXY = pc[1]; pc += 2; NEXT(7)
+
+			case 0x34:	// INC (XY+d)
+				adr = XY_ADR;
+				pc += 2;
+				READ_BYTE(adr, d8)
+				INC_R(d8)
+				WRITE_BYTE(adr, d8)
+				NEXT(22)
+
+			case 0x35:	// DEC (XY+d)
+				adr = XY_ADR;
+				pc += 2;
+				READ_BYTE(adr, d8)
+				DEC_R(d8)
+				WRITE_BYTE(adr, d8)
+				NEXT(22)
+
+			case 0x36:	// LD (XY+d),n
+				adr = XY_ADR;
+				pc += 3;
+				WRITE_BYTE(adr, pc[-1])
+				NEXT(15)
+
+			case 0x44: zB = zhXY; pc++; NEXT(4)
+			case 0x45: zB = zlXY; pc++; NEXT(4)
+			case 0x4C: zC = zhXY; pc++; NEXT(4)
+			case 0x4D: zC = zlXY; pc++; NEXT(4)
+			case 0x54: zD = zhXY; pc++; NEXT(4)
+			case 0x55: zD = zlXY; pc++; NEXT(4)
+			case 0x5C: zE = zhXY; pc++; NEXT(4)
+			case 0x5D: zE = zlXY; pc++; NEXT(4)
+			case 0x7C: zA = zhXY; pc++; NEXT(4)
+			case 0x7D: zA = zlXY; pc++; NEXT(4)
+			case 0x60: zhXY = zB; pc++; NEXT(4)
+			case 0x61: zhXY = zC; pc++; NEXT(4)
+			case 0x62: zhXY = zD; pc++; NEXT(4)
+			case 0x63: zhXY = zE; pc++; NEXT(4)
+			case 0x64: pc++; NEXT(4)
+			case 0x65: zhXY = zL; pc++; NEXT(4)		// L, not the low half of XY
+			case 0x67: zhXY = zA; pc++; NEXT(4)
+			case 0x68: zlXY = zB; pc++; NEXT(4)
+			case 0x69: zlXY = zC; pc++; NEXT(4)
+			case 0x6A: zlXY = zD; pc++; NEXT(4)
+			case 0x6B: zlXY = zE; pc++; NEXT(4)
+			case 0x6C: zlXY = zH; pc++; NEXT(4)		// H, not the high half of XY
+			case 0x6D: pc++; NEXT(4)
+			case 0x6F: zlXY = zA; pc++; NEXT(4)
+
+			// LD r,(XY+d)
+
+			case 0x46: case 0x4E: case 0x56: case 0x5E: case 0x66: case 0x6E: case 0x7E:
+				adr = XY_ADR;
+				pc += 2;
+				r8 = (UINT8 *) z + Reg_Offset[(op >> 3) & 7];
+				READ_BYTE(adr, *r8)
+				NEXT(15)
+
+			// LD (XY+d),r
+
+			case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x77:
+				adr = XY_ADR;
+				pc += 2;
+				r8 = (UINT8 *) z + Reg_Offset[op & 7];
+				WRITE_BYTE(adr, *r8)
+				NEXT(15)
+
+			// ALU A,hXY / lXY / (XY+d)
+
+			case 0x84: case 0x8C: case 0x94: case 0x9C: case 0xA4: case 0xAC: case 0xB4: case 0xBC:
+				ARITH_A(op, zhXY) pc++; NEXT(4)
+			case 0x85: case 0x8D: case 0x95: case 0x9D: case 0xA5: case 0xAD: case 0xB5: case 0xBD:
+				ARITH_A(op, zlXY) pc++; NEXT(4)
+			case 0x86: case 0x8E: case 0x96: case 0x9E: case 0xA6: case 0xAE: case 0xB6: case 0xBE:
+				adr = XY_ADR;
+				pc += 2;
+				READ_BYTE(adr, d8)
+				ARITH_A(op, d8)
+				NEXT(15)
+
+			case 0xE1: pc++; POP_WORD(zXY) NEXT(10)
+			case 0xE5: pc++; PUSH_WORD(zXY) NEXT(11)
+
+			case 0xE3:	// EX (SP),XY
+				pc++;
+				READ_WORD(z->SP.d, w16)
+				adr = zXY;
+				zXY = w16;
+				WRITE_WORD(z->SP.d, adr)
+				NEXT(19)
+
+			case 0xE9:	// JP (XY)
+				REBASE_PC(zXY)
+				NEXT(4)
+
+			case 0xF9:	// LD SP,XY
+				zSP = zXY;
+				pc++;
+				NEXT(6)
+
+			case 0xFC:	// CALL P,nn in the asm tables, not CALL M,nn
+				if (zF & FLAG_S)
+				{
+					pc += 3;
+					NEXT(10)
+				}
+				PUSH_WORD(UNBASED_PC + 3)
+				REBASE_PC(GET_WORD(1))
+				NEXT(17)
+
+			case 0xCB:
+				goto Prefix_XYCB;
+
+			default:
+				goto Dispatch;
+		}
+
+
+Prefix_XYCB:
+		op = pc[2];
+
+		if ((op & 0xC0) == 0x40)
+		{
+			if ((op & 7) != 6)
+			{
+				// the register forms run BIT n,r and leave PC on the opcode byte
+				BIT_FLAGS((op >> 3) & 7, *((UINT8 *) z + Reg_Offset[op & 7]), *((UINT8 *) z + Reg_Offset[op & 7]))
+				pc += 2;
+				NEXT(8)
+			}
+
+			adr = XY_ADR;
+			READ_BYTE(adr, d8)
+			BIT_FLAGS((op >> 3) & 7, d8, (adr & 0x1FFF) >> 8)
+			pc += 3;
+			NEXT(16)
+		}
+
+		adr = XY_ADR;
+		pc += 3;
+		READ_BYTE(adr, d8)
+
+		if (op & 0x80)
+		{
+			if (op & 0x40) d8 |= 1 << ((op >> 3) & 7);
+			else d8 &= ~(1 << ((op >> 3) & 7));
+			if ((op & 7) != 6) *((UINT8 *) z + Reg_Offset[op & 7]) = d8;
+			WRITE_BYTE(adr, d8)
+			NEXT(19)
+		}
+
+		d8 = Z80_Rotate(z, op, d8);
+		if ((op & 0x38) == 0x30) d8++;		// SLL
+		if ((op & 7) != 6) *((UINT8 *) z + Reg_Offset[op & 7]) = d8;
+		WRITE_BYTE(adr, d8)
+		NEXT(23)
+	}
+
+
+Exec_Quit:
+	quit = (int) z->CycleSup;
+	cyc += quit;
+	z->CycleSup = 0;
+
+	if (cyc >= 0)
+	{
+		// an interrupt or EI ended the timeslice early
+		CHECK_INT
+		goto Next_Op;
+	}
+
+Really_Quit:
+	z->PC.d = UNBASED_PC;
+	z->CycleCnt += z->CycleTD - cyc;
+	z->Status &= 0xFF & ~Z80_RUNNING;
+	if (quit & Z80_HALTED) z->CycleCnt += cyc;
+
+	return 0;
+}
+
+#endif
@@ -33,6 +33,16 @@ void RAMeka_RAMByteWriteFn(unsigned int Offset, unsigned int nVal) {
 void RAMeka_RAMByteWriteFnColeco(unsigned int Offset, unsigned int nVal) {
     Write_Mapper_Coleco(0x6000 + Offset, nVal);  // special case for ColecoVision crazy mirroring
 }
+//Size of the RAM bank installed by RAMeka_RA_MountROM
+static unsigned int RAMeka_RAMBankSize = 0;
+unsigned int RAMeka_RAMBlockReadFn(unsigned int Offset, unsigned char* Buffer, unsigned int Count) {
+    if (Offset >= RAMeka_RAMBankSize)
+        return 0;
+    if (Count > RAMeka_RAMBankSize - Offset)
+        Count = RAMeka_RAMBankSize - Offset;
+    memcpy(Buffer, RAM + Offset, Count);
+    return Count;
+}
 
 
 //Needed as RA and Meka both use GetCurrentDirectory and SetCurrentDirectory seperately
@@ -276,18 +286,27 @@ void RAMeka_RA_MountROM( ConsoleID consoleID ) {
     switch ( consoleID )
     {
         case MasterSystem:
-            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, 0x2000 ); //8KB
+            RAMeka_RAMBankSize = 0x2000; //8KB
+            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, RAMeka_RAMBankSize );
             break;
         case GameGear:
-            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, 0x2000 ); //8KB
+            RAMeka_RAMBankSize = 0x2000; //8KB
+            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, RAMeka_RAMBankSize );
             break;
         case Colecovision:
-            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFnColeco, 0x400 ); //1KB
+            RAMeka_RAMBankSize = 0x400; //1KB
+            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFnColeco, RAMeka_RAMBankSize );
             break;
         case SG1000:
-            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, 0x400 ); //1KB
+            RAMeka_RAMBankSize = 0x400; //1KB
+            RA_InstallMemoryBank( 0, RAMeka_RAMByteReadFn, RAMeka_RAMByteWriteFn, RAMeka_RAMBankSize );
+            break;
+        default:
+            RAMeka_RAMBankSize = 0;
             break;
     }
+    if ( RAMeka_RAMBankSize )
+        RA_InstallMemoryBankBlockReader( 0, RAMeka_RAMBlockReadFn );
     
     RA_OnLoadNewRom( ROM, tsms.Size_ROM );
 
@@ -47,6 +47,7 @@ extern void RA_InitShared();
 //See: RA_MemManager.h _RAMByteReadFn _RAMByteWriteFn
 unsigned char	RAMeka_RAMByteReadFn (unsigned int Offset);
 void			RAMeka_RAMByteWriteFn(unsigned int Offset, unsigned int nVal);
+unsigned int	RAMeka_RAMBlockReadFn(unsigned int Offset, unsigned char* Buffer, unsigned int Count);
 
 void RAMeka_Stash_Meka_CurrentDirectory();
 void RAMeka_Restore_Meka_CurrentDirectory();
@@ -6,6 +6,7 @@
 #include "fceu.h"
 #include "movie.h"
 #include "cheat.h"
+#include "fceulua.h"
 
 #include "drivers/win/debugger.h"
 #include "drivers/win/memwatch.h"
@@ -84,6 +85,9 @@ void GetEstimatedGameTitle( char* sNameOut )
 void ResetEmulation()
 {
 	FCEUI_StopMovie();
+#ifdef _S9XLUA_H
+	FCEU_LuaStop();
+#endif
     CloseMemoryWatch();
     CloseRamWindows();
     if (hDebug)
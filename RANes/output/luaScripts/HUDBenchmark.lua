@@ -0,0 +1,135 @@
+--HUD Benchmark
+--Measures how much a typical overlay script adds to each frame, once per way of
+--reading memory and registering callbacks. Every mode replays the same frames
+--from a savestate taken when the script starts. Results are printed to the
+--Lua console and drawn on screen when the run is over.
+
+--You can change the number of frames timed per mode here.
+local frames = 600
+--A HUD that shows this many 16-byte object slots out of RAM.
+local objects = 16
+local objectBase = 0x0400
+--Number of separate HUD pieces for the callback modes.
+local pieces = 8
+
+local slots = objects * 16
+local buffer = {}
+local sum = 0
+
+--Stands in for formatting and drawing what was read.
+local function draw(i, x, y, hp)
+	if i % 4 == 0 then
+		gui.text(8, 8 + i * 2, string.format("%02X %02X %02X", x, y, hp))
+	end
+end
+
+local hud = {}
+
+hud.readbyte = function()
+	for i = 0, objects - 1 do
+		local a = objectBase + i * 16
+		local x, y, hp = memory.readbyte(a), memory.readbyte(a + 1), memory.readbyte(a + 2)
+		for j = 3, 15 do
+			sum = sum + memory.readbyte(a + j)
+		end
+		draw(i, x, y, hp)
+	end
+end
+
+hud.readbyterange = function()
+	local s = memory.readbyterange(objectBase, slots)
+	for i = 0, objects - 1 do
+		local o = i * 16
+		local x, y, hp = s:byte(o + 1, o + 3)
+		for j = 4, 16 do
+			sum = sum + s:byte(o + j)
+		end
+		draw(i, x, y, hp)
+	end
+end
+
+hud.readbytes = function()
+	local t = memory.readbytes(objectBase, slots, buffer)
+	for i = 0, objects - 1 do
+		local o = i * 16
+		for j = 4, 16 do
+			sum = sum + t[o + j]
+		end
+		draw(i, t[o + 1], t[o + 2], t[o + 3])
+	end
+end
+
+--One piece of a HUD that was split into several independent modules.
+local function piece(n)
+	return function()
+		local t = memory.readbytes(objectBase + n * 16, 16, buffer)
+		draw(n * 4, t[1], t[2], t[3])
+	end
+end
+local pieceFuncs = {}
+for n = 0, pieces - 1 do
+	pieceFuncs[n + 1] = piece(n)
+end
+
+--Each mode installs itself and returns the function that removes it again.
+local modes = {
+	{"none", function() return function() end end},
+	{"readbyte", function() gui.register(hud.readbyte); return function() gui.register(nil) end end},
+	{"readbyterange", function() gui.register(hud.readbyterange); return function() gui.register(nil) end end},
+	{"readbytes", function() gui.register(hud.readbytes); return function() gui.register(nil) end end},
+	{"chained", function()
+		--the old way to share one callback: a wrapper that calls every piece
+		emu.registerafter(function()
+			for i = 1, #pieceFuncs do
+				pieceFuncs[i]()
+			end
+		end)
+		return function() emu.registerafter(nil) end
+	end},
+	{"addcallback", function()
+		for i = 1, #pieceFuncs do
+			emu.addcallback("after", pieceFuncs[i])
+		end
+		return function()
+			for i = 1, #pieceFuncs do
+				emu.removecallback("after", pieceFuncs[i])
+			end
+		end
+	end},
+}
+
+local start = savestate.create()
+savestate.save(start)
+emu.speedmode("maximum")
+
+local results = {}
+for m = 1, #modes do
+	local name, install = modes[m][1], modes[m][2]
+	savestate.load(start)
+	local uninstall = install()
+	collectgarbage()
+	local t0 = os.clock()
+	for f = 1, frames do
+		emu.frameadvance()
+	end
+	results[m] = (os.clock() - t0) * 1000000 / frames
+	uninstall()
+end
+
+emu.speedmode("normal")
+savestate.load(start)
+
+local lines = {string.format("%-14s %10s %10s", "mode", "us/frame", "overhead")}
+for m = 1, #modes do
+	lines[#lines + 1] = string.format("%-14s %10.1f %10.1f", modes[m][1], results[m], results[m] - results[1])
+end
+for i = 1, #lines do
+	print(lines[i])
+end
+
+while true do
+	for i = 1, #lines do
+		gui.text(8, 8 + (i - 1) * 10, lines[i])
+	end
+	emu.frameadvance()
+end
@@ -47,7 +47,9 @@ static void M170Power(void) {
 	SetWriteHandler(0x6502, 0x6502, M170ProtW);
 	SetWriteHandler(0x7000, 0x7000, M170ProtW);
 	SetReadHandler(0x7001, 0x7001, M170ProtR);
+	SetPeekHandler(0x7001, 0x7001, M170ProtR);
 	SetReadHandler(0x7777, 0x7777, M170ProtR);
+	SetPeekHandler(0x7777, 0x7777, M170ProtR);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 }
 
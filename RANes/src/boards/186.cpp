@@ -68,6 +68,7 @@ static void M186Power(void) {
 	SetReadHandler(0x4200, 0x43FF, M186Read);
 	SetWriteHandler(0x4200, 0x43FF, M186Write);
 	SetReadHandler(0x4400, 0x4FFF, ASWRAM);
+	SetPeekHandler(0x4400, 0x4FFF, ASWRAM);
 	SetWriteHandler(0x4400, 0x4FFF, BSWRAM);
 	regs[0] = regs[1] = regs[2] = regs[3];
 	Sync();
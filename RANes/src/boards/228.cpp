@@ -68,6 +68,7 @@ static void M228Reset(void) {
 static void M228Power(void) {
 	M228Reset();
 	SetReadHandler(0x5000,0x5FFF,M228RamRead);
+	SetPeekHandler(0x5000,0x5FFF,M228RamRead);
 	SetWriteHandler(0x5000,0x5FFF,M228RamWrite);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x8000, 0xFFFF, M228Write);
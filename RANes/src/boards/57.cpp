@@ -63,6 +63,7 @@ static void M57Power(void) {
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x8000, 0xFFFF, M57Write);
 	SetReadHandler(0x6000, 0x6000, M57Read);
+	SetPeekHandler(0x6000, 0x6000, M57Read);
 	Sync();
 }
 
@@ -35,6 +35,7 @@ static void UNL6035052Power(void) {
 	GenMMC3Power();
 	SetWriteHandler(0x4020, 0x7FFF, UNL6035052ProtWrite);
 	SetReadHandler(0x4020, 0x7FFF, UNL6035052ProtRead);
+	SetPeekHandler(0x4020, 0x7FFF, UNL6035052ProtRead);
 }
 
 void UNL6035052_Init(CartInfo *info) {
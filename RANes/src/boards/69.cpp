@@ -226,6 +226,7 @@ static void M69Power(void) {
 	IRQa = 0;
 	Sync();
 	SetReadHandler(0x6000, 0x7FFF, M69WRAMRead);
+	SetPeekHandler(0x6000, 0x7FFF, M69WRAMRead);
 	SetWriteHandler(0x6000, 0x7FFF, M69WRAMWrite);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x8000, 0x9FFF, M69Write0);
@@ -137,6 +137,7 @@ static void M80Power(void) {
 	wram_enable = 0xFF;
 	Sync();
 	SetReadHandler(0x7F00, 0x7FFF, M80RamRead);
+	SetPeekHandler(0x7F00, 0x7FFF, M80RamRead);
 	SetWriteHandler(0x7F00, 0x7FFF, M80RamWrite);
 	SetWriteHandler(0x7EF0, 0x7EFF, M80Write);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
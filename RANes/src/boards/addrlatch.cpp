@@ -44,8 +44,10 @@ static void LatchPower(void) {
 	if (WRAM) {
 		SetReadHandler(0x6000, 0xFFFF, CartBR);
 		SetWriteHandler(0x6000, 0x7FFF, CartBW);
-	} else
+	} else {
 		SetReadHandler(0x6000, 0xFFFF, defread);
+		SetPeekHandler(0x6000, 0xFFFF, defread);
+	}
 	SetWriteHandler(addrreg0, addrreg1, LatchWrite);
 }
 
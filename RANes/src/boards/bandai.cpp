@@ -216,6 +216,7 @@ static void BandaiPower(void) {
 	x24c0x_init();
 	Sync();
 	SetReadHandler(0x6000, 0x7FFF, BandaiRead);
+	SetPeekHandler(0x6000, 0x7FFF, BandaiRead);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x6000, 0xFFFF, BandaiWrite);
 }
@@ -449,6 +450,7 @@ static void M157Power(void) {
 
 	SetWriteHandler(0x6000, 0xFFFF, BandaiWrite);
 	SetReadHandler(0x6000, 0x7FFF, BarcodeRead);
+	SetPeekHandler(0x6000, 0x7FFF, BarcodeRead);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 }
 
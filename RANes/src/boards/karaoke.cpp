@@ -48,6 +48,7 @@ static void Power(void) {
 	setchr8(0);
 	setprg16(0xc000, 0x7);
 	SetReadHandler(0x6000, 0x7FFF, ExtDev);
+	SetPeekHandler(0x6000, 0x7FFF, ExtDev);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x8000, 0xFFFF, M188Write);
 }
@@ -109,11 +109,13 @@ static void UNLKS7030Power(void) {
 	reg0 = reg1 = ~0;
 	Sync();
 	SetReadHandler(0x6000, 0x7FFF, UNLKS7030RamRead0);
+	SetPeekHandler(0x6000, 0x7FFF, UNLKS7030RamRead0);
 	SetWriteHandler(0x6000, 0x7FFF, UNLKS7030RamWrite0);
 	SetReadHandler(0x8000, 0xFFFF, CartBR);
 	SetWriteHandler(0x8000, 0x8FFF, UNLKS7030Write0);
 	SetWriteHandler(0x9000, 0x9FFF, UNLKS7030Write1);
 	SetReadHandler(0xB800, 0xD7FF, UNLKS7030RamRead1);
+	SetPeekHandler(0xB800, 0xD7FF, UNLKS7030RamRead1);
 	SetWriteHandler(0xB800, 0xD7FF, UNLKS7030RamWrite1);
 }
 
@@ -255,6 +255,7 @@ static void GenMMC1Power(void) {
 
 	if (mmc1opts & 1) {
 		SetReadHandler(0x6000, 0x7FFF, MAWRAM);
+		SetPeekHandler(0x6000, 0x7FFF, MAWRAM);
 		SetWriteHandler(0x6000, 0x7FFF, MBWRAM);
 		setprg8r(0x10, 0x6000, 0);
 	}
@@ -252,6 +252,7 @@ void GenMMC3Power(void) {
 		if (WRAMSIZE == 1024) {
 			FCEU_CheatAddRAM(1, 0x7000, WRAM);
 			SetReadHandler(0x7000, 0x7FFF, MAWRAMMMC6);
+			SetPeekHandler(0x7000, 0x7FFF, MAWRAMMMC6);
 			SetWriteHandler(0x7000, 0x7FFF, MBWRAMMMC6);
 		} else {
 			FCEU_CheatAddRAM((WRAMSIZE & 0x1fff) >> 10, 0x6000, WRAM);
@@ -1261,6 +1262,7 @@ static void M254_Power(void) {
 	GenMMC3Power();
 	SetWriteHandler(0x8000, 0xBFFF, M254Write);
 	SetReadHandler(0x6000, 0x7FFF, MR254WRAM);
+	SetPeekHandler(0x6000, 0x7FFF, MR254WRAM);
 }
 
 void Mapper254_Init(CartInfo *info) {
@@ -751,9 +751,11 @@ static void GenMMC5Reset(void) {
 
 	SetWriteHandler(0x5c00, 0x5fff, MMC5_ExRAMWr);
 	SetReadHandler(0x5c00, 0x5fff, MMC5_ExRAMRd);
+	SetPeekHandler(0x5c00, 0x5fff, MMC5_ExRAMRd);
 
 	SetWriteHandler(0x6000, 0xFFFF, MMC5_WriteROMRAM);
 	SetReadHandler(0x6000, 0xFFFF, MMC5_ReadROMRAM);
+	SetPeekHandler(0x6000, 0xFFFF, MMC5_ReadROMRAM);
 
 	SetWriteHandler(0x5000, 0x5015, Mapper5_SW);
 	SetWriteHandler(0x5205, 0x5206, Mapper5_write);
@@ -27,6 +27,7 @@
 #include "cart.h"
 #include "driver.h"
 #include "utils/memory.h"
+#include "writewatch.h"
 
 #include <string>
 #include <cstdlib>
@@ -438,7 +439,11 @@ void FCEU_ApplyPeriodicCheats(void)
 	{
 		if(cur->status && !(cur->type))
 			if(CheatRPtrs[cur->addr>>10])
+			{
+				if(FCEU_WriteWatched(cur->addr))
+					FCEU_WriteWatchRecord(cur->addr,CheatRPtrs[cur->addr>>10][cur->addr],cur->val);
 				CheatRPtrs[cur->addr>>10][cur->addr]=cur->val;
+			}
 		if(cur->next)
 			cur=cur->next;
 		else
@@ -941,10 +946,18 @@ int FCEU_CheatGetByte(uint32 A)
 
 void FCEU_CheatSetByte(uint32 A, uint8 V)
 {
+   uint8 old=0;
+   bool watched=(A < 0x10000) && FCEU_WriteWatched(A);
+   if(watched)
+    old=FCEU_PeekMem(A);
+
    if(CheatRPtrs[A>>10])
     CheatRPtrs[A>>10][A]=V;
    else if(A < 0x10000)
     BWrite[A](A, V);
+
+   if(watched)
+    FCEU_WriteWatchRecord(A,old,FCEU_PeekMem(A));
 }
 
 void UpdateFrozenList(void)
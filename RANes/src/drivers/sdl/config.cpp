@@ -258,6 +258,15 @@ InitConfig()
     
 	// fm2 -> srt conversion
 	config->addOption("ripsubs", "SDL.RipSubs", "");
+
+	// savestate load benchmark
+	config->addOption("statebench", "SDL.StateBench", 0);
+
+	// write watch benchmark
+	config->addOption("writewatchbench", "SDL.WriteWatchBench", 0);
+
+	// peek bus scan
+	config->addOption("peekscan", "SDL.PeekScan", 0);
 	
 	// enable new PPU core
 	config->addOption("newppu", "SDL.NewPPU", 0);
@@ -0,0 +1,166 @@
+/// \file
+/// \brief Timing loops behind the --peekscan, --statebench and --writewatchbench command line benchmarks.
+///
+/// They only drive the core through its public interface, so the core itself
+/// carries no benchmark code.
+
+#include "sdl-bench.h"
+#include "../../fceu.h"
+#include "../../driver.h"
+#include "../../emufile.h"
+#include "../../state.h"
+#include "../../writewatch.h"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <ctime>
+
+bool BenchPeekScan(int frames, double *bytesPerSec, int *changedFrames)
+{
+	if(!GameInfo || frames < 1)
+		return false;
+
+	static uint8 scan[0x10000];
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	clock_t elapsed = 0;
+
+	*changedFrames = 0;
+	for(int frame = 0; frame < frames; frame++)
+	{
+		FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+
+		EMUFILE_MEMORY before, after;
+		FCEUSS_SaveMS(&before, 0);
+		clock_t t = clock();
+		for(uint32 A = 0; A < 0x10000; A++)
+			scan[A] = FCEU_PeekMem(A);
+		elapsed += clock() - t;
+		FCEUSS_SaveMS(&after, 0);
+
+		if(before.size() != after.size() || memcmp(before.buf(), after.buf(), before.size()))
+			(*changedFrames)++;
+	}
+
+	*bytesPerSec = elapsed ? (double)frames * 0x10000 * CLOCKS_PER_SEC / elapsed : 0.0;
+	return *changedFrames == 0;
+}
+
+bool BenchStateLoad(int iterations, double *indexedUsec, double *linearUsec)
+{
+	EMUFILE_MEMORY original, resaved;
+	if(!FCEUSS_SaveMS(&original, Z_NO_COMPRESSION))
+		return false;
+	if(iterations < 1)
+		iterations = 1;
+
+	bool ok = true;
+	for(int pass = 0; pass < 2; pass++)
+	{
+		FCEUSS_SetIndexEnabled(pass == 0);
+		clock_t start = clock();
+		for(int i = 0; i < iterations; i++)
+		{
+			original.fseek(0, SEEK_SET);
+			if(!FCEUSS_LoadFP(&original, SSLOADPARAM_NOBACKUP))
+				ok = false;
+		}
+		double usec = (double)(clock() - start) * 1000000.0 / CLOCKS_PER_SEC / iterations;
+		*(pass == 0 ? indexedUsec : linearUsec) = usec;
+
+		resaved.set_len(0);
+		FCEUSS_SaveMS(&resaved, Z_NO_COMPRESSION);
+		if(resaved.size() != original.size() || memcmp(resaved.buf(), original.buf(), original.size()))
+			ok = false;
+	}
+	FCEUSS_SetIndexEnabled(true);
+	return ok;
+}
+
+//Checks one published frame against snapshots of internal RAM taken before and
+//after it. Other areas are not checked: register peeks return open bus and
+//cartridge peeks move with bank switches, neither of which is a write.
+static bool CheckWrites(uint32 start, uint32 count, const uint8 *before, const uint8 *after)
+{
+	uint32 n;
+	bool invalidated;
+	const WATCHEDWRITE *w = FCEU_WriteWatchGetWrites(&n, &invalidated);
+	if(invalidated)
+		return true;
+
+	static uint8 listed[0x800];
+	memset(listed, 0, sizeof(listed));
+	for(uint32 i = 0; i < n; i++)
+	{
+		if(w[i].addr >= 0x800)
+			continue;
+		if(w[i].oldval != before[w[i].addr] || w[i].newval != after[w[i].addr])
+			return false;
+		listed[w[i].addr] = 1;
+	}
+	for(uint32 x = start; x < start + count && x < 0x2000; x++)
+	{
+		uint32 A = x & 0x7FF;
+		if(before[A] != after[A] && !listed[A])
+			return false;
+	}
+	return true;
+}
+
+bool BenchWriteWatch(uint32 start, uint32 count, int frames, double *watchedUsec, double *unwatchedUsec, double *writesPerFrame)
+{
+	if(!GameInfo || !count || frames < 1)
+		return false;
+
+	EMUFILE_MEMORY original;
+	if(!FCEUSS_SaveMS(&original, 0))
+		return false;
+
+	uint8 *gfx;
+	int32 *sound;
+	int32 ssize;
+	bool ok = true;
+	uint64 writes = 0;
+
+	//the watched pass goes first and checks its lists, the unwatched pass only times
+	for(int pass = 0; pass < 2; pass++)
+	{
+		original.fseek(0, SEEK_SET);
+		FCEUSS_LoadFP(&original, SSLOADPARAM_NOBACKUP);
+		if(pass == 0)
+			FCEU_WriteWatchAdd(start, start + count - 1);
+
+		clock_t elapsed = 0;
+		for(int frame = 0; frame < frames; frame++)
+		{
+			uint8 before[0x800], after[0x800];
+			if(pass == 0)
+				memcpy(before, RAM, sizeof(before));
+
+			clock_t t = clock();
+			FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+			elapsed += clock() - t;
+
+			if(pass == 0)
+			{
+				memcpy(after, RAM, sizeof(after));
+				uint32 n;
+				FCEU_WriteWatchGetWrites(&n, NULL);
+				writes += n;
+				if(!CheckWrites(start, count, before, after))
+					ok = false;
+			}
+		}
+
+		if(pass == 0)
+			FCEU_WriteWatchRemove(start, start + count - 1);
+		*(pass == 0 ? watchedUsec : unwatchedUsec) = (double)elapsed * 1000000.0 / CLOCKS_PER_SEC / frames;
+	}
+	*writesPerFrame = (double)writes / frames;
+
+	original.fseek(0, SEEK_SET);
+	FCEUSS_LoadFP(&original, SSLOADPARAM_NOBACKUP);
+	return ok;
+}
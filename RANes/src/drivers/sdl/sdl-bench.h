@@ -0,0 +1,19 @@
+#ifndef __FCEU_SDL_BENCH_H
+#define __FCEU_SDL_BENCH_H
+
+#include "../../types.h"
+
+//Runs frames frames, peeking all of $0000-$FFFF after each one, and counts the
+//frames whose savestate differed before and after the scan.
+bool BenchPeekScan(int frames, double *bytesPerSec, int *changedFrames);
+
+//Loads the current state back in repeatedly with and without the SFORMAT hash
+//index; reports microseconds per load and whether the state survived intact.
+bool BenchStateLoad(int iterations, double *indexedUsec, double *linearUsec);
+
+//Times FCEUI_Emulate with count addresses from start watched against the same
+//frames unwatched, starting both runs from the current state, and checks every
+//published list against a before/after snapshot of those addresses.
+bool BenchWriteWatch(uint32 start, uint32 count, int frames, double *watchedUsec, double *unwatchedUsec, double *writesPerFrame);
+
+#endif
@@ -5,6 +5,7 @@
 #include "../common/cheat.h"
 #include "../../fceu.h"
 #include "../../movie.h"
+#include "../../state.h"
 #include "../../version.h"
 #ifdef _S9XLUA_H
 #include "../../fceulua.h"
@@ -14,6 +15,7 @@
 #include "dface.h"
 
 #include "sdl.h"
+#include "sdl-bench.h"
 #include "sdl-video.h"
 #include "unix-netplay.h"
 
@@ -113,6 +115,9 @@ static const char *DriverUsage=
 "--pauseframe   x       Pause movie playback at frame x.\n"
 "--fcmconvert   f       Convert fcm movie file f to fm2.\n"
 "--ripsubs      f       Convert movie's subtitles to srt\n"
+"--statebench   x       Time x savestate loads on every iNES mapper and exit.\n"
+"--writewatchbench x    Time x frames with 1k addresses write-watched and exit.\n"
+"--peekscan     x       Peek all 64k after each of x frames on every mapper and exit.\n"
 "--subtitles    {0|1}   Enable subtitle display\n"
 "--fourscore    {0|1}   Enable fourscore emulation\n"
 "--no-config    {0|1}   Use default config file and do not save\n"
@@ -521,6 +526,186 @@ void FCEUD_TraceInstruction() {
 	int noGui = 1;
 #endif
 
+/**
+ * Fills rom with a blank 128k PRG + 128k CHR iNES image whose every 8k bank
+ * points its vectors at $8000, ready to have the mapper number patched in.
+ */
+static void BuildBenchmarkROM(std::vector<uint8> &rom)
+{
+	rom.assign(16 + 0x20000 + 0x20000, 0xEA);
+	for(int bank = 0; bank < 0x20000; bank += 0x2000)
+	{
+		uint8 *vectors = &rom[16 + bank + 0x2000 - 6];
+		for(int i = 0; i < 6; i += 2)
+		{
+			vectors[i] = 0x00;
+			vectors[i + 1] = 0x80;
+		}
+	}
+	memset(&rom[0], 0, 16);
+	memcpy(&rom[0], "NES\x1a", 4);
+	rom[4] = 8;
+	rom[5] = 16;
+}
+
+/**
+ * Boots a blank cartridge on every iNES mapper the core knows about, runs
+ * it for a second and times loading the resulting savestate back in, with
+ * and without the SFORMAT hash index.
+ */
+static int StateBenchmark(int iterations)
+{
+	const char *tmpdir = getenv("TMPDIR");
+	std::string fname = std::string(tmpdir ? tmpdir : "/tmp") + "/fceux-statebench.nes";
+
+	std::vector<uint8> rom;
+	BuildBenchmarkROM(rom);
+
+	int failures = 0;
+	printf("mapper  indexed(us)  linear(us)  speedup\n");
+	for(int mapper = 0; mapper < 256; mapper++)
+	{
+		rom[6] = (mapper & 0x0F) << 4;
+		rom[7] = mapper & 0xF0;
+		FILE *fp = fopen(fname.c_str(), "wb");
+		if(!fp)
+		{
+			FCEUD_PrintError("Couldn't write the benchmark ROM.");
+			return -1;
+		}
+		fwrite(&rom[0], 1, rom.size(), fp);
+		fclose(fp);
+
+		if(!FCEUI_LoadGame(fname.c_str(), 1, true))
+			continue;
+
+		uint8 *gfx;
+		int32 *sound;
+		int32 ssize;
+		for(int frame = 0; frame < 60; frame++)
+			FCEUI_Emulate(&gfx, &sound, &ssize, 0);
+
+		double indexed, linear;
+		bool ok = BenchStateLoad(iterations, &indexed, &linear);
+		printf("%6d  %11.2f  %10.2f  %6.2fx%s\n", mapper, indexed, linear,
+			indexed > 0 ? linear / indexed : 0.0, ok ? "" : "  MISMATCH");
+		if(!ok)
+			failures++;
+
+		FCEUI_CloseGame();
+	}
+	unlink(fname.c_str());
+	return failures ? -1 : 0;
+}
+
+/**
+ * Boots a blank cartridge on every iNES mapper the core knows about and
+ * peeks all 64k of the CPU bus after each of the given frames, the way
+ * RetroAchievements reads memory, checking the scans change no state.
+ */
+static int PeekScanBenchmark(int frames)
+{
+	const char *tmpdir = getenv("TMPDIR");
+	std::string fname = std::string(tmpdir ? tmpdir : "/tmp") + "/fceux-peekscan.nes";
+
+	std::vector<uint8> rom;
+	BuildBenchmarkROM(rom);
+
+	int failures = 0;
+	int mappers = 0;
+	double total = 0;
+	printf("mapper  bytes/s  changed frames\n");
+	for(int mapper = 0; mapper < 256; mapper++)
+	{
+		rom[6] = (mapper & 0x0F) << 4;
+		rom[7] = mapper & 0xF0;
+		FILE *fp = fopen(fname.c_str(), "wb");
+		if(!fp)
+		{
+			FCEUD_PrintError("Couldn't write the benchmark ROM.");
+			return -1;
+		}
+		fwrite(&rom[0], 1, rom.size(), fp);
+		fclose(fp);
+
+		if(!FCEUI_LoadGame(fname.c_str(), 1, true))
+			continue;
+
+		double bytesPerSec;
+		int changed;
+		bool ok = BenchPeekScan(frames, &bytesPerSec, &changed);
+		printf("%6d  %7.3g  %14d%s\n", mapper, bytesPerSec, changed, ok ? "" : "  CHANGED");
+		if(!ok)
+			failures++;
+		total += bytesPerSec;
+		mappers++;
+
+		FCEUI_CloseGame();
+	}
+	unlink(fname.c_str());
+	printf("%d mappers, %.3g bytes/s on average, %d changed state\n", mappers,
+		mappers ? total / mappers : 0.0, failures);
+	return failures ? -1 : 0;
+}
+
+/**
+ * Boots an NROM cartridge that spends the whole frame storing to zero page,
+ * $0300 and $0400, then times FCEUI_Emulate with $0000-$03FF write-watched
+ * against the same frames with nothing watched.
+ */
+static int WriteWatchBenchmark(int frames)
+{
+	const char *tmpdir = getenv("TMPDIR");
+	std::string fname = std::string(tmpdir ? tmpdir : "/tmp") + "/fceux-writewatchbench.nes";
+
+	static const uint8 program[] = {
+		0xA2, 0x00,		// $8000 LDX #$00
+		0xFE, 0x00, 0x03,	// $8002 INC $0300,X
+		0x9D, 0x00, 0x04,	// $8005 STA $0400,X
+		0x95, 0x00,		// $8008 STA $00,X
+		0xE8,			// $800A INX
+		0xD0, 0xF5,		// $800B BNE $8002
+		0x69, 0x01,		// $800D ADC #$01
+		0x4C, 0x02, 0x80,	// $800F JMP $8002
+	};
+	std::vector<uint8> rom(16 + 0x8000 + 0x2000, 0x00);
+	memcpy(&rom[0], "NES\x1a", 4);
+	rom[4] = 2;
+	rom[5] = 1;
+	memcpy(&rom[16], program, sizeof(program));
+	for(int i = 0; i < 6; i += 2)
+	{
+		rom[16 + 0x7FFA + i] = 0x00;
+		rom[16 + 0x7FFA + i + 1] = 0x80;
+	}
+
+	FILE *fp = fopen(fname.c_str(), "wb");
+	if(!fp)
+	{
+		FCEUD_PrintError("Couldn't write the benchmark ROM.");
+		return -1;
+	}
+	fwrite(&rom[0], 1, rom.size(), fp);
+	fclose(fp);
+
+	if(!FCEUI_LoadGame(fname.c_str(), 1, true))
+	{
+		unlink(fname.c_str());
+		return -1;
+	}
+
+	double watched, unwatched, writes;
+	bool ok = BenchWriteWatch(0x0000, 0x400, frames, &watched, &unwatched, &writes);
+	printf("watched(us)  unwatched(us)  overhead  writes/frame\n");
+	printf("%11.2f  %13.2f  %7.2f%%  %12.1f%s\n", watched, unwatched,
+		unwatched > 0 ? (watched - unwatched) * 100.0 / unwatched : 0.0, writes,
+		ok ? "" : "  MISMATCH");
+
+	FCEUI_CloseGame();
+	unlink(fname.c_str());
+	return ok ? 0 : -1;
+}
+
 
 /**
  * The main loop for the SDL.
@@ -725,6 +910,48 @@ int main(int argc, char *argv[])
 		FCEUI_SetAviDisableMovieMessages(false);
 	
 	
+	// time savestate loading across all the mappers, then quit
+	{
+		int iterations;
+		g_config->getOption("SDL.StateBench", &iterations);
+		g_config->setOption("SDL.StateBench", 0);
+		if(iterations > 0)
+		{
+			int ret = StateBenchmark(iterations);
+			DriverKill();
+			SDL_Quit();
+			return ret;
+		}
+	}
+
+	// time frames with write watches against frames without, then quit
+	{
+		int frames;
+		g_config->getOption("SDL.WriteWatchBench", &frames);
+		g_config->setOption("SDL.WriteWatchBench", 0);
+		if(frames > 0)
+		{
+			int ret = WriteWatchBenchmark(frames);
+			DriverKill();
+			SDL_Quit();
+			return ret;
+		}
+	}
+
+	// scan the whole bus through the peek handlers on every mapper, then quit
+	{
+		int frames;
+		g_config->getOption("SDL.PeekScan", &frames);
+		g_config->setOption("SDL.PeekScan", 0);
+		if(frames > 0)
+		{
+			int ret = PeekScanBenchmark(frames);
+			DriverKill();
+			SDL_Quit();
+			return ret;
+		}
+	}
+
 	// check for a .fm2 file to rip the subtitles
 	g_config->getOption("SDL.RipSubs", &s);
 	g_config->setOption("SDL.RipSubs", "");
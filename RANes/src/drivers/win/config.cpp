@@ -365,6 +365,7 @@ static CFGSTRUCT fceuconfig[] =
 	AC(taseditorConfig.followUndoContext),
 	AC(taseditorConfig.followMarkerNoteContext),
 	AC(taseditorConfig.greenzoneCapacity),
+	AC(taseditorConfig.greenzoneMemoryLimit),
 	AC(taseditorConfig.maxUndoLevels),
 	AC(taseditorConfig.enableGreenzoning),
 	AC(taseditorConfig.autofirePatternSkipsLag),
@@ -22,6 +22,7 @@
 #include "../../fceu.h"
 #include "memwatch.h"
 #include "../../debug.h"
+#include "../../writewatch.h"
 #include "debugger.h"
 #include "cheat.h"
 #include "../../utils/xstring.h"
@@ -265,11 +266,45 @@ static struct MWRec
 				addr=FastStrToU16(TempArray+x,valid);
 				break;
 			}
+		updateWatch();
+	}
+
+	//Rows showing internal RAM are registered with the write watch, so that
+	//UpdateMemWatch can skip them on frames that did not write their bytes
+	void updateWatch()
+	{
+		unwatch();
+		if(valid && addr + twobytes < 0x2000)
+		{
+			watching = true;
+			watchLo = addr & 0x7FF;
+			watchHi = (addr + twobytes) & 0x7FF;
+			FCEU_WriteWatchAdd(addr, addr + twobytes);
+		}
+	}
+	void unwatch()
+	{
+		if(watching)
+			FCEU_WriteWatchRemove(watchLo, watchLo + (watchHi != watchLo));
+		watching = false;
+	}
+	bool written(const WATCHEDWRITE* writes, uint32 count)
+	{
+		for(uint32 x = 0; x < count; x++)
+			if(writes[x].addr == watchLo || writes[x].addr == watchHi)
+				return true;
+		return false;
 	}
 	bool valid, twobytes, hex;
 	uint16 addr;
+	bool watching;
+	uint16 watchLo, watchHi;	//mirror folded, as the write watch reports them
 } mwrecs[MWNUM];
 
+static bool memwRedrawAll = true;		//next UpdateMemWatch redraws every row
+static uint32 memwLastFrame;			//FCEU_WriteWatchFrames at the last refresh
+static unsigned int memwLastFrozen;
+
 //Update the values in the Memory Watch window
 void UpdateMemWatch()
 {
@@ -279,10 +314,28 @@ void UpdateMemWatch()
 		SetTextColor(hdc,GetSysColor(COLOR_WINDOWTEXT));	//adelikat-changed colors to Windows System Colors.  Hardcoded colors run the risk of incompatibiliy (for instance if someone uses custom colors and makes dialogs black, addresses would be unreadable)
 		SetBkColor(hdc,GetSysColor(COLOR_3DFACE));
 
+		//Watched rows only need a redraw when the last frame wrote them. Any
+		//other change (a missed or repeated frame, a savestate, a freeze)
+		//redraws everything.
+		uint32 writeCount;
+		bool invalidated;
+		const WATCHEDWRITE* writes = FCEU_WriteWatchGetWrites(&writeCount, &invalidated);
+		uint32 frames = FCEU_WriteWatchFrames();
+		bool redrawAll = memwRedrawAll || invalidated || frames != memwLastFrame + 1 || FrozenAddressCount != memwLastFrozen;
+		memwRedrawAll = false;
+		memwLastFrame = frames;
+		memwLastFrozen = FrozenAddressCount;
+
 		for(int i = 0; i < MWNUM; i++)
 		{
 			MWRec& mwrec = mwrecs[i];
 
+			if (!redrawAll && mwrec.watching && !mwrec.written(writes, writeCount))
+			{
+				SetTextColor(hdc,RGB(0,0,0));
+				continue;
+			}
+
 			//Display blue if address is frozen
 			if (FrozenAddressCount && FrozenAddresses.size())
 			{
@@ -779,6 +832,7 @@ static BOOL CALLBACK MemWatchCallB(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARA
 		PAINTSTRUCT ps;
 		BeginPaint(hwndDlg, &ps);
 		EndPaint(hwndDlg, &ps);
+		memwRedrawAll = true;
 		UpdateMemWatch();
 		break;
 	case WM_INITMENU:
@@ -791,6 +845,11 @@ static BOOL CALLBACK MemWatchCallB(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARA
 		CloseMemoryWatch();
 		break;
 
+	case WM_DESTROY:
+		for(int i = 0; i < MWNUM; i++)
+			mwrecs[i].unwatch();
+		break;
+
 	case WM_DROPFILES:
 	{
 		unsigned int len;
@@ -904,6 +963,7 @@ static BOOL CALLBACK MemWatchCallB(HWND hwndDlg, UINT uMsg, WPARAM wParam, LPARA
 				int changed = MWRec::findIndex(LOWORD(wParam));
 				if(changed==-1) break;
 				mwrecs[changed].parse(LOWORD(wParam));
+				memwRedrawAll = true;
 				break;
 			}
 		
@@ -982,6 +1042,7 @@ void CreateMemWatch()
 
 	hwndMemWatch=CreateDialog(fceu_hInstance,"MEMWATCH",Parent,MemWatchCallB);
 	memwmenu=GetMenu(hwndMemWatch);
+	memwRedrawAll = true;
 	UpdateMemWatch();
 	memwrecentmenu = CreateMenu();
 
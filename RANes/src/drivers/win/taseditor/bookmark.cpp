@@ -71,7 +71,8 @@ void BOOKMARK::set()
 	if (taseditorConfig.enableHotChanges)
 		snapshot.inputlog.copyHotChanges(&history.getCurrentSnapshot().inputlog);
 	// copy savestate
-	savestate = greenzone.getSavestateOfFrame(currFrameCounter);
+	if (!greenzone.getSavestateOfFrame(currFrameCounter, savestate))
+		savestate.resize(0);
 	// save screenshot
 	uLongf comprlen = (SCREENSHOT_SIZE>>9)+12 + SCREENSHOT_SIZE;
 	savedScreenshot.resize(comprlen);
@@ -10,12 +10,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 Greenzone - Access zone
 [Single instance]
 
-* stores array of savestates, used for faster movie navigation by Playback cursor
+* stores array of savestates, used for faster movie navigation by Playback cursor (in Greenzone_Storage, as keyframes and page deltas)
 * also stores LagLog of current movie Input
 * saves and loads the data from a project file. On error: truncates Greenzone to last successfully read savestate
 * regularly checks if there's a savestate of current emulation state, if there's no such savestate in array then creates one and updates lag info for previous frame
 * implements the working of "Auto-adjust Input according to lag" feature
-* regularly runs gradual cleaning of the savestates array (for memory saving), deleting oldest savestates
+* regularly runs gradual cleaning of the savestates array (for memory saving), deleting oldest savestates, then keeps the array within the memory limit
 * on demand: (when movie Input was changed) truncates the size of Greenzone, deleting savestates that became irrelevant because of new Input. After truncating it may also move Playback cursor (which must always reside within Greenzone) and may launch Playback seeking
 * stores resources: save id, properties of gradual cleaning, timing of cleaning
 ------------------------------------------------------------------------------------ */
@@ -49,7 +49,7 @@ void GREENZONE::init()
 }
 void GREENZONE::free()
 {
-	savestates.resize(0);
+	savestates.reset();
 	greenzoneSize = 0;
 	lagLog.reset();
 }
@@ -110,14 +110,15 @@ void GREENZONE::update()
 
 void GREENZONE::collectCurrentState()
 {
-	if ((int)savestates.size() <= currFrameCounter)
-		savestates.resize(currFrameCounter + 1);
 	// if frame is not saved - log savestate
-	if (!savestates[currFrameCounter].size())
+	if (savestates.isSavestateEmpty(currFrameCounter))
 	{
-		EMUFILE_MEMORY ms(&savestates[currFrameCounter]);
-		FCEUSS_SaveMS(&ms, Z_DEFAULT_COMPRESSION);
+		// uncompressed, so that the storage can share unchanged pages with neighbour frames
+		savestateBuffer.resize(0);
+		EMUFILE_MEMORY ms(&savestateBuffer);
+		FCEUSS_SaveMS(&ms, Z_NO_COMPRESSION);
 		ms.trim();
+		savestates.setSavestate(currFrameCounter, savestateBuffer);
 	}
 	if (greenzoneSize <= currFrameCounter)
 		greenzoneSize = currFrameCounter + 1;
@@ -125,9 +126,9 @@ void GREENZONE::collectCurrentState()
 
 bool GREENZONE::loadSavestateOfFrame(unsigned int frame)
 {
-	if (frame >= savestates.size() || !savestates[frame].size())
+	if (!savestates.getSavestate(frame, savestateBuffer))
 		return false;
-	EMUFILE_MEMORY ms(&savestates[frame]);
+	EMUFILE_MEMORY ms(&savestateBuffer);
 	return FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP);
 }
 
@@ -143,7 +144,7 @@ void GREENZONE::runGreenzoneCleaning()
 	for (; i > limit; i--)
 	{
 		if (i & 0x1)
-			changed = changed | clearSavestateAndFreeMemory(i);
+			changed = changed | clearSavestateOfFrame(i);
 	}
 	if (i < 0) goto finish;
 	// 4x of 1/4
@@ -152,7 +153,7 @@ void GREENZONE::runGreenzoneCleaning()
 	for (; i > limit; i--)
 	{
 		if (i & 0x3)
-			changed = changed | clearSavestateAndFreeMemory(i);
+			changed = changed | clearSavestateOfFrame(i);
 	}
 	if (i < 0) goto finish;
 	// 8x of 1/8
@@ -161,7 +162,7 @@ void GREENZONE::runGreenzoneCleaning()
 	for (; i > limit; i--)
 	{
 		if (i & 0x7)
-			changed = changed | clearSavestateAndFreeMemory(i);
+			changed = changed | clearSavestateOfFrame(i);
 	}
 	if (i < 0) goto finish;
 	// 16x of 1/16
@@ -170,14 +171,15 @@ void GREENZONE::runGreenzoneCleaning()
 	for (; i > limit; i--)
 	{
 		if (i & 0xF)
-			changed = changed | clearSavestateAndFreeMemory(i);
+			changed = changed | clearSavestateOfFrame(i);
 	}
 	// clear all remaining
 	for (; i > 0; i--)
 	{
-		changed = changed | clearSavestateAndFreeMemory(i);
+		changed = changed | clearSavestateOfFrame(i);
 	}
 finish:
+	changed = changed | runMemoryLimitCleaning();
 	if (changed)
 	{
 		pianoRoll.redraw();
@@ -187,28 +189,28 @@ finish:
 	nextCleaningTime = clock() + TIME_BETWEEN_CLEANINGS;
 }
 
-// returns true if actually cleared savestate data
-bool GREENZONE::clearSavestateOfFrame(unsigned int frame)
+// if savestates still take more memory than allowed, delete oldest savestates before Playback cursor: first leaving every 16th, then all of them
+bool GREENZONE::runMemoryLimitCleaning()
 {
-	if (frame < savestates.size() && savestates[frame].size())
-	{
-	    savestates[frame].resize(0);
-		return true;
-	} else
-	{
-		return false;
-	}
+	int limit = taseditorConfig.greenzoneMemoryLimit;
+	if (limit < GREENZONE_MEMORY_LIMIT_MIN)
+		limit = GREENZONE_MEMORY_LIMIT_MIN;
+	else if (limit > GREENZONE_MEMORY_LIMIT_MAX)
+		limit = GREENZONE_MEMORY_LIMIT_MAX;
+	unsigned int max_bytes = (unsigned int)limit * 1024 * 1024;
+	bool changed = false;
+	for (int i = 1; i < currFrameCounter && savestates.getMemoryUsage() > max_bytes; ++i)
+		if (i & 0xF)
+			changed = changed | clearSavestateOfFrame(i);
+	for (int i = 1; i < currFrameCounter && savestates.getMemoryUsage() > max_bytes; ++i)
+		changed = changed | clearSavestateOfFrame(i);
+	return changed;
 }
-bool GREENZONE::clearSavestateAndFreeMemory(unsigned int frame)
+
+// returns true if actually cleared savestate data
+bool GREENZONE::clearSavestateOfFrame(unsigned int frame)
 {
-	if (frame < savestates.size() && savestates[frame].size())
-	{
-	    savestates[frame].swap(std::vector<uint8>());
-		return true;
-	} else
-	{
-		return false;
-	}
+	return savestates.clearSavestate(frame);
 }
 
 void GREENZONE::ungreenzoneSelectedFrames()
@@ -216,13 +218,12 @@ void GREENZONE::ungreenzoneSelectedFrames()
 	RowsSelection* current_selection = selection.getCopyOfCurrentRowsSelection();
 	if (current_selection->size() == 0) return;
 	bool changed = false;
-	int size = savestates.size();
 	int start_index = *current_selection->begin();
 	int end_index = *current_selection->rbegin();
 	RowsSelection::reverse_iterator current_selection_rend = current_selection->rend();
 	// degreenzone frames, going backwards
 	for (RowsSelection::reverse_iterator it(current_selection->rbegin()); it != current_selection_rend; it++)
-		changed = changed | clearSavestateAndFreeMemory(*it);
+		changed = changed | clearSavestateOfFrame(*it);
 	if (changed)
 	{
 		pianoRoll.redraw();
@@ -236,8 +237,8 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 	{
 		collectCurrentState();		// in case the project is being saved before the greenzone.update() was called within current frame
 		runGreenzoneCleaning();
-		if (greenzoneSize > (int)savestates.size())
-			greenzoneSize = savestates.size();
+		if (greenzoneSize > savestates.getSize())
+			greenzoneSize = savestates.getSize();
 		// write "GREENZONE" string
 		os->fwrite(greenzone_save_id, GREENZONE_ID_LEN);
 		// write LagLog
@@ -263,12 +264,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 					playback.setProgressbar(frame, greenzoneSize);
 					last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 				}
-				if (!savestates[frame].size()) continue;
+				if (!savestates.getSavestate(frame, savestateBuffer, true)) continue;
 				write32le(frame, os);
 				// write savestate
-				size = savestates[frame].size();
+				size = savestateBuffer.size();
 				write32le(size, os);
-				os->fwrite(&savestates[frame][0], size);
+				os->fwrite(&savestateBuffer[0], size);
 			}
 			// write -1 as eof for greenzone
 			write32le(-1, os);
@@ -287,12 +288,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 						playback.setProgressbar(frame, greenzoneSize);
 						last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 					}
-					if (!savestates[frame].size()) continue;
+					if (!savestates.getSavestate(frame, savestateBuffer, true)) continue;
 					write32le(frame, os);
 					// write savestate
-					size = savestates[frame].size();
+					size = savestateBuffer.size();
 					write32le(size, os);
-					os->fwrite(&savestates[frame][0], size);
+					os->fwrite(&savestateBuffer[0], size);
 				}
 			}
 			// write -1 as eof for greenzone
@@ -312,12 +313,12 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 						playback.setProgressbar(frame, greenzoneSize);
 						last_tick = frame / PROGRESSBAR_UPDATE_RATE;
 					}
-					if (!savestates[frame].size()) continue;
+					if (!savestates.getSavestate(frame, savestateBuffer, true)) continue;
 					write32le(frame, os);
 					// write savestate
-					size = savestates[frame].size();
+					size = savestateBuffer.size();
 					write32le(size, os);
-					os->fwrite(&savestates[frame][0], size);
+					os->fwrite(&savestateBuffer[0], size);
 				}
 			}
 			// write -1 as eof for greenzone
@@ -336,9 +337,10 @@ void GREENZONE::save(EMUFILE *os, int save_type)
 			{
 				// write ONE savestate for currFrameCounter
 				collectCurrentState();
-				int size = savestates[currFrameCounter].size();
+				savestates.getSavestate(currFrameCounter, savestateBuffer, true);
+				int size = savestateBuffer.size();
 				write32le(size, os);
-				os->fwrite(&savestates[currFrameCounter][0], size);
+				os->fwrite(&savestateBuffer[0], size);
 			}
 			break;
 		}
@@ -372,15 +374,15 @@ bool GREENZONE::load(EMUFILE *is, unsigned int offset)
 		{
 			currFrameCounter = frame;
 			greenzoneSize = currFrameCounter + 1;
-			savestates.resize(greenzoneSize);
 			if (currFrameCounter)
 			{
 				// there must be one savestate in the file
-				if (read32le(&size, is) && size >= 0)
+				if (read32le(&size, is) && size > 0)
 				{
-					savestates[frame].resize(size);
-					if (is->fread(&savestates[frame][0], size) == size)
+					savestateBuffer.resize(size);
+					if (is->fread(&savestateBuffer[0], size) == size)
 					{
+						savestates.setSavestate(frame, savestateBuffer);
 						if (loadSavestateOfFrame(currFrameCounter))
 						{
 							FCEU_printf("No Greenzone in the file\n");
@@ -406,7 +408,6 @@ bool GREENZONE::load(EMUFILE *is, unsigned int offset)
 	if (read32le(&size, is) && size >= 0 && size <= currMovieData.getNumRecords())
 	{
 		greenzoneSize = size;
-		savestates.resize(greenzoneSize);
 		// read Playback cursor position
 		if (read32le(&frame, is))
 		{
@@ -441,10 +442,9 @@ bool GREENZONE::load(EMUFILE *is, unsigned int offset)
 				} else
 				{
 					// load this savestate
-					if ((int)savestates.size() <= frame)
-						savestates.resize(frame + 1);
-					savestates[frame].resize(size);
-					if ((int)is->fread(&savestates[frame][0], size) < size) break;
+					savestateBuffer.resize(size);
+					if ((int)is->fread(&savestateBuffer[0], size) < size) break;
+					savestates.setSavestate(frame, savestateBuffer);
 					prev_frame = frame;			// successfully read one Greenzone frame info
 				}
 			}
@@ -576,7 +576,7 @@ void GREENZONE::invalidate(int after)
 		if (after >= currMovieData.getNumRecords())
 			after = currMovieData.getNumRecords() - 1;
 		// clear all savestates that became irrelevant
-		for (int i = savestates.size() - 1; i > after; i--)
+		for (int i = savestates.getSize() - 1; i > after; i--)
 			clearSavestateOfFrame(i);
 		if (greenzoneSize > after + 1)
 		{
@@ -596,7 +596,7 @@ void GREENZONE::invalidateAndUpdatePlayback(int after)
 		if (after >= currMovieData.getNumRecords())
 			after = currMovieData.getNumRecords() - 1;
 		// clear all savestates that became irrelevant
-		for (int i = savestates.size() - 1; i > after; i--)
+		for (int i = savestates.getSize() - 1; i > after; i--)
 			clearSavestateOfFrame(i);
 		if (greenzoneSize > after + 1 || currFrameCounter > after)
 		{
@@ -629,7 +629,7 @@ void GREENZONE::invalidateAndUpdatePlayback(int after)
 int GREENZONE::findFirstGreenzonedFrame(int starting_index)
 {
 	for (int i = starting_index; i < greenzoneSize; ++i)
-		if (savestates[i].size()) return i;
+		if (!savestates.isSavestateEmpty(i)) return i;
 	return -1;	// error
 }
 
@@ -640,23 +640,21 @@ int GREENZONE::getSize()
 }
 
 // this should only be used by Bookmark Set procedure
-std::vector<uint8>& GREENZONE::getSavestateOfFrame(int frame)
+bool GREENZONE::getSavestateOfFrame(int frame, std::vector<uint8>& savestate)
 {
-	return savestates[frame];
+	return savestates.getSavestate(frame, savestate, true);
 }
 // this function should only be used by Bookmark Deploy procedure
 void GREENZONE::writeSavestateForFrame(int frame, std::vector<uint8>& savestate)
 {
-	if ((int)savestates.size() <= frame)
-		savestates.resize(frame + 1);
-	savestates[frame] = savestate;
+	savestates.setSavestate(frame, savestate);
 	if (greenzoneSize <= frame)
 		greenzoneSize = frame + 1;
 }
 
 bool GREENZONE::isSavestateEmpty(unsigned int frame)
 {
-	if ((int)frame < greenzoneSize && frame < savestates.size() && savestates[frame].size())
+	if ((int)frame < greenzoneSize && !savestates.isSavestateEmpty(frame))
 		return false;
 	else
 		return true;
@@ -1,6 +1,7 @@
 // Specification file for Greenzone class
 
 #include "laglog.h"
+#include "greenzone_storage.h"
 
 #define GREENZONE_ID_LEN 10
 
@@ -37,7 +38,7 @@ public:
 	int findFirstGreenzonedFrame(int startingFrame = 0);
 
 	int getSize();
-	std::vector<uint8>& getSavestateOfFrame(int frame);
+	bool getSavestateOfFrame(int frame, std::vector<uint8>& savestate);
 	void writeSavestateForFrame(int frame, std::vector<uint8>& savestate);
 	bool isSavestateEmpty(unsigned int frame);
 
@@ -47,16 +48,17 @@ public:
 private:
 	void collectCurrentState();
 	bool clearSavestateOfFrame(unsigned int frame);
-	bool clearSavestateAndFreeMemory(unsigned int frame);
+	bool runMemoryLimitCleaning();
 
 	void adjustUp();
 	void adjustDown();
 
 	// saved data
 	int greenzoneSize;
-	std::vector<std::vector<uint8>> savestates;
+	GREENZONE_STORAGE savestates;
 
 	// not saved data
 	int nextCleaningTime;
+	std::vector<uint8> savestateBuffer;
 	
 };
@@ -0,0 +1,418 @@
+/* ---------------------------------------------------------------------------------
+Implementation file of Greenzone_Storage class
+
+(The MIT License)
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+------------------------------------------------------------------------------------
+Greenzone_Storage - Savestates of the Greenzone
+[Single instance]
+
+* stores uncompressed savestates split into 256-byte pages, every distinct page is kept only once (RLE-packed) and shared by all savestates containing it
+* every GREENZONE_KEYFRAME_INTERVAL frames share a keyframe (full list of pages), each savestate only stores the pages that differ from its keyframe
+* a savestate that differs from the keyframe in more than half of its pages starts a new keyframe for the following frames
+* restoring a savestate costs unpacking its keyframe and its delta, regardless of where the frame is
+* accepts compressed and uncompressed savestates, gives back either of them
+* keeps track of used memory, so that Greenzone can be kept within the memory limit
+------------------------------------------------------------------------------------ */
+
+#include "taseditor_project.h"
+#include "zlib.h"
+
+#define SAVESTATE_HEADER_SIZE 16
+
+// PackBits: 0..127 = copy next n+1 bytes, 129..255 = repeat next byte 257-n times
+// returns the packed size, or GREENZONE_PAGE_SIZE if the page had to be stored as is
+static int packPage(const uint8* src, uint8* dst)
+{
+	int in = 0, out = 0;
+	while (in < GREENZONE_PAGE_SIZE)
+	{
+		int run = 1;
+		while (in + run < GREENZONE_PAGE_SIZE && run < 128 && src[in + run] == src[in])
+			run++;
+		if (run >= 3)
+		{
+			if (out + 2 >= GREENZONE_PAGE_SIZE) goto raw;
+			dst[out++] = (uint8)(257 - run);
+			dst[out++] = src[in];
+			in += run;
+		} else
+		{
+			int start = in, len = 0;
+			while (in < GREENZONE_PAGE_SIZE && len < 128)
+			{
+				if (in + 2 < GREENZONE_PAGE_SIZE && src[in] == src[in + 1] && src[in] == src[in + 2])
+					break;
+				in++;
+				len++;
+			}
+			if (out + 1 + len >= GREENZONE_PAGE_SIZE) goto raw;
+			dst[out++] = (uint8)(len - 1);
+			memcpy(dst + out, src + start, len);
+			out += len;
+		}
+	}
+	return out;
+raw:
+	memcpy(dst, src, GREENZONE_PAGE_SIZE);
+	return GREENZONE_PAGE_SIZE;
+}
+
+static uint32 hashPage(const uint8* data, int size)
+{
+	uint32 hash = 2166136261u;
+	for (int i = 0; i < size; ++i)
+		hash = (hash ^ data[i]) * 16777619u;
+	return hash;
+}
+
+GREENZONE_STORAGE::GREENZONE_STORAGE()
+{
+	reset();
+}
+
+void GREENZONE_STORAGE::reset()
+{
+	pages.clear();
+	buckets.clear();
+	freePages = -1;
+	livePages = 0;
+	packedBytes = 0;
+	keyframes.clear();
+	freeKeyframes.clear();
+	keyframeEntries = 0;
+	frames.clear();
+	deltaEntries = 0;
+	slotKeyframe.clear();
+	slotFrames.clear();
+	keyframeCache.clear();
+	cachedKeyframe = -1;
+}
+
+// stores the savestate of the frame, replacing the old one
+void GREENZONE_STORAGE::setSavestate(int frame, std::vector<uint8>& savestate)
+{
+	clearSavestate(frame);
+	if (frame < 0 || !unpackSavestate(savestate, plainBuffer))
+		return;
+
+	if ((int)frames.size() <= frame)
+	{
+		FRAME emptyFrame;
+		emptyFrame.keyframe = -1;
+		emptyFrame.length = 0;
+		frames.resize(frame + 1, emptyFrame);
+	}
+	int slot = frame / GREENZONE_KEYFRAME_INTERVAL;
+	if ((int)slotKeyframe.size() <= slot)
+	{
+		slotKeyframe.resize(slot + 1, -1);
+		slotFrames.resize(slot + 1, 0);
+	}
+
+	uint32 length = plainBuffer.size();
+	int numPages = (length + GREENZONE_PAGE_SIZE - 1) / GREENZONE_PAGE_SIZE;
+	plainBuffer.resize(numPages * GREENZONE_PAGE_SIZE, 0);		// pad the last page with zeros
+	const uint8* data = &plainBuffer[0];
+
+	FRAME& currentFrame = frames[frame];
+	int keyframe = slotKeyframe[slot];
+	if (keyframe >= 0 && (int)keyframes[keyframe].pages.size() == numPages)
+	{
+		// collect the pages that differ from the keyframe
+		const uint8* base = getKeyframeData(keyframe);
+		DELTA delta;
+		for (int i = 0; i < numPages; ++i)
+		{
+			if (memcmp(base + i * GREENZONE_PAGE_SIZE, data + i * GREENZONE_PAGE_SIZE, GREENZONE_PAGE_SIZE))
+			{
+				delta.index = i;
+				delta.page = -1;
+				currentFrame.delta.push_back(delta);
+			}
+		}
+		if ((int)currentFrame.delta.size() * 2 > numPages)
+		{
+			// too different, a new keyframe will be cheaper
+			currentFrame.delta.clear();
+			keyframe = -1;
+		} else
+		{
+			for (int i = currentFrame.delta.size() - 1; i >= 0; i--)
+				currentFrame.delta[i].page = internPage(data + currentFrame.delta[i].index * GREENZONE_PAGE_SIZE);
+			deltaEntries += currentFrame.delta.size();
+			keyframes[keyframe].refs++;
+		}
+	} else
+	{
+		keyframe = -1;
+	}
+	if (keyframe < 0)
+	{
+		keyframe = createKeyframe(data, numPages);
+		// following frames of the slot will be compared with this keyframe
+		if (slotKeyframe[slot] >= 0)
+			releaseKeyframe(slotKeyframe[slot]);
+		slotKeyframe[slot] = keyframe;
+		keyframes[keyframe].refs++;
+	}
+	currentFrame.keyframe = keyframe;
+	currentFrame.length = length;
+	slotFrames[slot]++;
+}
+
+// returns false if there's no savestate for the frame
+bool GREENZONE_STORAGE::getSavestate(int frame, std::vector<uint8>& savestate, bool compressed)
+{
+	if (isSavestateEmpty(frame))
+		return false;
+	FRAME& currentFrame = frames[frame];
+	std::vector<uint8>& output = compressed ? plainBuffer : savestate;
+	int size = keyframes[currentFrame.keyframe].pages.size() * GREENZONE_PAGE_SIZE;
+	output.resize(size);
+	memcpy(&output[0], getKeyframeData(currentFrame.keyframe), size);
+	for (int i = currentFrame.delta.size() - 1; i >= 0; i--)
+		unpackPage(currentFrame.delta[i].page, &output[currentFrame.delta[i].index * GREENZONE_PAGE_SIZE]);
+	output.resize(currentFrame.length);
+
+	if (compressed)
+	{
+		if (currentFrame.length <= SAVESTATE_HEADER_SIZE || memcmp(&plainBuffer[0], "FCSX", 4))
+		{
+			savestate = plainBuffer;
+			return true;
+		}
+		// same layout that FCEUSS_SaveMS produces
+		uLong len = currentFrame.length - SAVESTATE_HEADER_SIZE;
+		uLongf comprlen = (len>>9)+12 + len;
+		compressedBuffer.resize(SAVESTATE_HEADER_SIZE + comprlen);
+		memcpy(&compressedBuffer[0], &plainBuffer[0], SAVESTATE_HEADER_SIZE);
+		if (compress2(&compressedBuffer[SAVESTATE_HEADER_SIZE], &comprlen, &plainBuffer[SAVESTATE_HEADER_SIZE], len, Z_DEFAULT_COMPRESSION) != Z_OK)
+		{
+			savestate = plainBuffer;
+			return true;
+		}
+		FCEU_en32lsb(&compressedBuffer[12], comprlen);
+		compressedBuffer.resize(SAVESTATE_HEADER_SIZE + comprlen);
+		savestate = compressedBuffer;
+	}
+	return true;
+}
+
+// returns true if actually cleared savestate data
+bool GREENZONE_STORAGE::clearSavestate(int frame)
+{
+	if (isSavestateEmpty(frame))
+		return false;
+	FRAME& currentFrame = frames[frame];
+	for (int i = currentFrame.delta.size() - 1; i >= 0; i--)
+		releasePage(currentFrame.delta[i].page);
+	deltaEntries -= currentFrame.delta.size();
+	std::vector<DELTA>().swap(currentFrame.delta);
+	releaseKeyframe(currentFrame.keyframe);
+	currentFrame.keyframe = -1;
+	currentFrame.length = 0;
+
+	int slot = frame / GREENZONE_KEYFRAME_INTERVAL;
+	if (--slotFrames[slot] == 0 && slotKeyframe[slot] >= 0)
+	{
+		releaseKeyframe(slotKeyframe[slot]);
+		slotKeyframe[slot] = -1;
+	}
+	return true;
+}
+
+bool GREENZONE_STORAGE::isSavestateEmpty(int frame)
+{
+	return (frame < 0 || frame >= (int)frames.size() || frames[frame].keyframe < 0);
+}
+
+int GREENZONE_STORAGE::getSize()
+{
+	return frames.size();
+}
+
+// approximate number of bytes taken by all stored savestates
+unsigned int GREENZONE_STORAGE::getMemoryUsage()
+{
+	return packedBytes
+		+ livePages * sizeof(PAGE)
+		+ buckets.size() * sizeof(int)
+		+ keyframes.size() * sizeof(KEYFRAME) + keyframeEntries * sizeof(int)
+		+ frames.size() * sizeof(FRAME) + deltaEntries * sizeof(DELTA)
+		+ keyframeCache.size() + plainBuffer.capacity() + compressedBuffer.capacity();
+}
+// -------------------------------------------------------------------------------------------------
+// converts a compressed savestate into the uncompressed one, keeping the FCSX header
+bool GREENZONE_STORAGE::unpackSavestate(std::vector<uint8>& savestate, std::vector<uint8>& plain)
+{
+	if (savestate.size() <= SAVESTATE_HEADER_SIZE || memcmp(&savestate[0], "FCSX", 4))
+	{
+		plain = savestate;
+		return plain.size() != 0;
+	}
+	int totalsize = FCEU_de32lsb(&savestate[4]);
+	int comprlen = FCEU_de32lsb(&savestate[12]);
+	if (comprlen == -1)
+	{
+		plain = savestate;
+		return true;
+	}
+	if (totalsize < 0 || comprlen < 0 || comprlen > (int)savestate.size() - SAVESTATE_HEADER_SIZE)
+		return false;
+	plain.resize(SAVESTATE_HEADER_SIZE + totalsize);
+	memcpy(&plain[0], &savestate[0], SAVESTATE_HEADER_SIZE);
+	FCEU_en32lsb(&plain[12], (uint32)-1);
+	uLongf uncomprlen = totalsize;
+	int error = uncompress(&plain[SAVESTATE_HEADER_SIZE], &uncomprlen, &savestate[SAVESTATE_HEADER_SIZE], comprlen);
+	return (error == Z_OK && uncomprlen == totalsize);
+}
+
+// returns the id of the page with given contents, adding it if there's no such page yet
+int GREENZONE_STORAGE::internPage(const uint8* data)
+{
+	uint8 packed[GREENZONE_PAGE_SIZE];
+	int size = packPage(data, packed);
+	uint32 hash = hashPage(packed, size);
+
+	if (livePages >= (int)buckets.size())
+		growHashTable();
+	int bucket = hash & (buckets.size() - 1);
+	for (int i = buckets[bucket]; i >= 0; i = pages[i].next)
+	{
+		if (pages[i].hash == hash && (int)pages[i].packed.size() == size && !memcmp(&pages[i].packed[0], packed, size))
+		{
+			pages[i].refs++;
+			return i;
+		}
+	}
+
+	int page;
+	if (freePages >= 0)
+	{
+		page = freePages;
+		freePages = pages[page].next;
+	} else
+	{
+		page = pages.size();
+		pages.push_back(PAGE());
+	}
+	PAGE& newPage = pages[page];
+	newPage.hash = hash;
+	newPage.refs = 1;
+	newPage.packed.assign(packed, packed + size);
+	newPage.next = buckets[bucket];
+	buckets[bucket] = page;
+	livePages++;
+	packedBytes += size;
+	return page;
+}
+
+void GREENZONE_STORAGE::releasePage(int page)
+{
+	if (--pages[page].refs > 0)
+		return;
+	// unlink from the hash bucket
+	int* link = &buckets[pages[page].hash & (buckets.size() - 1)];
+	while (*link != page)
+		link = &pages[*link].next;
+	*link = pages[page].next;
+
+	packedBytes -= pages[page].packed.size();
+	std::vector<uint8>().swap(pages[page].packed);
+	pages[page].next = freePages;
+	freePages = page;
+	livePages--;
+}
+
+void GREENZONE_STORAGE::unpackPage(int page, uint8* data)
+{
+	const std::vector<uint8>& packed = pages[page].packed;
+	if (packed.size() == GREENZONE_PAGE_SIZE)
+	{
+		memcpy(data, &packed[0], GREENZONE_PAGE_SIZE);
+		return;
+	}
+	const uint8* src = &packed[0];
+	const uint8* end = src + packed.size();
+	while (src < end)
+	{
+		int n = *src++;
+		if (n < 128)
+		{
+			memcpy(data, src, n + 1);
+			src += n + 1;
+			data += n + 1;
+		} else
+		{
+			memset(data, *src++, 257 - n);
+			data += 257 - n;
+		}
+	}
+}
+
+int GREENZONE_STORAGE::createKeyframe(const uint8* data, int numPages)
+{
+	int keyframe;
+	if (freeKeyframes.size())
+	{
+		keyframe = freeKeyframes.back();
+		freeKeyframes.pop_back();
+	} else
+	{
+		keyframe = keyframes.size();
+		keyframes.push_back(KEYFRAME());
+	}
+	KEYFRAME& newKeyframe = keyframes[keyframe];
+	newKeyframe.pages.resize(numPages);
+	for (int i = 0; i < numPages; ++i)
+		newKeyframe.pages[i] = internPage(data + i * GREENZONE_PAGE_SIZE);
+	newKeyframe.refs = 1;
+	keyframeEntries += numPages;
+	// the next frames will most likely be compared with it
+	keyframeCache.assign(data, data + numPages * GREENZONE_PAGE_SIZE);
+	cachedKeyframe = keyframe;
+	return keyframe;
+}
+
+void GREENZONE_STORAGE::releaseKeyframe(int keyframe)
+{
+	if (--keyframes[keyframe].refs > 0)
+		return;
+	std::vector<int>& keyframePages = keyframes[keyframe].pages;
+	for (int i = keyframePages.size() - 1; i >= 0; i--)
+		releasePage(keyframePages[i]);
+	keyframeEntries -= keyframePages.size();
+	std::vector<int>().swap(keyframePages);
+	freeKeyframes.push_back(keyframe);
+	if (cachedKeyframe == keyframe)
+		cachedKeyframe = -1;
+}
+
+const uint8* GREENZONE_STORAGE::getKeyframeData(int keyframe)
+{
+	if (cachedKeyframe != keyframe)
+	{
+		std::vector<int>& keyframePages = keyframes[keyframe].pages;
+		keyframeCache.resize(keyframePages.size() * GREENZONE_PAGE_SIZE);
+		for (int i = keyframePages.size() - 1; i >= 0; i--)
+			unpackPage(keyframePages[i], &keyframeCache[i * GREENZONE_PAGE_SIZE]);
+		cachedKeyframe = keyframe;
+	}
+	return &keyframeCache[0];
+}
+
+void GREENZONE_STORAGE::growHashTable()
+{
+	int size = buckets.size() ? buckets.size() * 2 : 1024;
+	buckets.assign(size, -1);
+	for (int i = pages.size() - 1; i >= 0; i--)
+	{
+		if (pages[i].refs <= 0) continue;
+		int bucket = pages[i].hash & (size - 1);
+		pages[i].next = buckets[bucket];
+		buckets[bucket] = i;
+	}
+}
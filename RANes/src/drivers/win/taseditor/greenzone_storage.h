@@ -0,0 +1,79 @@
+// Specification file for Greenzone_Storage class
+
+#include <deque>
+
+#define GREENZONE_PAGE_SIZE 256
+#define GREENZONE_KEYFRAME_INTERVAL 64		// every 64 frames share one keyframe, so restoring any savestate costs one keyframe plus one delta
+
+class GREENZONE_STORAGE
+{
+public:
+	GREENZONE_STORAGE();
+	void reset();
+
+	void setSavestate(int frame, std::vector<uint8>& savestate);
+	bool getSavestate(int frame, std::vector<uint8>& savestate, bool compressed = false);
+	bool clearSavestate(int frame);
+	bool isSavestateEmpty(int frame);
+
+	int getSize();
+	unsigned int getMemoryUsage();
+
+private:
+	struct PAGE
+	{
+		uint32 hash;
+		int next;						// next page in the same hash bucket, or next free page
+		int refs;
+		std::vector<uint8> packed;		// PackBits data, or the raw page if that's not any shorter
+	};
+	struct DELTA
+	{
+		int index;						// page number inside the savestate
+		int page;
+	};
+	struct KEYFRAME
+	{
+		std::vector<int> pages;
+		int refs;
+	};
+	struct FRAME
+	{
+		int keyframe;					// -1 = no savestate for this frame
+		uint32 length;
+		std::vector<DELTA> delta;		// pages that differ from the keyframe
+	};
+
+	bool unpackSavestate(std::vector<uint8>& savestate, std::vector<uint8>& plain);
+	int internPage(const uint8* data);
+	void releasePage(int page);
+	void unpackPage(int page, uint8* data);
+	int createKeyframe(const uint8* data, int numPages);
+	void releaseKeyframe(int keyframe);
+	const uint8* getKeyframeData(int keyframe);
+	void growHashTable();
+
+	std::deque<PAGE> pages;
+	std::vector<int> buckets;
+	int freePages;
+	int livePages;
+	unsigned int packedBytes;
+
+	std::vector<KEYFRAME> keyframes;
+	std::vector<int> freeKeyframes;
+	unsigned int keyframeEntries;
+
+	std::vector<FRAME> frames;
+	unsigned int deltaEntries;
+
+	// keyframe used by new savestates of every GREENZONE_KEYFRAME_INTERVAL frames, and how many savestates that slot holds
+	std::vector<int> slotKeyframe;
+	std::vector<int> slotFrames;
+
+	// last keyframe that was unpacked, so that consecutive frames don't unpack it again
+	std::vector<uint8> keyframeCache;
+	int cachedKeyframe;
+
+	std::vector<uint8> plainBuffer;
+	std::vector<uint8> compressedBuffer;
+};
@@ -51,6 +51,7 @@ TASEDITOR_CONFIG::TASEDITOR_CONFIG()
 	followMarkerNoteContext = true;
 
 	greenzoneCapacity = GREENZONE_CAPACITY_DEFAULT;
+	greenzoneMemoryLimit = GREENZONE_MEMORY_LIMIT_DEFAULT;
 	maxUndoLevels = UNDO_LEVELS_DEFAULT;
 	enableGreenzoning = true;
 	autofirePatternSkipsLag = true;
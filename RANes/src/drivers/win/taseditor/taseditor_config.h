@@ -4,6 +4,10 @@
 #define GREENZONE_CAPACITY_MAX 50000	// this limitation is here just because we're running in 32-bit OS, so there's 2GB limit of RAM
 #define GREENZONE_CAPACITY_DEFAULT 10000
 
+#define GREENZONE_MEMORY_LIMIT_MIN 16		// in megabytes
+#define GREENZONE_MEMORY_LIMIT_MAX 1536
+#define GREENZONE_MEMORY_LIMIT_DEFAULT 512
+
 #define UNDO_LEVELS_MIN 1
 #define UNDO_LEVELS_MAX 1000			// this limitation is here just because we're running in 32-bit OS, so there's 2GB limit of RAM
 #define UNDO_LEVELS_DEFAULT 100
@@ -61,6 +65,7 @@ public:
 	bool followMarkerNoteContext;
 
 	int greenzoneCapacity;
+	int greenzoneMemoryLimit;
 	int maxUndoLevels;
 
 	bool enableGreenzoning;
@@ -1038,11 +1038,35 @@ void CloseGame()
 
 unsigned char ByteReader( size_t nOffs )
 {
-	//return reinterpret_cast<unsigned char>( (BYTE*)( &ARead[ 0 ] ) );
-	//return static_cast<unsigned char>( ARead[ 0 ]( nOffs ) );
-	return static_cast<unsigned char>( ARead[ nOffs ]( nOffs ) );
-	//extern uint8 GetMem( uint16 A );
-	//return static_cast<unsigned char>( GetMem( static_cast<uint16>( nOffs ) ) );
+	// peek path: never runs the live bus handlers, so no PPU/APU/mapper side effects
+	return static_cast<unsigned char>( FCEU_PeekMem( static_cast<uint32>( nOffs ) ) );
+}
+
+unsigned int BlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	if ( nOffs >= 0x10000 )
+		return 0;
+	if ( nCount > 0x10000 - nOffs )
+		nCount = 0x10000 - nOffs;
+
+	unsigned int i = 0;
+	if ( GameInfo )
+	{
+		// internal RAM and its mirrors can be copied straight from the backing array
+		for ( ; i < nCount && nOffs + i < 0x2000; )
+		{
+			const unsigned int nRAMOffs = ( nOffs + i ) & 0x7FF;
+			unsigned int nChunk = 0x800 - nRAMOffs;
+			if ( nChunk > nCount - i )
+				nChunk = nCount - i;
+			memcpy( pBuffer + i, RAM + nRAMOffs, nChunk );
+			i += nChunk;
+		}
+	}
+	for ( ; i < nCount; ++i )
+		pBuffer[ i ] = FCEU_PeekMem( nOffs + i );
+
+	return nCount;
 }
 
 void ByteWriter( size_t nOffs, unsigned int nVal )
@@ -1062,6 +1086,7 @@ bool ALoad(const char *nameo, char* innerFilename, bool silent)
 //pWriter is typedef void (_RAMByteWriteFn)( unsigned int nOffs, unsigned int nVal );
 		RA_ClearMemoryBanks();
 		RA_InstallMemoryBank( 0, ByteReader, ByteWriter, 0x10000 );
+		RA_InstallMemoryBankBlockReader( 0, BlockReader );
 		if (GameInfo->type == EGIT::GIT_FDS)
 		{
 			RA_OnLoadNewRom(FDSROM, FDSSize);
@@ -42,6 +42,7 @@
 #include "input.h"
 #include "file.h"
 #include "vsuni.h"
+#include "writewatch.h"
 #include "ines.h"
 #ifdef WIN32
 #include "drivers/win/pref.h"
@@ -218,6 +219,7 @@ void (*GameStateRestore)(int version);
 
 readfunc ARead[0x10000];
 writefunc BWrite[0x10000];
+static readfunc APeek[0x10000];
 static readfunc *AReadG;
 static writefunc *BWriteG;
 static int RWWrap = 0;
@@ -253,6 +255,16 @@ static DECLFR(ANull) {
 	return(X.DB);
 }
 
+//Default peek handler: reads the backing store directly so that debuggers and
+//RetroAchievements never trigger register or mapper side effects.
+static DECLFR(APeekDefault) {
+	if (A < 0x2000)
+		return RAM[A & 0x7FF];
+	if (A < 0x4020 || GetReadHandler(A) == ANull)
+		return X.DB;
+	return CartBROB(A);
+}
+
 int AllocGenieRW(void) {
 	if (!(AReadG = (readfunc*)FCEU_malloc(0x8000 * sizeof(readfunc))))
 		return 0;
@@ -291,6 +303,12 @@ void SetReadHandler(int32 start, int32 end, readfunc func) {
 	if (!func)
 		func = ANull;
 
+	//plain cart reads have no side effects; anything else has to register its own peek handler.
+	//CartBR doesn't check for unmapped pages, which a scan of the whole bus will find
+	readfunc peek = (func == CartBR || func == CartBROB) ? CartBROB : APeekDefault;
+	for (x = end; x >= start; x--)
+		APeek[x] = peek;
+
 	if (RWWrap)
 		for (x = end; x >= start; x--) {
 			if (x >= 0x8000)
@@ -303,6 +321,22 @@ void SetReadHandler(int32 start, int32 end, readfunc func) {
 			ARead[x] = func;
 }
 
+void SetPeekHandler(int32 start, int32 end, readfunc func) {
+	int32 x;
+
+	if (!func)
+		func = APeekDefault;
+
+	for (x = end; x >= start; x--)
+		APeek[x] = func;
+}
+
+uint8 FCEU_PeekMem(uint32 A) {
+	if (!GameInfo)
+		return 0;
+	return APeek[A & 0xFFFF](A & 0xFFFF);
+}
+
 writefunc GetWriteHandler(int32 a) {
 	if (RWWrap && a >= 0x8000)
 		return BWriteG[a - 0x8000];
@@ -367,6 +401,28 @@ static DECLFR(ARAMH) {
 	return RAM[A & 0x7FF];
 }
 
+void FCEU_ReadMemBlock(uint32 A, uint8 *dest, uint32 count) {
+	while (count) {
+		if (A >= 0x10000) {
+			memset(dest, 0, count);
+			return;
+		}
+		uint32 n = 1;
+		if (A < 0x2000 && (ARead[A] == ARAML || ARead[A] == ARAMH)) {
+			uint32 max = 0x800 - (A & 0x7FF);
+			if (max > count)
+				max = count;
+			while (n < max && (ARead[A + n] == ARAML || ARead[A + n] == ARAMH))
+				n++;
+			memcpy(dest, RAM + (A & 0x7FF), n);
+		} else
+			*dest = ARead[A](A);
+		A += n;
+		dest += n;
+		count -= n;
+	}
+}
+
 
 void ResetGameLoaded(void) {
 	if (GameInfo) FCEU_CloseGame();
@@ -696,6 +752,8 @@ void FCEUI_Emulate(uint8 **pXBuf, int32 **SoundBuf, int32 *SoundBufSize, int ski
 
 	if (skip != 2) ssize = FlushEmulateSound();  //If skip = 2 we are skipping sound processing
 
+	FCEU_WriteWatchFrameEnd();
+
 #ifdef _S9XLUA_H
 	CallRegisteredLuaFunctions(LUACALL_AFTEREMULATION);
 #endif
@@ -808,6 +866,7 @@ void PowerNES(void) {
 	//for(int i=0;i<0x800;i++) if(i&1) RAM[i] = 0xAA; else RAM[i] = 0x55;
 	//but we're leaving this for now until we collect some more data
 	FCEU_MemoryRand(RAM, 0x800);
+	FCEU_WriteWatchInvalidate();
 
 	SetReadHandler(0x0000, 0xFFFF, ANull);
 	SetWriteHandler(0x0000, 0xFFFF, BNull);
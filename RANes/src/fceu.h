@@ -19,6 +19,16 @@ void SetWriteHandler(int32 start, int32 end, writefunc func);
 writefunc GetWriteHandler(int32 a);
 readfunc GetReadHandler(int32 a);
 
+//Side-effect free reads for debuggers and RetroAchievements.
+//SetReadHandler resets the range to the default peek handler, so boards whose
+//read handlers are safe to call must register them after SetReadHandler.
+void SetPeekHandler(int32 start, int32 end, readfunc func);
+uint8 FCEU_PeekMem(uint32 A);
+
+//Reads count bytes through ARead like FCEU_CheatGetByte does, copying internal
+//RAM straight from the backing array while the default RAM handlers map it.
+void FCEU_ReadMemBlock(uint32 A, uint8 *dest, uint32 count);
+
 int AllocGenieRW(void);
 void FlushGenieRW(void);
 
@@ -46,6 +46,7 @@ struct LuaSaveData
 
 	void SaveRecord(struct lua_State* L, unsigned int key); // saves Lua stack into a record and pops it
 	void LoadRecord(struct lua_State* L, unsigned int key, unsigned int itemsToLoad) const; // pushes a record's data onto the Lua stack
+	bool HasRecord(unsigned int key) const; // true if a record was saved under key
 	void SaveRecordPartial(struct lua_State* L, unsigned int key, int idx); // saves part of the Lua stack (at the given index) into a record and does NOT pop anything
 
 	void ExportRecords(void* file) const; // writes all records to an already-open file
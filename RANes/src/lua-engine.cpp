@@ -23,8 +23,12 @@
 #include "x6502.h"
 #include "utils/xstring.h"
 #include "utils/memory.h"
+#include "utils/crc32.h"
 #include "fceulua.h"
 
+//##RA
+#include "RA_Interface.h"
+
 #ifdef WIN32
 #include "drivers/win/common.h"
 #include "drivers/win/taseditor/selection.h"
@@ -164,15 +168,43 @@ extern void WinLuaOnStop(int hDlgAsInt);
 void TaseditorDisableManualFunctionIfNeeded();
 #endif
 
-static lua_State *L;
+// One loaded script. Every script gets its own lua_State, so several can run
+// side by side without seeing each other's globals or registered functions.
+struct LuaContextInfo
+{
+	lua_State *L;
+
+	char *scriptName;
+
+	int exitErrorCount;
 
-static int luaexiterrorcount = 8;
+	// Are we running any code right now?
+	int running;
 
-// Are we running any code right now?
-static char *luaScriptName = NULL;
+	// True if there's a thread waiting to run after a run of frame-advance.
+	int frameAdvanceWaiting;
+
+	// Rerecord count skip mode
+	int skipRerecords;
+
+	// number of registered memory functions (1 per hooked byte)
+	unsigned int numMemHooks;
+
+	// Transparency strength. 255=opaque, 0=so transparent it's invisible
+	int transparencyModifier;
+};
 
-// Are we running any code right now?
-int luaRunning = FALSE;
+// Scripts in the order they were started. A stopped script keeps its entry,
+// with L set to NULL, until no script is being called, so the loops that
+// call each script in turn never see the list shrink under them.
+static std::vector<LuaContextInfo*> luaContexts;
+
+// The script being called, or else the last one started. L is its state.
+static LuaContextInfo *luaContext = NULL;
+static lua_State *L;
+
+// Number of LuaContextScopes alive
+static int luaContextDepth = 0;
 
 // True at the frame boundary, false otherwise.
 static int frameBoundary = FALSE;
@@ -180,22 +212,14 @@ static int frameBoundary = FALSE;
 // The execution speed we're running at.
 static enum {SPEED_NORMAL, SPEED_NOTHROTTLE, SPEED_TURBO, SPEED_MAXIMUM} speedmode = SPEED_NORMAL;
 
-// Rerecord count skip mode
-static int skipRerecords = FALSE;
-
 // Used by the registry to find our functions
 static const char *frameAdvanceThread = "FCEU.FrameAdvance";
 static const char *guiCallbackTable = "FCEU.GUI";
-
-// True if there's a thread waiting to run after a run of frame-advance.
-static int frameAdvanceWaiting = FALSE;
+static const char *callbackListTable = "FCEU.CallbackLists";
 
 // We save our pause status in the case of a natural death.
 static int wasPaused = FALSE;
 
-// Transparency strength. 255=opaque, 0=so transparent it's invisible
-static int transparencyModifier = 255;
-
 // Our joypads.
 static uint8 luajoypads1[4]= { 0xFF, 0xFF, 0xFF, 0xFF }; //x1
 static uint8 luajoypads2[4]= { 0x00, 0x00, 0x00, 0x00 }; //0x
@@ -212,9 +236,6 @@ static int gui_saw_current_palette = FALSE;
 // over time. The script gets knifed once this reaches zero.
 static int numTries;
 
-// number of registered memory functions (1 per hooked byte)
-static unsigned int numMemHooks;
-
 // Look in fceu.h for macros named like JOY_UP to determine the order.
 static const char *button_mappings[] = {
 	"A", "B", "select", "start", "up", "down", "left", "right"
@@ -261,11 +282,75 @@ static char* rawToCString(lua_State* L, int idx=0);
 static const char* toCString(lua_State* L, int idx=0);
 
 /**
- * Resets emulator speed / pause states after script exit.
+ * Makes info the current script until the end of the scope, so the code
+ * using L and luaContext works on it. Everything that calls into a script
+ * goes through one of these.
+ */
+struct LuaContextScope
+{
+	LuaContextInfo *prev;
+
+	LuaContextScope(LuaContextInfo *info) : prev(luaContext)
+	{
+		luaContextDepth++;
+		luaContext = info;
+		L = info->L;
+	}
+
+	~LuaContextScope()
+	{
+		luaContextDepth--;
+		luaContext = prev;
+		L = prev ? prev->L : NULL;
+	}
+};
+
+/**
+ * Frees the scripts that have been stopped. Does nothing while a script is
+ * being called, and keeps the current one so its name can be reloaded.
+ */
+static void PruneLuaContexts()
+{
+	if (luaContextDepth)
+		return;
+
+	for (size_t i = 0; i < luaContexts.size(); )
+	{
+		LuaContextInfo *info = luaContexts[i];
+		if (info->L || info == luaContext)
+		{
+			i++;
+			continue;
+		}
+		free(info->scriptName);
+		delete info;
+		luaContexts.erase(luaContexts.begin() + i);
+	}
+}
+
+/**
+ * Returns true if any script but except is running.
+ */
+static bool LuaRunningExcept(LuaContextInfo *except)
+{
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		LuaContextInfo *info = luaContexts[i];
+		if (info != except && info->L && info->running)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Resets emulator speed / pause states after script exit, once no other
+ * script is running.
  */
 static void FCEU_LuaOnStop()
 {
-	luaRunning = FALSE;
+	luaContext->running = FALSE;
+	if (LuaRunningExcept(luaContext))
+		return;
 	for (int i = 0 ; i < 4 ; i++ ){
 		luajoypads1[i]= 0xFF;	// Set these back to pass-through
 		luajoypads2[i]= 0x00;
@@ -289,7 +374,7 @@ static void FCEU_LuaOnStop()
  * consult FCEU_LuaFrameSkip().
  */
 int FCEU_LuaSpeed() {
-	if (!L || !luaRunning)
+	if (!LuaRunningExcept(NULL))
 		return 0;
 
 	//printf("%d\n", speedmode);
@@ -310,7 +395,7 @@ int FCEU_LuaSpeed() {
  * Returns 0 if no, 1 if frame should be skipped, -1 if it should not be.
  */
 int FCEU_LuaFrameSkip() {
-	if (!L || !luaRunning)
+	if (!LuaRunningExcept(NULL))
 		return 0;
 
 	switch (speedmode) {
@@ -405,10 +490,10 @@ static int emu_softreset(lua_State *L) {
 static int emu_frameadvance(lua_State *L) {
 	// We're going to sleep for a frame-advance. Take notes.
 
-	if (frameAdvanceWaiting)
+	if (luaContext->frameAdvanceWaiting)
 		return luaL_error(L, "can't call emu.frameadvance() from here");
 
-	frameAdvanceWaiting = TRUE;
+	luaContext->frameAdvanceWaiting = TRUE;
 
 	// Now we can yield to the main
 	return lua_yield(L, 0);
@@ -458,6 +543,90 @@ static int emu_message(lua_State *L) {
 }
 
 
+// Event names for emu.addcallback. The list for event i lives at
+// registry[callbackListTable][i+1]; "before" and "after" share their index
+// with the matching LuaCallID so CallRegisteredLuaFunctions can find them.
+static const char* luaCallbackListEvents [] = { "before", "after", "gui", NULL };
+enum { CALLBACKLIST_GUI = 2, CALLBACKLIST_COUNT = 3 };
+CTASSERT(LUACALL_BEFOREEMULATION == 0 && LUACALL_AFTEREMULATION == 1)
+
+// Pushes the callback list for the event, or nil if it has none and create is false.
+static void PushCallbackList(lua_State *L, int event, bool create) {
+	lua_getfield(L, LUA_REGISTRYINDEX, callbackListTable);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		if (!create)
+		{
+			lua_pushnil(L);
+			return;
+		}
+		lua_createtable(L, CALLBACKLIST_COUNT, 0);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, callbackListTable);
+	}
+	lua_rawgeti(L, -1, event + 1);
+	if (!lua_istable(L, -1) && create)
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, -3, event + 1);
+	}
+	lua_remove(L, -2);
+}
+
+// function emu.addcallback(string event, function f)
+//
+//  Adds f to the functions run on event ("before", "after" or "gui"), after
+//  the one set with emu.registerbefore, emu.registerafter or gui.register.
+//  Lets several HUD pieces hook the same frame without chaining each other,
+//  and the core runs the whole list in one pass. Returns f.
+static int emu_addcallback(lua_State *L) {
+	int event = luaL_checkoption(L, 1, NULL, luaCallbackListEvents);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	lua_settop(L, 2);
+	PushCallbackList(L, event, true);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+	lua_pushvalue(L, 2);
+	return 1;
+}
+
+// bool emu.removecallback(string event, function f)
+//
+//  Removes f from the list built by emu.addcallback. Returns false if it wasn't in it.
+static int emu_removecallback(lua_State *L) {
+	int event = luaL_checkoption(L, 1, NULL, luaCallbackListEvents);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	lua_settop(L, 2);
+	PushCallbackList(L, event, false);
+	bool removed = false;
+	if (lua_istable(L, 3))
+	{
+		int n = lua_objlen(L, 3);
+		for (int i = 1; i <= n; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			bool match = lua_rawequal(L, -1, 2) != 0;
+			lua_pop(L, 1);
+			if (!match)
+				continue;
+			for (; i < n; i++)
+			{
+				lua_rawgeti(L, 3, i + 1);
+				lua_rawseti(L, 3, i);
+			}
+			lua_pushnil(L);
+			lua_rawseti(L, 3, n);
+			removed = true;
+			break;
+		}
+	}
+	lua_pushboolean(L, removed);
+	return 1;
+}
+
 static int emu_registerbefore(lua_State *L) {
 	if (!lua_isnil(L,1))
 		luaL_checktype(L, 1, LUA_TFUNCTION);
@@ -1013,6 +1182,15 @@ void LuaSaveData::LoadRecord(struct lua_State* L, unsigned int key, unsigned int
 	}
 }
 
+// true if a record was saved under key
+bool LuaSaveData::HasRecord(unsigned int key) const
+{
+	for(Record* cur = recordList; cur; cur = cur->next)
+		if(cur->key == key)
+			return true;
+	return false;
+}
+
 // saves part of the Lua stack (at the given index) into a record and does NOT pop anything
 void LuaSaveData::SaveRecordPartial(struct lua_State* L, unsigned int key, int idx)
 {
@@ -1148,9 +1326,8 @@ void LuaSaveData::ClearRecords()
 
 
 
-void CallRegisteredLuaSaveFunctions(int savestateNumber, LuaSaveData& saveData)
+static void CallScriptSaveFunction(int savestateNumber, LuaSaveData& saveData, unsigned int key)
 {
-	//lua_State* L = FCEU_GetLuaState();
 	if(L)
 	{
 		lua_settop(L, 0);
@@ -1170,7 +1347,7 @@ void CallRegisteredLuaSaveFunctions(int savestateNumber, LuaSaveData& saveData)
 				fprintf(stderr, "Lua error in registersave function: %s\n", lua_tostring(L, -1));
 #endif
 			}
-			saveData.SaveRecord(L, LUA_DATARECORDKEY);
+			saveData.SaveRecord(L, key);
 		}
 		else
 		{
@@ -1180,9 +1357,8 @@ void CallRegisteredLuaSaveFunctions(int savestateNumber, LuaSaveData& saveData)
 }
 
 
-void CallRegisteredLuaLoadFunctions(int savestateNumber, const LuaSaveData& saveData)
+static void CallScriptLoadFunction(int savestateNumber, const LuaSaveData& saveData, unsigned int key)
 {
-	//lua_State* L = FCEU_GetLuaState();
 	if(L)
 	{
 		lua_settop(L, 0);
@@ -1201,12 +1377,12 @@ void CallRegisteredLuaLoadFunctions(int savestateNumber, const LuaSaveData& save
 			int prevGarbage = lua_gc(L, LUA_GCCOUNT, 0);
 
 			lua_pushinteger(L, savestateNumber);
-			saveData.LoadRecord(L, LUA_DATARECORDKEY, numParamsExpected);
+			saveData.LoadRecord(L, key, numParamsExpected);
 #else
 			int prevGarbage = lua_gc(L, LUA_GCCOUNT, 0);
 
 			lua_pushinteger(L, savestateNumber);
-			saveData.LoadRecord(L, LUA_DATARECORDKEY, (unsigned int) -1);
+			saveData.LoadRecord(L, key, (unsigned int) -1);
 #endif
 
 			int n = lua_gettop(L) - 1;
@@ -1240,6 +1416,55 @@ void CallRegisteredLuaLoadFunctions(int savestateNumber, const LuaSaveData& save
 	}
 }
 
+// Every script keeps its data under the CRC32 of its file name, so a state
+// loaded after other scripts were started or stopped still hands each script
+// its own data.
+static unsigned int ScriptDataKey(const LuaContextInfo *info)
+{
+	unsigned int key = CalcCRC32(0, (uint8 *)info->scriptName, (uint32)strlen(info->scriptName));
+	return (key == LUA_DATARECORDKEY) ? key + 1 : key;
+}
+
+// States saved when only one script could run have its data under
+// LUA_DATARECORDKEY. That record is only handed out when a single script is
+// running, as there is no telling whose it was otherwise.
+static unsigned int ScriptLoadKey(const LuaContextInfo *info, const LuaSaveData& saveData)
+{
+	unsigned int key = ScriptDataKey(info);
+	if (saveData.HasRecord(key))
+		return key;
+
+	int running = 0;
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (luaContexts[i]->L)
+			running++;
+	}
+	return (running == 1) ? LUA_DATARECORDKEY : key;
+}
+
+void CallRegisteredLuaSaveFunctions(int savestateNumber, LuaSaveData& saveData)
+{
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		CallScriptSaveFunction(savestateNumber, saveData, ScriptDataKey(luaContexts[i]));
+	}
+}
+
+void CallRegisteredLuaLoadFunctions(int savestateNumber, const LuaSaveData& saveData)
+{
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		CallScriptLoadFunction(savestateNumber, saveData, ScriptLoadKey(luaContexts[i], saveData));
+	}
+}
+
 
 static int rom_readbyte(lua_State *L) {
 	lua_pushinteger(L, FCEU_ReadRomByte(luaL_checkinteger(L,1)));
@@ -1304,12 +1529,48 @@ static int memory_readbyterange(lua_State *L) {
 	if(range_size < 0)
 		return 0;
 
-	char* buf = (char*)alloca(range_size);
-	for(int i=0;i<range_size;i++) {
-		buf[i] = FCEU_CheatGetByte(range_start+i);
+	luaL_Buffer b;
+	luaL_buffinit(L, &b);
+	while(range_size > 0) {
+		int n = range_size < LUAL_BUFFERSIZE ? range_size : LUAL_BUFFERSIZE;
+		FCEU_ReadMemBlock(range_start, (uint8*)luaL_prepbuffer(&b), n);
+		luaL_addsize(&b, n);
+		range_start += n;
+		range_size -= n;
 	}
+	luaL_pushresult(&b);
 
-	lua_pushlstring(L,buf,range_size);
+	return 1;
+}
+
+// table memory.readbytes(int address, int length [, table t])
+//
+//  Reads length bytes into t[1]..t[length] and returns t.
+//  Passing the same table every frame avoids building a new one.
+static int memory_readbytes(lua_State *L) {
+
+	int range_start = luaL_checkinteger(L,1);
+	int range_size = luaL_checkinteger(L,2);
+	if(range_size < 0)
+		range_size = 0;
+
+	if(lua_istable(L,3))
+		lua_settop(L,3);
+	else
+	{
+		lua_settop(L,2);
+		lua_createtable(L, range_size, 0);
+	}
+
+	uint8 buf[256];
+	for(int i = 0; i < range_size; i += sizeof(buf)) {
+		int n = range_size - i < (int)sizeof(buf) ? range_size - i : (int)sizeof(buf);
+		FCEU_ReadMemBlock(range_start + i, buf, n);
+		for(int j = 0; j < n; j++) {
+			lua_pushinteger(L, buf[j]);
+			lua_rawseti(L, 3, i + j + 1);
+		}
+	}
 
 	return 1;
 }
@@ -1734,6 +1995,9 @@ static int memory_setregister(lua_State *L)
 }
 
 
+static void LuaStopScript();
+
+// Reports an error from a registered function and stops the script it belongs to.
 void HandleCallbackError(lua_State* L)
 {
 	//if(L->errfunc || L->errorJmp)
@@ -1750,7 +2014,7 @@ void HandleCallbackError(lua_State* L)
 		fprintf(stderr, "Lua thread bombed out: %s\n", lua_tostring(L,-1));
 #endif
 
-		FCEU_LuaStop();
+		LuaStopScript();
 	}
 }
 
@@ -1848,14 +2112,12 @@ TieredRegion hookedRegions [LUAMEMHOOK_COUNT];
 static void CalculateMemHookRegions(LuaMemHookType hookType)
 {
 	std::vector<unsigned int> hookedBytes;
-//	std::map<int, LuaContextInfo*>::iterator iter = luaContextInfo.begin();
-//	std::map<int, LuaContextInfo*>::iterator end = luaContextInfo.end();
-//	while(iter != end)
-//	{
-//		LuaContextInfo& info = *iter->second;
-		if(/*info.*/ numMemHooks)
+	for(size_t c = 0; c < luaContexts.size(); c++)
+	{
+		LuaContextInfo& info = *luaContexts[c];
+		if(info.numMemHooks)
 		{
-//			lua_State* L = info.L;
+			lua_State* L = info.L;
 			if(L)
 			{
 				lua_settop(L, 0);
@@ -1873,27 +2135,20 @@ static void CalculateMemHookRegions(LuaMemHookType hookType)
 				lua_settop(L, 0);
 			}
 		}
-//		++iter;
-//	}
+	}
 	hookedRegions[hookType].Calculate(hookedBytes);
 }
 
 static void CallRegisteredLuaMemHook_LuaMatch(unsigned int address, int size, unsigned int value, LuaMemHookType hookType)
 {
-//	std::map<int, LuaContextInfo*>::iterator iter = luaContextInfo.begin();
-//	std::map<int, LuaContextInfo*>::iterator end = luaContextInfo.end();
-//	while(iter != end)
-//	{
-//		LuaContextInfo& info = *iter->second;
-		if(/*info.*/ numMemHooks)
+	for(size_t c = 0; c < luaContexts.size(); c++)
+	{
+		LuaContextInfo& info = *luaContexts[c];
+		if(info.numMemHooks)
 		{
-//			lua_State* L = info.L;
-			if(L/* && !info.panic*/)
+			if(info.L)
 			{
-#ifdef USE_INFO_STACK
-				infoStack.insert(infoStack.begin(), &info);
-				struct Scope { ~Scope(){ infoStack.erase(infoStack.begin()); } } scope;
-#endif
+				LuaContextScope scope(&info);
 				lua_settop(L, 0);
 				lua_getfield(L, LUA_REGISTRYINDEX, luaMemHookTypeStrings[hookType]);
 				for(int i = address; i != address+size; i++)
@@ -1901,19 +2156,17 @@ static void CallRegisteredLuaMemHook_LuaMatch(unsigned int address, int size, un
 					lua_rawgeti(L, -1, i);
 					if (lua_isfunction(L, -1))
 					{
-						bool wasRunning = (luaRunning!=0) /*info.running*/;
-						luaRunning /*info.running*/ = true;
+						bool wasRunning = (info.running!=0);
+						info.running = true;
 						//RefreshScriptSpeedStatus();
 						lua_pushinteger(L, address);
 						lua_pushinteger(L, size);
 						int errorcode = lua_pcall(L, 2, 0, 0);
-						luaRunning /*info.running*/ = wasRunning;
+						info.running = wasRunning;
 						//RefreshScriptSpeedStatus();
 						if (errorcode)
 						{
 							HandleCallbackError(L);
-							//int uid = iter->first;
-							//HandleCallbackError(L,info,uid,true);
 						}
 						break;
 					}
@@ -1922,11 +2175,11 @@ static void CallRegisteredLuaMemHook_LuaMatch(unsigned int address, int size, un
 						lua_pop(L,1);
 					}
 				}
-				lua_settop(L, 0);
+				if(L)
+					lua_settop(L, 0);
 			}
 		}
-//		++iter;
-//	}
+	}
 }
 void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value, LuaMemHookType hookType)
 {
@@ -1944,13 +2197,71 @@ void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value
 	}
 }
 
-void CallRegisteredLuaFunctions(LuaCallID calltype)
+static void ReportGuiError(lua_State *L)
 {
-	assert((unsigned int)calltype < (unsigned int)LUACALL_COUNT);
-	const char* idstring = luaCallIDStrings[calltype];
+#ifdef WIN32
+	//StopSound();//StopSound(); //mbg merge 7/23/08
+	MessageBox(hAppWnd, lua_tostring(L, -1), "Lua Error in GUI function", MB_OK);
+#else
+	fprintf(stderr, "Lua error in gui.register function: %s\n", lua_tostring(L, -1));
+#endif
+}
 
-	if (!L)
-		return;
+// Runs every function added to the event with emu.addcallback. The list is
+// fetched once and walked in place, so a frame with several HUD callbacks
+// costs one registry lookup rather than one per callback.
+// A failing function is treated like the one registered for the same event:
+// a "gui" one is reported and dropped from the list, a "before" or "after"
+// one stops the script. Returns false in that case.
+static bool CallLuaCallbackList(int event)
+{
+	PushCallbackList(L, event, false);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		return true;
+	}
+
+	int list = lua_gettop(L);
+	int n = lua_objlen(L, list);
+	for (int i = 1; i <= n; i++)
+	{
+		lua_rawgeti(L, list, i);
+		if (!lua_isfunction(L, -1))
+		{
+			// removed by an earlier callback in this pass
+			lua_pop(L, 1);
+			continue;
+		}
+		if (lua_pcall(L, 0, 0, 0))
+		{
+			if (event != CALLBACKLIST_GUI)
+			{
+				HandleCallbackError(L);
+				return false;
+			}
+			ReportGuiError(L);
+			lua_pop(L, 1);
+
+			// This is grounds for trashing the function
+			for (int j = i; j < n; j++)
+			{
+				lua_rawgeti(L, list, j + 1);
+				lua_rawseti(L, list, j);
+			}
+			lua_pushnil(L);
+			lua_rawseti(L, list, n);
+			i--;
+			n--;
+		}
+	}
+	lua_pop(L, 1);
+	return true;
+}
+
+static void CallScriptFunctions(LuaCallID calltype)
+{
+	const char* idstring = luaCallIDStrings[calltype];
 
 	lua_settop(L, 0);
 	lua_getfield(L, LUA_REGISTRYINDEX, idstring);
@@ -1960,12 +2271,31 @@ void CallRegisteredLuaFunctions(LuaCallID calltype)
 	{
 		errorcode = lua_pcall(L, 0, 0, 0);
 		if (errorcode)
+		{
 			HandleCallbackError(L);
+			return;
+		}
 	}
 	else
 	{
 		lua_pop(L, 1);
 	}
+
+	if (calltype == LUACALL_BEFOREEMULATION || calltype == LUACALL_AFTEREMULATION)
+		CallLuaCallbackList(calltype);
+}
+
+void CallRegisteredLuaFunctions(LuaCallID calltype)
+{
+	assert((unsigned int)calltype < (unsigned int)LUACALL_COUNT);
+
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		CallScriptFunctions(calltype);
+	}
 }
 
 void ForceExecuteLuaFrameFunctions()
@@ -1988,14 +2318,19 @@ void TaseditorManualFunction()
 #ifdef WIN32
 void TaseditorDisableManualFunctionIfNeeded()
 {
-	if (L)
+	// check if any script's LUACALL_TASEDITOR_MANUAL function is not nil
+	for (size_t i = 0; i < luaContexts.size(); i++)
 	{
-		// check if LUACALL_TASEDITOR_MANUAL function is not nil
+		lua_State *L = luaContexts[i]->L;
+		if (!L)
+			continue;
 		lua_getfield(L, LUA_REGISTRYINDEX, luaCallIDStrings[LUACALL_TASEDITOR_MANUAL]);
-		if (!lua_isfunction(L, -1))
-			taseditor_lua.disableRunFunction();
+		bool set = lua_isfunction(L, -1) != 0;
 		lua_pop(L, 1);
-	} else taseditor_lua.disableRunFunction();
+		if (set)
+			return;
+	}
+	taseditor_lua.disableRunFunction();
 }
 #endif
 
@@ -2048,8 +2383,7 @@ static int memory_registerHook(lua_State* L, LuaMemHookType hookType, int defaul
 	}
 
 	// adjust the count of active hooks
-	//LuaContextInfo& info = GetCurrentInfo();
-	/*info.*/ numMemHooks += numFuncsAfter - numFuncsBefore;
+	luaContext->numMemHooks += numFuncsAfter - numFuncsBefore;
 
 	// re-cache regions of hooked memory across all scripts
 	CalculateMemHookRegions(hookType);
@@ -2698,7 +3032,7 @@ static int savestate_loadscriptdata(lua_State *L) {
 			fclose(luaSaveFile);
 
 			lua_settop(L, 0);
-			saveData.LoadRecord(L, LUA_DATARECORDKEY, (unsigned int)-1);
+			saveData.LoadRecord(L, ScriptLoadKey(luaContext, saveData), (unsigned int)-1);
 			return lua_gettop(L);
 		}
 	}
@@ -2772,7 +3106,7 @@ static int movie_rerecordcounting(lua_State *L) {
 	if (lua_gettop(L) == 0)
 		luaL_error(L, "no parameters specified");
 
-	skipRerecords = lua_toboolean(L,1);
+	luaContext->skipRerecords = lua_toboolean(L,1);
 	return 0;
 }
 
@@ -3315,7 +3649,7 @@ static uint32 gui_getcolour(lua_State *L, int offset) {
 	int a, r, g, b;
 
 	colour = gui_getcolour_wrapped(L, offset, false, 0);
-	a = ((colour & 0xff) * transparencyModifier) / 255;
+	a = ((colour & 0xff) * luaContext->transparencyModifier) / 255;
 	if (a > 255) a = 255;
 	b = (colour >> 8) & 0xff;
 	g = (colour >> 16) & 0xff;
@@ -3331,7 +3665,7 @@ static uint32 gui_optcolour(lua_State *L, int offset, uint32 defaultColour) {
 	defaultColour = (defR << 24) | (defG << 16) | (defB << 8) | defA;
 
 	colour = gui_getcolour_wrapped(L, offset, true, defaultColour);
-	a = ((colour & 0xff) * transparencyModifier) / 255;
+	a = ((colour & 0xff) * luaContext->transparencyModifier) / 255;
 	if (a > 255) a = 255;
 	b = (colour >> 8) & 0xff;
 	g = (colour >> 16) & 0xff;
@@ -3612,9 +3946,9 @@ static int gui_gdscreenshot(lua_State *L) {
 // however, it can be convenient to be able to globally modify the drawing transparency
 static int gui_setopacity(lua_State *L) {
 	double opacF = luaL_checknumber(L,1);
-	transparencyModifier = (int) (opacF * 255);
-	if (transparencyModifier < 0)
-		transparencyModifier = 0;
+	luaContext->transparencyModifier = (int) (opacF * 255);
+	if (luaContext->transparencyModifier < 0)
+		luaContext->transparencyModifier = 0;
 	return 0;
 }
 
@@ -3623,9 +3957,9 @@ static int gui_setopacity(lua_State *L) {
 //  0 = solid,
 static int gui_transparency(lua_State *L) {
 	double trans = luaL_checknumber(L,1);
-	transparencyModifier = (int) ((4.0 - trans) / 4.0 * 255);
-	if (transparencyModifier < 0)
-		transparencyModifier = 0;
+	luaContext->transparencyModifier = (int) ((4.0 - trans) / 4.0 * 255);
+	if (luaContext->transparencyModifier < 0)
+		luaContext->transparencyModifier = 0;
 	return 0;
 }
 
@@ -3989,7 +4323,7 @@ void LuaDrawTextTransWH(const char *str, size_t l, int &x, int y, uint32 color,
 		return;
 
 	size_t len = l;
-	int defaultAlpha = std::max(0, std::min(transparencyModifier, 255));
+	int defaultAlpha = std::max(0, std::min(luaContext->transparencyModifier, 255));
 	int diffx;
 	int diffy = std::max(0, std::min(7, LUA_SCREEN_HEIGHT - y));
 
@@ -4134,7 +4468,7 @@ static int gui_gdoverlay(lua_State *L) {
 		height = luaL_checkinteger(L,index++);
 	}
 
-	int alphaMul = transparencyModifier;
+	int alphaMul = luaContext->transparencyModifier;
 	if(lua_isnumber(L, index))
 		alphaMul = (int)(alphaMul * lua_tonumber(L, index++));
 	if(alphaMul <= 0)
@@ -5350,6 +5684,8 @@ static const struct luaL_reg emulib [] = {
 	{"registerbefore", emu_registerbefore},
 	{"registerafter", emu_registerafter},
 	{"registerexit", emu_registerexit},
+	{"addcallback", emu_addcallback},
+	{"removecallback", emu_removecallback},
 	{"addgamegenie", emu_addgamegenie},
 	{"delgamegenie", emu_delgamegenie},
 	{"getscreenpixel", emu_getscreenpixel},
@@ -5374,6 +5710,7 @@ static const struct luaL_reg memorylib [] = {
 
 	{"readbyte", memory_readbyte},
 	{"readbyterange", memory_readbyterange},
+	{"readbytes", memory_readbytes},
 	{"readbytesigned", memory_readbytesigned},	
 	{"readbyteunsigned", memory_readbyte},	// alternate naming scheme for unsigned
 	{"readword", memory_readword},
@@ -5569,12 +5906,10 @@ void CallExitFunction() {
 		HandleCallbackError(L);
 }
 
-void FCEU_LuaFrameBoundary()
+static void LuaScriptFrameBoundary()
 {
-	//printf("Lua Frame\n");
-
 	// HA!
-	if (!L || !luaRunning)
+	if (!L || !luaContext->running)
 		return;
 
 	// Our function needs calling
@@ -5584,7 +5919,7 @@ void FCEU_LuaFrameBoundary()
 
 	// Lua calling C must know that we're busy inside a frame boundary
 	frameBoundary = TRUE;
-	frameAdvanceWaiting = FALSE;
+	luaContext->frameAdvanceWaiting = FALSE;
 
 	numTries = 1000;
 	int result = lua_resume(thread, 0);
@@ -5614,12 +5949,25 @@ void FCEU_LuaFrameBoundary()
 	// not do anything too stupid, so let ourselves know.
 	frameBoundary = FALSE;
 
-	if (!frameAdvanceWaiting) {
+	if (!luaContext->frameAdvanceWaiting) {
 		FCEU_LuaOnStop();
 	}
 
 }
 
+void FCEU_LuaFrameBoundary()
+{
+	//printf("Lua Frame\n");
+
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		LuaScriptFrameBoundary();
+	}
+}
+
 /**
  * Loads and runs the given Lua script.
  * The emulator MUST be paused for this function to be
@@ -5629,18 +5977,18 @@ void FCEU_LuaFrameBoundary()
  */
 int FCEU_LoadLuaCode(const char *filename, const char *arg) {
 
-	return 0;	//##RA - removed!
+	//##RA - scripts can write memory and control input, so not in hardcore mode
+	if (RA_HardcoreModeIsActive())
+		return 0;
 
 	if (!DemandLua())
 	{
 		return 0;
 	}
 
-	if (filename != luaScriptName)
-	{
-		if (luaScriptName) free(luaScriptName);
-		luaScriptName = strdup(filename);
-	}
+	// filename may belong to a script stopped below, so use a copy
+	char *scriptName = strdup(filename);
+	filename = scriptName;
 
 #if defined(WIN32) || defined(__linux)
 	std::string getfilepath = filename;
@@ -5650,11 +5998,26 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg) {
 	SetCurrentDir(getfilepath.c_str());
 #endif
 
-	//stop any lua we might already have had running
-	FCEU_LuaStop();
+	//restart the script if it is already running, the others keep running
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (luaContexts[i]->L && !strcmp(luaContexts[i]->scriptName, scriptName))
+		{
+			LuaContextScope scope(luaContexts[i]);
+			LuaStopScript();
+		}
+	}
+
+	LuaContextInfo *info = new LuaContextInfo();
+	info->scriptName = scriptName;
 
 	//Reinit the error count
-	luaexiterrorcount = 8;
+	info->exitErrorCount = 8;
+
+	luaContexts.push_back(info);
+	luaContext = info;
+	L = NULL;
+	PruneLuaContexts();
 
 	if (!L) {
 
@@ -5724,6 +6087,7 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg) {
 			lua_setfield(L, LUA_REGISTRYINDEX, luaMemHookTypeStrings[i]);
 		}
 	}
+	info->L = L;
 
 	// We make our thread NOW because we want it at the bottom of the stack.
 	// If all goes wrong, we let the garbage collector remove it.
@@ -5741,8 +6105,9 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg) {
 		fprintf(stderr, "Failed to compile file: %s\n", lua_tostring(L,-1));
 #endif
 
-		// Wipe the stack. Our thread
-		lua_settop(L,0);
+		// Nothing will run in this state, drop it. Its name stays for a reload.
+		lua_close(L);
+		L = info->L = NULL;
 		return 0; // Oh shit.
 	}
 #ifdef WIN32
@@ -5757,10 +6122,10 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg) {
 
 
 	// Initialize settings
-	luaRunning = TRUE;
-	skipRerecords = FALSE;
-	numMemHooks = 0;
-	transparencyModifier = 255; // opaque
+	info->running = TRUE;
+	info->skipRerecords = FALSE;
+	info->numMemHooks = 0;
+	info->transparencyModifier = 255; // opaque
 
 	//wasPaused = FCEUI_EmulationPaused();
 	//if (wasPaused) FCEUI_ToggleEmulationPause();
@@ -5795,7 +6160,7 @@ int FCEU_LoadLuaCode(const char *filename, const char *arg) {
  */
 void FCEU_ReloadLuaCode()
 {
-	if (!luaScriptName)
+	if (!luaContext)
 	{
 #ifdef WIN32
 		// no script currently running, then try loading the most recent 
@@ -5815,39 +6180,34 @@ void FCEU_ReloadLuaCode()
 #endif
 	} else
 	{
-		FCEU_LoadLuaCode(luaScriptName);
+		FCEU_LoadLuaCode(luaContext->scriptName);
 	}
 }
 
 
 /**
- * Terminates a running Lua script by killing the whole Lua engine.
- *
- * Always safe to call, except from within a lua call itself (duh).
- *
+ * Terminates the current script by closing its Lua state.
+ * The other scripts keep running.
  */
-void FCEU_LuaStop() {
-
-	if (!CheckLua())
-		return;
+static void LuaStopScript() {
 
 	//already killed
 	if (!L) return;
 
 	// Since the script is exiting, we want to prevent an infinite loop.
-	// CallExitFunction() > HandleCallbackError() > FCEU_LuaStop() > CallExitFunction() ...
-	if (luaexiterrorcount > 0) {
-		luaexiterrorcount = luaexiterrorcount - 1;
+	// CallExitFunction() > HandleCallbackError() > LuaStopScript() > CallExitFunction() ...
+	if (luaContext->exitErrorCount > 0) {
+		luaContext->exitErrorCount = luaContext->exitErrorCount - 1;
 		//execute the user's shutdown callbacks
 		CallExitFunction();
 	}
 
-	luaexiterrorcount = luaexiterrorcount + 1;
+	luaContext->exitErrorCount = luaContext->exitErrorCount + 1;
 
 	//already killed (after multiple errors)
 	if (!L) return;
 
-	/*info.*/numMemHooks = 0;
+	luaContext->numMemHooks = 0;
 	for(int i = 0; i < LUAMEMHOOK_COUNT; i++)
 		CalculateMemHookRegions((LuaMemHookType)i);
 
@@ -5857,15 +6217,36 @@ void FCEU_LuaStop() {
 	CoInitialize(0);
 	#endif
 
-	if (info_onstop)
-		info_onstop(info_uid);
-
 	//lua_gc(L,LUA_GCCOLLECT,0);
 
 
 	lua_close(L); // this invokes our garbage collectors for us
-	L = NULL;
+	L = luaContext->L = NULL;
 	FCEU_LuaOnStop();
+
+	if (info_onstop && !FCEU_LuaRunning())
+		info_onstop(info_uid);
+}
+
+/**
+ * Terminates every running Lua script.
+ *
+ * Always safe to call, except from within a lua call itself (duh).
+ *
+ */
+void FCEU_LuaStop() {
+
+	if (!CheckLua())
+		return;
+
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		LuaStopScript();
+	}
+	PruneLuaContexts();
 }
 
 /**
@@ -5874,7 +6255,13 @@ void FCEU_LuaStop() {
  */
 int FCEU_LuaRunning() {
 	// FIXME: return false when no callback functions are registered.
-	return (int) (L != NULL); // should return true if callback functions are active.
+	// should return true if callback functions are active.
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (luaContexts[i]->L)
+			return 1;
+	}
+	return 0;
 }
 
 
@@ -5918,7 +6305,13 @@ uint8 FCEU_LuaReadJoypad(int which, uint8 joyl) {
  */
 int FCEU_LuaRerecordCountSkip() {
 	// FIXME: return true if (there are any active callback functions && skipRerecords)
-	return L && luaRunning && skipRerecords;
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		LuaContextInfo *info = luaContexts[i];
+		if (info->L && info->running && info->skipRerecords)
+			return 1;
+	}
+	return 0;
 }
 
 /**
@@ -5927,11 +6320,8 @@ int FCEU_LuaRerecordCountSkip() {
  *
  * Currently we only support 256x* resolutions.
  */
-void FCEU_LuaGui(uint8 *XBuf)
+static void LuaScriptGui()
 {
-	if (!L/* || !luaRunning*/)
-		return;
-
 	// First, check if we're being called by anybody
 	lua_getfield(L, LUA_REGISTRYINDEX, guiCallbackTable);
 
@@ -5940,12 +6330,7 @@ void FCEU_LuaGui(uint8 *XBuf)
 		numTries = 1000;
 		int ret = lua_pcall(L, 0, 0, 0);
 		if (ret != 0) {
-#ifdef WIN32
-			//StopSound();//StopSound(); //mbg merge 7/23/08
-			MessageBox(hAppWnd, lua_tostring(L, -1), "Lua Error in GUI function", MB_OK);
-#else
-			fprintf(stderr, "Lua error in gui.register function: %s\n", lua_tostring(L, -1));
-#endif
+			ReportGuiError(L);
 			// This is grounds for trashing the function
 			lua_pushnil(L);
 			lua_setfield(L, LUA_REGISTRYINDEX, guiCallbackTable);
@@ -5956,6 +6341,24 @@ void FCEU_LuaGui(uint8 *XBuf)
 	// And wreak the stack
 	lua_settop(L, 0);
 
+	CallLuaCallbackList(CALLBACKLIST_GUI);
+	lua_settop(L, 0);
+}
+
+void FCEU_LuaGui(uint8 *XBuf)
+{
+	if (!FCEU_LuaRunning())
+		return;
+
+	// every script draws into the same gui_data
+	for (size_t i = 0; i < luaContexts.size(); i++)
+	{
+		if (!luaContexts[i]->L)
+			continue;
+		LuaContextScope scope(luaContexts[i]);
+		LuaScriptGui();
+	}
+
 	if (gui_used == GUI_CLEAR)
 		return;
 
@@ -6013,5 +6416,5 @@ lua_State* FCEU_GetLuaState() {
 	return L;
 }
 char* FCEU_GetLuaScriptName() {
-	return luaScriptName;
+	return luaContext ? luaContext->scriptName : NULL;
 }
@@ -656,6 +656,16 @@ static DECLFR(A200x) {	/* Not correct for $2004 reads. */
 	return PPUGenLatch;
 }
 
+/* Side-effect free view of the PPU registers (no latch/flag resets). */
+static DECLFR(A200xPeek) {
+	switch (A & 7) {
+	case 2: return PPU[2] | (PPUGenLatch & 0x1F);
+	case 4: return SPRAM[PPU[3]];
+	case 7: return VRAMBuffer;
+	default: return PPUGenLatch;
+	}
+}
+
 static DECLFR(A2007) {
 	uint8 ret;
 	uint32 tmp = RefreshAddr & 0x3FFF;
@@ -1692,6 +1702,7 @@ void FCEUPPU_Power(void) {
 		ARead[x + 7] = A2007;
 		BWrite[x + 7] = B2007;
 	}
+	SetPeekHandler(0x2000, 0x3FFF, A200xPeek);
 	BWrite[0x4014] = B4014;
 }
 
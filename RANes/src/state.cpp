@@ -36,6 +36,7 @@
 #include "netplay.h"
 #include "video.h"
 #include "input.h"
+#include "writewatch.h"
 #include "zlib.h"
 #include "driver.h"
 #ifdef _S9XLUA_H
@@ -56,7 +57,9 @@
 //#include <unistd.h> //mbg merge 7/17/06 removed
 
 #include <vector>
+#include <map>
 #include <fstream>
+#include <ctime>
 
 //##RA
 #include "RA_Interface.h"
@@ -212,35 +215,136 @@ static SFORMAT *CheckS(SFORMAT *sf, uint32 tsize, char *desc)
 	return(0);
 }
 
-static bool ReadStateChunk(EMUFILE* is, SFORMAT *sf, int size)
+//Hash index over a chunk's SFORMAT table, so that loading a field doesn't mean
+//walking the whole table (and every table linked from it) with CheckS.
+//Entries are flattened in the same depth-first order CheckS searches them and
+//only the first entry for each desc is kept, so a hit is the entry CheckS
+//would have returned. Indexes are dropped whenever SFMDATA changes.
+struct SFINDEX
 {
-	SFORMAT *tmp;
-	int temp = is->ftell();
+	std::vector<uint32> keys;
+	std::vector<SFORMAT*> entries;
+	uint32 mask;
+	bool built;
 
-	while(is->ftell()<temp+size)
+	SFINDEX() : mask(0), built(false) {}
+};
+
+static std::map<SFORMAT*,SFINDEX> SFIndexes;
+static bool SFIndexEnabled = true;
+
+static uint32 SFKey(const char *desc)
+{
+	uint32 key;
+	memcpy(&key,desc,4);
+	return key;
+}
+
+static uint32 SFHash(uint32 key)
+{
+	key*=0x9E3779B1;
+	return key^(key>>15);
+}
+
+static uint32 SFCount(SFORMAT *sf)
+{
+	uint32 count=0;
+	for(;sf->v;sf++)
+		count+=(sf->s==~0)?SFCount((SFORMAT *)sf->v):1;
+	return count;
+}
+
+static void SFIndexAdd(SFINDEX &index, SFORMAT *sf)
+{
+	for(;sf->v;sf++)
+	{
+		if(sf->s==~0)		// Link to another SFORMAT structure.
+		{
+			SFIndexAdd(index,(SFORMAT *)sf->v);
+			continue;
+		}
+
+		uint32 key=SFKey(sf->desc);
+		uint32 i=SFHash(key)&index.mask;
+		while(index.entries[i] && index.keys[i]!=key)
+			i=(i+1)&index.mask;
+		if(!index.entries[i])		// an earlier entry keeps the slot
+		{
+			index.keys[i]=key;
+			index.entries[i]=sf;
+		}
+	}
+}
+
+static SFINDEX &SFGetIndex(SFORMAT *sf)
+{
+	SFINDEX &index=SFIndexes[sf];
+	if(!index.built)
+	{
+		uint32 count=SFCount(sf);
+		uint32 slots=16;
+		while(slots<count*2)
+			slots<<=1;
+		index.mask=slots-1;
+		index.keys.assign(slots,0);
+		index.entries.assign(slots,(SFORMAT *)0);
+		SFIndexAdd(index,sf);
+		index.built=true;
+	}
+	return index;
+}
+
+static SFORMAT *FindS(SFINDEX &index, SFORMAT *sf, uint32 tsize, char *desc)
+{
+	uint32 key=SFKey(desc);
+	uint32 i=SFHash(key)&index.mask;
+	while(SFORMAT *tmp=index.entries[i])
+	{
+		if(index.keys[i]==key)
+		{
+			if(tsize==(tmp->s&(~FCEUSTATE_FLAGS)) && !memcmp(desc,tmp->desc,4))
+				return(tmp);
+			//a size mismatch inside a linked table lets CheckS carry on
+			//searching the parent, so leave that rare case to it
+			return(CheckS(sf,tsize,desc));
+		}
+		i=(i+1)&index.mask;
+	}
+	return(0);
+}
+
+//Applies one chunk straight out of the loaded state buffer.
+static bool ReadStateChunk(uint8 *data, uint32 size, SFORMAT *sf)
+{
+	SFINDEX *index=SFIndexEnabled?&SFGetIndex(sf):0;
+	uint8 *end=data+size;
+
+	while(data<end)
 	{
-		uint32 tsize;
-		char toa[4];
-		if(is->fread(toa,4)<4)
+		if(end-data<8)
 			return false;
 
-		read32le(&tsize,is);
+		char *desc=(char *)data;
+		uint32 tsize=FCEU_de32lsb(data+4);
+		data+=8;
+		if(tsize>(uint32)(end-data))
+			return false;
 
-		if((tmp=CheckS(sf,tsize,toa)))
+		SFORMAT *tmp=index?FindS(*index,sf,tsize,desc):CheckS(sf,tsize,desc);
+		if(tmp)
 		{
 			if(tmp->s&FCEUSTATE_INDIRECT)
-				is->fread(*(char **)tmp->v,tmp->s&(~FCEUSTATE_FLAGS));
+				memcpy(*(char **)tmp->v,data,tsize);
 			else
-				is->fread((char *)tmp->v,tmp->s&(~FCEUSTATE_FLAGS));
+				memcpy(tmp->v,data,tsize);
 
 #ifndef LSB_FIRST
 			if(tmp->s&RLSB)
 				FlipByteOrder((uint8*)tmp->v,tmp->s&(~FCEUSTATE_FLAGS));
 #endif
 		}
-		else
-			is->fseek(tsize,SEEK_CUR);
-	} // while(...)
+		data+=tsize;
+	}
 	return true;
 }
 
@@ -248,10 +352,16 @@ static int read_sfcpuc=0, read_snd=0;
 
 void FCEUD_BlitScreen(uint8 *XBuf); //mbg merge 7/17/06 YUCKY had to add
 void UpdateFCEUWindow(void);  //mbg merge 7/17/06 YUCKY had to add
-static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
+//Walks the chunks of a state that is already sitting in memory, starting at
+//the stream's current position. Chunk payloads are used in place rather than
+//being fread field by field.
+static bool ReadStateChunks(EMUFILE_MEMORY* is, int32 totalsize)
 {
 	int t;
 	uint32 size;
+	uint8 *buf=is->buf();
+	int pos=is->ftell();
+	int len=is->size();
 	bool ret=true;
 	bool warned=false;
 
@@ -265,32 +375,41 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 
 	while(totalsize > 0)
 	{
-		t=is->fgetc();
-		if(t==EOF) break;
-		if(!read32le(&size,is)) break;
+		if(len-pos<5) break;
+		t=buf[pos];
+		size=FCEU_de32lsb(buf+pos+1);
+		pos+=5;
 		totalsize -= size + 5;
+		if(size>(uint32)(len-pos))
+		{
+			ret=false;
+			break;
+		}
+		uint8 *data=buf+pos;
 
 		switch(t)
 		{
-		case 1:if(!ReadStateChunk(is,SFCPU,size)) ret=false;break;
-		case 3:if(!ReadStateChunk(is,FCEUPPU_STATEINFO,size)) ret=false;break;
-		case 31:if(!ReadStateChunk(is,FCEU_NEWPPU_STATEINFO,size)) ret=false;break;
-		case 4:if(!ReadStateChunk(is,FCEUCTRL_STATEINFO,size)) ret=false;break;
+		case 1:if(!ReadStateChunk(data,size,SFCPU)) ret=false;break;
+		case 3:if(!ReadStateChunk(data,size,FCEUPPU_STATEINFO)) ret=false;break;
+		case 31:if(!ReadStateChunk(data,size,FCEU_NEWPPU_STATEINFO)) ret=false;break;
+		case 4:if(!ReadStateChunk(data,size,FCEUCTRL_STATEINFO)) ret=false;break;
 		case 7:
+			is->fseek(pos,SEEK_SET);
 			if(!FCEUMOV_ReadState(is,size)) {
 				//allow this to fail in old-format savestates.
 				if(!FCEU_state_loading_old_format)
 					ret=false;
 			}
+			buf=is->buf();
 			break;
 		case 0x10:
-			if(!ReadStateChunk(is,SFMDATA,size)) 
+			if(!ReadStateChunk(data,size,SFMDATA)) 
 				ret=false; 
 			break;
 
 			// now it gets hackier:
 		case 5:
-			if(!ReadStateChunk(is,FCEUSND_STATEINFO,size))
+			if(!ReadStateChunk(data,size,FCEUSND_STATEINFO))
 				ret=false;
 			else
 				read_snd=1;
@@ -298,35 +417,27 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 		case 6:
 			if(FCEUMOV_Mode(MOVIEMODE_PLAY|MOVIEMODE_RECORD|MOVIEMODE_FINISHED))
 			{
-				if(!ReadStateChunk(is,FCEUMOV_STATEINFO,size)) ret=false;
-			}
-			else
-			{
-				is->fseek(size,SEEK_CUR);
+				if(!ReadStateChunk(data,size,FCEUMOV_STATEINFO)) ret=false;
 			}
 			break;
 		case 8:
 			// load back buffer
 			{
 				extern uint8 *XBackBuf;
-				if(is->fread((char*)XBackBuf,size) != size)
-					ret = false;
+				memcpy(XBackBuf,data,size);
 
 				//MBG TODO - can this be moved to a better place?
 				//does it even make sense, displaying XBuf when its XBackBuf we just loaded?
 #ifdef WIN32
-				else
-				{
-					FCEUD_BlitScreen(XBuf);
-					UpdateFCEUWindow();
-				}
+				FCEUD_BlitScreen(XBuf);
+				UpdateFCEUWindow();
 #endif
 
 			}
 			break;
 		case 2:
 			{
-				if(!ReadStateChunk(is,SFCPUC,size))
+				if(!ReadStateChunk(data,size,SFCPUC))
 					ret=false;
 				else
 					read_sfcpuc=1;
@@ -341,9 +452,11 @@ static bool ReadStateChunks(EMUFILE* is, int32 totalsize)
 				warned=true;
 			}
 			//if(fseek(st,size,SEEK_CUR)<0) goto endo;break;
-			is->fseek(size,SEEK_CUR);
+			break;
 		}
+		pos+=size;
 	}
+	is->fseek(pos,SEEK_SET);
 	//endo:
 
 	//mbg 6/16/08 - wtf
@@ -577,6 +690,7 @@ int FCEUSS_LoadFP_old(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	{
 		FCEUMOV_PreLoad();
 	}
+	FCEU_WriteWatchInvalidate();
     is->fread((char*)&header,16);
 	if(memcmp(header,"FCS",3))
 	{
@@ -594,7 +708,14 @@ int FCEUSS_LoadFP_old(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	//{
 	//	scan_chunks=1;
 	//}
-	x=ReadStateChunks(is,*(uint32*)(header+4));
+	//pull the rest of the state into memory so the chunks can be parsed in place
+	int totalsize=*(uint32*)(header+4);
+	int avail=is->size()-is->ftell();
+	if(totalsize<0 || totalsize>avail)
+		totalsize=avail;
+	EMUFILE_MEMORY ms(totalsize);
+	ms.set_len(is->fread(ms.buf(),totalsize));
+	x=ReadStateChunks(&ms,totalsize);
 	//if(params == SSLOADPARAM_DUMMY)
 	//{
 	//	scan_chunks=0;
@@ -689,6 +810,7 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 	}
 
 	FCEUMOV_PreLoad();
+	FCEU_WriteWatchInvalidate();
 
 	bool x = (ReadStateChunks(&memory_savestate, totalsize) != 0);
 
@@ -715,6 +837,11 @@ bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params)
 }
 
 
+void FCEUSS_SetIndexEnabled(bool enabled)
+{
+	SFIndexEnabled=enabled;
+}
+
 bool FCEUSS_Load(const char *fname, bool display_message)
 {
 	EMUFILE* st;
@@ -860,10 +987,13 @@ void ResetExState(void (*PreSave)(void), void (*PostSave)(void))
 	}
 	// adelikat, 3/14/09:  had to add this to clear out the size parameter.  NROM(mapper 0) games were having savestate crashes if loaded after a non NROM game	because the size variable was carrying over and causing savestates to save too much data
 	SFMDATA[0].s = 0;
+	// a board that never calls AddExState (an unsupported mapper) would otherwise save the previous game's freed chunks
+	SFMDATA[0].v = 0;
 
 	SPreSave = PreSave;
 	SPostSave = PostSave;
 	SFEXINDEX=0;
+	SFIndexes.clear();
 }
 
 void AddExState(void *v, uint32 s, int type, char *desc)
@@ -913,6 +1043,7 @@ void AddExState(void *v, uint32 s, int type, char *desc)
 		}
 	}
 	SFMDATA[SFEXINDEX].v=0;		// End marker.
+	SFIndexes.erase(SFMDATA);
 }
 
 void FCEUI_SelectStateNext(int n)
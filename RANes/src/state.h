@@ -32,6 +32,9 @@ bool FCEUSS_SaveMS(EMUFILE* outstream, int compressionLevel);
 
 bool FCEUSS_LoadFP(EMUFILE* is, ENUM_SSLOADPARAMS params);
 
+//on by default; off falls back to walking every SFORMAT table for each chunk
+void FCEUSS_SetIndexEnabled(bool enabled);
+
 extern int CurrentState;
 void FCEUSS_CheckStates(void);
 
@@ -0,0 +1,132 @@
+/* FCE Ultra - NES/Famicom Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "types.h"
+#include "writewatch.h"
+
+#include <cstring>
+#include <vector>
+
+//map bits. Mirrors of internal RAM only carry WW_WATCHED; WW_PENDING is kept
+//on the folded address while it has an entry in the pending list.
+#define WW_WATCHED 1
+#define WW_PENDING 2
+
+uint32 FCEU_WriteWatchCount = 0;
+uint8 FCEU_WriteWatchMap[0x10000];
+
+static uint16 refs[0x10000];
+static uint16 slot[0x10000];
+static std::vector<WATCHEDWRITE> pending, published;
+static bool pendingInvalid = false, publishedInvalid = false;
+static uint32 frames = 0;
+
+static INLINE uint32 FoldMirrors(uint32 A) {
+	return (A < 0x2000) ? (A & 0x7FF) : A;
+}
+
+static void SetWatched(uint32 A, bool watched) {
+	int mirrors = (A < 0x800) ? 4 : 1;
+	for (int m = 0; m < mirrors; m++) {
+		if (watched)
+			FCEU_WriteWatchMap[A + m * 0x800] |= WW_WATCHED;
+		else
+			FCEU_WriteWatchMap[A + m * 0x800] &= ~WW_WATCHED;
+	}
+}
+
+void FCEU_WriteWatchAdd(uint32 start, uint32 end) {
+	if (end > 0xFFFF)
+		end = 0xFFFF;
+	for (uint32 x = start; x <= end; x++) {
+		uint32 A = FoldMirrors(x);
+		if (refs[A] == 0xFFFF)
+			continue;
+		if (refs[A]++ == 0) {
+			SetWatched(A, true);
+			FCEU_WriteWatchCount++;
+		}
+	}
+	//one entry per watched address and frame at most, so this is the only growth
+	pending.reserve(FCEU_WriteWatchCount);
+	published.reserve(FCEU_WriteWatchCount);
+}
+
+void FCEU_WriteWatchRemove(uint32 start, uint32 end) {
+	if (end > 0xFFFF)
+		end = 0xFFFF;
+	for (uint32 x = start; x <= end; x++) {
+		uint32 A = FoldMirrors(x);
+		if (refs[A] && --refs[A] == 0) {
+			SetWatched(A, false);
+			FCEU_WriteWatchCount--;
+		}
+	}
+}
+
+void FCEU_WriteWatchReset(void) {
+	memset(FCEU_WriteWatchMap, 0, sizeof(FCEU_WriteWatchMap));
+	memset(refs, 0, sizeof(refs));
+	FCEU_WriteWatchCount = 0;
+	pending.clear();
+	published.clear();
+	pendingInvalid = publishedInvalid = false;
+}
+
+void FCEU_WriteWatchRecord(uint32 A, uint8 oldval, uint8 newval) {
+	A = FoldMirrors(A);
+	uint8 flags = FCEU_WriteWatchMap[A];
+	if (!(flags & WW_WATCHED))
+		return;
+
+	//only the first old value and the last new value of the frame are kept
+	if (flags & WW_PENDING) {
+		pending[slot[A]].newval = newval;
+		return;
+	}
+
+	FCEU_WriteWatchMap[A] = flags | WW_PENDING;
+	slot[A] = (uint16)pending.size();
+	WATCHEDWRITE w = { (uint16)A, oldval, newval };
+	pending.push_back(w);
+}
+
+void FCEU_WriteWatchFrameEnd(void) {
+	for (size_t i = 0; i < pending.size(); i++)
+		FCEU_WriteWatchMap[pending[i].addr] &= ~WW_PENDING;
+	published.swap(pending);
+	pending.clear();
+	publishedInvalid = pendingInvalid;
+	pendingInvalid = false;
+	frames++;
+}
+
+void FCEU_WriteWatchInvalidate(void) {
+	pendingInvalid = true;
+}
+
+const WATCHEDWRITE* FCEU_WriteWatchGetWrites(uint32 *count, bool *invalidated) {
+	if (count)
+		*count = (uint32)published.size();
+	if (invalidated)
+		*invalidated = publishedInvalid;
+	return published.empty() ? NULL : &published[0];
+}
+
+uint32 FCEU_WriteWatchFrames(void) {
+	return frames;
+}
@@ -0,0 +1,60 @@
+#ifndef _WRITEWATCH_H
+#define _WRITEWATCH_H
+
+//Write watch: tools register the CPU addresses they care about and get back,
+//once per frame, the list of watched addresses that were written along with
+//their value before the first write and after the last one. Achievement
+//evaluation and the memory tools can use it to skip conditions whose inputs
+//did not change instead of re-reading every address every frame.
+//
+//The Windows memory watch (drivers/win/memwatch.cpp) uses it to redraw only
+//the rows whose bytes were written. Achievement conditions are evaluated
+//inside the RA_Integration DLL, which reads memory through the bank readers
+//installed in drivers/win/window.cpp and has no way to take this list; once it
+//does, the list should be handed to it next to RA_DoAchievementsFrame() in
+//FCEUI_Emulate, which runs right after FCEU_WriteWatchFrameEnd.
+//
+//Internal RAM mirrors are folded together: watching $0800 watches $0000, and
+//writes to any mirror are reported at their $0000-$07FF address.
+
+struct WATCHEDWRITE {
+	uint16 addr;
+	uint8 oldval;
+	uint8 newval;
+};
+
+//Registrations are reference counted, so several tools can watch the same
+//range and remove their own watches independently.
+void FCEU_WriteWatchAdd(uint32 start, uint32 end);
+void FCEU_WriteWatchRemove(uint32 start, uint32 end);
+void FCEU_WriteWatchReset(void);
+
+//Called by FCEUI_Emulate once the frame has been run. Everything recorded since
+//the previous call becomes the published list.
+void FCEU_WriteWatchFrameEnd(void);
+
+//Memory changed without going through a write (power on, savestate load).
+//The next published list will be flagged as invalidated.
+void FCEU_WriteWatchInvalidate(void);
+
+//The writes published by the last FCEU_WriteWatchFrameEnd. When *invalidated
+//is set, the list is incomplete and every watched address has to be re-read.
+const WATCHEDWRITE* FCEU_WriteWatchGetWrites(uint32 *count, bool *invalidated);
+
+//Number of FCEU_WriteWatchFrameEnd calls so far. A tool that does not look at
+//the list every frame compares this with the value from its last look, and
+//re-reads everything when more than one frame went by.
+uint32 FCEU_WriteWatchFrames(void);
+
+//Core side. The map is nonzero for watched addresses (mirrors included) and
+//FCEU_WriteWatchCount is zero when nothing is watched at all, so a write only
+//pays for one global load and branch unless someone is watching.
+extern uint32 FCEU_WriteWatchCount;
+extern uint8 FCEU_WriteWatchMap[0x10000];
+void FCEU_WriteWatchRecord(uint32 A, uint8 oldval, uint8 newval);
+
+static INLINE bool FCEU_WriteWatched(uint32 A) {
+	return FCEU_WriteWatchCount && FCEU_WriteWatchMap[A];
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "fceu.h"
 #include "debug.h"
 #include "sound.h"
+#include "writewatch.h"
 #ifdef _S9XLUA_H
 #include "fceulua.h"
 #endif
@@ -48,10 +49,21 @@ static INLINE uint8 RdMem(unsigned int A)
  return(_DB=ARead[A](A));
 }
 
+//write through the bus while someone is watching A
+static void WrWatched(unsigned int A, uint8 V)
+{
+	uint8 old=FCEU_PeekMem(A);
+	BWrite[A](A,V);
+	FCEU_WriteWatchRecord(A,old,FCEU_PeekMem(A));
+}
+
 //normal memory write
 static INLINE void WrMem(unsigned int A, uint8 V)
 {
-	BWrite[A](A,V);
+	if(FCEU_WriteWatched(A))
+		WrWatched(A,V);
+	else
+		BWrite[A](A,V);
 	#ifdef _S9XLUA_H
 	CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
 	#endif
@@ -66,6 +78,8 @@ static INLINE uint8 RdRAM(unsigned int A)
 
 static INLINE void WrRAM(unsigned int A, uint8 V)
 {
+	if(FCEU_WriteWatched(A))
+		FCEU_WriteWatchRecord(A,RAM[A],V);
 	RAM[A]=V;
 	#ifdef _S9XLUA_H
 	CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
@@ -81,7 +95,10 @@ uint8 X6502_DMR(uint32 A)
 void X6502_DMW(uint32 A, uint8 V)
 {
  ADDCYC(1);
- BWrite[A](A,V);
+ if(FCEU_WriteWatched(A))
+  WrWatched(A,V);
+ else
+  BWrite[A](A,V);
  #ifdef _S9XLUA_H
  CallRegisteredLuaMemHook(A, 1, V, LUAMEMHOOK_WRITE);
  #endif
@@ -529,7 +529,7 @@ SetGameFileNameBuf(
 		}
 		else if (bSetCueMark) //bSetCueMarkTRUEɂČĂ񂾎BROMI[vj[\̂ݎgpB[CD][Hu]}[NtBv2.24
 		{
-			if (strstr(strToLower(extractFileExt(buf)), "cue")) //gqcueȂB
+			if (CDIF_IsImageFile(buf)) //gqcue(܂iso,chd)ȂB
 			{	//CUEt@C̏ꍇ
 				strcpy(buf, pGameFileNameBuf);
 				strcpy(pGameFileNameBuf, "[CD] ");
@@ -4947,6 +4947,7 @@ APP_Init(
 	MSG					msg;
 	FILE*				fp;
 	char				softVersion[5] = "0.00"; //KitaoǉBo[WB5oCg(4)ŒB
+	char				cdBenchReport[1024]; //CDC[WETOCf[^x[X̃x`}[N
 
 #if defined(__GNUC__)
 	puts("          Compiled with GCC version " __VERSION__);
@@ -5489,6 +5490,40 @@ APP_Init(
 		fclose(fp);
 	}
 
+	//[/cdbench O C[W]̏ꍇACDR}hOfBXNC[WōĐăV[NԂƓ]xvAcd_bench.txt֒ǋLďIB
+	if ((argc == 4)&&(_stricmp(argv[1],"/cdbench") == 0))
+	{
+		CDIF_Benchmark(argv[2], argv[3], cdBenchReport, sizeof(cdBenchReport)); //sꍇRcdBenchReportɓ
+		strcpy(fileName, _AppPath);
+		strcat(fileName, "cd_bench.txt");
+		if ((fp = fopen(fileName, "a")) != NULL)
+		{
+			fputs(cdBenchReport, fp);
+			fclose(fp);
+		}
+		return FALSE;
+	}
+	//[/tocbench]̏ꍇAÑfBXN(TOCf[^x[X̏ƍƃpb`)ɂ鎞ԂvAtoc_bench.txt֒ǋLďIB
+	if ((argc == 2)&&(_stricmp(argv[1],"/tocbench") == 0))
+	{
+		TOCDB_Benchmark(cdBenchReport, sizeof(cdBenchReport));
+		strcpy(fileName, _AppPath);
+		strcat(fileName, "toc_bench.txt");
+		if ((fp = fopen(fileName, "a")) != NULL)
+		{
+			fputs(cdBenchReport, fp);
+			fclose(fp);
+		}
+		return FALSE;
+	}
+	//[/cdlog O C[W]̏ꍇACDR}hO֋L^ȂC[W(܂cue)NB
+	if ((argc == 4)&&(_stricmp(argv[1],"/cdlog") == 0))
+	{
+		CDIF_SetCommandLog(argv[2]);
+		argv[1] = argv[3];
+		argc = 2;
+	}
+
 	if (argc > 2)
 	{
 		MessageBox(hWnd,"Error: too many arguments.    ", "Ootake", MB_OK);
@@ -5568,7 +5603,7 @@ APP_Init(
 			else
 			{
 				strcpy(fileName, _RecentRom[1]); //_RecentRom[1]͏Ȃ悤ɂ邽fileNameɃRs[
-				if (strstr(strToLower(extractFileExt(fileName)), "cue")) //CUEt@C̏ꍇACDQ[ƂċNBv2.24ǉ
+				if (CDIF_IsImageFile(fileName)) //CUEt@C(܂ISO,CHD̃fBXNC[W)̏ꍇACDQ[ƂċNBv2.24ǉ
 				{
 					_bCDGame = TRUE;
 					strcpy(_CueFilePathName, _RecentRom[1]);
@@ -5618,7 +5653,7 @@ APP_Init(
 				MessageBox(hWnd,"File not found.    ", "Ootake", MB_OK);
 				return FALSE;
 			}
-			if (strstr(extractFileExt(fileName), "cue")) //CUEt@C̏ꍇACDQ[ƂċNBv2.33ǉ
+			if (CDIF_IsImageFile(fileName)) //CUEt@C(܂ISO,CHD̃fBXNC[W)̏ꍇACDQ[ƂċNBv2.33ǉ
 			{
 				_bCDGame = TRUE;
 				strcpy(_CueFilePathName, argv[1]);
@@ -6040,7 +6075,7 @@ restore_setting(
 			CONFIG_Set("[APP DEVICE] VideoSpeedUp Mode", &_FastForwarding, sizeof(_FastForwarding));
 		}
 		//bLNĂꍇAftHg̃VXeJ[hgpɖ߂Bv2.07
-		if (strcmp(TOCDB_GetGameTitle(),"Juuouki (J)") == 0) //bLHuJ[h̑CDQ[̎ɖ߂_bCDGameTRUEǂ̓`FbNȂB
+		if (TOCDB_GetGameID() == TOCDB_JUUOUKI_J) //bLHuJ[h̑CDQ[̎ɖ߂_bCDGameTRUEǂ̓`FbNȂB
 			_OtherSysCard = 0;
 	}
 	VDC_SetOverClock(_OverClockTypeR); //Xe[g[hŕςĂꍇɖ߂
@@ -6121,7 +6156,7 @@ app_reset_sub(
 		return_special_setting();
 		//W[t@CΓǂݍ
 		if ((_OtherSysCard == 0)|| //Ŝ߁AZbg(CDւ)́AftHgVXeJ[ĥ݃W[LɂB
-			((_OtherSysCard == 1)&&(_bCDGame)&&(strcmp(TOCDB_GetGameTitle(),"Juuouki (J)") == 0))) //bL̏ꍇ̓W[LɁBv2.07
+			((_OtherSysCard == 1)&&(_bCDGame)&&(TOCDB_GetGameID() == TOCDB_JUUOUKI_J))) //bL̏ꍇ̓W[LɁBv2.07
 				load_resume();
 		else
 			_bResumeMode = FALSE;
@@ -6610,7 +6645,7 @@ recent_sub(
 		end_playrecord(); end_recording(); save_resume(); save_bram();
 
 		strcpy(fileName, _RecentRom[n]); //_RecentRom[1]͏Ȃ悤ɂ邽fileNameɃRs[
-		if (strstr(strToLower(extractFileExt(fileName)), "cue")) //CUEt@C̏ꍇACDQ[ƂċNBv2.24ǉ
+		if (CDIF_IsImageFile(fileName)) //CUEt@C(܂ISO,CHD̃fBXNC[W)̏ꍇACDQ[ƂċNBv2.24ǉ
 		{
 			strcpy(_CueFilePathName, _RecentRom[n]);
 			_bCueFile = TRUE; //CUEt@CL
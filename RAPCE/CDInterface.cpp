@@ -43,7 +43,10 @@ Copyright(C)2006-2011 Kitao Nakamura.
 ******************************************************************************/
 #define _CRT_SECURE_NO_DEPRECATE
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>				// offsetof(structName, memberName)
+#include <ctype.h>
+#include "zlib.h"
 #include "CDInterface.h"
 #include "SCSIDEFS.h"
 #include "WNASPI32.h"
@@ -151,6 +154,116 @@ static BYTE*					_pCDDAReadBuf; //Kitao
 
 static BOOL						_bBadInstalled; //cueNۂɁAÂOotakeŃbsO߂̕sꍇTRUEɁBv2.31
 
+//fBXNC[W(CUE/BIN,ISO,CHD)璼ړǂݍޏꍇp
+#define IMAGE_MAXFILES			100
+#define IMAGE_BLOCKSECTORS		32		//ǂ݃LbVPubÑZN^[Bvalid̃rbgƍ킹B
+#define IMAGE_CACHEBLOCKS		16
+#define IMAGE_READAHEAD			4		//AANZXƉyĐɐǂ݂ubN
+#define IMAGE_RAWSIZE			2448	//LbV̂PZN^[̑傫(2352+Tu`l96)
+#define IMAGE_BENCH_MAXWAIT		10		//x`}[NɃR}hԂő҂ő厞(~b)
+
+#define CHD_HUNK_NONE			0		//ǂ߂ȂnN(蓖,eCHDQ)
+#define CHD_HUNK_RAW			1		//񈳏k
+#define CHD_HUNK_CDZL			2		//cdzl(zlib)ňk
+#define CHD_CODEC_CDZL			0x63647A6C	//'cdzl'
+#define CHD_COMP_NONE			4		//k}bv̈k^CvB0`3̓wb_̈k[0]`[3]B
+#define CHD_COMP_SELF			5
+#define CHD_COMP_PARENT			6
+#define CHD_COMP_RLE_SMALL		7
+#define CHD_COMP_RLE_LARGE		8
+#define CHD_COMP_SELF_0			9
+#define CHD_COMP_SELF_1			10
+#define CHD_COMP_PARENT_SELF	11
+#define CHD_COMP_PARENT_0		12
+#define CHD_COMP_PARENT_1		13
+#define CHD_HUFF_CODES			16
+#define CHD_HUFF_MAXBITS		8
+
+typedef struct
+{
+	HANDLE		hFile;
+	Uint64		size;
+	Uint64		dataStart;	//WAVȄꍇ"data"`N̐擪
+	Uint64		dataSize;
+} ImageFile;
+
+typedef struct
+{
+	Sint32		file;		//_ImageFile[]̃CfbNX
+	Uint64		offset;		//INDEX 01̃t@CʒuBCHD̏ꍇ̓t[ԍB
+	Uint32		nFrames;	//INDEX 01ǂݏoZN^[
+	Uint32		sectorSize;	//2048,2336,2352,2448
+	Uint32		dataOffset;	//ZN^[̃[U[f[^̈ʒuBMODE1/2352=16,MODE2/2352=24
+	BOOL		bSwap;		//yf[^rbOGfBȀꍇTRUE(CHD,MOTOROLA)
+	HANDLE		hMap;
+	Uint8*		pView;		//MapViewOfFile()̖߂l
+	Uint8*		pData;		//pViewINDEX 01̈ʒuB}bvĂȂꍇNULLB
+} ImageTrack;
+
+typedef struct
+{
+	Uint32		type;		//CHD_HUNK_*
+	Uint32		length;		//t@C̒(k)
+	Uint64		offset;		//t@C̈ʒu
+} ChdHunk;
+
+typedef struct
+{
+	z_stream	zs;
+	BOOL		bInit;		//inflateInit2()ς݂ȂTRUE
+	Sint32		hunk;		//pHunkɓWJĂnNB-1=Ȃ
+	Uint8*		pComp;		//t@Cǂ񂾈kf[^
+	Uint8*		pWork;		//WJCf[^(2352~t[)ƃTu`l(96~t[)
+	Uint8*		pHunk;		//2448oCg̃t[ɕגnN
+} ChdInflater;
+
+typedef struct
+{
+	const Uint8*	p;
+	Uint32			size;
+	Uint32			bit;	//ɓǂރrbgʒu(ʃrbg)
+} ChdBits;
+
+typedef struct
+{
+	Sint32		block;		//lba / IMAGE_BLOCKSECTORSB-1=
+	Uint32		valid;		//ǂݍ߂ZN^[̃rbg
+	DWORD		used;		//LRUp
+	Uint8		buf[IMAGE_BLOCKSECTORS * IMAGE_RAWSIZE];
+} ImageBlock;
+
+typedef struct
+{
+	DWORD		time;
+	Uint32		command;
+	Uint32		lba;
+	Uint32		nSectors;
+} CdLogEntry;
+
+static BOOL						_bImage = FALSE; //fBXNC[WJĂꍇTRUE
+static ImageFile				_ImageFile[IMAGE_MAXFILES];
+static Sint32					_nImageFiles;
+static ImageTrack				_ImageTrack[101]; // [0] ͎gȂ
+static ChdHunk*					_pChdMap = NULL; //CHD̃nN}bvBNULLȂCHDł͂ȂB
+static Uint32					_ChdHunkBytes;
+static Uint32					_ChdNumHunks;
+static ChdInflater				_ChdInflater[2]; //[0]=CDXbh(ƃx`}[N)pC[1]=ǂ݃Xbhp
+static ImageBlock*				_pImageCache = NULL;
+static DWORD					_ImageCacheClock;
+static ImageBlock				_ImageLoadBlock[2]; //[0]=CDXbh(ƃx`}[N)pC[1]=ǂ݃Xbhp
+static Uint8					_ImageStage[2][IMAGE_BLOCKSECTORS * IMAGE_RAWSIZE];
+static CRITICAL_SECTION			_ImageLock;
+static HANDLE					_hPrefetchEvent = NULL;
+static HANDLE					_hPrefetchThread = INVALID_HANDLE_VALUE;
+static volatile BOOL			_bPrefetchExit;
+static volatile Uint32			_PrefetchLba;
+static volatile Uint32			_PrefetchBlocks;
+static BOOL						_bReadAhead = TRUE;
+static Uint32					_LastEndLba; //Oǂݍ񂾍ŏIZN^[+1BAANZX̔pB
+
+static FILE*					_fpCommandLog = NULL; //CDR}hȌo͐
+static DWORD					_CommandLogTime;
+
 
 //KitaoǉB_CdArgNA
 static void
@@ -492,152 +605,1581 @@ read_toc()
 		if (!execute_scsi_command(pTOC, 0x400, ha, tg, lun, cdb, sizeof(cdb)))
 			continue;
 
-		_LastTrack = (Uint32)pTOC[3];
+		_LastTrack = (Uint32)pTOC[3];
+
+		for (j = 1; j <= _LastTrack+1; j++)
+		{
+			pLBA = &pTOC[4+(j-1)*8+4];
+			_TrackInfo[j].lba = (pLBA[0]<<24) + (pLBA[1]<<16) + (pLBA[2]<<8) + pLBA[3];
+			_TrackInfo[j].bAudio = ((pTOC[4+(j-1)*8+1] & 0x4) == 0) ? TRUE : FALSE;
+//			printf("track %d\n", j+1);
+//			printf("LBA = %d\n", _TrackInfo[j+1].lba);
+//			printf("bAudio = %d\n", _TrackInfo[j+1].bAudio);
+		}
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+//KitaoǉBCXg[Ootakeo[WǂݍŐɃbsOoĂt@Cǂ𔻒fBCDROM.cpppBv2.31
+BOOL //o[W̋LڂȂꍇFALSEԂBo[WLڂ̗Lɂ炸A_bBadInstalledݒ肳B
+CDIF_SetBadInstalled(
+	FILE*	fp)
+{
+	char	buf[256];
+	char	ver[4];
+	int		v;
+
+	_bBadInstalled = FALSE;
+	strcpy(buf, "");
+	if (fgets(buf, 255, fp))
+	{
+		if (strstr(buf,"REM ver"))
+		{
+			ver[0] = buf[7];
+			ver[1] = buf[8];
+			ver[2] = buf[9];
+			ver[3] = 0;
+			v = atoi(ver);
+			if (v < 232) //v2.32̏ꍇAygbNP̃bsOsB
+				_bBadInstalled = TRUE;
+			if (v == 250) //v2.50̏ꍇAygbNPCUEt@C̃bsOsB
+				_bBadInstalled = TRUE;
+			return TRUE;
+		}
+		else //o[WLڂȂꍇ
+			_bBadInstalled = TRUE; //ygbNP̃bsOs\B
+	}
+	return FALSE;
+}
+
+//KitaoǉBCuet@CTOC쐬Bv2.24
+static BOOL
+read_toc_cue()
+{
+	FILE*	fp;
+	FILE*	fp2;
+	char	buf[256];
+	char	buf2[256];
+	char*	r;
+	Uint32	tn;	
+	Uint32	lba;
+	char*	pi;
+	char*	pi2;
+	char	installPath[MAX_PATH+1];
+	char	fn[MAX_PATH+1];
+	DWORD	size;
+
+	fp = fopen(APP_GetCueFilePathName(), "r");
+	if (fp == NULL)	return FALSE;
+
+	SetCursor(LoadCursor(NULL, IDC_WAIT)); //gbNƎԂ|̂ŁAJ[\vɁB
+
+	strcpy(installPath, APP_GetCueFilePathName());
+	pi = strrchr(installPath, '\\');
+	if (pi != NULL)	*(pi+1)=0; //installPath̃t@CJbg
+
+	tn = 1; //gbNio[
+	lba = 0;
+
+	//v2.31ǉBCXg[Ootakeo[WǂݍŐɃbsOoĂt@Cǂ𔻒fB
+	if (!CDIF_SetBadInstalled(fp))
+	{	//o[WLڂȂꍇ(v2.30ȑOcue)At@C擪JȂB
+		fclose(fp);
+		fp = fopen(APP_GetCueFilePathName(), "r");
+	}
+
+	while (TRUE)
+	{
+		strcpy(buf, "");
+		while (strstr(buf,"FILE ") == NULL)
+		{
+			r = fgets(buf, 255, fp);
+			if (r == NULL) break;
+		}
+		if (r == NULL)
+			 break; //"FILE"ȂȂI
+		pi = strstr(buf,"FILE ") + 5;
+		if (*pi == '"') pi++;
+		strcpy(buf2, pi);
+		pi2 = strstr(buf2,".");
+		if (pi2 != NULL)
+		{
+			pi2 += 4;
+			strcpy(buf, pi2);
+			*pi2 = 0; //buf2̓et@Ĉ݂ɂȂ
+		}
+		strcpy(fn, installPath);
+		strcat(fn, buf2);
+		fp2 = fopen(fn, "rb");
+		if (fp2 == NULL) break;
+		fseek(fp2, 0, SEEK_END);
+		size = ftell(fp2);
+		fclose(fp2);
+		r = fgets(buf2, 255, fp); //"TRACK"̍sǂݔ΂
+		r = fgets(buf2, 255, fp);
+		if (r != NULL)
+			if (strstr(buf2,"PREGAP") != NULL)
+				lba += 150; //vMbvԂ𑫂
+		_TrackInfo[tn].lba = lba;
+		if (strstr(buf,"BINARY") != NULL) //isȍꍇ
+		{
+			_TrackInfo[tn].bAudio = FALSE;
+			lba += size / 2048;
+		}
+		else //wav̏ꍇ
+		{
+			_TrackInfo[tn].bAudio = TRUE;
+			lba += (size - 44) / 2352; //44=WAVEwb_Ԃ
+		}
+		tn++;
+	}
+	fclose(fp);
+
+	//[hAEgݒ
+	_TrackInfo[tn].bAudio = FALSE;
+	_TrackInfo[tn].lba = lba;
+	_LastTrack = tn - 1;
+
+	SetCursor(LoadCursor(NULL, IDC_ARROW)); //J[\ɖ߂
+
+	//PRINTF("TrackInfo Test = %X", _TrackInfo[10].lba);
+
+	if (_LastTrack == 0)
+		return FALSE;
+	else
+		return TRUE;
+}
+
+
+/*-----------------------------------------------------------------------------
+	[fBXNC[W]
+		CUE/BIN(WAVE),ISO,CHD(v5,񈳏kcdzl)̃C[Wt@CCDhCȗ
+		ǂݍ݂܂Bf[^gbN̓}bvAȊÕgbN͐ǂ
+		LbVʂēǂݍ݂܂Bǂ݂read_sector(READ,SEEKDATA)
+		play_track(SEEK,READCDDA,PLAYCDDA)̃ANZXp^[ʃXbhōs܂B
+-----------------------------------------------------------------------------*/
+static Uint32
+read_be32(
+	const Uint8*	p)
+{
+	return (p[0]<<24) + (p[1]<<16) + (p[2]<<8) + p[3];
+}
+
+
+static Uint64
+read_be64(
+	const Uint8*	p)
+{
+	return ((Uint64)read_be32(p) << 32) + read_be32(p+4);
+}
+
+
+//fBXNC[WƂĊJt@CǂgqŔfBApp.cpppB
+//CHD͓WJłȂkłhCuɂ͉񂳂Aparse_chd()ŃG[\B
+BOOL
+CDIF_IsImageFile(
+	const char*	pFileName)
+{
+	const char*	pExt = strrchr(pFileName, '.');
+
+	if (pExt == NULL)
+		return FALSE;
+	pExt++;
+	return ((_stricmp(pExt,"cue") == 0)||(_stricmp(pExt,"iso") == 0)||(_stricmp(pExt,"chd") == 0));
+}
+
+
+//OotakeŃtCXg[Ƃcuet@Cǂ𔻒fB
+//"REM ver"Ŏn܂邩ASĂ"FILE"TrackNN.iso,TrackNN.wavȂCXg[pcueB
+static BOOL
+is_install_cue(
+	const char*	pCueFileName)
+{
+	FILE*		fp;
+	char		buf[256];
+	char*		pName;
+	char*		p;
+	BOOL		bFirst = TRUE;
+	Sint32		nFiles = 0;
+	BOOL		bInstall = TRUE;
+
+	p = strrchr((char*)pCueFileName, '.');
+	if ((p == NULL)||(_stricmp(p+1,"cue") != 0))
+		return FALSE;
+	if ((fp = fopen(pCueFileName, "r")) == NULL)
+		return FALSE;
+	while (fgets(buf, 255, fp))
+	{
+		if ((bFirst)&&(strncmp(buf,"REM ver",7) == 0))
+		{
+			fclose(fp);
+			return TRUE;
+		}
+		bFirst = FALSE;
+		if ((pName = strstr(buf,"FILE ")) == NULL)
+			continue;
+		nFiles++;
+		pName += 5;
+		if (*pName == '"') pName++;
+		if ((p = strchr(pName, '"')) != NULL)	*p = 0;
+		else if ((p = strchr(pName, ' ')) != NULL)	*p = 0;
+		if ((p = strrchr(pName, '\\')) != NULL)	pName = p+1;
+		if ((strlen(pName) != 11)||(_strnicmp(pName,"Track",5) != 0)||
+			(!isdigit((Uint8)pName[5]))||(!isdigit((Uint8)pName[6]))||
+			((_stricmp(pName+7,".iso") != 0)&&(_stricmp(pName+7,".wav") != 0)))
+				bInstall = FALSE;
+	}
+	fclose(fp);
+
+	return ((nFiles > 0)&&(bInstall));
+}
+
+
+//t@C̎wʒuǂݍށBCDXbhƐǂ݃Xbh瓯ɌĂ΂Ă悤ɁAt@C|C^͎gȂB
+static BOOL
+image_read_at(
+	HANDLE	hFile,
+	Uint64	pos,
+	void*	pBuf,
+	Uint32	size)
+{
+	OVERLAPPED	ov;
+	DWORD		n;
+
+	ZeroMemory(&ov, sizeof(ov));
+	ov.Offset = (DWORD)pos;
+	ov.OffsetHigh = (DWORD)(pos >> 32);
+	if (!ReadFile(hFile, pBuf, size, &n, &ov))
+		return FALSE;
+
+	return (n == size);
+}
+
+
+//C[W̃t@CJ_ImageFile[]ɓo^B߂l̓CfbNXBs-1B
+static Sint32
+image_open_file(
+	const char*	pFileName,
+	BOOL		bWave)
+{
+	ImageFile*	pF;
+	Uint8		hdr[12];
+	Uint8		chunk[8];
+	Uint64		pos;
+	Uint32		size;
+	DWORD		sizeHigh;
+
+	if (_nImageFiles >= IMAGE_MAXFILES)
+		return -1;
+	pF = &_ImageFile[_nImageFiles];
+	pF->hFile = CreateFile(pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (pF->hFile == INVALID_HANDLE_VALUE)
+		return -1;
+	pF->size = GetFileSize(pF->hFile, &sizeHigh);
+	pF->size += (Uint64)sizeHigh << 32; //4GBȏ̃C[W
+	pF->dataStart = 0;
+	pF->dataSize = pF->size;
+
+	if (bWave)
+	{	//"data"`NTBwb_̑傫44oCgƂ͌ȂB
+		if ((!image_read_at(pF->hFile, 0, hdr, 12))||(memcmp(hdr,"RIFF",4) != 0)||(memcmp(hdr+8,"WAVE",4) != 0))
+		{
+			CloseHandle(pF->hFile);
+			return -1;
+		}
+		pos = 12;
+		while (image_read_at(pF->hFile, pos, chunk, 8))
+		{
+			size = chunk[4] + (chunk[5]<<8) + (chunk[6]<<16) + (chunk[7]<<24);
+			if (memcmp(chunk,"data",4) == 0)
+			{
+				pF->dataStart = pos + 8;
+				pF->dataSize = (size < pF->size - pF->dataStart) ? size : pF->size - pF->dataStart;
+				break;
+			}
+			pos += 8 + size + (size & 1);
+			if (pos >= pF->size)
+				break;
+		}
+		if (pF->dataStart == 0)
+		{
+			CloseHandle(pF->hFile);
+			return -1;
+		}
+	}
+
+	return _nImageFiles++;
+}
+
+
+static Uint32
+parse_msf(
+	const char*	p)
+{
+	Uint32	m = 0;
+	Uint32	s = 0;
+	Uint32	f = 0;
+
+	sscanf(p, "%lu:%lu:%lu", &m, &s, &f);
+	return (m*60 + s)*75 + f;
+}
+
+
+//ʓIcueV[gǂݍށBFILE(BINARY,MOTOROLA,WAVE)CTRACK(MODE1/2048,MODE1/2352,MODE2/2336,MODE2/2352,AUDIO)C
+//PREGAPCINDEX 01ɑΉB
+static BOOL
+parse_cue(
+	const char*	pCueFileName)
+{
+	FILE*		fp;
+	char		buf[MAX_PATH+64];
+	char		path[MAX_PATH+1];
+	char*		p;
+	char*		pName;
+	char*		pi;
+	char*		pType;
+	Sint32		file = -1;
+	Sint32		t = 0;
+	Sint32		prevT = 0;
+	Uint32		fileLba = 0;	//݂FILE̐擪LBA
+	Uint32		fileFrames = 0;	//݂FILẼZN^[
+	Uint32		pregap = 0;		//PREGAP̍v(t@CɊ܂܂Ȃ)
+	BOOL		bMotorola = FALSE;
+	ImageTrack*	pT;
+
+	if ((fp = fopen(pCueFileName, "r")) == NULL)
+		return FALSE;
+
+	while (fgets(buf, sizeof(buf)-1, fp))
+	{
+		p = buf;
+		while ((*p == ' ')||(*p == '\t'))	p++;
+
+		if (strncmp(p,"FILE ",5) == 0)
+		{
+			if (file >= 0) //OFILẼZN^[Ԃ擪LBAi߂
+				fileLba += fileFrames;
+			pName = p + 5;
+			if (*pName == '"')
+			{
+				pName++;
+				pi = strchr(pName, '"');
+			}
+			else
+				pi = strchr(pName, ' ');
+			if (pi == NULL)
+				break;
+			*pi = 0;
+			pType = pi + 1;
+			if ((strchr(pName, ':') != NULL)||(pName[0] == '\\'))
+				strcpy(path, pName); //΃pX
+			else
+			{
+				strcpy(path, pCueFileName);
+				pi = strrchr(path, '\\');
+				if (pi != NULL)	*(pi+1) = 0; else path[0] = 0;
+				strcat(path, pName);
+			}
+			bMotorola = (strstr(pType,"MOTOROLA") != NULL);
+			file = image_open_file(path, (strstr(pType,"WAVE") != NULL));
+			if (file < 0)
+				break;
+			fileFrames = 0;
+		}
+		else if ((strncmp(p,"TRACK ",6) == 0)&&(file >= 0))
+		{
+			t = atoi(p + 6);
+			if ((t < 1)||(t > 99))
+				break;
+			pT = &_ImageTrack[t];
+			pT->file = file;
+			pT->dataOffset = 0;
+			pT->bSwap = FALSE;
+			_TrackInfo[t].bAudio = FALSE;
+			if (strstr(p,"AUDIO") != NULL)
+			{
+				pT->sectorSize = 2352;
+				pT->bSwap = bMotorola;
+				_TrackInfo[t].bAudio = TRUE;
+			}
+			else if (strstr(p,"MODE1/2048") != NULL)
+				pT->sectorSize = 2048;
+			else if (strstr(p,"MODE1/2352") != NULL)
+			{
+				pT->sectorSize = 2352;
+				pT->dataOffset = 16;
+			}
+			else if (strstr(p,"MODE2/2336") != NULL)
+			{
+				pT->sectorSize = 2336;
+				pT->dataOffset = 8;
+			}
+			else if (strstr(p,"MODE2/2352") != NULL)
+			{
+				pT->sectorSize = 2352;
+				pT->dataOffset = 24;
+			}
+			else //CDGɂ͔Ή
+				break;
+			fileFrames = (Uint32)(_ImageFile[file].dataSize / pT->sectorSize);
+		}
+		else if ((strncmp(p,"PREGAP ",7) == 0)&&(t != 0))
+			pregap += parse_msf(p + 7);
+		else if ((strncmp(p,"INDEX 01 ",9) == 0)&&(t != 0))
+		{
+			pT = &_ImageTrack[t];
+			pT->offset = _ImageFile[file].dataStart + parse_msf(p + 9) * pT->sectorSize;
+			_TrackInfo[t].lba = fileLba + pregap + parse_msf(p + 9);
+			if ((prevT != 0)&&(_ImageTrack[prevT].file == file)) //t@C̑ÕgbN̒܂
+				_ImageTrack[prevT].nFrames = (Uint32)((pT->offset - _ImageTrack[prevT].offset) / _ImageTrack[prevT].sectorSize);
+			prevT = t;
+			_LastTrack = t;
+		}
+	}
+	fclose(fp);
+
+	//eFILE̍Ō̃gbN̒̓t@C̏I܂
+	for (t=1; t<=_LastTrack; t++)
+	{
+		pT = &_ImageTrack[t];
+		if ((pT->sectorSize != 0)&&((t == _LastTrack)||(_ImageTrack[t+1].file != pT->file)))
+			pT->nFrames = (Uint32)((_ImageFile[pT->file].dataStart + _ImageFile[pT->file].dataSize - pT->offset) / pT->sectorSize);
+		if (pT->sectorSize == 0) //TRACKINDEX 01Ă
+			return FALSE;
+	}
+	if (_LastTrack == 0)
+		return FALSE;
+
+	//[hAEgݒ
+	_TrackInfo[_LastTrack+1].bAudio = FALSE;
+	_TrackInfo[_LastTrack+1].lba = _TrackInfo[_LastTrack].lba + _ImageTrack[_LastTrack].nFrames;
+
+	return TRUE;
+}
+
+
+//f[^gbNЂƂisoC[WJB
+static BOOL
+parse_iso(
+	const char*	pIsoFileName)
+{
+	Sint32		file = image_open_file(pIsoFileName, FALSE);
+	ImageTrack*	pT = &_ImageTrack[1];
+
+	if (file < 0)
+		return FALSE;
+	pT->file = file;
+	if (((_ImageFile[file].size % 2048) != 0)&&((_ImageFile[file].size % 2352) == 0))
+	{	//gqisołgMODE1/2352̏ꍇ
+		pT->sectorSize = 2352;
+		pT->dataOffset = 16;
+	}
+	else
+		pT->sectorSize = 2048;
+	pT->nFrames = (Uint32)(_ImageFile[file].size / pT->sectorSize);
+	_TrackInfo[1].lba = 0;
+	_TrackInfo[1].bAudio = FALSE;
+	_TrackInfo[2].lba = pT->nFrames;
+	_TrackInfo[2].bAudio = FALSE;
+	_LastTrack = 1;
+
+	return TRUE;
+}
+
+
+//CHD̈k}bvnrbgǂށBf[^̌0ƂēǂށB
+static Uint64
+chd_read_bits(
+	ChdBits*	pB,
+	int			n)
+{
+	Uint64	v = 0;
+	Uint32	pos;
+
+	while (n-- > 0)
+	{
+		pos = pB->bit++;
+		v <<= 1;
+		if (pos/8 < pB->size)
+			v |= (pB->p[pos/8] >> (7 - pos%8)) & 1;
+	}
+
+	return v;
+}
+
+
+//k^Cṽnt}\ǂݍpLookup[]Bl(R[h<<5)+rbgB
+//\͊eR[h̃rbg4rbgׂ̂ŁA1̓GXP[v("1,1"=1C"1,n,r"=nr+3)B
+static BOOL
+chd_read_huffman(
+	ChdBits*	pB,
+	Uint16*		pLookup)
+{
+	Uint32	numBits[CHD_HUFF_CODES];
+	Uint32	start[33];
+	Uint32	histo;
+	Uint32	next;
+	Uint32	nodeBits;
+	Uint32	rep;
+	Uint32	code;
+	Uint32	shift;
+	int		n = 0;
+	int		i;
+	Uint32	j;
+
+	while (n < CHD_HUFF_CODES)
+	{
+		nodeBits = (Uint32)chd_read_bits(pB, 4);
+		if (nodeBits != 1)
+			numBits[n++] = nodeBits;
+		else if ((nodeBits = (Uint32)chd_read_bits(pB, 4)) == 1)
+			numBits[n++] = 1;
+		else
+		{
+			rep = (Uint32)chd_read_bits(pB, 4) + 3;
+			if (n + rep > CHD_HUFF_CODES)
+				return FALSE;
+			while (rep-- > 0)
+				numBits[n++] = nodeBits;
+		}
+	}
+
+	//rbgƂ̍ŏ̃R[h߂(R[h珇Ɋ蓖Ă)
+	ZeroMemory(start, sizeof(start));
+	for (i=0; i<CHD_HUFF_CODES; i++)
+	{
+		if (numBits[i] > CHD_HUFF_MAXBITS)
+			return FALSE;
+		start[numBits[i]]++;
+	}
+	code = 0;
+	for (i=32; i>0; i--)
+	{
+		histo = start[i];
+		next = (code + histo) >> 1;
+		if ((i != 1)&&(next*2 != code + histo))
+			return FALSE;
+		start[i] = code;
+		code = next;
+	}
+
+	ZeroMemory(pLookup, sizeof(Uint16) << CHD_HUFF_MAXBITS);
+	for (i=0; i<CHD_HUFF_CODES; i++)
+		if (numBits[i] > 0)
+		{
+			code = start[numBits[i]]++;
+			shift = CHD_HUFF_MAXBITS - numBits[i];
+			for (j=code<<shift; j<((code+1)<<shift); j++)
+				pLookup[j] = (Uint16)((i<<5) + numBits[i]);
+		}
+
+	return TRUE;
+}
+
+
+static Uint32
+chd_decode_huffman(
+	ChdBits*		pB,
+	const Uint16*	pLookup)
+{
+	Uint16	v = pLookup[(Uint32)chd_read_bits(pB, CHD_HUFF_MAXBITS)];
+
+	pB->bit -= CHD_HUFF_MAXBITS - (v & 0x1F); //gȂrbg߂
+	return v >> 5;
+}
+
+
+//CRC16(CCITT)Bk}bv̌ؗpB
+static Uint32
+chd_crc16(
+	Uint32			crc,
+	const Uint8*	p,
+	Uint32			size)
+{
+	int		i;
+
+	while (size-- > 0)
+	{
+		crc ^= *p++ << 8;
+		for (i=0; i<8; i++)
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+	}
+
+	return crc;
+}
+
+
+//񈳏k̃}bvǂށBGg͂SoCg̃rbOGfBAŁAnNPʂ̈ʒuB0͊蓖ĂĂȂB
+static BOOL
+chd_read_raw_map(
+	HANDLE	hFile,
+	Uint64	mapOffset)
+{
+	Uint8*	pRaw = (Uint8*)malloc(_ChdNumHunks * 4);
+	Uint32	i;
+	BOOL	bOk;
+
+	if (pRaw == NULL)
+		return FALSE;
+	bOk = image_read_at(hFile, mapOffset, pRaw, _ChdNumHunks * 4);
+	for (i=0; (bOk)&&(i<_ChdNumHunks); i++)
+	{
+		_pChdMap[i].offset = (Uint64)read_be32(pRaw + i*4) * _ChdHunkBytes;
+		_pChdMap[i].length = _ChdHunkBytes;
+		_pChdMap[i].type = (_pChdMap[i].offset != 0) ? CHD_HUNK_RAW : CHD_HUNK_NONE;
+	}
+	free(pRaw);
+
+	return bOk;
+}
+
+
+//k}bv(pDataCpHdr͐擪16oCg)_pChdMap[]ɓWJB
+//ɑSnN̈k^Cv(nt}ƃOX)AĊenN̒EʒuECRCrbgŕłB
+//cdzlȊO̕ňkꂽnN΁A̕*pBadCodecɕԂFALSEB
+static BOOL
+chd_decode_map(
+	const Uint8*	pHdr,
+	const Uint8*	pData,
+	Uint32			mapBytes,
+	const Uint32*	pCodec,
+	Uint32*			pBadCodec)
+{
+	ChdBits		bits;
+	Uint16		lookup[1 << CHD_HUFF_MAXBITS];
+	Uint8		raw[12];
+	Uint64		curOffset = ((Uint64)((pHdr[4]<<8) + pHdr[5]) << 32) + read_be32(pHdr+6);
+	Uint32		lengthBits = pHdr[12];
+	Uint32		selfBits = pHdr[13];
+	Uint32		parentBits = pHdr[14];
+	Uint32		crc = 0xFFFF;
+	Uint32		lastType = 0;
+	Uint32		rep = 0;
+	Uint64		lastSelf = 0;
+	Uint64		lastParent = 0;
+	Uint32		type;
+	Uint32		length;
+	Uint64		offset;
+	Uint32		hunkCrc;
+	Uint32		i;
+	ChdHunk*	pH;
+
+	bits.p = pData;
+	bits.size = mapBytes;
+	bits.bit = 0;
+	if (!chd_read_huffman(&bits, lookup))
+		return FALSE;
+	for (i=0; i<_ChdNumHunks; i++)
+	{
+		if (rep > 0)
+		{
+			_pChdMap[i].type = lastType;
+			rep--;
+			continue;
+		}
+		type = chd_decode_huffman(&bits, lookup);
+		if (type == CHD_COMP_RLE_SMALL)
+			rep = 2 + chd_decode_huffman(&bits, lookup);
+		else if (type == CHD_COMP_RLE_LARGE)
+		{
+			rep = 2 + 16 + (chd_decode_huffman(&bits, lookup) << 4);
+			rep += chd_decode_huffman(&bits, lookup);
+		}
+		else
+			lastType = type;
+		_pChdMap[i].type = lastType;
+	}
+
+	*pBadCodec = 0;
+	for (i=0; i<_ChdNumHunks; i++)
+	{
+		pH = &_pChdMap[i];
+		type = pH->type;
+		length = 0;
+		offset = curOffset;
+		hunkCrc = 0;
+		switch (type)
+		{
+			case 0:
+			case 1:
+			case 2:
+			case 3:
+				length = (Uint32)chd_read_bits(&bits, lengthBits);
+				curOffset += length;
+				hunkCrc = (Uint32)chd_read_bits(&bits, 16);
+				break;
+			case CHD_COMP_NONE:
+				length = _ChdHunkBytes;
+				curOffset += length;
+				hunkCrc = (Uint32)chd_read_bits(&bits, 16);
+				break;
+			case CHD_COMP_SELF:
+				offset = lastSelf = chd_read_bits(&bits, selfBits);
+				break;
+			case CHD_COMP_PARENT:
+				offset = lastParent = chd_read_bits(&bits, parentBits);
+				break;
+			case CHD_COMP_SELF_1:
+				lastSelf++;
+				//̂܂CHD_COMP_SELF_0
+			case CHD_COMP_SELF_0:
+				type = CHD_COMP_SELF;
+				offset = lastSelf;
+				break;
+			case CHD_COMP_PARENT_SELF:
+				type = CHD_COMP_PARENT;
+				offset = lastParent = (Uint64)i * _ChdHunkBytes / 2448;
+				break;
+			case CHD_COMP_PARENT_1:
+				lastParent += _ChdHunkBytes / 2448;
+				//̂܂CHD_COMP_PARENT_0
+			case CHD_COMP_PARENT_0:
+				type = CHD_COMP_PARENT;
+				offset = lastParent;
+				break;
+			default:
+				return FALSE;
+		}
+
+		//}bvCRC͓WJ12oCg̃Gg(^Cv,24bit,ʒu48bit,CRC16)ɑ΂ČvZ
+		raw[0] = (Uint8)type;
+		raw[1] = (Uint8)(length >> 16);
+		raw[2] = (Uint8)(length >> 8);
+		raw[3] = (Uint8)length;
+		raw[4] = (Uint8)(offset >> 40);
+		raw[5] = (Uint8)(offset >> 32);
+		raw[6] = (Uint8)(offset >> 24);
+		raw[7] = (Uint8)(offset >> 16);
+		raw[8] = (Uint8)(offset >> 8);
+		raw[9] = (Uint8)offset;
+		raw[10] = (Uint8)(hunkCrc >> 8);
+		raw[11] = (Uint8)hunkCrc;
+		crc = chd_crc16(crc, raw, 12);
+
+		pH->offset = offset;
+		pH->length = length;
+		if (type < CHD_COMP_NONE)
+		{
+			if (pCodec[type] == 0)
+				return FALSE;
+			if (pCodec[type] != CHD_CODEC_CDZL)
+				*pBadCodec = pCodec[type];
+			pH->type = CHD_HUNK_CDZL;
+		}
+		else if (type == CHD_COMP_NONE)
+			pH->type = CHD_HUNK_RAW;
+		else if (type == CHD_COMP_SELF) //ȇÕnNQ
+		{
+			if (offset >= i)
+				return FALSE;
+			*pH = _pChdMap[(Uint32)offset];
+		}
+		else //eCHD̍C[Wɂ͔Ή
+			pH->type = CHD_HUNK_NONE;
+	}
+	if ((bits.bit > mapBytes * 8)||(crc != read_be32(pHdr+8) % 0x10000))
+	{
+		*pBadCodec = 0;
+		return FALSE;
+	}
+
+	return (*pBadCodec == 0);
+}
+
+
+static BOOL
+chd_read_compressed_map(
+	HANDLE			hFile,
+	Uint64			mapOffset,
+	const Uint32*	pCodec,
+	Uint32*			pBadCodec)
+{
+	Uint8	hdr[16];
+	Uint8*	pData;
+	Uint32	mapBytes;
+	BOOL	bOk;
+
+	if (!image_read_at(hFile, mapOffset, hdr, sizeof(hdr)))
+		return FALSE;
+	mapBytes = read_be32(hdr);
+	pData = (Uint8*)malloc(mapBytes);
+	if (pData == NULL)
+		return FALSE;
+	bOk = ((image_read_at(hFile, mapOffset + sizeof(hdr), pData, mapBytes))&&
+		   (chd_decode_map(hdr, pData, mapBytes, pCodec, pBadCodec)));
+	free(pData);
+
+	return bOk;
+}
+
+
+//kꂽnNWJobt@zlibXbhƂɗpӂB
+static BOOL
+chd_open_inflaters()
+{
+	ChdInflater*	pI;
+	int				n;
+
+	for (n=0; n<2; n++)
+	{
+		pI = &_ChdInflater[n];
+		pI->hunk = -1;
+		pI->pComp = (Uint8*)malloc(_ChdHunkBytes * 3);
+		if (pI->pComp == NULL)
+			return FALSE;
+		pI->pWork = pI->pComp + _ChdHunkBytes;
+		pI->pHunk = pI->pWork + _ChdHunkBytes;
+		ZeroMemory(&pI->zs, sizeof(pI->zs));
+		if (inflateInit2(&pI->zs, -MAX_WBITS) != Z_OK) //wb_deflatef[^
+			return FALSE;
+		pI->bInit = TRUE;
+	}
+
+	return TRUE;
+}
+
+
+static BOOL
+chd_inflate(
+	z_stream*		pZ,
+	const Uint8*	pSrc,
+	Uint32			srcSize,
+	Uint8*			pDst,
+	Uint32			dstSize)
+{
+	if (inflateReset(pZ) != Z_OK)
+		return FALSE;
+	pZ->next_in = (Bytef*)pSrc;
+	pZ->avail_in = srcSize;
+	pZ->next_out = pDst;
+	pZ->avail_out = dstSize;
+	inflate(pZ, Z_FINISH);
+
+	return (pZ->total_out == dstSize);
+}
+
+
+//CHDframeԖڂ̃t[(2448oCg)kꂽnNoBn=0:CDXbh(ƃx`}[N)Cn=1:ǂ݃Xbh
+//cdzl̃nŃAECCĐłZN^[̃rbgCCf[^̈k̒CCf[^CTu`l̏B
+//̂悤ȃZN^[͓p^[ECC0ɂȂĂBp^[߂BECC0̂܂܂Af[^gbN
+//[U[f[^(dataOffset2048oCg)ǂ܂Ȃ̂ŖȂB
+static BOOL
+chd_read_frame(
+	Sint32	file,
+	Uint32	frame,
+	Uint8*	pDst,
+	int		n)
+{
+	static const Uint8	sync[12] = {0x00,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x00};
+	ChdInflater*	pI = &_ChdInflater[n];
+	Uint32			framesPerHunk = _ChdHunkBytes / 2448;
+	Uint32			hunk = frame / framesPerHunk;
+	ChdHunk*		pH;
+	Uint32			eccBytes;
+	Uint32			headerBytes;
+	Uint32			baseBytes;
+	Uint32			f;
+
+	if (hunk >= _ChdNumHunks)
+		return FALSE;
+	pH = &_pChdMap[hunk];
+	if (pH->type != CHD_HUNK_CDZL)
+		return FALSE;
+
+	if (pI->hunk != (Sint32)hunk)
+	{
+		pI->hunk = -1;
+		eccBytes = (framesPerHunk + 7) / 8;
+		headerBytes = eccBytes + ((_ChdHunkBytes < 65536) ? 2 : 3);
+		if ((pH->length < headerBytes)||(pH->length > _ChdHunkBytes)||
+			(!image_read_at(_ImageFile[file].hFile, pH->offset, pI->pComp, pH->length)))
+			return FALSE;
+		baseBytes = (pI->pComp[eccBytes]<<8) + pI->pComp[eccBytes+1];
+		if (_ChdHunkBytes >= 65536)
+			baseBytes = (baseBytes<<8) + pI->pComp[eccBytes+2];
+		if ((headerBytes + baseBytes > pH->length)||
+			(!chd_inflate(&pI->zs, pI->pComp + headerBytes, baseBytes, pI->pWork, framesPerHunk * 2352))||
+			(!chd_inflate(&pI->zs, pI->pComp + headerBytes + baseBytes, pH->length - headerBytes - baseBytes,
+						  pI->pWork + framesPerHunk * 2352, framesPerHunk * 96)))
+			return FALSE;
+		for (f=0; f<framesPerHunk; f++)
+		{
+			CopyMemory(pI->pHunk + f*2448, pI->pWork + f*2352, 2352);
+			CopyMemory(pI->pHunk + f*2448 + 2352, pI->pWork + framesPerHunk*2352 + f*96, 96);
+			if (pI->pComp[f/8] & (1 << (f%8)))
+				CopyMemory(pI->pHunk + f*2448, sync, 12);
+		}
+		pI->hunk = hunk;
+	}
+	CopyMemory(pDst, pI->pHunk + (frame % framesPerHunk) * 2448, 2448);
+
+	return TRUE;
+}
+
+
+//CHD(v5)JBCDp̃^f[^(CHT2,CHTR)TOC쐬B
+//񈳏k̂̂cdzl(zlib)ňk("chdman createcd -c none"C"-c cdzl"ō쐬)ɑΉB
+//LZMA(cdlz),FLAC(cdfl)͓WJCuߔΉŁAG[\B
+static BOOL
+parse_chd(
+	const char*	pChdFileName)
+{
+	Sint32		file = image_open_file(pChdFileName, FALSE);
+	HANDLE		hFile;
+	Uint8		hdr[124];
+	Uint8		meta[16];
+	char		buf[256];
+	Uint32		codec[4];
+	Uint32		badCodec = 0;
+	Uint64		mapOffset;
+	Uint64		metaOffset;
+	Uint32		len;
+	Uint32		i;
+	Uint32		chdFrame = 0;	//CHD̃t[ʒu
+	Uint32		lba = 0;
+	Sint32		t;
+	Uint32		frames;
+	Uint32		pregap;
+	Uint32		postgap;
+	char		type[32];
+	char		subtype[32];
+	char		pgtype[32];
+	ImageTrack*	pT;
+
+	if (file < 0)
+		return FALSE;
+	hFile = _ImageFile[file].hFile;
+	if ((!image_read_at(hFile, 0, hdr, sizeof(hdr)))||(memcmp(hdr,"MComprHD",8) != 0)||(read_be32(hdr+12) != 5))
+		return FALSE;
+	for (i=0; i<4; i++)
+		codec[i] = read_be32(hdr+16 + i*4);
+	mapOffset = read_be64(hdr+40);
+	metaOffset = read_be64(hdr+48);
+	_ChdHunkBytes = read_be32(hdr+56);
+	if ((read_be32(hdr+60) != 2448)||(_ChdHunkBytes == 0)||((_ChdHunkBytes % 2448) != 0)||(_ChdHunkBytes > 0x1000000))
+		return FALSE;
+	_ChdNumHunks = (Uint32)((read_be64(hdr+32) + _ChdHunkBytes - 1) / _ChdHunkBytes);
+
+	_pChdMap = (ChdHunk*)malloc(_ChdNumHunks * sizeof(ChdHunk));
+	if (_pChdMap == NULL)
+		return FALSE;
+	if (codec[0] == 0) //k̎w肪Δ񈳏k̃}bv
+	{
+		if (!chd_read_raw_map(hFile, mapOffset))
+			return FALSE;
+	}
+	else
+	{
+		if (!chd_read_compressed_map(hFile, mapOffset, codec, &badCodec))
+		{
+			if (badCodec != 0) //LZMA(cdlz),FLAC(cdfl)ȂǂňkꂽnN
+			{
+				sprintf(buf, "This CHD image uses the \"%c%c%c%c\" codec, which Ootake cannot decompress.\n"
+							 "Please recompress it with \"chdman createcd -c cdzl\" (or \"-c none\").    ",
+						(char)(badCodec >> 24), (char)(badCodec >> 16), (char)(badCodec >> 8), (char)badCodec);
+				MessageBox(WINMAIN_GetHwnd(), buf, "Ootake Error", MB_OK);
+			}
+			return FALSE;
+		}
+		if (!chd_open_inflaters())
+			return FALSE;
+	}
+
+	//^f[^̃gbNɓǂ
+	while (metaOffset != 0)
+	{
+		if (!image_read_at(hFile, metaOffset, meta, 16))
+			return FALSE;
+		len = (meta[5]<<16) + (meta[6]<<8) + meta[7];
+		if (((memcmp(meta,"CHT2",4) == 0)||(memcmp(meta,"CHTR",4) == 0))&&(len < sizeof(buf)))
+		{
+			if (!image_read_at(hFile, metaOffset+16, buf, len))
+				return FALSE;
+			buf[len] = 0;
+			pregap = postgap = 0;
+			strcpy(pgtype, "");
+			if (sscanf(buf, "TRACK:%ld TYPE:%31s SUBTYPE:%31s FRAMES:%lu PREGAP:%lu PGTYPE:%31s", &t, type, subtype, &frames, &pregap, pgtype) < 4)
+				return FALSE;
+			if ((t < 1)||(t > 99))
+				return FALSE;
+			if (strstr(buf,"POSTGAP:") != NULL)
+				postgap = atoi(strstr(buf,"POSTGAP:") + 8);
+			pT = &_ImageTrack[t];
+			pT->file = file;
+			pT->sectorSize = 2448;
+			pT->dataOffset = 0;
+			pT->bSwap = FALSE;
+			_TrackInfo[t].bAudio = FALSE;
+			if (strcmp(type,"AUDIO") == 0)
+			{
+				pT->bSwap = TRUE; //CHD̉yf[^̓rbOGfBA
+				_TrackInfo[t].bAudio = TRUE;
+			}
+			else if (strcmp(type,"MODE1_RAW") == 0)
+				pT->dataOffset = 16;
+			else if (strcmp(type,"MODE2_RAW") == 0)
+				pT->dataOffset = 24;
+			else if (strcmp(type,"MODE2_FORM_MIX") == 0)
+				pT->dataOffset = 8;
+			if (pgtype[0] == 'V') //vMbvCHDɊ܂܂Ă
+			{
+				pT->offset = chdFrame + pregap;
+				pT->nFrames = frames - pregap;
+			}
+			else
+			{
+				pT->offset = chdFrame;
+				pT->nFrames = frames;
+			}
+			_TrackInfo[t].lba = lba + pregap;
+			lba += ((pgtype[0] == 'V') ? 0 : pregap) + frames + postgap;
+			chdFrame += (frames + 3) & ~3; //CHD̃gbN4t[Pʂɂ낦Ă
+			if (t > _LastTrack)
+				_LastTrack = t;
+		}
+		metaOffset = read_be64(meta+8); //̃^f[^
+	}
+	if (_LastTrack == 0)
+		return FALSE;
+
+	//[hAEgݒ
+	_TrackInfo[_LastTrack+1].bAudio = FALSE;
+	_TrackInfo[_LastTrack+1].lba = lba;
+
+	return TRUE;
+}
+
+
+//lba܂ރgbNԂBȂ0B
+static Sint32
+image_find_track(
+	Uint32	lba)
+{
+	Sint32	t;
+
+	for (t=_LastTrack; t>=_FirstTrack; t--)
+		if (lba >= _TrackInfo[t].lba)
+			return t;
+
+	return 0;
+}
+
+
+//gbNtINDEX 01relԖڂ̃ZN^[̃t@CʒuԂB
+//CHDŔ񈳏k̃nNɖZN^[(kĂ,蓖ĂĂȂ)0B
+static Uint64
+image_sector_pos(
+	Sint32	t,
+	Uint32	rel)
+{
+	ImageTrack*	pT = &_ImageTrack[t];
+	Uint32		frame;
+	Uint32		framesPerHunk;
+	ChdHunk*	pH;
+
+	if (_pChdMap != NULL)
+	{
+		framesPerHunk = _ChdHunkBytes / 2448;
+		frame = (Uint32)pT->offset + rel;
+		if (frame / framesPerHunk >= _ChdNumHunks)
+			return 0;
+		pH = &_pChdMap[frame / framesPerHunk];
+		if (pH->type != CHD_HUNK_RAW)
+			return 0;
+		return pH->offset + (frame % framesPerHunk) * 2448;
+	}
+
+	return pT->offset + (Uint64)rel * pT->sectorSize;
+}
+
+
+//ubN(IMAGE_BLOCKSECTORSZN^[)t@CǂݍށBt@CŘAĂZN^[͂܂Ƃ߂ēǂށB
+//n=0:CDXbh(ƃx`}[N)Cn=1:ǂ݃Xbh
+static void
+image_load_block(
+	Sint32	block,
+	int		n)
+{
+	ImageBlock*	pLoad = &_ImageLoadBlock[n];
+	Uint8*		pStage = _ImageStage[n];
+	ImageBlock*	pBlock;
+	ImageBlock*	pVictim;
+	Uint32		lba = block * IMAGE_BLOCKSECTORS;
+	Uint64		pos[IMAGE_BLOCKSECTORS];
+	Uint32		size[IMAGE_BLOCKSECTORS];
+	Sint32		file[IMAGE_BLOCKSECTORS];
+	Sint32		t;
+	Uint32		rel;
+	int			i;
+	int			j;
+	int			k;
+	Uint32		runSize;
+
+	pLoad->block = block;
+	pLoad->valid = 0;
+	for (i=0; i<IMAGE_BLOCKSECTORS; i++)
+	{
+		file[i] = -1;
+		t = image_find_track(lba + i);
+		if (t == 0)
+			continue;
+		rel = lba + i - _TrackInfo[t].lba;
+		if (rel >= _ImageTrack[t].nFrames) //t@CɊ܂܂ȂvMbv
+			continue;
+		pos[i] = image_sector_pos(t, rel);
+		if ((_pChdMap != NULL)&&(pos[i] == 0))
+		{	//kꂽnN͂œWJĎo
+			if (chd_read_frame(_ImageTrack[t].file, (Uint32)_ImageTrack[t].offset + rel, pLoad->buf + i*IMAGE_RAWSIZE, n))
+				pLoad->valid |= 1 << i;
+			continue;
+		}
+		size[i] = (_pChdMap != NULL) ? 2448 : _ImageTrack[t].sectorSize;
+		file[i] = _ImageTrack[t].file;
+	}
+
+	for (i=0; i<IMAGE_BLOCKSECTORS; i=j)
+	{
+		j = i + 1;
+		if (file[i] < 0)
+			continue;
+		runSize = size[i];
+		while ((j < IMAGE_BLOCKSECTORS)&&(file[j] == file[i])&&(size[j] == size[i])&&(pos[j] == pos[i] + runSize))
+			runSize += size[j++];
+		if (image_read_at(_ImageFile[file[i]].hFile, pos[i], pStage, runSize))
+			for (k=i; k<j; k++)
+			{
+				CopyMemory(pLoad->buf + k*IMAGE_RAWSIZE, pStage + (k-i)*size[i], size[i]);
+				pLoad->valid |= 1 << k;
+			}
+	}
+
+	//LbVɓo^BԌÂubNƓւB
+	EnterCriticalSection(&_ImageLock);
+	pVictim = &_pImageCache[0];
+	for (i=0; i<IMAGE_CACHEBLOCKS; i++)
+	{
+		pBlock = &_pImageCache[i];
+		if (pBlock->block == block) //̃Xbhɓǂݍł
+		{
+			pVictim = NULL;
+			break;
+		}
+		if (pBlock->used < pVictim->used)
+			pVictim = pBlock;
+	}
+	if (pVictim != NULL)
+	{
+		pVictim->block = block;
+		pVictim->valid = pLoad->valid;
+		pVictim->used = ++_ImageCacheClock;
+		CopyMemory(pVictim->buf, pLoad->buf, sizeof(pLoad->buf));
+	}
+	LeaveCriticalSection(&_ImageLock);
+}
+
+
+//LbVubNTB_ImageLock擾ĂĂԁB
+static ImageBlock*
+image_find_block(
+	Sint32	block)
+{
+	int		i;
+
+	for (i=0; i<IMAGE_CACHEBLOCKS; i++)
+		if (_pImageCache[i].block == block)
+			return &_pImageCache[i];
+
+	return NULL;
+}
+
+
+//gbNt̃ZN^[lba̐f[^̂AoffsetsizeoCgpDstփRs[Bǂ߂ȂꍇFALSEԂB
+static BOOL
+image_copy_sector(
+	Sint32	t,
+	Uint32	lba,
+	Uint8*	pDst,
+	Uint32	offset,
+	Uint32	size)
+{
+	ImageTrack*	pT = &_ImageTrack[t];
+	Uint32		rel = lba - _TrackInfo[t].lba;
+	Sint32		block = lba / IMAGE_BLOCKSECTORS;
+	Uint32		bit = 1 << (lba % IMAGE_BLOCKSECTORS);
+	ImageBlock*	pBlock;
+	BOOL		bSuccess = FALSE;
+
+	if (rel >= pT->nFrames)
+		return FALSE;
+
+	if (pT->pData != NULL) //}bvĂf[^gbN
+	{
+		CopyMemory(pDst, pT->pData + rel * pT->sectorSize + offset, size);
+		return TRUE;
+	}
+
+	EnterCriticalSection(&_ImageLock);
+	if ((pBlock = image_find_block(block)) == NULL)
+	{	//ǂ݂ĂȂꍇAœǂݍ
+		LeaveCriticalSection(&_ImageLock);
+		image_load_block(block, 0);
+		EnterCriticalSection(&_ImageLock);
+		pBlock = image_find_block(block);
+	}
+	if ((pBlock != NULL)&&(pBlock->valid & bit))
+	{
+		CopyMemory(pDst, pBlock->buf + (lba % IMAGE_BLOCKSECTORS) * IMAGE_RAWSIZE + offset, size);
+		pBlock->used = ++_ImageCacheClock;
+		bSuccess = TRUE;
+	}
+	LeaveCriticalSection(&_ImageLock);
+
+	return bSuccess;
+}
+
+
+static void
+image_clear_cache()
+{
+	int		i;
+
+	EnterCriticalSection(&_ImageLock);
+	for (i=0; i<IMAGE_CACHEBLOCKS; i++)
+	{
+		_pImageCache[i].block = -1;
+		_pImageCache[i].valid = 0;
+		_pImageCache[i].used = 0;
+	}
+	_ImageCacheClock = 0;
+	LeaveCriticalSection(&_ImageLock);
+}
+
+
+//ǂ݃XbhBlbanubNԂA}bvĂgbN̓y[WɐGēǂݍ܂AȊO̓LbV֓ǂݍށB
+static DWORD WINAPI
+image_prefetch_thread(
+	LPVOID	param)
+{
+	Uint32			lba;
+	Uint32			n;
+	Sint32			block;
+	Sint32			t;
+	Uint32			rel;
+	int				i;
+	BOOL			bCached;
+	volatile Uint8	touch;
+
+	while (TRUE)
+	{
+		WaitForSingleObject(_hPrefetchEvent, INFINITE);
+		if (_bPrefetchExit)
+			break;
+
+		lba = _PrefetchLba;
+		n = _PrefetchBlocks;
+		for (block = lba / IMAGE_BLOCKSECTORS; block < (Sint32)(lba / IMAGE_BLOCKSECTORS + n); block++)
+		{
+			if ((_bPrefetchExit)||(_PrefetchLba != lba)) //Vv炻D悷
+				break;
+			t = image_find_track(block * IMAGE_BLOCKSECTORS);
+			if ((t != 0)&&(_ImageTrack[t].pData != NULL))
+			{
+				for (i=0; i<IMAGE_BLOCKSECTORS; i++) //PZN^[͂Py[W菬̂ŁAeZN^[̐擪ɐGΑSy[Wǂݍ܂
+				{
+					t = image_find_track(block * IMAGE_BLOCKSECTORS + i);
+					if ((t == 0)||(_ImageTrack[t].pData == NULL))
+						continue;
+					rel = block * IMAGE_BLOCKSECTORS + i - _TrackInfo[t].lba;
+					if (rel < _ImageTrack[t].nFrames)
+						touch = _ImageTrack[t].pData[rel * _ImageTrack[t].sectorSize];
+				}
+			}
+			else
+			{
+				EnterCriticalSection(&_ImageLock);
+				bCached = (image_find_block(block) != NULL);
+				LeaveCriticalSection(&_ImageLock);
+				if (!bCached)
+					image_load_block(block, 1);
+			}
+		}
+	}
+
+	ExitThread(TRUE);
+	return 0;
+}
+
+
+//ANZXp^[ǂ݂˗BAANZXƉy̍Đ͑߂ɐǂ݂B
+static void
+image_read_ahead(
+	Uint32	startLBA,
+	Uint32	endLBA,
+	BOOL	bStream)
+{
+	Uint32	blocks;
+
+	if ((startLBA == _LastEndLba)||(bStream))
+		blocks = IMAGE_READAHEAD;
+	else
+		blocks = 1;
+	_LastEndLba = endLBA;
+
+	if ((!_bReadAhead)||(_hPrefetchEvent == NULL))
+		return;
+	_PrefetchBlocks = blocks;
+	_PrefetchLba = endLBA;
+	SetEvent(_hPrefetchEvent);
+}
+
+
+//C[Wf[^ZN^[(2048oCg)ǂݍށBexecute_read()̃C[WŁB
+static BOOL
+image_read(
+	CdArg*	pArg)
+{
+	Uint32	nSectors = pArg->endLBA - pArg->startLBA;
+	Uint32	lba = pArg->startLBA;
+	Uint32	i;
+	Sint32	t;
+
+	for (i=0; i<nSectors; i++, lba++)
+	{
+		t = image_find_track(lba);
+		if ((t == 0)||(_TrackInfo[t].bAudio)||(!image_copy_sector(t, lba, pArg->pBuf + i*2048, _ImageTrack[t].dataOffset, 2048)))
+		{	//ygbNC[W͈̔͊O͎@ƓlɃG[Bǂݍ߂Ȃ̈0Ŗ߂B
+			ZeroMemory(pArg->pBuf + i*2048, 2048*(nSectors-i));
+			_LastEndLba = 0xFFFFFFFF;
+			return FALSE;
+		}
+	}
+	image_read_ahead(pArg->startLBA, pArg->endLBA, FALSE);
+
+	return TRUE;
+}
 
-		for (j = 1; j <= _LastTrack+1; j++)
-		{
-			pLBA = &pTOC[4+(j-1)*8+4];
-			_TrackInfo[j].lba = (pLBA[0]<<24) + (pLBA[1]<<16) + (pLBA[2]<<8) + pLBA[3];
-			_TrackInfo[j].bAudio = ((pTOC[4+(j-1)*8+1] & 0x4) == 0) ? TRUE : FALSE;
-//			printf("track %d\n", j+1);
-//			printf("LBA = %d\n", _TrackInfo[j+1].lba);
-//			printf("bAudio = %d\n", _TrackInfo[j+1].bAudio);
+
+//C[W特yZN^[(2352oCg)ǂݍށBexecute_readCdda()̃C[WŁB
+static BOOL
+image_read_cdda(
+	CdArg*	pArg)
+{
+	Uint32	nSectors = pArg->endLBA - pArg->startLBA;
+	Uint32	lba = pArg->startLBA;
+	Uint32	i;
+	Uint32	j;
+	Sint32	t;
+	Uint8*	p;
+	Uint8	c;
+
+	for (i=0; i<nSectors; i++, lba++)
+	{
+		t = image_find_track(lba);
+		p = pArg->pBuf + i*2352;
+		if ((t == 0)||(!_TrackInfo[t].bAudio)||(!image_copy_sector(t, lba, p, 0, 2352)))
+		{	//f[^gbNC[W͈̔͊O̓G[Bǂݍ߂Ȃ̈0Ŗ߂B
+			ZeroMemory(p, (nSectors-i)*2352);
+			_LastEndLba = 0xFFFFFFFF;
+			return FALSE;
 		}
-		return TRUE;
+		if (_ImageTrack[t].bSwap)
+			for (j=0; j<2352; j+=2)
+			{
+				c = p[j];
+				p[j] = p[j+1];
+				p[j+1] = c;
+			}
 	}
+	image_read_ahead(pArg->startLBA, pArg->endLBA, TRUE);
 
-	return FALSE;
+	return TRUE;
 }
 
 
-//KitaoǉBCXg[Ootakeo[WǂݍŐɃbsOoĂt@Cǂ𔻒fBCDROM.cpppBv2.31
-BOOL //o[W̋LڂȂꍇFALSEԂBo[WLڂ̗Lɂ炸A_bBadInstalledݒ肳B
-CDIF_SetBadInstalled(
-	FILE*	fp)
+//f[^gbN}bvBAhXԂȂꍇȂǂ͎s邪Ȁꍇ̓LbVoRœǂݍށB
+static void
+image_map_data_tracks()
 {
-	char	buf[256];
-	char	ver[4];
-	int		v;
-
-	_bBadInstalled = FALSE;
-	strcpy(buf, "");
-	if (fgets(buf, 255, fp))
+	SYSTEM_INFO	si;
+	Sint32		t;
+	ImageTrack*	pT;
+	Uint64		start;
+	Uint32		size;
+
+	GetSystemInfo(&si);
+	for (t=1; t<=_LastTrack; t++)
 	{
-		if (strstr(buf,"REM ver"))
+		pT = &_ImageTrack[t];
+		if ((_TrackInfo[t].bAudio)||(_pChdMap != NULL)||(pT->nFrames == 0))
+			continue;
+		start = pT->offset - (pT->offset % si.dwAllocationGranularity);
+		size = (Uint32)(pT->offset - start) + pT->nFrames * pT->sectorSize;
+		pT->hMap = CreateFileMapping(_ImageFile[pT->file].hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (pT->hMap == NULL)
+			continue;
+		pT->pView = (Uint8*)MapViewOfFile(pT->hMap, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, size);
+		if (pT->pView == NULL)
 		{
-			ver[0] = buf[7];
-			ver[1] = buf[8];
-			ver[2] = buf[9];
-			ver[3] = 0;
-			v = atoi(ver);
-			if (v < 232) //v2.32̏ꍇAygbNP̃bsOsB
-				_bBadInstalled = TRUE;
-			if (v == 250) //v2.50̏ꍇAygbNPCUEt@C̃bsOsB
-				_bBadInstalled = TRUE;
-			return TRUE;
+			CloseHandle(pT->hMap);
+			pT->hMap = NULL;
+			continue;
 		}
-		else //o[WLڂȂꍇ
-			_bBadInstalled = TRUE; //ygbNP̃bsOs\B
+		pT->pData = pT->pView + (Uint32)(pT->offset - start);
 	}
-	return FALSE;
 }
 
-//KitaoǉBCuet@CTOC쐬Bv2.24
-static BOOL
-read_toc_cue()
+
+static void
+close_image()
 {
-	FILE*	fp;
-	FILE*	fp2;
-	char	buf[256];
-	char	buf2[256];
-	char*	r;
-	Uint32	tn;	
-	Uint32	lba;
-	char*	pi;
-	char*	pi2;
-	char	installPath[MAX_PATH+1];
-	char	fn[MAX_PATH+1];
-	DWORD	size;
+	Sint32	i;
 
-	fp = fopen(APP_GetCueFilePathName(), "r");
-	if (fp == NULL)	return FALSE;
+	if (_hPrefetchThread != INVALID_HANDLE_VALUE)
+	{
+		_bPrefetchExit = TRUE;
+		SetEvent(_hPrefetchEvent);
+		WaitForSingleObject(_hPrefetchThread, INFINITE);
+		CloseHandle(_hPrefetchThread);
+		_hPrefetchThread = INVALID_HANDLE_VALUE;
+	}
+	if (_hPrefetchEvent != NULL)
+	{
+		CloseHandle(_hPrefetchEvent);
+		_hPrefetchEvent = NULL;
+	}
 
-	SetCursor(LoadCursor(NULL, IDC_WAIT)); //gbNƎԂ|̂ŁAJ[\vɁB
+	for (i=1; i<=100; i++)
+	{
+		if (_ImageTrack[i].pView != NULL)
+			UnmapViewOfFile(_ImageTrack[i].pView);
+		if (_ImageTrack[i].hMap != NULL)
+			CloseHandle(_ImageTrack[i].hMap);
+	}
+	ZeroMemory(_ImageTrack, sizeof(_ImageTrack));
 
-	strcpy(installPath, APP_GetCueFilePathName());
-	pi = strrchr(installPath, '\\');
-	if (pi != NULL)	*(pi+1)=0; //installPath̃t@CJbg
+	for (i=0; i<_nImageFiles; i++)
+		CloseHandle(_ImageFile[i].hFile);
+	_nImageFiles = 0;
 
-	tn = 1; //gbNio[
-	lba = 0;
+	if (_pChdMap != NULL)
+	{
+		free(_pChdMap);
+		_pChdMap = NULL;
+	}
+	for (i=0; i<2; i++)
+	{
+		if (_ChdInflater[i].bInit)
+			inflateEnd(&_ChdInflater[i].zs);
+		free(_ChdInflater[i].pComp);
+	}
+	ZeroMemory(_ChdInflater, sizeof(_ChdInflater));
+	if (_pImageCache != NULL)
+	{
+		free(_pImageCache);
+		_pImageCache = NULL;
+		DeleteCriticalSection(&_ImageLock);
+	}
 
-	//v2.31ǉBCXg[Ootakeo[WǂݍŐɃbsOoĂt@Cǂ𔻒fB
-	if (!CDIF_SetBadInstalled(fp))
-	{	//o[WLڂȂꍇ(v2.30ȑOcue)At@C擪JȂB
-		fclose(fp);
-		fp = fopen(APP_GetCueFilePathName(), "r");
+	_bImage = FALSE;
+}
+
+
+//fBXNC[WJTOC쐬B
+static BOOL
+open_image(
+	const char*	pFileName)
+{
+	const char*	pExt = strrchr(pFileName, '.');
+	BOOL		bSuccess;
+
+	if (_bImage)
+	{
+		waitDeviceBusy();
+		close_image();
 	}
+	ZeroMemory(_TrackInfo, sizeof(_TrackInfo));
+	_LastTrack = 0;
+	_bBadInstalled = FALSE;
 
-	while (TRUE)
+	if ((pExt != NULL)&&(_stricmp(pExt,".chd") == 0))
+		bSuccess = parse_chd(pFileName);
+	else if ((pExt != NULL)&&(_stricmp(pExt,".iso") == 0))
+		bSuccess = parse_iso(pFileName);
+	else
+		bSuccess = parse_cue(pFileName);
+	if (!bSuccess)
 	{
-		strcpy(buf, "");
-		while (strstr(buf,"FILE ") == NULL)
-		{
-			r = fgets(buf, 255, fp);
-			if (r == NULL) break;
-		}
-		if (r == NULL)
-			 break; //"FILE"ȂȂI
-		pi = strstr(buf,"FILE ") + 5;
-		if (*pi == '"') pi++;
-		strcpy(buf2, pi);
-		pi2 = strstr(buf2,".");
-		if (pi2 != NULL)
-		{
-			pi2 += 4;
-			strcpy(buf, pi2);
-			*pi2 = 0; //buf2̓et@Ĉ݂ɂȂ
-		}
-		strcpy(fn, installPath);
-		strcat(fn, buf2);
-		fp2 = fopen(fn, "rb");
-		if (fp2 == NULL) break;
-		fseek(fp2, 0, SEEK_END);
-		size = ftell(fp2);
-		fclose(fp2);
-		r = fgets(buf2, 255, fp); //"TRACK"̍sǂݔ΂
-		r = fgets(buf2, 255, fp);
-		if (r != NULL)
-			if (strstr(buf2,"PREGAP") != NULL)
-				lba += 150; //vMbvԂ𑫂
-		_TrackInfo[tn].lba = lba;
-		if (strstr(buf,"BINARY") != NULL) //isȍꍇ
-		{
-			_TrackInfo[tn].bAudio = FALSE;
-			lba += size / 2048;
-		}
-		else //wav̏ꍇ
-		{
-			_TrackInfo[tn].bAudio = TRUE;
-			lba += (size - 44) / 2352; //44=WAVEwb_Ԃ
-		}
-		tn++;
+		close_image();
+		_LastTrack = 0;
+		return FALSE;
 	}
-	fclose(fp);
 
-	//[hAEgݒ
-	_TrackInfo[tn].bAudio = FALSE;
-	_TrackInfo[tn].lba = lba;
-	_LastTrack = tn - 1;
+	_pImageCache = (ImageBlock*)malloc(sizeof(ImageBlock) * IMAGE_CACHEBLOCKS);
+	if (_pImageCache == NULL)
+	{
+		close_image();
+		return FALSE;
+	}
+	InitializeCriticalSection(&_ImageLock);
+	image_clear_cache();
+	image_map_data_tracks();
+	_LastEndLba = 0xFFFFFFFF;
+
+	//ǂ݃Xbh쐬
+	_bPrefetchExit = FALSE;
+	_hPrefetchEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (_hPrefetchEvent != NULL)
+	{
+		_hPrefetchThread = CreateThread(NULL, 0, image_prefetch_thread, NULL, 0, NULL);
+		if (_hPrefetchThread == NULL)
+			_hPrefetchThread = INVALID_HANDLE_VALUE;
+	}
 
-	SetCursor(LoadCursor(NULL, IDC_ARROW)); //J[\ɖ߂
+	_bImage = TRUE;
+	return TRUE;
+}
 
-	//PRINTF("TrackInfo Test = %X", _TrackInfo[10].lba);
 
-	if (_LastTrack == 0)
-		return FALSE;
-	else
-		return TRUE;
+//CDXbhŏR}hO֋L^BHDDł̃R}hLBAɒċL^̂ŁAǂŋL^OC[WōĐłB
+static void
+write_command_log(
+	CdArg*	pArg)
+{
+	const char*	pName;
+	Uint32		lba = pArg->startLBA;
+	Uint32		nSectors = pArg->endLBA - pArg->startLBA;
+
+	switch (pArg->command)
+	{
+		case CDIF_READ:			pName = "read";		break;
+		case CDIF_SEEKDATA:		pName = "seekdata";	break;
+		case CDIF_SEEK:			pName = "seek";		break;
+		case CDIF_READCDDA:		pName = "cdda";		break;
+		case CDIF_READCDDA2:	pName = "cdda2";	break;
+		case CDIF_PLAYCDDA:
+			pName = "play";
+			lba = nSectors = 0;
+			break;
+		case CDIF_READHDD:
+		case CDIF_SEEKDATAHDD:
+			pName = (pArg->command == CDIF_READHDD) ? "read" : "seekdata";
+			lba = _TrackInfo[pArg->track].lba + pArg->startLBA / 2048;
+			nSectors = pArg->endLBA;
+			break;
+		case CDIF_SEEKHDD:
+		case CDIF_READCDDAHDD:
+		case CDIF_READCDDA2HDD:
+			pName = (pArg->command == CDIF_SEEKHDD) ? "seek" : ((pArg->command == CDIF_READCDDAHDD) ? "cdda" : "cdda2");
+			lba = _TrackInfo[pArg->track].lba + (pArg->startLBA - 44) / 2352;
+			nSectors = pArg->endLBA;
+			break;
+		default: //CXg[ƃTuQ͋L^Ȃ
+			return;
+	}
+	fprintf(_fpCommandLog, "%lu %s %lu %lu\n", timeGetTime() - _CommandLogTime, pName, lba, nSectors);
 }
 
 
@@ -771,6 +2313,9 @@ execute_read(
 	int			nSectors;
 	Uint32		lba;
 
+	if (_bImage) //fBXNC[Wǂݍޏꍇ
+		return image_read(pArg);
+
 	nSectors = pArg->endLBA - pArg->startLBA;
 	lba      = pArg->startLBA;
 
@@ -842,6 +2387,9 @@ execute_readCdda(
 	int		nSectors;
 	Uint32	lba;
 
+	if (_bImage) //fBXNC[Wǂݍޏꍇ
+		return image_read_cdda(pArg);
+
 	nSectors = pArg->endLBA - pArg->startLBA;
 	lba      = pArg->startLBA;
 
@@ -935,6 +2483,9 @@ execute_subq(
 	BYTE	lun = (BYTE)_CdromInfo[_DeviceInUse].lun;
 	BYTE*	pBuf = (BYTE*)pArg->pBuf;
 
+	if (_bImage) //fBXNC[Wɂ̓TuQ`l
+		return FALSE;
+
 	ZeroMemory(cdb, sizeof(BYTE)*10);
 	cdb[0]		= 0x42;
 	cdb[1]		= (lun << 5) | 2;
@@ -983,6 +2534,9 @@ cdif_main_thread(
 		if (pArg->command == CDIF_EXIT)
 			break;
 
+		if (_fpCommandLog != NULL) //x`}[NpɃR}hL^
+			write_command_log(pArg);
+
 		bSuccess = FALSE;
 		retry = 1; //G[̃gC񐔁B@ł͈͊ÕZN^[ȂǂɃANZX݂悤Ƃ\tgȀꍇ́AG[ԂKvB
 				   //			             Ȃ̂ŃgC񐔂𑽂ƃ\tg̓삪ꂪB~OXOPfȂǁB
@@ -1010,6 +2564,8 @@ cdif_main_thread(
 
 				case CDIF_PLAYCDDA://KitaoǉBv2.29
 					bSuccess = TRUE; //ȂŋABCDIF_PLAYCDDÁAEFCg邽߂ɗpB
+					if (_bImage) //Đn܂̂ŁAV[Nœǂ񂾑ǂ݂ĂB
+						image_read_ahead(_LastEndLba, _LastEndLba, TRUE);
 					break;
 
 				case CDIF_READCDDA://Kitaoǉ
@@ -1087,7 +2643,21 @@ CDIF_SelectDevice(
 	char	path[10];
 
 	if (APP_GetCueFile()) //Cuet@CN郂[h̏ꍇBv2.24
+	{
+		if ((CDIF_IsImageFile(APP_GetCueFilePathName()))&&(!is_install_cue(APP_GetCueFilePathName())))
+			return open_image(APP_GetCueFilePathName()); //CUE/BIN,ISO,CHD̃fBXNC[WNꍇ
+		if (_bImage)
+		{
+			waitDeviceBusy();
+			close_image();
+		}
 		return read_toc_cue();
+	}
+	if (_bImage)
+	{
+		waitDeviceBusy();
+		close_image();
+	}
 
 	if ((deviceNum >= 0)&&(deviceNum < _nCdromDevice))
 	{
@@ -1139,6 +2709,9 @@ CDIF_Deinit()
 		CloseHandle(_hEvent);
 	}
 
+	close_image();
+	CDIF_SetCommandLog(NULL);
+
 	//Kitaoǉ
 	if (_SPTIfileHandle != INVALID_HANDLE_VALUE)
 	{
@@ -1358,6 +2931,9 @@ CDIF_SetSpeed(
 	BYTE	lun = (BYTE)_CdromInfo[_DeviceInUse].lun;
 	BOOL	bSuccess;
 
+	if (_bImage) //fBXNC[W̏ꍇ͐ݒsv
+		return TRUE;
+
 	waitDeviceBusy();
 	_bDeviceBusy = TRUE;
 
@@ -1805,3 +3381,220 @@ CDIF_GetBadInstalled()
 {
 	return _bBadInstalled;
 }
+
+
+//fBXNC[WNĂꍇTRUEԂB
+BOOL
+CDIF_IsImage()
+{
+	return _bImage;
+}
+
+
+//CDXbhŏR}ht@C֋L^BNULLw肷ƋL^IB
+//͂Ps"o߃~b R}h LBA ZN^["BCDIF_Benchmark()ōĐłB
+BOOL
+CDIF_SetCommandLog(
+	const char*	pFileName)
+{
+	if (_fpCommandLog != NULL)
+	{
+		fclose(_fpCommandLog);
+		_fpCommandLog = NULL;
+	}
+	if (pFileName == NULL)
+		return TRUE;
+
+	_fpCommandLog = fopen(pFileName, "w");
+	_CommandLogTime = timeGetTime();
+
+	return (_fpCommandLog != NULL);
+}
+
+
+/*-----------------------------------------------------------------------------
+	[Benchmark]
+		CDIF_SetCommandLog()ŋL^R}hOfBXNC[Wɑ΂čĐ
+		AV[N(AĂȂANZX)̑҂ԂƓ]xv܂B
+		ǂ݂ȂȄɌv܂BOS̃t@CLbV̉e낦
+		߁Av̑OɈxOǂ݂܂BR}hԂ̊Ԋu͋L^ǂ
+		҂܂AIMAGE_BENCH_MAXWAIT~bőł؂܂B
+-----------------------------------------------------------------------------*/
+BOOL
+CDIF_Benchmark(
+	const char*	pLogFileName,
+	const char*	pImageFileName,
+	char*		pReport,
+	int			reportSize)
+{
+	FILE*			fp;
+	char			buf[256];
+	char			name[32];
+	CdLogEntry*		pLog = NULL;
+	Sint32			nLog = 0;
+	Sint32			maxLog = 0;
+	Uint32			maxSectors = 0;
+	DWORD			time;
+	Uint32			lba;
+	Uint32			nSectors;
+	Uint32			command;
+	Uint8*			pBuf;
+	CdArg			arg;
+	int				pass;
+	Sint32			i;
+	DWORD			wait;
+	Uint32			prevEnd;
+	LARGE_INTEGER	freq;
+	LARGE_INTEGER	t1;
+	LARGE_INTEGER	t2;
+	double			ms;
+	double			total[2];
+	double			seekTotal[2];
+	double			seekMax[2];
+	Sint32			nSeek[2];
+	double			bytes = 0.0;
+	char			line[2][160];
+
+	strcpy(pReport, "");
+	if ((fp = fopen(pLogFileName, "r")) == NULL)
+	{
+		_snprintf(pReport, reportSize, "%s: log not found.\n", pLogFileName);
+		return FALSE;
+	}
+	while (fgets(buf, 255, fp))
+	{
+		if (sscanf(buf, "%lu %31s %lu %lu", &time, name, &lba, &nSectors) != 4)
+			continue;
+		if (strcmp(name,"read") == 0)			command = CDIF_READ;
+		else if (strcmp(name,"seekdata") == 0)	command = CDIF_SEEKDATA;
+		else if (strcmp(name,"seek") == 0)		command = CDIF_SEEK;
+		else if (strcmp(name,"cdda") == 0)		command = CDIF_READCDDA;
+		else if (strcmp(name,"cdda2") == 0)		command = CDIF_READCDDA2;
+		else if (strcmp(name,"play") == 0)		command = CDIF_PLAYCDDA;
+		else continue;
+		if (nLog == maxLog)
+		{
+			maxLog += 4096;
+			pLog = (CdLogEntry*)realloc(pLog, maxLog * sizeof(CdLogEntry));
+			if (pLog == NULL)
+			{
+				fclose(fp);
+				return FALSE;
+			}
+		}
+		pLog[nLog].time = time;
+		pLog[nLog].command = command;
+		pLog[nLog].lba = lba;
+		pLog[nLog].nSectors = nSectors;
+		if (nSectors > maxSectors)
+			maxSectors = nSectors;
+		nLog++;
+	}
+	fclose(fp);
+	if (nLog == 0)
+	{
+		_snprintf(pReport, reportSize, "%s: no commands.\n", pLogFileName);
+		free(pLog);
+		return FALSE;
+	}
+
+	if (!open_image(pImageFileName))
+	{
+		_snprintf(pReport, reportSize, "%s: could not open image.\n", pImageFileName);
+		free(pLog);
+		return FALSE;
+	}
+	pBuf = (Uint8*)malloc(maxSectors * 2352 + 2352);
+	if (pBuf == NULL)
+	{
+		close_image();
+		free(pLog);
+		return FALSE;
+	}
+
+	QueryPerformanceFrequency(&freq);
+	for (pass=-1; pass<2; pass++) //pass=-1̓t@CLbV낦邽߂̋ǂ
+	{
+		_bReadAhead = (pass == 1);
+		image_clear_cache();
+		_LastEndLba = 0xFFFFFFFF;
+		prevEnd = 0xFFFFFFFF;
+		if (pass >= 0)
+		{
+			total[pass] = seekTotal[pass] = seekMax[pass] = 0.0;
+			nSeek[pass] = 0;
+		}
+		for (i=0; i<nLog; i++)
+		{
+			if ((pass >= 0)&&(i > 0))
+			{
+				wait = pLog[i].time - pLog[i-1].time;
+				if (wait > IMAGE_BENCH_MAXWAIT)
+					wait = IMAGE_BENCH_MAXWAIT;
+				if (wait > 0)
+					Sleep(wait);
+			}
+			ZeroMemory(&arg, sizeof(arg));
+			arg.command = pLog[i].command;
+			arg.pBuf = pBuf;
+			arg.startLBA = pLog[i].lba;
+			arg.endLBA = pLog[i].lba + pLog[i].nSectors;
+
+			QueryPerformanceCounter(&t1);
+			switch (arg.command)
+			{
+				case CDIF_READ:
+				case CDIF_SEEKDATA:
+					image_read(&arg);
+					break;
+				case CDIF_SEEK:
+				case CDIF_READCDDA:
+				case CDIF_READCDDA2:
+					image_read_cdda(&arg);
+					break;
+				case CDIF_PLAYCDDA:
+					image_read_ahead(_LastEndLba, _LastEndLba, TRUE);
+					break;
+			}
+			QueryPerformanceCounter(&t2);
+			if (pass < 0)
+			{
+				if ((arg.command == CDIF_READ)||(arg.command == CDIF_SEEKDATA))
+					bytes += pLog[i].nSectors * 2048.0;
+				else
+					bytes += pLog[i].nSectors * 2352.0;
+				continue;
+			}
+
+			ms = (double)(t2.QuadPart - t1.QuadPart) * 1000.0 / (double)freq.QuadPart;
+			total[pass] += ms;
+			if ((pLog[i].nSectors != 0)&&(pLog[i].lba != prevEnd))
+			{
+				nSeek[pass]++;
+				seekTotal[pass] += ms;
+				if (ms > seekMax[pass])
+					seekMax[pass] = ms;
+			}
+			if (pLog[i].nSectors != 0)
+				prevEnd = pLog[i].lba + pLog[i].nSectors;
+		}
+	}
+	_bReadAhead = TRUE;
+	close_image();
+	free(pBuf);
+
+	for (pass=0; pass<2; pass++)
+		_snprintf(line[pass], sizeof(line[pass]), "  read-ahead %s: seek avg %.3f ms, max %.3f ms (%ld seeks), %.3f ms/command, %.1f MB/s\n",
+				  (pass == 0) ? "off" : "on ",
+				  (nSeek[pass] > 0) ? seekTotal[pass] / nSeek[pass] : 0.0,
+				  seekMax[pass],
+				  nSeek[pass],
+				  total[pass] / nLog,
+				  (total[pass] > 0.0) ? bytes / (1024.0*1024.0) / (total[pass] / 1000.0) : 0.0);
+	_snprintf(pReport, reportSize, "%s\n  log: %s (%ld commands, %.1f MB)\n%s%s",
+			  pImageFileName, pLogFileName, nLog, bytes / (1024.0*1024.0), line[0], line[1]);
+	pReport[reportSize-1] = 0;
+	free(pLog);
+
+	return TRUE;
+}
@@ -250,4 +250,24 @@ BOOL
 CDIF_GetBadInstalled();
 
 
+//fBXNC[W(CUE/BIN,ISO,CHD)p
+BOOL
+CDIF_IsImageFile(
+	const char*	pFileName);
+
+BOOL
+CDIF_IsImage();
+
+BOOL
+CDIF_SetCommandLog(
+	const char*	pFileName);			// NULLw肷ƋL^I
+
+BOOL
+CDIF_Benchmark(
+	const char*	pLogFileName,		// CDIF_SetCommandLog()ŋL^O
+	const char*	pImageFileName,
+	char*		pReport,			// ʂ̕̕ۑ
+	int			reportSize);
+
+
 #endif /* CDROM_INTERFACE_H_INCLUDED */
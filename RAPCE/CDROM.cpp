@@ -354,6 +354,7 @@ static void
 check_game()
 {
 	char*	pGameTitle;
+	Sint32	gameID;
 	char	cdMessage[256];
 
 	//CDANZX𑬂(܂͒x)ݒɂĂꍇ́AftHgݒɖ߂B
@@ -446,6 +447,7 @@ check_game()
 					//^_]ppb`𖳌ɖ߂B
 		
 		pGameTitle = TOCDB_GetGameTitle();
+		gameID = TOCDB_GetGameID(); //Q[Ƃ̃pb`͂IDōs
 		
 		switch (_CDInstall)
 		{
@@ -468,63 +470,74 @@ check_game()
 			PRINTF("%s", cdMessage);
 		
 		//NI܂ŊmɃ}`^bv𖳌ɂȂ΂ȂȂQ[
-		if ((strcmp(pGameTitle,"Linda Cube (J)") == 0)|| //_L[uB^CgʂŕKvB
-			(strcmp(pGameTitle,"Linda Cube [first] (J)") == 0)|| //_L[uo(oO)
-			(strcmp(pGameTitle,"Emerald Dragon (J)") == 0)|| //GhhSBMB128̃[eBeBĝɕKvB
-			(strcmp(pGameTitle,"Shin Megami Tensei (J)") == 0)|| //^_]B}`^bvMB128FĂ܂s(@łN)ɑΉB
-			(strcmp(pGameTitle,"Bazaar de Gozahru no Game de Gozahru (J)") == 0)|| //oU[ł[BOȂƃR삪ȂBv2.08
-			(strcmp(pGameTitle,"Ginga Ojousama Densetsu Yuna II (J)") == 0)) //͂l`iQB^CgʂŕKvB
+		switch (gameID)
 		{
+			case TOCDB_LINDA_CUBE_J: //_L[uB^CgʂŕKvB
+			case TOCDB_LINDA_CUBE_FIRST_J: //_L[uo(oO)
+			case TOCDB_EMERALD_DRAGON_J: //GhhSBMB128̃[eBeBĝɕKvB
+			case TOCDB_SHIN_MEGAMI_TENSEI_J: //^_]B}`^bvMB128FĂ܂s(@łN)ɑΉB
+			case TOCDB_BAZAAR_DE_GOZAHRU_NO_GAME_DE_GOZAHRU_J: //oU[ł[BOȂƃR삪ȂBv2.08
+			case TOCDB_GINGA_OJOUSAMA_DENSETSU_YUNA_II_J: //͂l`iQB^CgʂŕKvB
 				JOYPAD_ConnectMultiTap(FALSE);//}`^bv𖳌ɁB
 				_bAutoDisconnectMultiTap = TRUE;//ߋo[W̃Xe[gZ[uǂݍ񂾏ꍇL[v邽߂ɕKvB
+				break;
 		}
 		
 		//ftHgŃ}`^bv𖳌ɂقQ[
-		if ((strcmp(pGameTitle,"Chou Aniki (J)") == 0)|| //ZMBIvV̒eo悤ɁB
-			(strcmp(pGameTitle,"Card Angels (J)") == 0)) //J[hGWFXBj̗Zg悤ɁB
+		switch (gameID)
+		{
+			case TOCDB_CHOU_ANIKI_J: //ZMBIvV̒eo悤ɁB
+			case TOCDB_CARD_ANGELS_J: //J[hGWFXBj̗Zg悤ɁB
 				JOYPAD_ConnectMultiTap(FALSE);//}`^bv𖳌ɁB
+				break;
+		}
 
 		//MB128𖳌ɂȂ΂ȂȂQ[
-		if (strcmp(pGameTitle,"Magicoal (J)") == 0) //}WN[B̓[hɃt[ŶMB128OBC\Bv2.17
+		if (gameID == TOCDB_MAGICOAL_J) //}WN[B̓[hɃt[ŶMB128OBC\Bv2.17
 			JOYPAD_ConnectMB128(FALSE);//MB128𖳌ɁB
 		
-		if ((strcmp(pGameTitle,"Advanced Variable Geo (J)") == 0)|| //Ah@XgV.G.
-			(strcmp(pGameTitle,"Emerald Dragon (J)") == 0)|| //GhhS
-			(strcmp(pGameTitle,"Kakutou Haou Densetsu Algunos (J)") == 0)|| //ie`AKmX
-			(strcmp(pGameTitle,"Kabuki Ittouryoudan (J)") == 0)|| //VOJuL꓁k
-			(strcmp(pGameTitle,"Garou Densetsu II (J)") == 0)|| //T`Q
-			(strcmp(pGameTitle,"Garou Densetsu II - Sample Disc (J)") == 0)|| //T`QTvfBXN
-			(strcmp(pGameTitle,"Garou Densetsu Special (J)") == 0)|| //T`SPECIAL
-			(strcmp(pGameTitle,"Ginga Ojousama Densetsu Yuna II (J)") == 0)|| //͂l`iQ
-			(strcmp(pGameTitle,"Super Real Mahjong P II & III Custom (J)") == 0)|| //X[p[AP-II/III JX^
-			(strcmp(pGameTitle,"Super Real Mahjong P V Custom (J)") == 0)|| //X[p[AP-V JX^
-			(strcmp(pGameTitle,"FirePro Jyoshi - Dome ChoujouKessen (J)") == 0)|| //t@Cvqΐ
-			(strcmp(pGameTitle,"Flash Hiders (J)") == 0)|| //tbVnC_[X
-			(strcmp(pGameTitle,"Princess Maker II (J)") == 0)|| //vZX[J[Q
-			//(strcmp(pGameTitle,"Martial Champions (J)") == 0)|| //}[V`sI ͂U{^ɂI,II,RUN{^ȂȂsBRCQ{^pbhŎxႪ̂ŁAU{^ȂȂ悤ɂBv0.98
-			(strcmp(pGameTitle,"Mahjong Sword (J)") == 0)|| //}[W\[hEvZXNGXgO`
-			(strcmp(pGameTitle,"Ryuuko no Ken (J)") == 0)|| //Ղ̌
-			(strcmp(pGameTitle,"Linda Cube (J)") == 0)|| //_L[u
-			(strcmp(pGameTitle,"Linda Cube [first] (J)") == 0)|| //_L[uo(oO)
-			(strcmp(pGameTitle,"World Heroes II (J)") == 0)) //[hq[[YQ
-			{
+		switch (gameID)
+		{
+			case TOCDB_ADVANCED_VARIABLE_GEO_J: //Ah@XgV.G.
+			case TOCDB_EMERALD_DRAGON_J: //GhhS
+			case TOCDB_KAKUTOU_HAOU_DENSETSU_ALGUNOS_J: //ie`AKmX
+			case TOCDB_KABUKI_ITTOURYOUDAN_J: //VOJuL꓁k
+			case TOCDB_GAROU_DENSETSU_II_J: //T`Q
+			case TOCDB_GAROU_DENSETSU_II_SAMPLE_DISC_J: //T`QTvfBXN
+			case TOCDB_GAROU_DENSETSU_SPECIAL_J: //T`SPECIAL
+			case TOCDB_GINGA_OJOUSAMA_DENSETSU_YUNA_II_J: //͂l`iQ
+			case TOCDB_SUPER_REAL_MAHJONG_P_II_AND_III_CUSTOM_J: //X[p[AP-II/III JX^
+			case TOCDB_SUPER_REAL_MAHJONG_P_V_CUSTOM_J: //X[p[AP-V JX^
+			case TOCDB_FIREPRO_JYOSHI_DOME_CHOUJOUKESSEN_J: //t@Cvqΐ
+			case TOCDB_FLASH_HIDERS_J: //tbVnC_[X
+			case TOCDB_PRINCESS_MAKER_II_J: //vZX[J[Q
+			//case TOCDB_MARTIAL_CHAMPIONS_J: //}[V`sI ͂U{^ɂI,II,RUN{^ȂȂsBRCQ{^pbhŎxႪ̂ŁAU{^ȂȂ悤ɂBv0.98
+			case TOCDB_MAHJONG_SWORD_J: //}[W\[hEvZXNGXgO`
+			case TOCDB_RYUUKO_NO_KEN_J: //Ղ̌
+			case TOCDB_LINDA_CUBE_J: //_L[u
+			case TOCDB_LINDA_CUBE_FIRST_J: //_L[uo(oO)
+			case TOCDB_WORLD_HEROES_II_J: //[hq[[YQ
 				JOYPAD_UseSixButton(TRUE);//łU{^pbhݒɂB
 				PRINTF("Connected 6-button pad.  %s", cdMessage);
-			}
+				break;
+		}
 		
-		if ((strcmp(pGameTitle,"Martial Champions (J)") == 0)|| //}[V`sI
-			(strcmp(pGameTitle,"Card Angels (J)") == 0)) //J[hGWFX
-			{
+		switch (gameID)
+		{
+			case TOCDB_MARTIAL_CHAMPIONS_J: //}[V`sI
+			case TOCDB_CARD_ANGELS_J: //J[hGWFX
 				if (!JOYPAD_GetConnectThreeButton()) //NQ{^pbhȂłꍇ
 				{
 					JOYPAD_UseThreeButton(TRUE);//łR{^pbhݒɂB
 					PRINTF("Connected 3-button pad.  %s", cdMessage);
 				}
-			}
+				break;
+		}
 		
-		if ((strcmp(pGameTitle,"Forgotten Worlds (J)") == 0)|| //tHSbg[h
-			(strcmp(pGameTitle,"Forgotten Worlds (U)") == 0)) //tHSbg[h(U)
-			{
+		switch (gameID)
+		{
+			case TOCDB_FORGOTTEN_WORLDS_J: //tHSbg[h
+			case TOCDB_FORGOTTEN_WORLDS_U: //tHSbg[h(U)
 				JOYPAD_SetSwapSelRun(TRUE); //SEL{^RUN{^ւ
 				if (!JOYPAD_GetConnectThreeButton()) //NQ{^pbhȂłꍇ
 				{
@@ -533,337 +546,373 @@ check_game()
 				}
 				else //ŏR{^pbhȂłꍇ
 					PRINTF("Swapped Select&Run Buttons.  %s", cdMessage);
-			}
+				break;
+		}
 		
-		if ((strcmp(pGameTitle,"A. III (J)") == 0)|| //`ԂōsIII
-			(strcmp(pGameTitle,"The Atlas (J)") == 0)|| //THE ATLAS
-			(strcmp(pGameTitle,"Eikan ha Kimini (J)") == 0)|| //h͌N
-			(strcmp(pGameTitle,"Tokimeki Memorial (J)") == 0)|| //Ƃ߂A
-			(strcmp(pGameTitle,"Vasteel II (J)") == 0)|| //oXeB[Q
-			(strcmp(pGameTitle,"Power Golf 2 - Golfer (J)") == 0)|| //p[StQ
-			(strcmp(pGameTitle,"Hatsukoi Monogatari (J)") == 0)|| //
-			(strcmp(pGameTitle,"Metal Angel (J)") == 0)|| //^GWF
-			(strcmp(pGameTitle,"Nemurenuyoru no Chiisana Ohanashi (J)") == 0)|| //Rq́ȕȂbv
-			(strcmp(pGameTitle,"Doukyuusei (J)") == 0)) //
-			{
+		switch (gameID)
+		{
+			case TOCDB_A_III_J: //`ԂōsIII
+			case TOCDB_THE_ATLAS_J: //THE ATLAS
+			case TOCDB_EIKAN_HA_KIMINI_J: //h͌N
+			case TOCDB_TOKIMEKI_MEMORIAL_J: //Ƃ߂A
+			case TOCDB_VASTEEL_II_J: //oXeB[Q
+			case TOCDB_POWER_GOLF_2_GOLFER_J: //p[StQ
+			case TOCDB_HATSUKOI_MONOGATARI_J: //
+			case TOCDB_METAL_ANGEL_J: //^GWF
+			case TOCDB_NEMURENUYORU_NO_CHIISANA_OHANASHI_J: //Rq́ȕȂbv
+			case TOCDB_DOUKYUUSEI_J: //
 				JOYPAD_ConnectMultiTap(FALSE);
 				JOYPAD_ConnectMouse(TRUE);
 				PRINTF("Mouse [ WheelDown = RUN ].  %s", cdMessage);
-			}//Ń}EXȂBufBbVAvZX[J[QA㕨R̓pbh₷Ǝv̂ł̂܂܂
-		if (strcmp(pGameTitle,"1552 Tenka Tairan (J)") == 0) //1552V嗐
-		{
-			JOYPAD_ConnectMultiTap(FALSE);
-			JOYPAD_ConnectMouse(TRUE);
-			PRINTF("Mouse [ Do WheelUp(SELECT) after started. ].  %s", cdMessage);
-		}//Ń}EXȂB}EXւ̐؂ւ(SELECT{^)̐B
-		if (strcmp(pGameTitle,"Lemmings (J)") == 0) //~OX
-		{
-			JOYPAD_ConnectMultiTap(FALSE);
-			JOYPAD_ConnectMouse(TRUE);
-			JOYPAD_SetSwapIandII(TRUE);
-			PRINTF("Mouse [ WheelDown = RUN ].  Swapped I & II Buttons.  %s", cdMessage);
-		}//Ń}EXȂBI{^II{^ւB
+				//Ń}EXȂBufBbVAvZX[J[QA㕨R̓pbh₷Ǝv̂ł̂܂܂
+				break;
+			
+			case TOCDB_1552_TENKA_TAIRAN_J: //1552V嗐
+				JOYPAD_ConnectMultiTap(FALSE);
+				JOYPAD_ConnectMouse(TRUE);
+				PRINTF("Mouse [ Do WheelUp(SELECT) after started. ].  %s", cdMessage);
+				//Ń}EXȂB}EXւ̐؂ւ(SELECT{^)̐B
+				break;
+			
+			case TOCDB_LEMMINGS_J: //~OX
+				JOYPAD_ConnectMultiTap(FALSE);
+				JOYPAD_ConnectMouse(TRUE);
+				JOYPAD_SetSwapIandII(TRUE);
+				PRINTF("Mouse [ WheelDown = RUN ].  Swapped I & II Buttons.  %s", cdMessage);
+				//Ń}EXȂBI{^II{^ւB
+				break;
+		}
 		
 		//X^荞݂̃^C~Oݒ(Yɓ)
-		if (strcmp(pGameTitle,"Super Darius II (J)") == 0) //X[p[_CAXII(nCXRA\)
+		switch (gameID)
+		{
+			case TOCDB_SUPER_DARIUS_II_J: //X[p[_CAXII(nCXRA\)
 				VDC_SetAutoRasterTiming(5); //MORE LATE
-		if ((strcmp(pGameTitle,"Magicoal (J)") == 0)|| //}WN[
-			(strcmp(pGameTitle,"Legion (J)") == 0)) //MI
+				break;
+			
+			case TOCDB_MAGICOAL_J: //}WN[
+			case TOCDB_LEGION_J: //MI
 				VDC_SetAutoRasterTiming(3); //LATE
+				break;
+		}
 		
 		//XN[̃mXgb`ortXgb`ݒő傫Ȗ肪\tg(CPʂŉ𑜓xύXĂQ[)͎ŃAXgb`ɂ
-		if ((strcmp(pGameTitle,"Ryuuko no Ken (J)") == 0)|| //Ղ̌
-			(strcmp(pGameTitle,"Yami no Ketsuzoku Harukanaru Kioku (J)") == 0)) //ł̌(𑜓xł͂Ȃ\[Xhbg̕ύXBAXgb`Kv)
+		switch (gameID)
 		{
-			_AutoRealStretched = APP_GetStartStretchMode(); //ύXÕXgb`ݒۑBv2.64
-			if (_AutoRealStretched != 1)
-				APP_SetStartStretchMode(1); //v2.64B//ݒt@Cɂ͕ۑAꎞIɃAXgb`֕ύXBv2.64
-		}		
+			case TOCDB_RYUUKO_NO_KEN_J: //Ղ̌
+			case TOCDB_YAMI_NO_KETSUZOKU_HARUKANARU_KIOKU_J: //ł̌(𑜓xł͂Ȃ\[Xhbg̕ύXBAXgb`Kv)
+				_AutoRealStretched = APP_GetStartStretchMode(); //ύXÕXgb`ݒۑBv2.64
+				if (_AutoRealStretched != 1)
+					APP_SetStartStretchMode(1); //v2.64B//ݒt@Cɂ͕ۑAꎞIɃAXgb`֕ύXBv2.64
+				break;
+		}
 
 		//XvCgČ\tg
-		if ((strcmp(pGameTitle,"Tengai Makyou - Fuuun Kabuki Den (J)") == 0)|| //_JuL`BbZ[WEBhEɃLȂ悤ɁB
-			(strcmp(pGameTitle,"Lodoss Tou Senki II (J)") == 0)|| //[hXLIIBUN\̃p[̉Ƃ̃rWAV[ȂǂŁA݂oȂ悤ɁB
-			(strcmp(pGameTitle,"Princess Maker II (J)") == 0)|| //vZX[J[QBf̃^CgʂŉEɔ~̃S~oȂ悤ɁBv2.10
-			(strcmp(pGameTitle,"Ranma 1-2 (J)") == 0)|| //1/2BOPf̃vCIeBBv2.61
-			(strcmp(pGameTitle,"Bonanza Bros. (J)") == 0)|| //{iUuU[YB^Cgʂ̃vCIeBBv2.34
-			(strcmp(pGameTitle,"Nekketsu Koukou Soccer Hen (J)") == 0)|| //MZTbJ[ҁBXe[^X\ɃLȂ悤ɁB
-			(strcmp(pGameTitle,"GALAXY Deka GAYVAN (J)") == 0)|| //GALAXYYKCoBOPf̃ebvȂ悤ɁB
-			(strcmp(pGameTitle,"Nemurenuyoru no Chiisana Ohanashi (J)") == 0)|| //Rq́ȕȂbvBXvCg𗘗prWAV[Bv2.17Bv2.26
-			(strcmp(pGameTitle,"Black Hole Assault (J)") == 0)|| //ubNz[ATgBXvCg𗘗prWAV[Bv2.34
-			(strcmp(pGameTitle,"Quiz Tonosama no Yabou (J)") == 0)) //NCYal̖]BI[vjOfŃXvCgČB
+		switch (gameID)
+		{
+			case TOCDB_TENGAI_MAKYOU_FUUUN_KABUKI_DEN_J: //_JuL`BbZ[WEBhEɃLȂ悤ɁB
+			case TOCDB_LODOSS_TOU_SENKI_II_J: //[hXLIIBUN\̃p[̉Ƃ̃rWAV[ȂǂŁA݂oȂ悤ɁB
+			case TOCDB_PRINCESS_MAKER_II_J: //vZX[J[QBf̃^CgʂŉEɔ~̃S~oȂ悤ɁBv2.10
+			case TOCDB_RANMA_1_2_J: //1/2BOPf̃vCIeBBv2.61
+			case TOCDB_BONANZA_BROS_J: //{iUuU[YB^Cgʂ̃vCIeBBv2.34
+			case TOCDB_NEKKETSU_KOUKOU_SOCCER_HEN_J: //MZTbJ[ҁBXe[^X\ɃLȂ悤ɁB
+			case TOCDB_GALAXY_DEKA_GAYVAN_J: //GALAXYYKCoBOPf̃ebvȂ悤ɁB
+			case TOCDB_NEMURENUYORU_NO_CHIISANA_OHANASHI_J: //Rq́ȕȂbvBXvCg𗘗prWAV[Bv2.17Bv2.26
+			case TOCDB_BLACK_HOLE_ASSAULT_J: //ubNz[ATgBXvCg𗘗prWAV[Bv2.34
+			case TOCDB_QUIZ_TONOSAMA_NO_YABOU_J: //NCYal̖]BI[vjOfŃXvCgČB
 				VDC_SetAutoPerformSpriteLimit(TRUE);
+				break;
+		}
 		
-		//if ((strcmp(pGameTitle,"A. III (J)") == 0)|| //`ԂōsIII
-		//	(strcmp(pGameTitle,"Vasteel II (J)") == 0)) //oXeB[Q
+		//switch (gameID)
+		//{
+		//	case TOCDB_A_III_J: //`ԂōsIII
+		//	case TOCDB_VASTEEL_II_J: //oXeB[Q
 		//		VDC_SetAutoOverClock(6);//KɗVԂ߂ɑxAbvݒɂB
+		//		break;
+		//}
 		
 		//CDV[N&[hᑬ(@݁BȂǂ̑傫ȃf[^ȊO͍V[N̂܂܁B)ɂQ[
-		if ((strcmp(pGameTitle,"Uchuu Senkan Yamato (J)") == 0)|| //F̓}gBfʂî݂B
-			(strcmp(pGameTitle,"Metal Angel II (J)") == 0)|| //^GWFQBCxgV[ŉʉYȂ߂ɕKvB
-			(strcmp(pGameTitle,"Shin Onryou Senki (J)") == 0)) //^LBfʂî݂B
+		switch (gameID)
 		{
-	 		//rWAV[̉h߁ACDANZX𑬂ݒɁB
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-	 		//rWAV[̉h߁ACDV[Nm[}ݒɁB
-			_bFastSeek = FALSE;
-			_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
-			//bcCXg[̏ꍇAbZ[W\B
-			//  F̓}ǵAANZXxƋHɓrADPCMĂ܂ƂB
-			//  ^GWFQ́ACxgV[(Ղ̊}V[)ŉʉȂ߂ɕKvB
-			//  ^ĹA^Cg(X^[gďoẴ^Cg)Ń^C~O킹邽ߕKvB
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+			case TOCDB_UCHUU_SENKAN_YAMATO_J: //F̓}gBfʂî݂B
+			case TOCDB_METAL_ANGEL_II_J: //^GWFQBCxgV[ŉʉYȂ߂ɕKvB
+			case TOCDB_SHIN_ONRYOU_SENKI_J: //^LBfʂî݂B
+				//rWAV[̉h߁ACDANZX𑬂ݒɁB
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				//rWAV[̉h߁ACDV[Nm[}ݒɁB
+				_bFastSeek = FALSE;
+				_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
+				//bcCXg[̏ꍇAbZ[W\B
+				//  F̓}ǵAANZXxƋHɓrADPCMĂ܂ƂB
+				//  ^GWFQ́ACxgV[(Ղ̊}V[)ŉʉȂ߂ɕKvB
+				//  ^ĹA^Cg(X^[gďoẴ^Cg)Ń^C~O킹邽ߕKvB
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+				break;
 		}
 
 		//CDV[Nx(@͑B[hANZX͑܂܁B)Q[
-		if ((strcmp(pGameTitle,"Fighting Street (J)") == 0)||
-			(strcmp(pGameTitle,"Fighting Street (U)") == 0)|| //t@CeBOXg[gBƂ(Ⴊ݂ŌtƂ)ADPCMȂƂB
-			(strcmp(pGameTitle,"Jantei Monogatari (J)") == 0)|| //㕨B|Cg̋ZIʂŗ邱Ƃ肪Bv2.34
-			(strcmp(pGameTitle,"DE-JA (J)") == 0)|| //DEEJABʂ̗@݂ɌyBv2.40
-			(strcmp(pGameTitle,"Psychic Storm (J)") == 0)|| //TCLbNXg[BX^[gȂǉʐ؂ւɗꂪo邱Ƃ肪Bv2.17
-			(strcmp(pGameTitle,"Pop'n Magic (J)") == 0)) //ۂ'n܂BX^[gfȂ悤ɂ邽ߕKvB
-				_bSeekWait = TRUE; //CDV[NxݒɁB
-
-		//CDV[Nx(@͑B[hANZX͑܂܁B)Q[
-		if (strcmp(pGameTitle,"Vasteel (J)") == 0) //oXeB[BfV[ŉr؂Ȃ߂ɕKvBv2.34
+		switch (gameID)
 		{
-			_bSeekWait = TRUE; //CDV[NxݒɁB
-			_bSeekWait2 = TRUE; //ʏ_bSeekWait菭Ȗڂ̃EFCgB
+			case TOCDB_FIGHTING_STREET_J:
+			case TOCDB_FIGHTING_STREET_U: //t@CeBOXg[gBƂ(Ⴊ݂ŌtƂ)ADPCMȂƂB
+			case TOCDB_JANTEI_MONOGATARI_J: //㕨B|Cg̋ZIʂŗ邱Ƃ肪Bv2.34
+			case TOCDB_DE_JA_J: //DEEJABʂ̗@݂ɌyBv2.40
+			case TOCDB_PSYCHIC_STORM_J: //TCLbNXg[BX^[gȂǉʐ؂ւɗꂪo邱Ƃ肪Bv2.17
+			case TOCDB_POPN_MAGIC_J: //ۂ'n܂BX^[gfȂ悤ɂ邽ߕKvB
+				_bSeekWait = TRUE; //CDV[NxݒɁB
+				break;
+			
+			//CDV[Nx(@͑B[hANZX͑܂܁B)Q[
+			case TOCDB_VASTEEL_J: //oXeB[BfV[ŉr؂Ȃ߂ɕKvBv2.34
+				_bSeekWait = TRUE; //CDV[NxݒɁB
+				_bSeekWait2 = TRUE; //ʏ_bSeekWait菭Ȗڂ̃EFCgB
+				break;
 		}
 
 		//CDV[Nx(@͑BV[NuԎ͑܂܂ŁA[hANZXɃEFCgB)Q[
-/*		if ((strcmp(pGameTitle,"Psychic Storm (J)") == 0)) //TCLbNXg[B_bSeekWaitōs悤ɂ߃JbgBv2.17
+/*		if (gameID == TOCDB_PSYCHIC_STORM_J) //TCLbNXg[B_bSeekWaitōs悤ɂ߃JbgBv2.17
 		{
 			_bFastSeek = FALSE;
 			_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
 		}
 */
 		//CD[hANZXx(V[N͑܂)Q[
-		if ((strcmp(pGameTitle,"3 x 3 Eyes - Sanjiyan Hensei (J)") == 0)|| //TUACYBmA[P[hJ[hQ[̃fʂî݂B
-			(strcmp(pGameTitle,"Garou Densetsu II (J)") == 0)|| //T`QBQ[I[o[̃bZ[W\̂̂Bv2.60
-			(strcmp(pGameTitle,"Jantei Monogatari III (J)") == 0)) //㕨RBrWAV[ŉʂ̂B
-		{
-			_bReadWait = TRUE; //CD[hANZXxݒɁB
-		}
-
- 		//CDANZXƉʂî݂Ŏ@̃ANZXEFCgB
-		//  Q[ɂẮANŏxƑ҂Ԃ̂ŁA^CgʂȂǔCӂ̃^C~O(CDDA̋ȃio[}Ƃ)ŒxB
-		if (strcmp(pGameTitle,"Mirai Shonen Conan (J)") == 0) //NRiBXe[WJnɃANZXƃt[YB
-			_bAccessWait = TRUE; //Xe[WJñ^C~OŃXe[g[hꍇz肵āAQ[ŏŌ܂ŃANZXEFCgĂB
- 		if (strcmp(pGameTitle,"Brandish (J)") == 0) //ufBbV
-		{
-			_AutoSlowAccess = 4; //dĨfrB̃gbNNo.CDDAĐȂꂽƓɁAȍ~CDANZXxB
-			_AutoRetAccess = 1000; //X^[gBGMB4ȊÕgbNNo.ŉCDDAĐȂꂽƓɁAȍ~CDANZX𑬂(ɖ߂)B
-		}
-		if (strcmp(pGameTitle,"Mugen Senshi Valis (J)") == 0) //@XP
+		switch (gameID)
 		{
-	 		//ANZXƋNɎ~܂Ă܂߁ACDV[NxݒɁB
-			_bSeekWait = TRUE;
-			_AutoSlowPlaySeekWait = 24; //I[vjOf㔼̃gbNĐƂ@݂̃V[NEFCgBpN̉YB
-			_AutoRetPlaySeekWait = 1000; //ȊŐȂ|瑬V[NEFCgɖ߂B
-		}
- 		if (strcmp(pGameTitle,"Double Dragon II (J)") == 0) //_uhSII
- 		{
- 			//X^[gʂRUN{^̃^CgR[Ō܂ŔBXe[WJñXe[W\(CDANZX)KxȒɁB
-			_bSeekWait = TRUE;
-			_bReadWait = TRUE;
-			_bDoubleDragon = TRUE; //X^[gʂRUN{^̃ANZX@̒xɂB
+			case TOCDB_3_X_3_EYES_SANJIYAN_HENSEI_J: //TUACYBmA[P[hJ[hQ[̃fʂî݂B
+			case TOCDB_GAROU_DENSETSU_II_J: //T`QBQ[I[o[̃bZ[W\̂̂Bv2.60
+			case TOCDB_JANTEI_MONOGATARI_III_J: //㕨RBrWAV[ŉʂ̂B
+				_bReadWait = TRUE; //CD[hANZXxݒɁB
+				break;
+			
+			//CDANZXƉʂî݂Ŏ@̃ANZXEFCgB
+			//  Q[ɂẮANŏxƑ҂Ԃ̂ŁA^CgʂȂǔCӂ̃^C~O(CDDA̋ȃio[}Ƃ)ŒxB
+			case TOCDB_MIRAI_SHONEN_CONAN_J: //NRiBXe[WJnɃANZXƃt[YB
+				_bAccessWait = TRUE; //Xe[WJñ^C~OŃXe[g[hꍇz肵āAQ[ŏŌ܂ŃANZXEFCgĂB
+				break;
+			
+			case TOCDB_BRANDISH_J: //ufBbV
+				_AutoSlowAccess = 4; //dĨfrB̃gbNNo.CDDAĐȂꂽƓɁAȍ~CDANZXxB
+				_AutoRetAccess = 1000; //X^[gBGMB4ȊÕgbNNo.ŉCDDAĐȂꂽƓɁAȍ~CDANZX𑬂(ɖ߂)B
+				break;
+			
+			case TOCDB_MUGEN_SENSHI_VALIS_J: //@XP
+				//ANZXƋNɎ~܂Ă܂߁ACDV[NxݒɁB
+				_bSeekWait = TRUE;
+				_AutoSlowPlaySeekWait = 24; //I[vjOf㔼̃gbNĐƂ@݂̃V[NEFCgBpN̉YB
+				_AutoRetPlaySeekWait = 1000; //ȊŐȂ|瑬V[NEFCgɖ߂B
+				break;
+			
+			case TOCDB_DOUBLE_DRAGON_II_J: //_uhSII
+				//X^[gʂRUN{^̃^CgR[Ō܂ŔBXe[WJñXe[W\(CDANZX)KxȒɁB
+				_bSeekWait = TRUE;
+				_bReadWait = TRUE;
+				_bDoubleDragon = TRUE; //X^[gʂRUN{^̃ANZX@̒xɂB
+				break;
 		}
 
 		//CDANZX(ftHg)ɂACDCXg[(f[^gbNւ̍ANZXKv)̃Q[B
-		if ((strcmp(pGameTitle,"Private Eyedol (J)") == 0)|| //vCx[gAChBV[QO҂̃X^[gfŕKvB
-			(strcmp(pGameTitle,"Tenshi no Uta (J)") == 0)|| //Vg̎B^CgʒAI[vjOɎ~܂Ă܂Ȃ悤ɁBX̕\ԂȂǂ傤ǂɂȂBv2.56
-			(strcmp(pGameTitle,"Tenshi no Uta II (J)") == 0)|| //Vg̎QBfʉt[YȂ߂ɕKvBv2.56
-			(strcmp(pGameTitle,"Dungeon Explorer II (J)") == 0)|| //_WGNXv[[IIBfʉYȂ߂ɕKvB
-			(strcmp(pGameTitle,"Dungeon Explorer II (U)") == 0)|| //_WGNXv[[II(US)
-			(strcmp(pGameTitle,"Travellers! Densetsu wo Buttobase (J)") == 0)|| //Ƃׂ[IBCxgV[ŉYȂ߂ɕKvB
-			(strcmp(pGameTitle,"Arunamu no Kiba (J)") == 0)) //AỉBX^[gfŃt[YȂ߂ɕKvB
-		{	//CDCXg[
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-			_bFastSeek = TRUE;
-			_AutoNormalSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
-			if ((strcmp(pGameTitle,"Tenshi no Uta (J)") == 0)|| //Vg̎B^CgʒAI[vjOɎ~܂Ă܂Ȃ悤ɁBX̕\ԂȂǂ傤ǂɂȂBv2.56
-				(strcmp(pGameTitle,"Tenshi no Uta II (J)") == 0)) //Vg̎QBfʉt[YȂ߂ɕKvBv2.56
-			{
-				_bSeekWait = TRUE; //CDV[NxݒɁB
-				_bSeekWait2 = TRUE; //Z߂̃EFCgOKB_bSeekWait݂̂ƒx̂ŁB
-			}
-			if ((strcmp(pGameTitle,"Dungeon Explorer II (J)") == 0)|| //_WGNXv[[II
-				(strcmp(pGameTitle,"Dungeon Explorer II (U)") == 0)) //_WGNXv[[II(US)
-			{
-				//rWAV[ŉʂȂ悤ɁAZEFCg(@Z)B
-				_bSeekWait = TRUE;
-				_bSeekWait3 = TRUE; //Z߂̃EFCgB_bSeekWait݂̂ƃEFCg傫ĉYB
-			}
+		switch (gameID)
+		{
+			case TOCDB_PRIVATE_EYEDOL_J: //vCx[gAChBV[QO҂̃X^[gfŕKvB
+			case TOCDB_TENSHI_NO_UTA_J: //Vg̎B^CgʒAI[vjOɎ~܂Ă܂Ȃ悤ɁBX̕\ԂȂǂ傤ǂɂȂBv2.56
+			case TOCDB_TENSHI_NO_UTA_II_J: //Vg̎QBfʉt[YȂ߂ɕKvBv2.56
+			case TOCDB_DUNGEON_EXPLORER_II_J: //_WGNXv[[IIBfʉYȂ߂ɕKvB
+			case TOCDB_DUNGEON_EXPLORER_II_U: //_WGNXv[[II(US)
+			case TOCDB_TRAVELLERS_DENSETSU_WO_BUTTOBASE_J: //Ƃׂ[IBCxgV[ŉYȂ߂ɕKvB
+			case TOCDB_ARUNAMU_NO_KIBA_J: //AỉBX^[gfŃt[YȂ߂ɕKvB
+				//CDCXg[
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				_bFastSeek = TRUE;
+				_AutoNormalSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+				switch (gameID)
+				{
+					case TOCDB_TENSHI_NO_UTA_J: //Vg̎B^CgʒAI[vjOɎ~܂Ă܂Ȃ悤ɁBX̕\ԂȂǂ傤ǂɂȂBv2.56
+					case TOCDB_TENSHI_NO_UTA_II_J: //Vg̎QBfʉt[YȂ߂ɕKvBv2.56
+						_bSeekWait = TRUE; //CDV[NxݒɁB
+						_bSeekWait2 = TRUE; //Z߂̃EFCgOKB_bSeekWait݂̂ƒx̂ŁB
+						break;
+					case TOCDB_DUNGEON_EXPLORER_II_J: //_WGNXv[[II
+					case TOCDB_DUNGEON_EXPLORER_II_U: //_WGNXv[[II(US)
+						//rWAV[ŉʂȂ悤ɁAZEFCg(@Z)B
+						_bSeekWait = TRUE;
+						_bSeekWait3 = TRUE; //Z߂̃EFCgB_bSeekWait݂̂ƃEFCg傫ĉYB
+						break;
+				}
+				break;
 		}
 
-		//CDANZX(ftHg)ɂACDtCXg[(ygbNւ̍ANZXKv)̃Q[B
-		if (strcmp(pGameTitle,"Doraemon Nobita no Dorabian Night (J)") == 0) //h(SCD)BʃNAȂǂɉʂȂ߂ɕKvB
-		{	//CDtCXg[
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-			_bFastSeek = TRUE;
-			_AutoNormalSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
-			if (_CDInstall != 2)
-				PRINTF("Recommend \"FullInstall\".  %s", cdMessage); //CXg[
-		}
-		
-		if 	(strcmp(pGameTitle,"Popful Mail (J)") == 0) //ۂՂ郁C
+		//̓Q[Ƃ̌ʂ̐ݒ
+		switch (gameID)
 		{
-			_PopfulMail = 1;
-			//^C~O̖肩ǂAʉ⍕ʏԂN邽߁ACPȖxグđΏB
-			VDC_SetAutoOverClock(200);//^[{Q{
-			//X^[gfJñCʂŁAXvCgČKvB
-			VDC_SetAutoPerformSpriteLimit(TRUE);
-	 		//rWAV[̉h߁ACDANZX𑬂ݒɁB
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-	 		//rWAV[̉h߁ACDV[Nm[}ݒɁB
-			_bFastSeek = FALSE;
-			_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
+			//CDANZX(ftHg)ɂACDtCXg[(ygbNւ̍ANZXKv)̃Q[B
+			case TOCDB_DORAEMON_NOBITA_NO_DORABIAN_NIGHT_J: //h(SCD)BʃNAȂǂɉʂȂ߂ɕKvB
+				//CDtCXg[
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				_bFastSeek = TRUE;
+				_AutoNormalSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+				if (_CDInstall != 2)
+					PRINTF("Recommend \"FullInstall\".  %s", cdMessage); //CXg[
+				break;
 			
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
-		}
-		
-		if ((strcmp(pGameTitle,"Sherlock Holmes no Tantei Kouza (J)") == 0)|| //V[bNz[YP
-			(strcmp(pGameTitle,"Sherlock Holmes Consulting Detective (U)") == 0)|| //V[bNz[YPUSA
-			(strcmp(pGameTitle,"Sherlock Holmes no Tantei Kouza II (J)") == 0)|| //V[bNz[YQ
-			(strcmp(pGameTitle,"Sherlock Holmes Volume II (U)") == 0)) //V[bNz[YQUSA
-		{
-			_bSherlock = TRUE; //rWAV[CDANZXɍœKȃEFCgĎ@Ɠl̓ɂB
+			case TOCDB_POPFUL_MAIL_J: //ۂՂ郁C
+				_PopfulMail = 1;
+				//^C~O̖肩ǂAʉ⍕ʏԂN邽߁ACPȖxグđΏB
+				VDC_SetAutoOverClock(200);//^[{Q{
+				//X^[gfJñCʂŁAXvCgČKvB
+				VDC_SetAutoPerformSpriteLimit(TRUE);
+				//rWAV[̉h߁ACDANZX𑬂ݒɁB
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				//rWAV[̉h߁ACDV[Nm[}ݒɁB
+				_bFastSeek = FALSE;
+				_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
+				
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+				break;
 			
-	 		//CDANZX𑬂ݒ
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-	 		//rWAV[̉h߁ACDV[NݒɁB
-			_bFastSeek = TRUE;
-			_AutoFastSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+			case TOCDB_SHERLOCK_HOLMES_NO_TANTEI_KOUZA_J: //V[bNz[YP
+			case TOCDB_SHERLOCK_HOLMES_CONSULTING_DETECTIVE_U: //V[bNz[YPUSA
+			case TOCDB_SHERLOCK_HOLMES_NO_TANTEI_KOUZA_II_J: //V[bNz[YQ
+			case TOCDB_SHERLOCK_HOLMES_VOLUME_II_U: //V[bNz[YQUSA
+				_bSherlock = TRUE; //rWAV[CDANZXɍœKȃEFCgĎ@Ɠl̓ɂB
+				
+				//CDANZX𑬂ݒ
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				//rWAV[̉h߁ACDV[NݒɁB
+				_bFastSeek = TRUE;
+				_AutoFastSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+				
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+				break;
 			
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
-		}
-		
- 		if (strcmp(pGameTitle,"Ys IV - The Dawn of Ys (J)") == 0) //C[XSBLl킪oĂCxgV[ł̉B
- 		{
-			_bYs4 = TRUE; //ȃ^C~ÕrWAV[̉YB
+			case TOCDB_YS_IV_THE_DAWN_OF_YS_J: //C[XSBLl킪oĂCxgV[ł̉B
+				_bYs4 = TRUE; //ȃ^C~ÕrWAV[̉YB
+				
+				//rWAV[̉h߁ACDANZX𑬂ݒɁB
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				//rWAV[̉h߁ACDV[Nm[}ݒɁB
+				_bFastSeek = FALSE;
+				_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
+				
+				JOYPAD_SetRenshaSpeedMax(3); //AˑxőLow܂łɗ}B
+				
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[BANZXxƃCxgV[łPC̗ꂪo邱ƂB
+				break;
 			
-	 		//rWAV[̉h߁ACDANZX𑬂ݒɁB
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-	 		//rWAV[̉h߁ACDV[Nm[}ݒɁB
-			_bFastSeek = FALSE;
-			_AutoNormalSeek = -1; //Q[NォFastSeekItɂ(ƂŌɖ߂߂ɕKv)
+			case TOCDB_CD_BATTLE_HIKARI_NO_YUUSHATACHI_J: //bcog ̗E҂
+				APP_SetF1NoReset(TRUE);
+				_bAutoF1NoReset = TRUE;
+				PRINTF("F1 key for \"CD Replace\".  %s", cdMessage);
+				break;
 			
-			JOYPAD_SetRenshaSpeedMax(3); //AˑxőLow܂łɗ}B
+			case TOCDB_GINGA_FUKEI_DENSETSU_SAPPHIRE_J: //͕wx`Tt@CA
+			case TOCDB_GINGA_FUKEI_DENSETSU_SAPPHIRE_BOOTLEG_J:
+				//N̒ǂݍݕ́ACDV[NݒɁB
+				_bFastSeek = TRUE;
+				_AutoNormalSeek = 1000; //CDDAĐȂꂽƓɁAȍ~̓m[}V[NݒɂB
+				break;
 			
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[BANZXxƃCxgV[łPC̗ꂪo邱ƂB
-		}
-		
-		if (strcmp(pGameTitle,"CD Battle Hikari no Yuushatachi (J)") == 0) //bcog ̗E҂
-		{
-			APP_SetF1NoReset(TRUE);
-			_bAutoF1NoReset = TRUE;
-			PRINTF("F1 key for \"CD Replace\".  %s", cdMessage);
-		}
-		
-		if ((strcmp(pGameTitle,"Ginga Fukei Densetsu Sapphire (J)") == 0)|| //͕wx`Tt@CA
-			(strcmp(pGameTitle,"Ginga Fukei Densetsu Sapphire [bootleg] (J)") == 0))
-		{
-	 		//N̒ǂݍݕ́ACDV[NݒɁB
-			_bFastSeek = TRUE;
-			_AutoNormalSeek = 1000; //CDDAĐȂꂽƓɁAȍ~̓m[}V[NݒɂB
-		}
-		
-		if (strcmp(pGameTitle,"Kaze no Densetsu Xanadu II (J)") == 0) //̓`UihDII
-		{
-			//v[ORUN{^ƂɏoʂŁAXvCgČKvB
-			_AutoSpriteLimit = 11; //dĨfrB̃gbNNo.CDDAĐȂꂽƓɁAȍ~̓XvCgI[o[ČB
-			_AutoNonSpriteLimit = -1; //CDDAĐXgbvƓɁAȍ~̓XvCgI[o[ČȂB
-		}
-		if (strcmp(pGameTitle,"Exile - Toki no Hazama he (J)") == 0) //GOUC
-		{
-			//Xg{Xގ̃rWAV[ŁAXvCgČKvB
-			_AutoSpriteLimit = 13; //̃gbNNo.CDDAĐȂꂽƓɁAȍ~̓XvCgI[o[ČB
-			_AutoNonSpriteLimit = -1; //CDDAĐXgbvƓɁAȍ~̓XvCgI[o[ČȂB
-		}
-		
-		if (strcmp(pGameTitle,"Gradius II - Gofer no Yabou (J)") == 0) //OfBEXII
-		{
-			if (APP_GetAutoGradiusII())
-			{
-				 //NɃRg[Q̉{^ςȂɂāA[U[EXvbh{ȂݒɂB
-				_bGradiusII = TRUE;
-				_GradiusIIwait = 0;
-			}
-		}
-		
-		if (strcmp(pGameTitle,"Downtown Nekketsu Monogatari (J)") == 0) //_E^EM
-			_bNekketsu = TRUE; //@݂CDANZXxɗƂA{̂óu܂̂炢Ă ܂Ă܂vADPCMŌ܂ŔB
-		
-		if (strcmp(pGameTitle,"Super Darius (J)") == 0) //X[p[_CAX
-			_bDarius = TRUE; //@݂CDANZXxɗƂAX^[g̃Cg~[WbN(ADPCM)Ō܂ŔB
-		
-		if (strcmp(pGameTitle,"Chou Aniki (J)") == 0) //ZMBI[vjÕ^CgʂŗȂ悤ɁB
-		{
-			_AutoSlowPlaySeekWait = 25; //I[vjŐȂn܂AygbNւ̃V[Nx@ɂB
-			_AutoRetPlaySeekWait = 1000; //I[vjOȊŐȍĐ}ɁAANZXɖ߂B
-		}
-
-		if (strcmp(pGameTitle,"Nekketsu Legend Baseballer (J)") == 0) //MWFhx[X{[[
-		{
-			_bBaseballer = TRUE; //@݂CDANZXxɗƂArWAV[̉YB
+			case TOCDB_KAZE_NO_DENSETSU_XANADU_II_J: //̓`UihDII
+				//v[ORUN{^ƂɏoʂŁAXvCgČKvB
+				_AutoSpriteLimit = 11; //dĨfrB̃gbNNo.CDDAĐȂꂽƓɁAȍ~̓XvCgI[o[ČB
+				_AutoNonSpriteLimit = -1; //CDDAĐXgbvƓɁAȍ~̓XvCgI[o[ČȂB
+				break;
 			
-	 		//CDANZX𑬂ݒ
-			_bFastCD = TRUE;
-			_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
-	 		//rWAV[̉h߁ACDV[NݒɁB
-			_bFastSeek = TRUE;
-			_AutoFastSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+			case TOCDB_EXILE_TOKI_NO_HAZAMA_HE_J: //GOUC
+				//Xg{Xގ̃rWAV[ŁAXvCgČKvB
+				_AutoSpriteLimit = 13; //̃gbNNo.CDDAĐȂꂽƓɁAȍ~̓XvCgI[o[ČB
+				_AutoNonSpriteLimit = -1; //CDDAĐXgbvƓɁAȍ~̓XvCgI[o[ČȂB
+				break;
 			
-			if (_CDInstall == 0)
-				PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
-		}
-		
- 		if ((strcmp(pGameTitle,"Rayxanber II (J)") == 0)|| //CUo[II
- 			(strcmp(pGameTitle,"Kakutou Haou Densetsu Algunos (J)") == 0)) //AKmX
+			case TOCDB_GRADIUS_II_GOFER_NO_YABOU_J: //OfBEXII
+				if (APP_GetAutoGradiusII())
+				{
+					//NɃRg[Q̉{^ςȂɂāA[U[EXvbh{ȂݒɂB
+					_bGradiusII = TRUE;
+					_GradiusIIwait = 0;
+				}
+				break;
+			
+			case TOCDB_DOWNTOWN_NEKKETSU_MONOGATARI_J: //_E^EM
+				_bNekketsu = TRUE; //@݂CDANZXxɗƂA{̂óu܂̂炢Ă ܂Ă܂vADPCMŌ܂ŔB
+				break;
+			
+			case TOCDB_SUPER_DARIUS_J: //X[p[_CAX
+				_bDarius = TRUE; //@݂CDANZXxɗƂAX^[g̃Cg~[WbN(ADPCM)Ō܂ŔB
+				break;
+			
+			case TOCDB_CHOU_ANIKI_J: //ZMBI[vjÕ^CgʂŗȂ悤ɁB
+				_AutoSlowPlaySeekWait = 25; //I[vjŐȂn܂AygbNւ̃V[Nx@ɂB
+				_AutoRetPlaySeekWait = 1000; //I[vjOȊŐȍĐ}ɁAANZXɖ߂B
+				break;
+			
+			case TOCDB_NEKKETSU_LEGEND_BASEBALLER_J: //MWFhx[X{[[
+				_bBaseballer = TRUE; //@݂CDANZXxɗƂArWAV[̉YB
+				
+				//CDANZX𑬂ݒ
+				_bFastCD = TRUE;
+				_AutoFastCD = -1; //Q[NォFastCDIɂ(ƂŌɖ߂߂ɕKv)
+				//rWAV[̉h߁ACDV[NݒɁB
+				_bFastSeek = TRUE;
+				_AutoFastSeek = -1; //Q[NォFastSeekIɂ(ƂŌɖ߂߂ɕKv)
+				
+				if (_CDInstall == 0)
+					PRINTF("Recommend \"Install\".  %s", cdMessage); //CXg[
+				break;
+			
+			case TOCDB_RAYXANBER_II_J: //CUo[II
+			case TOCDB_KAKUTOU_HAOU_DENSETSU_ALGUNOS_J: //AKmX
 				JOYPAD_SetRenshaSpeedMax(2); //AˑxőMiddle܂łɗ}B
-
- 		if ((strcmp(pGameTitle,"Shadow of the Beast (J)") == 0)|| //Vh[IuUr[Xg(J)
- 			(strcmp(pGameTitle,"Shadow of the Beast (U)") == 0))  //Vh[IuUr[Xg(U)
+				break;
+			
+			case TOCDB_SHADOW_OF_THE_BEAST_J: //Vh[IuUr[Xg(J)
+			case TOCDB_SHADOW_OF_THE_BEAST_U: //Vh[IuUr[Xg(U)
 				JOYPAD_SetRenshaSpeedMax(3); //AˑxőLow܂łɗ}B
-
-		if (strcmp(pGameTitle,"Seisenshi Denshou - Jantaku no Kishi (J)") == 0) //m`|̋Rm|BADPCM̉Ƃ(y)
-			_bFastAdpcmDma = TRUE; //ADPCMDMA]Jnʏ葁߂̃^C~OɂB
-
-		if (strcmp(pGameTitle,"Shin Megami Tensei (J)") == 0) //^_]
-		{
-			//퓬V[ȂǂŃbZ[WEBhEƁAU▂@ʂɁAXvCgČKvBv2.20
-			VDC_SetAutoPerformSpriteLimit(TRUE);
+				break;
 			
-			if (APP_GetAutoShinMegamiTensei()) //œKL(ftHg)ɐݒ肵Ă
-			{
-				//ʕ`掞ȂǂɎXPt[̗ꂪôhB@ło邪YɂȂ̂Ŏ{Bv2.20
-				VDC_SetForceRaster(TRUE);
-				VDC_SetForceVBlank(TRUE); //v2.24ǉ
-				//^C~O̖ŋHɃI[g}bvʂʉ̂h߁A኱CPȖxグđΏB@łN邪KvĈߎ{Bv2.20
-				VDC_SetShinMegamiTensei(TRUE);
-			}
+			case TOCDB_SEISENSHI_DENSHOU_JANTAKU_NO_KISHI_J: //m`|̋Rm|BADPCM̉Ƃ(y)
+				_bFastAdpcmDma = TRUE; //ADPCMDMA]Jnʏ葁߂̃^C~OɂB
+				break;
+			
+			case TOCDB_SHIN_MEGAMI_TENSEI_J: //^_]
+				//퓬V[ȂǂŃbZ[WEBhEƁAU▂@ʂɁAXvCgČKvBv2.20
+				VDC_SetAutoPerformSpriteLimit(TRUE);
+				
+				if (APP_GetAutoShinMegamiTensei()) //œKL(ftHg)ɐݒ肵Ă
+				{
+					//ʕ`掞ȂǂɎXPt[̗ꂪôhB@ło邪YɂȂ̂Ŏ{Bv2.20
+					VDC_SetForceRaster(TRUE);
+					VDC_SetForceVBlank(TRUE); //v2.24ǉ
+					//^C~O̖ŋHɃI[g}bvʂʉ̂h߁A኱CPȖxグđΏB@łN邪KvĈߎ{Bv2.20
+					VDC_SetShinMegamiTensei(TRUE);
+				}
+				break;
+			
+			case TOCDB_AYA_J: //AYABANZXăbZ[WĂ܂ʂ@݂̒xɂB
+				_bAya = TRUE;
+				break;
+			
+			case TOCDB_ORGEL_J: //IS[BANZXďʂi݂Ƃ@݂̒xɂB
+				_bOrgel = TRUE;
+				break;
+			
+			case TOCDB_PASTEL_LIME_J: //pXeC
+				_bLime = TRUE; //ȃ^C~OAIՂ̉r؂B
+				break;
 		}
-
-		if (strcmp(pGameTitle,"Aya (J)") == 0) //AYABANZXăbZ[WĂ܂ʂ@݂̒xɂB
-			_bAya = TRUE;
-
-		if (strcmp(pGameTitle,"Orgel (J)") == 0) //IS[BANZXďʂi݂Ƃ@݂̒xɂB
-			_bOrgel = TRUE;
-
-		if (strcmp(pGameTitle,"Pastel Lime (J)") == 0) //pXeC
-			_bLime = TRUE; //ȃ^C~OAIՂ̉r؂B
 	}
 }
 
@@ -882,7 +931,7 @@ check_cdrom2_disc(
 		check_disc_toc();
 		//gbÑCXg[󋵂`FbN
 		_CDInstall = CDROM_CheckCDInstall();
-		if ((APP_GetCDGame())&&(APP_GetCueFile())&&(_CDInstall != 2)) //CUENɃt@CȂꍇ
+		if ((APP_GetCDGame())&&(APP_GetCueFile())&&(!CDIF_IsImage())&&(_CDInstall != 2)) //CUENɃt@CȂꍇBfBXNC[WNꍇ͏B
 		{
 			TOCDB_ClearGameTitle(); //Q[NA
 			PRINTF("CD: not ready.");
@@ -3620,9 +3669,7 @@ CDROM_GetInstallRequiredHDD()
 static void
 checkCDInstallGame()
 {
-	char*	pGameTitle = TOCDB_GetGameTitle();
-
-	if (strcmp(pGameTitle,"Star Parodia (J)") == 0) //X^[pW[
+	if (TOCDB_GetGameID() == TOCDB_STAR_PARODIA_J) //X^[pW[
 	{
 		if (!APP_GetCDSpeedDown()) //Xxݒ̏ꍇ͏Ȃ
 				CDIF_SetSpeed(4); //œǂނƃG[o₷̂ŁACD-ROM̓ǂݍݑxx4ɐBʂ̂ȂhCu
@@ -3633,9 +3680,7 @@ checkCDInstallGame()
 static void
 checkCDInstallGameEnd()
 {
-	char*	pGameTitle = TOCDB_GetGameTitle();
-
-	if (strcmp(pGameTitle,"Star Parodia (J)") == 0) //X^[pW[
+	if (TOCDB_GetGameID() == TOCDB_STAR_PARODIA_J) //X^[pW[
 	{
 		if (!APP_GetCDSpeedDown()) //Xxݒ̏ꍇ͏Ȃ
 				CDIF_SetSpeed(0); //xɖ߂B
@@ -3910,6 +3955,9 @@ CDROM_CheckCDInstall()
 	BOOL	bDataExist = FALSE;
 	FILE*	fp;
 
+	if (CDIF_IsImage()) //fBXNC[WNꍇ́ACDhCuƓŃC[WǂݍށB
+		return 0;
+
 	for (track=1; track<=lastTrack; track++)
 	{
 		sprintf(trackChar, "%02d", track);
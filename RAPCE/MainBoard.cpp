@@ -1192,6 +1192,17 @@ void RAMByteWriter( unsigned int nOffs, unsigned int nVal )
 	MAINBOARD_GetpMainRam()[ nOffs ] = nVal;
 }
 
+unsigned int RAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	if (nOffs >= 0x8000)
+		return 0;
+	if (nCount > 0x8000 - nOffs)
+		nCount = 0x8000 - nOffs;
+
+	memcpy(pBuffer, MAINBOARD_GetpMainRam() + nOffs, nCount);
+	return nCount;
+}
+
 //Kitao追加。CDROM.c から呼ばれる。v1.21
 void
 MAINBOARD_SetGradiusII()
@@ -1664,7 +1675,7 @@ MAINBOARD_Init(
 
 	//獣王記の問題(スーパーシステムカードでプレイすると途中で止まることがある)対策。v2.07
 	//  実機でもスーパーシステムカード(v3.0)だと２面でドラゴンに変身出来ず止まる問題があるので旧システムカードを使用する。
-	if ((APP_GetCDGame())&&(strcmp(TOCDB_GetGameTitle(),"Juuouki (J)") == 0))
+	if ((APP_GetCDGame())&&(TOCDB_GetGameID() == TOCDB_JUUOUKI_J))
 	{
 		pOtherSys1OpenName = APP_ChangeToOtherSysCard1();
 		switch (CDROM_GetCDInstall())
@@ -1712,6 +1723,7 @@ MAINBOARD_Init(
 
 	RA_ClearMemoryBanks();
 	RA_InstallMemoryBank(0,	RAMByteReader, RAMByteWriter, 0x8000);
+	RA_InstallMemoryBankBlockReader(0, RAMBlockReader);
 	RA_OnLoadNewRom( MAINBOARD_GetpMainROM(), MAINBOARD_GetpMainROMSize());
 
 	//Kitao追加。v1.11。メインウィンドウが最小化されていた場合(TG16変換のときにもこうなる)、元に戻す。
@@ -37,6 +37,7 @@ Copyright(C)2006-2010 Kitao Nakamura.
 ******************************************************************************/
 #define _CRT_SECURE_NO_DEPRECATE
 #include <stdio.h>
+#include <string.h>
 #include "TocDB.h"
 
 static char	_GameTitle[256];//KitaoǉBQ[
@@ -17086,15 +17087,75 @@ static const DISCINFO	s_DiscInfo[] =
 };
 
 
-const DISCINFO*
-TOCDB_IsMatch(
+//TOC̃tBK[vg(gbN1`99TOCINFÕoCg)ɂnbVƁAeGg̃pb`pIDB
+//ǂTocDBIndex.pys_DiscInfo[]ÓIȕ\Ȃ̂ŁANɍKv͂ȂB
+#define TOCDB_FP_TRACKS		99		//pDisc->TOC[1`99]s_DiscInfo[].TOC[0`98]Ή
+#define TOCDB_FP_BYTES		(TOCDB_FP_TRACKS * sizeof(TOCINFO))
+#define TOCDB_NUM_ENTRIES	(sizeof(s_DiscInfo) / sizeof(s_DiscInfo[0]) - 1)	//NULL
+
+#include "TocDBIndex.h"	//_TocHash[]:tBK[vgs_DiscInfo[]̓Y(-1=)B_GameID[]:s_DiscInfo[]̓Ypb`pIDB
+
+//s_DiscInfo[]ҏŴTocDBIndex.pysYꂽꍇ́AŃRpCG[ɂȂB
+typedef char	TOCDB_INDEX_IS_STALE[(TOCDB_NUM_ENTRIES == TOCDB_INDEX_ENTRIES) ? 1 : -1];
+
+static Sint32	_MatchIndex = -1;				//ŌɈvs_DiscInfo[]̓YB-1=vȂ
+
+
+//FNV-1a
+static Uint32
+hash_bytes(
+	const Uint8*	p,
+	Uint32			size)
+{
+	Uint32	h = 2166136261UL;
+	Uint32	i;
+
+	for (i=0; i<size; i++)
+		h = ((h ^ p[i]) * 16777619UL) & 0xFFFFFFFF;
+	return h;
+}
+
+
+//TOC̃nbVlB[hAEg(trackNum=0)0ԂȂ̂ŁA[hAEg܂łŌvZB
+//rmemcmp()99gbNԂŝŁAnbVlłʂ͕ςȂB
+//TocDBIndex.pytoc_hash()ƓvZɂĂƁB
+static Uint32
+hash_toc(
+	const TOCINFO*	pToc)
+{
+	int		n;
+
+	for (n=1; n<TOCDB_FP_TRACKS; n++)
+		if (pToc[n-1].trackNum == 0)
+			break;
+	return hash_bytes((const Uint8*)pToc, n * sizeof(TOCINFO)) & (TOCDB_HASH_SIZE-1);
+}
+
+
+//pToc99gbNԂƓTOC̃GgTAs_DiscInfo[]̓YԂBȂꍇ-1B
+static Sint32
+find_toc(
+	const TOCINFO*	pToc)
+{
+	Uint32	h = hash_toc(pToc);
+
+	while (_TocHash[h] != -1)
+	{
+		if (memcmp(s_DiscInfo[_TocHash[h]].TOC, pToc, TOCDB_FP_BYTES) == 0)
+			return _TocHash[h];
+		h = (h+1) & (TOCDB_HASH_SIZE-1);
+	}
+	return -1;
+}
+
+
+//O̐`Bx`}[Nł̔rpB
+static Sint32
+match_linear(
 	const DISCINFO*		pDisc)
 {
 	int		i = 0;
 	int		j;
-	char	t[3];
-
-	_GameTitle[0] = '\0'; //Kitaoǉ
 
 	while (s_DiscInfo[i].pTitle != NULL)
 	{
@@ -17112,12 +17173,31 @@ TOCDB_IsMatch(
 			if (pDisc->TOC[j].lbaL != s_DiscInfo[i].TOC[j-1].lbaL) break;
 		}
 		if (j == 100)
-		{
-			strcpy(_GameTitle,s_DiscInfo[i].pTitle);
-			return &s_DiscInfo[i];
-		}
+			return i;
 		++i;
 	}
+	return -1;
+}
+
+
+const DISCINFO*
+TOCDB_IsMatch(
+	const DISCINFO*		pDisc)
+{
+	Sint32	i;
+	char	t[3];
+
+	_GameTitle[0] = '\0'; //Kitaoǉ
+	_MatchIndex = -1;
+
+	//₷悤ApDisc̓Y͂Pn܂gbNԍƓBs_DiscInfoTOC[][0]PgbNځB
+	i = find_toc(&pDisc->TOC[1]);
+	if (i != -1)
+	{
+		_MatchIndex = i;
+		strcpy(_GameTitle,s_DiscInfo[i].pTitle);
+		return &s_DiscInfo[i];
+	}
 
 	//KitaoǉBTOCɓĂ͂܂ȂꍇARgbNڂTOC𗘗păj[NȖOtB
 	if (pDisc->TOC[2].isAudio == 1)
@@ -17162,6 +17242,7 @@ void
 TOCDB_ClearGameTitle()
 {
 	_GameTitle[0] = '\0';
+	_MatchIndex = -1;
 }
 
 //Kitaoǉ
@@ -17173,3 +17254,98 @@ TOCDB_GetGameTitle()
 	return _GameTitle;
 }
 
+
+//݂̃fBXÑpb`pID(TocDB.hTOCDB_GAME_xxx)ԂBf[^x[XɂȂfBXNHuJ[h̏ꍇTOCDB_GAME_NONEB
+//o[WႢTOCQ[́Aǂ̃GgIDɂȂB
+Sint32
+TOCDB_GetGameID()
+{
+	if (_MatchIndex == -1) //f[^x[XɂȂfBXNC܂HuJ[h
+		return TOCDB_GAME_NONE;
+	return _GameID[_MatchIndex];
+}
+
+
+/*-----------------------------------------------------------------------------
+	[Benchmark]
+		ÑfBXNʂɂ鎞Ԃv܂Bf[^x[X̑STOC(ƈv
+		ȂTOCЂƂ)`EnbVŏƍƂ̕ώԂƁA
+		Q[Ƃ̃pb`^CgstrcmpETOCDB_GetGameID()ōs
+		Ƃ̂P񂠂̎Ԃv܂Bƍʂ`ƐHꍇ
+		̐񍐂܂(TocDBIndex.hÂꍇȂ)B
+-----------------------------------------------------------------------------*/
+BOOL
+TOCDB_Benchmark(
+	char*	pReport,
+	int		reportSize)
+{
+	static DISCINFO	disc; //傫̂static
+	Sint32			n = TOCDB_NUM_ENTRIES;
+	Sint32			i;
+	Sint32			j;
+	Sint32			r;
+	Sint32			nMismatch = 0;
+	Sint32			saveMatch = _MatchIndex;
+	volatile Sint32	sink = 0; //œKŌvΏۂ̏Ȃ悤
+	LARGE_INTEGER	freq;
+	LARGE_INTEGER	t1;
+	LARGE_INTEGER	t2;
+	double			linearUs;
+	double			hashUs;
+	double			strcmpNs;
+	double			gameIdNs;
+
+	QueryPerformanceFrequency(&freq);
+
+	//TOC̏ƍBi=n͂ǂ̃GgƂvȂTOCB
+	linearUs = hashUs = 0.0;
+	for (i=0; i<=n; i++)
+	{
+		memset(&disc, 0, sizeof(disc));
+		memcpy(&disc.TOC[1], s_DiscInfo[(i < n) ? i : 0].TOC, TOCDB_FP_BYTES);
+		if (i == n)
+			disc.TOC[1].lbaL ^= 0xFF;
+		if (match_linear(&disc) != find_toc(&disc.TOC[1]))
+			nMismatch++;
+
+		QueryPerformanceCounter(&t1);
+		for (r=0; r<16; r++)
+			sink += match_linear(&disc);
+		QueryPerformanceCounter(&t2);
+		linearUs += (double)(t2.QuadPart - t1.QuadPart) * 1000000.0 / (double)freq.QuadPart / 16.0;
+
+		QueryPerformanceCounter(&t1);
+		for (r=0; r<16; r++)
+			sink += find_toc(&disc.TOC[1]);
+		QueryPerformanceCounter(&t2);
+		hashUs += (double)(t2.QuadPart - t1.QuadPart) * 1000000.0 / (double)freq.QuadPart / 16.0;
+	}
+
+	//pb`BeGgVłƂɁAS^CgŔ肷B
+	QueryPerformanceCounter(&t1);
+	for (i=0; i<n; i++)
+		for (j=0; j<n; j++)
+			sink += (strcmp(s_DiscInfo[i].pTitle, s_DiscInfo[j].pTitle) == 0);
+	QueryPerformanceCounter(&t2);
+	strcmpNs = (double)(t2.QuadPart - t1.QuadPart) * 1000000000.0 / (double)freq.QuadPart / ((double)n * n);
+
+	QueryPerformanceCounter(&t1);
+	for (i=0; i<n; i++)
+	{
+		_MatchIndex = i;
+		for (j=0; j<n; j++)
+			sink += (TOCDB_GetGameID() == _GameID[j]);
+	}
+	QueryPerformanceCounter(&t2);
+	gameIdNs = (double)(t2.QuadPart - t1.QuadPart) * 1000000000.0 / (double)freq.QuadPart / ((double)n * n);
+	_MatchIndex = saveMatch;
+
+	_snprintf(pReport, reportSize,
+			  "TOC database: %ld entries, static index\n"
+			  "  TOC match: linear %.2f us, hash %.2f us (avg of %ld lookups, %ld mismatches)\n"
+			  "  title check: strcmp %.1f ns, TOCDB_GetGameID %.1f ns\n",
+			  n, linearUs / (n+1), hashUs / (n+1), n+1, nMismatch, strcmpNs, gameIdNs);
+	pReport[reportSize-1] = 0;
+
+	return (nMismatch == 0);
+}
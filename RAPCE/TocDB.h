@@ -52,4 +52,121 @@ char*
 TOCDB_GetGameTitle();
 
 
+//Q[Ƃ̃pb`pIDBTOCDB_GetGameID()ԂB
+//Rg̃^Cgs_DiscInfo[]̂̂ƊSɈvĂBTocDBIndex.py
+//s_DiscInfo[]̊eGgID̕\TocDBIndex.h֏o͂̂ŁAǉEύXsƁB
+enum
+{
+	TOCDB_GAME_NONE = 0,
+	TOCDB_1552_TENKA_TAIRAN_J,							//"1552 Tenka Tairan (J)"
+	TOCDB_3_X_3_EYES_SANJIYAN_HENSEI_J,					//"3 x 3 Eyes - Sanjiyan Hensei (J)"
+	TOCDB_ADVANCED_VARIABLE_GEO_J,						//"Advanced Variable Geo (J)"
+	TOCDB_ARUNAMU_NO_KIBA_J,							//"Arunamu no Kiba (J)"
+	TOCDB_AYA_J,										//"Aya (J)"
+	TOCDB_A_III_J,										//"A. III (J)"
+	TOCDB_BAZAAR_DE_GOZAHRU_NO_GAME_DE_GOZAHRU_J,		//"Bazaar de Gozahru no Game de Gozahru (J)"
+	TOCDB_BLACK_HOLE_ASSAULT_J,							//"Black Hole Assault (J)"
+	TOCDB_BONANZA_BROS_J,								//"Bonanza Bros. (J)"
+	TOCDB_BRANDISH_J,									//"Brandish (J)"
+	TOCDB_CARD_ANGELS_J,								//"Card Angels (J)"
+	TOCDB_CD_BATTLE_HIKARI_NO_YUUSHATACHI_J,			//"CD Battle Hikari no Yuushatachi (J)"
+	TOCDB_CHOU_ANIKI_J,									//"Chou Aniki (J)"
+	TOCDB_DE_JA_J,										//"DE-JA (J)"
+	TOCDB_DORAEMON_NOBITA_NO_DORABIAN_NIGHT_J,			//"Doraemon Nobita no Dorabian Night (J)"
+	TOCDB_DOUBLE_DRAGON_II_J,							//"Double Dragon II (J)"
+	TOCDB_DOUKYUUSEI_J,									//"Doukyuusei (J)"
+	TOCDB_DOWNTOWN_NEKKETSU_MONOGATARI_J,				//"Downtown Nekketsu Monogatari (J)"
+	TOCDB_DUNGEON_EXPLORER_II_J,						//"Dungeon Explorer II (J)"
+	TOCDB_DUNGEON_EXPLORER_II_U,						//"Dungeon Explorer II (U)"
+	TOCDB_EIKAN_HA_KIMINI_J,							//"Eikan ha Kimini (J)"
+	TOCDB_EMERALD_DRAGON_J,								//"Emerald Dragon (J)"
+	TOCDB_EXILE_TOKI_NO_HAZAMA_HE_J,					//"Exile - Toki no Hazama he (J)"
+	TOCDB_FIGHTING_STREET_J,							//"Fighting Street (J)"
+	TOCDB_FIGHTING_STREET_U,							//"Fighting Street (U)"
+	TOCDB_FIREPRO_JYOSHI_DOME_CHOUJOUKESSEN_J,			//"FirePro Jyoshi - Dome ChoujouKessen (J)"
+	TOCDB_FLASH_HIDERS_J,								//"Flash Hiders (J)"
+	TOCDB_FORGOTTEN_WORLDS_J,							//"Forgotten Worlds (J)"
+	TOCDB_FORGOTTEN_WORLDS_U,							//"Forgotten Worlds (U)"
+	TOCDB_GALAXY_DEKA_GAYVAN_J,							//"GALAXY Deka GAYVAN (J)"
+	TOCDB_GAROU_DENSETSU_II_J,							//"Garou Densetsu II (J)"
+	TOCDB_GAROU_DENSETSU_II_SAMPLE_DISC_J,				//"Garou Densetsu II - Sample Disc (J)"
+	TOCDB_GAROU_DENSETSU_SPECIAL_J,						//"Garou Densetsu Special (J)"
+	TOCDB_GINGA_FUKEI_DENSETSU_SAPPHIRE_BOOTLEG_J,		//"Ginga Fukei Densetsu Sapphire [bootleg] (J)"
+	TOCDB_GINGA_FUKEI_DENSETSU_SAPPHIRE_J,				//"Ginga Fukei Densetsu Sapphire (J)"
+	TOCDB_GINGA_OJOUSAMA_DENSETSU_YUNA_II_J,			//"Ginga Ojousama Densetsu Yuna II (J)"
+	TOCDB_GRADIUS_II_GOFER_NO_YABOU_J,					//"Gradius II - Gofer no Yabou (J)"
+	TOCDB_HATSUKOI_MONOGATARI_J,						//"Hatsukoi Monogatari (J)"
+	TOCDB_JANTEI_MONOGATARI_III_J,						//"Jantei Monogatari III (J)"
+	TOCDB_JANTEI_MONOGATARI_J,							//"Jantei Monogatari (J)"
+	TOCDB_JUUOUKI_J,									//"Juuouki (J)"
+	TOCDB_KABUKI_ITTOURYOUDAN_J,						//"Kabuki Ittouryoudan (J)"
+	TOCDB_KAKUTOU_HAOU_DENSETSU_ALGUNOS_J,				//"Kakutou Haou Densetsu Algunos (J)"
+	TOCDB_KAZE_NO_DENSETSU_XANADU_II_J,					//"Kaze no Densetsu Xanadu II (J)"
+	TOCDB_LEGION_J,										//"Legion (J)"
+	TOCDB_LEMMINGS_J,									//"Lemmings (J)"
+	TOCDB_LINDA_CUBE_FIRST_J,							//"Linda Cube [first] (J)"
+	TOCDB_LINDA_CUBE_J,									//"Linda Cube (J)"
+	TOCDB_LODOSS_TOU_SENKI_II_J,						//"Lodoss Tou Senki II (J)"
+	TOCDB_MAGICOAL_J,									//"Magicoal (J)"
+	TOCDB_MAHJONG_SWORD_J,								//"Mahjong Sword (J)"
+	TOCDB_MARTIAL_CHAMPIONS_J,							//"Martial Champions (J)"
+	TOCDB_METAL_ANGEL_II_J,								//"Metal Angel II (J)"
+	TOCDB_METAL_ANGEL_J,								//"Metal Angel (J)"
+	TOCDB_MIRAI_SHONEN_CONAN_J,							//"Mirai Shonen Conan (J)"
+	TOCDB_MUGEN_SENSHI_VALIS_J,							//"Mugen Senshi Valis (J)"
+	TOCDB_NEKKETSU_KOUKOU_SOCCER_HEN_J,					//"Nekketsu Koukou Soccer Hen (J)"
+	TOCDB_NEKKETSU_LEGEND_BASEBALLER_J,					//"Nekketsu Legend Baseballer (J)"
+	TOCDB_NEMURENUYORU_NO_CHIISANA_OHANASHI_J,			//"Nemurenuyoru no Chiisana Ohanashi (J)"
+	TOCDB_ORGEL_J,										//"Orgel (J)"
+	TOCDB_PASTEL_LIME_J,								//"Pastel Lime (J)"
+	TOCDB_POPFUL_MAIL_J,								//"Popful Mail (J)"
+	TOCDB_POPN_MAGIC_J,									//"Pop'n Magic (J)"
+	TOCDB_POWER_GOLF_2_GOLFER_J,						//"Power Golf 2 - Golfer (J)"
+	TOCDB_PRINCESS_MAKER_II_J,							//"Princess Maker II (J)"
+	TOCDB_PRIVATE_EYEDOL_J,								//"Private Eyedol (J)"
+	TOCDB_PSYCHIC_STORM_J,								//"Psychic Storm (J)"
+	TOCDB_QUIZ_TONOSAMA_NO_YABOU_J,						//"Quiz Tonosama no Yabou (J)"
+	TOCDB_RANMA_1_2_J,									//"Ranma 1-2 (J)"
+	TOCDB_RAYXANBER_II_J,								//"Rayxanber II (J)"
+	TOCDB_RYUUKO_NO_KEN_J,								//"Ryuuko no Ken (J)"
+	TOCDB_SEISENSHI_DENSHOU_JANTAKU_NO_KISHI_J,			//"Seisenshi Denshou - Jantaku no Kishi (J)"
+	TOCDB_SHADOW_OF_THE_BEAST_J,						//"Shadow of the Beast (J)"
+	TOCDB_SHADOW_OF_THE_BEAST_U,						//"Shadow of the Beast (U)"
+	TOCDB_SHERLOCK_HOLMES_CONSULTING_DETECTIVE_U,		//"Sherlock Holmes Consulting Detective (U)"
+	TOCDB_SHERLOCK_HOLMES_NO_TANTEI_KOUZA_II_J,			//"Sherlock Holmes no Tantei Kouza II (J)"
+	TOCDB_SHERLOCK_HOLMES_NO_TANTEI_KOUZA_J,			//"Sherlock Holmes no Tantei Kouza (J)"
+	TOCDB_SHERLOCK_HOLMES_VOLUME_II_U,					//"Sherlock Holmes Volume II (U)"
+	TOCDB_SHIN_MEGAMI_TENSEI_J,							//"Shin Megami Tensei (J)"
+	TOCDB_SHIN_ONRYOU_SENKI_J,							//"Shin Onryou Senki (J)"
+	TOCDB_STAR_PARODIA_J,								//"Star Parodia (J)"
+	TOCDB_SUPER_DARIUS_II_J,							//"Super Darius II (J)"
+	TOCDB_SUPER_DARIUS_J,								//"Super Darius (J)"
+	TOCDB_SUPER_REAL_MAHJONG_P_II_AND_III_CUSTOM_J,		//"Super Real Mahjong P II & III Custom (J)"
+	TOCDB_SUPER_REAL_MAHJONG_P_V_CUSTOM_J,				//"Super Real Mahjong P V Custom (J)"
+	TOCDB_TENGAI_MAKYOU_FUUUN_KABUKI_DEN_J,				//"Tengai Makyou - Fuuun Kabuki Den (J)"
+	TOCDB_TENSHI_NO_UTA_II_J,							//"Tenshi no Uta II (J)"
+	TOCDB_TENSHI_NO_UTA_J,								//"Tenshi no Uta (J)"
+	TOCDB_THE_ATLAS_J,									//"The Atlas (J)"
+	TOCDB_TOKIMEKI_MEMORIAL_J,							//"Tokimeki Memorial (J)"
+	TOCDB_TRAVELLERS_DENSETSU_WO_BUTTOBASE_J,			//"Travellers! Densetsu wo Buttobase (J)"
+	TOCDB_UCHUU_SENKAN_YAMATO_J,						//"Uchuu Senkan Yamato (J)"
+	TOCDB_VASTEEL_II_J,									//"Vasteel II (J)"
+	TOCDB_VASTEEL_J,									//"Vasteel (J)"
+	TOCDB_WORLD_HEROES_II_J,							//"World Heroes II (J)"
+	TOCDB_YAMI_NO_KETSUZOKU_HARUKANARU_KIOKU_J,			//"Yami no Ketsuzoku Harukanaru Kioku (J)"
+	TOCDB_YS_IV_THE_DAWN_OF_YS_J,						//"Ys IV - The Dawn of Ys (J)"
+	TOCDB_GAME_COUNT
+};
+
+
+Sint32
+TOCDB_GetGameID();
+
+
+BOOL
+TOCDB_Benchmark(
+	char*	pReport,
+	int		reportSize);
+
+
 #endif		/* TOC_DB_H_INCLUDED */
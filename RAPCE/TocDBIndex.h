@@ -0,0 +1,171 @@
+/* Generated by TocDBIndex.py from TocDB.cpp and TocDB.h. Do not edit. */
+#define TOCDB_INDEX_ENTRIES	497
+#define TOCDB_HASH_SIZE		2048
+
+static const Sint16	_TocHash[TOCDB_HASH_SIZE] =
+{
+	399, -1, -1, -1, -1, -1, 130, -1, 485, 258, -1, 72, -1, -1, -1, -1,
+	-1, -1, 200, -1, -1, -1, -1, -1, -1, -1, -1, -1, 155, -1, -1, 213,
+	315, -1, -1, -1, -1, -1, 103, -1, -1, 150, 424, 201, -1, -1, 83, -1,
+	-1, 294, 145, -1, -1, -1, -1, -1, -1, -1, -1, 432, 326, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 63, 260, 483, -1, -1, -1, -1, -1,
+	-1, 113, -1, -1, -1, 23, -1, -1, 106, 439, -1, -1, 493, -1, -1, 191,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 6, 39, -1, -1, -1, -1,
+	-1, -1, 361, 134, 356, 94, -1, -1, -1, -1, -1, -1, 149, -1, -1, 123,
+	-1, -1, -1, 245, -1, -1, -1, 322, 208, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, 233, 423, 293, 85, 235, -1, -1, -1, 169, -1, -1, -1, -1, 91,
+	309, -1, -1, 173, -1, -1, 344, -1, -1, -1, -1, -1, 207, -1, -1, -1,
+	102, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 35, -1, -1, -1, 231, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, 276, -1, -1, -1, 55, 360, -1, -1, -1, 151, 262, -1,
+	-1, 324, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	15, -1, -1, 58, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 255, -1, -1, -1, -1, -1, -1, 197, -1, -1, 47, 416, 338, 450, -1,
+	-1, -1, -1, -1, 333, -1, -1, 241, 92, 93, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, 125, 280, 395, 408, -1, 387, 160, 458, -1,
+	73, 38, 105, -1, -1, -1, -1, -1, 378, 53, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, 251, -1, -1, 236, 394, -1, -1, -1, -1, -1, -1, 237, 368,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, 41, 172, 446, -1, -1, -1, -1,
+	-1, 373, -1, 495, 171, -1, -1, -1, -1, -1, 122, -1, -1, 88, 434, -1,
+	14, -1, 377, -1, -1, 166, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 321, -1, -1, 381, -1, 390, 79, -1, 474, -1, -1, -1, -1, -1, -1,
+	-1, -1, 50, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	363, -1, -1, -1, -1, -1, -1, 452, -1, -1, 477, -1, -1, -1, -1, 453,
+	-1, -1, -1, -1, 376, -1, -1, 460, -1, 253, 300, -1, 375, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 131, 323, 214, -1, -1,
+	-1, -1, 329, -1, -1, -1, -1, 65, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, 284, 391, -1, -1, 137, -1, -1, -1, 261, -1, -1, -1, -1, -1,
+	-1, 22, -1, 126, -1, -1, -1, -1, -1, -1, -1, 340, -1, -1, -1, -1,
+	-1, -1, 74, 318, -1, -1, 287, -1, -1, -1, 11, 230, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 342, -1, 46, -1, -1,
+	448, -1, -1, 354, 87, -1, -1, -1, -1, -1, -1, 10, -1, -1, 142, 455,
+	9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 220,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 422, -1, 427, -1, -1, 282,
+	-1, -1, 327, 393, -1, -1, -1, 277, 370, -1, -1, -1, -1, 33, -1, -1,
+	-1, -1, 127, -1, -1, 163, -1, -1, -1, 285, 374, 372, -1, -1, -1, -1,
+	-1, -1, -1, 319, -1, -1, -1, -1, -1, -1, -1, 259, -1, -1, 468, -1,
+	-1, -1, -1, -1, -1, -1, 476, -1, -1, -1, 238, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, 77, 385, -1, 289, 401, -1, -1,
+	-1, -1, 187, -1, -1, -1, -1, -1, -1, -1, -1, 195, 336, 484, 254, 222,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 350, -1, -1, -1,
+	-1, -1, 347, 174, -1, -1, 177, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	299, -1, -1, 295, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 24,
+	-1, -1, -1, -1, -1, -1, 279, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	57, 475, -1, -1, -1, -1, -1, -1, 449, -1, -1, -1, -1, 75, -1, 325,
+	-1, 2, 32, -1, -1, 219, 71, 37, 139, -1, -1, 471, -1, -1, -1, -1,
+	-1, 25, 202, 193, 257, -1, -1, 349, 436, 447, -1, 144, 410, 489, -1, -1,
+	44, 421, -1, 491, 8, -1, -1, -1, -1, 138, -1, -1, -1, -1, 224, -1,
+	426, 182, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 313, -1, -1,
+	-1, -1, -1, -1, 355, 409, -1, -1, -1, -1, 425, -1, -1, -1, -1, -1,
+	36, -1, -1, 367, -1, 129, -1, -1, -1, -1, 67, 176, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 301, -1, 218, -1, 404, -1, -1, -1,
+	494, 248, -1, -1, -1, -1, -1, -1, -1, -1, 78, -1, -1, -1, 358, -1,
+	212, 330, 328, -1, -1, -1, -1, 162, -1, -1, -1, -1, 317, 462, -1, 456,
+	-1, 314, 118, -1, -1, 205, -1, 82, -1, -1, -1, 17, -1, 80, 81, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 273, -1, 109, 1, 466,
+	-1, -1, -1, 407, -1, -1, -1, -1, -1, -1, -1, -1, -1, 297, -1, -1,
+	-1, -1, -1, -1, -1, 433, -1, -1, 331, -1, -1, -1, -1, -1, -1, 157,
+	-1, 194, -1, 281, -1, 332, 430, -1, 352, 383, 265, 308, -1, 184, 490, -1,
+	-1, -1, 443, 492, 487, 304, -1, -1, -1, -1, -1, -1, -1, -1, -1, 229,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 428, -1, -1, -1, -1,
+	-1, -1, 45, -1, -1, 335, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, 116, -1, -1, -1, 278, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 306, -1, -1, -1, -1, -1, -1, -1,
+	-1, 249, -1, -1, -1, -1, 431, -1, 302, -1, -1, -1, -1, -1, 486, -1,
+	-1, 199, -1, -1, 288, 420, 283, 316, -1, 252, -1, -1, -1, -1, 397, -1,
+	-1, -1, 153, -1, -1, 26, -1, 496, 414, 104, -1, -1, -1, 357, -1, -1,
+	-1, 216, 147, -1, 95, -1, -1, -1, -1, -1, -1, -1, -1, 167, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, 143, 386, -1, -1, -1, 337, -1, -1, -1,
+	-1, -1, 234, 334, -1, -1, -1, 60, -1, -1, -1, -1, -1, -1, 27, 76,
+	-1, -1, -1, 435, -1, -1, 4, -1, -1, 186, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, 244, -1, -1, -1, -1, -1, 240, -1, 203, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, 227, -1, -1, -1, -1, -1, -1, -1, -1, 346,
+	-1, -1, -1, -1, -1, 61, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	271, -1, -1, 348, -1, -1, -1, -1, -1, -1, -1, -1, 369, -1, -1, -1,
+	-1, 146, 211, 114, -1, -1, -1, 90, 159, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, 445, -1, 7, 296, -1, -1, -1, -1, -1, -1, 206, -1, -1, -1,
+	380, -1, -1, -1, -1, -1, 298, -1, 351, -1, 232, -1, -1, -1, 451, -1,
+	429, -1, -1, 472, -1, -1, -1, -1, 19, 362, -1, -1, -1, 64, 311, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, 440, -1, -1, -1, -1, -1, 124,
+	-1, 121, -1, -1, -1, 161, -1, -1, -1, -1, 411, 270, -1, -1, -1, -1,
+	-1, -1, 196, -1, -1, -1, -1, -1, 266, -1, -1, -1, -1, -1, -1, 384,
+	264, 275, -1, -1, -1, -1, 40, 217, 274, -1, -1, -1, -1, 290, 100, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 185, -1, -1, -1, -1, -1, 111, -1,
+	305, -1, -1, -1, -1, 56, 70, 170, -1, -1, -1, -1, -1, 415, -1, -1,
+	-1, -1, -1, -1, -1, 286, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	31, -1, -1, -1, -1, -1, -1, -1, 256, 98, 181, -1, -1, 99, -1, -1,
+	-1, -1, -1, -1, 128, 341, 371, 469, -1, -1, 403, 247, 488, -1, -1, -1,
+	-1, 136, 48, 66, 96, -1, -1, -1, -1, -1, 239, -1, -1, -1, -1, 110,
+	-1, 16, 97, -1, -1, 437, -1, -1, -1, 86, -1, -1, -1, 457, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 392, 272, 417,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, 406, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, 119, -1, -1, 379, -1, -1, -1, -1, -1,
+	303, -1, -1, 442, -1, -1, -1, -1, -1, -1, -1, 400, -1, -1, -1, -1,
+	-1, -1, 343, -1, -1, -1, -1, -1, -1, 307, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, 180, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	21, -1, -1, -1, -1, -1, 339, -1, -1, -1, 402, -1, -1, -1, 382, 263,
+	108, -1, -1, -1, -1, -1, -1, -1, -1, 141, 465, -1, 68, 268, 364, 51,
+	-1, -1, -1, 178, -1, -1, 226, -1, -1, -1, -1, -1, -1, -1, -1, 459,
+	463, -1, -1, -1, 148, 115, 246, 418, -1, 412, 365, -1, -1, -1, -1, -1,
+	-1, 28, -1, -1, 42, 312, -1, -1, -1, -1, -1, -1, -1, -1, 269, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 62, -1, 156, 473, -1, 366, -1, -1,
+	210, 482, 34, -1, -1, -1, -1, -1, -1, -1, -1, 242, -1, 188, 353, -1,
+	-1, -1, 43, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 164, -1, -1,
+	-1, -1, -1, 250, 133, -1, -1, -1, 398, -1, -1, 89, -1, -1, -1, -1,
+	-1, -1, -1, -1, 267, -1, -1, -1, -1, 438, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, 204, -1, -1, -1, -1, 389, 5, 152, -1, -1, 189,
+	69, -1, -1, 461, -1, -1, -1, -1, -1, 54, -1, -1, -1, -1, 225, -1,
+	-1, -1, -1, -1, -1, -1, 165, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	20, 30, 84, -1, -1, -1, -1, 140, -1, -1, 168, -1, 112, -1, 192, -1,
+	-1, -1, 470, -1, -1, -1, -1, 464, 175, -1, -1, 228, -1, -1, -1, -1,
+	-1, -1, -1, -1, 320, 419, -1, 52, 480, -1, -1, -1, -1, -1, -1, -1,
+	101, -1, -1, -1, -1, -1, -1, 310, -1, 3, 49, -1, -1, -1, -1, 18,
+	-1, 154, 291, -1, -1, 29, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, 13, -1, -1, -1, -1, 413, -1, -1, 209, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 183, 467,
+	-1, -1, -1, -1, 132, -1, -1, 215, -1, 135, 190, 405, 481, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, 396, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, 107, -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 388, -1, -1,
+	478, -1, -1, -1, -1, -1, -1, 223, -1, 454, -1, -1, -1, -1, -1, -1,
+	-1, -1, 59, -1, -1, -1, 117, 441, -1, -1, 158, 444, 359, -1, -1, -1,
+};
+
+static const Uint8	_GameID[TOCDB_INDEX_ENTRIES] =
+{
+	1, 0, 2, 2, 0, 6, 3, 0, 0, 0, 0, 0, 0, 4, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0,
+	8, 0, 0, 0, 9, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	11, 12, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 14, 0, 0, 0, 0,
+	0, 0, 0, 0, 15, 16, 17, 0, 18, 0, 0, 0, 0, 0, 0, 0,
+	0, 19, 20, 0, 0, 0, 21, 0, 22, 0, 0, 23, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 24, 25, 0, 0, 26, 27, 0, 28, 29,
+	0, 0, 0, 0, 30, 0, 36, 0, 0, 0, 0, 0, 31, 32, 33, 0,
+	0, 0, 35, 34, 0, 0, 0, 0, 0, 0, 37, 0, 0, 38, 0, 0,
+	0, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 40, 0, 0, 39, 0, 0, 41, 41,
+	0, 0, 43, 0, 0, 0, 0, 44, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 45, 46, 48, 47, 0, 0, 49, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 62, 0, 50, 0, 0, 0,
+	51, 0, 0, 0, 0, 0, 52, 0, 0, 0, 0, 54, 53, 0, 0, 0,
+	0, 0, 0, 55, 0, 0, 0, 0, 0, 0, 0, 56, 0, 57, 0, 58,
+	59, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 61, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 63, 0, 0, 0, 0, 0, 65, 0,
+	66, 5, 0, 60, 67, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 68,
+	0, 0, 69, 0, 0, 70, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 71, 0, 0, 0, 0, 0, 72, 0,
+	0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0, 75, 78, 77, 76,
+	0, 0, 79, 80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 81, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 83, 82, 0, 0, 84, 0, 85,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 86,
+	42, 0, 0, 0, 88, 87, 0, 0, 89, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 90, 0, 0, 0, 91, 92, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 94, 0, 93, 0, 0, 0, 0, 0, 0, 95, 0,
+	0, 0, 0, 0, 96, 0, 0, 0, 0, 0, 0, 97, 97, 0, 0, 0,
+	0,
+};
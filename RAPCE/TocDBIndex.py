@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#------------------------------------------------------------------------------
+#	[TocDBIndex.py]
+#
+#	Generates TocDBIndex.h from TocDB.cpp and TocDB.h.
+#
+#	_TocHash[] is the open-addressing hash table that TOCDB_IsMatch() probes
+#	with the disc's TOC fingerprint (tracks 1-99). hash_toc() in TocDB.cpp
+#	must stay identical to toc_hash() below. When several entries share a TOC
+#	the first one is stored, the same result as the old linear scan.
+#
+#	_GameID[] maps every s_DiscInfo[] entry to the patch ID from the enum in
+#	TocDB.h (TOCDB_GAME_NONE when the game needs no patch). Each enumerator
+#	carries the exact title it stands for as a //"..." comment.
+#
+#	Run it after editing s_DiscInfo[] or the patch ID list:
+#		python TocDBIndex.py
+#------------------------------------------------------------------------------
+import os
+import re
+import sys
+
+HASH_SIZE = 2048	# power of two, about four times the number of entries
+FP_TRACKS = 99		# pDisc->TOC[1..99] corresponds to s_DiscInfo[].TOC[0..98]
+ENCODING = 'cp932'
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+
+def read(name):
+	with open(os.path.join(here, name), 'rb') as f:
+		return f.read().decode(ENCODING)
+
+
+def parse_discs(src):
+	start = src.index('s_DiscInfo[] =')
+	end = src.index('\n\t\tNULL\n', start)
+	body = src[start:end]
+	heads = list(re.finditer(r'^\t\t"((?:[^"\\]|\\.)*)",', body, re.M))
+	discs = []
+	for n, m in enumerate(heads):
+		stop = heads[n+1].start() if n+1 < len(heads) else len(body)
+		rows = re.findall(r'\{\s*((?:0x[0-9a-fA-F]+\s*,\s*){7}0x[0-9a-fA-F]+)\s*\}', body[m.end():stop])
+		toc = bytearray(FP_TRACKS * 8)
+		for i, row in enumerate(rows[:FP_TRACKS]):
+			toc[i*8:i*8+8] = bytes(int(v, 16) for v in row.split(','))
+		discs.append((m.group(1), bytes(toc)))
+	return discs
+
+
+def parse_games(src):
+	start = src.index('TOCDB_GAME_NONE')
+	end = src.index('TOCDB_GAME_COUNT', start)
+	return re.findall(r'^\t(TOCDB_\w+),\s*//"([^"]*)"', src[start:end], re.M)
+
+
+def toc_hash(toc):
+	n = 1
+	while n < FP_TRACKS and toc[(n-1)*8] != 0:
+		n += 1
+	h = 2166136261
+	for b in toc[:n*8]:
+		h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+	return h & (HASH_SIZE-1)
+
+
+def main():
+	discs = parse_discs(read('TocDB.cpp'))
+	games = parse_games(read('TocDB.h'))
+	titles = [title for title, toc in discs]
+
+	slots = [-1] * HASH_SIZE
+	for i, (title, toc) in enumerate(discs):
+		h = toc_hash(toc)
+		while slots[h] != -1 and discs[slots[h]][1] != toc:
+			h = (h+1) & (HASH_SIZE-1)
+		if slots[h] == -1:
+			slots[h] = i
+
+	if len(games) >= 256:
+		sys.exit('TocDBIndex.py: too many patch IDs for Uint8 _GameID[]')
+	game_id = [0] * len(discs)
+	for n, (name, title) in enumerate(games):
+		if title not in titles:
+			sys.exit('TocDBIndex.py: %s: "%s" is not in s_DiscInfo[]' % (name, title))
+		for i, t in enumerate(titles):
+			if t == title:
+				game_id[i] = n + 1
+
+	out = []
+	out.append('/* Generated by TocDBIndex.py from TocDB.cpp and TocDB.h. Do not edit. */')
+	out.append('#define TOCDB_INDEX_ENTRIES\t%d' % len(discs))
+	out.append('#define TOCDB_HASH_SIZE\t\t%d' % HASH_SIZE)
+	out.append('')
+	out.append('static const Sint16\t_TocHash[TOCDB_HASH_SIZE] =')
+	out.append('{')
+	for i in range(0, HASH_SIZE, 16):
+		out.append('\t' + ' '.join('%d,' % v for v in slots[i:i+16]))
+	out.append('};')
+	out.append('')
+	out.append('static const Uint8\t_GameID[TOCDB_INDEX_ENTRIES] =')
+	out.append('{')
+	for i in range(0, len(discs), 16):
+		out.append('\t' + ' '.join('%d,' % v for v in game_id[i:i+16]))
+	out.append('};')
+	with open(os.path.join(here, 'TocDBIndex.h'), 'w', newline='\n') as f:
+		f.write('\n'.join(out) + '\n')
+
+	used = sum(1 for v in slots if v != -1)
+	print('TocDBIndex.h: %d entries, %d distinct TOCs, %d patched titles' % (len(discs), used, len(games)))
+
+
+if __name__ == '__main__':
+	main()
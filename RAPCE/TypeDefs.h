@@ -29,6 +29,8 @@ typedef		short			Sint16;
 typedef		unsigned short	Uint16;
 typedef		long			Sint32;
 typedef		unsigned long	Uint32;
+typedef		__int64			Sint64;
+typedef		unsigned __int64	Uint64;
 
 //typedef		int				BOOL;
 
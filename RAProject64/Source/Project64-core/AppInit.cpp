@@ -186,6 +186,10 @@ static bool ParseCommand(int32_t argc, char **argv)
             g_Settings->SaveBool(Cmd_ShowHelp, true);
             return false;
         }
+        else if (strcmp(argv[i], "--recompiler-cache-bench") == 0)
+        {
+            g_Settings->SaveBool(Cmd_RecompilerCacheBench, true);
+        }
         else if (ArgsLeft == 0 && argv[i][0] != '-')
         {
             g_Settings->SaveString(Cmd_RomFile, &(argv[i][0]));
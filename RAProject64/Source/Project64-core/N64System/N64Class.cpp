@@ -45,6 +45,21 @@ void RAMByteWriter( unsigned int nOffs, unsigned int nVal )
 	g_MMU->Rdram()[ nOffs ] = nVal;
 }
 
+unsigned int RAMBlockReader( unsigned int nOffs, unsigned char * pBuffer, unsigned int nCount )
+{
+	uint32_t RdramSize = g_MMU->RdramSize();
+	if (nOffs >= RdramSize)
+	{
+		return 0;
+	}
+	if (nCount > RdramSize - nOffs)
+	{
+		nCount = RdramSize - nOffs;
+	}
+	memcpy(pBuffer, g_MMU->Rdram() + nOffs, nCount);
+	return nCount;
+}
+
 CN64System::CN64System(CPlugins * Plugins, bool SavesReadOnly, bool SyncSystem) :
 CSystemEvents(this, Plugins),
 m_EndEmulation(false),
@@ -361,6 +376,7 @@ void CN64System::RunLoadedImage(void)
 	// #RA
 	RA_ClearMemoryBanks();
 	RA_InstallMemoryBank( 0, RAMByteReader, RAMByteWriter, g_MMU->RdramSize() );
+	RA_InstallMemoryBankBlockReader( 0, RAMBlockReader );
     RA_ActivateGame( g_RAGameId );
     WriteTrace(TraceN64System, TraceDebug, "Done");
 }
@@ -2185,6 +2201,17 @@ void CN64System::RefreshScreen()
     if ((bBasicMode() || bLimitFPS()) && !bSyncToAudio())
     {
         if (bShowCPUPer()) { m_CPU_Usage.StartTimer(Timer_Idel); }
+        if (m_Recomp != NULL && m_SyncCPU == NULL)
+        {
+            /* Give the recompiler most of the time this frame left idle to translate blocks remembered from
+               earlier sessions. This runs inside the timer callback, so the work waits until control is back in
+               the recompiler's dispatch loop, and the limiter sleeps that much less on the next frame */
+            uint32_t Idle = m_Limiter.IdleMicroSeconds();
+            if (Idle > 2000)
+            {
+                m_Recomp->ScheduleWarmCode(Idle - 2000);
+            }
+        }
         uint32_t FrameRate;
         if (m_Limiter.Timer_Process(&FrameRate) && bDisplayFrameRate())
         {
@@ -26,13 +26,14 @@ bool DelaySlotEffectsCompare(uint32_t PC, uint32_t Reg1, uint32_t Reg2);
 extern "C" void __clear_cache_android(uint8_t* begin, uint8_t *end);
 #endif
 
-CCodeBlock::CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation) :
+CCodeBlock::CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation, BLOCK_COUNTERS * Counters, CRecompilerCache::BLOCK_ANALYSIS * Analysis) :
 m_VAddrEnter(VAddrEnter),
 m_VAddrFirst(VAddrEnter),
 m_VAddrLast(VAddrEnter),
 m_CompiledLocation(CompiledLocation),
 m_EnterSection(NULL),
 m_RecompilerOps(NULL),
+m_Counters(Counters),
 m_Test(1)
 {
 #if defined(__arm__) || defined(_M_ARM)
@@ -87,7 +88,18 @@ m_Test(1)
         memset(m_MemContents, 0, sizeof(m_MemContents));
     }
 
-    AnalyseBlock();
+    if (Analysis != NULL && !Analysis->Sections.empty() && g_System->bLinkBlocks())
+    {
+        RestoreAnalysis(*Analysis);
+    }
+    else
+    {
+        AnalyseBlock();
+        if (Analysis != NULL)
+        {
+            RecordAnalysis(*Analysis);
+        }
+    }
 }
 
 CCodeBlock::~CCodeBlock()
@@ -437,6 +449,101 @@ bool CCodeBlock::AnalyseBlock()
     return true;
 }
 
+void CCodeBlock::RecordAnalysis(CRecompilerCache::BLOCK_ANALYSIS & Analysis) const
+{
+    Analysis.Sections.clear();
+    Analysis.Parents.clear();
+    if (!g_System->bLinkBlocks())
+    {
+        return;
+    }
+
+    for (SectionList::const_iterator itr = m_Sections.begin(); itr != m_Sections.end(); itr++)
+    {
+        const CCodeSection * Section = *itr;
+        if (Section->m_SectionID == 0)
+        {
+            continue;
+        }
+
+        CRecompilerCache::SECTION_ENTRY Entry;
+        Entry.EnterPC = Section->m_EnterPC;
+        Entry.EndPC = Section->m_EndPC;
+        Entry.JumpPC = Section->m_Jump.JumpPC;
+        Entry.JumpTargetPC = Section->m_Jump.TargetPC;
+        Entry.ContinuePC = Section->m_Cont.JumpPC;
+        Entry.ContinueTargetPC = Section->m_Cont.TargetPC;
+        Entry.JumpSection = Section->m_JumpSection != NULL ? Section->m_JumpSection->m_SectionID : (uint32_t)CRecompilerCache::NoSection;
+        Entry.ContinueSection = Section->m_ContinueSection != NULL ? Section->m_ContinueSection->m_SectionID : (uint32_t)CRecompilerCache::NoSection;
+        Entry.ParentCount = (uint32_t)Section->m_ParentSection.size();
+        Entry.Flags = 0;
+        if (Section->m_LinkAllowed) { Entry.Flags |= CRecompilerCache::Section_LinkAllowed; }
+        if (Section->m_EndSection) { Entry.Flags |= CRecompilerCache::Section_End; }
+        if (Section->m_InLoop) { Entry.Flags |= CRecompilerCache::Section_InLoop; }
+        if (Section->m_DelaySlot) { Entry.Flags |= CRecompilerCache::Section_DelaySlot; }
+        if (Section->m_Jump.PermLoop) { Entry.Flags |= CRecompilerCache::Section_PermLoop; }
+        Analysis.Sections.push_back(Entry);
+
+        for (CCodeSection::SECTION_LIST::const_iterator Parent = Section->m_ParentSection.begin(); Parent != Section->m_ParentSection.end(); Parent++)
+        {
+            Analysis.Parents.push_back((*Parent)->m_SectionID);
+        }
+    }
+}
+
+// Puts the sections back the way CreateBlockLinkage and DetermineLoops left
+// them. The register sets they carry are still the defaults at that point, so
+// the parents can be linked directly rather than through AddParent.
+void CCodeBlock::RestoreAnalysis(const CRecompilerCache::BLOCK_ANALYSIS & Analysis)
+{
+    // the constructor has already made section 0 and the enter section
+    std::vector<CCodeSection *> Sections(m_Sections.begin(), m_Sections.end());
+    for (size_t i = 1, n = Analysis.Sections.size(); i < n; i++)
+    {
+        const CRecompilerCache::SECTION_ENTRY & Entry = Analysis.Sections[i];
+        bool LinkAllowed = (Entry.Flags & CRecompilerCache::Section_LinkAllowed) != 0;
+        CCodeSection * Section = new CCodeSection(this, Entry.EnterPC, (uint32_t)Sections.size(), LinkAllowed);
+        m_Sections.push_back(Section);
+        Sections.push_back(Section);
+        if (LinkAllowed)
+        {
+            m_SectionMap.insert(SectionMap::value_type(Entry.EnterPC, Section));
+        }
+    }
+
+    const uint32_t * Parent = Analysis.Parents.empty() ? NULL : &Analysis.Parents[0];
+    for (size_t i = 0, n = Analysis.Sections.size(); i < n; i++)
+    {
+        const CRecompilerCache::SECTION_ENTRY & Entry = Analysis.Sections[i];
+        CCodeSection * Section = Sections[i + 1];
+
+        Section->m_EndPC = Entry.EndPC;
+        if (Entry.JumpPC != (uint32_t)-1 || Entry.JumpTargetPC != (uint32_t)-1)
+        {
+            Section->SetJumpAddress(Entry.JumpPC, Entry.JumpTargetPC, (Entry.Flags & CRecompilerCache::Section_PermLoop) != 0);
+        }
+        if (Entry.ContinuePC != (uint32_t)-1 || Entry.ContinueTargetPC != (uint32_t)-1)
+        {
+            Section->SetContinueAddress(Entry.ContinuePC, Entry.ContinueTargetPC);
+        }
+        Section->m_JumpSection = Entry.JumpSection != CRecompilerCache::NoSection ? Sections[Entry.JumpSection] : NULL;
+        Section->m_ContinueSection = Entry.ContinueSection != CRecompilerCache::NoSection ? Sections[Entry.ContinueSection] : NULL;
+        Section->m_EndSection = (Entry.Flags & CRecompilerCache::Section_End) != 0;
+        Section->m_InLoop = (Entry.Flags & CRecompilerCache::Section_InLoop) != 0;
+        if ((Entry.Flags & CRecompilerCache::Section_DelaySlot) != 0)
+        {
+            Section->SetDelaySlot();
+        }
+
+        Section->m_ParentSection.clear();
+        for (uint32_t p = 0; p < Entry.ParentCount; p++)
+        {
+            Section->m_ParentSection.push_back(Sections[*Parent++]);
+        }
+    }
+    LogSectionInfo();
+}
+
 bool CCodeBlock::AnalyzeInstruction(uint32_t PC, uint32_t & TargetPC, uint32_t & ContinuePC, bool & LikelyBranch, bool & IncludeDelaySlot, bool & EndBlock, bool & PermLoop)
 {
     TargetPC = (uint32_t)-1;
@@ -756,6 +863,7 @@ bool CCodeBlock::Compile()
     CPU_Message("No of Sections: %d", NoOfSections());
     CPU_Message("====== recompiled code ======");
 
+    m_RecompilerOps->SetCurrentSection(m_EnterSection);
     m_RecompilerOps->EnterCodeBlock();
     if (g_System->bLinkBlocks())
     {
@@ -12,11 +12,24 @@
 #include <Common/md5.h>
 #include <Project64-core/N64System/Recompiler/RecompilerOps.h>
 #include <Project64-core/N64System/Recompiler/CodeSection.h>
+#include <Project64-core/N64System/Recompiler/RecompilerCache.h>
+
+// Updated by the recompiled code itself: EntryCount on every entry into the
+// block and Cycles with the count register cycles charged at each exit.
+// Only emitted while execution times are being recorded.
+typedef struct
+{
+    uint64_t EntryCount;
+    uint64_t Cycles;
+} BLOCK_COUNTERS;
 
 class CCodeBlock
 {
 public:
-    CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation);
+    // When Analysis holds a section layout from the recompiler cache the block is
+    // rebuilt from it instead of analysing the MIPS code, when it is empty it
+    // gets the layout the analysis produced
+    CCodeBlock(uint32_t VAddrEnter, uint8_t * CompiledLocation, BLOCK_COUNTERS * Counters = NULL, CRecompilerCache::BLOCK_ANALYSIS * Analysis = NULL);
     ~CCodeBlock();
 
     bool Compile();
@@ -30,6 +43,7 @@ public:
     const CCodeSection & EnterSection() const { return *m_EnterSection; }
     const MD5Digest & Hash() const { return m_Hash; }
     CRecompilerOps *& RecompilerOps() { return m_RecompilerOps; }
+    BLOCK_COUNTERS * Counters() const { return m_Counters; }
     void SetVAddrFirst(uint32_t VAddr) { m_VAddrFirst = VAddr; }
     void SetVAddrLast(uint32_t VAddr) { m_VAddrLast = VAddr; }
 
@@ -47,6 +61,8 @@ private:
     CCodeBlock& operator=(const CCodeBlock&); // Disable assignment
 
     bool AnalyseBlock();
+    void RecordAnalysis(CRecompilerCache::BLOCK_ANALYSIS & Analysis) const;
+    void RestoreAnalysis(const CRecompilerCache::BLOCK_ANALYSIS & Analysis);
 
     bool CreateBlockLinkage(CCodeSection * EnterSection);
     void DetermineLoops();
@@ -72,4 +88,5 @@ private:
     uint64_t         m_MemContents[2];
     uint64_t *       m_MemLocation[2];
     CRecompilerOps * m_RecompilerOps;
+    BLOCK_COUNTERS * m_Counters;
 };
@@ -18,6 +18,7 @@ CCompiledFunc::CCompiledFunc( const CCodeBlock & CodeBlock ) :
     m_Hash(CodeBlock.Hash()),
     m_Function((Func)CodeBlock.CompiledLocation()),
     m_FunctionEnd(CodeBlock.CompiledLocationEnd()),
+    m_Counters(CodeBlock.Counters()),
     m_Next(NULL)
 {
     m_MemContents[0] = CodeBlock.MemContents(0);
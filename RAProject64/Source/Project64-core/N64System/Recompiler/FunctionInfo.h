@@ -25,6 +25,7 @@ public:
     const Func     Function  () const { return m_Function; }
     const uint8_t *FunctionEnd() const { return m_FunctionEnd; }
     const MD5Digest&    Hash () const { return m_Hash; }
+    BLOCK_COUNTERS * Counters() const { return m_Counters; }
 
     CCompiledFunc*    Next () const { return m_Next; }
     void SetNext(CCompiledFunc* Next) { m_Next = Next; }
@@ -47,6 +48,9 @@ private:
     //From querying the recompiler get information about the function
     Func  m_Function;
 
+    // NULL unless the block was compiled while execution times were recorded
+    BLOCK_COUNTERS * m_Counters;
+
     CCompiledFunc* m_Next;
 
     //Validation
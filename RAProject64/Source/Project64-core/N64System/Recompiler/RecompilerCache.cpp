@@ -0,0 +1,252 @@
+/****************************************************************************
+*                                                                           *
+* Project64 - A Nintendo 64 emulator.                                      *
+* http://www.pj64-emu.com/                                                  *
+* Copyright (C) 2012 Project64. All rights reserved.                        *
+*                                                                           *
+* License:                                                                  *
+* GNU/GPLv2 http://www.gnu.org/licenses/gpl-2.0.html                        *
+*                                                                           *
+****************************************************************************/
+#include "stdafx.h"
+#include <Project64-core/N64System/Recompiler/RecompilerCache.h>
+#include <Common/FileClass.h>
+#include <Common/path.h>
+
+CRecompilerCache::CRecompilerCache() :
+    m_Enabled(false),
+    m_Changed(false),
+    m_LoadedCount(0)
+{
+}
+
+CRecompilerCache::~CRecompilerCache()
+{
+}
+
+void CRecompilerCache::Load(const char * GameKey)
+{
+    m_Enabled = false;
+    m_Changed = false;
+    m_Entries.clear();
+    m_Sections.clear();
+    m_Parents.clear();
+    m_Index.clear();
+    m_Pending.clear();
+    m_PendingPos = m_Pending.end();
+    m_LoadedCount = 0;
+
+    if (GameKey == NULL || GameKey[0] == '\0')
+    {
+        return;
+    }
+
+    // the ini key holds the rom crcs and country code, eg "XXXXXXXX-XXXXXXXX-C:45"
+    stdstr Name(GameKey);
+    Name.Replace(':', '-');
+
+    CPath CacheDir(g_Settings->LoadStringVal(Setting_RecompilerCacheDir).c_str(), "");
+    if (!CacheDir.DirectoryExists())
+    {
+        CacheDir.DirectoryCreate();
+    }
+    m_FileName = (const char *)CPath((const char *)CacheDir, stdstr_f("%s.rcache", Name.c_str()).c_str());
+    m_Enabled = true;
+
+    CFile File;
+    if (!File.Open(m_FileName.c_str(), CFileBase::modeRead))
+    {
+        WriteTrace(TraceRecompiler, TraceInfo, "No recompiler cache for %s", GameKey);
+        return;
+    }
+
+    uint32_t Header[5];
+    if (File.Read(Header, sizeof(Header)) != sizeof(Header) || Header[0] != CacheMagic || Header[1] != CacheVersion ||
+        Header[2] > MaxEntries || Header[3] > MaxSections || Header[4] > MaxParents)
+    {
+        WriteTrace(TraceRecompiler, TraceWarning, "Ignoring invalid recompiler cache %s", m_FileName.c_str());
+        return;
+    }
+
+    ENTRY_LIST Entries(Header[2]);
+    SECTION_LIST Sections(Header[3]);
+    PARENT_LIST Parents(Header[4]);
+    if ((Header[2] != 0 && File.Read(&Entries[0], Header[2] * sizeof(BLOCK_ENTRY)) != Header[2] * sizeof(BLOCK_ENTRY)) ||
+        (Header[3] != 0 && File.Read(&Sections[0], Header[3] * sizeof(SECTION_ENTRY)) != Header[3] * sizeof(SECTION_ENTRY)) ||
+        (Header[4] != 0 && File.Read(&Parents[0], Header[4] * sizeof(uint32_t)) != Header[4] * sizeof(uint32_t)))
+    {
+        WriteTrace(TraceRecompiler, TraceWarning, "Ignoring truncated recompiler cache %s", m_FileName.c_str());
+        return;
+    }
+
+    m_Sections.swap(Sections);
+    m_Parents.swap(Parents);
+    for (ENTRY_LIST::iterator itr = Entries.begin(); itr != Entries.end(); itr++)
+    {
+        if (!ValidAnalysis(*itr, (uint32_t)m_Sections.size(), (uint32_t)m_Parents.size()))
+        {
+            // still worth warming, the block is just analysed again
+            itr->SectionCount = 0;
+            itr->ParentCount = 0;
+        }
+        if (m_Entries.size() < MaxEntries && !Exists(*itr))
+        {
+            m_Index.insert(ENTRY_INDEX::value_type(itr->VAddrEnter, (uint32_t)m_Entries.size()));
+            m_Entries.push_back(*itr);
+        }
+    }
+    for (uint32_t i = 0, n = (uint32_t)m_Entries.size(); i < n; i++)
+    {
+        m_Pending.push_back(i);
+    }
+    m_PendingPos = m_Pending.end();
+    m_LoadedCount = (uint32_t)m_Entries.size();
+    m_Changed = false;
+    WriteTrace(TraceRecompiler, TraceInfo, "Loaded %d blocks from %s", m_LoadedCount, m_FileName.c_str());
+}
+
+void CRecompilerCache::Save()
+{
+    if (!m_Enabled || !m_Changed)
+    {
+        return;
+    }
+
+    CFile File;
+    if (!File.Open(m_FileName.c_str(), CFileBase::modeWrite | CFileBase::modeCreate))
+    {
+        WriteTrace(TraceRecompiler, TraceError, "Failed to open %s", m_FileName.c_str());
+        return;
+    }
+
+    uint32_t Header[5] = { CacheMagic, CacheVersion, (uint32_t)m_Entries.size(), (uint32_t)m_Sections.size(), (uint32_t)m_Parents.size() };
+    File.Write(Header, sizeof(Header));
+    if (!m_Entries.empty())
+    {
+        File.Write(&m_Entries[0], (uint32_t)(m_Entries.size() * sizeof(BLOCK_ENTRY)));
+    }
+    if (!m_Sections.empty())
+    {
+        File.Write(&m_Sections[0], (uint32_t)(m_Sections.size() * sizeof(SECTION_ENTRY)));
+    }
+    if (!m_Parents.empty())
+    {
+        File.Write(&m_Parents[0], (uint32_t)(m_Parents.size() * sizeof(uint32_t)));
+    }
+    File.SetEndOfFile();
+    m_Changed = false;
+}
+
+bool CRecompilerCache::Exists(const BLOCK_ENTRY & Entry) const
+{
+    std::pair<ENTRY_INDEX::const_iterator, ENTRY_INDEX::const_iterator> Range = m_Index.equal_range(Entry.VAddrEnter);
+    for (ENTRY_INDEX::const_iterator itr = Range.first; itr != Range.second; itr++)
+    {
+        const BLOCK_ENTRY & Existing = m_Entries[itr->second];
+        if (Existing.PAddrFirst == Entry.PAddrFirst && Existing.Length == Entry.Length &&
+            memcmp(Existing.Hash.digest, Entry.Hash.digest, sizeof(Entry.Hash.digest)) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CRecompilerCache::ValidAnalysis(const BLOCK_ENTRY & Entry, uint32_t SectionCount, uint32_t ParentCount) const
+{
+    if (Entry.SectionCount == 0)
+    {
+        return Entry.ParentCount == 0;
+    }
+    if (Entry.FirstSection > SectionCount || Entry.SectionCount > SectionCount - Entry.FirstSection ||
+        Entry.FirstParent > ParentCount || Entry.ParentCount > ParentCount - Entry.FirstParent ||
+        m_Sections[Entry.FirstSection].EnterPC != Entry.VAddrEnter)
+    {
+        return false;
+    }
+
+    // section ids run from 1 to SectionCount, parents may also be the entry stub
+    uint32_t Parents = 0;
+    for (uint32_t i = 0; i < Entry.SectionCount; i++)
+    {
+        const SECTION_ENTRY & Section = m_Sections[Entry.FirstSection + i];
+        if ((Section.JumpSection != NoSection && (Section.JumpSection == 0 || Section.JumpSection > Entry.SectionCount)) ||
+            (Section.ContinueSection != NoSection && (Section.ContinueSection == 0 || Section.ContinueSection > Entry.SectionCount)) ||
+            Section.ParentCount > Entry.ParentCount - Parents)
+        {
+            return false;
+        }
+        Parents += Section.ParentCount;
+    }
+    if (Parents != Entry.ParentCount)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < Entry.ParentCount; i++)
+    {
+        if (m_Parents[Entry.FirstParent + i] > Entry.SectionCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CRecompilerCache::AddBlock(const BLOCK_ENTRY & Entry, const BLOCK_ANALYSIS & Analysis)
+{
+    if (m_Entries.size() >= MaxEntries || Exists(Entry) ||
+        m_Sections.size() + Analysis.Sections.size() > MaxSections || m_Parents.size() + Analysis.Parents.size() > MaxParents)
+    {
+        return;
+    }
+
+    BLOCK_ENTRY NewEntry = Entry;
+    NewEntry.FirstSection = (uint32_t)m_Sections.size();
+    NewEntry.SectionCount = (uint32_t)Analysis.Sections.size();
+    NewEntry.FirstParent = (uint32_t)m_Parents.size();
+    NewEntry.ParentCount = (uint32_t)Analysis.Parents.size();
+    m_Sections.insert(m_Sections.end(), Analysis.Sections.begin(), Analysis.Sections.end());
+    m_Parents.insert(m_Parents.end(), Analysis.Parents.begin(), Analysis.Parents.end());
+    if (!ValidAnalysis(NewEntry, (uint32_t)m_Sections.size(), (uint32_t)m_Parents.size()))
+    {
+        m_Sections.resize(NewEntry.FirstSection);
+        m_Parents.resize(NewEntry.FirstParent);
+        NewEntry.SectionCount = 0;
+        NewEntry.ParentCount = 0;
+    }
+
+    m_Index.insert(ENTRY_INDEX::value_type(NewEntry.VAddrEnter, (uint32_t)m_Entries.size()));
+    m_Entries.push_back(NewEntry);
+    m_Changed = true;
+}
+
+void CRecompilerCache::GetAnalysis(const BLOCK_ENTRY & Entry, BLOCK_ANALYSIS & Analysis) const
+{
+    Analysis.Sections.assign(m_Sections.begin() + Entry.FirstSection, m_Sections.begin() + Entry.FirstSection + Entry.SectionCount);
+    Analysis.Parents.assign(m_Parents.begin() + Entry.FirstParent, m_Parents.begin() + Entry.FirstParent + Entry.ParentCount);
+}
+
+const CRecompilerCache::BLOCK_ENTRY * CRecompilerCache::NextPending()
+{
+    if (m_Pending.empty())
+    {
+        return NULL;
+    }
+    if (m_PendingPos == m_Pending.end() || ++m_PendingPos == m_Pending.end())
+    {
+        m_PendingPos = m_Pending.begin();
+    }
+    return &m_Entries[*m_PendingPos];
+}
+
+void CRecompilerCache::RemovePending()
+{
+    if (m_PendingPos == m_Pending.end())
+    {
+        return;
+    }
+    // step back so the following NextPending lands on the entry after this one
+    PENDING_LIST::iterator Removed = m_PendingPos;
+    m_PendingPos = Removed == m_Pending.begin() ? m_Pending.end() : --PENDING_LIST::iterator(Removed);
+    m_Pending.erase(Removed);
+}
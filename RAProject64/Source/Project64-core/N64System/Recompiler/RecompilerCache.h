@@ -0,0 +1,125 @@
+/****************************************************************************
+*                                                                           *
+* Project64 - A Nintendo 64 emulator.                                      *
+* http://www.pj64-emu.com/                                                  *
+* Copyright (C) 2012 Project64. All rights reserved.                        *
+*                                                                           *
+* License:                                                                  *
+* GNU/GPLv2 http://www.gnu.org/licenses/gpl-2.0.html                        *
+*                                                                           *
+****************************************************************************/
+#pragma once
+#include <Common/md5.h>
+#include <list>
+#include <map>
+#include <vector>
+
+/*
+ * Remembers, per game, which blocks were compiled in earlier sessions: where
+ * they start, a hash of the MIPS code they were compiled from and the section
+ * layout CCodeBlock worked out for them (sections, links, delay slots and
+ * loops). The x86 code itself is not stored, it embeds the addresses of this
+ * session's registers, timers and RDRAM and has no relocation information.
+ *
+ * On the next boot the recompiler translates the remembered blocks in the
+ * time the speed limiter would otherwise sleep, once their code is in RDRAM
+ * with the same hash, instead of stalling when the game first reaches them.
+ * Those blocks are rebuilt from the stored layout rather than analysed again.
+ */
+class CRecompilerCache
+{
+public:
+    typedef struct
+    {
+        uint32_t  VAddrEnter;
+        uint32_t  PAddrEnter;
+        uint32_t  PAddrFirst;   // physical address of the lowest opcode in the block
+        uint32_t  Length;       // bytes of MIPS code the hash covers
+        MD5Digest Hash;
+        uint32_t  FirstSection; // into the section list of the cache
+        uint32_t  SectionCount; // 0 when the layout was not stored
+        uint32_t  FirstParent;  // into the parent list of the cache
+        uint32_t  ParentCount;
+    } BLOCK_ENTRY;
+
+    enum
+    {
+        Section_LinkAllowed = 0x01,
+        Section_End = 0x02,
+        Section_InLoop = 0x04,
+        Section_DelaySlot = 0x08,
+        Section_PermLoop = 0x10,
+    };
+
+    enum { NoSection = 0xFFFFFFFF };
+
+    // A section as CCodeBlock::AnalyseBlock left it, other sections are
+    // referred to by section id. Section 0 is the fixed entry stub of every
+    // block and is not stored, the list starts at section 1.
+    typedef struct
+    {
+        uint32_t EnterPC;
+        uint32_t EndPC;
+        uint32_t JumpPC;
+        uint32_t JumpTargetPC;
+        uint32_t ContinuePC;
+        uint32_t ContinueTargetPC;
+        uint32_t JumpSection;
+        uint32_t ContinueSection;
+        uint32_t ParentCount;  // ids follow on from the previous section's in Parents
+        uint32_t Flags;
+    } SECTION_ENTRY;
+
+    typedef std::vector<SECTION_ENTRY> SECTION_LIST;
+    typedef std::vector<uint32_t> PARENT_LIST;
+
+    typedef struct
+    {
+        SECTION_LIST Sections;
+        PARENT_LIST  Parents;
+    } BLOCK_ANALYSIS;
+
+    CRecompilerCache();
+    ~CRecompilerCache();
+
+    bool Enabled() const { return m_Enabled; }
+    void Load(const char * GameKey);
+    void Save();
+
+    void AddBlock(const BLOCK_ENTRY & Entry, const BLOCK_ANALYSIS & Analysis);
+    void GetAnalysis(const BLOCK_ENTRY & Entry, BLOCK_ANALYSIS & Analysis) const;
+
+    // Walks the blocks loaded from disk that have not been translated yet,
+    // oldest first, wrapping around; RemovePending drops the last one returned
+    bool HavePending() const { return !m_Pending.empty(); }
+    const BLOCK_ENTRY * NextPending();
+    void RemovePending();
+    uint32_t PendingCount() const { return (uint32_t)m_Pending.size(); }
+
+    uint32_t LoadedCount() const { return m_LoadedCount; }
+
+private:
+    CRecompilerCache(const CRecompilerCache&);              // Disable copy constructor
+    CRecompilerCache& operator=(const CRecompilerCache&);   // Disable assignment
+
+    bool Exists(const BLOCK_ENTRY & Entry) const;
+    bool ValidAnalysis(const BLOCK_ENTRY & Entry, uint32_t SectionCount, uint32_t ParentCount) const;
+
+    typedef std::vector<BLOCK_ENTRY> ENTRY_LIST;
+    typedef std::multimap<uint32_t, uint32_t> ENTRY_INDEX;
+    typedef std::list<uint32_t> PENDING_LIST;
+
+    enum { CacheMagic = 0x43524A50, CacheVersion = 2 };
+    enum { MaxEntries = 0x10000, MaxSections = 0x100000, MaxParents = 0x100000 };
+
+    bool          m_Enabled;
+    bool          m_Changed;
+    std::string   m_FileName;
+    ENTRY_LIST    m_Entries;
+    SECTION_LIST  m_Sections;
+    PARENT_LIST   m_Parents;
+    ENTRY_INDEX   m_Index;          // VAddrEnter -> m_Entries
+    PENDING_LIST  m_Pending;
+    PENDING_LIST::iterator m_PendingPos;
+    uint32_t      m_LoadedCount;
+};
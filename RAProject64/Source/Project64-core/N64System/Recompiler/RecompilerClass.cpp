@@ -15,10 +15,24 @@
 #include <Project64-core/N64System/N64Class.h>
 #include <Project64-core/N64System/Interpreter/InterpreterCPU.h>
 #include <Project64-core/ExceptionHandler.h>
+#include <algorithm>
 
 CRecompiler::CRecompiler(CRegisters & Registers, bool & EndEmulation) :
 m_Registers(Registers),
 m_EndEmulation(EndEmulation),
+m_BlockProfileSpan(0),
+m_ClearingPhys(false),
+m_DemandCompiles(0),
+m_DemandCompileTime(0),
+m_WarmMicroSeconds(0),
+m_WarmCompiles(0),
+m_WarmCompileTime(0),
+m_WarmRestored(0),
+m_BenchAnalysis(false),
+m_BenchBlocks(0),
+m_BenchDiffer(0),
+m_BenchColdTime(0),
+m_BenchWarmTime(0),
 PROGRAM_COUNTER(Registers.m_PROGRAM_COUNTER)
 {
     CFunctionMap::AllocateMemory();
@@ -26,10 +40,20 @@ PROGRAM_COUNTER(Registers.m_PROGRAM_COUNTER)
     {
         ResetMemoryStackPos();
     }
+    if (g_Settings->LoadBool(Setting_RecompilerCache))
+    {
+        m_TranslationCache.Load(g_Settings->LoadStringVal(Game_IniKey).c_str());
+        m_BenchAnalysis = g_Settings->LoadBool(Cmd_RecompilerCacheBench);
+    }
 }
 
 CRecompiler::~CRecompiler()
 {
+    if (m_TranslationCache.Enabled())
+    {
+        m_TranslationCache.Save();
+        LogTranslationCache();
+    }
     ResetRecompCode(false);
 }
 
@@ -115,6 +139,10 @@ void CRecompiler::RecompilerMain_VirtualTable()
 
     while (!Done)
     {
+        if (m_WarmMicroSeconds != 0)
+        {
+            WarmCode();
+        }
         if (!g_TransVaddr->ValidVaddr(PC))
         {
             m_Registers.DoTLBReadMiss(false, PC);
@@ -341,6 +369,10 @@ void CRecompiler::RecompilerMain_Lookup()
 {
     while (!m_EndEmulation)
     {
+        if (m_WarmMicroSeconds != 0)
+        {
+            WarmCode();
+        }
         uint32_t PhysicalAddr = PROGRAM_COUNTER & 0x1FFFFFFF;
         if (PhysicalAddr < g_System->RdramSize())
         {
@@ -535,6 +567,10 @@ void CRecompiler::RecompilerMain_Lookup_TLB()
 
     while (!m_EndEmulation)
     {
+        if (m_WarmMicroSeconds != 0)
+        {
+            WarmCode();
+        }
         if (!g_TransVaddr->TranslateVaddr(PROGRAM_COUNTER, PhysicalAddr))
         {
             m_Registers.DoTLBReadMiss(false, PROGRAM_COUNTER);
@@ -587,6 +623,10 @@ void CRecompiler::RecompilerMain_Lookup_validate()
 {
     while (!m_EndEmulation)
     {
+        if (m_WarmMicroSeconds != 0)
+        {
+            WarmCode();
+        }
         uint32_t PhysicalAddr = PROGRAM_COUNTER & 0x1FFFFFFF;
         if (PhysicalAddr < g_System->RdramSize())
         {
@@ -645,6 +685,10 @@ void CRecompiler::RecompilerMain_Lookup_validate_TLB()
 
     while (!Done)
     {
+        if (m_WarmMicroSeconds != 0)
+        {
+            WarmCode();
+        }
         if (!g_TransVaddr->TranslateVaddr(PC, PhysicalAddr))
         {
             m_Registers.DoTLBReadMiss(false, PC);
@@ -957,37 +1001,93 @@ CCompiledFunc * CRecompiler::CompileCode()
         return NULL;
     }
 
-    CCompiledFuncList::iterator iter = m_Functions.find(PROGRAM_COUNTER);
-    if (iter != m_Functions.end())
+    CCompiledFunc * Func = FindCompiledFunc(PROGRAM_COUNTER);
+    if (Func != NULL)
+    {
+        WriteTrace(TraceRecompiler, TraceInfo, "Using extisting compiled code (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
+        return Func;
+    }
+
+    HighResTimeStamp StartTime;
+    StartTime.SetToNow();
+
+    Func = CompileBlock(PROGRAM_COUNTER, pAddr);
+    if (Func != NULL)
     {
-        WriteTrace(TraceRecompiler, TraceInfo, "exisiting functions for address (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
-        for (CCompiledFunc * Func = iter->second; Func != NULL; Func = Func->Next())
+        HighResTimeStamp EndTime;
+        m_DemandCompiles += 1;
+        m_DemandCompileTime += EndTime.SetToNow().GetMicroSeconds() - StartTime.GetMicroSeconds();
+    }
+    return Func;
+}
+
+CCompiledFunc * CRecompiler::FindCompiledFunc(uint32_t VAddr)
+{
+    CCompiledFuncList::iterator iter = m_Functions.find(VAddr);
+    if (iter == m_Functions.end())
+    {
+        return NULL;
+    }
+
+    WriteTrace(TraceRecompiler, TraceInfo, "exisiting functions for address (Program Counter: %X)", VAddr);
+    for (CCompiledFunc * Func = iter->second; Func != NULL; Func = Func->Next())
+    {
+        uint32_t PAddr;
+        if (g_TransVaddr->TranslateVaddr(Func->MinPC(), PAddr))
         {
-            uint32_t PAddr;
-            if (g_TransVaddr->TranslateVaddr(Func->MinPC(), PAddr))
+            MD5Digest Hash;
+            MD5(g_MMU->Rdram() + PAddr, (Func->MaxPC() - Func->MinPC()) + 4).get_digest(Hash);
+            if (memcmp(Hash.digest, Func->Hash().digest, sizeof(Hash.digest)) == 0)
             {
-                MD5Digest Hash;
-                MD5(g_MMU->Rdram() + PAddr, (Func->MaxPC() - Func->MinPC()) + 4).get_digest(Hash);
-                if (memcmp(Hash.digest, Func->Hash().digest, sizeof(Hash.digest)) == 0)
-                {
-                    WriteTrace(TraceRecompiler, TraceInfo, "Using extisting compiled code (Program Counter: %X pAddr: %X)", PROGRAM_COUNTER, pAddr);
-                    return Func;
-                }
+                return Func;
             }
         }
     }
+    return NULL;
+}
 
+CCompiledFunc * CRecompiler::CompileBlock(uint32_t VAddr, uint32_t pAddr, CRecompilerCache::BLOCK_ANALYSIS * Analysis)
+{
     CheckRecompMem();
 
-    //uint32_t StartTime = timeGetTime();
-    WriteTrace(TraceRecompiler, TraceDebug, "Compile Block-Start: Program Counter: %X pAddr: %X", PROGRAM_COUNTER, pAddr);
+    WriteTrace(TraceRecompiler, TraceDebug, "Compile Block-Start: Program Counter: %X pAddr: %X", VAddr, pAddr);
+
+    BLOCK_PROFILE_DATA * Profile = NULL;
+    BLOCK_COUNTERS * Counters = NULL;
+    if (bRecordExecutionTimes())
+    {
+        Profile = &m_BlockCounters[pAddr];
+        Profile->EnterPC = VAddr;
+        Profile->CompileCount += 1;
+        Counters = &Profile->Counters;
+    }
 
-    CCodeBlock CodeBlock(PROGRAM_COUNTER, *g_RecompPos);
+    // with the cache on the block either reuses a stored section layout or
+    // hands back the one it worked out, to be stored with it
+    CRecompilerCache::BLOCK_ANALYSIS NewAnalysis;
+    if (Analysis == NULL && m_TranslationCache.Enabled())
+    {
+        Analysis = &NewAnalysis;
+    }
+
+    CCodeBlock CodeBlock(VAddr, *g_RecompPos, Counters, Analysis);
     if (!CodeBlock.Compile())
     {
         return NULL;
     }
 
+    if (Profile != NULL)
+    {
+        // the block is translated from one page, so it is contiguous in
+        // physical memory around its entry
+        Profile->PAddrStart = pAddr - (VAddr - CodeBlock.VAddrFirst());
+        Profile->PAddrEnd = pAddr + (CodeBlock.VAddrLast() - VAddr) + 4;
+        if (Profile->PAddrEnd - Profile->PAddrStart > m_BlockProfileSpan)
+        {
+            m_BlockProfileSpan = Profile->PAddrEnd - Profile->PAddrStart;
+        }
+    }
+
     if (bShowRecompMemSize())
     {
         ShowMemUsed();
@@ -1000,6 +1100,10 @@ CCompiledFunc * CRecompiler::CompileCode()
         Func->SetNext(ret.first->second->Next());
         ret.first->second->SetNext(Func);
     }
+    if (Analysis != NULL)
+    {
+        RememberBlock(Func, pAddr, *Analysis);
+    }
 
     if (g_ModuleLogLevel[TraceRecompiler] >= TraceDebug)
     {
@@ -1029,10 +1133,168 @@ CCompiledFunc * CRecompiler::CompileCode()
     return Func;
 }
 
+void CRecompiler::RememberBlock(const CCompiledFunc * Func, uint32_t PAddr, const CRecompilerCache::BLOCK_ANALYSIS & Analysis)
+{
+    CRecompilerCache::BLOCK_ENTRY Entry;
+    memset(&Entry, 0, sizeof(Entry));
+    Entry.VAddrEnter = Func->EnterPC();
+    Entry.PAddrEnter = PAddr;
+    Entry.Length = (Func->MaxPC() - Func->MinPC()) + 4;
+    Entry.Hash = Func->Hash();
+    if (!g_TransVaddr->TranslateVaddr(Func->MinPC(), Entry.PAddrFirst))
+    {
+        return;
+    }
+
+    // the layout is only as good as the hash, so it must not depend on code outside it
+    for (CRecompilerCache::SECTION_LIST::const_iterator itr = Analysis.Sections.begin(); itr != Analysis.Sections.end(); itr++)
+    {
+        if (itr->EnterPC < Func->MinPC() || itr->EndPC > Func->MaxPC())
+        {
+            m_TranslationCache.AddBlock(Entry, CRecompilerCache::BLOCK_ANALYSIS());
+            return;
+        }
+    }
+    m_TranslationCache.AddBlock(Entry, Analysis);
+}
+
+// Only called from the dispatch loops, so no compiled code is running when
+// blocks get translated or the recompiler memory is touched
+void CRecompiler::WarmCode()
+{
+    uint32_t MicroSeconds = m_WarmMicroSeconds;
+    m_WarmMicroSeconds = 0;
+    if (!m_TranslationCache.HavePending())
+    {
+        return;
+    }
+
+    HighResTimeStamp StartTime, CurrentTime;
+    uint64_t Start = StartTime.SetToNow().GetMicroSeconds(), Now = Start;
+    uint32_t RdramSize = g_System->RdramSize();
+
+    // each pending block is looked at at most once per call, blocks whose code
+    // is not loaded yet stay pending for a later frame
+    for (uint32_t Checked = 0, Count = m_TranslationCache.PendingCount(); Checked < Count && Now - Start < MicroSeconds; Checked++)
+    {
+        if (RecompMemHalfUsed())
+        {
+            // the game has moved on to other code, leave the space to it rather than risk a reset
+            break;
+        }
+
+        const CRecompilerCache::BLOCK_ENTRY * Entry = m_TranslationCache.NextPending();
+        uint32_t PAddrEnter, PAddrFirst;
+        if (!g_TransVaddr->TranslateVaddr(Entry->VAddrEnter, PAddrEnter) || PAddrEnter != Entry->PAddrEnter ||
+            PAddrEnter >= RdramSize || Entry->PAddrFirst >= RdramSize || Entry->Length > RdramSize - Entry->PAddrFirst)
+        {
+            continue;
+        }
+
+        MD5Digest Hash;
+        MD5(g_MMU->Rdram() + Entry->PAddrFirst, Entry->Length).get_digest(Hash);
+        if (memcmp(Hash.digest, Entry->Hash.digest, sizeof(Hash.digest)) != 0)
+        {
+            continue;
+        }
+
+        uint32_t VAddrEnter = Entry->VAddrEnter;
+        CRecompilerCache::BLOCK_ANALYSIS Analysis;
+        m_TranslationCache.GetAnalysis(*Entry, Analysis);
+        m_TranslationCache.RemovePending();
+        if (FindCompiledFunc(VAddrEnter) == NULL)
+        {
+            if (m_BenchAnalysis && !Analysis.Sections.empty())
+            {
+                BenchAnalysis(VAddrEnter, Analysis);
+                Now = CurrentTime.SetToNow().GetMicroSeconds();
+            }
+
+            // the block may cover more code than when it was remembered, so the
+            // reuse check in CompileCode still decides whether it is used
+            uint64_t BlockStart = Now;
+            bool Restored = !Analysis.Sections.empty();
+            if (CompileBlock(VAddrEnter, PAddrEnter, &Analysis) == NULL)
+            {
+                break;
+            }
+            Now = CurrentTime.SetToNow().GetMicroSeconds();
+            m_WarmCompiles += 1;
+            m_WarmCompileTime += Now - BlockStart;
+            if (Restored)
+            {
+                m_WarmRestored += 1;
+            }
+            continue;
+        }
+        Now = CurrentTime.SetToNow().GetMicroSeconds();
+    }
+}
+
+// Builds the block's sections both ways without compiling it: analysed from
+// the MIPS code as on a cold start, and from the stored layout as when warming.
+// Each is repeated so the times are well above the timer resolution.
+void CRecompiler::BenchAnalysis(uint32_t VAddr, const CRecompilerCache::BLOCK_ANALYSIS & Analysis)
+{
+    HighResTimeStamp StartTime, EndTime;
+    CRecompilerCache::BLOCK_ANALYSIS Cold;
+    StartTime.SetToNow();
+    for (int i = 0; i < BenchRepeats; i++)
+    {
+        Cold.Sections.clear();
+        Cold.Parents.clear();
+        CCodeBlock CodeBlock(VAddr, *g_RecompPos, NULL, &Cold);
+    }
+    EndTime.SetToNow();
+    m_BenchColdTime += EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+
+    StartTime.SetToNow();
+    for (int i = 0; i < BenchRepeats; i++)
+    {
+        CRecompilerCache::BLOCK_ANALYSIS Warm(Analysis);
+        CCodeBlock CodeBlock(VAddr, *g_RecompPos, NULL, &Warm);
+    }
+    EndTime.SetToNow();
+    m_BenchWarmTime += EndTime.GetMicroSeconds() - StartTime.GetMicroSeconds();
+
+    // a stored layout that no longer matches the analysis would compile different code
+    m_BenchBlocks += 1;
+    if (Cold.Sections.size() != Analysis.Sections.size() || Cold.Parents != Analysis.Parents ||
+        (!Cold.Sections.empty() && memcmp(&Cold.Sections[0], &Analysis.Sections[0], Cold.Sections.size() * sizeof(Cold.Sections[0])) != 0))
+    {
+        m_BenchDiffer += 1;
+    }
+}
+
+void CRecompiler::LogTranslationCache()
+{
+    CPath LogFileName(g_Settings->LoadStringVal(Directory_Log).c_str(), "RecompilerCache.log");
+
+    CLog Log;
+    if (!Log.Open(LogFileName, CLog::Log_Append))
+    {
+        return;
+    }
+    Log.LogF("%s: %u blocks loaded, %u warmed in %llu us (%u from stored sections), %u compiled on demand in %llu us, %u never seen\r\n",
+        g_Settings->LoadStringVal(Game_IniKey).c_str(), m_TranslationCache.LoadedCount(),
+        m_WarmCompiles, (unsigned long long)m_WarmCompileTime, m_WarmRestored,
+        m_DemandCompiles, (unsigned long long)m_DemandCompileTime, m_TranslationCache.PendingCount());
+    if (m_BenchAnalysis)
+    {
+        Log.LogF("%s: section analysis of %u blocks x%d: cold %llu us, warm %llu us, %u stored layouts differed\r\n",
+            g_Settings->LoadStringVal(Game_IniKey).c_str(), m_BenchBlocks, BenchRepeats,
+            (unsigned long long)m_BenchColdTime, (unsigned long long)m_BenchWarmTime, m_BenchDiffer);
+    }
+}
+
 void CRecompiler::ClearRecompCode_Phys(uint32_t Address, int length, REMOVE_REASON Reason)
 {
+    RecordBlockClear(Address, length, Reason);
+
     if (g_System->LookUpMode() == FuncFind_VirtualLookup)
     {
+        // the virtual aliases all map back to this range, count it once
+        m_ClearingPhys = true;
         ClearRecompCode_Virt(Address + 0x80000000, length, Reason);
         ClearRecompCode_Virt(Address + 0xA0000000, length, Reason);
 
@@ -1045,6 +1307,7 @@ void CRecompiler::ClearRecompCode_Phys(uint32_t Address, int length, REMOVE_REAS
                 ClearRecompCode_Virt(VAddr, length, Reason);
             }
         }
+        m_ClearingPhys = false;
     }
     else if (g_System->LookUpMode() == FuncFind_PhysicalLookup)
     {
@@ -1078,6 +1341,14 @@ void CRecompiler::ClearRecompCode_Virt(uint32_t Address, int length, REMOVE_REAS
     switch (g_System->LookUpMode())
     {
     case FuncFind_VirtualLookup:
+        if (!m_ClearingPhys)
+        {
+            uint32_t pAddr = 0;
+            if (g_TransVaddr->TranslateVaddr(Address, pAddr))
+            {
+                RecordBlockClear(pAddr, length, Reason);
+            }
+        }
         AddressIndex = Address >> 0xC;
         WriteStart = (Address & 0xFFC);
         length = ((length + 3) & ~0x3);
@@ -1152,9 +1423,87 @@ void CRecompiler::DumpFunctionTimes()
     {
         Log.LogF("%X,0x%X,%d\r\n", (uint32_t)itr->first, itr->second.Address, (uint32_t)itr->second.TimeTaken);
     }
+
+    DumpBlockProfile();
 }
 
 void CRecompiler::ResetFunctionTimes()
 {
     m_BlockProfile.clear();
-}
\ No newline at end of file
+
+    // compiled blocks still point at their counters, so only zero them
+    for (BLOCK_PROFILE::iterator itr = m_BlockCounters.begin(); itr != m_BlockCounters.end(); itr++)
+    {
+        BLOCK_PROFILE_DATA & Profile = itr->second;
+        Profile.CompileCount = 0;
+        memset(Profile.ClearCount, 0, sizeof(Profile.ClearCount));
+        Profile.Counters.EntryCount = 0;
+        Profile.Counters.Cycles = 0;
+    }
+}
+
+void CRecompiler::RecordBlockClear(uint32_t PhysicalAddress, int32_t length, REMOVE_REASON Reason)
+{
+    if (m_BlockCounters.empty() || length <= 0 || Reason >= Remove_MaxReason)
+    {
+        return;
+    }
+
+    // count every block overlapping the cleared range, including those that
+    // start before it; only entries within a block's length of it can
+    uint32_t ClearEnd = PhysicalAddress + length;
+    uint32_t First = PhysicalAddress > m_BlockProfileSpan ? PhysicalAddress - m_BlockProfileSpan : 0;
+    BLOCK_PROFILE::iterator itr = m_BlockCounters.lower_bound(First);
+    BLOCK_PROFILE::iterator end = m_BlockCounters.lower_bound(ClearEnd + m_BlockProfileSpan);
+    for (; itr != end; itr++)
+    {
+        BLOCK_PROFILE_DATA & Profile = itr->second;
+        if (Profile.PAddrStart < ClearEnd && Profile.PAddrEnd > PhysicalAddress)
+        {
+            Profile.ClearCount[Reason] += 1;
+        }
+    }
+}
+
+bool CRecompiler::BlockHotter(BLOCK_PROFILE::const_iterator a, BLOCK_PROFILE::const_iterator b)
+{
+    return a->second.Counters.Cycles > b->second.Counters.Cycles;
+}
+
+void CRecompiler::DumpBlockProfile()
+{
+    typedef std::vector<BLOCK_PROFILE::const_iterator> BLOCK_LIST;
+
+    BLOCK_LIST Blocks;
+    Blocks.reserve(m_BlockCounters.size());
+    for (BLOCK_PROFILE::const_iterator itr = m_BlockCounters.begin(); itr != m_BlockCounters.end(); itr++)
+    {
+        Blocks.push_back(itr);
+    }
+    std::sort(Blocks.begin(), Blocks.end(), BlockHotter);
+
+    CPath LogFileName(g_Settings->LoadStringVal(Directory_Log).c_str(), "BlockProfile.csv");
+
+    CLog Log;
+    Log.Open(LogFileName);
+    Log.LogF("PC,PAddr,Entries,Cycles,Compiles,Clears,InitialCode,Cache,ProtectedMem,ValidateFunc,TLB,DMA,StoreInstruc\r\n");
+
+    for (BLOCK_LIST::const_iterator itr = Blocks.begin(); itr != Blocks.end(); itr++)
+    {
+        const BLOCK_PROFILE_DATA & Profile = (*itr)->second;
+
+        uint32_t Clears = 0;
+        for (int32_t i = 0; i < Remove_MaxReason; i++)
+        {
+            Clears += Profile.ClearCount[i];
+        }
+
+        Log.LogF("0x%08X,0x%08X,%llu,%llu,%u,%u", Profile.EnterPC, (*itr)->first, (unsigned long long)Profile.Counters.EntryCount,
+            (unsigned long long)Profile.Counters.Cycles, Profile.CompileCount, Clears);
+        for (int32_t i = 0; i < Remove_MaxReason; i++)
+        {
+            Log.LogF(",%u", Profile.ClearCount[i]);
+        }
+        Log.LogF("\r\n");
+    }
+}
@@ -13,6 +13,7 @@
 #include <Project64-core/N64System/Mips/RegisterClass.h>
 #include <Project64-core/N64System/Recompiler/FunctionMapClass.h>
 #include <Project64-core/N64System/Recompiler/RecompilerMemory.h>
+#include <Project64-core/N64System/Recompiler/RecompilerCache.h>
 #include <Project64-core/N64System/ProfilingClass.h>
 #include <Project64-core/Settings/RecompilerSettings.h>
 #include <Project64-core/Settings/DebugSettings.h>
@@ -35,6 +36,7 @@ public:
         Remove_TLB,
         Remove_DMA,
         Remove_StoreInstruc,
+        Remove_MaxReason,
     };
 
     typedef void(*DelayFunc)();
@@ -57,12 +59,24 @@ public:
 
     uint32_t& MemoryStackPos() { return m_MemoryStack; }
 
+    // Lets the next trip through the dispatch loop translate blocks remembered
+    // from earlier sessions for up to MicroSeconds
+    void ScheduleWarmCode(uint32_t MicroSeconds) { m_WarmMicroSeconds = MicroSeconds; }
+
 private:
     CRecompiler();                              // Disable default constructor
     CRecompiler(const CRecompiler&);            // Disable copy constructor
     CRecompiler& operator=(const CRecompiler&); // Disable assignment
 
     CCompiledFunc * CompileCode();
+    CCompiledFunc * CompileBlock(uint32_t VAddr, uint32_t PAddr, CRecompilerCache::BLOCK_ANALYSIS * Analysis = NULL);
+    CCompiledFunc * FindCompiledFunc(uint32_t VAddr);
+    void RememberBlock(const CCompiledFunc * Func, uint32_t PAddr, const CRecompilerCache::BLOCK_ANALYSIS & Analysis);
+    void WarmCode();
+    void BenchAnalysis(uint32_t VAddr, const CRecompilerCache::BLOCK_ANALYSIS & Analysis);
+
+    enum { BenchRepeats = 16 };
+    void LogTranslationCache();
 
     typedef struct
     {
@@ -72,6 +86,27 @@ private:
 
     typedef std::map <CCompiledFunc::Func, FUNCTION_PROFILE_DATA> FUNCTION_PROFILE;
 
+    typedef struct
+    {
+        uint32_t EnterPC;
+        uint32_t PAddrStart;    // physical range of the last compile, end exclusive
+        uint32_t PAddrEnd;
+        uint32_t CompileCount;
+        uint32_t ClearCount[Remove_MaxReason];
+        BLOCK_COUNTERS Counters;
+    } BLOCK_PROFILE_DATA;
+
+    // Keyed on the physical address of the block entry so that the counts
+    // survive the block being cleared and compiled again. Entries are never
+    // erased while code is compiled as the blocks point at their counters.
+    // A block can start before its entry, so lookups by range widen the
+    // search by m_BlockProfileSpan, the longest block recorded.
+    typedef std::map <uint32_t, BLOCK_PROFILE_DATA> BLOCK_PROFILE;
+
+    void RecordBlockClear(uint32_t PhysicalAddress, int32_t length, REMOVE_REASON Reason);
+    void DumpBlockProfile();
+    static bool BlockHotter(BLOCK_PROFILE::const_iterator a, BLOCK_PROFILE::const_iterator b);
+
     // Main loops for the different look up methods
     void RecompilerMain_VirtualTable();
     void RecompilerMain_VirtualTable_validate();
@@ -86,6 +121,22 @@ private:
     bool             & m_EndEmulation;
     uint32_t           m_MemoryStack;
     FUNCTION_PROFILE m_BlockProfile;
+    BLOCK_PROFILE    m_BlockCounters;
+    uint32_t         m_BlockProfileSpan;
+    bool             m_ClearingPhys;
+
+    CRecompilerCache m_TranslationCache;
+    uint32_t         m_DemandCompiles;
+    uint64_t         m_DemandCompileTime;
+    uint32_t         m_WarmMicroSeconds;
+    uint32_t         m_WarmCompiles;
+    uint64_t         m_WarmCompileTime;
+    uint32_t         m_WarmRestored;     // warmed blocks rebuilt from a stored section layout
+    bool             m_BenchAnalysis;
+    uint32_t         m_BenchBlocks;
+    uint32_t         m_BenchDiffer;
+    uint64_t         m_BenchColdTime;
+    uint64_t         m_BenchWarmTime;
 
     //Quick access to registers
     uint32_t            & PROGRAM_COUNTER;
@@ -79,6 +79,11 @@ void CRecompMemory::CheckRecompMem()
     m_RecompSize += IncreaseCompileBufferSize;
 }
 
+bool CRecompMemory::RecompMemHalfUsed() const
+{
+    return (uint32_t)(m_RecompPos - m_RecompCode) >= MaxCompileBufferSize / 2;
+}
+
 void CRecompMemory::Reset()
 {
     m_RecompPos = m_RecompCode;
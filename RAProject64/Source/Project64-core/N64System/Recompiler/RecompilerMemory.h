@@ -21,6 +21,7 @@ protected:
     void CheckRecompMem();
     void Reset();
     void ShowMemUsed();
+    bool RecompMemHalfUsed() const;
 
 public:
     uint8_t** RecompPos() { return &m_RecompPos; }
@@ -8805,6 +8805,18 @@ void CX86RecompilerOps::EnterCodeBlock()
     Push(x86_ESI);
     Push(x86_EBX);
 #endif
+    BLOCK_COUNTERS * Counters = m_Section->m_BlockInfo->Counters();
+    if (Counters != NULL)
+    {
+        AddToBlockCounter(&Counters->EntryCount, "EntryCount", 1);
+    }
+}
+
+void CX86RecompilerOps::AddToBlockCounter(uint64_t * Counter, const char * CounterName, uint32_t Value)
+{
+    WriteX86Comment("Block profile");
+    AddConstToVariable(Value, Counter, CounterName);
+    AdcConstToVariable(((uint32_t *)Counter) + 1, stdstr_f("%s + 4", CounterName).c_str(), 0);
 }
 
 void CX86RecompilerOps::ExitCodeBlock()
@@ -9644,6 +9656,12 @@ void CX86RecompilerOps::UpdateCounters(CRegInfo & RegSet, bool CheckTimer, bool
 {
     if (RegSet.GetBlockCycleCount() != 0)
     {
+        // before the timer update, which leaves the flags for the timer test
+        BLOCK_COUNTERS * Counters = m_Section->m_BlockInfo->Counters();
+        if (Counters != NULL)
+        {
+            AddToBlockCounter(&Counters->Cycles, "Cycles", RegSet.GetBlockCycleCount());
+        }
         UpdateSyncCPU(RegSet, RegSet.GetBlockCycleCount());
         WriteX86Comment("Update Counter");
         SubConstFromVariable(RegSet.GetBlockCycleCount(), g_NextTimer, "g_NextTimer"); // updates compare flag
@@ -361,6 +361,7 @@ private:
     void CompileExit(uint32_t JumpPC, uint32_t TargetPC, CRegInfo &ExitRegSet, CExitInfo::EXIT_REASON reason, bool CompileNow, void(*x86Jmp)(const char * Label, uint32_t Value));
     void Compile_StoreInstructClean(x86Reg AddressReg, int32_t Length);
     void ResetMemoryStack();
+    void AddToBlockCounter(uint64_t * Counter, const char * CounterName, uint32_t Value);
 
     EXIT_LIST m_ExitInfo;
     static STEP_TYPE      m_NextInstruction;
@@ -83,6 +83,20 @@ bool CSpeedLimiter::Timer_Process(uint32_t * FrameRate)
     return false;
 }
 
+/* Time left before the next call to Timer_Process would stop sleeping */
+uint32_t CSpeedLimiter::IdleMicroSeconds()
+{
+    uint64_t LastTime = m_LastTime.GetMicroSeconds();
+    if (LastTime == 0)
+    {
+        return 0;
+    }
+    HighResTimeStamp CurrentTime;
+    uint64_t CurrentTimeValue = CurrentTime.SetToNow().GetMicroSeconds();
+    uint64_t CalculatedTime = LastTime + (m_MicroSecondsPerFrame * (m_Frames + 1));
+    return CurrentTimeValue < CalculatedTime ? (uint32_t)(CalculatedTime - CurrentTimeValue) : 0;
+}
+
 void CSpeedLimiter::AlterSpeed( const ESpeedChange SpeedChange )
 {
 	int32_t SpeedFactor = 1;
@@ -25,6 +25,7 @@ public:
 
     void SetHertz(const uint32_t Hertz);
     bool Timer_Process(uint32_t* const FrameRate);
+    uint32_t IdleMicroSeconds();
 
 	void AlterSpeed(const ESpeedChange SpeedChange);
 
@@ -25,6 +25,7 @@ enum SettingID
     Cmd_BaseDirectory,
     Cmd_RomFile,
     Cmd_ShowHelp,
+    Cmd_RecompilerCacheBench,
 
     //Support Files
     SupportFile_Settings,
@@ -58,6 +59,8 @@ enum SettingID
     Setting_EnableDisk,
     Setting_PreAllocSyncMem,
     Setting_ReducedSyncMem,
+    Setting_RecompilerCache,
+    Setting_RecompilerCacheDir,
 
     //RDB Settings
     Rdb_GoodName,
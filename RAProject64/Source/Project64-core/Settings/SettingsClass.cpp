@@ -87,6 +87,7 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     //Command Settings
     AddHandler(Cmd_BaseDirectory, new CSettingTypeTempString(BaseDirectory));
     AddHandler(Cmd_ShowHelp, new CSettingTypeTempBool(false));
+    AddHandler(Cmd_RecompilerCacheBench, new CSettingTypeTempBool(false));
     AddHandler(Cmd_RomFile, new CSettingTypeTempString(""));
 
     //Support Files
@@ -123,6 +124,8 @@ void CSettings::AddHowToHandleSetting(const char * BaseDirectory)
     AddHandler(Setting_EnableDisk, new CSettingTypeTempBool(false));
     AddHandler(Setting_PreAllocSyncMem, new CSettingTypeApplication("", "PreAllocSyncMem", true));
     AddHandler(Setting_ReducedSyncMem, new CSettingTypeApplication("", "ReducedSyncMem", false));
+    AddHandler(Setting_RecompilerCache, new CSettingTypeApplication("", "Recompiler Cache", false));
+    AddHandler(Setting_RecompilerCacheDir, new CSettingTypeRelativePath("Cache", ""));
     AddHandler(Setting_LanguageDirDefault, new CSettingTypeRelativePath("Lang", ""));
     AddHandler(Setting_LanguageDir, new CSettingTypeApplicationPath("Lang Directory", "Directory", Setting_LanguageDirDefault));
 
@@ -61,6 +61,7 @@ $CC -o $obj/N64System/dynarec/CSect.asm $src/N64System/Recompiler/CodeSection.cp
 $CC -o $obj/N64System/dynarec/FnNfo.asm $src/N64System/Recompiler/FunctionInfo.cpp $C_FLAGS
 $CC -o $obj/N64System/dynarec/FnMap.asm $src/N64System/Recompiler/FunctionMapClass.cpp $C_FLAGS
 $CC -o $obj/N64System/dynarec/Loop.asm  $src/N64System/Recompiler/LoopAnalysis.cpp $C_FLAGS
+$CC -o $obj/N64System/dynarec/Cache.asm $src/N64System/Recompiler/RecompilerCache.cpp $C_FLAGS
 $CC -o $obj/N64System/dynarec/Class.asm $src/N64System/Recompiler/RecompilerClass.cpp $C_FLAGS
 $CC -o $obj/N64System/dynarec/Mem.asm   $src/N64System/Recompiler/RecompilerMemory.cpp $C_FLAGS
 $CC -o $obj/N64System/dynarec/Ops.asm   $src/N64System/Recompiler/x86/x86RecompilerOps.cpp $C_FLAGS
@@ -142,6 +143,7 @@ $AS -o $obj/N64System/dynarec/CSect.o   $obj/N64System/dynarec/CSect.asm
 $AS -o $obj/N64System/dynarec/FnNfo.o   $obj/N64System/dynarec/FnNfo.asm
 $AS -o $obj/N64System/dynarec/FnMap.o   $obj/N64System/dynarec/FnMap.asm
 $AS -o $obj/N64System/dynarec/Loop.o    $obj/N64System/dynarec/Loop.asm
+$AS -o $obj/N64System/dynarec/Cache.o   $obj/N64System/dynarec/Cache.asm
 $AS -o $obj/N64System/dynarec/Class.o   $obj/N64System/dynarec/Class.asm
 $AS -o $obj/N64System/dynarec/Mem.o     $obj/N64System/dynarec/Mem.asm
 $AS -o $obj/N64System/dynarec/Ops.o     $obj/N64System/dynarec/Ops.asm
@@ -222,6 +224,7 @@ $obj/N64System/dynarec/CSect.o \
 $obj/N64System/dynarec/FnNfo.o \
 $obj/N64System/dynarec/FnMap.o \
 $obj/N64System/dynarec/Loop.o \
+$obj/N64System/dynarec/Cache.o \
 $obj/N64System/dynarec/Class.o \
 $obj/N64System/dynarec/Mem.o \
 $obj/N64System/dynarec/Ops.o \
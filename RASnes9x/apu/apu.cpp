@@ -180,6 +180,7 @@
 #include "apu.h"
 #include "snapshot.h"
 #include "display.h"
+#include "profile.h"
 #include "hermite_resampler.h"
 
 #include "snes/snes.hpp"
@@ -206,6 +207,7 @@ namespace spc
 
 	static bool8		sound_in_sync   = TRUE;
 	static bool8		sound_enabled   = FALSE;
+	static bool8		discard         = FALSE;
 
 	static int			buffer_size;
 	static int			lag_master      = 0;
@@ -272,6 +274,8 @@ static void ReverseStereo (uint8 *src_buffer, int sample_count)
 
 bool8 S9xMixSamples (uint8 *buffer, int sample_count)
 {
+	PROFILE_SECTION(PROFILE_APU);
+
 	static int	shrink_buffer_size = -1;
 	uint8		*dest;
 
@@ -347,7 +351,7 @@ int S9xGetSampleCount (void)
 /* TODO: Attach */
 void S9xFinalizeSamples (void)
 {
-	if (!Settings.Mute)
+	if (!Settings.Mute && !spc::discard)
 	{
 		if (!spc::resampler->push((short *) spc::landing_buffer, SNES::dsp.spc_dsp.sample_count ()))
 		{
@@ -359,7 +363,7 @@ void S9xFinalizeSamples (void)
 		}
 	}
 
-	if (!Settings.SoundSync || Settings.TurboMode || Settings.Mute)
+	if (!Settings.SoundSync || Settings.TurboMode || Settings.Mute || spc::discard)
 		spc::sound_in_sync = TRUE;
 	else
 	if (spc::resampler->space_empty() >= spc::resampler->space_filled())
@@ -474,6 +478,14 @@ void S9xSetSoundMute (bool8 mute)
 		Settings.Mute = TRUE;
 }
 
+// While set, generated samples are dropped and APU resets leave the samples
+// already queued for output alone. Unlike muting, nothing that is playing is
+// cut, so this can be toggled around frames that must not be heard.
+void S9xSetSoundDiscard (bool8 discard)
+{
+	spc::discard = discard;
+}
+
 void S9xDumpSPCSnapshot (void)
 {
 	SNES::dsp.spc_dsp.dump_spc_snapshot();
@@ -547,6 +559,8 @@ void S9xAPUSetReferenceTime (int32 cpucycles)
 
 void S9xAPUExecute (void)
 {
+	PROFILE_SECTION(PROFILE_APU);
+
 	SNES::smp.clock -= S9xAPUGetClock (CPU.Cycles);
 	SNES::smp.enter ();
 
@@ -557,6 +571,8 @@ void S9xAPUExecute (void)
 
 void S9xAPUEndScanline (void)
 {
+	PROFILE_SECTION(PROFILE_APU);
+
 	S9xAPUExecute();
 	SNES::dsp.synchronize();
 
@@ -590,7 +606,8 @@ void S9xResetAPU (void)
 	SNES::dsp.spc_dsp.set_output ((SNES::SPC_DSP::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
 	SNES::dsp.spc_dsp.set_spc_snapshot_callback(SPCSnapshotCallback);
 
-	spc::resampler->clear();
+	if (!spc::discard)
+		spc::resampler->clear();
 }
 
 void S9xSoftResetAPU (void)
@@ -180,6 +180,7 @@
 #include "snes9x.h"
 #include "memmap.h"
 #include "sar.h"
+#include "profile.h"
 
 static int16	C4SinTable[512] =
 {
@@ -937,6 +938,8 @@ void S9xInitC4 (void)
 
 uint8 S9xGetC4 (uint16 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	if (Address == 0x7f5e)
 		return (0);
 
@@ -945,6 +948,8 @@ uint8 S9xGetC4 (uint16 Address)
 
 void S9xSetC4 (uint8 byte, uint16 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	Memory.C4RAM[Address - 0x6000] = byte;
 
 	if (Address == 0x7f4f)
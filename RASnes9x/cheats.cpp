@@ -176,12 +176,16 @@
  ***********************************************************************************/
 
 
-#include <Windows.h>
 #include <ctype.h>
 #include "snes9x.h"
 #include "memmap.h"
 #include "cheats.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHEAT_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
 #define WRAM_BITS	ALL_BITS
 #define SRAM_BITS	ALL_BITS + (0x20000 >> 5)
 #define IRAM_BITS	ALL_BITS + (0x30000 >> 5)
@@ -190,26 +194,6 @@
 
 #define TEST_BIT(a, v)	((a)[(v) >> 5] & (1 << ((v) & 31)))
 
-#define _S9XCHTC(c, a, b) \
-	((c) == S9X_LESS_THAN             ? (a) <  (b) : \
-	 (c) == S9X_GREATER_THAN          ? (a) >  (b) : \
-	 (c) == S9X_LESS_THAN_OR_EQUAL    ? (a) <= (b) : \
-	 (c) == S9X_GREATER_THAN_OR_EQUAL ? (a) >= (b) : \
-	 (c) == S9X_EQUAL                 ? (a) == (b) : \
-	                                    (a) != (b))
-
-#define _S9XCHTD(s, m, o) \
-	((s) == S9X_8_BITS  ? ((uint8)   (*((m) + (o)))) : \
-	 (s) == S9X_16_BITS ? ((uint16)  (*((m) + (o)) + (*((m) + (o) + 1) << 8))) : \
-	 (s) == S9X_24_BITS ? ((uint32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16))) : \
-	                      ((uint32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16) + (*((m) + (o) + 3) << 24))))
-
-#define _S9XCHTDS(s, m, o) \
-	((s) == S9X_8_BITS  ?  ((int8)   (*((m) + (o)))) : \
-	 (s) == S9X_16_BITS ?  ((int16)  (*((m) + (o)) + (*((m) + (o) + 1) << 8))) : \
-	 (s) == S9X_24_BITS ? (((int32) ((*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16)) << 8)) >> 8): \
-                           ((int32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16) + (*((m) + (o) + 3) << 24))))
-
 static bool8 S9xAllHex (const char *, int);
 
 
@@ -313,247 +297,425 @@ const char * S9xGameGenieToRaw (const char *code, uint32 &address, uint8 &byte)
 	return (NULL);
 }
 
-void S9xStartCheatSearch (SCheatData *d)
+// The searches work on the candidate bitmap a word, or 32 addresses, at a
+// time. Words whose addresses are all ruled out are skipped, and with SSE2
+// the 32 comparisons are done as vectors against the last snapshot. Once few
+// enough candidates are left they are kept in a list as well, and later
+// searches only look at those.
+
+#define SEARCH_CHANGE	0
+#define SEARCH_VALUE	1
+#define SEARCH_ADDRESS	2
+
+struct SearchRegion
 {
-	memmove(d->CWRAM, d->RAM, 0x20000);
-	memmove(d->CSRAM, d->SRAM, 0x10000);
-	memmove(d->CIRAM, &d->FillRAM[0x3000], 0x2000);
-	memset((char *) d->ALL_BITS, 0xff, 0x32000 >> 3);
+	uint8	*mem;
+	uint8	*saved;
+	uint32	*bits;
+	int		base;
+	int		size;
+	bool8	clear_tail;
+};
+
+struct SearchOp
+{
+	int						mode;
+	S9xCheatComparisonType	cmp;
+	int						bytes;
+	bool8					is_signed;
+	int64					value;
+	int						constant;	// value out of range: -1 below every element, 1 above, 0 in range
+	bool8					update;
+};
+
+static void SetupRegions (SCheatData *d, SearchRegion r[3])
+{
+	r[0].mem = d->RAM;               r[0].saved = d->CWRAM; r[0].bits = d->WRAM_BITS; r[0].base = 0;       r[0].size = 0x20000; r[0].clear_tail = TRUE;
+	r[1].mem = d->SRAM;              r[1].saved = d->CSRAM; r[1].bits = d->SRAM_BITS; r[1].base = 0x20000; r[1].size = 0x10000; r[1].clear_tail = TRUE;
+	r[2].mem = d->FillRAM + 0x3000;  r[2].saved = d->CIRAM; r[2].bits = d->IRAM_BITS; r[2].base = 0x30000; r[2].size = 0x2000;  r[2].clear_tail = FALSE;
 }
 
-void S9xSearchForChange (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, bool8 is_signed, bool8 update)
+static void SetupOp (SearchOp &op, int mode, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 is_signed, bool8 update)
 {
-	int	l, i;
-
 	switch (size)
 	{
-		case S9X_8_BITS:	l = 0; break;
-		case S9X_16_BITS:	l = 1; break;
-		case S9X_24_BITS:	l = 2; break;
+		case S9X_8_BITS:	op.bytes = 1; break;
+		case S9X_16_BITS:	op.bytes = 2; break;
+		case S9X_24_BITS:	op.bytes = 3; break;
 		default:
-		case S9X_32_BITS:	l = 3; break;
+		case S9X_32_BITS:	op.bytes = 4; break;
 	}
 
-	if (is_signed)
-	{
-		for (i = 0; i < 0x20000 - l; i++)
-		{
-			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->RAM, i), _S9XCHTDS(size, d->CWRAM, i)))
-			{
-				if (update)
-					d->CWRAM[i] = d->RAM[i];
-			}
-			else
-				BIT_CLEAR(d->WRAM_BITS, i);
-		}
+	op.mode = mode;
+	op.cmp = cmp;
+	op.is_signed = is_signed;
+	op.value = is_signed ? (int64) (int32) value : (int64) value;
+	op.constant = 0;
+	op.update = update;
 
-		for (i = 0; i < 0x10000 - l; i++)
-		{
-			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->SRAM, i), _S9XCHTDS(size, d->CSRAM, i)))
-			{
-				if (update)
-					d->CSRAM[i] = d->SRAM[i];
-			}
-			else
-				BIT_CLEAR(d->SRAM_BITS, i);
-		}
+	if (mode == SEARCH_VALUE)
+	{
+		int		bits = op.bytes * 8;
+		int64	lo = is_signed ? -((int64) 1 << (bits - 1)) : 0;
+		int64	hi = is_signed ? ((int64) 1 << (bits - 1)) - 1 : ((int64) 1 << bits) - 1;
 
-		for (i = 0; i < 0x2000 - l; i++)
-		{
-			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->FillRAM + 0x3000, i), _S9XCHTDS(size, d->CIRAM, i)))
-			{
-				if (update)
-					d->CIRAM[i] = d->FillRAM[i + 0x3000];
-			}
-			else
-				BIT_CLEAR(d->IRAM_BITS, i);
-		}
+		if (op.value < lo)
+			op.constant = -1;
+		else
+		if (op.value > hi)
+			op.constant = 1;
 	}
-	else
+}
+
+static inline int64 ReadValue (const uint8 *m, int bytes, bool8 is_signed)
+{
+	uint32	v = m[0];
+
+	if (bytes > 1)
+		v |= m[1] << 8;
+	if (bytes > 2)
+		v |= m[2] << 16;
+	if (bytes > 3)
+		v |= (uint32) m[3] << 24;
+
+	if (!is_signed)
+		return (v);
+
+	int	shift = 32 - bytes * 8;
+	return (((int32) (v << shift)) >> shift);
+}
+
+// Turns the greater-than and equal masks into the comparison's mask.
+static inline uint32 CombineMasks (S9xCheatComparisonType cmp, uint32 gt, uint32 eq)
+{
+	switch (cmp)
 	{
-		for (i = 0; i < 0x20000 - l; i++)
-		{
-			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->RAM, i), _S9XCHTD(size, d->CWRAM, i)))
-			{
-				if (update)
-					d->CWRAM[i] = d->RAM[i];
-			}
-			else
-				BIT_CLEAR(d->WRAM_BITS, i);
-		}
+		case S9X_LESS_THAN:				return (~(gt | eq));
+		case S9X_GREATER_THAN:			return (gt);
+		case S9X_LESS_THAN_OR_EQUAL:	return (~gt);
+		case S9X_GREATER_THAN_OR_EQUAL:	return (gt | eq);
+		case S9X_EQUAL:					return (eq);
+		default:
+		case S9X_NOT_EQUAL:				return (~eq);
+	}
+}
 
-		for (i = 0; i < 0x10000 - l; i++)
-		{
-			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->SRAM, i), _S9XCHTD(size, d->CSRAM, i)))
-			{
-				if (update)
-					d->CSRAM[i] = d->SRAM[i];
-			}
-			else
-				BIT_CLEAR(d->SRAM_BITS, i);
-		}
+static inline bool8 TestOne (const SearchRegion &r, const SearchOp &op, int i)
+{
+	int64	a, b;
 
-		for (i = 0; i < 0x2000 - l; i++)
-		{
-			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->FillRAM + 0x3000, i), _S9XCHTD(size, d->CIRAM, i)))
-			{
-				if (update)
-					d->CIRAM[i] = d->FillRAM[i + 0x3000];
-			}
-			else
-				BIT_CLEAR(d->IRAM_BITS, i);
-		}
+	if (op.mode == SEARCH_ADDRESS)
+	{
+		a = r.base + i;
+		b = op.value;
 	}
+	else
+	{
+		if (op.constant)
+			return ((CombineMasks(op.cmp, op.constant < 0 ? 1 : 0, 0) & 1) != 0);
 
-	for (i = 0x20000 - l; i < 0x20000; i++)
-		BIT_CLEAR(d->WRAM_BITS, i);
+		a = ReadValue(r.mem + i, op.bytes, op.is_signed);
+		b = (op.mode == SEARCH_CHANGE) ? ReadValue(r.saved + i, op.bytes, op.is_signed) : op.value;
+	}
 
-	for (i = 0x10000 - l; i < 0x10000; i++)
-		BIT_CLEAR(d->SRAM_BITS, i);
+	return ((CombineMasks(op.cmp, a > b, a == b) & 1) != 0);
 }
 
-void S9xSearchForValue (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 is_signed, bool8 update)
+template <int bytes>
+static uint32 CompareScalarBytes (const SearchRegion &r, const SearchOp &op, int i, int n)
 {
-	int l, i;
+	uint32	gt = 0, eq = 0;
 
-	switch (size)
+	for (int k = 0; k < n; k++)
 	{
-		case S9X_8_BITS:	l = 0; break;
-		case S9X_16_BITS:	l = 1; break;
-		case S9X_24_BITS:	l = 2; break;
-		default:
-		case S9X_32_BITS:	l = 3; break;
+		int64	a = ReadValue(r.mem + i + k, bytes, op.is_signed);
+		int64	b = (op.mode == SEARCH_CHANGE) ? ReadValue(r.saved + i + k, bytes, op.is_signed) : op.value;
+
+		gt |= (uint32) (a > b) << k;
+		eq |= (uint32) (a == b) << k;
 	}
 
-	if (is_signed)
+	return (CombineMasks(op.cmp, gt, eq));
+}
+
+static uint32 CompareScalar (const SearchRegion &r, const SearchOp &op, int i, int n)
+{
+	if (op.mode == SEARCH_VALUE && op.constant)
+		return (CombineMasks(op.cmp, op.constant < 0 ? 0xffffffff : 0, 0));
+
+	if (op.mode == SEARCH_ADDRESS)
 	{
-		for (i = 0; i < 0x20000 - l; i++)
-		{
-			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->RAM, i), (int32) value))
-			{
-				if (update)
-					d->CWRAM[i] = d->RAM[i];
-			}
-			else
-				BIT_CLEAR(d->WRAM_BITS, i);
-		}
+		uint32	gt = 0, eq = 0;
 
-		for (i = 0; i < 0x10000 - l; i++)
+		for (int k = 0; k < n; k++)
 		{
-			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->SRAM, i), (int32) value))
-			{
-				if (update)
-					d->CSRAM[i] = d->SRAM[i];
-			}
-			else
-				BIT_CLEAR(d->SRAM_BITS, i);
-		}
+			int64	a = r.base + i + k;
 
-		for (i = 0; i < 0x2000 - l; i++)
-		{
-			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->FillRAM + 0x3000, i), (int32) value))
-			{
-				if (update)
-					d->CIRAM[i] = d->FillRAM[i + 0x3000];
-			}
-			else
-				BIT_CLEAR(d->IRAM_BITS, i);
+			gt |= (uint32) (a > op.value) << k;
+			eq |= (uint32) (a == op.value) << k;
 		}
+
+		return (CombineMasks(op.cmp, gt, eq));
 	}
-	else
+
+	switch (op.bytes)
 	{
-		for (i = 0; i < 0x20000 - l; i++)
-		{
-			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->RAM, i), value))
-			{
-				if (update)
-					d->CWRAM[i] = d->RAM[i];
-			}
-			else
-				BIT_CLEAR(d->WRAM_BITS, i);
-		}
+		case 1:	return (CompareScalarBytes<1>(r, op, i, n));
+		case 2:	return (CompareScalarBytes<2>(r, op, i, n));
+		case 3:	return (CompareScalarBytes<3>(r, op, i, n));
+		default:
+		case 4:	return (CompareScalarBytes<4>(r, op, i, n));
+	}
+}
 
-		for (i = 0; i < 0x10000 - l; i++)
-		{
-			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->SRAM, i), value))
-			{
-				if (update)
-					d->CSRAM[i] = d->SRAM[i];
-			}
-			else
-				BIT_CLEAR(d->SRAM_BITS, i);
-		}
+#ifdef CHEAT_SEARCH_SSE2
+// Loads the values at p + j, p + j + bytes, ... as lanes of the comparison's
+// width, sign extended or biased so that a signed compare orders them.
+static inline __m128i LoadLanes (const uint8 *p, int bytes, bool8 is_signed)
+{
+	__m128i	v = _mm_loadu_si128((const __m128i *) p);
 
-		for (i = 0; i < 0x2000 - l; i++)
-		{
-			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->FillRAM + 0x3000, i), value))
-			{
-				if (update)
-					d->CIRAM[i] = d->FillRAM[i + 0x3000];
-			}
-			else
-				BIT_CLEAR(d->IRAM_BITS, i);
-		}
+	switch (bytes)
+	{
+		case 1:	return (is_signed ? v : _mm_xor_si128(v, _mm_set1_epi8((char) 0x80)));
+		case 2:	return (is_signed ? v : _mm_xor_si128(v, _mm_set1_epi16((short) 0x8000)));
+		case 3:	return (is_signed ? _mm_srai_epi32(_mm_slli_epi32(v, 8), 8) : _mm_and_si128(v, _mm_set1_epi32(0xffffff)));
+		default:
+		case 4:	return (is_signed ? v : _mm_xor_si128(v, _mm_set1_epi32((int) 0x80000000)));
 	}
+}
 
-	for (i = 0x20000 - l; i < 0x20000; i++)
-		BIT_CLEAR(d->WRAM_BITS, i);
+static inline __m128i ValueLanes (const SearchOp &op)
+{
+	uint32	v = (uint32) op.value;
 
-	for (i = 0x10000 - l; i < 0x10000; i++)
-		BIT_CLEAR(d->SRAM_BITS, i);
+	switch (op.bytes)
+	{
+		case 1:	return (_mm_set1_epi8((char) (op.is_signed ? v : v ^ 0x80)));
+		case 2:	return (_mm_set1_epi16((short) (op.is_signed ? v : v ^ 0x8000)));
+		case 3:	return (_mm_set1_epi32((int) v));
+		default:
+		case 4:	return (_mm_set1_epi32((int) (op.is_signed ? v : v ^ 0x80000000)));
+	}
 }
 
-void S9xSearchForAddress (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 update)
+static inline __m128i CompareGT (const __m128i &a, const __m128i &b, int bytes)
 {
-	int	l, i;
+	return (bytes == 1 ? _mm_cmpgt_epi8(a, b) : bytes == 2 ? _mm_cmpgt_epi16(a, b) : _mm_cmpgt_epi32(a, b));
+}
 
-	switch (size)
+static inline __m128i CompareEQ (const __m128i &a, const __m128i &b, int bytes)
+{
+	return (bytes == 1 ? _mm_cmpeq_epi8(a, b) : bytes == 2 ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b));
+}
+
+// Puts lane k of m[j] at byte bytes * k + j, so byte n is the result for
+// address n, and returns those as a bit mask.
+static inline uint32 InterleaveMasks (const __m128i *m, int bytes)
+{
+	if (bytes == 1)
+		return (_mm_movemask_epi8(m[0]));
+
+	if (bytes == 2)
+		return (_mm_movemask_epi8(_mm_unpacklo_epi8(_mm_packs_epi16(m[0], m[0]), _mm_packs_epi16(m[1], m[1]))));
+
+	__m128i	t0 = _mm_unpacklo_epi32(m[0], m[1]), t1 = _mm_unpacklo_epi32(m[2], m[3]);
+	__m128i	t2 = _mm_unpackhi_epi32(m[0], m[1]), t3 = _mm_unpackhi_epi32(m[2], m[3]);
+	__m128i	lo = _mm_packs_epi32(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1));
+	__m128i	hi = _mm_packs_epi32(_mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3));
+
+	return (_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+}
+
+// 16 addresses from i. Reads up to i + 15 + bytes.
+static inline uint32 CompareSSE2Half (const SearchRegion &r, const SearchOp &op, const __m128i &value, int i)
+{
+	int		lanes = op.bytes == 3 ? 4 : op.bytes;
+	__m128i	gt[4], eq[4];
+
+	for (int j = 0; j < lanes; j++)
 	{
-		case S9X_8_BITS:	l = 0; break;
-		case S9X_16_BITS:	l = 1; break;
-		case S9X_24_BITS:	l = 2; break;
-		default:
-		case S9X_32_BITS:	l = 3; break;
+		__m128i	a = LoadLanes(r.mem + i + j, op.bytes, op.is_signed);
+		__m128i	b = (op.mode == SEARCH_CHANGE) ? LoadLanes(r.saved + i + j, op.bytes, op.is_signed) : value;
+
+		gt[j] = CompareGT(a, b, op.bytes);
+		eq[j] = CompareEQ(a, b, op.bytes);
 	}
 
-	for (i = 0; i < 0x20000 - l; i++)
+	return (CombineMasks(op.cmp, InterleaveMasks(gt, lanes), InterleaveMasks(eq, lanes)) & 0xffff);
+}
+#endif
+
+static inline int CountBits (uint32 v)
+{
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	return ((((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24);
+}
+
+static void SaveMatches (const SearchRegion &r, int i, uint32 matches)
+{
+	if (matches == 0xffffffff)
+		memcpy(r.saved + i, r.mem + i, 32);
+	else
 	{
-		if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, i, (int32) value))
+		for (int k = 0; matches; k++, matches >>= 1)
 		{
-			if (update)
-				d->CWRAM[i] = d->RAM[i];
+			if (matches & 1)
+				r.saved[i + k] = r.mem[i + k];
 		}
+	}
+}
+
+static void SearchRegionBits (const SearchRegion &r, const SearchOp &op)
+{
+	int	count = r.size - (op.bytes - 1);
+
+#ifdef CHEAT_SEARCH_SSE2
+	bool8	vector = op.mode != SEARCH_ADDRESS && !op.constant;
+	__m128i	value = ValueLanes(op);
+#endif
+
+	for (int w = 0; w * 32 < count; w++)
+	{
+		uint32	old = r.bits[w];
+		if (!old)
+			continue;
+
+		int		i = w * 32;
+		int		n = count - i < 32 ? count - i : 32;
+		uint32	tested = n == 32 ? 0xffffffff : (1u << n) - 1;
+		uint32	matches;
+
+	#ifdef CHEAT_SEARCH_SSE2
+		if (vector && i + 32 + op.bytes <= r.size)
+			matches = CompareSSE2Half(r, op, value, i) | (CompareSSE2Half(r, op, value, i + 16) << 16);
 		else
-			BIT_CLEAR(d->WRAM_BITS, i);
+	#endif
+			matches = CompareScalar(r, op, i, n);
+
+		matches &= old & tested;
+		r.bits[w] = matches | (old & ~tested);
+
+		if (op.update && matches)
+			SaveMatches(r, i, matches);
 	}
 
-	for (i = 0; i < 0x10000 - l; i++)
+	if (r.clear_tail)
+	{
+		for (int i = count; i < r.size; i++)
+			BIT_CLEAR(r.bits, i);
+	}
+}
+
+static void SearchCandidateList (SCheatData *d, const SearchRegion r[3], const SearchOp &op)
+{
+	uint32	kept = 0;
+
+	for (uint32 c = 0; c < d->num_candidates; c++)
 	{
-		if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, i + 0x20000, (int32) value))
+		uint32	p = d->candidates[c];
+		const SearchRegion	&reg = r[p < 0x20000 ? 0 : p < 0x30000 ? 1 : 2];
+		int		i = p - reg.base;
+
+		if (i >= reg.size - (op.bytes - 1))
+		{
+			if (reg.clear_tail)
+			{
+				BIT_CLEAR(reg.bits, i);
+				continue;
+			}
+		}
+		else
+		if (TestOne(reg, op, i))
 		{
-			if (update)
-				d->CSRAM[i] = d->SRAM[i];
+			if (op.update)
+				reg.saved[i] = reg.mem[i];
 		}
 		else
-			BIT_CLEAR(d->SRAM_BITS, i);
+		{
+			BIT_CLEAR(reg.bits, i);
+			continue;
+		}
+
+		d->candidates[kept++] = p;
 	}
 
-	for (i = 0; i < 0x2000 - l; i++)
+	d->num_candidates = kept;
+}
+
+// Rebuilds the candidate list from the bitmap if it has become short enough.
+static void UpdateCandidateList (SCheatData *d)
+{
+	uint32	total = 0;
+	int		w;
+
+	for (w = 0; w < (0x32000 >> 5); w++)
+		total += CountBits(d->ALL_BITS[w]);
+
+	d->use_candidates = total <= MAX_CHEAT_CANDIDATES;
+	if (!d->use_candidates)
+		return;
+
+	d->num_candidates = 0;
+	for (w = 0; w < (0x32000 >> 5); w++)
 	{
-		if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, i + 0x30000, (int32) value))
+		for (uint32 bits = d->ALL_BITS[w], k = 0; bits; k++, bits >>= 1)
 		{
-			if (update)
-				d->CIRAM[i] = d->FillRAM[i + 0x3000];
+			if (bits & 1)
+				d->candidates[d->num_candidates++] = w * 32 + k;
 		}
-		else
-			BIT_CLEAR(d->IRAM_BITS, i);
 	}
+}
+
+static void RunCheatSearch (SCheatData *d, const SearchOp &op)
+{
+	SearchRegion	r[3];
+
+	SetupRegions(d, r);
+
+	if (d->use_candidates)
+		SearchCandidateList(d, r, op);
+	else
+	{
+		for (int n = 0; n < 3; n++)
+			SearchRegionBits(r[n], op);
+
+		UpdateCandidateList(d);
+	}
+}
+
+void S9xStartCheatSearch (SCheatData *d)
+{
+	memmove(d->CWRAM, d->RAM, 0x20000);
+	memmove(d->CSRAM, d->SRAM, 0x10000);
+	memmove(d->CIRAM, &d->FillRAM[0x3000], 0x2000);
+	memset((char *) d->ALL_BITS, 0xff, 0x32000 >> 3);
+	d->use_candidates = FALSE;
+}
 
-	for (i = 0x20000 - l; i < 0x20000; i++)
-		BIT_CLEAR(d->WRAM_BITS, i);
+void S9xSearchForChange (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, bool8 is_signed, bool8 update)
+{
+	SearchOp	op;
+
+	SetupOp(op, SEARCH_CHANGE, cmp, size, 0, is_signed, update);
+	RunCheatSearch(d, op);
+}
+
+void S9xSearchForValue (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 is_signed, bool8 update)
+{
+	SearchOp	op;
+
+	SetupOp(op, SEARCH_VALUE, cmp, size, value, is_signed, update);
+	RunCheatSearch(d, op);
+}
+
+void S9xSearchForAddress (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 update)
+{
+	SearchOp	op;
 
-	for (i = 0x10000 - l; i < 0x10000; i++)
-		BIT_CLEAR(d->SRAM_BITS, i);
+	SetupOp(op, SEARCH_ADDRESS, cmp, size, value, TRUE, update);
+	RunCheatSearch(d, op);
 }
 
 void S9xOutputCheatSearchResults (SCheatData *d)
@@ -180,6 +180,7 @@
 #define _CHEATS_H_
 
 #define MAX_CHEATS	150
+#define MAX_CHEAT_CANDIDATES	0x1000
 
 struct SCheat
 {
@@ -203,6 +204,9 @@ struct SCheatData
 	uint8	*SRAM;
 	uint32	ALL_BITS[0x32000 >> 5];
 	uint8	CWatchRAM[0x32000];
+	uint32	candidates[MAX_CHEAT_CANDIDATES];	// the set bits of ALL_BITS, once there are few enough
+	uint32	num_candidates;
+	bool8	use_candidates;
 };
 
 struct Watch
@@ -274,6 +274,13 @@ void S9xReset (void)
 	S9xResetSaveTimer(FALSE);
 	S9xResetLogger();
 
+	S9xResetHardware();
+}
+
+// Power-on state of the emulated hardware only, without the oops snapshot and
+// stream logger side effects of S9xReset.
+void S9xResetHardware (void)
+{
 	memset(Memory.RAM, 0x55, 0x20000);
 	memset(Memory.VRAM, 0x00, 0x10000);
 	memset(Memory.FillRAM, 0, 0x8000);
@@ -183,6 +183,8 @@
 #include "apu/apu.h"
 #include "fxemu.h"
 #include "snapshot.h"
+#include "movie.h"
+#include "profile.h"
 #ifdef DEBUGGER
 #include "debug.h"
 #include "missing.h"
@@ -190,9 +192,15 @@
 
 static inline void S9xReschedule (void);
 
+static bool8	RunAheadHidden     = FALSE;
+static uint8	*RunAheadBuffer    = NULL;
+static uint32	RunAheadBufferSize = 0;
+
 
 void S9xMainLoop (void)
 {
+	PROFILE_SECTION(PROFILE_CPU);
+
 	for (;;)
 	{
 		if (CPU.NMILine)
@@ -305,11 +313,79 @@ void S9xMainLoop (void)
 	#ifdef DEBUGGER
 		if (!(CPU.Flags & FRAME_ADVANCE_FLAG))
 	#endif
-		S9xSyncSpeed();
+		if (!RunAheadHidden)
+			S9xSyncSpeed();
 		CPU.Flags &= ~SCAN_KEYS_FLAG;
 	}
 }
 
+// Runs one real frame with Settings.RunAheadFrames frames of run-ahead.
+// The real frame is emulated with sound but without video, then the
+// following frames are emulated from a snapshot of it with their sound
+// discarded, the last of them is displayed, and the snapshot is restored.
+// The game's own input lag is hidden while the caller still sees exactly
+// one emulated frame per call.
+void S9xMainLoopRunAhead (void)
+{
+	uint32	frames = Settings.RunAheadFrames;
+
+	if (frames == 0 || S9xMovieActive())
+	{
+		S9xMainLoop();
+		return;
+	}
+
+	uint32	size = S9xFreezeSizeFast();
+	if (size > RunAheadBufferSize)
+	{
+		delete [] RunAheadBuffer;
+		RunAheadBuffer = new uint8[size];
+		RunAheadBufferSize = size;
+	}
+
+	bool8	render = IPPU.RenderThisFrame;
+
+	IPPU.RenderThisFrame = FALSE;
+	S9xMainLoop();
+
+	// S9xSyncSpeed has made the frameskip decision for the next real frame
+	bool8	render_next = IPPU.RenderThisFrame;
+
+	if (!S9xFreezeGameMemFast(RunAheadBuffer, RunAheadBufferSize))
+		return;
+
+	uint32		frame_count     = IPPU.FrameCount;
+	uint32		rendered_count  = IPPU.RenderedFramesCount;
+	uint32		displayed_count = IPPU.DisplayedRenderedFrameCount;
+	uint32		total_frames    = IPPU.TotalEmulatedFrames;
+	const char	*info_string    = GFX.InfoString;
+	uint32		info_timeout    = GFX.InfoStringTimeout;
+
+	S9xLandSamples();
+	S9xSetSoundDiscard(TRUE);
+	RunAheadHidden = TRUE;
+
+	for (uint32 i = 1; i <= frames; i++)
+	{
+		IPPU.RenderThisFrame = (i == frames) ? render : FALSE;
+		S9xMainLoop();
+	}
+
+	RunAheadHidden = FALSE;
+	S9xLandSamples();
+	S9xUnfreezeGameMemFast(RunAheadBuffer, RunAheadBufferSize);
+	S9xSetSoundDiscard(FALSE);
+
+	IPPU.FrameCount                  = frame_count;
+	IPPU.RenderedFramesCount         = rendered_count + (render ? 1 : 0);
+	IPPU.DisplayedRenderedFrameCount = displayed_count;
+	IPPU.TotalEmulatedFrames         = total_frames;
+	GFX.InfoString                   = info_string;
+	GFX.InfoStringTimeout            = info_timeout;
+
+	IPPU.RenderThisFrame = render_next;
+}
+
 static inline void S9xReschedule (void)
 {
 	switch (CPU.WhichEvent)
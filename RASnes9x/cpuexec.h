@@ -217,7 +217,9 @@ extern uint8			S9xOpLengthsM0X1[256];
 extern uint8			S9xOpLengthsM0X0[256];
 
 void S9xMainLoop (void);
+void S9xMainLoopRunAhead (void);
 void S9xReset (void);
+void S9xResetHardware (void);
 void S9xSoftReset (void);
 void S9xDoHEventProcessing (void);
 
@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profile.h"
 #ifdef DEBUGGER
 #include "missing.h"
 #endif
@@ -204,6 +205,8 @@ void S9xResetDSP (void)
 
 uint8 S9xGetDSP (uint16 address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 #ifdef DEBUGGER
 	if (Settings.TraceDSP)
 	{
@@ -217,6 +220,8 @@ uint8 S9xGetDSP (uint16 address)
 
 void S9xSetDSP (uint8 byte, uint16 address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 #ifdef DEBUGGER
 	missing.unknowndsp_write = address;
 	if (Settings.TraceDSP)
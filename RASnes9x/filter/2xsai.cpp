@@ -178,6 +178,12 @@
 
 #include "snes9x.h"
 #include "2xsai.h"
+#include "simd.h"
+
+#ifdef S9X_FILTER_SIMD
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
 
 #define ALL_COLOR_MASK	(FIRST_COLOR_MASK | SECOND_COLOR_MASK | THIRD_COLOR_MASK)
 
@@ -248,6 +254,94 @@ static inline uint32 Q_INTERPOLATE (uint32 A, uint32 B, uint32 C, uint32 D)
 	return (x + y);
 }
 
+// All three filters turn a pixel whose 2x2 block (itself, right, below and
+// below right) is one colour into four copies of it. The flat kernels write
+// such pixels a whole vector at a time and return how many leading pixels of
+// the span they did; anything else goes through the scalar code.
+
+typedef int (*SAIFlatFunc) (const uint16 *, uint32, uint32 *, int, int);
+
+static int SAI_Flat_None (const uint16 *bP, uint32 nextline, uint32 *dP, int dstRowBytes, int count)
+{
+	return (0);
+}
+
+#ifdef S9X_FILTER_SIMD
+
+S9X_TARGET_SSE2
+static int SAI_Flat_SSE2 (const uint16 *bP, uint32 nextline, uint32 *dP, int dstRowBytes, int count)
+{
+	uint32	*dP2 = dP + (dstRowBytes >> 2);
+	int		x;
+
+	for (x = 0; x + 8 <= count; x += 8)
+	{
+		__m128i	color = _mm_loadu_si128((const __m128i *) (bP + x));
+		__m128i	right = _mm_loadu_si128((const __m128i *) (bP + x + 1));
+		__m128i	below = _mm_loadu_si128((const __m128i *) (bP + nextline + x));
+		__m128i	belowRight = _mm_loadu_si128((const __m128i *) (bP + nextline + x + 1));
+
+		__m128i	flat = _mm_and_si128(_mm_cmpeq_epi16(color, right), _mm_and_si128(_mm_cmpeq_epi16(color, below), _mm_cmpeq_epi16(color, belowRight)));
+		if (_mm_movemask_epi8(flat) != 0xFFFF)
+			break;
+
+		__m128i	lo = _mm_unpacklo_epi16(color, color), hi = _mm_unpackhi_epi16(color, color);
+		_mm_storeu_si128((__m128i *) (dP  + x),     lo);
+		_mm_storeu_si128((__m128i *) (dP  + x + 4), hi);
+		_mm_storeu_si128((__m128i *) (dP2 + x),     lo);
+		_mm_storeu_si128((__m128i *) (dP2 + x + 4), hi);
+	}
+
+	return (x);
+}
+
+S9X_TARGET_AVX2
+static int SAI_Flat_AVX2 (const uint16 *bP, uint32 nextline, uint32 *dP, int dstRowBytes, int count)
+{
+	uint32	*dP2 = dP + (dstRowBytes >> 2);
+	int		x;
+
+	for (x = 0; x + 16 <= count; x += 16)
+	{
+		__m256i	color = _mm256_loadu_si256((const __m256i *) (bP + x));
+		__m256i	right = _mm256_loadu_si256((const __m256i *) (bP + x + 1));
+		__m256i	below = _mm256_loadu_si256((const __m256i *) (bP + nextline + x));
+		__m256i	belowRight = _mm256_loadu_si256((const __m256i *) (bP + nextline + x + 1));
+
+		__m256i	flat = _mm256_and_si256(_mm256_cmpeq_epi16(color, right), _mm256_and_si256(_mm256_cmpeq_epi16(color, below), _mm256_cmpeq_epi16(color, belowRight)));
+		if (_mm256_movemask_epi8(flat) != -1)
+			break;
+
+		// unpack works within 128-bit lanes, put the pixel pairs back in order
+		__m256i	lo = _mm256_unpacklo_epi16(color, color), hi = _mm256_unpackhi_epi16(color, color);
+		__m256i	first = _mm256_permute2x128_si256(lo, hi, 0x20), second = _mm256_permute2x128_si256(lo, hi, 0x31);
+		_mm256_storeu_si256((__m256i *) (dP  + x),     first);
+		_mm256_storeu_si256((__m256i *) (dP  + x + 8), second);
+		_mm256_storeu_si256((__m256i *) (dP2 + x),     first);
+		_mm256_storeu_si256((__m256i *) (dP2 + x + 8), second);
+	}
+
+	return (x);
+}
+
+#endif
+
+static SAIFlatFunc SAI_SelectFlat (void)
+{
+#ifdef S9X_FILTER_SIMD
+	switch (S9xFilterSIMDLevel())
+	{
+		case S9X_SIMD_AVX2:
+			return (SAI_Flat_AVX2);
+
+		case S9X_SIMD_SSE2:
+			return (SAI_Flat_SSE2);
+	}
+#endif
+
+	return (SAI_Flat_None);
+}
+
 bool8 S9xBlit2xSaIFilterInit (void)
 {
 #ifdef GFX_MULTI_FORMAT
@@ -265,137 +359,148 @@ void S9xBlit2xSaIFilterDeinit (void)
 	return;
 }
 
+static inline void SuperEaglePixel (uint16 *bP, uint32 *dP, uint32 nextline, int dstRowBytes)
+{
+	uint32	color1, color2, color3, color4, color5, color6;
+	uint32	colorA0, colorA1, colorA2, colorA3, colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
+	uint32	product1a, product1b, product2a, product2b;
+
+	colorB0 = *(bP - nextline - 1);
+	colorB1 = *(bP - nextline    );
+	colorB2 = *(bP - nextline + 1);
+	colorB3 = *(bP - nextline + 2);
+
+	color4  = *(bP - 1);
+	color5  = *(bP    );
+	color6  = *(bP + 1);
+	colorS2 = *(bP + 2);
+
+	color1  = *(bP + nextline - 1);
+	color2  = *(bP + nextline    );
+	color3  = *(bP + nextline + 1);
+	colorS1 = *(bP + nextline + 2);
+
+	colorA0 = *(bP + nextline + nextline - 1);
+	colorA1 = *(bP + nextline + nextline    );
+	colorA2 = *(bP + nextline + nextline + 1);
+	colorA3 = *(bP + nextline + nextline + 2);
+
+	if (color2 == color6 && color5 != color3)
+	{
+		product1b = product2a = color2;
+		if ((color1 == color2 && color6 == colorS2) || (color2 == colorA1 && color6 == colorB2))
+		{
+			product1a = INTERPOLATE(color2, color5);
+			product1a = INTERPOLATE(color2, product1a);
+			product2b = INTERPOLATE(color2, color3);
+			product2b = INTERPOLATE(color2, product2b);
+		}
+		else
+		{
+			product1a = INTERPOLATE(color5, color6);
+			product2b = INTERPOLATE(color2, color3);
+		}
+	}
+	else
+	if (color5 == color3 && color2 != color6)
+	{
+		product2b = product1a = color5;
+		if ((colorB1 == color5 && color3 == colorA2) || (color4 == color5 && color3 == colorS1))
+		{
+			product1b = INTERPOLATE(color5, color6);
+			product1b = INTERPOLATE(color5, product1b);
+			product2a = INTERPOLATE(color5, color2);
+			product2a = INTERPOLATE(color5, product2a);
+		}
+		else
+		{
+			product1b = INTERPOLATE(color5, color6);
+			product2a = INTERPOLATE(color2, color3);
+		}
+	}
+	else
+	if (color5 == color3 && color2 == color6 && color5 != color6)
+	{
+		int	r = 0;
+
+		r += GetResult(color6, color5, color1,  colorA1);
+		r += GetResult(color6, color5, color4,  colorB1);
+		r += GetResult(color6, color5, colorA2, colorS1);
+		r += GetResult(color6, color5, colorB2, colorS2);
+
+		if (r > 0)
+		{
+			product1b = product2a = color2;
+			product1a = product2b = INTERPOLATE(color5, color6);
+		}
+		else
+		if (r < 0)
+		{
+			product2b = product1a = color5;
+			product1b = product2a = INTERPOLATE(color5, color6);
+		}
+		else
+		{
+			product2b = product1a = color5;
+			product1b = product2a = color2;
+		}
+	}
+	else
+	{
+		if ((color2 == color5) || (color3 == color6))
+		{
+			product1a = color5;
+			product2a = color2;
+			product1b = color6;
+			product2b = color3;
+		}
+		else
+		{
+			product1b = product1a = INTERPOLATE(color5, color6);
+			product1a = INTERPOLATE(color5, product1a);
+			product1b = INTERPOLATE(color6, product1b);
+
+			product2a = product2b = INTERPOLATE(color2, color3);
+			product2a = INTERPOLATE(color2, product2a);
+			product2b = INTERPOLATE(color3, product2b);
+		}
+	}
+
+#ifdef MSB_FIRST
+	product1a = (product1a << 16) | product1b;
+	product2a = (product2a << 16) | product2b;
+#else
+	product1a = product1a | (product1b << 16);
+	product2a = product2a | (product2b << 16);
+#endif
+
+	*(dP) = product1a;
+	*(dP + (dstRowBytes >> 2)) = product2a;
+}
+
 void SuperEagle (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
     uint16	*bP;
     uint32	*dP;
 	uint32	nextline = srcRowBytes >> 1;
 
+	SAIFlatFunc	flatFunc = SAI_SelectFlat();
+
 	for (; height; height--)
 	{
 	    bP = (uint16 *) srcPtr;
 	    dP = (uint32 *) dstPtr;
 
-		for (int i = 0; i < width; i++)
+		for (int i = 0; i < width; )
 		{
-           	uint32	color1, color2, color3, color4, color5, color6;
-           	uint32	colorA0, colorA1, colorA2, colorA3, colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
-           	uint32	product1a, product1b, product2a, product2b;
-
-			colorB0 = *(bP - nextline - 1);
-			colorB1 = *(bP - nextline    );
-			colorB2 = *(bP - nextline + 1);
-			colorB3 = *(bP - nextline + 2);
-
-			color4  = *(bP - 1);
-			color5  = *(bP    );
-			color6  = *(bP + 1);
-			colorS2 = *(bP + 2);
-
-			color1  = *(bP + nextline - 1);
-			color2  = *(bP + nextline    );
-			color3  = *(bP + nextline + 1);
-			colorS1 = *(bP + nextline + 2);
-
-			colorA0 = *(bP + nextline + nextline - 1);
-			colorA1 = *(bP + nextline + nextline    );
-			colorA2 = *(bP + nextline + nextline + 1);
-			colorA3 = *(bP + nextline + nextline + 2);
-
-			if (color2 == color6 && color5 != color3)
-			{
-				product1b = product2a = color2;
-				if ((color1 == color2 && color6 == colorS2) || (color2 == colorA1 && color6 == colorB2))
-				{
-					product1a = INTERPOLATE(color2, color5);
-					product1a = INTERPOLATE(color2, product1a);
-					product2b = INTERPOLATE(color2, color3);
-					product2b = INTERPOLATE(color2, product2b);
-				}
-				else
-				{
-					product1a = INTERPOLATE(color5, color6);
-					product2b = INTERPOLATE(color2, color3);
-				}
-			}
-			else
-			if (color5 == color3 && color2 != color6)
-			{
-				product2b = product1a = color5;
-				if ((colorB1 == color5 && color3 == colorA2) || (color4 == color5 && color3 == colorS1))
-				{
-					product1b = INTERPOLATE(color5, color6);
-					product1b = INTERPOLATE(color5, product1b);
-					product2a = INTERPOLATE(color5, color2);
-					product2a = INTERPOLATE(color5, product2a);
-				}
-				else
-				{
-					product1b = INTERPOLATE(color5, color6);
-					product2a = INTERPOLATE(color2, color3);
-				}
-			}
-			else
-			if (color5 == color3 && color2 == color6 && color5 != color6)
-			{
-				int	r = 0;
-
-				r += GetResult(color6, color5, color1,  colorA1);
-				r += GetResult(color6, color5, color4,  colorB1);
-				r += GetResult(color6, color5, colorA2, colorS1);
-				r += GetResult(color6, color5, colorB2, colorS2);
-
-				if (r > 0)
-				{
-					product1b = product2a = color2;
-					product1a = product2b = INTERPOLATE(color5, color6);
-				}
-				else
-				if (r < 0)
-				{
-					product2b = product1a = color5;
-					product1b = product2a = INTERPOLATE(color5, color6);
-				}
-				else
-				{
-					product2b = product1a = color5;
-					product1b = product2a = color2;
-				}
-			}
-			else
-			{
-				if ((color2 == color5) || (color3 == color6))
-				{
-					product1a = color5;
-					product2a = color2;
-					product1b = color6;
-					product2b = color3;
-				}
-				else
-				{
-					product1b = product1a = INTERPOLATE(color5, color6);
-					product1a = INTERPOLATE(color5, product1a);
-					product1b = INTERPOLATE(color6, product1b);
-
-					product2a = product2b = INTERPOLATE(color2, color3);
-					product2a = INTERPOLATE(color2, product2a);
-					product2b = INTERPOLATE(color3, product2b);
-				}
-			}
-
-		#ifdef MSB_FIRST
-			product1a = (product1a << 16) | product1b;
-			product2a = (product2a << 16) | product2b;
-		#else
-			product1a = product1a | (product1b << 16);
-			product2a = product2a | (product2b << 16);
-		#endif
-
-			*(dP) = product1a;
-			*(dP + (dstRowBytes >> 2)) = product2a;
-
-			bP++;
-			dP++;
+			int	n   = flatFunc(bP, nextline, dP, dstRowBytes, width - i);
+			int	end = (i + n + 8 < width) ? i + n + 8 : width;
+
+			bP += n;
+			dP += n;
+
+			for (i += n; i < end; i++, bP++, dP++)
+				SuperEaglePixel(bP, dP, nextline, dstRowBytes);
 		}
 
 	    dstPtr += dstRowBytes << 1;
@@ -403,135 +508,146 @@ void SuperEagle (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes,
  	}
 }
 
+static inline void _2xSaIPixel (uint16 *bP, uint32 *dP, uint32 nextline, int dstRowBytes)
+{
+	uint32	colorA, colorB, colorC, colorD, colorE, colorF, colorG, colorH, colorI, colorJ, colorK, colorL, colorM, colorN, colorO, colorP;
+	uint32	product, product1, product2;
+
+	colorI = *(bP - nextline - 1);
+	colorE = *(bP - nextline    );
+	colorF = *(bP - nextline + 1);
+	colorJ = *(bP - nextline + 2);
+
+	colorG = *(bP - 1);
+	colorA = *(bP    );
+	colorB = *(bP + 1);
+	colorK = *(bP + 2);
+
+	colorH = *(bP + nextline - 1);
+	colorC = *(bP + nextline    );
+	colorD = *(bP + nextline + 1);
+	colorL = *(bP + nextline + 2);
+
+	colorM = *(bP + nextline + nextline - 1);
+	colorN = *(bP + nextline + nextline    );
+	colorO = *(bP + nextline + nextline + 1);
+	colorP = *(bP + nextline + nextline + 2);
+
+	if ((colorA == colorD) && (colorB != colorC))
+	{
+		if (((colorA == colorE) && (colorB == colorL)) || ((colorA == colorC) && (colorA == colorF) && (colorB != colorE) && (colorB == colorJ)))
+			product = colorA;
+		else
+			product = INTERPOLATE(colorA, colorB);
+
+		if (((colorA == colorG) && (colorC == colorO)) || ((colorA == colorB) && (colorA == colorH) && (colorG != colorC) && (colorC == colorM)))
+			product1 = colorA;
+		else
+			product1 = INTERPOLATE(colorA, colorC);
+
+		product2 = colorA;
+	}
+	else
+	if ((colorB == colorC) && (colorA != colorD))
+	{
+		if (((colorB == colorF) && (colorA == colorH)) || ((colorB == colorE) && (colorB == colorD) && (colorA != colorF) && (colorA == colorI)))
+			product = colorB;
+		else
+			product = INTERPOLATE(colorA, colorB);
+
+		if (((colorC == colorH) && (colorA == colorF)) || ((colorC == colorG) && (colorC == colorD) && (colorA != colorH) && (colorA == colorI)))
+			product1 = colorC;
+		else
+			product1 = INTERPOLATE(colorA, colorC);
+
+		product2 = colorB;
+	}
+	else
+	if ((colorA == colorD) && (colorB == colorC))
+	{
+		if (colorA == colorB)
+		{
+			product  = colorA;
+			product1 = colorA;
+			product2 = colorA;
+		}
+		else
+		{
+			int	r = 0;
+
+			product1 = INTERPOLATE(colorA, colorC);
+			product  = INTERPOLATE(colorA, colorB);
+
+			r += GetResult1(colorA, colorB, colorG, colorE, colorI);
+			r += GetResult2(colorB, colorA, colorK, colorF, colorJ);
+			r += GetResult2(colorB, colorA, colorH, colorN, colorM);
+			r += GetResult1(colorA, colorB, colorL, colorO, colorP);
+
+			if (r > 0)
+				product2 = colorA;
+			else
+			if (r < 0)
+				product2 = colorB;
+			else
+				product2 = Q_INTERPOLATE(colorA, colorB, colorC, colorD);
+		}
+	}
+	else
+	{
+		product2 = Q_INTERPOLATE(colorA, colorB, colorC, colorD);
+
+		if ((colorA == colorC) && (colorA == colorF) && (colorB != colorE) && (colorB == colorJ))
+			product  = colorA;
+		else
+		if ((colorB == colorE) && (colorB == colorD) && (colorA != colorF) && (colorA == colorI))
+			product  = colorB;
+		else
+			product = INTERPOLATE(colorA, colorB);
+
+		if ((colorA == colorB) && (colorA == colorH) && (colorG != colorC) && (colorC == colorM))
+			product1 = colorA;
+		else
+		if ((colorC == colorG) && (colorC == colorD) && (colorA != colorH) && (colorA == colorI))
+			product1 = colorC;
+		else
+			product1 = INTERPOLATE(colorA, colorC);
+	}
+
+#ifdef MSB_FIRST
+	product  = (colorA   << 16) | product;
+	product1 = (product1 << 16) | product2;
+#else
+	product  = colorA   | (product  << 16);
+	product1 = product1 | (product2 << 16);
+#endif
+
+	*(dP) = product;
+	*(dP + (dstRowBytes >> 2)) = product1;
+}
+
 void _2xSaI (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
 	uint16 	*bP;
 	uint32	*dP;
 	uint32	nextline  = srcRowBytes >> 1;
 
+	SAIFlatFunc	flatFunc = SAI_SelectFlat();
+
 	for (; height; height--)
 	{
 	    bP = (uint16 *) srcPtr;
 	    dP = (uint32 *) dstPtr;
 
-		for (int i = 0; i < width; i++)
+		for (int i = 0; i < width; )
 		{
-			uint32	colorA, colorB, colorC, colorD, colorE, colorF, colorG, colorH, colorI, colorJ, colorK, colorL, colorM, colorN, colorO, colorP;
-			uint32	product, product1, product2;
-
-			colorI = *(bP - nextline - 1);
-			colorE = *(bP - nextline    );
-			colorF = *(bP - nextline + 1);
-			colorJ = *(bP - nextline + 2);
-
-			colorG = *(bP - 1);
-			colorA = *(bP    );
-			colorB = *(bP + 1);
-			colorK = *(bP + 2);
-
-			colorH = *(bP + nextline - 1);
-			colorC = *(bP + nextline    );
-			colorD = *(bP + nextline + 1);
-			colorL = *(bP + nextline + 2);
-
-			colorM = *(bP + nextline + nextline - 1);
-			colorN = *(bP + nextline + nextline    );
-			colorO = *(bP + nextline + nextline + 1);
-			colorP = *(bP + nextline + nextline + 2);
-
-			if ((colorA == colorD) && (colorB != colorC))
-			{
-				if (((colorA == colorE) && (colorB == colorL)) || ((colorA == colorC) && (colorA == colorF) && (colorB != colorE) && (colorB == colorJ)))
-					product = colorA;
-				else
-					product = INTERPOLATE(colorA, colorB);
-
-				if (((colorA == colorG) && (colorC == colorO)) || ((colorA == colorB) && (colorA == colorH) && (colorG != colorC) && (colorC == colorM)))
-					product1 = colorA;
-				else
-					product1 = INTERPOLATE(colorA, colorC);
+			int	n   = flatFunc(bP, nextline, dP, dstRowBytes, width - i);
+			int	end = (i + n + 8 < width) ? i + n + 8 : width;
 
-				product2 = colorA;
-			}
-			else
-			if ((colorB == colorC) && (colorA != colorD))
-			{
-				if (((colorB == colorF) && (colorA == colorH)) || ((colorB == colorE) && (colorB == colorD) && (colorA != colorF) && (colorA == colorI)))
-					product = colorB;
-				else
-					product = INTERPOLATE(colorA, colorB);
-
-				if (((colorC == colorH) && (colorA == colorF)) || ((colorC == colorG) && (colorC == colorD) && (colorA != colorH) && (colorA == colorI)))
-					product1 = colorC;
-				else
-					product1 = INTERPOLATE(colorA, colorC);
+			bP += n;
+			dP += n;
 
-				product2 = colorB;
-			}
-			else
-			if ((colorA == colorD) && (colorB == colorC))
-			{
-				if (colorA == colorB)
-				{
-					product  = colorA;
-					product1 = colorA;
-					product2 = colorA;
-				}
-				else
-				{
-					int	r = 0;
-
-					product1 = INTERPOLATE(colorA, colorC);
-					product  = INTERPOLATE(colorA, colorB);
-
-					r += GetResult1(colorA, colorB, colorG, colorE, colorI);
-					r += GetResult2(colorB, colorA, colorK, colorF, colorJ);
-					r += GetResult2(colorB, colorA, colorH, colorN, colorM);
-					r += GetResult1(colorA, colorB, colorL, colorO, colorP);
-
-					if (r > 0)
-						product2 = colorA;
-					else
-					if (r < 0)
-						product2 = colorB;
-					else
-						product2 = Q_INTERPOLATE(colorA, colorB, colorC, colorD);
-				}
-			}
-			else
-			{
-				product2 = Q_INTERPOLATE(colorA, colorB, colorC, colorD);
-
-				if ((colorA == colorC) && (colorA == colorF) && (colorB != colorE) && (colorB == colorJ))
-					product  = colorA;
-				else
-				if ((colorB == colorE) && (colorB == colorD) && (colorA != colorF) && (colorA == colorI))
-					product  = colorB;
-				else
-					product = INTERPOLATE(colorA, colorB);
-
-				if ((colorA == colorB) && (colorA == colorH) && (colorG != colorC) && (colorC == colorM))
-					product1 = colorA;
-				else
-				if ((colorC == colorG) && (colorC == colorD) && (colorA != colorH) && (colorA == colorI))
-					product1 = colorC;
-				else
-					product1 = INTERPOLATE(colorA, colorC);
-			}
-
-		#ifdef MSB_FIRST
-			product  = (colorA   << 16) | product;
-			product1 = (product1 << 16) | product2;
-		#else
-			product  = colorA   | (product  << 16);
-			product1 = product1 | (product2 << 16);
-		#endif
-
-			*(dP) = product;
-			*(dP + (dstRowBytes >> 2)) = product1;
-
-			bP++;
-			dP++;
+			for (i += n; i < end; i++, bP++, dP++)
+				_2xSaIPixel(bP, dP, nextline, dstRowBytes);
 		}
 
 	    dstPtr += dstRowBytes << 1;
@@ -539,114 +655,125 @@ void _2xSaI (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
     }
 }
 
+static inline void Super2xSaIPixel (uint16 *bP, uint32 *dP, uint32 nextline, int dstRowBytes)
+{
+	uint32	color1, color2, color3, color4, color5, color6;
+	uint32	colorA0, colorA1, colorA2, colorA3, colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
+	uint32	product1a, product1b, product2a, product2b;
+
+	colorB0 = *(bP - nextline - 1);
+	colorB1 = *(bP - nextline    );
+	colorB2 = *(bP - nextline + 1);
+	colorB3 = *(bP - nextline + 2);
+
+	color4  = *(bP - 1);
+	color5  = *(bP    );
+	color6  = *(bP + 1);
+	colorS2 = *(bP + 2);
+
+	color1  = *(bP + nextline - 1);
+	color2  = *(bP + nextline    );
+	color3  = *(bP + nextline + 1);
+	colorS1 = *(bP + nextline + 2);
+
+	colorA0 = *(bP + nextline + nextline - 1);
+	colorA1 = *(bP + nextline + nextline    );
+	colorA2 = *(bP + nextline + nextline + 1);
+	colorA3 = *(bP + nextline + nextline + 2);
+
+	if (color2 == color6 && color5 != color3)
+		product2b = product1b = color2;
+	else
+	if (color5 == color3 && color2 != color6)
+		product2b = product1b = color5;
+	else
+	if (color5 == color3 && color2 == color6 && color5 != color6)
+	{
+		int	r = 0;
+
+		r += GetResult(color6, color5, color1,  colorA1);
+		r += GetResult(color6, color5, color4,  colorB1);
+		r += GetResult(color6, color5, colorA2, colorS1);
+		r += GetResult(color6, color5, colorB2, colorS2);
+
+		if (r > 0)
+			product2b = product1b = color6;
+		else
+		if (r < 0)
+			product2b = product1b = color5;
+		else
+			product2b = product1b = INTERPOLATE(color5, color6);
+	}
+	else
+	{
+		if (color6 == color3 && color3 == colorA1 && color2 != colorA2 && color3 != colorA0)
+			product2b = Q_INTERPOLATE(color3, color3, color3, color2);
+		else
+		if (color5 == color2 && color2 == colorA2 && colorA1 != color3 && color2 != colorA3)
+			product2b = Q_INTERPOLATE(color2, color2, color2, color3);
+		else
+			product2b = INTERPOLATE(color2, color3);
+
+		if (color6 == color3 && color6 == colorB1 && color5 != colorB2 && color6 != colorB0)
+			product1b = Q_INTERPOLATE(color6, color6, color6, color5);
+		else
+		if (color5 == color2 && color5 == colorB2 && colorB1 != color6 && color5 != colorB3)
+			product1b = Q_INTERPOLATE(color6, color5, color5, color5);
+		else
+			product1b = INTERPOLATE (color5, color6);
+	}
+
+	if (color5 == color3 && color2 != color6 && color4 == color5 && color5 != colorA2)
+		product2a = INTERPOLATE(color2, color5);
+	else
+	if (color5 == color1 && color6 == color5 && color4 != color2 && color5 != colorA0)
+		product2a = INTERPOLATE(color2, color5);
+	else
+		product2a = color2;
+
+	if (color2 == color6 && color5 != color3 && color1 == color2 && color2 != colorB2)
+		product1a = INTERPOLATE(color2, color5);
+	else
+	if (color4 == color2 && color3 == color2 && color1 != color5 && color2 != colorB0)
+		product1a = INTERPOLATE(color2, color5);
+	else
+		product1a = color5;
+
+#ifdef MSB_FIRST
+	product1a = (product1a << 16) | product1b;
+	product2a = (product2a << 16) | product2b;
+#else
+	product1a = product1a | (product1b << 16);
+	product2a = product2a | (product2b << 16);
+#endif
+
+	*(dP) = product1a;
+	*(dP +(dstRowBytes >> 2)) = product2a;
+}
+
 void Super2xSaI (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
     uint16	*bP;
 	uint32	*dP;
 	uint32	nextline = srcRowBytes >> 1;
 
+	SAIFlatFunc	flatFunc = SAI_SelectFlat();
+
 	for (; height; height--)
 	{
 		bP = (uint16 *) srcPtr;
 	    dP = (uint32 *) dstPtr;
 
-		for (int i = 0; i < width; i++)
+		for (int i = 0; i < width; )
 		{
-           	uint32	color1, color2, color3, color4, color5, color6;
-           	uint32	colorA0, colorA1, colorA2, colorA3, colorB0, colorB1, colorB2, colorB3, colorS1, colorS2;
-           	uint32	product1a, product1b, product2a, product2b;
-
-			colorB0 = *(bP - nextline - 1);
-			colorB1 = *(bP - nextline    );
-			colorB2 = *(bP - nextline + 1);
-			colorB3 = *(bP - nextline + 2);
-
-			color4  = *(bP - 1);
-			color5  = *(bP    );
-			color6  = *(bP + 1);
-			colorS2 = *(bP + 2);
-
-			color1  = *(bP + nextline - 1);
-			color2  = *(bP + nextline    );
-			color3  = *(bP + nextline + 1);
-			colorS1 = *(bP + nextline + 2);
-
-			colorA0 = *(bP + nextline + nextline - 1);
-			colorA1 = *(bP + nextline + nextline    );
-			colorA2 = *(bP + nextline + nextline + 1);
-			colorA3 = *(bP + nextline + nextline + 2);
-
-			if (color2 == color6 && color5 != color3)
-            	product2b = product1b = color2;
-			else
-			if (color5 == color3 && color2 != color6)
-                product2b = product1b = color5;
-			else
-			if (color5 == color3 && color2 == color6 && color5 != color6)
-			{
-				int	r = 0;
-
-				r += GetResult(color6, color5, color1,  colorA1);
-				r += GetResult(color6, color5, color4,  colorB1);
-				r += GetResult(color6, color5, colorA2, colorS1);
-				r += GetResult(color6, color5, colorB2, colorS2);
-
-				if (r > 0)
-					product2b = product1b = color6;
-				else
-				if (r < 0)
-					product2b = product1b = color5;
-				else
-					product2b = product1b = INTERPOLATE(color5, color6);
-			}
-			else
-			{
-				if (color6 == color3 && color3 == colorA1 && color2 != colorA2 && color3 != colorA0)
-					product2b = Q_INTERPOLATE(color3, color3, color3, color2);
-				else
-				if (color5 == color2 && color2 == colorA2 && colorA1 != color3 && color2 != colorA3)
-					product2b = Q_INTERPOLATE(color2, color2, color2, color3);
-				else
-					product2b = INTERPOLATE(color2, color3);
-
-				if (color6 == color3 && color6 == colorB1 && color5 != colorB2 && color6 != colorB0)
-					product1b = Q_INTERPOLATE(color6, color6, color6, color5);
-				else
-				if (color5 == color2 && color5 == colorB2 && colorB1 != color6 && color5 != colorB3)
-					product1b = Q_INTERPOLATE(color6, color5, color5, color5);
-				else
-					product1b = INTERPOLATE (color5, color6);
-			}
-
-			if (color5 == color3 && color2 != color6 && color4 == color5 && color5 != colorA2)
-				product2a = INTERPOLATE(color2, color5);
-			else
-			if (color5 == color1 && color6 == color5 && color4 != color2 && color5 != colorA0)
-				product2a = INTERPOLATE(color2, color5);
-			else
-				product2a = color2;
-
-			if (color2 == color6 && color5 != color3 && color1 == color2 && color2 != colorB2)
-				product1a = INTERPOLATE(color2, color5);
-			else
-			if (color4 == color2 && color3 == color2 && color1 != color5 && color2 != colorB0)
-				product1a = INTERPOLATE(color2, color5);
-			else
-				product1a = color5;
-
-		#ifdef MSB_FIRST
-			product1a = (product1a << 16) | product1b;
-			product2a = (product2a << 16) | product2b;
-		#else
-			product1a = product1a | (product1b << 16);
-			product2a = product2a | (product2b << 16);
-		#endif
+			int	n   = flatFunc(bP, nextline, dP, dstRowBytes, width - i);
+			int	end = (i + n + 8 < width) ? i + n + 8 : width;
 
-			*(dP) = product1a;
-			*(dP +(dstRowBytes >> 2)) = product2a;
+			bP += n;
+			dP += n;
 
-			bP++;
-			dP++;
+			for (i += n; i < end; i++, bP++, dP++)
+				Super2xSaIPixel(bP, dP, nextline, dstRowBytes);
 		}
 
 	    dstPtr += dstRowBytes << 1;
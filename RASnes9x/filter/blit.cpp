@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "blit.h"
+#include "threadpool.h"
 
 #define ALL_COLOR_MASK	(FIRST_COLOR_MASK | SECOND_COLOR_MASK | THIRD_COLOR_MASK)
 
@@ -191,9 +192,20 @@ static uint32	colorMask = 0;
 #define colorMask		(((~RGB_HI_BITS_MASK & ALL_COLOR_MASK) << 16) | (~RGB_HI_BITS_MASK & ALL_COLOR_MASK))
 #endif
 
+#ifdef MSB_FIRST
+#define RIGHT_EDGE_PAIR(p)	((p) << 16)
+#else
+#define RIGHT_EDGE_PAIR(p)	((p) >> 16)
+#endif
+
 static snes_ntsc_t	*ntsc   = NULL;
 static uint8		*XDelta = NULL;
 
+static void Simple2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static void TV2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static void MixedTV1x2 (uint8 *, int, uint8 *, int, int, int, bool8);
+static void Smooth2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *, uint8 *);
+
 
 bool8 S9xBlitFilterInit (void)
 {
@@ -303,7 +315,13 @@ void S9xBlitPixSimple2x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 
 void S9xBlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+	Simple2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta);
+}
+
+// deltaPtr is the XDelta row matching srcPtr
+static void Simple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+	uint8	*dstPtr2 = dstPtr + dstRowBytes;
 	dstRowBytes <<= 1;
 
 	for (; height; height--)
@@ -428,7 +446,12 @@ void S9xBlitPixTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowB
 
 void S9xBlitPixTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+	TV2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta);
+}
+
+static void TV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+	uint8	*dstPtr2 = dstPtr + dstRowBytes;
 	dstRowBytes <<= 1;
 
 	for (; height; height--)
@@ -538,11 +561,20 @@ void S9xBlitPixTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowB
 }
 
 void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	MixedTV1x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, TRUE);
+}
+
+// Each line is mixed with the next one, except the last line of the frame.
+static void MixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, bool8 bottomEdge)
 {
 	uint8	*dstPtr2 = dstPtr + dstRowBytes, *srcPtr2 = srcPtr + srcRowBytes;
 	dstRowBytes <<= 1;
 
-	for (; height > 1; height--)
+	if (bottomEdge)
+		height--;
+
+	for (; height > 0; height--)
 	{
 		uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) dstPtr2, *bP1 = (uint16 *) srcPtr, *bP2 = (uint16 *) srcPtr2;
 		uint16	prev, next, mixed;
@@ -563,6 +595,9 @@ void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int ds
 		dstPtr2 += dstRowBytes;
 	}
 
+	if (!bottomEdge)
+		return;
+
 	// Last 1 line
 
 	uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) dstPtr2, *bP1 = (uint16 *) srcPtr;
@@ -580,55 +615,90 @@ void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int ds
 
 void S9xBlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+	Smooth2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta, NULL);
+}
+
+static inline void Smooth2x2Pair (uint32 currentPixel, uint32 nextPixel, uint32 &currentPixA, uint32 &currentPixB)
+{
+	uint32	colorA, colorB, colorC;
+
+#ifdef MSB_FIRST
+	colorA = (currentPixel >> 16) & 0xFFFF;
+	colorB = (currentPixel      ) & 0xFFFF;
+	colorC = (nextPixel    >> 16) & 0xFFFF;
+
+	currentPixA = (colorA << 16) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask))      );
+	currentPixB = (colorB << 16) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask))      );
+#else
+	colorA = (currentPixel      ) & 0xFFFF;
+	colorB = (currentPixel >> 16) & 0xFFFF;
+	colorC = (nextPixel         ) & 0xFFFF;
+
+	currentPixA = (colorA      ) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask)) << 16);
+	currentPixB = (colorB      ) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask)) << 16);
+#endif
+}
+
+// Every output line is blended with the one above it. prevPtr is the source
+// line above srcPtr when the frame is scaled in slices, or NULL at the top of
+// the frame. The first line of a slice is always redrawn since the change
+// flags of the line above belong to the slice before it.
+static void Smooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr, uint8 *prevPtr)
+{
+	uint8	*dstPtr2 = dstPtr + dstRowBytes;
 	uint32	lastLinePix[SNES_WIDTH << 1];
 	uint8	lastLineChg[SNES_WIDTH >> 1];
-	int		lineBytes = width << 1;
+	int		pairs = width >> 1;
 
 	dstRowBytes <<= 1;
 
-	memset(lastLinePix, 0, sizeof(lastLinePix));
-	memset(lastLineChg, 0, sizeof(lastLineChg));
+	if (prevPtr)
+	{
+		uint32	*bP = (uint32 *) prevPtr, *lL = lastLinePix;
+
+		for (int i = pairs - 1; i >= 0; i--, bP++, lL += 2)
+			Smooth2x2Pair(bP[0], i ? bP[1] : RIGHT_EDGE_PAIR(bP[0]), lL[0], lL[1]);
+
+		memset(lastLineChg, 1, sizeof(lastLineChg));
+	}
+	else
+	{
+		memset(lastLinePix, 0, sizeof(lastLinePix));
+		memset(lastLineChg, 0, sizeof(lastLineChg));
+	}
 
 	for (; height; height--)
 	{
 		uint32	*dP1 = (uint32 *) dstPtr, *dP2 = (uint32 *) dstPtr2, *bP = (uint32 *) srcPtr, *xP = (uint32 *) deltaPtr;
 		uint32	*lL = lastLinePix;
 		uint8	*lC = lastLineChg;
-		uint32	currentPixel, nextPixel, currentDelta, nextDelta, lastPix, lastChg, thisChg, currentPixA, currentPixB, colorA, colorB, colorC;
-		uint16	savePixel;
-
-		savePixel = *(uint16 *) (srcPtr + lineBytes);
-		*(uint16 *) (srcPtr   + lineBytes) = *(uint16 *) (srcPtr + lineBytes - 2);
-		*(uint32 *) (deltaPtr + lineBytes) = *(uint32 *) (srcPtr + lineBytes);
+		uint32	currentPixel, nextPixel, currentDelta, nextDelta, lastPix, lastChg, thisChg, currentPixA, currentPixB;
 
 		nextPixel = *bP++;
 		nextDelta = *xP++;
 
-		for (int i = 0; i < (width >> 1); i++)
+		for (int i = pairs - 1; i >= 0; i--)
 		{
 			currentPixel = nextPixel;
 			currentDelta = nextDelta;
-			nextPixel    = *bP++;
-			nextDelta    = *xP++;
-			lastChg      = *lC;
-			thisChg      = (nextPixel - nextDelta) | (currentPixel - currentDelta);
 
-		#ifdef MSB_FIRST
-			colorA = (currentPixel >> 16) & 0xFFFF;
-			colorB = (currentPixel      ) & 0xFFFF;
-			colorC = (nextPixel    >> 16) & 0xFFFF;
+			if (i)
+			{
+				nextPixel = *bP++;
+				nextDelta = *xP++;
+			}
+			else
+			{
+				// past the right edge the last pixel repeats
+				nextPixel = RIGHT_EDGE_PAIR(currentPixel);
+				nextDelta = nextPixel;
+				xP++;
+			}
 
-			currentPixA = (colorA << 16) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask))      );
-			currentPixB = (colorB << 16) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask))      );
-		#else
-			colorA = (currentPixel      ) & 0xFFFF;
-			colorB = (currentPixel >> 16) & 0xFFFF;
-			colorC = (nextPixel         ) & 0xFFFF;
+			lastChg      = *lC;
+			thisChg      = (nextPixel - nextDelta) | (currentPixel - currentDelta);
 
-			currentPixA = (colorA      ) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask)) << 16);
-			currentPixB = (colorB      ) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask)) << 16);
-		#endif
+			Smooth2x2Pair(currentPixel, nextPixel, currentPixA, currentPixB);
 
 			if (thisChg | lastChg)
 			{
@@ -658,8 +728,6 @@ void S9xBlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 			dP1 += 2;
 		}
 
-		*(uint16 *) (srcPtr + lineBytes) = savePixel;
-
 		srcPtr   += srcRowBytes;
 		deltaPtr += srcRowBytes;
 		dstPtr   += dstRowBytes;
@@ -711,3 +779,157 @@ void S9xBlitPixHiResNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int d
 {
 	snes_ntsc_blit_hires(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, 0, width, height, dstPtr, dstRowBytes);
 }
+
+// Slices of a frame for S9xBlitThreaded. srcPtr and dstPtr still point at the
+// top of the frame and the slice covers source lines top to top + rows - 1.
+// The source is only read, so filters that look at the lines around a pixel
+// can read past the slice; what has to be handled here is state carried from
+// one line to the next.
+typedef void (*BlitSliceFunc) (uint8 *, int, uint8 *, int, int, int, int, int);
+
+static void SliceSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	Simple2x2(srcPtr + top * srcRowBytes, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, XDelta + top * srcRowBytes);
+}
+
+static void SliceTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	TV2x2(srcPtr + top * srcRowBytes, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, XDelta + top * srcRowBytes);
+}
+
+static void SliceMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	MixedTV1x2(srcPtr + top * srcRowBytes, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, top + rows == height);
+}
+
+static void SliceSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	Smooth2x2(srcPtr + top * srcRowBytes, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, XDelta + top * srcRowBytes,
+		top ? srcPtr + (top - 1) * srcRowBytes : NULL);
+}
+
+static void SliceEPX16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	EPX_16_Rows(srcPtr + top * srcRowBytes, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, top == 0, top + rows == height);
+}
+
+// the colour burst phase steps once per line
+static void SliceNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	snes_ntsc_blit(ntsc, (SNES_NTSC_IN_T const *) (srcPtr + top * srcRowBytes), srcRowBytes >> 1, top % snes_ntsc_burst_count, width, rows, dstPtr + top * dstRowBytes, dstRowBytes);
+}
+
+static void SliceHiResNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	snes_ntsc_blit_hires(ntsc, (SNES_NTSC_IN_T const *) (srcPtr + top * srcRowBytes), srcRowBytes >> 1, top % snes_ntsc_burst_count, width, rows, dstPtr + top * dstRowBytes, dstRowBytes);
+}
+
+// Filters without a slice function have nothing carried between lines and
+// are just run on the lines of the slice, scale being output lines per line.
+struct BlitSlicer
+{
+	S9xBlitter		blit;
+	BlitSliceFunc	slice;
+	int				scale;
+};
+
+static const BlitSlicer	slicers[] =
+{
+	{ S9xBlitPixSimple1x1,		NULL,				1 },
+	{ S9xBlitPixSimple1x2,		NULL,				2 },
+	{ S9xBlitPixSimple2x1,		NULL,				1 },
+	{ S9xBlitPixSimple2x2,		SliceSimple2x2,		2 },
+	{ S9xBlitPixBlend1x1,		NULL,				1 },
+	{ S9xBlitPixBlend2x1,		NULL,				1 },
+	{ S9xBlitPixTV1x2,			NULL,				2 },
+	{ S9xBlitPixTV2x2,			SliceTV2x2,			2 },
+	{ S9xBlitPixMixedTV1x2,		SliceMixedTV1x2,	2 },
+	{ S9xBlitPixSmooth2x2,		SliceSmooth2x2,		2 },
+	{ S9xBlitPixSuperEagle16,	NULL,				2 },
+	{ S9xBlitPix2xSaI16,		NULL,				2 },
+	{ S9xBlitPixSuper2xSaI16,	NULL,				2 },
+	{ S9xBlitPixEPX16,			SliceEPX16,			2 },
+	{ S9xBlitPixHQ2x16,			NULL,				2 },
+	{ S9xBlitPixHQ3x16,			NULL,				3 },
+	{ S9xBlitPixHQ4x16,			NULL,				4 },
+	{ S9xBlitPixNTSC16,			SliceNTSC16,		1 },
+	{ S9xBlitPixHiResNTSC16,	SliceHiResNTSC16,	1 }
+};
+
+// fewer lines than this per slice cost more in wake-ups than they save
+#define MIN_SLICE_ROWS	16
+
+struct BlitJob
+{
+	const BlitSlicer	*slicer;
+	uint8				*srcPtr, *dstPtr;
+	int					srcRowBytes, dstRowBytes;
+	int					width, height;
+	int					slices;
+};
+
+static void BlitSlice (void *data, int index)
+{
+	BlitJob				*job = (BlitJob *) data;
+	const BlitSlicer	*slicer = job->slicer;
+	int					top    = job->height *  index      / job->slices;
+	int					bottom = job->height * (index + 1) / job->slices;
+
+	if (slicer->slice)
+		slicer->slice(job->srcPtr, job->srcRowBytes, job->dstPtr, job->dstRowBytes, job->width, job->height, top, bottom - top);
+	else
+		slicer->blit(job->srcPtr + top * job->srcRowBytes, job->srcRowBytes, job->dstPtr + top * slicer->scale * job->dstRowBytes, job->dstRowBytes, job->width, bottom - top);
+}
+
+bool8 S9xBlitThreadsInit (int threads)
+{
+	return (S9xThreadPoolInit(threads));
+}
+
+void S9xBlitThreadsDeinit (void)
+{
+	S9xThreadPoolDeinit();
+}
+
+// Runs one of the S9xBlitPix filters above split into horizontal slices over
+// the threads started by S9xBlitThreadsInit, with the same output as calling
+// it directly.
+void S9xBlitThreaded (S9xBlitter blit, uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	const BlitSlicer	*slicer = NULL;
+	int					slices = S9xThreadPoolThreads();
+
+	if (slices > height / MIN_SLICE_ROWS)
+		slices = height / MIN_SLICE_ROWS;
+
+	if (slices > 1)
+	{
+		for (size_t i = 0; i < sizeof(slicers) / sizeof(slicers[0]); i++)
+		{
+			if (slicers[i].blit == blit)
+			{
+				slicer = &slicers[i];
+				break;
+			}
+		}
+	}
+
+	if (!slicer)
+	{
+		blit(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+		return;
+	}
+
+	BlitJob	job;
+
+	job.slicer      = slicer;
+	job.srcPtr      = srcPtr;
+	job.dstPtr      = dstPtr;
+	job.srcRowBytes = srcRowBytes;
+	job.dstRowBytes = dstRowBytes;
+	job.width       = width;
+	job.height      = height;
+	job.slices      = slices;
+
+	S9xThreadPoolRun(BlitSlice, &job, slices);
+}
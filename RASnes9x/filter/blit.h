@@ -184,6 +184,8 @@
 #include "hq2x.h"
 #include "snes_ntsc.h"
 
+typedef void (*S9xBlitter) (uint8 *, int, uint8 *, int, int, int);
+
 bool8 S9xBlitFilterInit (void);
 void S9xBlitFilterDeinit (void);
 void S9xBlitClearDelta (void);
@@ -209,5 +211,8 @@ void S9xBlitPixHQ3x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHQ4x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixNTSC16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHiResNTSC16 (uint8 *, int, uint8 *, int, int, int);
+bool8 S9xBlitThreadsInit (int);
+void S9xBlitThreadsDeinit (void);
+void S9xBlitThreaded (S9xBlitter, uint8 *, int, uint8 *, int, int, int);
 
 #endif
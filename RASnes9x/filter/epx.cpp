@@ -178,67 +178,150 @@
 
 #include "snes9x.h"
 #include "epx.h"
+#include "simd.h"
 
+#ifdef S9X_FILTER_SIMD
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
 
-void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+//   D
+// A X C
+//   B
+//
+// The row kernels handle pixels 1 to count of a row a whole vector at a time
+// and return how many they did; the edges and the remainder stay scalar. The
+// top and bottom rows pass their own row as the missing neighbour, which the
+// scalar edge code is equivalent to.
+
+typedef int (*EPXRowFunc) (const uint16 *, const uint16 *, const uint16 *, uint32 *, uint32 *, int);
+
+static int EPX_Row_None (const uint16 *uP, const uint16 *sP, const uint16 *lP, uint32 *dP1, uint32 *dP2, int count)
 {
-	uint16	colorX, colorA, colorB, colorC, colorD;
-	uint16	*sP, *uP, *lP;
-	uint32	*dP1, *dP2;
-	int		w;
+	return (0);
+}
 
-	height -= 2;
+#ifdef S9X_FILTER_SIMD
 
-	//   D
-	// A X C
-	//   B
+S9X_TARGET_SSE2
+static int EPX_Row_SSE2 (const uint16 *uP, const uint16 *sP, const uint16 *lP, uint32 *dP1, uint32 *dP2, int count)
+{
+	const __m128i	ones = _mm_set1_epi16(-1);
+	int				x;
 
-	// top edge
+	for (x = 1; x + 8 <= count + 1; x += 8)
+	{
+		__m128i	colorA = _mm_loadu_si128((const __m128i *) (sP + x - 1));
+		__m128i	colorX = _mm_loadu_si128((const __m128i *) (sP + x));
+		__m128i	colorC = _mm_loadu_si128((const __m128i *) (sP + x + 1));
+		__m128i	colorB = _mm_loadu_si128((const __m128i *) (lP + x));
+		__m128i	colorD = _mm_loadu_si128((const __m128i *) (uP + x));
+
+		__m128i	edge = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(colorA, colorC), _mm_cmpeq_epi16(colorB, colorD)), ones);
+		__m128i	m00  = _mm_and_si128(edge, _mm_cmpeq_epi16(colorD, colorA));
+		__m128i	m01  = _mm_and_si128(edge, _mm_cmpeq_epi16(colorC, colorD));
+		__m128i	m10  = _mm_and_si128(edge, _mm_cmpeq_epi16(colorA, colorB));
+		__m128i	m11  = _mm_and_si128(edge, _mm_cmpeq_epi16(colorB, colorC));
+		__m128i	p00  = _mm_or_si128(_mm_and_si128(m00, colorD), _mm_andnot_si128(m00, colorX));
+		__m128i	p01  = _mm_or_si128(_mm_and_si128(m01, colorC), _mm_andnot_si128(m01, colorX));
+		__m128i	p10  = _mm_or_si128(_mm_and_si128(m10, colorA), _mm_andnot_si128(m10, colorX));
+		__m128i	p11  = _mm_or_si128(_mm_and_si128(m11, colorB), _mm_andnot_si128(m11, colorX));
+
+		_mm_storeu_si128((__m128i *) (dP1 + x),     _mm_unpacklo_epi16(p00, p01));
+		_mm_storeu_si128((__m128i *) (dP1 + x + 4), _mm_unpackhi_epi16(p00, p01));
+		_mm_storeu_si128((__m128i *) (dP2 + x),     _mm_unpacklo_epi16(p10, p11));
+		_mm_storeu_si128((__m128i *) (dP2 + x + 4), _mm_unpackhi_epi16(p10, p11));
+	}
 
-	sP  = (uint16 *) srcPtr;
-	lP  = (uint16 *) (srcPtr + srcRowBytes);
-	dP1 = (uint32 *) dstPtr;
-	dP2 = (uint32 *) (dstPtr + dstRowBytes);
+	return (x - 1);
+}
 
-	// left edge
+S9X_TARGET_AVX2
+static int EPX_Row_AVX2 (const uint16 *uP, const uint16 *sP, const uint16 *lP, uint32 *dP1, uint32 *dP2, int count)
+{
+	const __m256i	ones = _mm256_set1_epi16(-1);
+	int				x;
 
-	colorX = *sP;
-	colorC = *++sP;
-	colorB = *lP++;
+	for (x = 1; x + 16 <= count + 1; x += 16)
+	{
+		__m256i	colorA = _mm256_loadu_si256((const __m256i *) (sP + x - 1));
+		__m256i	colorX = _mm256_loadu_si256((const __m256i *) (sP + x));
+		__m256i	colorC = _mm256_loadu_si256((const __m256i *) (sP + x + 1));
+		__m256i	colorB = _mm256_loadu_si256((const __m256i *) (lP + x));
+		__m256i	colorD = _mm256_loadu_si256((const __m256i *) (uP + x));
+
+		__m256i	edge = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi16(colorA, colorC), _mm256_cmpeq_epi16(colorB, colorD)), ones);
+		__m256i	p00  = _mm256_blendv_epi8(colorX, colorD, _mm256_and_si256(edge, _mm256_cmpeq_epi16(colorD, colorA)));
+		__m256i	p01  = _mm256_blendv_epi8(colorX, colorC, _mm256_and_si256(edge, _mm256_cmpeq_epi16(colorC, colorD)));
+		__m256i	p10  = _mm256_blendv_epi8(colorX, colorA, _mm256_and_si256(edge, _mm256_cmpeq_epi16(colorA, colorB)));
+		__m256i	p11  = _mm256_blendv_epi8(colorX, colorB, _mm256_and_si256(edge, _mm256_cmpeq_epi16(colorB, colorC)));
+
+		// unpack works within 128-bit lanes, put the pixel pairs back in order
+		__m256i	lo1 = _mm256_unpacklo_epi16(p00, p01), hi1 = _mm256_unpackhi_epi16(p00, p01);
+		__m256i	lo2 = _mm256_unpacklo_epi16(p10, p11), hi2 = _mm256_unpackhi_epi16(p10, p11);
+
+		_mm256_storeu_si256((__m256i *) (dP1 + x),     _mm256_permute2x128_si256(lo1, hi1, 0x20));
+		_mm256_storeu_si256((__m256i *) (dP1 + x + 8), _mm256_permute2x128_si256(lo1, hi1, 0x31));
+		_mm256_storeu_si256((__m256i *) (dP2 + x),     _mm256_permute2x128_si256(lo2, hi2, 0x20));
+		_mm256_storeu_si256((__m256i *) (dP2 + x + 8), _mm256_permute2x128_si256(lo2, hi2, 0x31));
+	}
 
-	if ((colorX != colorC) && (colorB != colorX))
+	return (x - 1);
+}
+
+#endif
+
+static EPXRowFunc EPX_SelectRow (void)
+{
+#ifdef S9X_FILTER_SIMD
+	switch (S9xFilterSIMDLevel())
 	{
-	#ifdef MSB_FIRST
-		*dP1 = (colorX << 16) + colorX;
-		*dP2 = (colorX << 16) + ((colorB == colorC) ? colorB : colorX);
-	#else
-		*dP1 = colorX + (colorX << 16);
-		*dP2 = colorX + (((colorB == colorC) ? colorB : colorX) << 16);
-	#endif
+		case S9X_SIMD_AVX2:
+			return (EPX_Row_AVX2);
+
+		case S9X_SIMD_SSE2:
+			return (EPX_Row_SSE2);
 	}
-	else
-		*dP1 = *dP2 = (colorX << 16) + colorX;
+#endif
 
-	dP1++;
-	dP2++;
+	return (EPX_Row_None);
+}
 
-	//
 
-	for (w = width - 2; w; w--)
+void EPX_16_Rows (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, bool8 topEdge, bool8 bottomEdge)
+{
+	uint16	colorX, colorA, colorB, colorC, colorD;
+	uint16	*sP, *uP, *lP;
+	uint32	*dP1, *dP2;
+	int		w, n;
+
+	EPXRowFunc	rowFunc = EPX_SelectRow();
+
+	height -= (topEdge ? 1 : 0) + (bottomEdge ? 1 : 0);
+
+	// top edge
+
+	if (topEdge)
 	{
-		colorA = colorX;
-		colorX = colorC;
+		sP  = (uint16 *) srcPtr;
+		lP  = (uint16 *) (srcPtr + srcRowBytes);
+		dP1 = (uint32 *) dstPtr;
+		dP2 = (uint32 *) (dstPtr + dstRowBytes);
+
+		// left edge
+
+		colorX = *sP;
 		colorC = *++sP;
 		colorB = *lP++;
 
-		if ((colorA != colorC) && (colorB != colorX))
+		if ((colorX != colorC) && (colorB != colorX))
 		{
 		#ifdef MSB_FIRST
 			*dP1 = (colorX << 16) + colorX;
-			*dP2 = (((colorA == colorB) ? colorA : colorX) << 16) + ((colorB == colorC) ? colorB : colorX);
+			*dP2 = (colorX << 16) + ((colorB == colorC) ? colorB : colorX);
 		#else
 			*dP1 = colorX + (colorX << 16);
-			*dP2 = ((colorA == colorB) ? colorA : colorX) + (((colorB == colorC) ? colorB : colorX) << 16);
+			*dP2 = colorX + (((colorB == colorC) ? colorB : colorX) << 16);
 		#endif
 		}
 		else
@@ -246,29 +329,63 @@ void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
 
 		dP1++;
 		dP2++;
-	}
 
-	// right edge
+		//
 
-	colorA = colorX;
-	colorX = colorC;
-	colorB = *lP;
+		n = rowFunc((uint16 *) srcPtr, (uint16 *) srcPtr, (uint16 *) (srcPtr + srcRowBytes), (uint32 *) dstPtr, (uint32 *) (dstPtr + dstRowBytes), width - 2);
+		sP  += n;
+		lP  += n;
+		dP1 += n;
+		dP2 += n;
+		colorX = *(sP - 1);
+		colorC = *sP;
 
-	if ((colorA != colorX) && (colorB != colorX))
-	{
-	#ifdef MSB_FIRST
-		*dP1 = (colorX << 16) + colorX;
-		*dP2 = (((colorA == colorB) ? colorA : colorX) << 16) + colorX;
-	#else
-		*dP1 = colorX + (colorX << 16);
-		*dP2 = ((colorA == colorB) ? colorA : colorX) + (colorX << 16);
-	#endif
-	}
-	else
-		*dP1 = *dP2 = (colorX << 16) + colorX;
+		for (w = width - 2 - n; w; w--)
+		{
+			colorA = colorX;
+			colorX = colorC;
+			colorC = *++sP;
+			colorB = *lP++;
 
-	srcPtr += srcRowBytes;
-	dstPtr += dstRowBytes << 1;
+			if ((colorA != colorC) && (colorB != colorX))
+			{
+			#ifdef MSB_FIRST
+				*dP1 = (colorX << 16) + colorX;
+				*dP2 = (((colorA == colorB) ? colorA : colorX) << 16) + ((colorB == colorC) ? colorB : colorX);
+			#else
+				*dP1 = colorX + (colorX << 16);
+				*dP2 = ((colorA == colorB) ? colorA : colorX) + (((colorB == colorC) ? colorB : colorX) << 16);
+			#endif
+			}
+			else
+				*dP1 = *dP2 = (colorX << 16) + colorX;
+
+			dP1++;
+			dP2++;
+		}
+
+		// right edge
+
+		colorA = colorX;
+		colorX = colorC;
+		colorB = *lP;
+
+		if ((colorA != colorX) && (colorB != colorX))
+		{
+		#ifdef MSB_FIRST
+			*dP1 = (colorX << 16) + colorX;
+			*dP2 = (((colorA == colorB) ? colorA : colorX) << 16) + colorX;
+		#else
+			*dP1 = colorX + (colorX << 16);
+			*dP2 = ((colorA == colorB) ? colorA : colorX) + (colorX << 16);
+		#endif
+		}
+		else
+			*dP1 = *dP2 = (colorX << 16) + colorX;
+
+		srcPtr += srcRowBytes;
+		dstPtr += dstRowBytes << 1;
+	}
 
 	//
 
@@ -305,7 +422,16 @@ void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
 
 		//
 
-		for (w = width - 2; w; w--)
+		n = rowFunc((uint16 *) (srcPtr - srcRowBytes), (uint16 *) srcPtr, (uint16 *) (srcPtr + srcRowBytes), (uint32 *) dstPtr, (uint32 *) (dstPtr + dstRowBytes), width - 2);
+		sP  += n;
+		uP  += n;
+		lP  += n;
+		dP1 += n;
+		dP2 += n;
+		colorX = *(sP - 1);
+		colorC = *sP;
+
+		for (w = width - 2 - n; w; w--)
 		{
 			colorA = colorX;
 			colorX = colorC;
@@ -356,49 +482,26 @@ void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
 
 	// bottom edge
 
-	sP  = (uint16 *) srcPtr;
-	uP  = (uint16 *) (srcPtr - srcRowBytes);
-	dP1 = (uint32 *) dstPtr;
-	dP2 = (uint32 *) (dstPtr + dstRowBytes);
-
-	// left edge
-
-	colorX = *sP;
-	colorC = *++sP;
-	colorD = *uP++;
-
-	if ((colorX != colorC) && (colorX != colorD))
+	if (bottomEdge)
 	{
-	#ifdef MSB_FIRST
-		*dP1 = (colorX << 16) + ((colorC == colorD) ? colorC : colorX);
-		*dP2 = (colorX << 16) + colorX;
-	#else
-		*dP1 = colorX + (((colorC == colorD) ? colorC : colorX) << 16);
-		*dP2 = colorX + (colorX << 16);
-	#endif
-	}
-	else
-		*dP1 = *dP2 = (colorX << 16) + colorX;
-
-	dP1++;
-	dP2++;
+		sP  = (uint16 *) srcPtr;
+		uP  = (uint16 *) (srcPtr - srcRowBytes);
+		dP1 = (uint32 *) dstPtr;
+		dP2 = (uint32 *) (dstPtr + dstRowBytes);
 
-	//
+		// left edge
 
-	for (w = width - 2; w; w--)
-	{
-		colorA = colorX;
-		colorX = colorC;
+		colorX = *sP;
 		colorC = *++sP;
 		colorD = *uP++;
 
-		if ((colorA != colorC) && (colorX != colorD))
+		if ((colorX != colorC) && (colorX != colorD))
 		{
 		#ifdef MSB_FIRST
-			*dP1 = (((colorD == colorA) ? colorD : colorX) << 16) + ((colorC == colorD) ? colorC : colorX);
+			*dP1 = (colorX << 16) + ((colorC == colorD) ? colorC : colorX);
 			*dP2 = (colorX << 16) + colorX;
 		#else
-			*dP1 = ((colorD == colorA) ? colorD : colorX) + (((colorC == colorD) ? colorC : colorX) << 16);
+			*dP1 = colorX + (((colorC == colorD) ? colorC : colorX) << 16);
 			*dP2 = colorX + (colorX << 16);
 		#endif
 		}
@@ -407,24 +510,63 @@ void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
 
 		dP1++;
 		dP2++;
-	}
 
-	// right edge
+		//
 
-	colorA = colorX;
-	colorX = colorC;
-	colorD = *uP;
+		n = rowFunc((uint16 *) (srcPtr - srcRowBytes), (uint16 *) srcPtr, (uint16 *) srcPtr, (uint32 *) dstPtr, (uint32 *) (dstPtr + dstRowBytes), width - 2);
+		sP  += n;
+		uP  += n;
+		dP1 += n;
+		dP2 += n;
+		colorX = *(sP - 1);
+		colorC = *sP;
 
-	if ((colorA != colorX) && (colorX != colorD))
-	{
-	#ifdef MSB_FIRST
-		*dP1 = (((colorD == colorA) ? colorD : colorX) << 16) + colorX;
-		*dP2 = (colorX << 16) + colorX;
-	#else
-		*dP1 = ((colorD == colorA) ? colorD : colorX) + (colorX << 16);
-		*dP2 = colorX + (colorX << 16);
-	#endif
+		for (w = width - 2 - n; w; w--)
+		{
+			colorA = colorX;
+			colorX = colorC;
+			colorC = *++sP;
+			colorD = *uP++;
+
+			if ((colorA != colorC) && (colorX != colorD))
+			{
+			#ifdef MSB_FIRST
+				*dP1 = (((colorD == colorA) ? colorD : colorX) << 16) + ((colorC == colorD) ? colorC : colorX);
+				*dP2 = (colorX << 16) + colorX;
+			#else
+				*dP1 = ((colorD == colorA) ? colorD : colorX) + (((colorC == colorD) ? colorC : colorX) << 16);
+				*dP2 = colorX + (colorX << 16);
+			#endif
+			}
+			else
+				*dP1 = *dP2 = (colorX << 16) + colorX;
+
+			dP1++;
+			dP2++;
+		}
+
+		// right edge
+
+		colorA = colorX;
+		colorX = colorC;
+		colorD = *uP;
+
+		if ((colorA != colorX) && (colorX != colorD))
+		{
+		#ifdef MSB_FIRST
+			*dP1 = (((colorD == colorA) ? colorD : colorX) << 16) + colorX;
+			*dP2 = (colorX << 16) + colorX;
+		#else
+			*dP1 = ((colorD == colorA) ? colorD : colorX) + (colorX << 16);
+			*dP2 = colorX + (colorX << 16);
+		#endif
+		}
+		else
+			*dP1 = *dP2 = (colorX << 16) + colorX;
 	}
-	else
-		*dP1 = *dP2 = (colorX << 16) + colorX;
+}
+
+void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	EPX_16_Rows(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, TRUE, TRUE);
 }
@@ -180,5 +180,6 @@
 #define _epx_h_
 
 void EPX_16 (uint8 *, int, uint8 *, int, int, int);
+void EPX_16_Rows (uint8 *, int, uint8 *, int, int, int, bool8, bool8);
 
 #endif
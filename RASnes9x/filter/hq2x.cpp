@@ -179,6 +179,12 @@
 #include "snes9x.h"
 #include "gfx.h"
 #include "hq2x.h"
+#include "simd.h"
+
+#ifdef S9X_FILTER_SIMD
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
 
 #define	Ymask	0xFF0000
 #define	Umask	0x00FF00
@@ -505,8 +511,23 @@ static uint16	Mask_2 = 0, Mask13 = 0;
 
 static int	*RGBtoYUV = NULL;
 
+// YUV of the rows above, at and below the one being scaled, each starting one
+// pixel left of the row, and the neighbour pattern of every pixel in the row.
+// The rows are rotated as the filter moves down so each source pixel is only
+// looked up once. They live on the caller's stack so that slices of a frame
+// can be scaled at the same time.
+#define HQ_ROW_STRIDE	(MAX_SNES_WIDTH + 2)
+
+struct HQRows
+{
+	int		yuv[HQ_ROW_STRIDE * 3];
+	uint8	pattern[MAX_SNES_WIDTH];
+	int		*up, *cur, *down;
+};
+
 static void InitLUTs (void);
 static inline bool Diff (int, int);
+static bool8 HQPatternRow (HQRows *, uint16 *, uint32, int, bool8);
 
 
 bool8 S9xBlitHQ2xFilterInit (void)
@@ -573,6 +594,185 @@ static inline bool Diff (int c1, int c2)
 	return (false);
 }
 
+// Bit n of a pattern is set when neighbour n (w1-w4, w6-w9) differs from the
+// centre pixel. w != w5 implies nothing extra, equal colours have equal YUV.
+
+typedef void (*HQFillFunc) (const uint16 *, int *, int);
+typedef void (*HQPatternFunc) (const int *, const int *, const int *, uint8 *, int);
+
+static void HQFill_C (const uint16 *sp, int *yuv, int count)
+{
+	for (int x = 0; x < count; x++)
+		yuv[x] = RGBtoYUV[sp[x]];
+}
+
+static void HQPattern_C (const int *up, const int *cur, const int *down, uint8 *pattern, int width)
+{
+	for (int x = 0; x < width; x++)
+	{
+		int		y = cur[x + 1];
+		uint32	p = 0;
+
+		if ((up[x]       != y) && Diff(y, up[x]))       p |= (1 << 0);
+		if ((up[x + 1]   != y) && Diff(y, up[x + 1]))   p |= (1 << 1);
+		if ((up[x + 2]   != y) && Diff(y, up[x + 2]))   p |= (1 << 2);
+		if ((cur[x]      != y) && Diff(y, cur[x]))      p |= (1 << 3);
+		if ((cur[x + 2]  != y) && Diff(y, cur[x + 2]))  p |= (1 << 4);
+		if ((down[x]     != y) && Diff(y, down[x]))     p |= (1 << 5);
+		if ((down[x + 1] != y) && Diff(y, down[x + 1])) p |= (1 << 6);
+		if ((down[x + 2] != y) && Diff(y, down[x + 2])) p |= (1 << 7);
+
+		pattern[x] = p;
+	}
+}
+
+#ifdef S9X_FILTER_SIMD
+
+// Same test as Diff() on four pixels. Y, U and V are one byte each, so the
+// absolute differences come from two saturating subtracts and exceed the
+// thresholds (48, 7, 6) exactly when subtracting the thresholds leaves
+// something.
+#define HQ_DIFF_SSE2(c, n, bit) \
+{ \
+	__m128i	d = _mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(c, n), _mm_subs_epu8(n, c)), limits); \
+	p = _mm_or_si128(p, _mm_andnot_si128(_mm_cmpeq_epi32(d, zero), _mm_set1_epi32(bit))); \
+}
+
+S9X_TARGET_SSE2
+static void HQPattern_SSE2 (const int *up, const int *cur, const int *down, uint8 *pattern, int width)
+{
+	const __m128i	limits = _mm_set1_epi32(trY | trU | trV);
+	const __m128i	zero = _mm_setzero_si128();
+	__m128i			half[2];
+	int				x;
+
+	for (x = 0; x + 8 <= width; x += 8)
+	{
+		for (int h = 0; h < 2; h++)
+		{
+			int		i = x + h * 4;
+			__m128i	c = _mm_loadu_si128((const __m128i *) (cur + i + 1));
+			__m128i	p = _mm_setzero_si128();
+			__m128i	n;
+
+			n = _mm_loadu_si128((const __m128i *) (up + i));       HQ_DIFF_SSE2(c, n, 1 << 0)
+			n = _mm_loadu_si128((const __m128i *) (up + i + 1));   HQ_DIFF_SSE2(c, n, 1 << 1)
+			n = _mm_loadu_si128((const __m128i *) (up + i + 2));   HQ_DIFF_SSE2(c, n, 1 << 2)
+			n = _mm_loadu_si128((const __m128i *) (cur + i));      HQ_DIFF_SSE2(c, n, 1 << 3)
+			n = _mm_loadu_si128((const __m128i *) (cur + i + 2));  HQ_DIFF_SSE2(c, n, 1 << 4)
+			n = _mm_loadu_si128((const __m128i *) (down + i));     HQ_DIFF_SSE2(c, n, 1 << 5)
+			n = _mm_loadu_si128((const __m128i *) (down + i + 1)); HQ_DIFF_SSE2(c, n, 1 << 6)
+			n = _mm_loadu_si128((const __m128i *) (down + i + 2)); HQ_DIFF_SSE2(c, n, 1 << 7)
+
+			half[h] = p;
+		}
+
+		__m128i	words = _mm_packs_epi32(half[0], half[1]);
+		_mm_storel_epi64((__m128i *) (pattern + x), _mm_packus_epi16(words, words));
+	}
+
+	HQPattern_C(up + x, cur + x, down + x, pattern + x, width - x);
+}
+
+#define HQ_DIFF_AVX2(c, n, bit) \
+{ \
+	__m256i	d = _mm256_subs_epu8(_mm256_or_si256(_mm256_subs_epu8(c, n), _mm256_subs_epu8(n, c)), limits); \
+	p = _mm256_or_si256(p, _mm256_andnot_si256(_mm256_cmpeq_epi32(d, zero), _mm256_set1_epi32(bit))); \
+}
+
+S9X_TARGET_AVX2
+static void HQFill_AVX2 (const uint16 *sp, int *yuv, int count)
+{
+	int	x;
+
+	for (x = 0; x + 8 <= count; x += 8)
+	{
+		__m256i	index = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (sp + x)));
+		_mm256_storeu_si256((__m256i *) (yuv + x), _mm256_i32gather_epi32(RGBtoYUV, index, 4));
+	}
+
+	HQFill_C(sp + x, yuv + x, count - x);
+}
+
+S9X_TARGET_AVX2
+static void HQPattern_AVX2 (const int *up, const int *cur, const int *down, uint8 *pattern, int width)
+{
+	const __m256i	limits = _mm256_set1_epi32(trY | trU | trV);
+	const __m256i	zero = _mm256_setzero_si256();
+	int				x;
+
+	for (x = 0; x + 8 <= width; x += 8)
+	{
+		__m256i	c = _mm256_loadu_si256((const __m256i *) (cur + x + 1));
+		__m256i	p = _mm256_setzero_si256();
+		__m256i	n;
+
+		n = _mm256_loadu_si256((const __m256i *) (up + x));       HQ_DIFF_AVX2(c, n, 1 << 0)
+		n = _mm256_loadu_si256((const __m256i *) (up + x + 1));   HQ_DIFF_AVX2(c, n, 1 << 1)
+		n = _mm256_loadu_si256((const __m256i *) (up + x + 2));   HQ_DIFF_AVX2(c, n, 1 << 2)
+		n = _mm256_loadu_si256((const __m256i *) (cur + x));      HQ_DIFF_AVX2(c, n, 1 << 3)
+		n = _mm256_loadu_si256((const __m256i *) (cur + x + 2));  HQ_DIFF_AVX2(c, n, 1 << 4)
+		n = _mm256_loadu_si256((const __m256i *) (down + x));     HQ_DIFF_AVX2(c, n, 1 << 5)
+		n = _mm256_loadu_si256((const __m256i *) (down + x + 1)); HQ_DIFF_AVX2(c, n, 1 << 6)
+		n = _mm256_loadu_si256((const __m256i *) (down + x + 2)); HQ_DIFF_AVX2(c, n, 1 << 7)
+
+		__m128i	words = _mm_packs_epi32(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+		_mm_storel_epi64((__m128i *) (pattern + x), _mm_packus_epi16(words, words));
+	}
+
+	HQPattern_C(up + x, cur + x, down + x, pattern + x, width - x);
+}
+
+#endif
+
+// Fills rows->pattern for the row at sp. firstRow starts a new frame or
+// slice, otherwise sp must be the row after the previous call's.
+static bool8 HQPatternRow (HQRows *rows, uint16 *sp, uint32 src1line, int width, bool8 firstRow)
+{
+	HQFillFunc		fill = HQFill_C;
+	HQPatternFunc	match = HQPattern_C;
+
+#ifdef S9X_FILTER_SIMD
+	switch (S9xFilterSIMDLevel())
+	{
+		case S9X_SIMD_AVX2:
+			fill = HQFill_AVX2;
+			match = HQPattern_AVX2;
+			break;
+
+		case S9X_SIMD_SSE2:
+			match = HQPattern_SSE2;
+			break;
+	}
+#endif
+
+	if (width > MAX_SNES_WIDTH)
+		return (FALSE);
+
+	if (firstRow)
+	{
+		rows->up   = rows->yuv;
+		rows->cur  = rows->yuv + HQ_ROW_STRIDE;
+		rows->down = rows->yuv + HQ_ROW_STRIDE * 2;
+
+		fill(sp - src1line - 1, rows->up, width + 2);
+		fill(sp - 1, rows->cur, width + 2);
+	}
+	else
+	{
+		int	*oldUp = rows->up;
+
+		rows->up   = rows->cur;
+		rows->cur  = rows->down;
+		rows->down = oldUp;
+	}
+
+	fill(sp + src1line - 1, rows->down, width + 2);
+	match(rows->up, rows->cur, rows->down, rows->pattern, width);
+
+	return (TRUE);
+}
+
 void HQ2X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
 {
 	register int	w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -582,10 +782,18 @@ void HQ2X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 	register uint16	*dp = (uint16 *) dstPtr;
 
 	uint32  pattern;
-	int		l, y;
+	uint8	*pp;
+	int		l;
+	bool8	firstRow = TRUE;
+	HQRows	rows;
 
 	while (height--)
 	{
+		if (!HQPatternRow(&rows, sp, src1line, width, firstRow))
+			return;
+		firstRow = FALSE;
+		pp = rows.pattern;
+
 		sp--;
 
 		w1 = *(sp - src1line);
@@ -606,17 +814,7 @@ void HQ2X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 			w6 = *(sp);
 			w9 = *(sp + src1line);
 
-			y = RGBtoYUV[w5];
-			pattern = 0;
-
-			if ((w1 != w5) && (Diff(y, RGBtoYUV[w1]))) pattern |= (1 << 0);
-			if ((w2 != w5) && (Diff(y, RGBtoYUV[w2]))) pattern |= (1 << 1);
-			if ((w3 != w5) && (Diff(y, RGBtoYUV[w3]))) pattern |= (1 << 2);
-			if ((w4 != w5) && (Diff(y, RGBtoYUV[w4]))) pattern |= (1 << 3);
-			if ((w6 != w5) && (Diff(y, RGBtoYUV[w6]))) pattern |= (1 << 4);
-			if ((w7 != w5) && (Diff(y, RGBtoYUV[w7]))) pattern |= (1 << 5);
-			if ((w8 != w5) && (Diff(y, RGBtoYUV[w8]))) pattern |= (1 << 6);
-			if ((w9 != w5) && (Diff(y, RGBtoYUV[w9]))) pattern |= (1 << 7);
+			pattern = *pp++;
 
 			switch (pattern)
 			{
@@ -3281,10 +3479,18 @@ void HQ3X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 	register uint16	*dp = (uint16 *) dstPtr;
 
 	uint32  pattern;
-	int		l, y;
+	uint8	*pp;
+	int		l;
+	bool8	firstRow = TRUE;
+	HQRows	rows;
 
 	while (height--)
 	{
+		if (!HQPatternRow(&rows, sp, src1line, width, firstRow))
+			return;
+		firstRow = FALSE;
+		pp = rows.pattern;
+
 		sp--;
 
 		w1 = *(sp - src1line);
@@ -3305,17 +3511,7 @@ void HQ3X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 			w6 = *(sp);
 			w9 = *(sp + src1line);
 
-			y = RGBtoYUV[w5];
-			pattern = 0;
-
-			if ((w1 != w5) && (Diff(y, RGBtoYUV[w1]))) pattern |= (1 << 0);
-			if ((w2 != w5) && (Diff(y, RGBtoYUV[w2]))) pattern |= (1 << 1);
-			if ((w3 != w5) && (Diff(y, RGBtoYUV[w3]))) pattern |= (1 << 2);
-			if ((w4 != w5) && (Diff(y, RGBtoYUV[w4]))) pattern |= (1 << 3);
-			if ((w6 != w5) && (Diff(y, RGBtoYUV[w6]))) pattern |= (1 << 4);
-			if ((w7 != w5) && (Diff(y, RGBtoYUV[w7]))) pattern |= (1 << 5);
-			if ((w8 != w5) && (Diff(y, RGBtoYUV[w8]))) pattern |= (1 << 6);
-			if ((w9 != w5) && (Diff(y, RGBtoYUV[w9]))) pattern |= (1 << 7);
+			pattern = *pp++;
 
 			switch (pattern)
 			{
@@ -6953,10 +7149,18 @@ void HQ4X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 	register uint16	*dp = (uint16 *) dstPtr;
 
 	uint32  pattern;
-	int		l, y;
+	uint8	*pp;
+	int		l;
+	bool8	firstRow = TRUE;
+	HQRows	rows;
 
 	while (height--)
 	{
+		if (!HQPatternRow(&rows, sp, src1line, width, firstRow))
+			return;
+		firstRow = FALSE;
+		pp = rows.pattern;
+
 		sp--;
 
 		w1 = *(sp - src1line);
@@ -6977,17 +7181,7 @@ void HQ4X_16 (uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, in
 			w6 = *(sp);
 			w9 = *(sp + src1line);
 
-			y = RGBtoYUV[w5];
-			pattern = 0;
-
-			if ((w1 != w5) && (Diff(y, RGBtoYUV[w1]))) pattern |= (1 << 0);
-			if ((w2 != w5) && (Diff(y, RGBtoYUV[w2]))) pattern |= (1 << 1);
-			if ((w3 != w5) && (Diff(y, RGBtoYUV[w3]))) pattern |= (1 << 2);
-			if ((w4 != w5) && (Diff(y, RGBtoYUV[w4]))) pattern |= (1 << 3);
-			if ((w6 != w5) && (Diff(y, RGBtoYUV[w6]))) pattern |= (1 << 4);
-			if ((w7 != w5) && (Diff(y, RGBtoYUV[w7]))) pattern |= (1 << 5);
-			if ((w8 != w5) && (Diff(y, RGBtoYUV[w8]))) pattern |= (1 << 6);
-			if ((w9 != w5) && (Diff(y, RGBtoYUV[w9]))) pattern |= (1 << 7);
+			pattern = *pp++;
 
 			switch (pattern)
 			{
@@ -0,0 +1,424 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+#include "snes9x.h"
+#include "threadpool.h"
+
+#ifdef __WIN32__
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+// The job being run is split into poolCount pieces. Whoever is free takes the
+// next one; the last to finish wakes the caller.
+static int			poolThreads = 1;
+static S9xPoolJob	poolJob = NULL;
+static void			*poolData = NULL;
+static int			poolNext = 0, poolCount = 0, poolPending = 0;
+static volatile bool8	poolQuit = FALSE;
+
+#ifdef __WIN32__
+static HANDLE			workers[S9X_MAX_POOL_THREADS];
+static HANDLE			startSemaphore = NULL, doneEvent = NULL;
+static CRITICAL_SECTION	poolLock;
+static bool8			poolLockReady = FALSE;
+#define LOCK()			EnterCriticalSection(&poolLock)
+#define UNLOCK()		LeaveCriticalSection(&poolLock)
+#define SIGNAL_DONE()	SetEvent(doneEvent)
+#else
+static pthread_t		workers[S9X_MAX_POOL_THREADS];
+static pthread_mutex_t	poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	startCond = PTHREAD_COND_INITIALIZER, doneCond = PTHREAD_COND_INITIALIZER;
+static uint32			poolGeneration = 0;
+#define LOCK()			pthread_mutex_lock(&poolLock)
+#define UNLOCK()		pthread_mutex_unlock(&poolLock)
+#define SIGNAL_DONE()	pthread_cond_signal(&doneCond)
+#endif
+
+
+static void RunJobs (void)
+{
+	for (;;)
+	{
+		LOCK();
+
+		if (poolNext >= poolCount)
+		{
+			UNLOCK();
+			return;
+		}
+
+		int			index = poolNext++;
+		S9xPoolJob	job = poolJob;
+		void		*data = poolData;
+
+		UNLOCK();
+
+		job(data, index);
+
+		LOCK();
+		if (--poolPending == 0)
+			SIGNAL_DONE();
+		UNLOCK();
+	}
+}
+
+#ifdef __WIN32__
+
+static unsigned __stdcall Worker (void *)
+{
+	for (;;)
+	{
+		WaitForSingleObject(startSemaphore, INFINITE);
+		if (poolQuit)
+			break;
+
+		RunJobs();
+	}
+
+	return (0);
+}
+
+static bool8 StartWorker (int i)
+{
+	workers[i] = (HANDLE) _beginthreadex(NULL, 0, Worker, NULL, 0, NULL);
+	return (workers[i] != 0);
+}
+
+#else
+
+static void * Worker (void *)
+{
+	LOCK();
+
+	uint32	seen = poolGeneration;
+
+	for (;;)
+	{
+		while (!poolQuit && poolGeneration == seen)
+			pthread_cond_wait(&startCond, &poolLock);
+		if (poolQuit)
+			break;
+
+		seen = poolGeneration;
+		UNLOCK();
+
+		RunJobs();
+
+		LOCK();
+	}
+
+	UNLOCK();
+
+	return (NULL);
+}
+
+static bool8 StartWorker (int i)
+{
+	return (pthread_create(&workers[i], NULL, Worker, NULL) == 0);
+}
+
+#endif
+
+// threads counts the caller, so 1 (or less) runs every job inline.
+// Returns FALSE if not all of the workers could be started; the pool then
+// runs with the ones that were.
+bool8 S9xThreadPoolInit (int threads)
+{
+	S9xThreadPoolDeinit();
+
+	if (threads > S9X_MAX_POOL_THREADS)
+		threads = S9X_MAX_POOL_THREADS;
+	if (threads <= 1)
+		return (TRUE);
+
+#ifdef __WIN32__
+	if (!poolLockReady)
+	{
+		InitializeCriticalSection(&poolLock);
+		poolLockReady = TRUE;
+	}
+
+	startSemaphore = CreateSemaphore(NULL, 0, 0x7fff, NULL);
+	doneEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (!startSemaphore || !doneEvent)
+	{
+		S9xThreadPoolDeinit();
+		return (FALSE);
+	}
+#endif
+
+	poolQuit = FALSE;
+
+	for (int i = 0; i < threads - 1; i++)
+	{
+		if (!StartWorker(i))
+			break;
+
+		poolThreads++;
+	}
+
+	return (poolThreads == threads);
+}
+
+void S9xThreadPoolDeinit (void)
+{
+	int	running = poolThreads - 1;
+
+	if (running > 0)
+	{
+		LOCK();
+		poolQuit = TRUE;
+	#ifndef __WIN32__
+		pthread_cond_broadcast(&startCond);
+	#endif
+		UNLOCK();
+
+	#ifdef __WIN32__
+		ReleaseSemaphore(startSemaphore, running, NULL);
+		WaitForMultipleObjects(running, workers, TRUE, INFINITE);
+		for (int i = 0; i < running; i++)
+			CloseHandle(workers[i]);
+	#else
+		for (int i = 0; i < running; i++)
+			pthread_join(workers[i], NULL);
+	#endif
+	}
+
+#ifdef __WIN32__
+	if (startSemaphore)
+	{
+		CloseHandle(startSemaphore);
+		startSemaphore = NULL;
+	}
+
+	if (doneEvent)
+	{
+		CloseHandle(doneEvent);
+		doneEvent = NULL;
+	}
+#endif
+
+	poolThreads = 1;
+}
+
+int S9xThreadPoolThreads (void)
+{
+	return (poolThreads);
+}
+
+// Calls job(data, i) for every i below count, spread over the pool, and
+// returns once all of them have.
+void S9xThreadPoolRun (S9xPoolJob job, void *data, int count)
+{
+	if (poolThreads <= 1 || count <= 1)
+	{
+		for (int i = 0; i < count; i++)
+			job(data, i);
+		return;
+	}
+
+	LOCK();
+	poolJob = job;
+	poolData = data;
+	poolNext = 0;
+	poolCount = count;
+	poolPending = count;
+#ifdef __WIN32__
+	ResetEvent(doneEvent);
+	UNLOCK();
+	ReleaseSemaphore(startSemaphore, poolThreads - 1, NULL);
+#else
+	poolGeneration++;
+	pthread_cond_broadcast(&startCond);
+	UNLOCK();
+#endif
+
+	RunJobs();
+
+#ifdef __WIN32__
+	WaitForSingleObject(doneEvent, INFINITE);
+#else
+	LOCK();
+	while (poolPending)
+		pthread_cond_wait(&doneCond, &poolLock);
+	UNLOCK();
+#endif
+}
@@ -180,6 +180,7 @@
 #include "memmap.h"
 #include "fxinst.h"
 #include "fxemu.h"
+#include "profile.h"
 
 static void FxReset (struct FxInfo_s *);
 static void fx_readRegisterSpace (void);
@@ -313,6 +314,8 @@ uint8 S9xGetSuperFX (uint16 address)
 
 void S9xSuperFXExec (void)
 {
+	PROFILE_SECTION(PROFILE_CHIPS);
+
 	if ((Memory.FillRAM[0x3000 + GSU_SFR] & FLG_G) && (Memory.FillRAM[0x3000 + GSU_SCMR] & 0x18) == 0x18)
 	{
 		FxEmulate((Memory.FillRAM[0x3000 + GSU_CLSR] & 1) ? SuperFX.speedPerLine * 2 : SuperFX.speedPerLine);
@@ -186,6 +186,7 @@
 #include "screenshot.h"
 #include "font.h"
 #include "display.h"
+#include "profile.h"
 
 extern struct SCheatData		Cheat;
 extern struct SLineData			LineData[240];
@@ -406,6 +407,8 @@ void S9xStartScreenRefresh (void)
 
 void S9xEndScreenRefresh (void)
 {
+	PROFILE_SECTION(PROFILE_PPU);
+
 	if (IPPU.RenderThisFrame)
 	{
 		FLUSH_REDRAW();
@@ -645,6 +648,8 @@ static inline void RenderScreen (bool8 sub)
 
 void S9xUpdateScreen (void)
 {
+	PROFILE_SECTION(PROFILE_PPU);
+
 	if (IPPU.OBJChanged || IPPU.InterlaceOBJ)
 		SetupOBJ();
 
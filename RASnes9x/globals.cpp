@@ -184,6 +184,7 @@
 #include "fxemu.h"
 #include "srtc.h"
 #include "cheats.h"
+#include "profile.h"
 #ifdef NETPLAY_SUPPORT
 #include "netplay.h"
 #endif
@@ -239,6 +240,8 @@ uint8	*HDMAMemPointers[8];
 uint16	BlackColourMap[256];
 uint16	DirectColourMaps[8][256];
 
+volatile int	S9xProfileSection = PROFILE_OTHER;
+
 SnesModel	M1SNES = { 1, 3, 2 };
 SnesModel	M2SNES = { 2, 4, 3 };
 SnesModel	*Model = &M1SNES;
@@ -178,10 +178,13 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profile.h"
 
 
 uint8 S9xGetOBC1 (uint16 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	switch (Address)
 	{
 		case 0x7ff0:
@@ -205,6 +208,8 @@ uint8 S9xGetOBC1 (uint16 Address)
 
 void S9xSetOBC1 (uint8 Byte, uint16 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	switch (Address)
 	{
 		case 0x7ff0:
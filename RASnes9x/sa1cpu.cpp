@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profile.h"
 
 #define CPU								SA1
 #define ICPU							SA1
@@ -231,6 +232,8 @@ static void S9xSA1UpdateTimer (void);
 
 void S9xSA1MainLoop (void)
 {
+	PROFILE_SECTION(PROFILE_CHIPS);
+
 	if (Memory.FillRAM[0x2200] & 0x60)
 	{
 		SA1.Cycles += 6; // FIXME
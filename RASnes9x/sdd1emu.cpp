@@ -192,6 +192,7 @@
 
 #include "port.h"
 #include "sdd1emu.h"
+#include "profile.h"
 
 static int valid_bits;
 static uint16 in_stream;
@@ -319,6 +320,8 @@ static inline uint8 GetBit(uint8 cur_bitplane){
 }
 
 void SDD1_decompress(uint8 *out, uint8 *in, int len){
+    PROFILE_SECTION(PROFILE_CHIPS);
+
     uint8 bit, i, plane;
     uint8 byte1, byte2;
 
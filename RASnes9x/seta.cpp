@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "seta.h"
+#include "profile.h"
 
 uint8	(*GetSETA) (uint32)        = &S9xGetST010;
 void	(*SetSETA) (uint32, uint8) = &S9xSetST010;
@@ -185,10 +186,14 @@ void	(*SetSETA) (uint32, uint8) = &S9xSetST010;
 
 uint8 S9xGetSetaDSP (uint32 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	return (GetSETA(Address));
 }
 
 void S9xSetSetaDSP (uint8 Byte, uint32 Address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	SetSETA (Address, Byte);
 }
@@ -1150,6 +1150,22 @@ static void UnfreezeStructFromCopy (void *, FreezeData *, int, uint8 *, int);
 static void FreezeBlock (STREAM, const char *, uint8 *, int);
 static void FreezeStruct (STREAM, const char *, void *, FreezeData *, int);
 
+enum
+{
+	FAST_SIZE,
+	FAST_SAVE,
+	FAST_LOAD
+};
+
+struct FastStream
+{
+	int		mode;
+	uint8	*buf;
+	uint32	pos;
+};
+
+static void FastSnapshot (FastStream *, struct SDMASnapshot *, struct SControlSnapshot *);
+
 
 void S9xResetSaveTimer (bool8 dontsave)
 {
@@ -1211,12 +1227,129 @@ bool8 S9xFreezeGame (const char *filename)
 
 int S9xUnfreezeGameMem (const uint8 *buf, uint32 bufSize)
 {
+	if (bufSize >= strlen(FAST_SNAPSHOT_MAGIC) && memcmp(buf, FAST_SNAPSHOT_MAGIC, strlen(FAST_SNAPSHOT_MAGIC)) == 0)
+		return (S9xUnfreezeGameMemFast(buf, bufSize));
+
     memStream stream(buf, bufSize);
 	int result = S9xUnfreezeFromStream(&stream);
 
 	return result;
 }
 
+// Fast in-memory snapshots: a fixed binary layout in native byte order with
+// no block headers, written straight into the caller's buffer. Only valid
+// within the running session, and movie data / screenshots are not included.
+
+uint32 S9xFreezeSizeFast (void)
+{
+	FastStream	stream = { FAST_SIZE, NULL, 0 };
+	FastSnapshot(&stream, NULL, NULL);
+
+	return (stream.pos);
+}
+
+bool8 S9xFreezeGameMemFast (uint8 *buf, uint32 bufSize)
+{
+	if (bufSize < S9xFreezeSizeFast())
+		return (FALSE);
+
+	struct SDMASnapshot		dma_snap;
+	struct SControlSnapshot	ctl_snap;
+
+	for (int d = 0; d < 8; d++)
+		dma_snap.dma[d] = DMA[d];
+	S9xControlPreSaveState(&ctl_snap);
+
+	if (Settings.SuperFX)
+		GSU.avRegAddr = (uint8 *) &GSU.avReg;
+	if (Settings.SA1)
+		S9xSA1PackStatus();
+	if (Settings.SPC7110)
+		S9xSPC7110PreSaveState();
+	if (Settings.SRTC)
+		S9xSRTCPreSaveState();
+
+	FastStream	stream = { FAST_SAVE, buf, 0 };
+	FastSnapshot(&stream, &dma_snap, &ctl_snap);
+
+	return (TRUE);
+}
+
+int S9xUnfreezeGameMemFast (const uint8 *buf, uint32 bufSize)
+{
+	uint32	size = S9xFreezeSizeFast();
+
+	if (bufSize < size || memcmp(buf, FAST_SNAPSHOT_MAGIC, strlen(FAST_SNAPSHOT_MAGIC)) != 0)
+		return (WRONG_FORMAT);
+
+	uint32	stored_size;
+	memcpy(&stored_size, buf + strlen(FAST_SNAPSHOT_MAGIC), sizeof(stored_size));
+	if (stored_size != size)
+		return (WRONG_FORMAT);
+
+	uint32 old_flags     = CPU.Flags;
+	uint32 sa1_old_flags = SA1.Flags;
+
+	struct SDMASnapshot		dma_snap;
+	struct SControlSnapshot	ctl_snap;
+
+	// nothing here touches the sound output, and the oops snapshot must not
+	// fire from a rewind or run-ahead restore
+	S9xResetHardware();
+
+	FastStream	stream = { FAST_LOAD, (uint8 *) buf, 0 };
+	FastSnapshot(&stream, &dma_snap, &ctl_snap);
+
+	CPU.Flags |= old_flags & (DEBUG_MODE_FLAG | TRACE_FLAG | SINGLE_STEP_FLAG | FRAME_ADVANCE_FLAG);
+	ICPU.ShiftedPB = Registers.PB << 16;
+	ICPU.ShiftedDB = Registers.DB << 16;
+	S9xSetPCBase(Registers.PBPC);
+	S9xUnpackStatus();
+	S9xFixCycles();
+
+	for (int d = 0; d < 8; d++)
+		DMA[d] = dma_snap.dma[d];
+	CPU.InDMA = CPU.InHDMA = FALSE;
+	CPU.InDMAorHDMA = CPU.InWRAMDMAorHDMA = FALSE;
+	CPU.HDMARanInDMA = 0;
+
+	S9xFixColourBrightness();
+	IPPU.ColorsChanged = TRUE;
+	IPPU.OBJChanged = TRUE;
+	IPPU.RenderThisFrame = TRUE;
+
+	uint8 hdma_byte = Memory.FillRAM[0x420c];
+	S9xSetCPU(hdma_byte, 0x420c);
+
+	S9xControlPostLoadState(&ctl_snap);
+
+	if (Settings.SuperFX)
+	{
+		GSU.pfPlot = fx_PlotTable[GSU.vMode];
+		GSU.pfRpix = fx_PlotTable[GSU.vMode + 5];
+	}
+
+	if (Settings.SA1)
+	{
+		SA1.Flags |= sa1_old_flags & TRACE_FLAG;
+		S9xSA1PostLoadState();
+	}
+
+	if (Settings.SDD1)
+		S9xSDD1PostLoadState();
+
+	if (Settings.SPC7110)
+		S9xSPC7110PostLoadState(SNAPSHOT_VERSION);
+
+	if (Settings.SRTC)
+		S9xSRTCPostLoadState(SNAPSHOT_VERSION);
+
+	if (Settings.BS)
+		S9xBSXPostLoadState();
+
+	return (SUCCESS);
+}
+
 bool8 S9xUnfreezeGame (const char *filename)
 {
 	STREAM	stream = NULL;
@@ -1292,7 +1425,7 @@ bool8 S9xUnfreezeGame (const char *filename)
 void S9xFreezeToStream (STREAM stream)
 {
 	char	buffer[1024];
-	uint8	*soundsnapshot = new uint8[SPC_SAVE_STATE_BLOCK_SIZE];
+	uint8	*soundsnapshot = new uint8[SPC_SAVE_STATE_BLOCK_SIZE](); // the APU leaves the end of the block unused
 
 	S9xSetSoundMute(TRUE);
 
@@ -2304,3 +2437,144 @@ static void UnfreezeStructFromCopy (void *sbase, FreezeData *fields, int num_fie
 		}
 	}
 }
+
+static void FastBlock (FastStream *stream, uint8 *block, int size)
+{
+	switch (stream->mode)
+	{
+		case FAST_SAVE:
+			memcpy(stream->buf + stream->pos, block, size);
+			break;
+
+		case FAST_LOAD:
+			memcpy(block, stream->buf + stream->pos, size);
+			break;
+	}
+
+	stream->pos += size;
+}
+
+static void FastStruct (FastStream *stream, void *base, FreezeData *fields, int num_fields)
+{
+	for (int i = 0; i < num_fields; i++)
+	{
+		if (SNAPSHOT_VERSION >= fields[i].deleted_in || SNAPSHOT_VERSION < fields[i].debuted_in)
+			continue;
+
+		uint8	*addr = (uint8 *) base + fields[i].offset;
+		int		size = FreezeSize(fields[i].size, fields[i].type);
+
+		if (stream->mode == FAST_SIZE)
+		{
+			stream->pos += size;
+			continue;
+		}
+
+		if (fields[i].type == uint8_INDIR_ARRAY_V || fields[i].type == uint16_INDIR_ARRAY_V || fields[i].type == uint32_INDIR_ARRAY_V)
+			addr = (uint8 *) (*((pint *) addr));
+
+		if (fields[i].type == POINTER_V)
+		{
+			// pointers are stored relative to another field, as in the stream format
+			uint8	*relativeTo = (uint8 *) *((pint *) ((uint8 *) base + fields[i].offset2));
+			int		relativeAddr;
+
+			if (stream->mode == FAST_SAVE)
+			{
+				relativeAddr = (int) ((uint8 *) *((pint *) addr) - relativeTo);
+				memcpy(stream->buf + stream->pos, &relativeAddr, sizeof(relativeAddr));
+			}
+			else
+			{
+				memcpy(&relativeAddr, stream->buf + stream->pos, sizeof(relativeAddr));
+				*((pint *) addr) = (pint) (relativeTo + relativeAddr);
+			}
+		}
+		else
+		if (stream->mode == FAST_SAVE)
+			memcpy(stream->buf + stream->pos, addr, size);
+		else
+			memcpy(addr, stream->buf + stream->pos, size);
+
+		stream->pos += size;
+	}
+}
+
+static void FastSnapshot (FastStream *stream, struct SDMASnapshot *dma_snap, struct SControlSnapshot *ctl_snap)
+{
+	uint32	size = 0;
+
+	if (stream->mode != FAST_SIZE)
+	{
+		size = S9xFreezeSizeFast();
+		if (stream->mode == FAST_SAVE)
+		{
+			memcpy(stream->buf + stream->pos, FAST_SNAPSHOT_MAGIC, strlen(FAST_SNAPSHOT_MAGIC));
+			memcpy(stream->buf + stream->pos + strlen(FAST_SNAPSHOT_MAGIC), &size, sizeof(size));
+		}
+	}
+	stream->pos += strlen(FAST_SNAPSHOT_MAGIC) + sizeof(size);
+
+	FastStruct(stream, &CPU, SnapCPU, COUNT(SnapCPU));
+	FastStruct(stream, &Registers, SnapRegisters, COUNT(SnapRegisters));
+	FastStruct(stream, &PPU, SnapPPU, COUNT(SnapPPU));
+	FastStruct(stream, dma_snap, SnapDMA, COUNT(SnapDMA));
+
+	FastBlock(stream, Memory.VRAM, 0x10000);
+	FastBlock(stream, Memory.RAM, 0x20000);
+	FastBlock(stream, Memory.SRAM, 0x20000);
+	FastBlock(stream, Memory.FillRAM, 0x8000);
+
+	// the APU serializes itself directly into/out of the snapshot buffer
+	if (stream->mode == FAST_SAVE)
+		S9xAPUSaveState(stream->buf + stream->pos);
+	else
+	if (stream->mode == FAST_LOAD)
+		S9xAPULoadState(stream->buf + stream->pos);
+	stream->pos += SPC_SAVE_STATE_BLOCK_SIZE;
+
+	FastStruct(stream, ctl_snap, SnapControls, COUNT(SnapControls));
+	FastStruct(stream, &Timings, SnapTimings, COUNT(SnapTimings));
+
+	if (Settings.SuperFX)
+		FastStruct(stream, &GSU, SnapFX, COUNT(SnapFX));
+
+	if (Settings.SA1)
+	{
+		FastStruct(stream, &SA1, SnapSA1, COUNT(SnapSA1));
+		FastStruct(stream, &SA1Registers, SnapSA1Registers, COUNT(SnapSA1Registers));
+	}
+
+	if (Settings.DSP == 1)
+		FastStruct(stream, &DSP1, SnapDSP1, COUNT(SnapDSP1));
+
+	if (Settings.DSP == 2)
+		FastStruct(stream, &DSP2, SnapDSP2, COUNT(SnapDSP2));
+
+	if (Settings.DSP == 4)
+		FastStruct(stream, &DSP4, SnapDSP4, COUNT(SnapDSP4));
+
+	if (Settings.C4)
+		FastBlock(stream, Memory.C4RAM, 8192);
+
+	if (Settings.SETA == ST_010)
+		FastStruct(stream, &ST010, SnapST010, COUNT(SnapST010));
+
+	if (Settings.OBC1)
+	{
+		FastStruct(stream, &OBC1, SnapOBC1, COUNT(SnapOBC1));
+		FastBlock(stream, Memory.OBC1RAM, 8192);
+	}
+
+	if (Settings.SPC7110)
+		FastStruct(stream, &s7snap, SnapSPC7110Snap, COUNT(SnapSPC7110Snap));
+
+	if (Settings.SRTC)
+		FastStruct(stream, &srtcsnap, SnapSRTCSnap, COUNT(SnapSRTCSnap));
+
+	if (Settings.SRTC || Settings.SPC7110RTC)
+		FastBlock(stream, RTCData.reg, 20);
+
+	if (Settings.BS)
+		FastStruct(stream, &BSX, SnapBSX, COUNT(SnapBSX));
+}
@@ -180,6 +180,7 @@
 #define _SNAPSHOT_H_
 
 #define SNAPSHOT_MAGIC			"#!s9xsnp"
+#define FAST_SNAPSHOT_MAGIC		"#!s9xfst"
 #define SNAPSHOT_VERSION_IRQ    7
 #define SNAPSHOT_VERSION_BAPU   8
 #define SNAPSHOT_VERSION		8
@@ -198,6 +199,9 @@ uint32 S9xFreezeSize (void);
 bool8 S9xFreezeGameMem (uint8 *,uint32);
 bool8 S9xUnfreezeGame (const char *);
 int S9xUnfreezeGameMem (const uint8 *,uint32);
+uint32 S9xFreezeSizeFast (void);
+bool8 S9xFreezeGameMemFast (uint8 *,uint32);
+int S9xUnfreezeGameMemFast (const uint8 *,uint32);
 void S9xFreezeToStream (STREAM);
 int	 S9xUnfreezeFromStream (STREAM);
 
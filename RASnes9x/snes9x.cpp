@@ -424,6 +424,7 @@ void S9xLoadConfigFiles (char **argv, int argc)
 	Settings.BSXBootup                  =  conf.GetBool("Settings::BSXBootup",                 false);
 	Settings.TurboMode                  =  conf.GetBool("Settings::TurboMode",                 false);
 	Settings.TurboSkipFrames            =  conf.GetUInt("Settings::TurboFrameSkip",            15);
+	Settings.RunAheadFrames             =  conf.GetUInt("Settings::RunAheadFrames",            0);
 	Settings.MovieTruncate              =  conf.GetBool("Settings::MovieTruncateAtEnd",        false);
 	Settings.MovieNotifyIgnored         =  conf.GetBool("Settings::MovieNotifyIgnored",        false);
 	Settings.WrongMovieStateProtection  =  conf.GetBool("Settings::WrongMovieStateProtection", true);
@@ -592,6 +593,7 @@ void S9xUsage (void)
 	// OTHER OPTIONS
 	S9xMessage(S9X_INFO, S9X_USAGE, "-frameskip <num>                Screen update frame skip rate");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-frametime <num>                Milliseconds per frame for frameskip auto-adjust");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-runahead <num>                 Frames to run ahead to hide input lag (0 = off)");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-upanddown                      Override protection from pressing left+right or");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                up+down together");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-conf <filename>                Use specified conf file (after standard files)");
@@ -880,6 +882,14 @@ char * S9xParseArgs (char **argv, int argc)
 					S9xUsage();
 			}
 			else
+			if (!strcasecmp(argv[i], "-runahead"))
+			{
+				if (i + 1 < argc)
+					Settings.RunAheadFrames = atoi(argv[++i]);
+				else
+					S9xUsage();
+			}
+			else
 			if (!strcasecmp(argv[i], "-upanddown"))
 				Settings.UpAndDown = TRUE;
 			else
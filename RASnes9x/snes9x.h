@@ -425,6 +425,7 @@ struct SSettings
 	bool8	TurboMode;
 	uint32	HighSpeedSeek;
 	bool8	FrameAdvance;
+	uint32	RunAheadFrames;
 
 	bool8	NetPlay;
 	bool8	NetPlayServer;
@@ -199,6 +199,7 @@
 #include "memmap.h"
 #include "srtc.h"
 #include "display.h"
+#include "profile.h"
 
 #define memory_cartrom_size()		Memory.CalculatedSize
 #define memory_cartrom_read(a)		Memory.ROM[(a)]
@@ -302,6 +303,8 @@ uint8 S9xGetSPC7110Byte (uint32 address)
 
 uint8 S9xGetSPC7110 (uint16 address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	if (!Settings.SPC7110RTC && address > 0x483f)
 		return (OpenBus);
 	
@@ -310,6 +313,8 @@ uint8 S9xGetSPC7110 (uint16 address)
 
 void S9xSetSPC7110 (uint8 byte, uint16 address)
 {
+	PROFILE_ACCESS(PROFILE_CHIPS);
+
 	if (!Settings.SPC7110RTC && address > 0x483f)
 		return;
 
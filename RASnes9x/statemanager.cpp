@@ -1,71 +1,120 @@
 #include "statemanager.h"
 #include "snapshot.h"
+#include "movie.h"
+
+#include <chrono>
 
 /*  State Manager Class that records snapshot data for rewinding
     mostly based on SSNES's rewind code by Themaister
 */
 
-static inline size_t nearest_pow2_size(size_t v)
+static inline uint64_t elapsed_usec(std::chrono::high_resolution_clock::time_point start)
 {
-   size_t orig = v;
-   v--;
-   v |= v >> 1;
-   v |= v >> 2;
-   v |= v >> 4;
-#if SIZE_MAX >= 0xffff
-      v |= v >> 8;
-#endif
-#if SIZE_MAX >= 0xffffffff
-      v |= v >> 16;
-#endif
-#if SIZE_MAX >= 0xffffffffffffffff
-      v |= v >> 32;
-#endif
-   v++;
-
-   size_t next = v;
-   size_t prev = v >> 1;
-
-   if ((next - orig) < (orig - prev))
-      return next;
-   else
-      return prev;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
 }
 
-void StateManager::deallocate() {
-    if(buffer) {
-        delete [] buffer;
-        buffer = NULL;
-    }
-    if(tmp_state) {
-        delete [] tmp_state;
-        tmp_state = NULL;
+/*  Delta encoding: the XOR of two consecutive states is mostly zero, so it is
+    stored as a sequence of (zero word count, literal word count, literals...).
+    A single matching word inside a literal run is kept as a literal to avoid
+    splitting the run for a two word token.
+*/
+static void encode_delta(const uint32_t *old_state, const uint32_t *new_state, size_t size, std::vector<uint32_t> &out)
+{
+    out.clear();
+
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t zero_start = i;
+        while (i < size && old_state[i] == new_state[i])
+            i++;
+
+        size_t literal_start = i;
+        while (i < size && (old_state[i] != new_state[i] || (i + 1 < size && old_state[i + 1] != new_state[i + 1])))
+            i++;
+
+        out.push_back((uint32_t)(literal_start - zero_start));
+        out.push_back((uint32_t)(i - literal_start));
+        for (size_t j = literal_start; j < i; j++)
+            out.push_back(old_state[j] ^ new_state[j]);
     }
-    if(in_state) {
-        delete [] in_state;
-        in_state = NULL;
+}
+
+// XORing a delta into either endpoint yields the other one.
+static void apply_delta(const std::vector<uint32_t> &delta, uint32_t *state)
+{
+    size_t pos = 0;
+    size_t i = 0;
+    while (pos < delta.size())
+    {
+        i += delta[pos++];
+        uint32_t count = delta[pos++];
+        while (count--)
+            state[i++] ^= delta[pos++];
     }
 }
 
+void StateManager::deallocate() {
+    history.clear();
+    history_bytes = 0;
+    top_state.clear();
+    slots.clear();
+    pending.clear();
+    free_slots.clear();
+    scratch.clear();
+    has_top = false;
+}
+
 StateManager::StateManager()
 {
-    buffer = NULL;
-    tmp_state = NULL;
-    in_state = NULL;
+    history_bytes = 0;
+    max_bytes = 0;
+    max_states = 0;
+    quit = false;
+    busy = false;
+    has_top = false;
+    state_size = 0;
+    real_state_size = 0;
     init_done = false;
+    first_pop = false;
+    push_count = push_usec = 0;
+    pop_count = pop_usec = 0;
+    encoded_count = encoded_bytes = 0;
+    dropped = 0;
 }
 
 StateManager::~StateManager() {
+    stop_worker();
     deallocate();
 }
 
-bool StateManager::init(size_t buffer_size) {
+void StateManager::stop_worker()
+{
+    if (!worker.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+    }
+    work_cond.notify_one();
+    worker.join();
+    quit = false;
+}
+
+bool StateManager::init(size_t buffer_size, size_t depth) {
 
     init_done = false;
 
+    stop_worker();
     deallocate();
 
+    // movies need the stream format (it carries the input log), everything else
+    // uses the header-less fast format; S9xUnfreezeGameMem tells them apart
     real_state_size = S9xFreezeSize();
+    if (S9xFreezeSizeFast() > real_state_size)
+        real_state_size = S9xFreezeSizeFast();
     state_size = real_state_size / sizeof(uint32_t); // Works in multiple of 4.
 
     // We need 4-byte aligned state_size to avoid having to enforce this with unneeded memcpy's!
@@ -74,118 +123,200 @@ bool StateManager::init(size_t buffer_size) {
     if (buffer_size <= real_state_size) // Need a sufficient buffer size.
         return false;
 
-    top_ptr = 1;
+    max_bytes = buffer_size - real_state_size;
+    max_states = depth;
 
-    
-    buf_size = nearest_pow2_size(buffer_size) / sizeof(uint64_t); // Works in multiple of 8.
-    buf_size_mask = buf_size - 1;
+    top_state.assign(state_size, 0);
+    slots.resize(QUEUE_SLOTS);
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        slots[i].assign(state_size, 0);
+        free_slots.push_back(i);
+    }
+    scratch.reserve(state_size * 2 + 2);
 
-    if (!(buffer = new uint64_t[buf_size]))
-        return false;
-    if (!(tmp_state = new uint32_t[state_size]))
-       return false;
-    if (!(in_state = new uint32_t[state_size]))
-       return false;
+    first_pop = false;
+    push_count = push_usec = 0;
+    pop_count = pop_usec = 0;
+    encoded_count = encoded_bytes = 0;
+    dropped = 0;
 
-    memset(tmp_state,0,state_size * sizeof(uint32_t));
-    memset(in_state,0,state_size * sizeof(uint32_t));
+    worker = std::thread(&StateManager::worker_main, this);
 
     init_done = true;
 
     return true;
 }
 
-int StateManager::pop()
-{ 
-    if(!init_done)
-        return 0;
+void StateManager::worker_main()
+{
+    std::unique_lock<std::mutex> guard(lock);
 
-    if (first_pop)
+    for (;;)
     {
-      first_pop = false;
-      return S9xUnfreezeGameMem((uint8 *)tmp_state,real_state_size);
+        while (!quit && pending.empty())
+            work_cond.wait(guard);
+        if (quit)
+            break;
+
+        size_t slot = pending.front();
+        pending.pop_front();
+        busy = true;
+
+        guard.unlock();
+        Delta delta;
+        bool encoded = store(slots[slot], delta);
+        guard.lock();
+
+        // the history is read by pop() and get_stats(), so it only changes under the lock
+        if (encoded)
+            add_delta(delta);
+
+        free_slots.push_back(slot);
+        busy = false;
+        if (pending.empty())
+            idle_cond.notify_all();
     }
+}
 
-    top_ptr = (top_ptr - 1) & buf_size_mask;
-
-    if (top_ptr == bottom_ptr) // Our stack is completely empty... :v
+// Runs on the worker thread without the lock; swaps the new snapshot into
+// top_state and returns false if there was no previous one to delta against.
+bool StateManager::store(std::vector<uint32_t> &state, Delta &delta)
+{
+    bool encoded = has_top;
+    if (encoded)
     {
-      top_ptr = (top_ptr + 1) & buf_size_mask;
-      return 0;
+        encode_delta(top_state.data(), state.data(), state_size, scratch);
+        delta.assign(scratch.begin(), scratch.end());
     }
+    top_state.swap(state);
+    has_top = true;
 
-    while (buffer[top_ptr])
-    {
-      // Apply the xor patch.
-      uint32_t addr = buffer[top_ptr] >> 32;
-      uint32_t xor_ = buffer[top_ptr] & 0xFFFFFFFFU;
-      tmp_state[addr] ^= xor_;
+    return encoded;
+}
 
-      top_ptr = (top_ptr - 1) & buf_size_mask;
-    }
+// Called with the lock held.
+void StateManager::add_delta(Delta &delta)
+{
+    size_t bytes = delta.size() * sizeof(uint32_t);
+
+    history.push_back(Delta());
+    history.back().swap(delta);
+    history_bytes += bytes;
+    encoded_count++;
+    encoded_bytes += bytes;
 
-    if (top_ptr == bottom_ptr) // Our stack is completely empty... :v
+    trim();
+}
+
+void StateManager::trim()
+{
+    while (!history.empty() && (history_bytes > max_bytes || (max_states && history.size() > max_states)))
     {
-      top_ptr = (top_ptr + 1) & buf_size_mask; 
+        history_bytes -= history.front().size() * sizeof(uint32_t);
+        history.pop_front();
     }
-
-    return S9xUnfreezeGameMem((uint8 *)tmp_state,real_state_size);
 }
 
-void StateManager::reassign_bottom()
+void StateManager::wait_idle(std::unique_lock<std::mutex> &guard)
 {
-   bottom_ptr = (top_ptr + 1) & buf_size_mask;
-   while (buffer[bottom_ptr]) // Skip ahead until we find the first 0 (boundary for state delta).
-      bottom_ptr = (bottom_ptr + 1) & buf_size_mask;
+    while (busy || !pending.empty())
+        idle_cond.wait(guard);
 }
 
-void StateManager::generate_delta(const void *data)
+int StateManager::pop()
 {
-   bool crossed = false;
-   const uint32_t *old_state = tmp_state;
-   const uint32_t *new_state = (const uint32_t*)data;
+    if(!init_done)
+        return 0;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-   buffer[top_ptr++] = 0; // For each separate delta, we have a 0 value sentinel in between.
-   top_ptr &= buf_size_mask;
+    std::unique_lock<std::mutex> guard(lock);
+    wait_idle(guard);
 
-   // Check if top_ptr and bottom_ptr crossed each other, which means we need to delete old cruft.
-   if (top_ptr == bottom_ptr)
-      crossed = true;
+    if (!has_top)
+        return 0;
+
+    if (first_pop)
+    {
+        first_pop = false;
+    }
+    else
+    {
+        if (history.empty()) // Our stack is completely empty... :v
+            return 0;
 
-   for (uint64_t i = 0; i < state_size; i++)
-   {
-      uint64_t xor_ = old_state[i] ^ new_state[i];
+        apply_delta(history.back(), top_state.data());
+        history_bytes -= history.back().size() * sizeof(uint32_t);
+        history.pop_back();
+    }
 
-      // If the data differs (xor != 0), we push that xor on the stack with index and xor.
-      // This can be reversed by reapplying the xor.
-      // This, if states don't really differ much, we'll save lots of space :)
-      // Hopefully this will work really well with save states.
-      if (xor_)
-      {
-         buffer[top_ptr] = (i << 32) | xor_;
-         top_ptr = (top_ptr + 1) & buf_size_mask;
+    int result = S9xUnfreezeGameMem((uint8 *)top_state.data(),real_state_size);
 
-         if (top_ptr == bottom_ptr)
-            crossed = true;
-      }
-   }
+    pop_count++;
+    pop_usec += elapsed_usec(start);
 
-   if (crossed)
-      reassign_bottom();
+    return result;
 }
 
 bool StateManager::push()
 {
     if(!init_done)
         return false;
-    if(!S9xFreezeGameMem((uint8 *)in_state,real_state_size))
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    size_t slot;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (free_slots.empty())
+        {
+            // never stall emulation on the worker; the next delta simply spans more frames
+            dropped++;
+            return false;
+        }
+        slot = free_slots.front();
+        free_slots.pop_front();
+    }
+
+    bool ok;
+    if (S9xMovieActive())
+        ok = S9xFreezeGameMem((uint8 *)slots[slot].data(),real_state_size) != 0;
+    else
+        ok = S9xFreezeGameMemFast((uint8 *)slots[slot].data(),real_state_size) != 0;
+
+    {
+        // pop() and get_stats() read these under the lock as well
+        std::lock_guard<std::mutex> guard(lock);
+        if (ok)
+        {
+            pending.push_back(slot);
+            first_pop = true;
+            push_count++;
+            push_usec += elapsed_usec(start);
+        }
+        else
+            free_slots.push_back(slot);
+    }
+    if (!ok)
         return false;
-    generate_delta(in_state);
-    uint32 *tmp = tmp_state;
-    tmp_state = in_state;
-    in_state = tmp;
 
-    first_pop = true;
+    work_cond.notify_one();
 
     return true;
 }
+
+StateManager::Stats StateManager::get_stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Stats stats;
+    stats.states = history.size();
+    stats.bytes = history_bytes;
+    stats.bytes_per_state = encoded_count ? (double)encoded_bytes / encoded_count : 0.0;
+    stats.push_usec = push_count ? (double)push_usec / push_count : 0.0;
+    stats.pop_usec = pop_count ? (double)pop_usec / pop_count : 0.0;
+    stats.dropped = dropped;
+
+    return stats;
+}
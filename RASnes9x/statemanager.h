@@ -3,33 +3,81 @@
 
 /*  State Manager Class that records snapshot data for rewinding
     mostly based on SSNES's rewind code by Themaister
+
+    Snapshots are taken on the emulation thread and handed to a worker
+    thread through a small bounded queue. The worker XORs each snapshot
+    against the previous one and stores the result zero-run encoded, so
+    the emulation thread only pays for S9xFreezeGameMem.
 */
 
 #include "snes9x.h"
 
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 class StateManager {
+public:
+    struct Stats {
+        size_t states;          // deltas currently held
+        size_t bytes;           // encoded bytes currently held
+        double bytes_per_state; // average encoded delta size
+        double push_usec;       // average emulation thread cost of push()
+        double pop_usec;        // average cost of pop(), including queue drain
+        uint32 dropped;         // pushes skipped because the queue was full
+    };
+
 private:
-    uint64_t *buffer;
-    size_t buf_size;
-    size_t buf_size_mask;
-    uint32_t *tmp_state;
-    uint32_t *in_state;
-    size_t top_ptr;
-    size_t bottom_ptr;
+    typedef std::vector<uint32_t> Delta;
+
+    enum { QUEUE_SLOTS = 4 };
+
+    std::deque<Delta> history;      // newest delta at the back
+    size_t history_bytes;
+    size_t max_bytes;
+    size_t max_states;
+
+    std::vector<uint32_t> top_state;                // most recently pushed snapshot
+    std::vector<std::vector<uint32_t> > slots;      // preallocated freeze buffers
+    std::deque<size_t> pending;
+    std::deque<size_t> free_slots;
+    Delta scratch;
+
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable work_cond;
+    std::condition_variable idle_cond;
+    bool quit;
+    bool busy;
+    bool has_top;
+
     size_t state_size;
     size_t real_state_size;
     bool init_done;
     bool first_pop;
-    
-    void reassign_bottom();
-    void generate_delta(const void *data);
+
+    uint64_t push_count, push_usec;
+    uint64_t pop_count, pop_usec;
+    uint64_t encoded_count, encoded_bytes;
+    uint32 dropped;
+
+    void worker_main();
+    bool store(std::vector<uint32_t> &state, Delta &delta);
+    void add_delta(Delta &delta);
+    void trim();
+    void wait_idle(std::unique_lock<std::mutex> &guard);
+    void stop_worker();
     void deallocate();
 public:
     StateManager();
     ~StateManager();
-    bool init(size_t buffer_size);
+    // buffer_size caps memory in bytes; depth caps the number of snapshots kept (0 = no cap)
+    bool init(size_t buffer_size, size_t depth = 0);
     int pop();
     bool push();
+    Stats get_stats();
 };
 
 #endif // STATEMANAGER_H
@@ -0,0 +1,823 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+// Runs the core without a display or sound device, as fast as it goes, and
+// reports its speed. A movie supplies the input so that runs are repeatable,
+// and the hash printed at the end covers RAM, VRAM, SRAM and the last frame,
+// so two builds can be checked for emulating the same thing.
+//
+//   snes9x-bench [-n frames] [-m movie.smv] [-p] [-norender] [-s count] [-runahead max] rom
+//
+// Without -n it runs the whole movie, or 3600 frames without a movie. -p
+// samples which part of the emulator is running (see profile.h) every
+// millisecond of CPU time and splits the time between the CPU, the PPU, the
+// APU and the special chips. Chips driven through their registers (DSP-n,
+// C4, ST01x, OBC1, SPC7110) are only counted as chips in a build made with
+// PROFILE_ACCESSES=1; otherwise their time goes to the CPU. -norender skips
+// drawing the frames, and leaves the frame out of the hash. -s then saves and loads the final state count
+// times each with S9xFreezeGameMem and S9xFreezeGameMemFast, and checks that
+// a state loaded from either format saves back the same bytes.
+//
+// -runahead then runs the same frames again from the starting state with
+// 0 to max frames of run-ahead (S9xMainLoopRunAhead), feeding each frame
+// the joypads the first run read from the movie, and reports what each
+// number of frames costs over no run-ahead. Run-ahead always restores the
+// real frame, so every run has to end with the RAM, VRAM and SRAM the
+// first run ended with.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "snes9x.h"
+#include "memmap.h"
+#include "apu/apu.h"
+#include "gfx.h"
+#include "snapshot.h"
+#include "controls.h"
+#include "cpuexec.h"
+#include "movie.h"
+#include "display.h"
+#include "conffile.h"
+#include "profile.h"
+
+#define DEFAULT_FRAMES	3600
+#define JOYPADS			8
+
+static const char	*sectionNames[PROFILE_COUNT] = { "other", "cpu", "ppu", "apu", "chips" };
+
+static volatile sig_atomic_t	samples[PROFILE_COUNT];
+
+static bool8	render = TRUE;
+static int		lastWidth = 0, lastHeight = 0;
+
+
+static double Now (void)
+{
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0);
+}
+
+static void ProfileHandler (int)
+{
+	samples[S9xProfileSection]++;
+}
+
+static void StartProfiler (void)
+{
+	struct sigaction	sa;
+	struct itimerval	timer;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = ProfileHandler;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, NULL);
+
+	timer.it_interval.tv_sec = 0;
+	timer.it_interval.tv_usec = 1000;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+static void StopProfiler (void)
+{
+	struct itimerval	timer;
+
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, NULL);
+	signal(SIGPROF, SIG_DFL);
+}
+
+// 64-bit FNV-1a
+static uint64 Hash (uint64 hash, const uint8 *data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return (hash);
+}
+
+// RAM, VRAM and SRAM, and the last frame if it was drawn
+static uint64 StateHash (bool8 frame)
+{
+	uint64	hash = 0xcbf29ce484222325ULL;
+
+	hash = Hash(hash, Memory.RAM, 0x20000);
+	hash = Hash(hash, Memory.VRAM, 0x10000);
+	if (Memory.SRAMSize)
+		hash = Hash(hash, Memory.SRAM, (1 << (Memory.SRAMSize + 3)) * 128);
+	if (frame)
+		for (int y = 0; y < lastHeight; y++)
+			hash = Hash(hash, (uint8 *) GFX.Screen + y * GFX.Pitch, lastWidth * sizeof(uint16));
+
+	return (hash);
+}
+
+// Runs frames from the starting state once with each number of run-ahead
+// frames up to max, giving frame i the joypads in input[i], and checks that
+// each run ends in the state with hash expected
+static bool8 RunAheadBench (int max, const uint8 *start, uint32 startSize, const uint16 *input, int frames, uint64 expected)
+{
+	double	base = 0.0;
+	bool8	ok = TRUE;
+
+	printf("Run-ahead: %d frames from the starting state\n", frames);
+
+	for (int n = 0; n <= max; n++)
+	{
+		if (S9xUnfreezeGameMemFast((uint8 *) start, startSize) != SUCCESS)
+		{
+			fprintf(stderr, "Cannot load the starting state.\n");
+			return (FALSE);
+		}
+
+		Settings.RunAheadFrames = n;
+
+		double	begin = Now();
+
+		for (int f = 0; f < frames; f++)
+		{
+			for (int j = 0; j < JOYPADS; j++)
+				MovieSetJoypad(j, input[f * JOYPADS + j]);
+			S9xMainLoopRunAhead();
+		}
+
+		double	elapsed = Now() - begin;
+		uint64	hash = StateHash(FALSE);
+
+		if (n == 0)
+			base = elapsed;
+		if (hash != expected)
+			ok = FALSE;
+
+		printf("  %d  %8.1f us/frame  %+7.1f us  %5.2fx  %s\n", n, elapsed * 1000.0 / frames,
+			(elapsed - base) * 1000.0 / frames, base ? elapsed / base : 0.0, hash == expected ? "same state" : "STATE DIFFERS");
+	}
+
+	Settings.RunAheadFrames = 0;
+
+	return (ok);
+}
+
+// Times the fast snapshots that rewind and run-ahead use against the full ones
+static bool8 SnapshotBench (int count)
+{
+	uint32	size = S9xFreezeSize(), fastSize = S9xFreezeSizeFast();
+	uint8	*full = new uint8[size], *fullCheck = new uint8[size];
+	uint8	*fast = new uint8[fastSize], *fastCheck = new uint8[fastSize];
+	double	start, save, saveFast, load, loadFast;
+	bool8	ok = TRUE;
+
+	start = Now();
+	for (int i = 0; i < count; i++)
+		S9xFreezeGameMem(full, size);
+	save = Now() - start;
+
+	start = Now();
+	for (int i = 0; i < count; i++)
+		S9xFreezeGameMemFast(fast, fastSize);
+	saveFast = Now() - start;
+
+	start = Now();
+	for (int i = 0; i < count; i++)
+		if (S9xUnfreezeGameMem(full, size) != SUCCESS)
+			ok = FALSE;
+	load = Now() - start;
+
+	start = Now();
+	for (int i = 0; i < count; i++)
+		if (S9xUnfreezeGameMemFast(fast, fastSize) != SUCCESS)
+			ok = FALSE;
+	loadFast = Now() - start;
+
+	// both buffers hold the same state, so loading one and saving the other
+	// has to give back exactly what was saved
+	S9xFreezeGameMem(fullCheck, size);
+	bool8	fastToFull = memcmp(full, fullCheck, size) == 0;
+	S9xUnfreezeGameMem(full, size);
+	S9xFreezeGameMemFast(fastCheck, fastSize);
+	bool8	fullToFast = memcmp(fast, fastCheck, fastSize) == 0;
+
+	printf("Snapshots: %u bytes full, %u bytes fast, %d of each\n", size, fastSize, count);
+	printf("  save   %8.1f us full, %8.1f us fast, %5.1fx\n", save * 1000.0 / count, saveFast * 1000.0 / count, saveFast ? save / saveFast : 0.0);
+	printf("  load   %8.1f us full, %8.1f us fast, %5.1fx\n", load * 1000.0 / count, loadFast * 1000.0 / count, loadFast ? load / loadFast : 0.0);
+	printf("  fast -> full %s, full -> fast %s%s\n", fastToFull ? "match" : "DIFFER", fullToFast ? "match" : "DIFFER", ok ? "" : ", a load FAILED");
+
+	delete [] full;
+	delete [] fullCheck;
+	delete [] fast;
+	delete [] fastCheck;
+
+	return (ok && fastToFull && fullToFast);
+}
+
+static void SamplesAvailable (void *)
+{
+	static uint8	buffer[0x10000];
+
+	S9xFinalizeSamples();
+
+	int	count = S9xGetSampleCount();
+	if (count > (int) (sizeof(buffer) >> 1))
+		count = sizeof(buffer) >> 1;
+
+	S9xMixSamples(buffer, count);
+}
+
+int main (int argc, char **argv)
+{
+	const char	*movieFilename = NULL;
+	bool8		profile = FALSE;
+	int			frames = 0;
+	int			snapshots = 0;
+	int			runAhead = -1;
+	int			i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else
+		if (!strcmp(argv[i], "-m") && i + 1 < argc)
+			movieFilename = argv[++i];
+		else
+		if (!strcmp(argv[i], "-p"))
+			profile = TRUE;
+		else
+		if (!strcmp(argv[i], "-norender"))
+			render = FALSE;
+		else
+		if (!strcmp(argv[i], "-s") && i + 1 < argc)
+			snapshots = atoi(argv[++i]);
+		else
+		if (!strcmp(argv[i], "-runahead") && i + 1 < argc)
+			runAhead = atoi(argv[++i]);
+		else
+			break;
+	}
+
+	if (i != argc - 1 || frames < 0 || snapshots < 0 || runAhead == 0 || runAhead < -1)
+	{
+		fprintf(stderr, "Usage: %s [-n frames] [-m movie.smv] [-p] [-norender] [-s count] [-runahead max] rom\n", argv[0]);
+		return (1);
+	}
+
+	memset(&Settings, 0, sizeof(Settings));
+	Settings.MouseMaster = TRUE;
+	Settings.SuperScopeMaster = TRUE;
+	Settings.JustifierMaster = TRUE;
+	Settings.MultiPlayer5Master = TRUE;
+	Settings.FrameTimePAL = 20000;
+	Settings.FrameTimeNTSC = 16667;
+	Settings.SixteenBitSound = TRUE;
+	Settings.Stereo = TRUE;
+	Settings.SoundPlaybackRate = 32000;
+	Settings.SoundInputRate = 32000;
+	Settings.SupportHiRes = TRUE;
+	Settings.Transparency = TRUE;
+	Settings.HDMATimingHack = 100;
+	Settings.BlockInvalidVRAMAccessMaster = TRUE;
+	Settings.StopEmulation = TRUE;
+	Settings.WrongMovieStateProtection = TRUE;
+	Settings.DumpStreamsMaxFrames = -1;
+	Settings.DontSaveOopsSnapshot = TRUE;
+
+	CPU.Flags = 0;
+
+	if (!Memory.Init() || !S9xInitAPU())
+	{
+		fprintf(stderr, "Memory allocation failure\n");
+		return (1);
+	}
+
+	S9xInitSound(100, 0);
+	S9xSetSoundMute(FALSE);
+	S9xSetSamplesAvailableCallback(SamplesAvailable, NULL);
+
+	GFX.Pitch = MAX_SNES_WIDTH * sizeof(uint16);
+	GFX.Screen = (uint16 *) calloc(1, GFX.Pitch * MAX_SNES_HEIGHT);
+	if (!GFX.Screen || !S9xGraphicsInit())
+	{
+		fprintf(stderr, "Memory allocation failure\n");
+		return (1);
+	}
+
+#ifdef GFX_MULTI_FORMAT
+	S9xSetRenderPixelFormat(RGB565);
+#endif
+
+	S9xInitInputDevices();
+	S9xUnmapAllControls();
+	S9xSetController(0, CTL_JOYPAD, 0, 0, 0, 0);
+	S9xSetController(1, CTL_JOYPAD, 1, 0, 0, 0);
+	S9xReportControllers();
+
+	if (!Memory.LoadROM(argv[i]))
+	{
+		fprintf(stderr, "Error opening the ROM file.\n");
+		return (1);
+	}
+
+	Settings.StopEmulation = FALSE;
+
+	if (movieFilename)
+	{
+		if (S9xMovieOpen(movieFilename, TRUE) != SUCCESS)
+		{
+			fprintf(stderr, "Error opening the movie file.\n");
+			return (1);
+		}
+
+		if (!frames)
+			frames = S9xMovieGetLength();
+	}
+
+	if (!frames)
+		frames = DEFAULT_FRAMES;
+
+	printf("%s: %d frames%s%s\n", Memory.ROMName, frames, movieFilename ? " of " : "", movieFilename ? movieFilename : "");
+
+	// the state the movie starts from, and the joypads it sets for each frame
+	uint8	*runAheadStart = NULL;
+	uint32	runAheadStartSize = 0;
+	uint16	*runAheadInput = NULL;
+
+	if (runAhead > 0)
+	{
+		runAheadStartSize = S9xFreezeSizeFast();
+		runAheadStart = new uint8[runAheadStartSize];
+		runAheadInput = new uint16[(frames + 1) * JOYPADS];
+		S9xFreezeGameMemFast(runAheadStart, runAheadStartSize);
+		for (int j = 0; j < JOYPADS; j++)
+			runAheadInput[j] = MovieGetJoypad(j);
+	}
+
+	if (profile)
+		StartProfiler();
+
+	double	start = Now();
+	int		ran;
+
+	for (ran = 0; ran < frames; ran++)
+	{
+		if (movieFilename && !S9xMoviePlaying())
+			break;
+
+		S9xMainLoop();
+
+		// the movie has set the joypads for the next frame
+		if (runAheadInput)
+			for (int j = 0; j < JOYPADS; j++)
+				runAheadInput[(ran + 1) * JOYPADS + j] = MovieGetJoypad(j);
+	}
+
+	double	elapsed = Now() - start;
+
+	if (profile)
+		StopProfiler();
+
+	printf("%d frames in %.3f s, %.1f fps, %.1f us/frame\n", ran, elapsed / 1000.0, ran * 1000.0 / elapsed, elapsed * 1000.0 / (ran ? ran : 1));
+
+	if (profile)
+	{
+		int	total = 0;
+
+		for (int s = 0; s < PROFILE_COUNT; s++)
+			total += samples[s];
+
+		for (int s = 0; s < PROFILE_COUNT; s++)
+		{
+			double	share = total ? (double) samples[s] / total : 0.0;
+			printf("  %-6s %5.1f%%  %8.1f us/frame\n", sectionNames[s], share * 100.0, share * elapsed * 1000.0 / (ran ? ran : 1));
+		}
+	}
+
+	if (!render)
+		lastWidth = lastHeight = 0;
+
+	uint64	hash = StateHash(TRUE), stateHash = StateHash(FALSE);
+
+	printf("Hash: %016llx (frame %dx%d)\n", (unsigned long long) hash, lastWidth, lastHeight);
+
+	S9xMovieShutdown();
+
+	bool8	snapshotsOK = TRUE;
+	if (snapshots)
+		snapshotsOK = SnapshotBench(snapshots);
+
+	bool8	runAheadOK = TRUE;
+	if (runAheadStart)
+	{
+		runAheadOK = RunAheadBench(runAhead, runAheadStart, runAheadStartSize, runAheadInput, ran, stateHash);
+		delete [] runAheadStart;
+		delete [] runAheadInput;
+	}
+
+	S9xGraphicsDeinit();
+	free(GFX.Screen);
+	Memory.Deinit();
+	S9xDeinitAPU();
+
+	return (snapshotsOK && runAheadOK ? 0 : 1);
+}
+
+void _splitpath (const char *path, char *drive, char *dir, char *fname, char *ext)
+{
+	*drive = 0;
+
+	const char	*slash = strrchr(path, SLASH_CHAR),
+				*dot   = strrchr(path, '.');
+
+	if (dot && slash && dot < slash)
+		dot = NULL;
+
+	if (!slash)
+	{
+		*dir = 0;
+
+		strcpy(fname, path);
+
+		if (dot)
+		{
+			fname[dot - path] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+	else
+	{
+		strcpy(dir, path);
+		dir[slash - path] = 0;
+
+		strcpy(fname, slash + 1);
+
+		if (dot)
+		{
+			fname[dot - slash - 1] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+}
+
+void _makepath (char *path, const char *, const char *dir, const char *fname, const char *ext)
+{
+	if (dir && *dir)
+	{
+		strcpy(path, dir);
+		strcat(path, SLASH_STR);
+	}
+	else
+		*path = 0;
+
+	strcat(path, fname);
+
+	if (ext && *ext)
+	{
+		strcat(path, ".");
+		strcat(path, ext);
+	}
+}
+
+// The port interface. Nothing is saved and nothing is shown: the frame is
+// left in GFX.Screen for the hash, and the sound is mixed and thrown away.
+
+bool8 S9xInitUpdate (void)
+{
+	return (TRUE);
+}
+
+bool8 S9xDeinitUpdate (int width, int height)
+{
+	lastWidth = width;
+	lastHeight = height;
+	return (TRUE);
+}
+
+bool8 S9xContinueUpdate (int width, int height)
+{
+	return (S9xDeinitUpdate(width, height));
+}
+
+void S9xSyncSpeed (void)
+{
+	IPPU.RenderThisFrame = render;
+	IPPU.FrameSkip = 0;
+	IPPU.SkippedFrames = 0;
+}
+
+void S9xMessage (int type, int, const char *message)
+{
+	if (type >= S9X_ERROR)
+		fprintf(stderr, "%s\n", message);
+}
+
+const char * S9xGetDirectory (enum s9x_getdirtype)
+{
+	return (".");
+}
+
+const char * S9xGetFilename (const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	snprintf(s, PATH_MAX + 1, "%s%s%s%s", S9xGetDirectory(dirtype), SLASH_STR, fname, ex);
+
+	return (s);
+}
+
+const char * S9xGetFilenameInc (const char *ex, enum s9x_getdirtype dirtype)
+{
+	return (S9xGetFilename(ex, dirtype));
+}
+
+const char * S9xBasename (const char *f)
+{
+	const char	*p;
+
+	if ((p = strrchr(f, '/')) != NULL || (p = strrchr(f, '\\')) != NULL)
+		return (p + 1);
+
+	return (f);
+}
+
+bool8 S9xOpenSnapshotFile (const char *filename, bool8 read_only, STREAM *file)
+{
+	if ((*file = OPEN_STREAM(filename, read_only ? "rb" : "wb")))
+		return (TRUE);
+
+	return (FALSE);
+}
+
+void S9xCloseSnapshotFile (STREAM file)
+{
+	CLOSE_STREAM(file);
+}
+
+const char * S9xChooseFilename (bool8)
+{
+	return (NULL);
+}
+
+const char * S9xChooseMovieFilename (bool8)
+{
+	return (NULL);
+}
+
+const char * S9xStringInput (const char *)
+{
+	return (NULL);
+}
+
+bool8 S9xOpenSoundDevice (void)
+{
+	return (TRUE);
+}
+
+void S9xToggleSoundChannel (int)
+{
+	return;
+}
+
+void S9xAutoSaveSRAM (void)
+{
+	return;
+}
+
+void S9xSetPalette (void)
+{
+	return;
+}
+
+void S9xInitInputDevices (void)
+{
+	return;
+}
+
+bool S9xPollButton (uint32, bool *)
+{
+	return (false);
+}
+
+bool S9xPollAxis (uint32, int16 *)
+{
+	return (false);
+}
+
+bool S9xPollPointer (uint32, int16 *, int16 *)
+{
+	return (false);
+}
+
+void S9xHandlePortCommand (s9xcommand_t, int16, int16)
+{
+	return;
+}
+
+void S9xParsePortConfig (ConfigFile &, int)
+{
+	return;
+}
+
+void S9xExtraUsage (void)
+{
+	return;
+}
+
+void S9xParseArg (char **, int &, int)
+{
+	return;
+}
+
+void S9xExit (void)
+{
+	exit(1);
+}
@@ -0,0 +1,756 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+// Times the cheat search against the byte-by-byte search it replaced, and
+// checks that both leave the same candidates and the same saved values.
+//
+//   snes9x-cheatbench [-n frames] [snapshot.ram ...]
+//
+// Snapshots are raw dumps of WRAM, optionally followed by SRAM and the
+// SA-1/SuperFX RAM (0x20000 or 0x32000 bytes), one per frame. Without any,
+// frames with counters, timers and noise are made up instead.
+//
+// Every comparison, size and signedness is run as a search for a change
+// over all the frames, and as a search for a value, and then a typical
+// session (changed, unchanged, increased, decreased, ...) is timed until
+// few candidates are left.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "snes9x.h"
+#include "cheats.h"
+
+#define WRAM_BITS	ALL_BITS
+#define SRAM_BITS	ALL_BITS + (0x20000 >> 5)
+#define IRAM_BITS	ALL_BITS + (0x30000 >> 5)
+
+#define BIT_CLEAR(a, v)	(a)[(v) >> 5] &= ~(1 << ((v) & 31))
+
+#define TEST_BIT(a, v)	((a)[(v) >> 5] & (1 << ((v) & 31)))
+
+#define SNAPSHOT_SIZE	0x32000
+#define DEFAULT_FRAMES	16
+
+// The search as it was, as the reference.
+
+#define _S9XCHTC(c, a, b) \
+	((c) == S9X_LESS_THAN             ? (a) <  (b) : \
+	 (c) == S9X_GREATER_THAN          ? (a) >  (b) : \
+	 (c) == S9X_LESS_THAN_OR_EQUAL    ? (a) <= (b) : \
+	 (c) == S9X_GREATER_THAN_OR_EQUAL ? (a) >= (b) : \
+	 (c) == S9X_EQUAL                 ? (a) == (b) : \
+	                                    (a) != (b))
+
+#define _S9XCHTD(s, m, o) \
+	((s) == S9X_8_BITS  ? ((uint8)   (*((m) + (o)))) : \
+	 (s) == S9X_16_BITS ? ((uint16)  (*((m) + (o)) + (*((m) + (o) + 1) << 8))) : \
+	 (s) == S9X_24_BITS ? ((uint32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16))) : \
+	                      ((uint32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16) + (*((m) + (o) + 3) << 24))))
+
+#define _S9XCHTDS(s, m, o) \
+	((s) == S9X_8_BITS  ?  ((int8)   (*((m) + (o)))) : \
+	 (s) == S9X_16_BITS ?  ((int16)  (*((m) + (o)) + (*((m) + (o) + 1) << 8))) : \
+	 (s) == S9X_24_BITS ? (((int32) ((*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16)) << 8)) >> 8): \
+                           ((int32)  (*((m) + (o)) + (*((m) + (o) + 1) << 8) + (*((m) + (o) + 2) << 16) + (*((m) + (o) + 3) << 24))))
+
+
+static void RefSearchForChange (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, bool8 is_signed, bool8 update)
+{
+	int	l, i;
+
+	switch (size)
+	{
+		case S9X_8_BITS:	l = 0; break;
+		case S9X_16_BITS:	l = 1; break;
+		case S9X_24_BITS:	l = 2; break;
+		default:
+		case S9X_32_BITS:	l = 3; break;
+	}
+
+	if (is_signed)
+	{
+		for (i = 0; i < 0x20000 - l; i++)
+		{
+			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->RAM, i), _S9XCHTDS(size, d->CWRAM, i)))
+			{
+				if (update)
+					d->CWRAM[i] = d->RAM[i];
+			}
+			else
+				BIT_CLEAR(d->WRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x10000 - l; i++)
+		{
+			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->SRAM, i), _S9XCHTDS(size, d->CSRAM, i)))
+			{
+				if (update)
+					d->CSRAM[i] = d->SRAM[i];
+			}
+			else
+				BIT_CLEAR(d->SRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x2000 - l; i++)
+		{
+			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->FillRAM + 0x3000, i), _S9XCHTDS(size, d->CIRAM, i)))
+			{
+				if (update)
+					d->CIRAM[i] = d->FillRAM[i + 0x3000];
+			}
+			else
+				BIT_CLEAR(d->IRAM_BITS, i);
+		}
+	}
+	else
+	{
+		for (i = 0; i < 0x20000 - l; i++)
+		{
+			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->RAM, i), _S9XCHTD(size, d->CWRAM, i)))
+			{
+				if (update)
+					d->CWRAM[i] = d->RAM[i];
+			}
+			else
+				BIT_CLEAR(d->WRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x10000 - l; i++)
+		{
+			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->SRAM, i), _S9XCHTD(size, d->CSRAM, i)))
+			{
+				if (update)
+					d->CSRAM[i] = d->SRAM[i];
+			}
+			else
+				BIT_CLEAR(d->SRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x2000 - l; i++)
+		{
+			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->FillRAM + 0x3000, i), _S9XCHTD(size, d->CIRAM, i)))
+			{
+				if (update)
+					d->CIRAM[i] = d->FillRAM[i + 0x3000];
+			}
+			else
+				BIT_CLEAR(d->IRAM_BITS, i);
+		}
+	}
+
+	for (i = 0x20000 - l; i < 0x20000; i++)
+		BIT_CLEAR(d->WRAM_BITS, i);
+
+	for (i = 0x10000 - l; i < 0x10000; i++)
+		BIT_CLEAR(d->SRAM_BITS, i);
+}
+
+static void RefSearchForValue (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 is_signed, bool8 update)
+{
+	int l, i;
+
+	switch (size)
+	{
+		case S9X_8_BITS:	l = 0; break;
+		case S9X_16_BITS:	l = 1; break;
+		case S9X_24_BITS:	l = 2; break;
+		default:
+		case S9X_32_BITS:	l = 3; break;
+	}
+
+	if (is_signed)
+	{
+		for (i = 0; i < 0x20000 - l; i++)
+		{
+			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->RAM, i), (int32) value))
+			{
+				if (update)
+					d->CWRAM[i] = d->RAM[i];
+			}
+			else
+				BIT_CLEAR(d->WRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x10000 - l; i++)
+		{
+			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->SRAM, i), (int32) value))
+			{
+				if (update)
+					d->CSRAM[i] = d->SRAM[i];
+			}
+			else
+				BIT_CLEAR(d->SRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x2000 - l; i++)
+		{
+			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTDS(size, d->FillRAM + 0x3000, i), (int32) value))
+			{
+				if (update)
+					d->CIRAM[i] = d->FillRAM[i + 0x3000];
+			}
+			else
+				BIT_CLEAR(d->IRAM_BITS, i);
+		}
+	}
+	else
+	{
+		for (i = 0; i < 0x20000 - l; i++)
+		{
+			if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->RAM, i), value))
+			{
+				if (update)
+					d->CWRAM[i] = d->RAM[i];
+			}
+			else
+				BIT_CLEAR(d->WRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x10000 - l; i++)
+		{
+			if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->SRAM, i), value))
+			{
+				if (update)
+					d->CSRAM[i] = d->SRAM[i];
+			}
+			else
+				BIT_CLEAR(d->SRAM_BITS, i);
+		}
+
+		for (i = 0; i < 0x2000 - l; i++)
+		{
+			if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, _S9XCHTD(size, d->FillRAM + 0x3000, i), value))
+			{
+				if (update)
+					d->CIRAM[i] = d->FillRAM[i + 0x3000];
+			}
+			else
+				BIT_CLEAR(d->IRAM_BITS, i);
+		}
+	}
+
+	for (i = 0x20000 - l; i < 0x20000; i++)
+		BIT_CLEAR(d->WRAM_BITS, i);
+
+	for (i = 0x10000 - l; i < 0x10000; i++)
+		BIT_CLEAR(d->SRAM_BITS, i);
+}
+
+static void RefSearchForAddress (SCheatData *d, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 update)
+{
+	int	l, i;
+
+	switch (size)
+	{
+		case S9X_8_BITS:	l = 0; break;
+		case S9X_16_BITS:	l = 1; break;
+		case S9X_24_BITS:	l = 2; break;
+		default:
+		case S9X_32_BITS:	l = 3; break;
+	}
+
+	for (i = 0; i < 0x20000 - l; i++)
+	{
+		if (TEST_BIT(d->WRAM_BITS, i) && _S9XCHTC(cmp, i, (int32) value))
+		{
+			if (update)
+				d->CWRAM[i] = d->RAM[i];
+		}
+		else
+			BIT_CLEAR(d->WRAM_BITS, i);
+	}
+
+	for (i = 0; i < 0x10000 - l; i++)
+	{
+		if (TEST_BIT(d->SRAM_BITS, i) && _S9XCHTC(cmp, i + 0x20000, (int32) value))
+		{
+			if (update)
+				d->CSRAM[i] = d->SRAM[i];
+		}
+		else
+			BIT_CLEAR(d->SRAM_BITS, i);
+	}
+
+	for (i = 0; i < 0x2000 - l; i++)
+	{
+		if (TEST_BIT(d->IRAM_BITS, i) && _S9XCHTC(cmp, i + 0x30000, (int32) value))
+		{
+			if (update)
+				d->CIRAM[i] = d->FillRAM[i + 0x3000];
+		}
+		else
+			BIT_CLEAR(d->IRAM_BITS, i);
+	}
+
+	for (i = 0x20000 - l; i < 0x20000; i++)
+		BIT_CLEAR(d->WRAM_BITS, i);
+
+	for (i = 0x10000 - l; i < 0x10000; i++)
+		BIT_CLEAR(d->SRAM_BITS, i);
+}
+
+static const char	*cmpNames[] = { "<", ">", "<=", ">=", "==", "!=" };
+
+static int		numFrames = 0;
+static uint8	**frames = NULL;
+
+static uint8	ram[0x20000], sram[0x20000], fillram[0x8000];
+
+static double Now (void)
+{
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0);
+}
+
+static uint8 * NewFrame (void)
+{
+	uint8	*frame = (uint8 *) calloc(SNAPSHOT_SIZE, 1);
+	if (!frame)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	frames = (uint8 **) realloc(frames, (numFrames + 1) * sizeof(uint8 *));
+	frames[numFrames++] = frame;
+
+	return (frame);
+}
+
+static void LoadFrame (const char *filename)
+{
+	FILE	*fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		perror(filename);
+		exit(1);
+	}
+
+	uint8	*frame = NewFrame();
+	size_t	size = fread(frame, 1, SNAPSHOT_SIZE, fp);
+	fclose(fp);
+
+	if (size != 0x20000 && size != SNAPSHOT_SIZE)
+	{
+		fprintf(stderr, "%s: expected 0x20000 or 0x32000 bytes\n", filename);
+		exit(1);
+	}
+}
+
+static uint32 Random (void)
+{
+	static uint32	seed = 12345;
+
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8);
+}
+
+// Mostly static memory, with some counters going up, some timers going
+// down and some noise.
+static void MakeFrames (int count)
+{
+	uint8	*prev = NULL;
+
+	for (int f = 0; f < count; f++)
+	{
+		uint8	*frame = NewFrame();
+
+		if (!prev)
+		{
+			for (int i = 0; i < SNAPSHOT_SIZE; i++)
+				frame[i] = (Random() & 3) ? 0 : (uint8) Random();
+		}
+		else
+		{
+			memcpy(frame, prev, SNAPSHOT_SIZE);
+
+			for (int i = 0; i < 64; i++)
+				frame[(i * 0x7f3) % SNAPSHOT_SIZE]++;
+			for (int i = 0; i < 64; i++)
+				frame[(i * 0x4e1 + 0x100) % SNAPSHOT_SIZE] -= 3;
+			for (int i = 0; i < SNAPSHOT_SIZE / 200; i++)
+				frame[Random() % SNAPSHOT_SIZE] = (uint8) Random();
+		}
+
+		prev = frame;
+	}
+}
+
+static void SetFrame (int f)
+{
+	memcpy(ram, frames[f], 0x20000);
+	memcpy(sram, frames[f] + 0x20000, 0x10000);
+	memcpy(fillram + 0x3000, frames[f] + 0x30000, 0x2000);
+}
+
+static void InitData (SCheatData *d)
+{
+	memset(d, 0, sizeof(SCheatData));
+	d->RAM = ram;
+	d->SRAM = sram;
+	d->FillRAM = fillram;
+}
+
+static int Candidates (const SCheatData *d)
+{
+	int	count = 0;
+
+	for (int i = 0; i < 0x32000; i++)
+		if (TEST_BIT(d->ALL_BITS, i))
+			count++;
+
+	return (count);
+}
+
+static bool8 Same (const SCheatData *a, const SCheatData *b)
+{
+	return (!memcmp(a->ALL_BITS, b->ALL_BITS, sizeof(a->ALL_BITS)) &&
+			!memcmp(a->CWRAM, b->CWRAM, sizeof(a->CWRAM)) &&
+			!memcmp(a->CSRAM, b->CSRAM, sizeof(a->CSRAM)) &&
+			!memcmp(a->CIRAM, b->CIRAM, sizeof(a->CIRAM)));
+}
+
+// Runs a search on both and checks them. Returns the failures.
+static int Step (SCheatData *ref, SCheatData *cur, int kind, S9xCheatComparisonType cmp, S9xCheatDataSize size, uint32 value, bool8 is_signed, double *refTime, double *curTime)
+{
+	double	t = Now();
+
+	switch (kind)
+	{
+		case 0:	RefSearchForChange(ref, cmp, size, is_signed, TRUE);			break;
+		case 1:	RefSearchForValue(ref, cmp, size, value, is_signed, FALSE);	break;
+		case 2:	RefSearchForAddress(ref, cmp, size, value, FALSE);			break;
+	}
+
+	*refTime += Now() - t;
+	t = Now();
+
+	switch (kind)
+	{
+		case 0:	S9xSearchForChange(cur, cmp, size, is_signed, TRUE);			break;
+		case 1:	S9xSearchForValue(cur, cmp, size, value, is_signed, FALSE);	break;
+		case 2:	S9xSearchForAddress(cur, cmp, size, value, FALSE);			break;
+	}
+
+	*curTime += Now() - t;
+
+	if (Same(ref, cur))
+		return (0);
+
+	static const char	*kinds[] = { "change", "value", "address" };
+	printf("  MISMATCH: %s %s %d-bit %s value %x\n", kinds[kind], cmpNames[cmp], (size + 1) * 8, is_signed ? "signed" : "unsigned", value);
+	return (1);
+}
+
+static void Start (SCheatData *ref, SCheatData *cur)
+{
+	SetFrame(0);
+	S9xStartCheatSearch(ref);
+	S9xStartCheatSearch(cur);
+}
+
+static int BenchCombinations (SCheatData *ref, SCheatData *cur)
+{
+	int	failures = 0;
+
+	printf("%-16s %10s %10s\n", "search", "old ms", "new ms");
+
+	for (int size = S9X_8_BITS; size <= S9X_32_BITS; size++)
+	{
+		for (int is_signed = 0; is_signed < 2; is_signed++)
+		{
+			double	refChange = 0.0, curChange = 0.0, refValue = 0.0, curValue = 0.0;
+
+			for (int cmp = S9X_LESS_THAN; cmp <= S9X_NOT_EQUAL; cmp++)
+			{
+				Start(ref, cur);
+
+				for (int f = 1; f < numFrames; f++)
+				{
+					SetFrame(f);
+					failures += Step(ref, cur, 0, (S9xCheatComparisonType) cmp, (S9xCheatDataSize) size, 0, is_signed, &refChange, &curChange);
+				}
+
+				// values that are in memory, and ones out of range for the size
+				static const uint32	values[] = { 0, 0x7f, 0x80, 0xff, 0x100, 0x8000, 0xffff, 0x800000, 0xffffff, 0x80000000, 0xffffffff };
+
+				for (int v = 0; v < (int) (sizeof(values) / sizeof(values[0])); v++)
+				{
+					Start(ref, cur);
+					failures += Step(ref, cur, 1, (S9xCheatComparisonType) cmp, (S9xCheatDataSize) size, values[v], is_signed, &refValue, &curValue);
+
+					SetFrame(numFrames - 1);
+					failures += Step(ref, cur, 1, (S9xCheatComparisonType) cmp, (S9xCheatDataSize) size, ram[0x100 + v], is_signed, &refValue, &curValue);
+				}
+
+				double	refAddress = 0.0, curAddress = 0.0;
+				Start(ref, cur);
+				failures += Step(ref, cur, 2, (S9xCheatComparisonType) cmp, (S9xCheatDataSize) size, 0x20010, FALSE, &refAddress, &curAddress);
+			}
+
+			printf("%2d-bit %-8s change %9.2f %10.2f\n", (size + 1) * 8, is_signed ? "signed" : "unsigned", refChange, curChange);
+			printf("%2d-bit %-8s value  %9.2f %10.2f\n", (size + 1) * 8, is_signed ? "signed" : "unsigned", refValue, curValue);
+		}
+	}
+
+	return (failures);
+}
+
+// Changed, unchanged, increased, decreased... over the frames, as someone
+// looking for a counter would.
+static int BenchSession (SCheatData *ref, SCheatData *cur)
+{
+	static const S9xCheatComparisonType	session[] = { S9X_NOT_EQUAL, S9X_EQUAL, S9X_GREATER_THAN, S9X_EQUAL, S9X_GREATER_THAN_OR_EQUAL, S9X_NOT_EQUAL };
+
+	int	failures = 0;
+
+	printf("\n%-6s %-4s %10s %10s %10s\n", "frame", "cmp", "left", "old us", "new us");
+
+	Start(ref, cur);
+
+	for (int f = 1; f < numFrames; f++)
+	{
+		S9xCheatComparisonType	cmp = session[(f - 1) % (sizeof(session) / sizeof(session[0]))];
+		double					refTime = 0.0, curTime = 0.0;
+
+		SetFrame(f);
+		failures += Step(ref, cur, 0, cmp, S9X_8_BITS, 0, FALSE, &refTime, &curTime);
+
+		printf("%-6d %-4s %10d %10.1f %10.1f\n", f, cmpNames[cmp], Candidates(cur), refTime * 1000.0, curTime * 1000.0);
+	}
+
+	return (failures);
+}
+
+int main (int argc, char **argv)
+{
+	int	count = DEFAULT_FRAMES;
+	int	i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (!strcmp(argv[i], "-n") && i + 1 < argc)
+			count = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Usage: %s [-n frames] [snapshot.ram ...]\n", argv[0]);
+			return (1);
+		}
+	}
+
+	for (; i < argc; i++)
+		LoadFrame(argv[i]);
+	if (!numFrames)
+		MakeFrames(count < 2 ? 2 : count);
+
+	if (numFrames < 2)
+	{
+		fprintf(stderr, "Need at least two snapshots\n");
+		return (1);
+	}
+
+	SCheatData	*ref = (SCheatData *) malloc(sizeof(SCheatData));
+	SCheatData	*cur = (SCheatData *) malloc(sizeof(SCheatData));
+
+	if (!ref || !cur)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return (1);
+	}
+
+	InitData(ref);
+	InitData(cur);
+
+	int	failures = BenchCombinations(ref, cur);
+	failures += BenchSession(ref, cur);
+
+	printf("\n%s\n", failures ? "FAILED" : "All searches match");
+
+	free(ref);
+	free(cur);
+	for (i = 0; i < numFrames; i++)
+		free(frames[i]);
+	free(frames);
+
+	return (failures ? 1 : 0);
+}
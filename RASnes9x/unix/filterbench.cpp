@@ -0,0 +1,562 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+// Times the pixel scalers at every SIMD level the CPU has and checks that
+// each level writes exactly what the scalar code writes. With -t it instead
+// times every blit filter split over 1, 2, 4 and 8 threads and checks that
+// the slices join up to what one thread writes.
+//
+//   snes9x-filterbench [-t] [-w width] [-h height] [-n repeats] [frame.raw ...]
+//
+// Frames are raw dumps of the 16-bit screen, width * height pixels without
+// padding. Without any, a few synthetic frames with flat areas, dithering
+// and gradients are used instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "snes9x.h"
+#include "gfx.h"
+#include "blit.h"
+#include "simd.h"
+
+#define BORDER_X	16
+#define BORDER_Y	4
+
+struct Filter
+{
+	const char	*name;
+	void		(*blit) (uint8 *, int, uint8 *, int, int, int);
+	int			scale;
+};
+
+static const Filter	filters[] =
+{
+	{ "EPX",         S9xBlitPixEPX16,         2 },
+	{ "2xSaI",       S9xBlitPix2xSaI16,       2 },
+	{ "Super2xSaI",  S9xBlitPixSuper2xSaI16,  2 },
+	{ "SuperEagle",  S9xBlitPixSuperEagle16,  2 },
+	{ "hq2x",        S9xBlitPixHQ2x16,        2 },
+	{ "hq3x",        S9xBlitPixHQ3x16,        3 },
+	{ "hq4x",        S9xBlitPixHQ4x16,        4 }
+};
+
+// delta filters skip pixels that have not changed since the last frame, so
+// their history is cleared before every run to time a full frame
+struct Blitter
+{
+	const char	*name;
+	S9xBlitter	blit;
+	bool8		delta;
+};
+
+static const Blitter	blitters[] =
+{
+	{ "Simple2x2",   S9xBlitPixSimple2x2,     TRUE  },
+	{ "TV2x2",       S9xBlitPixTV2x2,         TRUE  },
+	{ "Smooth2x2",   S9xBlitPixSmooth2x2,     TRUE  },
+	{ "MixedTV1x2",  S9xBlitPixMixedTV1x2,    FALSE },
+	{ "Blend2x1",    S9xBlitPixBlend2x1,      FALSE },
+	{ "EPX",         S9xBlitPixEPX16,         FALSE },
+	{ "2xSaI",       S9xBlitPix2xSaI16,       FALSE },
+	{ "Super2xSaI",  S9xBlitPixSuper2xSaI16,  FALSE },
+	{ "SuperEagle",  S9xBlitPixSuperEagle16,  FALSE },
+	{ "hq2x",        S9xBlitPixHQ2x16,        FALSE },
+	{ "hq3x",        S9xBlitPixHQ3x16,        FALSE },
+	{ "hq4x",        S9xBlitPixHQ4x16,        FALSE },
+	{ "NTSC",        S9xBlitPixNTSC16,        FALSE }
+};
+
+static const int	threadCounts[] = { 1, 2, 4, 8 };
+
+static const char	*levelNames[] = { "scalar", "sse2", "avx2" };
+
+static int		width = SNES_WIDTH, height = SNES_HEIGHT, pitch;
+static int		numFrames = 0;
+static uint16	**frames = NULL;
+
+#ifdef GFX_MULTI_FORMAT
+// the colour masks in globals.cpp default to RGB565, match them without
+// pulling in the renderer
+static uint32 BuildPixelRGB565 (uint32 R, uint32 G, uint32 B)
+{
+	return (BUILD_PIXEL_RGB565(R, G, B));
+}
+
+static void DecomposePixelRGB565 (uint32 value, uint32 &R, uint32 &G, uint32 &B)
+{
+	DECOMPOSE_PIXEL_RGB565(value, R, G, B);
+}
+#endif
+
+static double Now (void)
+{
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0);
+}
+
+static uint16 * NewFrame (void)
+{
+	uint16	*frame = (uint16 *) calloc(pitch * (height + BORDER_Y * 2), sizeof(uint16));
+	if (!frame)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	frames = (uint16 **) realloc(frames, (numFrames + 1) * sizeof(uint16 *));
+	frames[numFrames++] = frame;
+
+	return (frame + pitch * BORDER_Y + BORDER_X);
+}
+
+static void LoadFrame (const char *filename)
+{
+	FILE	*fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		perror(filename);
+		exit(1);
+	}
+
+	uint16	*frame = NewFrame();
+	for (int y = 0; y < height; y++)
+	{
+		if (fread(frame + y * pitch, sizeof(uint16), width, fp) != (size_t) width)
+		{
+			fprintf(stderr, "%s: short frame, expected %dx%d pixels\n", filename, width, height);
+			exit(1);
+		}
+	}
+
+	fclose(fp);
+}
+
+static void MakeFrames (void)
+{
+	srand(1);
+
+	for (int f = 0; f < 4; f++)
+	{
+		uint16	*frame = NewFrame();
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				uint16	c;
+
+				switch (f)
+				{
+					case 0:	// big flat tiles
+						c = BUILD_PIXEL_RGB565((x / 32) * 3 & 31, (y / 16) * 5 & 31, ((x + y) / 48) & 31);
+						break;
+
+					case 1:	// dithered shading
+						c = ((x ^ y) & 1) ? BUILD_PIXEL_RGB565(8, 16, 24) : BUILD_PIXEL_RGB565(9, 17, 23);
+						break;
+
+					case 2:	// gradients
+						c = BUILD_PIXEL_RGB565((x >> 3) & 31, (y >> 3) & 31, ((x + y) >> 4) & 31);
+						break;
+
+					default: // sprites on a plain background
+						c = (rand() % 100 < 8) ? BUILD_PIXEL_RGB565(rand() & 31, rand() & 31, rand() & 31) : BUILD_PIXEL_RGB565(2, 4, 12);
+						break;
+				}
+
+				frame[y * pitch + x] = c;
+			}
+		}
+	}
+}
+
+static int BenchSIMD (int repeats, uint8 *reference, uint8 *output, int dstPitch, size_t dstSize)
+{
+	int	bestLevel = S9xFilterSetSIMDLevel(S9X_SIMD_AVX2);
+	int	failures = 0;
+
+	printf("%d frame(s) of %dx%d, %d repeat(s), best level %s\n\n", numFrames, width, height, repeats, levelNames[bestLevel]);
+	printf("%-12s %-8s %10s %8s  %s\n", "filter", "level", "ms/frame", "speedup", "output");
+
+	for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+	{
+		double	scalarTime = 0.0;
+
+		for (int level = S9X_SIMD_NONE; level <= bestLevel; level++)
+		{
+			S9xFilterSetSIMDLevel(level);
+
+			bool8	exact = TRUE;
+			double	elapsed = 0.0;
+
+			for (int n = 0; n < numFrames; n++)
+			{
+				uint8	*src = (uint8 *) (frames[n] + pitch * BORDER_Y + BORDER_X);
+				uint8	*dst = (level == S9X_SIMD_NONE) ? reference + dstSize * n : output;
+
+				memset(dst, 0, dstSize);
+
+				// the fastest run is the least disturbed by the rest of the system
+				double	best = 0.0;
+				for (int r = 0; r < repeats; r++)
+				{
+					double	start = Now();
+					filters[f].blit(src, pitch * sizeof(uint16), dst, dstPitch, width, height);
+					double	taken = Now() - start;
+					if (r == 0 || taken < best)
+						best = taken;
+				}
+				elapsed += best;
+
+				if (level != S9X_SIMD_NONE && memcmp(output, reference + dstSize * n, dstSize))
+					exact = FALSE;
+			}
+
+			elapsed /= numFrames;
+			if (level == S9X_SIMD_NONE)
+				scalarTime = elapsed;
+			if (!exact)
+				failures++;
+
+			printf("%-12s %-8s %10.3f %7.2fx  %s\n", filters[f].name, levelNames[level], elapsed, scalarTime / elapsed,
+				(level == S9X_SIMD_NONE) ? "reference" : (exact ? "identical" : "MISMATCH"));
+		}
+	}
+
+	return (failures);
+}
+
+static int BenchThreads (int repeats, uint8 *reference, uint8 *output, int dstPitch, size_t dstSize)
+{
+	int	failures = 0;
+
+	printf("%d frame(s) of %dx%d, %d repeat(s), level %s\n\n", numFrames, width, height, repeats, levelNames[S9xFilterSIMDLevel()]);
+	printf("%-12s %-8s %10s %10s %8s  %s\n", "filter", "threads", "ms/frame", "frames/s", "speedup", "output");
+
+	for (size_t f = 0; f < sizeof(blitters) / sizeof(blitters[0]); f++)
+	{
+		const Blitter	*b = &blitters[f];
+		double			oneThread = 0.0;
+
+		S9xBlitThreadsInit(1);
+
+		for (int n = 0; n < numFrames; n++)
+		{
+			uint8	*src = (uint8 *) (frames[n] + pitch * BORDER_Y + BORDER_X);
+
+			S9xBlitClearDelta();
+			memset(reference + dstSize * n, 0, dstSize);
+			b->blit(src, pitch * sizeof(uint16), reference + dstSize * n, dstPitch, width, height);
+		}
+
+		for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); t++)
+		{
+			if (!S9xBlitThreadsInit(threadCounts[t]))
+			{
+				printf("%-12s %-8d  could not start the threads\n", b->name, threadCounts[t]);
+				failures++;
+				continue;
+			}
+
+			bool8	exact = TRUE;
+			double	elapsed = 0.0;
+
+			for (int n = 0; n < numFrames; n++)
+			{
+				uint8	*src = (uint8 *) (frames[n] + pitch * BORDER_Y + BORDER_X);
+
+				double	best = 0.0;
+				for (int r = 0; r < repeats; r++)
+				{
+					if (b->delta)
+						S9xBlitClearDelta();
+					memset(output, 0, dstSize);
+
+					double	start = Now();
+					S9xBlitThreaded(b->blit, src, pitch * sizeof(uint16), output, dstPitch, width, height);
+					double	taken = Now() - start;
+					if (r == 0 || taken < best)
+						best = taken;
+				}
+				elapsed += best;
+
+				if (memcmp(output, reference + dstSize * n, dstSize))
+					exact = FALSE;
+			}
+
+			elapsed /= numFrames;
+			if (t == 0)
+				oneThread = elapsed;
+			if (!exact)
+				failures++;
+
+			printf("%-12s %-8d %10.3f %10.1f %7.2fx  %s\n", b->name, threadCounts[t], elapsed, 1000.0 / elapsed, oneThread / elapsed,
+				exact ? "identical" : "MISMATCH");
+		}
+	}
+
+	S9xBlitThreadsDeinit();
+
+	return (failures);
+}
+
+int main (int argc, char **argv)
+{
+	bool8	threads = FALSE;
+	int		repeats = 20;
+	int		i;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (!strcmp(argv[i], "-t"))
+			threads = TRUE;
+		else
+		if (!strcmp(argv[i], "-w") && i + 1 < argc)
+			width = atoi(argv[++i]);
+		else
+		if (!strcmp(argv[i], "-h") && i + 1 < argc)
+			height = atoi(argv[++i]);
+		else
+		if (!strcmp(argv[i], "-n") && i + 1 < argc)
+			repeats = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Usage: %s [-t] [-w width] [-h height] [-n repeats] [frame.raw ...]\n", argv[0]);
+			return (1);
+		}
+	}
+
+	if (width < 16 || width > MAX_SNES_WIDTH || height < 4 || height > MAX_SNES_HEIGHT || repeats < 1)
+	{
+		fprintf(stderr, "Bad frame size or repeat count\n");
+		return (1);
+	}
+
+	pitch = width + BORDER_X * 2;
+
+	for (; i < argc; i++)
+		LoadFrame(argv[i]);
+	if (!numFrames)
+		MakeFrames();
+
+#ifdef GFX_MULTI_FORMAT
+	GFX.BuildPixel = BuildPixelRGB565;
+	GFX.BuildPixel2 = BuildPixelRGB565;
+	GFX.DecomposePixel = DecomposePixelRGB565;
+#endif
+
+	S9xBlitFilterInit();
+	S9xBlit2xSaIFilterInit();
+	S9xBlitHQ2xFilterInit();
+	S9xBlitNTSCFilterInit();
+
+	int		dstPitch = width * 4 * sizeof(uint16);
+	size_t	dstSize = dstPitch * height * 4;
+	uint8	*reference = (uint8 *) malloc(dstSize * numFrames);
+	uint8	*output = (uint8 *) malloc(dstSize);
+	int		failures;
+
+	if (!reference || !output)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return (1);
+	}
+
+	if (threads)
+		failures = BenchThreads(repeats, reference, output, dstPitch, dstSize);
+	else
+		failures = BenchSIMD(repeats, reference, output, dstPitch, dstSize);
+
+	free(reference);
+	free(output);
+	for (i = 0; i < numFrames; i++)
+		free(frames[i]);
+	free(frames);
+
+	S9xBlitNTSCFilterDeinit();
+	S9xBlitHQ2xFilterDeinit();
+	S9xBlit2xSaIFilterDeinit();
+	S9xBlitFilterDeinit();
+
+	return (failures ? 1 : 0);
+}
@@ -280,6 +280,7 @@ struct SUnixSettings
 	uint32	SoundFragmentSize;
 	uint32	rewindBufferSize;
 	uint32	rewindGranularity;
+	uint32	rewindDepth;
 };
 
 struct SoundStatus
@@ -297,6 +298,9 @@ static SoundStatus		so;
 
 static bool8	rewinding;
 
+static uint64	emulated_usec;
+static uint32	emulated_frames;
+
 #ifndef NOSOUND
 static uint8			Buf[SOUND_BUFFER_SIZE];
 #endif
@@ -445,6 +449,7 @@ void S9xExtraUsage (void)
 
 	S9xMessage(S9X_INFO, S9X_USAGE, "-rwbuffersize                   Rewind buffer size in MB");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-rwgranularity                  Rewind granularity in frames");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-rwdepth                        Rewind depth in seconds (0 = limited by buffer size)");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	S9xExtraDisplayUsage();
@@ -561,6 +566,14 @@ void S9xParseArg (char **argv, int &i, int argc)
 		else
 			S9xUsage();
 	}
+	else
+	if (!strcasecmp(argv[i], "-rwdepth"))
+	{
+		if (i + 1 < argc)
+			unixSettings.rewindDepth = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
 	else
 		S9xParseDisplayArg(argv, i, argc);
 }
@@ -1558,6 +1571,19 @@ void S9xExit (void)
 {
 	S9xMovieShutdown();
 
+	if (unixSettings.rewindBufferSize)
+	{
+		StateManager::Stats stats = stateMan.get_stats();
+		printf("Rewind: %u states, %u KB held, %.0f bytes/state, push %.1f us, pop %.1f us, %u dropped\n",
+			(unsigned int) stats.states, (unsigned int) (stats.bytes / 1024), stats.bytes_per_state,
+			stats.push_usec, stats.pop_usec, stats.dropped);
+	}
+
+	// compare runs with different -runahead values to get the run-ahead overhead
+	if (emulated_frames)
+		printf("Emulation: %u frames, %.1f us/frame, %u frames of run-ahead\n",
+			emulated_frames, (double) emulated_usec / emulated_frames, Settings.RunAheadFrames);
+
 	S9xSetSoundMute(TRUE);
 	Settings.StopEmulation = TRUE;
 
@@ -1637,11 +1663,15 @@ int main (int argc, char **argv)
 
 	unixSettings.rewindBufferSize = 0;
 	unixSettings.rewindGranularity = 1;
+	unixSettings.rewindDepth = 0;
 
 	memset(&so, 0, sizeof(so));
 
 	rewinding = false;
 
+	emulated_usec = 0;
+	emulated_frames = 0;
+
 	CPU.Flags = 0;
 
 	S9xLoadConfigFiles(argv, argc);
@@ -1817,7 +1847,11 @@ int main (int argc, char **argv)
 		}
 		if (unixSettings.rewindBufferSize)
 		{
-			stateMan.init(unixSettings.rewindBufferSize * 1024 * 1024);
+			uint32	depth = 0;
+			if (unixSettings.rewindDepth)
+				depth = unixSettings.rewindDepth * Memory.ROMFramesPerSecond / (unixSettings.rewindGranularity ? unixSettings.rewindGranularity : 1);
+
+			stateMan.init(unixSettings.rewindBufferSize * 1024 * 1024, depth);
 		}
 	}
 
@@ -1881,8 +1915,20 @@ int main (int argc, char **argv)
 				rewinding = stateMan.pop();
 			else if(IPPU.TotalEmulatedFrames % unixSettings.rewindGranularity == 0)
 				stateMan.push();
-			
-			S9xMainLoop();
+
+			struct timeval	start, end;
+
+			gettimeofday(&start, NULL);
+		#ifdef NETPLAY_SUPPORT
+			if (Settings.NetPlay)
+				S9xMainLoop();
+			else
+		#endif
+			S9xMainLoopRunAhead();
+			gettimeofday(&end, NULL);
+
+			emulated_usec += (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+			emulated_frames++;
 		}
 
 	#ifdef NETPLAY_SUPPORT
@@ -235,6 +235,7 @@ struct GUIData
 	Cursor			point_cursor;
 	Cursor			cross_hair_cursor;
 	int				video_mode;
+	int				blit_threads;
 	int				mouse_x;
 	int				mouse_y;
 	bool8			mod1_pressed;
@@ -302,6 +303,8 @@ void S9xExtraDisplayUsage (void)
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v7                             Video mode: EPX");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v8                             Video mode: hq2x");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-blitthreads <num>              Split the video mode filter over <num> threads");
+	S9xMessage(S9X_INFO, S9X_USAGE, "");
 }
 
 void S9xParseDisplayArg (char **argv, int &i, int argc)
@@ -309,6 +312,14 @@ void S9xParseDisplayArg (char **argv, int &i, int argc)
 	if (!strcasecmp(argv[i], "-setrepeat"))
 		GUI.no_repeat = FALSE;
 	else
+	if (!strcasecmp(argv[i], "-blitthreads"))
+	{
+		if (i + 1 < argc)
+			GUI.blit_threads = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
 	if (!strncasecmp(argv[i], "-v", 2))
 	{
 		switch (argv[i][2])
@@ -477,6 +488,8 @@ const char * S9xParseDisplayConfig (ConfigFile &conf, int pass)
 	else
 		GUI.video_mode = VIDEOMODE_BLOCKY;
 
+	GUI.blit_threads = conf.GetInt("Unix/X11::BlitThreads", 1);
+
 	return ("Unix/X11");
 }
 
@@ -568,6 +581,7 @@ void S9xInitDisplay (int argc, char **argv)
 	S9xBlitFilterInit();
 	S9xBlit2xSaIFilterInit();
 	S9xBlitHQ2xFilterInit();
+	S9xBlitThreadsInit(GUI.blit_threads);
 
 	XSetWindowAttributes	attrib;
 
@@ -638,6 +652,7 @@ void S9xDeinitDisplay (void)
 	TakedownImage();
 	XSync(GUI.display, False);
 	XCloseDisplay(GUI.display);
+	S9xBlitThreadsDeinit();
 	S9xBlitFilterDeinit();
 	S9xBlit2xSaIFilterDeinit();
 	S9xBlitHQ2xFilterDeinit();
@@ -835,7 +850,7 @@ void S9xPutImage (int width, int height)
 		blitFn = S9xBlitPixSimple1x1;
 	}
 
-	blitFn((uint8 *) GFX.Screen, GFX.Pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
+	S9xBlitThreaded(blitFn, (uint8 *) GFX.Screen, GFX.Pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
 
 	if (height < prevHeight)
 	{
@@ -195,6 +195,7 @@
 #include "../filter/2xsai.h"
 #include "../filter/hq2x.h"
 #include "snes_ntsc.h"
+#include "../filter/blit.h"
 
 // Private Prototypes, should not be called directly
 void RenderPlain (SSurface Src, SSurface Dst, RECT *);
@@ -453,6 +454,7 @@ void InitRenderFilters(void)
 		BlendBuffer = BlendBuf + EXT_OFFSET;
 		memset(BlendBuf, 0, EXT_PITCH * EXT_HEIGHT);
 	}
+	S9xBlitThreadsInit(GUI.FilterThreads);
 }
 
 #define R5G6B5 // windows port uses RGB565
@@ -833,8 +835,8 @@ void RenderSuperEagle (SSurface Src, SSurface Dst, RECT *rect)
     lpDst = Dst.Surface;
     lpDst += rect->top * Dst.Pitch + rect->left * 2;
 
-    SuperEagle (lpSrc, Src.Pitch,
-                lpDst, Dst.Pitch, Src.Width, Src.Height);
+    S9xBlitThreaded (S9xBlitPixSuperEagle16, lpSrc, Src.Pitch,
+                     lpDst, Dst.Pitch, Src.Width, Src.Height);
 
     if (snes9x_clear_change_log)
         snes9x_clear_change_log--;
@@ -857,8 +859,8 @@ void Render2xSaI (SSurface Src, SSurface Dst, RECT *rect)
     lpDst = Dst.Surface;
     lpDst += rect->top * Dst.Pitch + rect->left * 2;
 
-    _2xSaI (lpSrc, Src.Pitch,
-            lpDst, Dst.Pitch, Src.Width, Src.Height);
+    S9xBlitThreaded (S9xBlitPix2xSaI16, lpSrc, Src.Pitch,
+                     lpDst, Dst.Pitch, Src.Width, Src.Height);
 
     if (snes9x_clear_change_log)
         snes9x_clear_change_log--;
@@ -877,8 +879,8 @@ void RenderSuper2xSaI (SSurface Src, SSurface Dst, RECT *rect)
     lpDst = Dst.Surface;
     lpDst += rect->top * Dst.Pitch + rect->left * 2;
 
-    Super2xSaI (lpSrc, Src.Pitch,
-                lpDst, Dst.Pitch, Src.Width, Src.Height);
+    S9xBlitThreaded (S9xBlitPixSuper2xSaI16, lpSrc, Src.Pitch,
+                     lpDst, Dst.Pitch, Src.Width, Src.Height);
 
     if (snes9x_clear_change_log)
         snes9x_clear_change_log--;
@@ -1866,7 +1868,7 @@ void RenderHQ2X (SSurface Src, SSurface Dst, RECT *rect)
     dstPtr += rect->top * Dst.Pitch + rect->left * 2;
 
 	if(GuiScale==FILTER_HQ2X) {
-		HQ2X_16(Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
+		S9xBlitThreaded(S9xBlitPixHQ2x16,Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
 		return;
 	}
 
@@ -2244,7 +2246,7 @@ void RenderHQ3X (SSurface Src, SSurface Dst, RECT *rect)
     dstPtr += rect->top * Dst.Pitch + rect->left * 2;
 
 	if(GuiScale==FILTER_HQ2X) {
-		HQ3X_16(Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
+		S9xBlitThreaded(S9xBlitPixHQ3x16,Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
 		return;
 	}
 
@@ -2510,7 +2512,7 @@ void RenderHQ4X (SSurface Src, SSurface Dst, RECT *rect)
 
 	if (Src.Height > SNES_HEIGHT_EXTENDED || Src.Width == 512)
     {
-		HQ2X_16(Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
+		S9xBlitThreaded(S9xBlitPixHQ2x16,Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
 		if(Src.Height<=SNES_HEIGHT_EXTENDED)
 			DoubleHeightInPlace((uint16 *)dstPtr,Dst.Pitch>>1,Src.Width*2,Src.Height*2);
 		else if(Src.Width==SNES_WIDTH)
@@ -2518,7 +2520,7 @@ void RenderHQ4X (SSurface Src, SSurface Dst, RECT *rect)
         return;
     }
 
-	HQ4X_16(Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
+	S9xBlitThreaded(S9xBlitPixHQ4x16,Src.Surface,Src.Pitch,dstPtr,Dst.Pitch,Src.Width,Src.Height);
 }
 
 void RenderSimple4X( SSurface Src, SSurface Dst, RECT *rect)
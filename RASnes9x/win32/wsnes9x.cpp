@@ -3660,7 +3660,14 @@ int WINAPI WinMain(
                     }
                 }
 
-				S9xMainLoop();
+				// run-ahead frames are rolled back before returning, so the
+				// achievement runtime still sees one real frame per iteration
+#ifdef NETPLAY_SUPPORT
+				if (Settings.NetPlay)
+					S9xMainLoop();
+				else
+#endif
+				S9xMainLoopRunAhead();
 				GUI.FrameCount++;
 
 				RA_DoAchievementsFrame();
@@ -4098,6 +4105,15 @@ static void ResetFrameTimer ()
     GUI.hFrameTimer = timeSetEvent ((Settings.FrameTime+500)/1000, 0, (LPTIMECALLBACK)FrameTimer, 0, TIME_PERIODIC);
 }
 
+static void InitRewindBuffer()
+{
+	size_t depth = 0;
+	if (GUI.rewindDepth)
+		depth = (size_t)GUI.rewindDepth * Memory.ROMFramesPerSecond / GUI.rewindGranularity;
+
+	stateMan.init(GUI.rewindBufferSize * 1024 * 1024, depth);
+}
+
 unsigned char ByteReader( size_t nOffs )
 {
 	return Memory.RAM[ nOffs % 0x20000 ];
@@ -4112,6 +4128,34 @@ unsigned char ByteReaderSRAM( size_t nOffs )
 	return Memory.SRAM[ nOffs % nSRAMBytes ];
 }
 
+unsigned int BlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	if( nOffs >= 0x20000 )
+		return 0;
+
+	if( nCount > 0x20000 - nOffs )
+		nCount = 0x20000 - nOffs;
+
+	memcpy( pBuffer, Memory.RAM + nOffs, nCount );
+	return nCount;
+}
+
+unsigned int BlockReaderSRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	unsigned int nSRAMBytes = Memory.SRAMSize ? (1 << (Memory.SRAMSize + 3)) * 128 : 0;
+	if( nSRAMBytes > 0x20000 )
+		nSRAMBytes = 0x20000;
+
+	if( nOffs >= nSRAMBytes )
+		return 0;
+
+	if( nCount > nSRAMBytes - nOffs )
+		nCount = nSRAMBytes - nOffs;
+
+	memcpy( pBuffer, Memory.SRAM + nOffs, nCount );
+	return nCount;
+}
+
 void ByteWriter( size_t nOffs, unsigned int nVal )
 {
 	if( nOffs < 0x20000 )
@@ -4143,6 +4187,8 @@ static bool LoadROMPlain(const TCHAR *filename)
 		RA_ClearMemoryBanks();
 		RA_InstallMemoryBank( 0, ByteReader, ByteWriter, 0x20000 );
 		RA_InstallMemoryBank( 1, ByteReaderSRAM, ByteWriterSRAM, nSRAMBytes );
+		RA_InstallMemoryBankBlockReader( 0, BlockReader );
+		RA_InstallMemoryBankBlockReader( 1, BlockReaderSRAM );
 
 		RA_OnLoadNewRom(Memory.ROM, Memory.CalculatedSize);
 
@@ -4189,7 +4235,7 @@ static bool LoadROM(const TCHAR *filename) {
 			S9xNPServerQueueSendingLoadROMRequest (Memory.ROMName);
 #endif
         if(GUI.rewindBufferSize)
-            stateMan.init(GUI.rewindBufferSize * 1024 * 1024);
+            InitRewindBuffer();
 	}
 
 	if(GUI.ControllerOption == SNES_SUPERSCOPE)
@@ -5311,7 +5357,7 @@ INT_PTR CALLBACK DlgEmulatorProc(HWND hDlg, UINT msg, WPARAM wParam, LPARAM lPar
                     unsigned int newRewindBufSize = SendDlgItemMessage(hDlg, IDC_REWIND_BUFFER_SPIN, UDM_GETPOS, 0,0);
                     if(GUI.rewindBufferSize != newRewindBufSize) {
                         GUI.rewindBufferSize = newRewindBufSize;
-                        if(!Settings.StopEmulation) stateMan.init(GUI.rewindBufferSize * 1024 * 1024);
+                        if(!Settings.StopEmulation) InitRewindBuffer();
                     }
 
 					WinSaveConfigFile();
@@ -300,6 +300,7 @@ struct sGUI {
     RenderFilter Scale;
     RenderFilter ScaleHiRes;
 	bool BlendHiRes;
+	unsigned int FilterThreads;
 	bool AVIHiRes;
     bool DoubleBuffered;
     bool FullScreen;
@@ -397,6 +398,7 @@ struct sGUI {
     bool rewinding;
     unsigned int rewindBufferSize;
     unsigned int rewindGranularity;
+    unsigned int rewindDepth;
 };
 
 //TURBO masks
@@ -82,6 +82,17 @@ extern void winlog(const char *,...);
 extern void (*dbgOutput)(const char *s, u32 addr);
 extern void (*dbgSignal)(int sig,int number);
 
+// Optional timing of the emulation loop, used by the benchmark. The cores
+// announce each switch between CPU, rendering and sound work; the hook is
+// NULL in the normal ports so it only costs a pointer test there.
+enum { PROFILE_CPU, PROFILE_RENDER, PROFILE_SOUND, PROFILE_SECTIONS };
+extern void (*systemProfileSection)(int section);
+#define PROFILE_SECTION(s) \
+  do { \
+    if(systemProfileSection) \
+      systemProfileSection(s); \
+  } while(0)
+
 extern u16 systemColorMap16[0x10000];
 extern u32 systemColorMap32[0x10000];
 extern u16 systemGbPalette[24];
@@ -39,10 +39,71 @@ extern int systemBlueShift;
 extern u16 systemColorMap16[0x10000];
 extern u32 systemColorMap32[0x10000];
 
+void (*systemProfileSection)(int) = NULL;
+
+bool utilMemRawStates = true;
+
 static int (ZEXPORT *utilGzWriteFunc)(gzFile, const voidp, unsigned int) = NULL;
 static int (ZEXPORT *utilGzReadFunc)(gzFile, voidp, unsigned int) = NULL;
 static int (ZEXPORT *utilGzCloseFunc)(gzFile) = NULL;
 static z_off_t (ZEXPORT *utilGzSeekFunc)(gzFile, z_off_t, int) = NULL;
+static long (ZEXPORT *utilGzMemTellFunc)(gzFile) = NULL;
+
+// Uncompressed memory stream behind the same gzFile interface, so the
+// existing save game code can write rewind states without going through
+// zlib at all.
+typedef struct {
+  char *memory;
+  int available;
+  int pos;
+  bool overflow;
+} memraw_stream;
+
+static int ZEXPORT memrawwrite(gzFile file, const voidp buf, unsigned len)
+{
+  memraw_stream *s = (memraw_stream *)file;
+  if(s->overflow || len > (unsigned)(s->available - s->pos)) {
+    s->overflow = true;
+    return 0;
+  }
+  memcpy(s->memory + s->pos, buf, len);
+  s->pos += len;
+  return len;
+}
+
+static int ZEXPORT memrawread(gzFile file, voidp buf, unsigned len)
+{
+  memraw_stream *s = (memraw_stream *)file;
+  if(len > (unsigned)(s->available - s->pos)) {
+    s->overflow = true;
+    memset(buf, 0, len);
+    len = s->available - s->pos;
+  }
+  memcpy(buf, s->memory + s->pos, len);
+  s->pos += len;
+  return len;
+}
+
+static z_off_t ZEXPORT memrawseek(gzFile file, z_off_t off, int whence)
+{
+  memraw_stream *s = (memraw_stream *)file;
+  z_off_t pos = (whence == SEEK_SET) ? off : s->pos + off;
+  if(pos < 0 || pos > s->available)
+    return -1;
+  s->pos = pos;
+  return pos;
+}
+
+static int ZEXPORT memrawclose(gzFile file)
+{
+  free(file);
+  return 0;
+}
+
+static long ZEXPORT memrawtell(gzFile file)
+{
+  return ((memraw_stream *)file)->pos;
+}
 
 bool utilWritePNGFile(const char *fileName, int w, int h, u8 *pix)
 {
@@ -604,10 +665,48 @@ gzFile utilMemGzOpen(char *memory, int available, const char *mode)
   utilGzReadFunc = memgzread;
   utilGzCloseFunc = memgzclose;
   utilGzSeekFunc = memgzseek;
+  utilGzMemTellFunc = memtell;
 
   return memgzopen(memory, available, mode);
 }
 
+// Opens an uncompressed memory state. Writing puts UTIL_MEM_RAW_TAG first,
+// reading expects it (check with utilIsMemRawState).
+gzFile utilMemRawOpen(char *memory, int available, const char *mode)
+{
+  if(available < UTIL_MEM_RAW_TAG_SIZE || (*mode == 'w' && !utilMemRawStates))
+    return NULL;
+
+  utilGzWriteFunc = memrawwrite;
+  utilGzReadFunc = memrawread;
+  utilGzCloseFunc = memrawclose;
+  utilGzSeekFunc = memrawseek;
+  utilGzMemTellFunc = memrawtell;
+
+  memraw_stream *s = (memraw_stream *)malloc(sizeof(memraw_stream));
+  if(s == NULL)
+    return NULL;
+  s->memory = memory;
+  s->available = available;
+  s->pos = UTIL_MEM_RAW_TAG_SIZE;
+  s->overflow = false;
+  if(*mode == 'w')
+    memcpy(memory, UTIL_MEM_RAW_TAG, UTIL_MEM_RAW_TAG_SIZE);
+  return (gzFile)s;
+}
+
+bool utilIsMemRawState(const char *memory, int available)
+{
+  return available >= UTIL_MEM_RAW_TAG_SIZE &&
+    memcmp(memory, UTIL_MEM_RAW_TAG, UTIL_MEM_RAW_TAG_SIZE) == 0;
+}
+
+// true if a raw memory state didn't fit in (or ran past the end of) its buffer
+bool utilMemRawOverflow(gzFile file)
+{
+  return ((memraw_stream *)file)->overflow;
+}
+
 int utilGzWrite(gzFile file, const voidp buffer, unsigned int len)
 {
   return utilGzWriteFunc(file, buffer, len);
@@ -630,7 +729,7 @@ z_off_t utilGzSeek(gzFile file, z_off_t offset, int whence)
 
 long utilGzMemTell(gzFile file)
 {
-  return memtell(file);
+  return utilGzMemTellFunc(file);
 }
 
 void utilGBAFindSave(const u8 *data, const int size)
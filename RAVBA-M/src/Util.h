@@ -9,6 +9,14 @@ enum IMAGE_TYPE {
   IMAGE_GB      = 1
 };
 
+// tag at the start of uncompressed memory states (see utilMemRawOpen)
+#define UTIL_MEM_RAW_TAG "VBAMRAW"
+#define UTIL_MEM_RAW_TAG_SIZE 8
+
+// when false, memory states are written gzip-compressed as before; raw
+// states still load either way
+extern bool utilMemRawStates;
+
 // save game
 typedef struct {
   void *address;
@@ -35,11 +43,14 @@ int utilReadInt(gzFile);
 void utilWriteInt(gzFile, int);
 gzFile utilGzOpen(const char *file, const char *mode);
 gzFile utilMemGzOpen(char *memory, int available, const char *mode);
+gzFile utilMemRawOpen(char *memory, int available, const char *mode);
+bool utilIsMemRawState(const char *memory, int available);
 int utilGzWrite(gzFile file, const voidp buffer, unsigned int len);
 int utilGzRead(gzFile file, voidp buffer, unsigned int len);
 int utilGzClose(gzFile file);
 z_off_t utilGzSeek(gzFile file, z_off_t offset, int whence);
 long utilGzMemTell(gzFile file);
+bool utilMemRawOverflow(gzFile file);
 void utilGBAFindSave(const u8 *, const int);
 void utilUpdateSystemColorMaps(bool lcd = false);
 bool utilFileExists( const char *filename );
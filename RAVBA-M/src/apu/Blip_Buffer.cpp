@@ -201,9 +201,10 @@ void Blip_Synth_Fast_::volume_unit( double new_unit )
 
 #if !BLIP_BUFFER_FAST
 
-Blip_Synth_::Blip_Synth_( short* p, int w ) :
+Blip_Synth_::Blip_Synth_( short* p, int w, blip_long* k ) :
 	impulses( p ),
-	width( w )
+	width( w ),
+	kernel( k )
 {
 	volume_unit_ = 0.0;
 	kernel_unit  = 0;
@@ -286,6 +287,27 @@ void Blip_Synth_::adjust_impulse()
 	//for ( int i = blip_res; i--; printf( "\n" ) )
 	//  for ( int j = 0; j < width / 2; j++ )
 	//      printf( "%5ld,", impulses [j * blip_res + i + 1] );
+
+	update_kernel();
+}
+
+void Blip_Synth_::update_kernel()
+{
+	if ( !kernel )
+		return;
+
+	// same taps offset_resampled() reads from impulses, first half forwards
+	// and second half backwards, in output order
+	int const half = width / 2;
+	for ( int phase = 0; phase < blip_res; phase++ )
+	{
+		blip_long* out = kernel + phase * width;
+		for ( int i = 0; i < half; i++ )
+		{
+			out [i]        = (unsigned short) impulses [blip_res - phase + blip_res * i];
+			out [half + i] = (unsigned short) impulses [phase + blip_res * (half - 1 - i)];
+		}
+	}
 }
 
 void Blip_Synth_::treble_eq( blip_eq_t const& eq )
@@ -159,6 +159,20 @@ private:
 	#endif
 #endif
 
+// Adds deltas four taps at a time with SSE2 where the compiler guarantees
+// it. Output is identical to the scalar code.
+#ifndef BLIP_BUFFER_SSE2
+	#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define BLIP_BUFFER_SSE2 1
+	#else
+		#define BLIP_BUFFER_SSE2 0
+	#endif
+#endif
+
+#if BLIP_BUFFER_SSE2
+	#include <emmintrin.h>
+#endif
+
 	// Internal
 	typedef blip_ulong blip_resampled_time_t;
 	int const blip_widest_impulse_ = 16;
@@ -184,15 +198,17 @@ private:
 		int delta_factor;
 
 		void volume_unit( double );
-		Blip_Synth_( short* impulses, int width );
+		Blip_Synth_( short* impulses, int width, blip_long* kernel );
 		void treble_eq( blip_eq_t const& );
 	private:
 		double volume_unit_;
 		short* const impulses;
 		int const width;
+		blip_long* const kernel;
 		blip_long kernel_unit;
 		int impulses_size() const { return blip_res / 2 * width + 1; }
 		void adjust_impulse();
+		void update_kernel();
 	};
 
 // Quality level, better = slower. In general, use blip_good_quality.
@@ -246,8 +262,16 @@ private:
 	Blip_Synth_ impl;
 	typedef short imp_t;
 	imp_t impulses [blip_res * (quality / 2) + 1];
+#if BLIP_BUFFER_SSE2
+	// impulses rearranged so the 'quality' taps of each phase are adjacent,
+	// one per 32-bit word in the low half
+	blip_long kernel [blip_res * quality];
+public:
+	Blip_Synth() : impl( impulses, quality, kernel ) { }
+#else
 public:
-	Blip_Synth() : impl( impulses, quality ) { }
+	Blip_Synth() : impl( impulses, quality, 0 ) { }
+#endif
 #endif
 };
 
@@ -413,6 +437,28 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 #else
 
 	int const fwd = (blip_widest_impulse_ - quality) / 2;
+
+	#if BLIP_BUFFER_SSE2
+
+	// imp * delta modulo 2^32, split as delta = hi * 0x10000 + lo with lo signed
+	// so pmaddwd gives imp * lo and pmullw the low half of imp * hi
+	int const lo = (short) delta;
+	unsigned const hi = ((unsigned) delta - lo) >> 16;
+	__m128i const vlo = _mm_set1_epi32( lo & 0xFFFF );
+	__m128i const vhi = _mm_set1_epi32( hi & 0xFFFF );
+	__m128i const* BLIP_RESTRICT kern = (__m128i const*) (kernel + phase * quality);
+	__m128i* BLIP_RESTRICT out = (__m128i*) (buf + fwd);
+
+	for ( int i = 0; i < quality / 4; i++ )
+	{
+		__m128i k = _mm_loadu_si128( kern + i );
+		__m128i d = _mm_add_epi32( _mm_madd_epi16( k, vlo ),
+				_mm_slli_epi32( _mm_mullo_epi16( k, vhi ), 16 ) );
+		_mm_storeu_si128( out + i, _mm_add_epi32( _mm_loadu_si128( out + i ), d ) );
+	}
+
+	#else
+
 	int const rev = fwd + quality - 2;
 	int const mid = quality / 2 - 1;
 
@@ -493,6 +539,8 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 		buf [rev + 1] = t1;
 	#endif
 
+	#endif // BLIP_BUFFER_SSE2
+
 #endif
 }
 
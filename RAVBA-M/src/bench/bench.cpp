@@ -0,0 +1,952 @@
+// VisualBoyAdvance - Nintendo Gameboy/GameboyAdvance (TM) emulator.
+// Copyright (C) 1999-2003 Forgotten
+// Copyright (C) 2005-2006 Forgotten and the VBA development team
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2, or(at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// vbam-bench: runs a GB or GBA ROM headless for a fixed number of frames,
+// optionally replaying a .vmv movie, and reports the emulation speed, how
+// the time was split between the CPU core, rendering and sound, and a hash
+// of the final machine state and frame and of the sound output.  Rendering
+// options do not change either, except that frame skip can change which
+// frame was drawn last, so the same ROM, movie, frame count and frame skip
+// must always give the same hashes.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+#include "../System.h"
+#include "../apu/Effects_Buffer.h"
+#include "../Util.h"
+#include "../common/RAMemory.h"
+#include "../common/SoundDriver.h"
+#include "../gba/GBA.h"
+#include "../gba/GBAGfx.h"
+#include "../gba/Globals.h"
+#include "../gba/Sound.h"
+#include "../gb/gb.h"
+#include "../gb/gbGlobals.h"
+
+#ifndef _MSC_VER
+#define _stricmp strcasecmp
+#endif // ! _MSC_VER
+
+// size of the buffer the final state is written to; the uncompressed GBA
+// state is a little under 512KB
+#define BENCH_STATE_SIZE 0x100000
+
+struct EmulatedSystem emulator;
+
+int systemSpeed = 0;
+int systemRedShift = 19;
+int systemGreenShift = 11;
+int systemBlueShift = 3;
+int systemColorDepth = 32;
+int systemDebug = 0;
+int systemVerbose = 0;
+int systemFrameSkip = 0;
+int systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
+
+u16 systemColorMap16[0x10000];
+u32 systemColorMap32[0x10000];
+u16 systemGbPalette[24];
+
+int emulating = 0;
+
+void (*dbgOutput)(const char *, u32) = NULL;
+void (*dbgSignal)(int, int) = NULL;
+
+static const char *benchRom = NULL;
+static const char *benchMovie = NULL;
+static const char *benchBios = NULL;
+static int benchFrames = 3600;
+static bool benchProfile = true;
+static bool benchQuiet = false;
+static bool benchMemReads = false;
+static bool benchMemStates = false;
+static bool benchBlip = false;
+static bool benchGfxMerge = false;
+static bool benchRenderCheck = false;
+
+static u32 benchFrame = 0;
+
+static u32 soundHash = 2166136261u;
+static long soundSamples = 0;
+
+// -g hashes every frame drawn and notes the video modes it was drawn in
+static bool frameHashing = false;
+static u32 frameHash = 2166136261u;
+static int frameModes = 0;
+// with -c, the hash of each frame drawn on its own
+static u32 *frameHashList = NULL;
+static int frameHashCount = 0;
+
+// movie being replayed, read in full before the clock starts
+static u32 *movieData = NULL;
+static int movieLength = 0;
+static int moviePos = 0;
+static u32 movieJoypad = 0;
+
+static double profileTime[PROFILE_SECTIONS];
+static double profileStart = 0;
+static int profileCurrent = PROFILE_CPU;
+
+static const char *profileNames[PROFILE_SECTIONS] = {
+  "cpu",
+  "render",
+  "sound"
+};
+
+class NullSoundDriver : public SoundDriver
+{
+public:
+  bool init(long sampleRate) { return true; }
+  void pause() {}
+  void reset() {}
+  void resume() {}
+  void write(u16 *finalWave, int length) {}
+};
+
+static double benchClock()
+{
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if(!freq.QuadPart)
+    QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (double)now.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+static void benchProfileSection(int section)
+{
+  if(section == profileCurrent)
+    return;
+  double now = benchClock();
+  profileTime[profileCurrent] += now - profileStart;
+  profileStart = now;
+  profileCurrent = section;
+}
+
+static u32 benchReadLE32(const u8 *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+// <name>.vmv holds a version word followed by (frame, joypad) pairs, all
+// little-endian, and <name>.vm0 the state the recording starts from; see
+// wx/sys.cpp
+static bool benchLoadMovie(const char *name)
+{
+  FILE *f = fopen(name, "rb");
+  if(f == NULL) {
+    fprintf(stderr, "Cannot open movie %s\n", name);
+    return false;
+  }
+
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  u8 *data = (u8 *)malloc(size > 0 ? size : 1);
+  bool ok = size >= 12 && fread(data, 1, size, f) == (size_t)size &&
+    benchReadLE32(data) == 1;
+  fclose(f);
+
+  if(!ok) {
+    fprintf(stderr, "Invalid movie %s\n", name);
+    free(data);
+    return false;
+  }
+
+  movieLength = (size - 4) / 8;
+  movieData = (u32 *)malloc(movieLength * 2 * sizeof(u32));
+  for(int i = 0; i < movieLength * 2; i++)
+    movieData[i] = benchReadLE32(data + 4 + i * 4);
+  free(data);
+
+  char *state = strdup(name);
+  int len = strlen(state);
+  if(len >= 4 && !_stricmp(state + len - 4, ".vmv"))
+    state[len - 1] = '0';
+  else {
+    fprintf(stderr, "Movie name must end in .vmv\n");
+    free(state);
+    return false;
+  }
+
+  ok = emulator.emuReadState(state);
+  if(!ok)
+    fprintf(stderr, "Cannot read movie state %s\n", state);
+  free(state);
+  return ok;
+}
+
+static bool benchLoadRom(const char *name)
+{
+  IMAGE_TYPE type = utilFindType(name);
+
+  if(type == IMAGE_GB) {
+    if(!gbLoadRom(name))
+      return false;
+    gbGetHardwareType();
+    if(gbHardware & 5)
+      gbCPUInit(benchBios, benchBios != NULL);
+    emulator = GBSystem;
+    gbReset();
+    return true;
+  }
+
+  if(type == IMAGE_GBA) {
+    if(!CPULoadRom(name))
+      return false;
+    emulator = GBASystem;
+    CPUInit(benchBios, benchBios != NULL);
+    CPUReset();
+    return true;
+  }
+
+  fprintf(stderr, "Unknown file type %s\n", name);
+  return false;
+}
+
+// FNV-1a, carried on from hash
+static u32 benchHash(u32 hash, const u8 *data, int size)
+{
+  for(int i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// size of the frame buffer the GBA or GB core allocated
+static int benchPixSize()
+{
+  if(emulator.emuMain == GBASystem.emuMain)
+    return 4 * 241 * 162;
+  return 4 * 257 * 226;
+}
+
+// FNV-1a over the uncompressed memory state and the last frame drawn,
+// which the state leaves out
+static u32 benchStateHash()
+{
+  char *state = (char *)calloc(1, BENCH_STATE_SIZE);
+
+  if(!emulator.emuWriteMemState(state, BENCH_STATE_SIZE))
+    fprintf(stderr, "Cannot write final state\n");
+
+  u32 hash = benchHash(2166136261u, (const u8 *)state, BENCH_STATE_SIZE);
+  hash = benchHash(hash, pix, benchPixSize());
+
+  free(state);
+  return hash;
+}
+
+// RA memory bank readers, the ones win32/MainWnd.cpp installs for a GBA
+// game: one callback per byte, or one per block of bytes
+typedef unsigned char (*BenchByteReader)(size_t nOffs);
+typedef unsigned int (*BenchBlockReader)(unsigned int nOffs, unsigned char *pBuffer, unsigned int nCount);
+
+struct BenchBank {
+  BenchByteReader byteReader;
+  BenchBlockReader blockReader;
+  unsigned int size;
+};
+
+// not const, so the compiler has to call through the pointers like the
+// achievement runtime does
+static BenchBank benchBanks[2] = {
+  { GBAByteReaderInternalRAM, GBABlockReaderInternalRAM, 0x8000 },
+  { GBAByteReaderWorkRAM, GBABlockReaderWorkRAM, 0x40000 }
+};
+
+// reads IWRAM and EWRAM once per emulated frame, byte by byte and then in
+// 4KB blocks, and checks both gave the same bytes
+static void benchReadMemory()
+{
+  if(emulator.emuMain != GBASystem.emuMain) {
+    fprintf(stderr, "-r needs a GBA ROM\n");
+    return;
+  }
+
+  unsigned char *byteBuf = (unsigned char *)malloc(0x40000);
+  unsigned char *blockBuf = (unsigned char *)malloc(0x40000);
+  double byteTime = 0;
+  double blockTime = 0;
+  int mismatches = 0;
+  double bytes = 0;
+
+  for(int pass = 0; pass < benchFrames; pass++) {
+    for(int b = 0; b < 2; b++) {
+      BenchBank &bank = benchBanks[b];
+
+      double start = benchClock();
+      for(unsigned int i = 0; i < bank.size; i++)
+        byteBuf[i] = bank.byteReader(i);
+      double mid = benchClock();
+      for(unsigned int i = 0; i < bank.size; i += 0x1000)
+        bank.blockReader(i, blockBuf + i, 0x1000);
+      double end = benchClock();
+
+      byteTime += mid - start;
+      blockTime += end - mid;
+      bytes += bank.size;
+      if(memcmp(byteBuf, blockBuf, bank.size))
+        mismatches++;
+    }
+  }
+
+  printf("  RA reads: %.0f MB/s per byte, %.0f MB/s in blocks (%d passes over IWRAM+EWRAM, %d mismatches)\n",
+         byteTime > 0 ? bytes / byteTime / 1048576 : 0,
+         blockTime > 0 ? bytes / blockTime / 1048576 : 0,
+         benchFrames, mismatches);
+
+  free(byteBuf);
+  free(blockBuf);
+}
+
+// saves and loads the final state as a raw and as a gzip memory state, and
+// checks that loading the gzip one and saving it raw gives the same bytes
+static void benchMemStateTimes()
+{
+  const int iterations = 200;
+  char *raw = (char *)calloc(1, BENCH_STATE_SIZE);
+  char *gz = (char *)calloc(1, BENCH_STATE_SIZE);
+  char *check = (char *)calloc(1, BENCH_STATE_SIZE);
+  double rawSave = 0, rawLoad = 0, gzSave = 0, gzLoad = 0;
+  bool ok = true;
+
+  for(int i = 0; i < iterations; i++) {
+    double t0 = benchClock();
+    ok = emulator.emuWriteMemState(raw, BENCH_STATE_SIZE) && ok;
+    double t1 = benchClock();
+    ok = emulator.emuReadMemState(raw, BENCH_STATE_SIZE) && ok;
+    double t2 = benchClock();
+    utilMemRawStates = false;
+    ok = emulator.emuWriteMemState(gz, BENCH_STATE_SIZE) && ok;
+    utilMemRawStates = true;
+    double t3 = benchClock();
+    ok = emulator.emuReadMemState(gz, BENCH_STATE_SIZE) && ok;
+    double t4 = benchClock();
+
+    rawSave += t1 - t0;
+    rawLoad += t2 - t1;
+    gzSave += t3 - t2;
+    gzLoad += t4 - t3;
+  }
+
+  ok = emulator.emuWriteMemState(check, BENCH_STATE_SIZE) && ok;
+  bool same = memcmp(raw, check, BENCH_STATE_SIZE) == 0;
+
+  printf("  mem states: raw save %.3f ms load %.3f ms, gzip save %.3f ms load %.3f ms (%d each, %s%s)\n",
+         rawSave * 1000 / iterations, rawLoad * 1000 / iterations,
+         gzSave * 1000 / iterations, gzLoad * 1000 / iterations, iterations,
+         same ? "same state" : "STATES DIFFER", ok ? "" : ", a save or load FAILED");
+
+  free(raw);
+  free(gz);
+  free(check);
+}
+
+// xorshift, so the random lines and deltas are the same on every run
+static u32 benchRandom()
+{
+  static u32 seed = 12345;
+
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+// adds random deltas through 16, 12 and 8 tap synths to every channel of
+// buf, one GB frame at a time, and reads the frame back; the deltas and the
+// reads are timed apart
+static void benchBlipRun(const char *name, Multi_Buffer &buf, int channels)
+{
+  const int frames = 600;
+  const int deltas = 4000;
+  const blip_time_t length = 70224;
+  Blip_Synth<blip_high_quality, 65536> synth16;
+  Blip_Synth<blip_good_quality, 65536> synth12;
+  Blip_Synth<blip_med_quality, 65536> synth8;
+  blip_sample_t out[4096];
+  double insertTime = 0, readTime = 0;
+  long samples = 0;
+  u32 hash = 2166136261u;
+
+  synth16.volume(0.9);
+  synth12.volume(0.7);
+  synth8.volume(0.8);
+
+  for(int f = 0; f < frames; f++) {
+    double t0 = benchClock();
+    for(int c = 0; c < channels; c++) {
+      Multi_Buffer::channel_t ch = buf.channel(c);
+      for(int i = 0; i < deltas; i++) {
+        blip_time_t t = benchRandom() % length;
+        int delta = (int)(benchRandom() % 8192) - 4096;
+        if(i % 3 == 0)
+          synth16.offset(t, delta, ch.center);
+        else if(i % 3 == 1)
+          synth12.offset(t, delta, ch.left);
+        else
+          synth8.offset(t, delta, ch.right);
+      }
+    }
+    double t1 = benchClock();
+
+    buf.end_frame(length);
+    long n;
+    while((n = buf.read_samples(out, 4096)) > 0) {
+      hash = benchHash(hash, (const u8 *)out, n * sizeof(*out));
+      samples += n;
+    }
+    double t2 = benchClock();
+
+    insertTime += t1 - t0;
+    readTime += t2 - t1;
+  }
+
+  printf("  blip %-8s %6.1f M deltas/s, %6.1f M samples/s read, sound %08x\n", name,
+         insertTime > 0 ? (double)frames * deltas * channels / insertTime / 1e6 : 0,
+         readTime > 0 ? samples / readTime / 1e6 : 0, hash);
+}
+
+static void benchBlipSetup(Multi_Buffer &buf)
+{
+  buf.set_sample_rate(44100, 250);
+  buf.clock_rate(4194304);
+  buf.bass_freq(90);
+}
+
+// the GBA's Stereo_Buffer and the GB's Simple_Effects_Buffer with and
+// without echo; build with BLIP_BUFFER_SSE2=0 to time the scalar code
+static void benchBlipBuffers()
+{
+  Stereo_Buffer stereo;
+  benchBlipSetup(stereo);
+  benchBlipRun("stereo", stereo, 1);
+
+  Simple_Effects_Buffer effects;
+  benchBlipSetup(effects);
+  effects.set_channel_count(4);
+  effects.config().enabled = false;
+  effects.apply_config();
+  benchBlipRun("effects", effects, 4);
+
+  Simple_Effects_Buffer echo;
+  benchBlipSetup(echo);
+  echo.set_channel_count(4);
+  echo.config().enabled = true;
+  echo.config().echo = 0.6f;
+  echo.config().stereo = 0.8f;
+  echo.config().surround = true;
+  echo.apply_config();
+  benchBlipRun("echo", echo, 4);
+}
+
+static const char *mergeNames[3] = { "C", "SSE2", "AVX2" };
+
+// transparent, or a color with a random priority; OBJ pixels can also be
+// semi-transparent
+static u32 benchRandomPixel(bool obj)
+{
+  if(benchRandom() % 8 < 2)
+    return 0x80000000;
+
+  u32 color = (benchRandom() & 0xFFFF) | ((benchRandom() & 3) << 25);
+
+  if(!obj)
+    color |= 0x01000000;
+  else if(benchRandom() & 1)
+    color |= 0x00010000;
+  return color;
+}
+
+// layers passed by modes 0, 1, 2 and 3-5, in gfxMergeLine order
+static const bool mergeLayers[4][4] = {
+  { true, true, true, true },
+  { true, true, true, false },
+  { false, false, true, true },
+  { false, false, true, false }
+};
+
+static void benchMergeLine(u32 *dest, u32 layer[5][240], int mode,
+                           const u8 *mask, u32 backdrop)
+{
+  const bool *has = mergeLayers[mode];
+
+  gfxMergeLine(dest, has[0] ? layer[0] : NULL, has[1] ? layer[1] : NULL,
+               has[2] ? layer[2] : NULL, has[3] ? layer[3] : NULL,
+               layer[4], mask, backdrop);
+}
+
+// checks the SSE2 and AVX2 line merge against the C one on random lines,
+// with and without windows, then times all of them on a typical line for
+// every BLDMOD effect
+static void benchMergeKernels()
+{
+  static u32 layer[5][240];
+  static u32 out[3][240];
+  static u8 mask[240];
+  const int randomLines = 100000;
+  const int lines = 20000;
+  long mismatches = 0;
+  int levels = GFX_MERGE_C;
+
+  while(levels < GFX_MERGE_AVX2 && gfxMergeSelect(levels + 1) == levels + 1)
+    levels++;
+
+  for(int i = 0; i < randomLines; i++) {
+    for(int l = 0; l < 5; l++)
+      for(int x = 0; x < 240; x++)
+        layer[l][x] = benchRandomPixel(l == 4);
+
+    // the renderers without windows give the same mask to the whole line
+    u8 lineMask = 0x1F | (benchRandom() & 0x20);
+    for(int x = 0; x < 240; x++)
+      mask[x] = (i & 1) ? benchRandom() & 0x3F : lineMask;
+
+    gfxLine.BLDMOD = benchRandom();
+    gfxLine.COLEV = benchRandom();
+    gfxLine.COLY = benchRandom();
+    u32 backdrop = 0x30000000 | (benchRandom() & 0x7FFF);
+
+    for(int level = GFX_MERGE_C; level <= levels; level++) {
+      gfxMergeSelect(level);
+      benchMergeLine(out[level], layer, i % 4, mask, backdrop);
+      for(int x = 0; x < 240; x++)
+        if(out[level][x] != out[GFX_MERGE_C][x])
+          mismatches++;
+    }
+  }
+
+  printf("  gfx merge: %d random lines, %ld pixels differ from C\n", randomLines, mismatches);
+
+  // two full backgrounds with sparse BG2, BG3 and OBJ over them
+  for(int x = 0; x < 240; x++) {
+    layer[0][x] = 0x01000000 | (x * 31);
+    layer[1][x] = 0x03000000 | (x * 7);
+    layer[2][x] = (x % 3) ? 0x80000000 : 0x05001234;
+    layer[3][x] = (x % 5) ? 0x80000000 : 0x07004321;
+    layer[4][x] = (x % 10) ? 0x80000000 : (0x02000000 | x);
+  }
+
+  for(int windowed = 0; windowed < 2; windowed++) {
+    // a window over the middle third that turns off BG0
+    for(int x = 0; x < 240; x++)
+      mask[x] = (windowed && x >= 80 && x < 160) ? 0x3E : 0x3F;
+
+    for(int effect = 0; effect < 4; effect++) {
+      gfxLine.BLDMOD = (effect << 6) | 0x3F3F;
+      gfxLine.COLEV = 0x0808;
+      gfxLine.COLY = 8;
+
+      printf("  gfx merge effect %d%s:", effect, windowed ? " window" : "");
+      for(int level = GFX_MERGE_C; level <= levels; level++) {
+        double best = 0;
+
+        gfxMergeSelect(level);
+        for(int pass = 0; pass < 5; pass++) {
+          double start = benchClock();
+          for(int i = 0; i < lines; i++)
+            benchMergeLine(out[0], layer, 0, mask, 0x30000000);
+          double time = benchClock() - start;
+          if(pass == 0 || time < best)
+            best = time;
+        }
+        printf(" %s %.0f", mergeNames[level], best * 1e9 / lines);
+      }
+      printf(" ns/line\n");
+    }
+  }
+
+  gfxMergeSelect(GFX_MERGE_AVX2);
+}
+
+// runs the frames again from the starting state once with each line merge,
+// hashing every frame drawn, and checks they all drew the same frames
+static void benchMergeFrames(const char *start)
+{
+  u32 hashes[3];
+  int modes = 0;
+  int levels = 0;
+
+  frameHashing = true;
+
+  for(int level = GFX_MERGE_C; level <= GFX_MERGE_AVX2; level++) {
+    if(gfxMergeSelect(level) != level)
+      break;
+
+    emulator.emuReadMemState((char *)start, BENCH_STATE_SIZE);
+    benchFrame = 0;
+    moviePos = 0;
+    movieJoypad = 0;
+    frameHash = 2166136261u;
+    frameModes = 0;
+
+    double begin = benchClock();
+    while(benchFrame < (u32)benchFrames)
+      emulator.emuMain(emulator.emuCount);
+    double elapsed = benchClock() - begin;
+
+    hashes[level] = frameHash;
+    modes |= frameModes;
+    levels++;
+    printf("  gfx merge %-4s %.1f fps frames %08x\n", mergeNames[level],
+           elapsed > 0 ? benchFrame / elapsed : 0, frameHash);
+  }
+
+  frameHashing = false;
+  gfxMergeSelect(GFX_MERGE_AVX2);
+
+  bool same = true;
+  for(int level = 1; level < levels; level++)
+    if(hashes[level] != hashes[GFX_MERGE_C])
+      same = false;
+
+  printf("  gfx merge frames %s, modes drawn:", same ? "match" : "DIFFER");
+  for(int mode = 0; mode < 6; mode++)
+    if(modes & (1 << mode))
+      printf(" %d", mode);
+  printf("\n");
+}
+
+// runs the frames again from the starting state, drawing the lines on the
+// CPU thread and then on the render thread, and compares them frame by frame
+static void benchRenderThreadFrames(const char *start)
+{
+  bool renderThread = gfxRenderThread;
+  u32 *serial = (u32 *)calloc(benchFrames + 1, sizeof(u32));
+  u32 *threaded = (u32 *)calloc(benchFrames + 1, sizeof(u32));
+  int frames[2];
+
+  frameHashing = true;
+
+  for(int pass = 0; pass < 2; pass++) {
+    gfxRenderThread = pass == 1;
+
+    emulator.emuReadMemState((char *)start, BENCH_STATE_SIZE);
+    benchFrame = 0;
+    moviePos = 0;
+    movieJoypad = 0;
+    frameHash = 2166136261u;
+    frameHashList = pass ? threaded : serial;
+    frameHashCount = 0;
+
+    double begin = benchClock();
+    while(benchFrame < (u32)benchFrames)
+      emulator.emuMain(emulator.emuCount);
+    double elapsed = benchClock() - begin;
+
+    frames[pass] = frameHashCount;
+    printf("  render %-8s %.1f fps frames %08x\n", pass ? "threaded" : "serial",
+           elapsed > 0 ? benchFrame / elapsed : 0, frameHash);
+  }
+
+  frameHashing = false;
+  frameHashList = NULL;
+  gfxRenderThread = renderThread;
+
+  int differ = frames[0] != frames[1] ? 1 : 0;
+  int first = -1;
+  for(int i = 0; i < frames[0] && i < frames[1]; i++) {
+    if(serial[i] != threaded[i]) {
+      if(first < 0)
+        first = i;
+      differ++;
+    }
+  }
+
+  if(differ)
+    printf("  render frames DIFFER: %d of %d, first at frame %d\n", differ,
+           frames[0], first);
+  else
+    printf("  render frames match: %d frames\n", frames[0]);
+
+  free(serial);
+  free(threaded);
+}
+
+static void usage()
+{
+  printf("Usage: vbam-bench [options] file\n"
+         "\n"
+         "  -a        also time Blip_Buffer delta insertion and buffer reads\n"
+         "            on random deltas\n"
+         "  -b file   BIOS file to use\n"
+         "  -c        also run the GBA frames again drawing on the CPU thread\n"
+         "            and on the render thread, and compare every frame\n"
+         "  -f n      number of frames to run (default 3600)\n"
+         "  -g        also check and time the C, SSE2 and AVX2 line merge on\n"
+         "            random lines, and run the GBA frames again with each\n"
+         "            of them to compare the frames drawn\n"
+         "  -m file   replay the given .vmv movie\n"
+         "  -n        don't time the CPU, render and sound sections\n"
+         "  -q        only print the result line\n"
+         "  -r        also time RA memory reads, per byte against blocks,\n"
+         "            once per frame over GBA IWRAM and EWRAM\n"
+         "  -s n      frame skip\n"
+         "  -t        draw GBA lines on a separate thread\n"
+         "  -z        also time raw against gzip memory states\n");
+}
+
+static bool parseArgs(int argc, char **argv)
+{
+  for(int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if(arg[0] != '-' || !arg[1]) {
+      if(benchRom)
+        return false;
+      benchRom = arg;
+      continue;
+    }
+    if(arg[2])
+      return false;
+    switch(arg[1]) {
+    case 'a':
+      benchBlip = true;
+      break;
+    case 'c':
+      benchRenderCheck = true;
+      break;
+    case 'g':
+      benchGfxMerge = true;
+      break;
+    case 'n':
+      benchProfile = false;
+      break;
+    case 'q':
+      benchQuiet = true;
+      break;
+    case 'r':
+      benchMemReads = true;
+      break;
+    case 't':
+      gfxRenderThread = true;
+      break;
+    case 'z':
+      benchMemStates = true;
+      break;
+    case 'b':
+    case 'f':
+    case 'm':
+    case 's':
+      if(++i >= argc)
+        return false;
+      if(arg[1] == 'b')
+        benchBios = argv[i];
+      else if(arg[1] == 'f')
+        benchFrames = atoi(argv[i]);
+      else if(arg[1] == 'm')
+        benchMovie = argv[i];
+      else
+        systemFrameSkip = atoi(argv[i]);
+      break;
+    default:
+      return false;
+    }
+  }
+  return benchRom != NULL && benchFrames > 0;
+}
+
+int main(int argc, char **argv)
+{
+  if(!parseArgs(argc, argv)) {
+    usage();
+    return 1;
+  }
+
+  utilUpdateSystemColorMaps();
+  soundInit();
+
+  if(!benchLoadRom(benchRom)) {
+    fprintf(stderr, "Failed to load file %s\n", benchRom);
+    return 1;
+  }
+
+  if(benchMovie && !benchLoadMovie(benchMovie))
+    return 1;
+
+  emulating = 1;
+
+  char *startState = NULL;
+  if(benchGfxMerge || benchRenderCheck) {
+    if(emulator.emuMain == GBASystem.emuMain) {
+      startState = (char *)calloc(1, BENCH_STATE_SIZE);
+      emulator.emuWriteMemState(startState, BENCH_STATE_SIZE);
+    } else {
+      fprintf(stderr, "-%c needs a GBA ROM\n", benchGfxMerge ? 'g' : 'c');
+    }
+  }
+
+  if(benchProfile)
+    systemProfileSection = benchProfileSection;
+
+  double start = benchClock();
+  profileStart = start;
+
+  while(benchFrame < (u32)benchFrames)
+    emulator.emuMain(emulator.emuCount);
+
+  double elapsed = benchClock() - start;
+  benchProfileSection(PROFILE_CPU);
+  systemProfileSection = NULL;
+
+  u32 hash = benchStateHash();
+
+  emulating = 0;
+
+  if(!benchQuiet) {
+    printf("%s: %u frames in %.3f s\n", benchRom, benchFrame, elapsed);
+    if(benchProfile) {
+      for(int i = 0; i < PROFILE_SECTIONS; i++)
+        printf("  %-7s %8.3f s %5.1f%%\n", profileNames[i], profileTime[i],
+               elapsed > 0 ? profileTime[i] * 100 / elapsed : 0);
+      if(profileTime[PROFILE_SOUND] > 0)
+        printf("  %ld samples, %.0f samples/s of sound time\n", soundSamples,
+               soundSamples / profileTime[PROFILE_SOUND]);
+    }
+  }
+  printf("%.1f fps state %08x sound %08x\n", elapsed > 0 ? benchFrame / elapsed : 0,
+         hash, soundHash);
+  if(benchMemReads)
+    benchReadMemory();
+  if(benchMemStates)
+    benchMemStateTimes();
+  if(benchBlip)
+    benchBlipBuffers();
+  if(startState) {
+    if(benchGfxMerge) {
+      benchMergeKernels();
+      benchMergeFrames(startState);
+    }
+    if(benchRenderCheck)
+      benchRenderThreadFrames(startState);
+    free(startState);
+  }
+
+  emulator.emuCleanUp();
+  soundShutdown();
+  free(movieData);
+
+  return 0;
+}
+
+void systemFrame()
+{
+  benchFrame++;
+}
+
+u32 systemReadJoypad(int which)
+{
+  if(which != -1 && which != 0)
+    return 0;
+  // the frame counter starts with the movie, as in the wx port
+  while(moviePos < movieLength && benchFrame >= movieData[moviePos * 2]) {
+    movieJoypad = movieData[moviePos * 2 + 1];
+    moviePos++;
+  }
+  return movieJoypad;
+}
+
+bool systemReadJoypads()
+{
+  return true;
+}
+
+void systemMessage(int num, const char *msg, ...)
+{
+  va_list valist;
+
+  va_start(valist, msg);
+  vfprintf(stderr, msg, valist);
+  fputc('\n', stderr);
+  va_end(valist);
+}
+
+void log(const char *defaultMsg, ...)
+{
+}
+
+SoundDriver *systemSoundInit()
+{
+  return new NullSoundDriver;
+}
+
+u32 systemGetClock()
+{
+  return (u32)(benchClock() * 1000);
+}
+
+void systemOnWriteDataToSoundBuffer(const u16 *finalWave, int length)
+{
+  soundHash = benchHash(soundHash, (const u8 *)finalWave, length);
+  soundSamples += length / 2;
+}
+
+void systemDrawScreen()
+{
+  if(!frameHashing)
+    return;
+
+  frameHash = benchHash(frameHash, pix, benchPixSize());
+  frameModes |= 1 << (DISPCNT & 7);
+  if(frameHashList && frameHashCount <= benchFrames)
+    frameHashList[frameHashCount++] = benchHash(2166136261u, pix, benchPixSize());
+}
+
+bool systemPauseOnFrame() { return false; }
+void systemGbPrint(u8 *data, int len, int pages, int feed, int palette, int contrast) {}
+void systemScreenCapture(int num) {}
+void systemSetTitle(const char *title) {}
+void systemOnSoundShutdown() {}
+void systemScreenMessage(const char *msg) {}
+void systemUpdateMotionSensor() {}
+int systemGetSensorX() { return 0; }
+int systemGetSensorY() { return 0; }
+int systemGetSensorZ() { return 0; }
+u8 systemGetSensorDarkness() { return 0xE8; }
+void systemCartridgeRumble(bool on) {}
+void systemPossibleCartridgeRumble(bool on) {}
+void updateRumbleFrame() {}
+bool systemCanChangeSoundQuality() { return false; }
+void systemShowSpeed(int speed) {}
+void system10Frames(int rate) {}
+void systemGbBorderOn() {}
+
+// the cheat code write breakpoints need the debugger, which the bench has not
+void debuggerBreakOnWrite(u32 address, u32 oldvalue, u32 value, int size, int t) {}
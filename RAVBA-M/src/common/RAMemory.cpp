@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "RAMemory.h"
+#include "../System.h"
+#include "../gba/Globals.h"
+#include "../gb/gbGlobals.h"
+
+extern u8 gbReadMemory( u16 );
+extern void gbWriteMemory( u16, u8 );
+
+unsigned char ByteReader( size_t nOffs )
+{
+	return gbReadMemory( nOffs );
+}
+void ByteWriter( size_t nOffs, unsigned char nVal )
+{
+	gbWriteMemory( nOffs, nVal );
+}
+
+// Byte reader/writer offset by the size of the map until the end of the work RAM
+unsigned char PostRAMByteReader( size_t nOffs )
+{
+	return gbReadMemory( nOffs + 0xE000 );
+}
+
+void PostRAMByteWriter( size_t nOffs, unsigned char nVal )
+{
+	gbWriteMemory( nOffs + 0xE000, nVal );
+}
+
+// GBC RAM reader/writer targeting the first bank
+unsigned char GBCFirstRAMBankReader( size_t nOffs )
+{
+	return gbWram[0x1000 + nOffs];
+}
+void GBCFirstRAMBankWriter( size_t nOffs, unsigned char nVal )
+{
+	gbWram[0x1000 + nOffs] = nVal;
+}
+
+// GBC RAM reader/writer offset to the second bank
+unsigned char GBCBankedRAMReader( size_t nOffs )
+{
+	return gbWram[0x2000 + nOffs]; // Start on bank 2
+}
+void GBCBankedRAMWriter( size_t nOffs, unsigned char nVal )
+{
+	gbWram[0x2000 + nOffs] = nVal; // Start on bank 2
+}
+
+unsigned char GBAByteReaderInternalRAM( size_t nOffs )
+{
+	return static_cast<unsigned char>( internalRAM[ nOffs ] );
+}
+void GBAByteWriterInternalRAM( size_t nOffs, unsigned char nVal )
+{
+	internalRAM[ nOffs ] = nVal;
+}
+
+unsigned char GBAByteReaderWorkRAM( size_t nOffs )
+{
+	return static_cast<unsigned char>( workRAM[ nOffs ] );
+}
+void GBAByteWriterWorkRAM( size_t nOffs, unsigned char nVal )
+{
+	workRAM[ nOffs ] = nVal;
+}
+
+// Block readers let the achievement runtime fetch a whole range per call
+// instead of paying one callback per byte
+static unsigned int ClampBlock( unsigned int nOffs, unsigned int nCount, unsigned int nSize )
+{
+	if( nOffs >= nSize )
+		return 0;
+	return ( nCount > nSize - nOffs ) ? nSize - nOffs : nCount;
+}
+
+unsigned int BlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x10000 );
+	for( unsigned int i = 0; i < nCount; ++i )
+		pBuffer[i] = gbReadMemory( nOffs + i );
+	return nCount;
+}
+
+// GBC direct mapping, which stops where the first work RAM bank begins
+unsigned int GBCBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0xD000 );
+	for( unsigned int i = 0; i < nCount; ++i )
+		pBuffer[i] = gbReadMemory( nOffs + i );
+	return nCount;
+}
+
+unsigned int PostRAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x2000 );
+	for( unsigned int i = 0; i < nCount; ++i )
+		pBuffer[i] = gbReadMemory( nOffs + i + 0xE000 );
+	return nCount;
+}
+
+unsigned int GBCFirstRAMBankBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x1000 );
+	memcpy( pBuffer, gbWram + 0x1000 + nOffs, nCount );
+	return nCount;
+}
+
+unsigned int GBCBankedRAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x6000 );
+	memcpy( pBuffer, gbWram + 0x2000 + nOffs, nCount );
+	return nCount;
+}
+
+unsigned int GBABlockReaderInternalRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x8000 );
+	memcpy( pBuffer, internalRAM + nOffs, nCount );
+	return nCount;
+}
+
+unsigned int GBABlockReaderWorkRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount )
+{
+	nCount = ClampBlock( nOffs, nCount, 0x40000 );
+	memcpy( pBuffer, workRAM + nOffs, nCount );
+	return nCount;
+}
@@ -0,0 +1,36 @@
+#ifndef RAMEMORY_H
+#define RAMEMORY_H
+
+#include <stddef.h>
+
+// Memory bank readers and writers the front end installs with
+// RA_InstallMemoryBank and RA_InstallMemoryBankBlockReader
+
+// GB: the whole bus, or for GBC the bus up to work RAM, the work RAM banks
+// and the bus past work RAM
+unsigned char ByteReader( size_t nOffs );
+void ByteWriter( size_t nOffs, unsigned char nVal );
+unsigned char PostRAMByteReader( size_t nOffs );
+void PostRAMByteWriter( size_t nOffs, unsigned char nVal );
+unsigned char GBCFirstRAMBankReader( size_t nOffs );
+void GBCFirstRAMBankWriter( size_t nOffs, unsigned char nVal );
+unsigned char GBCBankedRAMReader( size_t nOffs );
+void GBCBankedRAMWriter( size_t nOffs, unsigned char nVal );
+
+// GBA: IWRAM and EWRAM
+unsigned char GBAByteReaderInternalRAM( size_t nOffs );
+void GBAByteWriterInternalRAM( size_t nOffs, unsigned char nVal );
+unsigned char GBAByteReaderWorkRAM( size_t nOffs );
+void GBAByteWriterWorkRAM( size_t nOffs, unsigned char nVal );
+
+// Block readers copy up to nCount bytes from nOffs and return how many
+// were copied, which is less at the end of the bank
+unsigned int BlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int GBCBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int PostRAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int GBCFirstRAMBankBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int GBCBankedRAMBlockReader( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int GBABlockReaderInternalRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+unsigned int GBABlockReaderWorkRAM( unsigned int nOffs, unsigned char* pBuffer, unsigned int nCount );
+
+#endif // RAMEMORY_H
@@ -3585,7 +3585,19 @@ static bool gbWriteSaveState(gzFile gzFile)
 
 bool gbWriteMemSaveState(char *memory, int available)
 {
-  gzFile gzFile = utilMemGzOpen(memory, available, "w");
+  // uncompressed first, only fall back to gzip if the buffer is too small
+  gzFile gzFile = utilMemRawOpen(memory, available, "w");
+
+  if(gzFile != NULL) {
+    bool res = gbWriteSaveState(gzFile) && !utilMemRawOverflow(gzFile);
+
+    utilGzClose(gzFile);
+
+    if(res)
+      return true;
+  }
+
+  gzFile = utilMemGzOpen(memory, available, "w");
 
   if(gzFile == NULL) {
     return false;
@@ -3985,6 +3997,19 @@ static bool gbReadSaveState(gzFile gzFile)
 
 bool gbReadMemSaveState(char *memory, int available)
 {
+  if(utilIsMemRawState(memory, available)) {
+    gzFile gzFile = utilMemRawOpen(memory, available, "r");
+
+    if(gzFile == NULL)
+      return false;
+
+    bool res = gbReadSaveState(gzFile) && !utilMemRawOverflow(gzFile);
+
+    utilGzClose(gzFile);
+
+    return res;
+  }
+
   gzFile gzFile = utilMemGzOpen(memory, available, "r");
 
   bool res = gbReadSaveState(gzFile);
@@ -5027,6 +5052,7 @@ void gbEmulate(int ticksToStop)
               if((register_LY < 144) && (register_LCDC & 0x80) && gbScreenOn) {
                 if(!gbSgbMask) {
                   if(gbFrameSkipCount >= framesToSkip) {
+                    PROFILE_SECTION(PROFILE_RENDER);
                     if (!gbBlackScreen)
                     {
                       gbRenderLine();
@@ -5044,6 +5070,7 @@ void gbEmulate(int ticksToStop)
                       }
                     }
                     gbDrawLine();
+                    PROFILE_SECTION(PROFILE_CPU);
                   }
                 }
               }
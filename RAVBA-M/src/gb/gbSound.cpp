@@ -1,5 +1,6 @@
 #include <string.h>
 
+#include "../System.h"
 #include "../gba/Sound.h"
 #include "../Util.h"
 #include "gbGlobals.h"
@@ -39,10 +40,14 @@ u8 gbSoundRead( u16 address )
 
 void gbSoundEvent(register u16 address, register int data)
 {
+	PROFILE_SECTION(PROFILE_SOUND);
+
 	gbMemory[address] = data;
 
 	if ( gb_apu && address >= NR10 && address <= 0xFF3F )
 		gb_apu->write_register( blip_time(), address, data );
+
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 static void end_frame( blip_time_t time )
@@ -86,6 +91,8 @@ static void apply_volume()
 
 void gbSoundTick()
 {
+	PROFILE_SECTION(PROFILE_SOUND);
+
  	if ( gb_apu && stereo_buffer )
 	{
 		// Run sound hardware to present
@@ -101,6 +108,8 @@ void gbSoundTick()
 		if ( soundVolume_ != soundGetVolume() )
 			apply_volume();
 	}
+
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 static void reset_apu()
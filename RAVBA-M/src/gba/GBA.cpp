@@ -37,6 +37,9 @@ int IRQTicks = 0;
 
 u32 mastercode = 0;
 int layerEnableDelay = 0;
+// BG2/BG3 reference point writes not handed to the renderer yet
+static int lineBG2Changed = 0;
+static int lineBG3Changed = 0;
 bool busPrefetch = false;
 bool busPrefetchEnable = false;
 u32 busPrefetchCount = 0;
@@ -512,38 +515,6 @@ inline int CPUUpdateTicks()
   return cpuLoopTicks;
 }
 
-void CPUUpdateWindow0()
-{
-  int x00 = WIN0H>>8;
-  int x01 = WIN0H & 255;
-
-  if(x00 <= x01) {
-    for(int i = 0; i < 240; i++) {
-      gfxInWin0[i] = (i >= x00 && i < x01);
-    }
-  } else {
-    for(int i = 0; i < 240; i++) {
-      gfxInWin0[i] = (i >= x00 || i < x01);
-    }
-  }
-}
-
-void CPUUpdateWindow1()
-{
-  int x00 = WIN1H>>8;
-  int x01 = WIN1H & 255;
-
-  if(x00 <= x01) {
-    for(int i = 0; i < 240; i++) {
-      gfxInWin1[i] = (i >= x00 && i < x01);
-    }
-  } else {
-    for(int i = 0; i < 240; i++) {
-      gfxInWin1[i] = (i >= x00 || i < x01);
-    }
-  }
-}
-
 extern u32 line0[240];
 extern u32 line1[240];
 extern u32 line2[240];
@@ -559,6 +530,7 @@ extern u32 line3[240];
 
 void CPUUpdateRenderBuffers(bool force)
 {
+  gfxRenderSync();
   if(!(layerEnable & 0x0100) || force) {
     CLEAR_ARRAY(line0);
   }
@@ -573,7 +545,9 @@ void CPUUpdateRenderBuffers(bool force)
   }
 }
 
-static bool CPUWriteState(gzFile gzFile)
+// memState: raw memory state for rewind; pix is left out because the next
+// frame redraws it anyway
+static bool CPUWriteState(gzFile gzFile, bool memState = false)
 {
   utilWriteInt(gzFile, SAVE_GAME_VERSION);
 
@@ -595,7 +569,8 @@ static bool CPUWriteState(gzFile gzFile)
   utilGzWrite(gzFile, workRAM, 0x40000);
   utilGzWrite(gzFile, vram, 0x20000);
   utilGzWrite(gzFile, oam, 0x400);
-  utilGzWrite(gzFile, pix, 4*241*162);
+  if(!memState)
+    utilGzWrite(gzFile, pix, 4*241*162);
   utilGzWrite(gzFile, ioMem, 0x400);
 
   eepromSaveGame(gzFile);
@@ -628,7 +603,19 @@ bool CPUWriteState(const char *file)
 
 bool CPUWriteMemState(char *memory, int available)
 {
-  gzFile gzFile = utilMemGzOpen(memory, available, "w");
+  // uncompressed first, only fall back to gzip if the buffer is too small
+  gzFile gzFile = utilMemRawOpen(memory, available, "w");
+
+  if(gzFile != NULL) {
+    bool res = CPUWriteState(gzFile, true) && !utilMemRawOverflow(gzFile);
+
+    utilGzClose(gzFile);
+
+    if(res)
+      return true;
+  }
+
+  gzFile = utilMemGzOpen(memory, available, "w");
 
   if(gzFile == NULL) {
     return false;
@@ -646,7 +633,7 @@ bool CPUWriteMemState(char *memory, int available)
   return res;
 }
 
-static bool CPUReadState(gzFile gzFile)
+static bool CPUReadState(gzFile gzFile, bool memState = false)
 {
   int version = utilReadInt(gzFile);
 
@@ -713,10 +700,12 @@ static bool CPUReadState(gzFile gzFile)
   utilGzRead(gzFile, workRAM, 0x40000);
   utilGzRead(gzFile, vram, 0x20000);
   utilGzRead(gzFile, oam, 0x400);
-  if(version < SAVE_GAME_VERSION_6)
-    utilGzRead(gzFile, pix, 4*240*160);
-  else
-    utilGzRead(gzFile, pix, 4*241*162);
+  if(!memState) {
+    if(version < SAVE_GAME_VERSION_6)
+      utilGzRead(gzFile, pix, 4*240*160);
+    else
+      utilGzRead(gzFile, pix, 4*241*162);
+  }
   utilGzRead(gzFile, ioMem, 0x400);
 
   if(skipSaveGameBattery) {
@@ -778,8 +767,6 @@ static bool CPUReadState(gzFile gzFile)
 
   CPUUpdateRender();
   CPUUpdateRenderBuffers(true);
-  CPUUpdateWindow0();
-  CPUUpdateWindow1();
   gbaSaveType = 0;
   switch(saveType) {
   case 0:
@@ -820,6 +807,19 @@ static bool CPUReadState(gzFile gzFile)
 
 bool CPUReadMemState(char *memory, int available)
 {
+  if(utilIsMemRawState(memory, available)) {
+    gzFile gzFile = utilMemRawOpen(memory, available, "r");
+
+    if(gzFile == NULL)
+      return false;
+
+    bool res = CPUReadState(gzFile, true) && !utilMemRawOverflow(gzFile);
+
+    utilGzClose(gzFile);
+
+    return res;
+  }
+
   gzFile gzFile = utilMemGzOpen(memory, available, "r");
 
   bool res = CPUReadState(gzFile);
@@ -1268,6 +1268,8 @@ bool CPUIsELF(const char *file)
 
 void CPUCleanUp()
 {
+  gfxRenderThreadStop();
+
 #ifdef PROFILING
   if(profilingTicksReload) {
     profCleanup();
@@ -1532,6 +1534,70 @@ void CPUUpdateRender()
   }
 }
 
+// Hands the current line to the renderer, either drawing it right away or
+// queueing it for the render thread
+static void CPURenderLine()
+{
+  bool threaded = gfxRenderThread && gfxRenderThreadStart();
+  // the option was turned off, draw from the live arrays again
+  if(!threaded && gfxRenderCopies)
+    gfxRenderThreadStop();
+  GfxLineState *line = threaded ? gfxNextLine() : &gfxLine;
+
+  line->render = renderLine;
+  line->VCOUNT = VCOUNT;
+  line->DISPCNT = DISPCNT;
+  line->BG0CNT = BG0CNT;
+  line->BG1CNT = BG1CNT;
+  line->BG2CNT = BG2CNT;
+  line->BG3CNT = BG3CNT;
+  line->BG0HOFS = BG0HOFS;
+  line->BG0VOFS = BG0VOFS;
+  line->BG1HOFS = BG1HOFS;
+  line->BG1VOFS = BG1VOFS;
+  line->BG2HOFS = BG2HOFS;
+  line->BG2VOFS = BG2VOFS;
+  line->BG3HOFS = BG3HOFS;
+  line->BG3VOFS = BG3VOFS;
+  line->BG2PA = BG2PA;
+  line->BG2PB = BG2PB;
+  line->BG2PC = BG2PC;
+  line->BG2PD = BG2PD;
+  line->BG2X_L = BG2X_L;
+  line->BG2X_H = BG2X_H;
+  line->BG2Y_L = BG2Y_L;
+  line->BG2Y_H = BG2Y_H;
+  line->BG3PA = BG3PA;
+  line->BG3PB = BG3PB;
+  line->BG3PC = BG3PC;
+  line->BG3PD = BG3PD;
+  line->BG3X_L = BG3X_L;
+  line->BG3X_H = BG3X_H;
+  line->BG3Y_L = BG3Y_L;
+  line->BG3Y_H = BG3Y_H;
+  line->WIN0H = WIN0H;
+  line->WIN1H = WIN1H;
+  line->WIN0V = WIN0V;
+  line->WIN1V = WIN1V;
+  line->WININ = WININ;
+  line->WINOUT = WINOUT;
+  line->MOSAIC = MOSAIC;
+  line->BLDMOD = BLDMOD;
+  line->COLEV = COLEV;
+  line->COLY = COLY;
+  line->layerEnable = layerEnable;
+  line->customBackdropColor = customBackdropColor;
+  line->bg2Changed = lineBG2Changed;
+  line->bg3Changed = lineBG3Changed;
+  lineBG2Changed = 0;
+  lineBG3Changed = 0;
+
+  if(threaded)
+    gfxQueueLine();
+  else
+    gfxDrawLine();
+}
+
 void CPUUpdateCPSR()
 {
   u32 CPSR = reg[16].I & 0x40;
@@ -2512,22 +2578,22 @@ void CPUUpdateRegister(u32 address, u16 value)
   case 0x28:
     BG2X_L = value;
     UPDATE_REG(0x28, BG2X_L);
-    gfxBG2Changed |= 1;
+    lineBG2Changed |= 1;
     break;
   case 0x2A:
     BG2X_H = (value & 0xFFF);
     UPDATE_REG(0x2A, BG2X_H);
-    gfxBG2Changed |= 1;
+    lineBG2Changed |= 1;
     break;
   case 0x2C:
     BG2Y_L = value;
     UPDATE_REG(0x2C, BG2Y_L);
-    gfxBG2Changed |= 2;
+    lineBG2Changed |= 2;
     break;
   case 0x2E:
     BG2Y_H = value & 0xFFF;
     UPDATE_REG(0x2E, BG2Y_H);
-    gfxBG2Changed |= 2;
+    lineBG2Changed |= 2;
     break;
   case 0x30:
     BG3PA = value;
@@ -2548,32 +2614,30 @@ void CPUUpdateRegister(u32 address, u16 value)
   case 0x38:
     BG3X_L = value;
     UPDATE_REG(0x38, BG3X_L);
-    gfxBG3Changed |= 1;
+    lineBG3Changed |= 1;
     break;
   case 0x3A:
     BG3X_H = value & 0xFFF;
     UPDATE_REG(0x3A, BG3X_H);
-    gfxBG3Changed |= 1;
+    lineBG3Changed |= 1;
     break;
   case 0x3C:
     BG3Y_L = value;
     UPDATE_REG(0x3C, BG3Y_L);
-    gfxBG3Changed |= 2;
+    lineBG3Changed |= 2;
     break;
   case 0x3E:
     BG3Y_H = value & 0xFFF;
     UPDATE_REG(0x3E, BG3Y_H);
-    gfxBG3Changed |= 2;
+    lineBG3Changed |= 2;
     break;
   case 0x40:
     WIN0H = value;
     UPDATE_REG(0x40, WIN0H);
-    CPUUpdateWindow0();
     break;
   case 0x42:
     WIN1H = value;
     UPDATE_REG(0x42, WIN1H);
-    CPUUpdateWindow1();
     break;
   case 0x44:
     WIN0V = value;
@@ -3332,9 +3396,6 @@ void CPUReset()
 
   soundReset();
 
-  CPUUpdateWindow0();
-  CPUUpdateWindow1();
-
   // make sure registers are correctly initialized if not using BIOS
   if(!useBios) {
     if(cpuIsMultiBoot)
@@ -3435,6 +3496,9 @@ void CPULoop(int ticks)
   // variable used by the CPU core
   cpuTotalTicks = 0;
 
+  // VRAM, palette and OAM may have been changed behind the renderer's back
+  gfxRenderReload();
+
   // shuffle2: what's the purpose?
   if(gba_link_enabled)
     cpuNextEvent = 1;
@@ -3473,11 +3537,15 @@ void CPULoop(int ticks)
 
     if(!holdState && !SWITicks) {
       if(armState) {
-        if (!armExecute())
+        if (!armExecute()) {
+          gfxRenderSync();
           return;
+        }
       } else {
-        if (!thumbExecute())
+        if (!thumbExecute()) {
+          gfxRenderSync();
           return;
+        }
       }
       clockTicks = 0;
     } else
@@ -3553,6 +3621,10 @@ void CPULoop(int ticks)
             lcdTicks += 1008;
             DISPSTAT &= 0xFFFD;
             if(VCOUNT == 160) {
+              // the frame has to be finished before anyone looks at pix
+              PROFILE_SECTION(PROFILE_RENDER);
+              gfxRenderSync();
+              PROFILE_SECTION(PROFILE_CPU);
               count++;
               systemFrame();
 
@@ -3631,107 +3703,10 @@ void CPULoop(int ticks)
             CPUCompareVCOUNT();
 
           } else {
-            if(frameCount >= framesToSkip)
-            {
-              (*renderLine)();
-              switch(systemColorDepth) {
-                case 16:
-                {
-                  u16 *dest = (u16 *)pix + 242 * (VCOUNT+1);
-                  for(int x = 0; x < 240;) {
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                    *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
-                  }
-                  // for filters that read past the screen
-                  *dest++ = 0;
-                }
-                break;
-                case 24:
-                {
-                  u8 *dest = (u8 *)pix + 240 * VCOUNT * 3;
-                  for(int x = 0; x < 240;) {
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                    *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    dest += 3;
-                  }
-                }
-                break;
-                case 32:
-                {
-                  u32 *dest = (u32 *)pix + 241 * (VCOUNT+1);
-                  for(int x = 0; x < 240; ) {
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                    *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
-                  }
-                }
-                break;
-              }
+            if(frameCount >= framesToSkip) {
+              PROFILE_SECTION(PROFILE_RENDER);
+              CPURenderLine();
+              PROFILE_SECTION(PROFILE_CPU);
             }
             // entering H-Blank
             DISPSTAT |= 2;
@@ -3971,6 +3946,7 @@ void CPULoop(int ticks)
 
     }
   }
+  gfxRenderSync();
 }
 
 
@@ -1,4 +1,15 @@
+#include <string.h>
+
 #include "../System.h"
+#include "GBA.h"
+#include "Globals.h"
+#include "GBAGfx.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 int coeff[32] = {
   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
@@ -23,3 +34,422 @@ int gfxBG2Y = 0;
 int gfxBG3X = 0;
 int gfxBG3Y = 0;
 int gfxLastVCOUNT = 0;
+
+GfxLineState gfxLine;
+int gfxLinesQueued = 0;
+
+u8 *gfxVram = 0;
+u8 *gfxPalette = 0;
+u8 *gfxOam = 0;
+
+// WIN0H/WIN1H that gfxInWin0/gfxInWin1 were last built from
+static int gfxWin0H = -1;
+static int gfxWin1H = -1;
+
+static void gfxUpdateWindow(bool *inWin, u16 winH)
+{
+  int x00 = winH>>8;
+  int x01 = winH & 255;
+
+  if(x00 <= x01) {
+    for(int i = 0; i < 240; i++) {
+      inWin[i] = (i >= x00 && i < x01);
+    }
+  } else {
+    for(int i = 0; i < 240; i++) {
+      inWin[i] = (i >= x00 || i < x01);
+    }
+  }
+}
+
+// Draws gfxLine and converts it into pix
+void gfxDrawLine()
+{
+  gfxBG2Changed |= gfxLine.bg2Changed;
+  gfxBG3Changed |= gfxLine.bg3Changed;
+
+  if(gfxLine.WIN0H != gfxWin0H) {
+    gfxUpdateWindow(gfxInWin0, gfxLine.WIN0H);
+    gfxWin0H = gfxLine.WIN0H;
+  }
+  if(gfxLine.WIN1H != gfxWin1H) {
+    gfxUpdateWindow(gfxInWin1, gfxLine.WIN1H);
+    gfxWin1H = gfxLine.WIN1H;
+  }
+
+  (*gfxLine.render)();
+
+  switch(systemColorDepth) {
+    case 16:
+    {
+      u16 *dest = (u16 *)pix + 242 * (gfxLine.VCOUNT+1);
+      for(int x = 0; x < 240;) {
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+        *dest++ = systemColorMap16[lineMix[x++]&0xFFFF];
+      }
+      // for filters that read past the screen
+      *dest++ = 0;
+    }
+    break;
+    case 24:
+    {
+      u8 *dest = (u8 *)pix + 240 * gfxLine.VCOUNT * 3;
+      for(int x = 0; x < 240;) {
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+        *((u32 *)dest) = systemColorMap32[lineMix[x++] & 0xFFFF];
+        dest += 3;
+      }
+    }
+    break;
+    case 32:
+    {
+      u32 *dest = (u32 *)pix + 241 * (gfxLine.VCOUNT+1);
+      for(int x = 0; x < 240; ) {
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+        *dest++ = systemColorMap32[lineMix[x++] & 0xFFFF];
+      }
+    }
+    break;
+  }
+}
+
+// Render thread. The CPU thread fills a queue slot and posts gfxLinesReady;
+// the worker draws it and posts gfxLinesDone. Only the CPU thread changes
+// gfxLinesQueued, so a zero there means the renderer is idle and the CPU may
+// touch the line buffers and the render copies freely.
+//
+// The worker draws from copies of VRAM, palette and OAM. Writes to the live
+// ones mark their 64 byte chunk dirty (CPURenderWrite), and each queued line
+// carries the current contents of the chunks dirtied since the line before,
+// which the worker copies in before drawing it. When more changed than a
+// line can carry, as with a DMA upload, the queue is drained instead and the
+// copies are updated directly.
+#define GFX_QUEUE_SIZE 32
+#define GFX_CHUNK_SIZE (1 << GFX_CHUNK_SHIFT)
+#define GFX_PATCH_CHUNKS 64
+
+typedef struct {
+  int count;
+  u16 chunk[GFX_PATCH_CHUNKS];
+  u8 data[GFX_PATCH_CHUNKS][GFX_CHUNK_SIZE];
+} GfxLinePatch;
+
+bool gfxRenderCopies = false;
+u8 gfxDirty[GFX_CHUNKS];
+static u16 gfxDirtyList[GFX_CHUNKS];
+static int gfxDirtyCount = 0;
+
+static u8 gfxVramCopy[0x20000];
+static u8 gfxPaletteCopy[0x400];
+static u8 gfxOamCopy[0x400];
+
+#ifdef _WIN32
+typedef HANDLE gfx_sem;
+
+static bool gfxSemInit(gfx_sem *s)
+{
+  *s = CreateSemaphore(NULL, 0, GFX_QUEUE_SIZE + 1, NULL);
+  return *s != NULL;
+}
+
+static void gfxSemFree(gfx_sem *s)
+{
+  CloseHandle(*s);
+}
+
+static void gfxSemPost(gfx_sem *s)
+{
+  ReleaseSemaphore(*s, 1, NULL);
+}
+
+static void gfxSemWait(gfx_sem *s)
+{
+  WaitForSingleObject(*s, INFINITE);
+}
+#else
+// unnamed POSIX semaphores are missing on OS X, so build one
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int count;
+} gfx_sem;
+
+static bool gfxSemInit(gfx_sem *s)
+{
+  s->count = 0;
+  if(pthread_mutex_init(&s->mutex, NULL))
+    return false;
+  if(pthread_cond_init(&s->cond, NULL)) {
+    pthread_mutex_destroy(&s->mutex);
+    return false;
+  }
+  return true;
+}
+
+static void gfxSemFree(gfx_sem *s)
+{
+  pthread_cond_destroy(&s->cond);
+  pthread_mutex_destroy(&s->mutex);
+}
+
+static void gfxSemPost(gfx_sem *s)
+{
+  pthread_mutex_lock(&s->mutex);
+  s->count++;
+  pthread_cond_signal(&s->cond);
+  pthread_mutex_unlock(&s->mutex);
+}
+
+static void gfxSemWait(gfx_sem *s)
+{
+  pthread_mutex_lock(&s->mutex);
+  while(s->count == 0)
+    pthread_cond_wait(&s->cond, &s->mutex);
+  s->count--;
+  pthread_mutex_unlock(&s->mutex);
+}
+#endif
+
+static GfxLineState gfxQueue[GFX_QUEUE_SIZE];
+static GfxLinePatch gfxQueuePatch[GFX_QUEUE_SIZE];
+static int gfxQueueHead = 0; // next slot the CPU fills
+static int gfxQueueTail = 0; // next slot the worker draws
+static gfx_sem gfxLinesReady;
+static gfx_sem gfxLinesDone;
+static bool gfxWorkerQuit = false;
+static bool gfxWorkerRunning = false;
+#ifdef _WIN32
+static HANDLE gfxWorker;
+#else
+static pthread_t gfxWorker;
+#endif
+
+static u8 *gfxChunkAddress(int chunk, bool copy)
+{
+  if(chunk >= GFX_CHUNK_OAM)
+    return (copy ? gfxOamCopy : oam) + ((chunk - GFX_CHUNK_OAM) << GFX_CHUNK_SHIFT);
+  if(chunk >= GFX_CHUNK_PALETTE)
+    return (copy ? gfxPaletteCopy : paletteRAM) + ((chunk - GFX_CHUNK_PALETTE) << GFX_CHUNK_SHIFT);
+  return (copy ? gfxVramCopy : vram) + (chunk << GFX_CHUNK_SHIFT);
+}
+
+void gfxMarkDirty(int chunk)
+{
+  gfxDirty[chunk] = 1;
+  gfxDirtyList[gfxDirtyCount++] = chunk;
+}
+
+static void gfxClearDirty()
+{
+  for(int i = 0; i < gfxDirtyCount; i++)
+    gfxDirty[gfxDirtyList[i]] = 0;
+  gfxDirtyCount = 0;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI gfxRenderWorker(LPVOID)
+#else
+static void *gfxRenderWorker(void *)
+#endif
+{
+  for(;;) {
+    gfxSemWait(&gfxLinesReady);
+    if(gfxWorkerQuit)
+      break;
+    GfxLinePatch *patch = &gfxQueuePatch[gfxQueueTail];
+    for(int i = 0; i < patch->count; i++)
+      memcpy(gfxChunkAddress(patch->chunk[i], true), patch->data[i], GFX_CHUNK_SIZE);
+    gfxLine = gfxQueue[gfxQueueTail];
+    gfxQueueTail = (gfxQueueTail + 1) & (GFX_QUEUE_SIZE - 1);
+    gfxDrawLine();
+    gfxSemPost(&gfxLinesDone);
+  }
+  return 0;
+}
+
+bool gfxRenderThreadStart()
+{
+  if(gfxWorkerRunning)
+    return true;
+
+  if(!gfxSemInit(&gfxLinesReady))
+    return false;
+  if(!gfxSemInit(&gfxLinesDone)) {
+    gfxSemFree(&gfxLinesReady);
+    return false;
+  }
+
+  gfxQueueHead = gfxQueueTail = 0;
+  gfxLinesQueued = 0;
+  gfxWorkerQuit = false;
+#ifdef _WIN32
+  gfxWorker = CreateThread(NULL, 0, gfxRenderWorker, NULL, 0, NULL);
+  gfxWorkerRunning = gfxWorker != NULL;
+#else
+  gfxWorkerRunning = pthread_create(&gfxWorker, NULL, gfxRenderWorker, NULL) == 0;
+#endif
+  if(!gfxWorkerRunning) {
+    gfxSemFree(&gfxLinesDone);
+    gfxSemFree(&gfxLinesReady);
+    return false;
+  }
+
+  gfxRenderCopies = true;
+  gfxRenderReload();
+  return true;
+}
+
+void gfxRenderThreadStop()
+{
+  if(!gfxWorkerRunning)
+    return;
+
+  gfxRenderSync();
+  gfxWorkerQuit = true;
+  gfxSemPost(&gfxLinesReady);
+#ifdef _WIN32
+  WaitForSingleObject(gfxWorker, INFINITE);
+  CloseHandle(gfxWorker);
+#else
+  pthread_join(gfxWorker, NULL);
+#endif
+  gfxSemFree(&gfxLinesDone);
+  gfxSemFree(&gfxLinesReady);
+  gfxWorkerRunning = false;
+
+  gfxRenderCopies = false;
+  gfxRenderReload();
+}
+
+// Returns the queue slot for the next line, waiting for the worker if the
+// queue is full
+GfxLineState *gfxNextLine()
+{
+  if(gfxLinesQueued == GFX_QUEUE_SIZE) {
+    gfxSemWait(&gfxLinesDone);
+    gfxLinesQueued--;
+  }
+  return &gfxQueue[gfxQueueHead];
+}
+
+void gfxQueueLine()
+{
+  GfxLinePatch *patch = &gfxQueuePatch[gfxQueueHead];
+  patch->count = 0;
+  if(gfxDirtyCount > GFX_PATCH_CHUNKS) {
+    gfxRenderSync();
+    for(int i = 0; i < gfxDirtyCount; i++)
+      memcpy(gfxChunkAddress(gfxDirtyList[i], true),
+             gfxChunkAddress(gfxDirtyList[i], false), GFX_CHUNK_SIZE);
+  } else {
+    for(int i = 0; i < gfxDirtyCount; i++) {
+      patch->chunk[i] = gfxDirtyList[i];
+      memcpy(patch->data[i], gfxChunkAddress(gfxDirtyList[i], false), GFX_CHUNK_SIZE);
+    }
+    patch->count = gfxDirtyCount;
+  }
+  gfxClearDirty();
+
+  gfxQueueHead = (gfxQueueHead + 1) & (GFX_QUEUE_SIZE - 1);
+  gfxLinesQueued++;
+  gfxSemPost(&gfxLinesReady);
+}
+
+// Waits until every queued line has been drawn
+void gfxRenderSync()
+{
+  while(gfxLinesQueued) {
+    gfxSemWait(&gfxLinesDone);
+    gfxLinesQueued--;
+  }
+}
+
+// Points the renderers at VRAM, palette and OAM, and with the render thread
+// running brings its copies in line with them. CPULoop calls this on entry,
+// for whatever changed them without CPURenderWrite in between: loading a ROM
+// or a state, a reset or a memory viewer; so does the BIOS when it clears them.
+void gfxRenderReload()
+{
+  if(!gfxRenderCopies) {
+    gfxClearDirty();
+    gfxVram = vram;
+    gfxPalette = paletteRAM;
+    gfxOam = oam;
+    return;
+  }
+
+  gfxRenderSync();
+  memcpy(gfxVramCopy, vram, sizeof(gfxVramCopy));
+  memcpy(gfxPaletteCopy, paletteRAM, sizeof(gfxPaletteCopy));
+  memcpy(gfxOamCopy, oam, sizeof(gfxOamCopy));
+  gfxClearDirty();
+  gfxVram = gfxVramCopy;
+  gfxPalette = gfxPaletteCopy;
+  gfxOam = gfxOamCopy;
+}
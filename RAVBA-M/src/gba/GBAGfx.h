@@ -91,6 +91,85 @@ extern int gfxBG3X;
 extern int gfxBG3Y;
 extern int gfxLastVCOUNT;
 
+// VRAM, palette and OAM as the line renderers see them: the live arrays, or
+// the render thread's own copies while it is running, see gfxRenderReload
+extern u8 *gfxVram;
+extern u8 *gfxPalette;
+extern u8 *gfxOam;
+
+// Everything the line renderers read apart from VRAM, palette and OAM.
+// CPULoop fills one of these at the end of every visible line, so the line
+// can be drawn later on the render thread while the CPU carries on.
+typedef struct {
+  void (*render)();
+  u16 VCOUNT;
+  u16 DISPCNT;
+  u16 BG0CNT;
+  u16 BG1CNT;
+  u16 BG2CNT;
+  u16 BG3CNT;
+  u16 BG0HOFS;
+  u16 BG0VOFS;
+  u16 BG1HOFS;
+  u16 BG1VOFS;
+  u16 BG2HOFS;
+  u16 BG2VOFS;
+  u16 BG3HOFS;
+  u16 BG3VOFS;
+  u16 BG2PA;
+  u16 BG2PB;
+  u16 BG2PC;
+  u16 BG2PD;
+  u16 BG2X_L;
+  u16 BG2X_H;
+  u16 BG2Y_L;
+  u16 BG2Y_H;
+  u16 BG3PA;
+  u16 BG3PB;
+  u16 BG3PC;
+  u16 BG3PD;
+  u16 BG3X_L;
+  u16 BG3X_H;
+  u16 BG3Y_L;
+  u16 BG3Y_H;
+  u16 WIN0H;
+  u16 WIN1H;
+  u16 WIN0V;
+  u16 WIN1V;
+  u16 WININ;
+  u16 WINOUT;
+  u16 MOSAIC;
+  u16 BLDMOD;
+  u16 COLEV;
+  u16 COLY;
+  int layerEnable;
+  int customBackdropColor;
+  int bg2Changed; // BG2X/BG2Y writes since the previous line
+  int bg3Changed;
+} GfxLineState;
+
+// line being drawn; only the renderer touches it while lines are queued
+extern GfxLineState gfxLine;
+extern int gfxLinesQueued;
+
+extern void gfxDrawLine();
+extern bool gfxRenderThreadStart();
+extern void gfxRenderThreadStop();
+extern GfxLineState *gfxNextLine();
+extern void gfxQueueLine();
+extern void gfxRenderSync();
+extern void gfxRenderReload();
+
+// Layer merge and color effects for a whole line, see GBAGfxMerge.cpp.
+// mask holds a layer mask per pixel as in WININ/WINOUT.
+enum { GFX_MERGE_C, GFX_MERGE_SSE2, GFX_MERGE_AVX2 };
+
+extern void (*gfxMergeLine)(u32 *dest, const u32 *bg0, const u32 *bg1,
+                            const u32 *bg2, const u32 *bg3, const u32 *obj,
+                            const u8 *mask, u32 backdrop);
+extern int gfxMergeSelect(int level);
+extern void gfxWindowMask(u8 *mask);
+
 static inline void gfxClearArray(u32 *array)
 {
   for(int i = 0; i < 240; i++) {
@@ -101,9 +180,9 @@ static inline void gfxClearArray(u32 *array)
 static inline void gfxDrawTextScreen(u16 control, u16 hofs, u16 vofs,
 				     u32 *line)
 {
-  u16 *palette = (u16 *)paletteRAM;
-  u8 *charBase = &vram[((control >> 2) & 0x03) * 0x4000];
-  u16 *screenBase = (u16 *)&vram[((control >> 8) & 0x1f) * 0x800];
+  u16 *palette = (u16 *)gfxPalette;
+  u8 *charBase = &gfxVram[((control >> 2) & 0x03) * 0x4000];
+  u16 *screenBase = (u16 *)&gfxVram[((control >> 8) & 0x1f) * 0x800];
   u32 prio = ((control & 3)<<25) + 0x1000000;
   int sizeX = 256;
   int sizeY = 256;
@@ -128,13 +207,13 @@ static inline void gfxDrawTextScreen(u16 control, u16 hofs, u16 vofs,
   bool mosaicOn = (control & 0x40) ? true : false;
 
   int xxx = hofs & maskX;
-  int yyy = (vofs + VCOUNT) & maskY;
-  int mosaicX = (MOSAIC & 0x000F)+1;
-  int mosaicY = ((MOSAIC & 0x00F0)>>4)+1;
+  int yyy = (vofs + gfxLine.VCOUNT) & maskY;
+  int mosaicX = (gfxLine.MOSAIC & 0x000F)+1;
+  int mosaicY = ((gfxLine.MOSAIC & 0x00F0)>>4)+1;
 
   if(mosaicOn) {
-    if((VCOUNT % mosaicY) != 0) {
-      mosaicY = VCOUNT - (VCOUNT % mosaicY);
+    if((gfxLine.VCOUNT % mosaicY) != 0) {
+      mosaicY = gfxLine.VCOUNT - (gfxLine.VCOUNT % mosaicY);
       yyy = (vofs + mosaicY) & maskY;
     }
   }
@@ -248,9 +327,9 @@ static inline void gfxDrawRotScreen(u16 control,
 				    int changed,
 				    u32 *line)
 {
-  u16 *palette = (u16 *)paletteRAM;
-  u8 *charBase = &vram[((control >> 2) & 0x03) * 0x4000];
-  u8 *screenBase = (u8 *)&vram[((control >> 8) & 0x1f) * 0x800];
+  u16 *palette = (u16 *)gfxPalette;
+  u8 *charBase = &gfxVram[((control >> 2) & 0x03) * 0x4000];
+  u8 *screenBase = (u8 *)&gfxVram[((control >> 8) & 0x1f) * 0x800];
   int prio = ((control & 3) << 25) + 0x1000000;
 
   int sizeX = 128;
@@ -287,7 +366,7 @@ static inline void gfxDrawRotScreen(u16 control,
   if(pd & 0x8000)
     dmy |= 0xFFFF8000;
 
-  if(VCOUNT == 0)
+  if(gfxLine.VCOUNT == 0)
     changed = 3;
 
   if(changed & 1) {
@@ -310,8 +389,8 @@ static inline void gfxDrawRotScreen(u16 control,
   int realY = currentY;
 
   if(control & 0x40) {
-    int mosaicY = ((MOSAIC & 0xF0)>>4) + 1;
-    int y = (VCOUNT % mosaicY);
+    int mosaicY = ((gfxLine.MOSAIC & 0xF0)>>4) + 1;
+    int y = (gfxLine.VCOUNT % mosaicY);
     realX -= y*dmx;
     realY -= y*dmy;
   }
@@ -359,7 +438,7 @@ static inline void gfxDrawRotScreen(u16 control,
   }
 
   if(control & 0x40) {
-    int mosaicX = (MOSAIC & 0xF) + 1;
+    int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
     if(mosaicX > 1) {
       int m = 1;
       for(int i = 0; i < 239; i++) {
@@ -383,7 +462,7 @@ static inline void gfxDrawRotScreen16Bit(u16 control,
 					 int changed,
 					 u32 *line)
 {
-  u16 *screenBase = (u16 *)&vram[0];
+  u16 *screenBase = (u16 *)&gfxVram[0];
   int prio = ((control & 3) << 25) + 0x1000000;
   int sizeX = 240;
   int sizeY = 160;
@@ -408,7 +487,7 @@ static inline void gfxDrawRotScreen16Bit(u16 control,
   if(pd & 0x8000)
     dmy |= 0xFFFF8000;
 
-  if(VCOUNT == 0)
+  if(gfxLine.VCOUNT == 0)
     changed = 3;
 
   if(changed & 1) {
@@ -430,8 +509,8 @@ static inline void gfxDrawRotScreen16Bit(u16 control,
   int realY = currentY;
 
   if(control & 0x40) {
-    int mosaicY = ((MOSAIC & 0xF0)>>4) + 1;
-    int y = (VCOUNT % mosaicY);
+    int mosaicY = ((gfxLine.MOSAIC & 0xF0)>>4) + 1;
+    int y = (gfxLine.VCOUNT % mosaicY);
     realX -= y*dmx;
     realY -= y*dmy;
   }
@@ -456,7 +535,7 @@ static inline void gfxDrawRotScreen16Bit(u16 control,
   }
 
   if(control & 0x40) {
-    int mosaicX = (MOSAIC & 0xF) + 1;
+    int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
     if(mosaicX > 1) {
       int m = 1;
       for(int i = 0; i < 239; i++) {
@@ -480,8 +559,8 @@ static inline void gfxDrawRotScreen256(u16 control,
 				       int changed,
 				       u32 *line)
 {
-  u16 *palette = (u16 *)paletteRAM;
-  u8 *screenBase = (DISPCNT & 0x0010) ? &vram[0xA000] : &vram[0x0000];
+  u16 *palette = (u16 *)gfxPalette;
+  u8 *screenBase = (gfxLine.DISPCNT & 0x0010) ? &gfxVram[0xA000] : &gfxVram[0x0000];
   int prio = ((control & 3) << 25) + 0x1000000;
   int sizeX = 240;
   int sizeY = 160;
@@ -506,7 +585,7 @@ static inline void gfxDrawRotScreen256(u16 control,
   if(pd & 0x8000)
     dmy |= 0xFFFF8000;
 
-  if(VCOUNT == 0)
+  if(gfxLine.VCOUNT == 0)
     changed = 3;
 
   if(changed & 1) {
@@ -529,8 +608,8 @@ static inline void gfxDrawRotScreen256(u16 control,
   int realY = currentY;
 
   if(control & 0x40) {
-    int mosaicY = ((MOSAIC & 0xF0)>>4) + 1;
-    int y = VCOUNT - (VCOUNT % mosaicY);
+    int mosaicY = ((gfxLine.MOSAIC & 0xF0)>>4) + 1;
+    int y = gfxLine.VCOUNT - (gfxLine.VCOUNT % mosaicY);
     realX = startX + y*dmx;
     realY = startY + y*dmy;
   }
@@ -557,7 +636,7 @@ static inline void gfxDrawRotScreen256(u16 control,
   }
 
   if(control & 0x40) {
-    int mosaicX = (MOSAIC & 0xF) + 1;
+    int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
     if(mosaicX > 1) {
       int m = 1;
       for(int i = 0; i < 239; i++) {
@@ -581,8 +660,8 @@ static inline void gfxDrawRotScreen16Bit160(u16 control,
 					    int changed,
 					    u32 *line)
 {
-  u16 *screenBase = (DISPCNT & 0x0010) ? (u16 *)&vram[0xa000] :
-    (u16 *)&vram[0];
+  u16 *screenBase = (gfxLine.DISPCNT & 0x0010) ? (u16 *)&gfxVram[0xa000] :
+    (u16 *)&gfxVram[0];
   int prio = ((control & 3) << 25) + 0x1000000;
   int sizeX = 160;
   int sizeY = 128;
@@ -607,7 +686,7 @@ static inline void gfxDrawRotScreen16Bit160(u16 control,
   if(pd & 0x8000)
     dmy |= 0xFFFF8000;
 
-  if(VCOUNT == 0)
+  if(gfxLine.VCOUNT == 0)
     changed = 3;
 
   if(changed & 1) {
@@ -630,8 +709,8 @@ static inline void gfxDrawRotScreen16Bit160(u16 control,
   int realY = currentY;
 
   if(control & 0x40) {
-    int mosaicY = ((MOSAIC & 0xF0)>>4) + 1;
-    int y = VCOUNT - (VCOUNT % mosaicY);
+    int mosaicY = ((gfxLine.MOSAIC & 0xF0)>>4) + 1;
+    int y = gfxLine.VCOUNT - (gfxLine.VCOUNT % mosaicY);
     realX = startX + y*dmx;
     realY = startY + y*dmy;
   }
@@ -656,7 +735,7 @@ static inline void gfxDrawRotScreen16Bit160(u16 control,
   }
 
   if(control & 0x40) {
-    int mosaicX = (MOSAIC & 0xF) + 1;
+    int mosaicX = (gfxLine.MOSAIC & 0xF) + 1;
     if(mosaicX > 1) {
       int m = 1;
       for(int i = 0; i < 239; i++) {
@@ -676,14 +755,14 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
   // lineOBJpix is used to keep track of the drawn OBJs
   // and to stop drawing them if the 'maximum number of OBJ per line'
   // has been reached.
-  int lineOBJpix = (DISPCNT & 0x20) ? 954 : 1226;
+  int lineOBJpix = (gfxLine.DISPCNT & 0x20) ? 954 : 1226;
   int m=0;
   gfxClearArray(lineOBJ);
-  if(layerEnable & 0x1000) {
-    u16 *sprites = (u16 *)oam;
-    u16 *spritePalette = &((u16 *)paletteRAM)[256];
-    int mosaicY = ((MOSAIC & 0xF000)>>12) + 1;
-    int mosaicX = ((MOSAIC & 0xF00)>>8) + 1;
+  if(gfxLine.layerEnable & 0x1000) {
+    u16 *sprites = (u16 *)gfxOam;
+    u16 *spritePalette = &((u16 *)gfxPalette)[256];
+    int mosaicY = ((gfxLine.MOSAIC & 0xF000)>>12) + 1;
+    int mosaicX = ((gfxLine.MOSAIC & 0xF00)>>8) + 1;
     for(int x = 0; x < 128 ; x++) {
       u16 a0 = READ16LE(sprites++);
       u16 a1 = READ16LE(sprites++);
@@ -732,7 +811,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
       int sx = (a1 & 0x1FF);
 
       // computes ticks used by OBJ-WIN if OBJWIN is enabled
-      if (((a0 & 0x0c00) == 0x0800) && (layerEnable & 0x8000))
+      if (((a0 & 0x0c00) == 0x0800) && (gfxLine.layerEnable & 0x8000))
       {
         if ((a0 & 0x0300) == 0x0300)
         {
@@ -750,7 +829,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
         }
         else if ((sx+sizeX)>240)
             sizeX=240-sx;
-        if ((VCOUNT>=sy) && (VCOUNT<sy+sizeY) && (sx<240))
+        if ((gfxLine.VCOUNT>=sy) && (gfxLine.VCOUNT<sy+sizeY) && (sx<240))
         {
           if (a0 & 0x0100)
             lineOBJpix-=8+2*sizeX;
@@ -778,7 +857,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
         }
         if((sy+fieldY) > 256)
           sy -= 256;
-        int t = VCOUNT - sy;
+        int t = gfxLine.VCOUNT - sy;
         if((t >= 0) && (t < fieldY)) {
           int startpix = 0;
           if ((sx+fieldX)> 512)
@@ -790,7 +869,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
             lineOBJpix-=8;
             // int t2 = t - (fieldY >> 1);
             int rot = (a1 >> 9) & 0x1F;
-            u16 *OAM = (u16 *)oam;
+            u16 *OAM = (u16 *)gfxOam;
             int dx = READ16LE(&OAM[3 + (rot << 4)]);
             if(dx & 0x8000)
               dx |= 0xFFFF8000;
@@ -817,10 +896,10 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
 
             if(a0 & 0x2000) {
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
               int inc = 32;
-              if(DISPCNT & 0x40)
+              if(gfxLine.DISPCNT & 0x40)
                 inc = sizeX >> 2;
               else
                 c &= 0x3FE;
@@ -836,7 +915,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
                    yyy < 0 || yyy >= sizeY ||
                    sx >= 240);
                 else {
-                  u32 color = vram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
+                  u32 color = gfxVram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
 									+ ((yyy & 7)<<3) + ((xxx >> 3)<<6) +
                                     (xxx & 7))&0x7FFF)];
                   if ((color==0) && (((prio >> 25)&3) <
@@ -866,11 +945,11 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
               }
             } else {
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40)
+              if(gfxLine.DISPCNT & 0x40)
                 inc = sizeX >> 3;
               int palette = (a2 >> 8) & 0xF0;
               for(int x = 0; x < fieldX; x++) {
@@ -884,7 +963,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
                    yyy < 0 || yyy >= sizeY ||
                    sx >= 240);
                 else {
-                  u32 color = vram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
+                  u32 color = gfxVram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
                                                 + ((yyy & 7)<<2) + ((xxx >> 3)<<5) +
                                                ((xxx & 7)>>1))&0x7FFF)];
                   if(xxx & 1)
@@ -924,7 +1003,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
       } else {
         if(sy+sizeY > 256)
           sy -= 256;
-        int t = VCOUNT - sy;
+        int t = gfxLine.VCOUNT - sy;
         if((t >= 0) && (t < sizeY)) {
           int startpix = 0;
           if ((sx+sizeX)> 512)
@@ -937,11 +1016,11 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
               if(a1 & 0x2000)
                 t = sizeY - t - 1;
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40) {
+              if(gfxLine.DISPCNT & 0x40) {
                 inc = sizeX >> 2;
               } else {
                 c &= 0x3FE;
@@ -967,7 +1046,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
                 if (lineOBJpix<0)
                   continue;
                 if(sx < 240) {
-                  u8 color = vram[address];
+                  u8 color = gfxVram[address];
                   if ((color==0) && (((prio >> 25)&3) <
                                      ((lineOBJ[sx]>>25)&3))) {
                     lineOBJ[sx] = (lineOBJ[sx] & 0xF9FFFFFF) | prio;
@@ -1016,11 +1095,11 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
               if(a1 & 0x2000)
                 t = sizeY - t - 1;
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40) {
+              if(gfxLine.DISPCNT & 0x40) {
                 inc = sizeX >> 3;
               }
               int xxx = 0;
@@ -1043,7 +1122,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
                   if (lineOBJpix<0)
                     continue;
                   if(sx < 240) {
-                    u8 color = vram[address];
+                    u8 color = gfxVram[address];
                     if(xx & 1) {
                       color = (color >> 4);
                     } else
@@ -1087,7 +1166,7 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
                   if (lineOBJpix<0)
                     continue;
                   if(sx < 240) {
-                    u8 color = vram[address];
+                    u8 color = gfxVram[address];
                     if(xx & 1) {
                       color = (color >> 4);
                     } else
@@ -1137,9 +1216,9 @@ static inline void gfxDrawSprites(u32 *lineOBJ)
 static inline void gfxDrawOBJWin(u32 *lineOBJWin)
 {
   gfxClearArray(lineOBJWin);
-  if((layerEnable & 0x9000) == 0x9000) {
-    u16 *sprites = (u16 *)oam;
-    // u16 *spritePalette = &((u16 *)paletteRAM)[256];
+  if((gfxLine.layerEnable & 0x9000) == 0x9000) {
+    u16 *sprites = (u16 *)gfxOam;
+    // u16 *spritePalette = &((u16 *)gfxPalette)[256];
     for(int x = 0; x < 128 ; x++) {
       int lineOBJpix = lineOBJpixleft[x];
       u16 a0 = READ16LE(sprites++);
@@ -1192,7 +1271,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
         }
         if((sy+fieldY) > 256)
           sy -= 256;
-        int t = VCOUNT - sy;
+        int t = gfxLine.VCOUNT - sy;
         if((t >= 0) && (t < fieldY)) {
           int sx = (a1 & 0x1FF);
           int startpix = 0;
@@ -1204,7 +1283,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
             lineOBJpix-=8;
             // int t2 = t - (fieldY >> 1);
             int rot = (a1 >> 9) & 0x1F;
-            u16 *OAM = (u16 *)oam;
+            u16 *OAM = (u16 *)gfxOam;
             int dx = READ16LE(&OAM[3 + (rot << 4)]);
             if(dx & 0x8000)
               dx |= 0xFFFF8000;
@@ -1227,10 +1306,10 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
 
             if(a0 & 0x2000) {
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
               int inc = 32;
-              if(DISPCNT & 0x40)
+              if(gfxLine.DISPCNT & 0x40)
                 inc = sizeX >> 2;
               else
                 c &= 0x3FE;
@@ -1246,7 +1325,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
                    yyy < 0 || yyy >= sizeY ||
                    sx >= 240) {
                 } else {
-                  u32 color = vram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
+                  u32 color = gfxVram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
                                     + ((yyy & 7)<<3) + ((xxx >> 3)<<6) +
                                    (xxx & 7))&0x7fff)];
                   if(color) {
@@ -1259,11 +1338,11 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
               }
             } else {
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40)
+              if(gfxLine.DISPCNT & 0x40)
                 inc = sizeX >> 3;
               // int palette = (a2 >> 8) & 0xF0;
               for(int x = 0; x < fieldX; x++) {
@@ -1282,7 +1361,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
                      yyy < 0 || yyy >= sizeY ||
                      sx >= 240) {
                   } else {
-                    u32 color = vram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
+                    u32 color = gfxVram[0x10000 + ((((c + (yyy>>3) * inc)<<5)
                                      + ((yyy & 7)<<2) + ((xxx >> 3)<<5) +
                                      ((xxx & 7)>>1))&0x7fff)];
                     if(xxx & 1)
@@ -1305,7 +1384,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
       } else {
         if((sy+sizeY) > 256)
           sy -= 256;
-        int t = VCOUNT - sy;
+        int t = gfxLine.VCOUNT - sy;
         if((t >= 0) && (t < sizeY)) {
           int sx = (a1 & 0x1FF);
           int startpix = 0;
@@ -1319,11 +1398,11 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
               if(a1 & 0x2000)
                 t = sizeY - t - 1;
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40) {
+              if(gfxLine.DISPCNT & 0x40) {
                 inc = sizeX >> 2;
               } else {
                 c &= 0x3FE;
@@ -1342,7 +1421,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
                 if (lineOBJpix<0)
                   continue;
                 if(sx < 240) {
-                  u8 color = vram[address];
+                  u8 color = gfxVram[address];
                   if(color) {
                     lineOBJWin[sx] = 1;
                   }
@@ -1373,11 +1452,11 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
               if(a1 & 0x2000)
                 t = sizeY - t - 1;
               int c = (a2 & 0x3FF);
-              if((DISPCNT & 7) > 2 && (c < 512))
+              if((gfxLine.DISPCNT & 7) > 2 && (c < 512))
                 continue;
 
               int inc = 32;
-              if(DISPCNT & 0x40) {
+              if(gfxLine.DISPCNT & 0x40) {
                 inc = sizeX >> 3;
               }
               int xxx = 0;
@@ -1395,7 +1474,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
                   if (lineOBJpix<0)
                     continue;
                   if(sx < 240) {
-                    u8 color = vram[address];
+                    u8 color = gfxVram[address];
                     if(xx & 1) {
                       color = (color >> 4);
                     } else
@@ -1423,7 +1502,7 @@ static inline void gfxDrawOBJWin(u32 *lineOBJWin)
                   if (lineOBJpix<0)
                     continue;
                   if(sx < 240) {
-                    u8 color = vram[address];
+                    u8 color = gfxVram[address];
                     if(xx & 1) {
                       color = (color >> 4);
                     } else
@@ -0,0 +1,621 @@
+#include <string.h>
+#include "GBA.h"
+#include "Globals.h"
+#include "GBAGfx.h"
+
+// GCC before 4.9 can't build SSE2/AVX2 functions into a file compiled
+// without -msse2/-mavx2, so those get the C version only
+#if defined(_M_X64) || defined(_M_IX86) || \
+    ((defined(__x86_64__) || defined(__i386__)) && \
+     (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define GFX_HAVE_X86
+#include <emmintrin.h>
+#if !defined(_MSC_VER) || _MSC_VER >= 1700
+#define GFX_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and clang only allow SSE2/AVX2 intrinsics in functions built for them
+#ifdef __GNUC__
+#define GFX_TARGET(x) __attribute__((target(x)))
+#else
+#define GFX_TARGET(x)
+#endif
+
+static void gfxMergeLineDetect(u32 *, const u32 *, const u32 *, const u32 *,
+                               const u32 *, const u32 *, const u8 *, u32);
+
+void (*gfxMergeLine)(u32 *, const u32 *, const u32 *, const u32 *,
+                     const u32 *, const u32 *, const u8 *, u32) = gfxMergeLineDetect;
+
+// Builds the per-pixel layer mask used by the windowed renderers. Needs
+// gfxInWin0/gfxInWin1 and lineOBJWin for the current line.
+void gfxWindowMask(u8 *mask)
+{
+  bool inWindow0 = false;
+  bool inWindow1 = false;
+
+  if(gfxLine.layerEnable & 0x2000) {
+    u8 v0 = gfxLine.WIN0V >> 8;
+    u8 v1 = gfxLine.WIN0V & 255;
+    inWindow0 = ((v0 == v1) && (v0 >= 0xe8));
+    if(v1 >= v0)
+      inWindow0 |= (gfxLine.VCOUNT >= v0 && gfxLine.VCOUNT < v1);
+    else
+      inWindow0 |= (gfxLine.VCOUNT >= v0 || gfxLine.VCOUNT < v1);
+  }
+  if(gfxLine.layerEnable & 0x4000) {
+    u8 v0 = gfxLine.WIN1V >> 8;
+    u8 v1 = gfxLine.WIN1V & 255;
+    inWindow1 = ((v0 == v1) && (v0 >= 0xe8));
+    if(v1 >= v0)
+      inWindow1 |= (gfxLine.VCOUNT >= v0 && gfxLine.VCOUNT < v1);
+    else
+      inWindow1 |= (gfxLine.VCOUNT >= v0 || gfxLine.VCOUNT < v1);
+  }
+
+  u8 inWin0Mask = gfxLine.WININ & 0xFF;
+  u8 inWin1Mask = gfxLine.WININ >> 8;
+  u8 outMask = gfxLine.WINOUT & 0xFF;
+  u8 objMask = gfxLine.WINOUT >> 8;
+
+  for(int x = 0; x < 240; x++) {
+    u8 m = outMask;
+
+    if(!(lineOBJWin[x] & 0x80000000))
+      m = objMask;
+    if(inWindow1 && gfxInWin1[x])
+      m = inWin1Mask;
+    if(inWindow0 && gfxInWin0[x])
+      m = inWin0Mask;
+
+    mask[x] = m;
+  }
+}
+
+// transparent line standing in for layers a mode doesn't have
+static u32 gfxNoLayer[240];
+
+// Instantiates a kernel for the layer sets the video modes use, so missing
+// layers cost nothing. Other sets go through the full version.
+#define GFX_MERGE_DISPATCH(kernel) \
+  switch((bg0 ? 0x01 : 0) | (bg1 ? 0x02 : 0) | (bg2 ? 0x04 : 0) | (bg3 ? 0x08 : 0)) { \
+  case 0x0F: \
+    kernel<0x1F>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop); \
+    break; \
+  case 0x07: \
+    kernel<0x17>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop); \
+    break; \
+  case 0x0C: \
+    kernel<0x1C>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop); \
+    break; \
+  case 0x04: \
+    kernel<0x14>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop); \
+    break; \
+  default: \
+    kernel<0x1F>(dest, bg0 ? bg0 : gfxNoLayer, bg1 ? bg1 : gfxNoLayer, \
+                 bg2 ? bg2 : gfxNoLayer, bg3 ? bg3 : gfxNoLayer, obj, mask, backdrop); \
+    break; \
+  }
+
+// Takes line[x] if its layer is enabled in m and in front of c. Without
+// windows every layer the mode has is enabled, so m isn't looked at.
+#define GFX_PICK(id, line, m, c, t) \
+  if((layers & id) && (!windowed || (m & id)) && line[x] < (c & 0xFF000000)) { \
+    c = line[x]; \
+    t = id; \
+  }
+
+// Same for the layer behind the top one
+#define GFX_PICK2(id, line, m, top, c, t) \
+  if((layers & id) && line[x] < (c & 0xFF000000) && top != id && (!windowed || (m & id))) { \
+    c = line[x]; \
+    t = id; \
+  }
+
+// Blending and brightness for one pixel whose top layer is already known.
+// Kept out of the pixel loop so the plain merge stays small.
+template<int layers, bool windowed>
+static u32 gfxMergeFX(int x, const u32 *bg0, const u32 *bg1,
+                      const u32 *bg2, const u32 *bg3, const u32 *obj,
+                      u8 m, u32 backdrop, u32 color, u8 top, bool semi)
+{
+  u16 bldmod = gfxLine.BLDMOD;
+  int effect = (bldmod >> 6) & 3;
+
+  if(semi || (effect == 1 && (top & bldmod))) {
+    u32 back = backdrop;
+    u8 top2 = 0x20;
+
+    GFX_PICK2(0x01, bg0, m, top, back, top2);
+    GFX_PICK2(0x02, bg1, m, top, back, top2);
+    GFX_PICK2(0x04, bg2, m, top, back, top2);
+    GFX_PICK2(0x08, bg3, m, top, back, top2);
+    GFX_PICK2(0x10, obj, m, top, back, top2);
+
+    if(top2 & (bldmod >> 8))
+      return gfxAlphaBlend(color, back, coeff[gfxLine.COLEV & 0x1F],
+                           coeff[(gfxLine.COLEV >> 8) & 0x1F]);
+  }
+
+  if(bldmod & top) {
+    if(effect == 2)
+      return gfxIncreaseBrightness(color, coeff[gfxLine.COLY & 0x1F]);
+    if(effect == 3)
+      return gfxDecreaseBrightness(color, coeff[gfxLine.COLY & 0x1F]);
+  }
+
+  return color;
+}
+
+// Reference version. For every pixel the top layer allowed by mask wins
+// (bits 0-3 BG0-BG3, bit 4 OBJ), then semi-transparent OBJ are always
+// blended and the BLDMOD effect is applied where mask bit 5 is set.
+// layers holds the same bits for the layers the current mode has. When
+// windowed is false the mask is the same for the whole line and enables
+// all of them, so the loop only needs its effect bit.
+template<int layers, bool windowed>
+static void gfxMergeC(u32 *dest, const u32 *bg0, const u32 *bg1,
+                      const u32 *bg2, const u32 *bg3, const u32 *obj,
+                      const u8 *mask, u32 backdrop)
+{
+  int effect = (gfxLine.BLDMOD >> 6) & 3;
+  bool lineFX = (mask[0] & 0x20) && effect;
+
+  for(int x = 0; x < 240; x++) {
+    u8 m = windowed ? mask[x] : 0x1F;
+    u32 color = backdrop;
+    u8 top = 0x20;
+
+    GFX_PICK(0x01, bg0, m, color, top);
+    GFX_PICK(0x02, bg1, m, color, top);
+    GFX_PICK(0x04, bg2, m, color, top);
+    GFX_PICK(0x08, bg3, m, color, top);
+    GFX_PICK(0x10, obj, m, color, top);
+
+    bool semi = (color & 0x00010000) != 0;
+
+    if(semi || (windowed ? (m & 0x20) && effect : lineFX))
+      color = gfxMergeFX<layers, windowed>(x, bg0, bg1, bg2, bg3, obj, m,
+                                           backdrop, color, top, semi);
+
+    dest[x] = color;
+  }
+}
+
+template<int layers>
+static void gfxMergeWindowC(u32 *dest, const u32 *bg0, const u32 *bg1,
+                            const u32 *bg2, const u32 *bg3, const u32 *obj,
+                            const u8 *mask, u32 backdrop)
+{
+  gfxMergeC<layers, true>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop);
+}
+
+template<int layers>
+static void gfxMergeNoWindowC(u32 *dest, const u32 *bg0, const u32 *bg1,
+                              const u32 *bg2, const u32 *bg3, const u32 *obj,
+                              const u8 *mask, u32 backdrop)
+{
+  gfxMergeC<layers, false>(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop);
+}
+
+// the renderers without windows fill the mask with 0x1F or 0x3F
+static inline bool gfxMergeWindowed(const u8 *mask)
+{
+  return (mask[0] & 0x1F) != 0x1F || memcmp(mask, mask + 1, 239) != 0;
+}
+
+static void gfxMergeLineC(u32 *dest, const u32 *bg0, const u32 *bg1,
+                          const u32 *bg2, const u32 *bg3, const u32 *obj,
+                          const u8 *mask, u32 backdrop)
+{
+  if(gfxMergeWindowed(mask)) {
+    GFX_MERGE_DISPATCH(gfxMergeWindowC)
+  } else {
+    GFX_MERGE_DISPATCH(gfxMergeNoWindowC)
+  }
+}
+
+#ifdef GFX_HAVE_X86
+
+// x * (k & 0xffff) + y * (k >> 16) for spread colors. SSE2 has no 32-bit
+// multiply, so this multiplies the 16-bit halves and adds them up.
+GFX_TARGET("sse2")
+static inline __m128i gfxMulAdd(__m128i x, __m128i y, __m128i k)
+{
+  const __m128i low = _mm_set1_epi32(0xFFFF);
+  __m128i lo = _mm_or_si128(_mm_and_si128(x, low), _mm_slli_epi32(y, 16));
+  __m128i hi = _mm_or_si128(_mm_srli_epi32(x, 16), _mm_andnot_si128(low, y));
+  return _mm_add_epi32(_mm_madd_epi16(lo, k), _mm_slli_epi32(_mm_madd_epi16(hi, k), 16));
+}
+
+GFX_TARGET("sse2")
+static inline __m128i gfxSelect(__m128i sel, __m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(sel, a), _mm_andnot_si128(sel, b));
+}
+
+// ((c & 0xffff) << 16 | (c & 0xffff)) & 0x03E07C1F
+GFX_TARGET("sse2")
+static inline __m128i gfxSpread(__m128i c)
+{
+  c = _mm_and_si128(c, _mm_set1_epi32(0xFFFF));
+  return _mm_and_si128(_mm_or_si128(_mm_slli_epi32(c, 16), c),
+                       _mm_set1_epi32(0x03E07C1F));
+}
+
+// Vector GFX_PICK
+GFX_TARGET("sse2")
+static inline void gfxPickSSE2(const u32 *line, __m128i m, __m128i id,
+                               __m128i &c, __m128i &t)
+{
+  __m128i v = _mm_loadu_si128((const __m128i *)line);
+  __m128i sel = _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(m, id), id),
+                              _mm_cmplt_epi32(_mm_srli_epi32(v, 24), _mm_srli_epi32(c, 24)));
+  c = gfxSelect(sel, v, c);
+  t = gfxSelect(sel, id, t);
+}
+
+template<int layers>
+GFX_TARGET("sse2")
+static void gfxMergeSSE2(u32 *dest, const u32 *bg0, const u32 *bg1,
+                         const u32 *bg2, const u32 *bg3, const u32 *obj,
+                         const u8 *mask, u32 backdrop)
+{
+  u16 bldmod = gfxLine.BLDMOD;
+  int effect = (bldmod >> 6) & 3;
+  int ca = coeff[gfxLine.COLEV & 0x1F];
+  int cb = coeff[(gfxLine.COLEV >> 8) & 0x1F];
+  int cy = coeff[gfxLine.COLY & 0x1F];
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi32(-1);
+  const __m128i rgb = _mm_set1_epi32(0x03E07C1F);
+  const __m128i id0 = _mm_set1_epi32(0x01);
+  const __m128i id1 = _mm_set1_epi32(0x02);
+  const __m128i id2 = _mm_set1_epi32(0x04);
+  const __m128i id3 = _mm_set1_epi32(0x08);
+  const __m128i id4 = _mm_set1_epi32(0x10);
+  const __m128i id5 = _mm_set1_epi32(0x20);
+  const __m128i vBackdrop = _mm_set1_epi32(backdrop);
+  const __m128i vTarget1 = _mm_set1_epi32(bldmod & 0x3F);
+  const __m128i vTarget2 = _mm_set1_epi32((bldmod >> 8) & 0x3F);
+  const __m128i vSemi = _mm_set1_epi32(0x00010000);
+  const __m128i vFX = effect ? id5 : zero;
+  const __m128i vAlphaFX = effect == 1 ? ones : zero;
+  const __m128i vBrightFX = effect >= 2 ? ones : zero;
+  const __m128i vCAB = _mm_set1_epi32(ca | (cb << 16));
+  const __m128i vCY = _mm_set1_epi32(cy);
+
+  for(int x = 0; x < 240; x += 4) {
+    __m128i m = _mm_cvtsi32_si128(*(const int *)(mask + x));
+    m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, zero), zero);
+
+    __m128i color = vBackdrop;
+    __m128i top = id5;
+
+    if(layers & 0x01)
+      gfxPickSSE2(bg0 + x, m, id0, color, top);
+    if(layers & 0x02)
+      gfxPickSSE2(bg1 + x, m, id1, color, top);
+    if(layers & 0x04)
+      gfxPickSSE2(bg2 + x, m, id2, color, top);
+    if(layers & 0x08)
+      gfxPickSSE2(bg3 + x, m, id3, color, top);
+    gfxPickSSE2(obj + x, m, id4, color, top);
+
+    __m128i semi = _mm_cmpeq_epi32(_mm_and_si128(color, vSemi), vSemi);
+    __m128i fx = _mm_andnot_si128(semi, _mm_cmpeq_epi32(_mm_and_si128(m, vFX), id5));
+    __m128i first = _mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(top, vTarget1), zero), ones);
+    __m128i alpha = _mm_or_si128(semi, _mm_and_si128(_mm_and_si128(fx, vAlphaFX), first));
+    __m128i bright = _mm_and_si128(_mm_and_si128(fx, vBrightFX), first);
+
+    if(!_mm_movemask_epi8(_mm_or_si128(alpha, bright))) {
+      _mm_storeu_si128((__m128i *)(dest + x), color);
+      continue;
+    }
+
+    __m128i result = color;
+
+    if(_mm_movemask_epi8(alpha)) {
+      __m128i back = vBackdrop;
+      __m128i top2 = id5;
+
+      // same search without the top layer
+      __m128i m2 = _mm_andnot_si128(top, m);
+
+      if(layers & 0x01)
+        gfxPickSSE2(bg0 + x, m2, id0, back, top2);
+      if(layers & 0x02)
+        gfxPickSSE2(bg1 + x, m2, id1, back, top2);
+      if(layers & 0x04)
+        gfxPickSSE2(bg2 + x, m2, id2, back, top2);
+      if(layers & 0x08)
+        gfxPickSSE2(bg3 + x, m2, id3, back, top2);
+      gfxPickSSE2(obj + x, m2, id4, back, top2);
+
+      __m128i second = _mm_cmpeq_epi32(_mm_and_si128(top2, vTarget2), zero);
+      // semi-transparent OBJ that can't blend get the brightness effect instead
+      bright = _mm_or_si128(bright, _mm_and_si128(_mm_and_si128(semi, second),
+                                                  _mm_and_si128(first, vBrightFX)));
+      alpha = _mm_andnot_si128(second, alpha);
+      alpha = _mm_and_si128(alpha, _mm_cmpgt_epi32(color, ones));
+
+      if(_mm_movemask_epi8(alpha)) {
+        __m128i c = gfxMulAdd(gfxSpread(color), gfxSpread(back), vCAB);
+        c = _mm_srli_epi32(c, 4);
+        if(ca + cb > 16) {
+          __m128i b;
+          b = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(0x20)), zero);
+          c = _mm_or_si128(c, _mm_andnot_si128(b, _mm_set1_epi32(0x1F)));
+          b = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(0x8000)), zero);
+          c = _mm_or_si128(c, _mm_andnot_si128(b, _mm_set1_epi32(0x7C00)));
+          b = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(0x4000000)), zero);
+          c = _mm_or_si128(c, _mm_andnot_si128(b, _mm_set1_epi32(0x03E00000)));
+        }
+        c = _mm_and_si128(c, rgb);
+        c = _mm_or_si128(_mm_srli_epi32(c, 16), c);
+        result = gfxSelect(alpha, c, result);
+      }
+    }
+
+    if(_mm_movemask_epi8(bright)) {
+      __m128i c = gfxSpread(color);
+      if(effect == 2) {
+        c = _mm_add_epi32(c, _mm_srli_epi32(gfxMulAdd(_mm_sub_epi32(rgb, c), zero, vCY), 4));
+        c = _mm_and_si128(c, rgb);
+      } else {
+        c = _mm_sub_epi32(c, _mm_and_si128(_mm_srli_epi32(gfxMulAdd(c, zero, vCY), 4), rgb));
+      }
+      c = _mm_or_si128(_mm_srli_epi32(c, 16), c);
+      result = gfxSelect(bright, c, result);
+    }
+
+    _mm_storeu_si128((__m128i *)(dest + x), result);
+  }
+}
+
+static void gfxMergeLineSSE2(u32 *dest, const u32 *bg0, const u32 *bg1,
+                             const u32 *bg2, const u32 *bg3, const u32 *obj,
+                             const u8 *mask, u32 backdrop)
+{
+  // without windows the C loop never reads the mask and beats four pixels
+  // a step, so SSE2 only takes the windowed lines
+  if(gfxMergeWindowed(mask)) {
+    GFX_MERGE_DISPATCH(gfxMergeSSE2)
+  } else {
+    GFX_MERGE_DISPATCH(gfxMergeNoWindowC)
+  }
+}
+
+#ifdef GFX_HAVE_AVX2
+
+GFX_TARGET("avx2")
+static inline __m256i gfxSpread256(__m256i c)
+{
+  c = _mm256_and_si256(c, _mm256_set1_epi32(0xFFFF));
+  return _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi32(c, 16), c),
+                          _mm256_set1_epi32(0x03E07C1F));
+}
+
+GFX_TARGET("avx2")
+static inline void gfxPickAVX2(const u32 *line, __m256i m, __m256i id,
+                               __m256i &c, __m256i &t)
+{
+  __m256i v = _mm256_loadu_si256((const __m256i *)line);
+  __m256i sel = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(m, id), id),
+                                 _mm256_cmpgt_epi32(_mm256_srli_epi32(c, 24), _mm256_srli_epi32(v, 24)));
+  c = _mm256_blendv_epi8(c, v, sel);
+  t = _mm256_blendv_epi8(t, id, sel);
+}
+
+// Same as gfxMergeSSE2, eight pixels at a time
+template<int layers>
+GFX_TARGET("avx2")
+static void gfxMergeAVX2(u32 *dest, const u32 *bg0, const u32 *bg1,
+                         const u32 *bg2, const u32 *bg3, const u32 *obj,
+                         const u8 *mask, u32 backdrop)
+{
+  u16 bldmod = gfxLine.BLDMOD;
+  int effect = (bldmod >> 6) & 3;
+  int ca = coeff[gfxLine.COLEV & 0x1F];
+  int cb = coeff[(gfxLine.COLEV >> 8) & 0x1F];
+  int cy = coeff[gfxLine.COLY & 0x1F];
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi32(-1);
+  const __m256i rgb = _mm256_set1_epi32(0x03E07C1F);
+  const __m256i id0 = _mm256_set1_epi32(0x01);
+  const __m256i id1 = _mm256_set1_epi32(0x02);
+  const __m256i id2 = _mm256_set1_epi32(0x04);
+  const __m256i id3 = _mm256_set1_epi32(0x08);
+  const __m256i id4 = _mm256_set1_epi32(0x10);
+  const __m256i id5 = _mm256_set1_epi32(0x20);
+  const __m256i vBackdrop = _mm256_set1_epi32(backdrop);
+  const __m256i vTarget1 = _mm256_set1_epi32(bldmod & 0x3F);
+  const __m256i vTarget2 = _mm256_set1_epi32((bldmod >> 8) & 0x3F);
+  const __m256i vSemi = _mm256_set1_epi32(0x00010000);
+  const __m256i vFX = effect ? id5 : zero;
+  const __m256i vAlphaFX = effect == 1 ? ones : zero;
+  const __m256i vBrightFX = effect >= 2 ? ones : zero;
+  const __m256i vCA = _mm256_set1_epi32(ca);
+  const __m256i vCB = _mm256_set1_epi32(cb);
+  const __m256i vCY = _mm256_set1_epi32(cy);
+
+  for(int x = 0; x < 240; x += 8) {
+    __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(mask + x)));
+
+    __m256i color = vBackdrop;
+    __m256i top = id5;
+
+    if(layers & 0x01)
+      gfxPickAVX2(bg0 + x, m, id0, color, top);
+    if(layers & 0x02)
+      gfxPickAVX2(bg1 + x, m, id1, color, top);
+    if(layers & 0x04)
+      gfxPickAVX2(bg2 + x, m, id2, color, top);
+    if(layers & 0x08)
+      gfxPickAVX2(bg3 + x, m, id3, color, top);
+    gfxPickAVX2(obj + x, m, id4, color, top);
+
+    __m256i semi = _mm256_cmpeq_epi32(_mm256_and_si256(color, vSemi), vSemi);
+    __m256i fx = _mm256_andnot_si256(semi, _mm256_cmpeq_epi32(_mm256_and_si256(m, vFX), id5));
+    __m256i first = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_and_si256(top, vTarget1), zero), ones);
+    __m256i alpha = _mm256_or_si256(semi, _mm256_and_si256(_mm256_and_si256(fx, vAlphaFX), first));
+    __m256i bright = _mm256_and_si256(_mm256_and_si256(fx, vBrightFX), first);
+
+    if(_mm256_testz_si256(_mm256_or_si256(alpha, bright), ones)) {
+      _mm256_storeu_si256((__m256i *)(dest + x), color);
+      continue;
+    }
+
+    __m256i result = color;
+
+    if(!_mm256_testz_si256(alpha, ones)) {
+      __m256i back = vBackdrop;
+      __m256i top2 = id5;
+
+      // same search without the top layer
+      __m256i m2 = _mm256_andnot_si256(top, m);
+
+      if(layers & 0x01)
+        gfxPickAVX2(bg0 + x, m2, id0, back, top2);
+      if(layers & 0x02)
+        gfxPickAVX2(bg1 + x, m2, id1, back, top2);
+      if(layers & 0x04)
+        gfxPickAVX2(bg2 + x, m2, id2, back, top2);
+      if(layers & 0x08)
+        gfxPickAVX2(bg3 + x, m2, id3, back, top2);
+      gfxPickAVX2(obj + x, m2, id4, back, top2);
+
+      __m256i second = _mm256_cmpeq_epi32(_mm256_and_si256(top2, vTarget2), zero);
+      bright = _mm256_or_si256(bright, _mm256_and_si256(_mm256_and_si256(semi, second),
+                                                        _mm256_and_si256(first, vBrightFX)));
+      alpha = _mm256_andnot_si256(second, alpha);
+      alpha = _mm256_and_si256(alpha, _mm256_cmpgt_epi32(color, ones));
+
+      if(!_mm256_testz_si256(alpha, ones)) {
+        __m256i c = _mm256_add_epi32(_mm256_mullo_epi32(gfxSpread256(color), vCA),
+                                     _mm256_mullo_epi32(gfxSpread256(back), vCB));
+        c = _mm256_srli_epi32(c, 4);
+        if(ca + cb > 16) {
+          __m256i b;
+          b = _mm256_cmpeq_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x20)), zero);
+          c = _mm256_or_si256(c, _mm256_andnot_si256(b, _mm256_set1_epi32(0x1F)));
+          b = _mm256_cmpeq_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x8000)), zero);
+          c = _mm256_or_si256(c, _mm256_andnot_si256(b, _mm256_set1_epi32(0x7C00)));
+          b = _mm256_cmpeq_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x4000000)), zero);
+          c = _mm256_or_si256(c, _mm256_andnot_si256(b, _mm256_set1_epi32(0x03E00000)));
+        }
+        c = _mm256_and_si256(c, rgb);
+        c = _mm256_or_si256(_mm256_srli_epi32(c, 16), c);
+        result = _mm256_blendv_epi8(result, c, alpha);
+      }
+    }
+
+    if(!_mm256_testz_si256(bright, ones)) {
+      __m256i c = gfxSpread256(color);
+      if(effect == 2) {
+        c = _mm256_add_epi32(c, _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(rgb, c), vCY), 4));
+        c = _mm256_and_si256(c, rgb);
+      } else {
+        c = _mm256_sub_epi32(c, _mm256_and_si256(_mm256_srli_epi32(_mm256_mullo_epi32(c, vCY), 4), rgb));
+      }
+      c = _mm256_or_si256(_mm256_srli_epi32(c, 16), c);
+      result = _mm256_blendv_epi8(result, c, bright);
+    }
+
+    _mm256_storeu_si256((__m256i *)(dest + x), result);
+  }
+}
+
+static void gfxMergeLineAVX2(u32 *dest, const u32 *bg0, const u32 *bg1,
+                             const u32 *bg2, const u32 *bg3, const u32 *obj,
+                             const u8 *mask, u32 backdrop)
+{
+  GFX_MERGE_DISPATCH(gfxMergeAVX2)
+}
+
+#endif // GFX_HAVE_AVX2
+
+static int gfxMergeSupported()
+{
+#ifdef _MSC_VER
+  int r[4];
+  __cpuid(r, 0);
+  int maxLeaf = r[0];
+  __cpuid(r, 1);
+  if(!(r[3] & (1 << 26)))
+    return GFX_MERGE_C;
+#ifdef GFX_HAVE_AVX2
+  // AVX2 also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+  if(maxLeaf >= 7 && (r[2] & 0x18000000) == 0x18000000 &&
+     (_xgetbv(0) & 6) == 6) {
+    __cpuidex(r, 7, 0);
+    if(r[1] & (1 << 5))
+      return GFX_MERGE_AVX2;
+  }
+#endif
+  return GFX_MERGE_SSE2;
+#else
+  __builtin_cpu_init();
+#ifdef GFX_HAVE_AVX2
+  if(__builtin_cpu_supports("avx2"))
+    return GFX_MERGE_AVX2;
+#endif
+  if(__builtin_cpu_supports("sse2"))
+    return GFX_MERGE_SSE2;
+  return GFX_MERGE_C;
+#endif
+}
+
+#else
+
+static int gfxMergeSupported()
+{
+  return GFX_MERGE_C;
+}
+
+#endif // GFX_HAVE_X86
+
+// Picks the widest kernel the CPU supports, but no wider than level, and
+// returns the one picked
+int gfxMergeSelect(int level)
+{
+  int supported = gfxMergeSupported();
+
+  gfxClearArray(gfxNoLayer);
+
+  if(level > supported)
+    level = supported;
+
+  switch(level) {
+#ifdef GFX_HAVE_AVX2
+  case GFX_MERGE_AVX2:
+    gfxMergeLine = gfxMergeLineAVX2;
+    break;
+#endif
+#ifdef GFX_HAVE_X86
+  case GFX_MERGE_SSE2:
+    gfxMergeLine = gfxMergeLineSSE2;
+    break;
+#endif
+  default:
+    level = GFX_MERGE_C;
+    gfxMergeLine = gfxMergeLineC;
+    break;
+  }
+  return level;
+}
+
+static void gfxMergeLineDetect(u32 *dest, const u32 *bg0, const u32 *bg1,
+                               const u32 *bg2, const u32 *bg3, const u32 *obj,
+                               const u8 *mask, u32 backdrop)
+{
+  gfxMergeSelect(GFX_MERGE_AVX2);
+  gfxMergeLine(dest, bg0, bg1, bg2, bg3, obj, mask, backdrop);
+}
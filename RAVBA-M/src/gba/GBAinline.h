@@ -8,6 +8,7 @@
 #include "agbprint.h"
 #include "GBAcpu.h"
 #include "GBALink.h"
+#include "Globals.h"
 
 extern const u32 objTilesAddress[3];
 
@@ -33,6 +34,28 @@ extern bool timer3On;
 extern int timer3Ticks;
 extern int timer3ClockReload;
 extern int cpuTotalTicks;
+extern bool gfxRenderCopies;
+extern u8 gfxDirty[GFX_CHUNKS];
+extern void gfxMarkDirty(int chunk);
+extern void gfxRenderReload();
+
+// VRAM, palette and OAM writes. While the render thread draws from its own
+// copies the chunk written is noted, and its new contents go out with the
+// next line queued; the lines already queued still see the old ones.
+#define CPURenderWrite(chunk) \
+  do { \
+    if(gfxRenderCopies && !gfxDirty[(chunk)]) \
+      gfxMarkDirty(chunk); \
+  } while(0)
+
+#define CPUPaletteWrite(address) \
+  CPURenderWrite(GFX_CHUNK_PALETTE + (((address) & 0x3ff) >> GFX_CHUNK_SHIFT))
+
+#define CPUVramWrite(address) \
+  CPURenderWrite((address) >> GFX_CHUNK_SHIFT)
+
+#define CPUOamWrite(address) \
+  CPURenderWrite(GFX_CHUNK_OAM + (((address) & 0x3ff) >> GFX_CHUNK_SHIFT))
 
 #define CPUReadByteQuick(addr) \
   map[(addr)>>24].address[(addr) & map[(addr)>>24].mask]
@@ -430,6 +453,7 @@ static inline void CPUWriteMemory(u32 address, u32 value)
     } else goto unwritable;
     break;
   case 0x05:
+    CPUPaletteWrite(address);
 #ifdef BKPT_SUPPORT
     if(*((u32 *)&freezePRAM[address & 0x3fc]))
       cheatsWriteMemory(address & 0x70003FC,
@@ -444,6 +468,7 @@ static inline void CPUWriteMemory(u32 address, u32 value)
       return;
     if ((address & 0x18000) == 0x18000)
       address &= 0x17fff;
+    CPUVramWrite(address);
 
 #ifdef BKPT_SUPPORT
     if(*((u32 *)&freezeVRAM[address]))
@@ -454,6 +479,7 @@ static inline void CPUWriteMemory(u32 address, u32 value)
       WRITE32LE(((u32 *)&vram[address]), value);
     break;
   case 0x07:
+    CPUOamWrite(address);
 #ifdef BKPT_SUPPORT
     if(*((u32 *)&freezeOAM[address & 0x3fc]))
       cheatsWriteMemory(address & 0x70003FC,
@@ -528,6 +554,7 @@ static inline void CPUWriteHalfWord(u32 address, u16 value)
     else goto unwritable;
     break;
   case 5:
+    CPUPaletteWrite(address);
 #ifdef BKPT_SUPPORT
     if(*((u16 *)&freezePRAM[address & 0x03fe]))
       cheatsWriteHalfWord(address & 0x70003fe,
@@ -542,6 +569,7 @@ static inline void CPUWriteHalfWord(u32 address, u16 value)
       return;
     if ((address & 0x18000) == 0x18000)
       address &= 0x17fff;
+    CPUVramWrite(address);
 #ifdef BKPT_SUPPORT
     if(*((u16 *)&freezeVRAM[address]))
       cheatsWriteHalfWord(address + 0x06000000,
@@ -551,6 +579,7 @@ static inline void CPUWriteHalfWord(u32 address, u16 value)
       WRITE16LE(((u16 *)&vram[address]), value);
     break;
   case 7:
+    CPUOamWrite(address);
 #ifdef BKPT_SUPPORT
     if(*((u16 *)&freezeOAM[address & 0x03fe]))
       cheatsWriteHalfWord(address & 0x70003fe,
@@ -675,6 +704,7 @@ static inline void CPUWriteByte(u32 address, u8 b)
     } else goto unwritable;
     break;
   case 5:
+    CPUPaletteWrite(address);
     // no need to switch
     *((u16 *)&paletteRAM[address & 0x3FE]) = (b << 8) | b;
     break;
@@ -684,6 +714,7 @@ static inline void CPUWriteByte(u32 address, u8 b)
       return;
     if ((address & 0x18000) == 0x18000)
       address &= 0x17fff;
+    CPUVramWrite(address);
 
     // no need to switch
     // byte writes to OBJ VRAM are ignored
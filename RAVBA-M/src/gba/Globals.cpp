@@ -39,6 +39,7 @@ bool skipSaveGameCheats = false;
 // -1: disabled
 // 0x0000 to 0x7FFF: set custom 15 bit color
 int customBackdropColor = -1;
+bool gfxRenderThread = false;
 
 u8 *bios = 0;
 u8 *rom = 0;
@@ -45,6 +45,7 @@ extern bool mirroringEnable;
 extern bool skipSaveGameBattery; // skip battery data when reading save states
 extern bool skipSaveGameCheats;  // skip cheat list data when reading save states
 extern int customBackdropColor;
+extern bool gfxRenderThread; // draw lines on a separate thread
 
 extern u8 *bios;
 extern u8 *rom;
@@ -56,6 +57,13 @@ extern u8 *pix;
 extern u8 *oam;
 extern u8 *ioMem;
 
+// The render thread draws from its own copy of VRAM, palette and OAM, kept
+// up to date in 64 byte chunks: VRAM first, then palette, then OAM
+#define GFX_CHUNK_SHIFT   6
+#define GFX_CHUNK_PALETTE (0x20000 >> GFX_CHUNK_SHIFT)
+#define GFX_CHUNK_OAM     (GFX_CHUNK_PALETTE + (0x400 >> GFX_CHUNK_SHIFT))
+#define GFX_CHUNKS        (GFX_CHUNK_OAM + (0x400 >> GFX_CHUNK_SHIFT))
+
 extern u16 DISPCNT;
 extern u16 DISPSTAT;
 extern u16 VCOUNT;
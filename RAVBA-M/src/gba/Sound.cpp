@@ -260,6 +260,8 @@ static int gba_to_gb_sound( int addr )
 
 void soundEvent(u32 address, u8 data)
 {
+	PROFILE_SECTION(PROFILE_SOUND);
+
 	int gb_addr = gba_to_gb_sound( address );
 	if ( gb_addr )
 	{
@@ -271,6 +273,8 @@ void soundEvent(u32 address, u8 data)
 	}
 
 	// TODO: what about byte writes to SGCNT0_H etc.?
+
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 static void apply_volume( bool apu_only = false )
@@ -301,6 +305,8 @@ static void write_SGCNT0_H( int data )
 
 void soundEvent(u32 address, u16 data)
 {
+	PROFILE_SECTION(PROFILE_SOUND);
+
 	switch ( address )
 	{
 	case SGCNT0_H:
@@ -329,12 +335,16 @@ void soundEvent(u32 address, u16 data)
 		soundEvent( address |  1, (u8) (data >> 8) ); // odd
 		break;
 	}
+
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 void soundTimerOverflow(int timer)
 {
+	PROFILE_SECTION(PROFILE_SOUND);
 	pcm [0].timer_overflowed( timer );
 	pcm [1].timer_overflowed( timer );
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 static void end_frame( blip_time_t time )
@@ -390,6 +400,8 @@ static void apply_filtering()
 
 void psoundTickfn()
 {
+	PROFILE_SECTION(PROFILE_SOUND);
+
  	if ( gb_apu && stereo_buffer )
 	{
 		// Run sound hardware to present
@@ -403,6 +415,8 @@ void psoundTickfn()
 		if ( soundVolume_ != soundVolume )
 			apply_volume();
 	}
+
+	PROFILE_SECTION(PROFILE_CPU);
 }
 
 static void apply_muting()
@@ -879,6 +879,8 @@ void BIOS_RegisterRamReset(u32 flags)
       // clean OAM
       memset(oam, 0, 0x400);
     }
+    if(flags & 0x1C)
+      gfxRenderReload();
 
     if(flags & 0x80) {
       int i;
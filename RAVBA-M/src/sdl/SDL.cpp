@@ -44,6 +44,7 @@
 #include "../gba/Cheats.h"
 #include "../gba/RTC.h"
 #include "../gba/Sound.h"
+#include "../gba/Globals.h"
 #include "../gb/gb.h"
 #include "../gb/gbGlobals.h"
 #include "../gb/gbCheats.h"
@@ -191,7 +192,7 @@ char *	(sdl_patch_names[PATCH_MAX_NUM])	= { NULL }; // and so on
 extern int autoFireMaxCount;
 
 #define REWIND_NUM 8
-#define REWIND_SIZE 400000
+#define REWIND_SIZE 0x100000 // big enough for an uncompressed GBA state
 #define SYSMSG_BUFFER_SIZE 1024
 
 #define _stricmp strcasecmp
@@ -788,6 +789,8 @@ void sdlReadPreferences(FILE *f)
       sdlAgbPrint = sdlFromHex(value);
     } else if(!strcmp(key, "rtcEnabled")) {
       sdlRtcEnable = sdlFromHex(value);
+    } else if(!strcmp(key, "renderThread")) {
+      gfxRenderThread = sdlFromHex(value) ? true : false;
     } else if(!strcmp(key, "rewindTimer")) {
       rewindTimer = sdlFromHex(value);
       if(rewindTimer < 0 || rewindTimer > 600)
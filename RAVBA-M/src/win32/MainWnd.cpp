@@ -25,6 +25,7 @@
 #include "../Util.h"
 #include "../gba/GBALink.h"
 #include "../common/Patch.h"
+#include "../common/RAMemory.h"
 
 //##RA
 #include "RA_Interface.h"
@@ -436,67 +437,6 @@ void MainWnd::OnClose()
   CWnd::OnClose();
 }
 
-extern u8 gbReadMemory( register u16 );
-extern void gbWriteMemory( register u16, register u8 );
-
-unsigned char ByteReader( size_t nOffs )
-{
-	return gbReadMemory( nOffs );
-}
-void ByteWriter( size_t nOffs, unsigned char nVal )
-{
-	gbWriteMemory( nOffs, nVal );
-}
-
-// Byte reader/writer offset by the size of the map until the end of the work RAM
-unsigned char PostRAMByteReader( size_t nOffs )
-{
-	return gbReadMemory( nOffs + 0xE000 );
-}
-
-void PostRAMByteWriter( size_t nOffs, unsigned char nVal )
-{
-	gbWriteMemory( nOffs + 0xE000, nVal );
-}
-
-// GBC RAM reader/writer targeting the first bank
-unsigned char GBCFirstRAMBankReader( size_t nOffs )
-{
-	return gbWram[0x1000 + nOffs];
-}
-void GBCFirstRAMBankWriter( size_t nOffs, unsigned char nVal )
-{
-	gbWram[0x1000 + nOffs] = nVal;
-}
-
-// GBC RAM reader/writer offset to the second bank
-unsigned char GBCBankedRAMReader( size_t nOffs )
-{
-	return gbWram[0x2000 + nOffs]; // Start on bank 2
-}
-void GBCBankedRAMWriter( size_t nOffs, unsigned char nVal )
-{
-	gbWram[0x2000 + nOffs] = nVal; // Start on bank 2
-}
-
-unsigned char GBAByteReaderInternalRAM( size_t nOffs )
-{
-	return static_cast<unsigned char>( internalRAM[ nOffs ] );
-}
-void GBAByteWriterInternalRAM( size_t nOffs, unsigned char nVal )
-{
-	internalRAM[ nOffs ] = nVal;
-}
-
-unsigned char GBAByteReaderWorkRAM( size_t nOffs )
-{
-	return static_cast<unsigned char>( workRAM[ nOffs ] );
-}
-void GBAByteWriterWorkRAM( size_t nOffs, unsigned char nVal )
-{
-	workRAM[ nOffs ] = nVal;
-}
-
 bool MainWnd::FileRun()
 {
   if (!RA_ConfirmLoadNewRom(false))
@@ -602,6 +542,7 @@ bool MainWnd::FileRun()
 		RA_SetConsoleID( 4 );
 		RA_ClearMemoryBanks();
 		RA_InstallMemoryBank( 0, ByteReader, ByteWriter, 0x10000 );
+		RA_InstallMemoryBankBlockReader( 0, BlockReader );
 		RA_OnLoadNewRom( gbRom, gbRomSize );
 	}
 	else
@@ -613,6 +554,10 @@ bool MainWnd::FileRun()
 		RA_InstallMemoryBank( 1, GBCFirstRAMBankReader, GBCFirstRAMBankWriter, 0x1000 ); // First RAM bank
 		RA_InstallMemoryBank( 2, PostRAMByteReader, PostRAMByteWriter, 0x2000 ); // Direct mapping past work RAM
 		RA_InstallMemoryBank( 3, GBCBankedRAMReader, GBCBankedRAMWriter, 0x6000 ); // RAM banks 2-7
+		RA_InstallMemoryBankBlockReader( 0, GBCBlockReader );
+		RA_InstallMemoryBankBlockReader( 1, GBCFirstRAMBankBlockReader );
+		RA_InstallMemoryBankBlockReader( 2, PostRAMBlockReader );
+		RA_InstallMemoryBankBlockReader( 3, GBCBankedRAMBlockReader );
 		RA_OnLoadNewRom( gbRom, gbRomSize );
 	}
 
@@ -686,6 +631,8 @@ bool MainWnd::FileRun()
 	RA_ClearMemoryBanks();
 	RA_InstallMemoryBank( 0, GBAByteReaderInternalRAM, GBAByteWriterInternalRAM, 0x8000 );
 	RA_InstallMemoryBank( 1, GBAByteReaderWorkRAM, GBAByteWriterWorkRAM, 0x40000 );
+	RA_InstallMemoryBankBlockReader( 0, GBABlockReaderInternalRAM );
+	RA_InstallMemoryBankBlockReader( 1, GBABlockReaderWorkRAM );
 	RA_OnLoadNewRom( rom, theApp.romSize );
   }
 
@@ -1640,6 +1640,8 @@ void VBA::loadSettings()
 
   cpuDisableSfx = regQueryDwordValue("disableSfx", 0) ? true : false;
 
+  gfxRenderThread = regQueryDwordValue("renderThread", 0) ? true : false;
+
   winSaveType = regQueryDwordValue("saveType", 0);
   if(winSaveType < 0 || winSaveType > 5)
     winSaveType = 0;
@@ -2645,6 +2647,8 @@ void VBA::saveSettings()
 
   regSetDwordValue("disableSfx", cpuDisableSfx);
 
+  regSetDwordValue("renderThread", gfxRenderThread);
+
   regSetDwordValue("saveType", winSaveType);
 
   regSetDwordValue("ifbType", ifbType);
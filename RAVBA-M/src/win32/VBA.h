@@ -48,7 +48,7 @@ enum AUDIO_API {
 #endif
 };
 
-#define REWIND_SIZE 400000
+#define REWIND_SIZE 0x100000 // big enough for an uncompressed GBA state
 
 class AVIWrite;
 class WavWriter;
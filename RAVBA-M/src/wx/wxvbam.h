@@ -365,8 +365,8 @@ public:
     char *rewind_mem; // should be u8, really
     int num_rewind_states;
     int next_rewind_state;
-    // FIXME: size this properly
-#define REWIND_SIZE 400000
+    // big enough for an uncompressed GBA state
+#define REWIND_SIZE 0x100000
     // FIXME: make this a config option
 #define NUM_REWINDS 8
 